@@ -286,7 +286,8 @@ void CIntelligence::ConvertPatternsIntoBehaviors()
 				Datum.ObjectIdentifier.Object3D->SetLinearVelocity(Datum.ObjectIdentifier, XMVectorSet(0, XMVectorGetY(LinearVelocity), 0, 0));
 
 				Datum.ObjectIdentifier.Object3D->SetAnimation(Datum.ObjectIdentifier, EAnimationRegistrationType::Idle, EAnimationOption::Repeat,
-					!Datum.ObjectIdentifier.Object3D->IsCurrentAnimationRegisteredAs(Datum.ObjectIdentifier, EAnimationRegistrationType::Idle));
+					!Datum.ObjectIdentifier.Object3D->IsCurrentAnimationRegisteredAs(Datum.ObjectIdentifier, EAnimationRegistrationType::Idle),
+					Datum.PatternState.AnimationBlendTime);
 			}
 		}
 		else if (ResultNode->Identifier == "Walk")
@@ -317,6 +318,7 @@ void CIntelligence::ConvertPatternsIntoBehaviors()
 					Behavior.PrevTranslation = Translation;
 					Behavior.StartTime_ms = m_Now_ms;
 					Behavior.Scalar = Datum.PatternState.WalkSpeed; // speed
+					Behavior.AnimationBlendTime = Datum.PatternState.AnimationBlendTime;
 
 					PushBackBehavior(Datum.ObjectIdentifier, Behavior);
 				}
@@ -339,6 +341,7 @@ void CIntelligence::ConvertPatternsIntoBehaviors()
 				Behavior.Vector = DestVector;
 				Behavior.StartTime_ms = m_Now_ms;
 				Behavior.Scalar = Datum.PatternState.WalkSpeed; // speed
+				Behavior.AnimationBlendTime = Datum.PatternState.AnimationBlendTime;
 
 				PushBackBehavior(Datum.ObjectIdentifier, Behavior);
 			}
@@ -374,6 +377,7 @@ void CIntelligence::ConvertPatternsIntoBehaviors()
 			Behavior.eBehaviorType = EBehaviorType::Attack;
 			Behavior.StartTime_ms = m_Now_ms;
 			Behavior.Scalar = 0;
+			Behavior.AnimationBlendTime = Datum.PatternState.AnimationBlendTime;
 
 			if (!IsFrontBehavior(Datum.ObjectIdentifier, EBehaviorType::Attack))
 			{
@@ -414,11 +418,13 @@ void CIntelligence::ExecuteBehavior(const SObjectIdentifier& Identifier, SBehavi
 			
 			if (Behavior.bIsPlayer)
 			{
-				Identifier.Object3D->SetAnimation(Identifier, EAnimationRegistrationType::Walking);
+				Identifier.Object3D->SetAnimation(Identifier, EAnimationRegistrationType::Walking, EAnimationOption::Repeat, true,
+					Behavior.AnimationBlendTime);
 			}
 			else
 			{
-				if (!bIsAlreadyAnimated) Identifier.Object3D->SetAnimation(Identifier, EAnimationRegistrationType::Walking);
+				if (!bIsAlreadyAnimated) Identifier.Object3D->SetAnimation(Identifier, EAnimationRegistrationType::Walking, EAnimationOption::Repeat, true,
+					Behavior.AnimationBlendTime);
 			}
 		}
 
@@ -516,11 +522,13 @@ void CIntelligence::ExecuteBehavior(const SObjectIdentifier& Identifier, SBehavi
 
 			if (Behavior.bIsPlayer)
 			{
-				Identifier.Object3D->SetAnimation(Identifier, eNewType, EAnimationOption::PlayToLastFrame);
+				Identifier.Object3D->SetAnimation(Identifier, eNewType, EAnimationOption::PlayToLastFrame, true,
+					Behavior.AnimationBlendTime);
 			}
 			else
 			{
-				if (!bIsAlreadyAnimated) Identifier.Object3D->SetAnimation(Identifier, eNewType, EAnimationOption::PlayToLastFrame);
+				if (!bIsAlreadyAnimated) Identifier.Object3D->SetAnimation(Identifier, eNewType, EAnimationOption::PlayToLastFrame, true,
+					Behavior.AnimationBlendTime);
 			}
 		}
 		else
@@ -542,7 +550,7 @@ void CIntelligence::ExecuteBehavior(const SObjectIdentifier& Identifier, SBehavi
 		if (Behavior.bIsPlayer)
 		{
 			Identifier.Object3D->SetAnimation(Identifier, EAnimationRegistrationType::Idle, EAnimationOption::Repeat,
-				Identifier.Object3D->IsCurrentAnimationRegisteredAs(Identifier, EAnimationRegistrationType::Walking));
+				Identifier.Object3D->IsCurrentAnimationRegisteredAs(Identifier, EAnimationRegistrationType::Walking), Behavior.AnimationBlendTime);
 		}
 	}
 }
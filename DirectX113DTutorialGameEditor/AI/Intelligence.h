@@ -33,6 +33,7 @@ struct SBehaviorData
 	XMVECTOR		Vector{};
 	XMVECTOR		PrevTranslation{};
 	float			Scalar{ 1.0f };
+	float			AnimationBlendTime{};
 	bool			bIsPlayer{ false };
 	long long		StartTime_ms{};
 
@@ -375,6 +375,13 @@ void CPattern::ExecuteFunctionNode(SSyntaxTreeNode*& Node)
 
 			m_CopiedState.WalkSpeed = Value;
 		}
+		else if (Node->vChildNodes[0]->Identifier == "AnimationBlendTime")
+		{
+			ExecuteNonFunctionNode(Node->vChildNodes[1]);
+			float Value{ stof(Node->vChildNodes[1]->Identifier) };
+
+			m_CopiedState.AnimationBlendTime = Value;
+		}
 	}
 }
 
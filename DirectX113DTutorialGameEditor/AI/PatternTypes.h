@@ -12,6 +12,7 @@ struct SPatternState
 	size_t			InstructionIndex{};
 	long long		InstructionEndTime{}; // unit: ms
 	float			WalkSpeed{ 1.0f };
+	float			AnimationBlendTime{}; // unit: s
 	const XMVECTOR* MyPosition{};
 	const XMVECTOR* EnemyPosition{};
 };
@@ -0,0 +1,142 @@
+#include "AssetManifest.h"
+#include "MappedFile.h"
+#include "StateCache.h"
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+using std::string;
+
+// Little-endian, as CBinaryData writes
+static bool ReadUint(const uint8_t*& PtrAt, const uint8_t* const PtrEnd, size_t ByteCount, uint64_t& OutValue)
+{
+	if ((size_t)(PtrEnd - PtrAt) < ByteCount) return false;
+
+	OutValue = 0;
+	for (size_t iByte = 0; iByte < ByteCount; ++iByte)
+	{
+		OutValue |= (uint64_t)PtrAt[iByte] << (iByte * 8);
+	}
+	PtrAt += ByteCount;
+	return true;
+}
+
+static void WriteUint(std::vector<uint8_t>& vBytes, size_t ByteCount, uint64_t Value)
+{
+	for (size_t iByte = 0; iByte < ByteCount; ++iByte)
+	{
+		vBytes.emplace_back((uint8_t)(Value >> (iByte * 8)));
+	}
+}
+
+bool CAssetManifest::Load(const string& FileName, uint32_t CookerVersion)
+{
+	m_umapEntries.clear();
+
+	CMappedFile MappedFile{};
+	if (!MappedFile.Open(FileName)) return false;
+
+	const uint8_t* PtrAt{ MappedFile.GetData() };
+	const uint8_t* const PtrEnd{ PtrAt + MappedFile.GetSize() };
+
+	// 4B (uint32_t) Cooker version
+	uint64_t Version{};
+	if (!ReadUint(PtrAt, PtrEnd, 4, Version) || Version != CookerVersion) return false;
+
+	// 4B (uint32_t) Entry count
+	uint64_t EntryCount{};
+	if (!ReadUint(PtrAt, PtrEnd, 4, EntryCount)) return false;
+	for (uint64_t iEntry = 0; iEntry < EntryCount; ++iEntry)
+	{
+		// <@PrefString> Output file name (relative to the output directory)
+		// 8B (uint64_t) Source hash
+		uint64_t KeyLength{};
+		if (!ReadUint(PtrAt, PtrEnd, 4, KeyLength) || (uint64_t)(PtrEnd - PtrAt) < KeyLength)
+		{
+			m_umapEntries.clear();
+			return false;
+		}
+		string Key{ (const char*)PtrAt, (size_t)KeyLength };
+		PtrAt += KeyLength;
+
+		uint64_t SourceHash{};
+		if (!ReadUint(PtrAt, PtrEnd, 8, SourceHash))
+		{
+			m_umapEntries.clear();
+			return false;
+		}
+		m_umapEntries[Key] = SourceHash;
+	}
+	return true;
+}
+
+bool CAssetManifest::Save(const string& FileName, uint32_t CookerVersion) const
+{
+	std::vector<uint8_t> vBytes{};
+	WriteUint(vBytes, 4, CookerVersion);
+	WriteUint(vBytes, 4, m_umapEntries.size());
+	for (const auto& Entry : m_umapEntries)
+	{
+		WriteUint(vBytes, 4, Entry.first.size());
+		vBytes.insert(vBytes.end(), Entry.first.begin(), Entry.first.end());
+		WriteUint(vBytes, 8, Entry.second);
+	}
+
+	// @important: written next to the file and renamed over it, so that a failed save never leaves a broken manifest behind
+	const string KTemporaryFileName{ FileName + ".tmp" };
+	std::ofstream ofs{ KTemporaryFileName, std::ios::binary };
+	if (!ofs.is_open()) return false;
+
+	ofs.write((const char*)vBytes.data(), vBytes.size());
+	ofs.close();
+
+	std::error_code ErrorCode{};
+	if (!ofs.fail()) std::filesystem::rename(KTemporaryFileName, FileName, ErrorCode);
+	if (ofs.fail() || ErrorCode)
+	{
+		std::filesystem::remove(KTemporaryFileName, ErrorCode);
+		return false;
+	}
+	return true;
+}
+
+void CAssetManifest::Clear()
+{
+	m_umapEntries.clear();
+}
+
+void CAssetManifest::Set(const string& Key, uint64_t SourceHash)
+{
+	m_umapEntries[Key] = SourceHash;
+}
+
+void CAssetManifest::Remove(const string& Key)
+{
+	m_umapEntries.erase(Key);
+}
+
+bool CAssetManifest::IsUpToDate(const string& Key, uint64_t SourceHash, const string& OutputFileName) const
+{
+	auto found{ m_umapEntries.find(Key) };
+	if (found == m_umapEntries.end() || found->second != SourceHash) return false;
+
+	// @important: an output deleted since it was cooked is cooked again
+	std::error_code ErrorCode{};
+	return std::filesystem::exists(OutputFileName, ErrorCode);
+}
+
+size_t CAssetManifest::GetEntryCount() const
+{
+	return m_umapEntries.size();
+}
+
+uint64_t CAssetManifest::HashFile(const string& FileName, uint64_t Seed, bool& bOutIsRead)
+{
+	CMappedFile MappedFile{};
+	bOutIsRead = MappedFile.Open(FileName);
+	if (!bOutIsRead) return 0;
+
+	uint64_t Hash{ (MappedFile.GetSize()) ? CStateCache::Hash(MappedFile.GetData(), MappedFile.GetSize()) : 0 };
+	Hash ^= Seed + 0x9E3779B97F4A7C15 + (Hash << 6) + (Hash >> 2);
+	return Hash;
+}
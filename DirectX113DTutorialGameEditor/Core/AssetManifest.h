@@ -0,0 +1,38 @@
+#pragma once
+
+// @important: pure CPU & file system, so that the up-to-date checks of the asset cooker can be tested without Assimp nor a device
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+
+// What the asset cooker (see CAssetCooker) last cooked: the content hash of the source of every output,
+// so that an output is only cooked again when its source has changed
+// @important: IsUpToDate() can be called from several threads as long as nothing is set or removed meanwhile
+class CAssetManifest
+{
+public:
+	CAssetManifest() {}
+	~CAssetManifest() {}
+
+public:
+	// A missing file, or one saved by another cooker version, leaves the manifest empty so that everything is cooked again
+	bool Load(const std::string& FileName, uint32_t CookerVersion);
+	// @important: atomic (written to FileName + ".tmp" first, then renamed)
+	bool Save(const std::string& FileName, uint32_t CookerVersion) const;
+	void Clear();
+
+	void Set(const std::string& Key, uint64_t SourceHash);
+	void Remove(const std::string& Key);
+
+public:
+	// The output was cooked from a source with the same hash and is still there
+	bool IsUpToDate(const std::string& Key, uint64_t SourceHash, const std::string& OutputFileName) const;
+	size_t GetEntryCount() const;
+
+public:
+	// The hash of the file's content, seeded (e.g. with the cooker version)
+	static uint64_t HashFile(const std::string& FileName, uint64_t Seed, bool& bOutIsRead);
+
+private:
+	std::unordered_map<std::string, uint64_t>	m_umapEntries{}; // output file name (relative to the output directory) to source hash
+};
@@ -236,6 +236,6 @@ void CBillboard::Draw()
 	m_PtrDeviceContext->IASetVertexBuffers(0, 1, m_InstanceBuffer.Buffer.GetAddressOf(), &m_InstanceBuffer.Stride, &m_InstanceBuffer.Offset);
 	m_PtrDeviceContext->DrawInstanced(1, (UINT)m_vInstanceCPUData.size(), 0, 0);
 
-	m_PtrDeviceContext->HSSetShader(nullptr, nullptr, 0);
-	m_PtrDeviceContext->DSSetShader(nullptr, nullptr, 0);
+	CShader::Unbind(m_PtrDeviceContext, EShaderType::HullShader);
+	CShader::Unbind(m_PtrDeviceContext, EShaderType::DomainShader);
 }
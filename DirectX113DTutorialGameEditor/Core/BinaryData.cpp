@@ -1,16 +1,21 @@
 #include "BinaryData.h"
 #include <fstream>
+#include <filesystem>
 
 void CBinaryData::Clear()
 {
 	m_vBytes.clear();
 	m_ReadByteOffset = 0;
+
+	ClearReadView();
 }
 
 bool CBinaryData::LoadFromFile(const std::string FileName)
 {
 	m_ReadByteOffset = 0;
 
+	ClearReadView();
+
 	std::ifstream ifs{ FileName, std::ios::binary };
 	if (ifs.is_open())
 	{
@@ -22,26 +27,97 @@ bool CBinaryData::LoadFromFile(const std::string FileName)
 		ifs.read((char*)&m_vBytes[0], ByteCount);
 
 		ifs.close();
+
+		if (CLZCodec::IsCompressed(m_vBytes.data(), m_vBytes.size())) return Decompress(m_vBytes.data(), m_vBytes.size());
 		return true;
 	}
 	return false;
 }
 
-bool CBinaryData::SaveToFile(const std::string FileName)
+bool CBinaryData::SaveToFile(const std::string FileName, bool bShouldCompress)
 {
 	m_ReadByteOffset = 0;
 
-	std::ofstream ofs{ FileName, std::ios::binary };
+	std::vector<byte> vFrame{};
+	if (bShouldCompress) CLZCodec::Compress(m_vBytes.data(), m_vBytes.size(), vFrame);
+	const std::vector<byte>& vBytes{ (bShouldCompress) ? vFrame : m_vBytes };
+
+	// @important: written next to the file and renamed over it, so that a failed save never leaves a broken file behind
+	const std::string KTemporaryFileName{ FileName + ".tmp" };
+	std::ofstream ofs{ KTemporaryFileName, std::ios::binary };
 	if (ofs.is_open())
 	{
-		ofs.write((const char*)&m_vBytes[0], m_vBytes.size());
+		if (vBytes.size()) ofs.write((const char*)&vBytes[0], vBytes.size());
 
 		ofs.close();
+
+		std::error_code ErrorCode{};
+		if (!ofs.fail()) std::filesystem::rename(KTemporaryFileName, FileName, ErrorCode);
+		if (ofs.fail() || ErrorCode)
+		{
+			std::filesystem::remove(KTemporaryFileName, ErrorCode);
+			return false;
+		}
 		return true;
 	}
 	return false;
 }
 
+bool CBinaryData::LoadFromMappedFile(const std::string FileName)
+{
+	m_vBytes.clear();
+	m_ReadByteOffset = 0;
+
+	ClearReadView();
+
+	m_MappedFile = std::make_unique<CMappedFile>();
+	if (!m_MappedFile->Open(FileName))
+	{
+		m_MappedFile.reset();
+		return false;
+	}
+
+	m_PtrReadView = m_MappedFile->GetData();
+	m_ReadViewByteCount = m_MappedFile->GetSize();
+
+	if (CLZCodec::IsCompressed(m_PtrReadView, m_ReadViewByteCount)) return Decompress(m_PtrReadView, m_ReadViewByteCount);
+	return true;
+}
+
+bool CBinaryData::Decompress(const byte* const Frame, size_t FrameByteCount)
+{
+	// @important: decoded aside first, since the frame may be what Clear() releases
+	uint64_t RawByteCount{};
+	std::vector<byte> vDecompressed{};
+	bool bIsDecompressed{ CLZCodec::GetRawByteCount(Frame, FrameByteCount, RawByteCount) };
+	if (bIsDecompressed)
+	{
+		vDecompressed.resize((size_t)RawByteCount);
+		bIsDecompressed = CLZCodec::Decompress(Frame, FrameByteCount, vDecompressed.data(), vDecompressed.size());
+	}
+
+	Clear();
+	if (!bIsDecompressed) return false;
+
+	m_vBytes = std::move(vDecompressed);
+	return true;
+}
+
+void CBinaryData::SetReadView(const byte* const Data, size_t ByteCount)
+{
+	m_ReadByteOffset = 0;
+
+	ClearReadView();
+
+	m_PtrReadView = Data;
+	m_ReadViewByteCount = ByteCount;
+}
+
+void CBinaryData::Reserve(size_t ByteCount)
+{
+	m_vBytes.reserve(ByteCount);
+}
+
 void CBinaryData::WriteBool(bool Value)
 {
 	m_vBytes.emplace_back((Value == true) ? 0xBB : 0x00);
@@ -61,22 +137,12 @@ void CBinaryData::WriteInt8(int8_t Value)
 
 void CBinaryData::WriteInt16(int16_t Value)
 {
-	byte Bytes[KInt16ByteCount]{};
-	memcpy(Bytes, &Value, KInt16ByteCount);
-	for (const byte& Byte : Bytes)
-	{
-		m_vBytes.emplace_back(Byte);
-	}
+	WriteRaw(&Value, KInt16ByteCount);
 }
 
 void CBinaryData::WriteInt32(int32_t Value)
 {
-	byte Bytes[KInt32ByteCount]{};
-	memcpy(Bytes, &Value, KInt32ByteCount);
-	for (const byte& Byte : Bytes)
-	{
-		m_vBytes.emplace_back(Byte);
-	}
+	WriteRaw(&Value, KInt32ByteCount);
 }
 
 void CBinaryData::WriteUint8(uint8_t Value)
@@ -86,108 +152,60 @@ void CBinaryData::WriteUint8(uint8_t Value)
 
 void CBinaryData::WriteUint16(uint16_t Value)
 {
-	byte Bytes[KUint16ByteCount]{};
-	memcpy(Bytes, &Value, KUint16ByteCount);
-	for (const byte& Byte : Bytes)
-	{
-		m_vBytes.emplace_back(Byte);
-	}
+	WriteRaw(&Value, KUint16ByteCount);
 }
 
 void CBinaryData::WriteUint32(uint32_t Value)
 {
-	byte Bytes[KUint32ByteCount]{};
-	memcpy(Bytes, &Value, KUint32ByteCount);
-	for (const byte& Byte : Bytes)
-	{
-		m_vBytes.emplace_back(Byte);
-	}
+	WriteRaw(&Value, KUint32ByteCount);
+}
+
+void CBinaryData::WriteUint64(uint64_t Value)
+{
+	WriteRaw(&Value, KUint64ByteCount);
 }
 
 void CBinaryData::WriteFloat(float Value)
 {
-	byte Bytes[KFloatByteCount]{};
-	memcpy(Bytes, &Value, KFloatByteCount);
-	for (const byte& Byte : Bytes)
-	{
-		m_vBytes.emplace_back(Byte);
-	}
+	WriteRaw(&Value, KFloatByteCount);
 }
 
 void CBinaryData::WriteXMFLOAT2(const XMFLOAT2& Value)
 {
-	byte Bytes[KXMFLOAT2ByteCount]{};
-	memcpy(Bytes, &Value, KXMFLOAT2ByteCount);
-	for (const byte& Byte : Bytes)
-	{
-		m_vBytes.emplace_back(Byte);
-	}
+	WriteRaw(&Value, KXMFLOAT2ByteCount);
 }
 
 void CBinaryData::WriteXMFLOAT3(const XMFLOAT3& Value)
 {
-	byte Bytes[KXMFLOAT3ByteCount]{};
-	memcpy(Bytes, &Value, KXMFLOAT3ByteCount);
-	for (const byte& Byte : Bytes)
-	{
-		m_vBytes.emplace_back(Byte);
-	}
+	WriteRaw(&Value, KXMFLOAT3ByteCount);
 }
 
 void CBinaryData::WriteXMFLOAT4(const XMFLOAT4& Value)
 {
-	byte Bytes[KXMFLOAT4ByteCount]{};
-	memcpy(Bytes, &Value, KXMFLOAT4ByteCount);
-	for (const byte& Byte : Bytes)
-	{
-		m_vBytes.emplace_back(Byte);
-	}
+	WriteRaw(&Value, KXMFLOAT4ByteCount);
 }
 
 void CBinaryData::WriteXMVECTOR(const XMVECTOR& Value)
 {
-	byte Bytes[KXMVECTORByteCount]{};
-	memcpy(Bytes, &Value, KXMVECTORByteCount);
-	for (const byte& Byte : Bytes)
-	{
-		m_vBytes.emplace_back(Byte);
-	}
+	WriteRaw(&Value, KXMVECTORByteCount);
 }
 
 void CBinaryData::WriteXMMATRIX(const XMMATRIX& Value)
 {
-	byte Bytes[KXMMATRIXByteCount]{};
-	memcpy(Bytes, &Value, KXMMATRIXByteCount);
-	for (const byte& Byte : Bytes)
-	{
-		m_vBytes.emplace_back(Byte);
-	}
+	WriteRaw(&Value, KXMMATRIXByteCount);
 }
 
 void CBinaryData::WriteString(const std::string& String)
 {
 	if (String.empty()) return;
-	m_vBytes.reserve(m_vBytes.size() + String.size());
-	for (const auto& Character : String)
-	{
-		m_vBytes.emplace_back(Character);
-	}
+	WriteRaw(String.data(), String.size());
 }
 
 void CBinaryData::WriteString(const std::string& String, size_t FixedLength)
 {
-	m_vBytes.reserve(m_vBytes.size() + FixedLength);
-	for (size_t iPosition = 0; iPosition < FixedLength; ++iPosition)
-	{
-		if (iPosition < String.size())
-		{
-			m_vBytes.emplace_back(String[iPosition]);
-		}
-		else
-		{
-			m_vBytes.emplace_back(0);
-		}
-	}
+	size_t CopiedLength{ (String.size() < FixedLength) ? String.size() : FixedLength };
+	WriteRaw(String.data(), CopiedLength);
+	m_vBytes.resize(m_vBytes.size() + FixedLength - CopiedLength, 0);
 }
 
 void CBinaryData::WriteStringWithPrefixedLength(const std::string& String)
@@ -203,16 +221,12 @@ void CBinaryData::WriteNullTerminatedString(const std::string& String)
 	if (Output.empty()) Output += '\0';
 	if (Output.back() != '\0') Output += '\0';
 
-	m_vBytes.reserve(m_vBytes.size() + Output.size());
-	for (const auto& Character : Output)
-	{
-		m_vBytes.emplace_back(Character);
-	}
+	WriteRaw(Output.data(), Output.size());
 }
 
 bool CBinaryData::ReadSkip(size_t SkippingByteCount)
 {
-	if (m_ReadByteOffset + SkippingByteCount - 1 >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset + SkippingByteCount - 1 >= GetReadByteCount()) return false;
 
 	m_ReadByteOffset += SkippingByteCount;
 	return true;
@@ -225,24 +239,28 @@ bool CBinaryData::ReadByte(byte& Out)
 
 bool CBinaryData::ReadBytes(size_t ByteCount, std::vector<byte>& Out)
 {
-	if (m_ReadByteOffset + ByteCount - 1 >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset + ByteCount - 1 >= GetReadByteCount()) return false;
 
-	Out.clear();
-	Out.reserve(ByteCount);
-	for (size_t iByte = 0; iByte < ByteCount; ++iByte)
-	{
-		Out.emplace_back(m_vBytes[m_ReadByteOffset + iByte]);
-	}
+	Out.assign(GetReadBytes() + m_ReadByteOffset, GetReadBytes() + m_ReadByteOffset + ByteCount);
 	m_ReadByteOffset += ByteCount;
 
 	return true;
 }
 
+bool CBinaryData::ReadBytesInPlace(size_t ByteCount, const byte*& OutData)
+{
+	if (ByteCount > GetRemainingByteCount()) return false;
+
+	OutData = GetReadBytes() + m_ReadByteOffset;
+	m_ReadByteOffset += ByteCount;
+	return true;
+}
+
 bool CBinaryData::ReadBool(bool& Out)
 {
-	if (m_ReadByteOffset >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset >= GetReadByteCount()) return false;
 
-	Out = (m_vBytes[m_ReadByteOffset] == 0) ? false : true;
+	Out = (GetReadBytes()[m_ReadByteOffset] == 0) ? false : true;
 	m_ReadByteOffset += KBoolByteCount;
 	return true;
 }
@@ -254,9 +272,9 @@ bool CBinaryData::ReadChar(char& Out)
 
 bool CBinaryData::ReadInt8(int8_t& Out)
 {
-	if (m_ReadByteOffset >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset >= GetReadByteCount()) return false;
 
-	memcpy(&Out, &m_vBytes[m_ReadByteOffset], KInt8ByteCount);
+	memcpy(&Out, GetReadBytes() + m_ReadByteOffset, KInt8ByteCount);
 
 	m_ReadByteOffset += KInt8ByteCount;
 	return true;
@@ -264,9 +282,9 @@ bool CBinaryData::ReadInt8(int8_t& Out)
 
 bool CBinaryData::ReadInt16(int16_t& Out)
 {
-	if (m_ReadByteOffset + KInt16ByteCount - 1 >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset + KInt16ByteCount - 1 >= GetReadByteCount()) return false;
 
-	memcpy(&Out, &m_vBytes[m_ReadByteOffset], KInt16ByteCount);
+	memcpy(&Out, GetReadBytes() + m_ReadByteOffset, KInt16ByteCount);
 
 	m_ReadByteOffset += KInt16ByteCount;
 	return true;
@@ -274,9 +292,9 @@ bool CBinaryData::ReadInt16(int16_t& Out)
 
 bool CBinaryData::ReadInt32(int32_t& Out)
 {
-	if (m_ReadByteOffset + KInt32ByteCount - 1 >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset + KInt32ByteCount - 1 >= GetReadByteCount()) return false;
 
-	memcpy(&Out, &m_vBytes[m_ReadByteOffset], KInt32ByteCount);
+	memcpy(&Out, GetReadBytes() + m_ReadByteOffset, KInt32ByteCount);
 
 	m_ReadByteOffset += KInt32ByteCount;
 	return true;
@@ -284,18 +302,18 @@ bool CBinaryData::ReadInt32(int32_t& Out)
 
 bool CBinaryData::ReadUint8(uint8_t& Out)
 {
-	if (m_ReadByteOffset >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset >= GetReadByteCount()) return false;
 
-	Out = m_vBytes[m_ReadByteOffset];
+	Out = GetReadBytes()[m_ReadByteOffset];
 	m_ReadByteOffset += KUint8ByteCount;
 	return true;
 }
 
 bool CBinaryData::ReadUint16(uint16_t& Out)
 {
-	if (m_ReadByteOffset + KUint16ByteCount - 1 >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset + KUint16ByteCount - 1 >= GetReadByteCount()) return false;
 	
-	memcpy(&Out, &m_vBytes[m_ReadByteOffset], KUint16ByteCount);
+	memcpy(&Out, GetReadBytes() + m_ReadByteOffset, KUint16ByteCount);
 	
 	m_ReadByteOffset += KUint16ByteCount;
 	return true;
@@ -303,19 +321,29 @@ bool CBinaryData::ReadUint16(uint16_t& Out)
 
 bool CBinaryData::ReadUint32(uint32_t& Out)
 {
-	if (m_ReadByteOffset + KUint32ByteCount - 1 >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset + KUint32ByteCount - 1 >= GetReadByteCount()) return false;
 
-	memcpy(&Out, &m_vBytes[m_ReadByteOffset], KUint32ByteCount);
+	memcpy(&Out, GetReadBytes() + m_ReadByteOffset, KUint32ByteCount);
 
 	m_ReadByteOffset += KUint32ByteCount;
 	return true;
 }
 
+bool CBinaryData::ReadUint64(uint64_t& Out)
+{
+	if (m_ReadByteOffset + KUint64ByteCount - 1 >= GetReadByteCount()) return false;
+
+	memcpy(&Out, GetReadBytes() + m_ReadByteOffset, KUint64ByteCount);
+
+	m_ReadByteOffset += KUint64ByteCount;
+	return true;
+}
+
 bool CBinaryData::ReadFloat(float& Out)
 {
-	if (m_ReadByteOffset + KFloatByteCount - 1 >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset + KFloatByteCount - 1 >= GetReadByteCount()) return false;
 
-	memcpy(&Out, &m_vBytes[m_ReadByteOffset], KFloatByteCount);
+	memcpy(&Out, GetReadBytes() + m_ReadByteOffset, KFloatByteCount);
 
 	m_ReadByteOffset += KFloatByteCount;
 	return true;
@@ -323,9 +351,9 @@ bool CBinaryData::ReadFloat(float& Out)
 
 bool CBinaryData::ReadXMFLOAT2(XMFLOAT2& Out)
 {
-	if (m_ReadByteOffset + KXMFLOAT2ByteCount - 1 >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset + KXMFLOAT2ByteCount - 1 >= GetReadByteCount()) return false;
 
-	memcpy(&Out, &m_vBytes[m_ReadByteOffset], KXMFLOAT2ByteCount);
+	memcpy(&Out, GetReadBytes() + m_ReadByteOffset, KXMFLOAT2ByteCount);
 
 	m_ReadByteOffset += KXMFLOAT2ByteCount;
 	return true;
@@ -333,9 +361,9 @@ bool CBinaryData::ReadXMFLOAT2(XMFLOAT2& Out)
 
 bool CBinaryData::ReadXMFLOAT3(XMFLOAT3& Out)
 {
-	if (m_ReadByteOffset + KXMFLOAT3ByteCount - 1 >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset + KXMFLOAT3ByteCount - 1 >= GetReadByteCount()) return false;
 
-	memcpy(&Out, &m_vBytes[m_ReadByteOffset], KXMFLOAT3ByteCount);
+	memcpy(&Out, GetReadBytes() + m_ReadByteOffset, KXMFLOAT3ByteCount);
 
 	m_ReadByteOffset += KXMFLOAT3ByteCount;
 	return true;
@@ -343,9 +371,9 @@ bool CBinaryData::ReadXMFLOAT3(XMFLOAT3& Out)
 
 bool CBinaryData::ReadXMFLOAT4(XMFLOAT4& Out)
 {
-	if (m_ReadByteOffset + KXMFLOAT4ByteCount - 1 >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset + KXMFLOAT4ByteCount - 1 >= GetReadByteCount()) return false;
 
-	memcpy(&Out, &m_vBytes[m_ReadByteOffset], KXMFLOAT4ByteCount);
+	memcpy(&Out, GetReadBytes() + m_ReadByteOffset, KXMFLOAT4ByteCount);
 
 	m_ReadByteOffset += KXMFLOAT4ByteCount;
 	return true;
@@ -353,9 +381,9 @@ bool CBinaryData::ReadXMFLOAT4(XMFLOAT4& Out)
 
 bool CBinaryData::ReadXMVECTOR(XMVECTOR& Out)
 {
-	if (m_ReadByteOffset + KXMVECTORByteCount - 1 >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset + KXMVECTORByteCount - 1 >= GetReadByteCount()) return false;
 
-	memcpy(&Out, &m_vBytes[m_ReadByteOffset], KXMVECTORByteCount);
+	memcpy(&Out, GetReadBytes() + m_ReadByteOffset, KXMVECTORByteCount);
 
 	m_ReadByteOffset += KXMVECTORByteCount;
 	return true;
@@ -363,9 +391,9 @@ bool CBinaryData::ReadXMVECTOR(XMVECTOR& Out)
 
 bool CBinaryData::ReadXMMATRIX(XMMATRIX& Out)
 {
-	if (m_ReadByteOffset + KXMMATRIXByteCount - 1 >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset + KXMMATRIXByteCount - 1 >= GetReadByteCount()) return false;
 
-	memcpy(&Out, &m_vBytes[m_ReadByteOffset], KXMMATRIXByteCount);
+	memcpy(&Out, GetReadBytes() + m_ReadByteOffset, KXMMATRIXByteCount);
 
 	m_ReadByteOffset += KXMMATRIXByteCount;
 	return true;
@@ -379,14 +407,9 @@ bool CBinaryData::ReadString(std::string& Out, uint32_t Length)
 		Out.clear();
 		return false;
 	}
-	if (m_ReadByteOffset + Length - 1 >= m_vBytes.size()) return false;
+	if (m_ReadByteOffset + Length - 1 >= GetReadByteCount()) return false;
 
-	Out.clear();
-	Out.reserve(Length);
-	for (uint32_t iPosition = 0; iPosition < Length; ++iPosition)
-	{
-		Out += m_vBytes[m_ReadByteOffset + iPosition];
-	}
+	Out.assign((const char*)(GetReadBytes() + m_ReadByteOffset), Length);
 
 	m_ReadByteOffset += Length;
 	return true;
@@ -414,9 +437,9 @@ bool CBinaryData::ReadNullTerminatedString(std::string& Out)
 	size_t At{};
 	while (true)
 	{
-		if (m_vBytes[m_ReadByteOffset + At] == '\0') break;
+		if (GetReadBytes()[m_ReadByteOffset + At] == '\0') break;
 
-		Out += m_vBytes[m_ReadByteOffset + At];
+		Out += GetReadBytes()[m_ReadByteOffset + At];
 
 		++At;
 	}
@@ -485,6 +508,13 @@ uint32_t CBinaryData::ReadUint32()
 	return Value;
 }
 
+uint64_t CBinaryData::ReadUint64()
+{
+	uint64_t Value{};
+	ReadUint64(Value);
+	return Value;
+}
+
 float CBinaryData::ReadFloat()
 {
 	float Value{};
@@ -494,14 +524,75 @@ float CBinaryData::ReadFloat()
 
 void CBinaryData::AppendBytes(const std::vector<byte>& SrcBytes)
 {
-	m_vBytes.reserve(m_vBytes.size() + SrcBytes.size());
-	for (const byte& Byte : SrcBytes)
-	{
-		m_vBytes.emplace_back(Byte);
-	}
+	m_vBytes.insert(m_vBytes.end(), SrcBytes.begin(), SrcBytes.end());
 }
 
-const std::vector<byte> CBinaryData::GetBytes() const
+const std::vector<byte>& CBinaryData::GetBytes() const
 {
 	return m_vBytes;
 }
+
+std::vector<byte> CBinaryData::MoveBytes()
+{
+	m_ReadByteOffset = 0;
+	return std::move(m_vBytes);
+}
+
+size_t CBinaryData::GetRemainingByteCount() const
+{
+	return (m_ReadByteOffset < GetReadByteCount()) ? GetReadByteCount() - m_ReadByteOffset : 0;
+}
+
+void CBinaryData::ClearReadView()
+{
+	m_PtrReadView = nullptr;
+	m_ReadViewByteCount = 0;
+	m_MappedFile.reset();
+}
+
+const byte* CBinaryData::GetReadBytes() const
+{
+	return (m_PtrReadView) ? m_PtrReadView : m_vBytes.data();
+}
+
+size_t CBinaryData::GetReadByteCount() const
+{
+	return (m_PtrReadView) ? m_ReadViewByteCount : m_vBytes.size();
+}
+
+void CBinaryData::WriteRaw(const void* const Data, size_t ByteCount)
+{
+	if (ByteCount == 0) return;
+
+	size_t Offset{ m_vBytes.size() };
+	m_vBytes.resize(Offset + ByteCount);
+	memcpy(&m_vBytes[Offset], Data, ByteCount);
+}
+
+bool CBinaryData::ReadRaw(void* const Out, size_t ByteCount)
+{
+	if (ByteCount > GetRemainingByteCount()) return false;
+
+	memcpy(Out, GetReadBytes() + m_ReadByteOffset, ByteCount);
+	m_ReadByteOffset += ByteCount;
+	return true;
+}
+
+bool CBinaryData::IsLittleEndian()
+{
+	const uint16_t KProbe{ 1 };
+	uint8_t FirstByte{};
+	memcpy(&FirstByte, &KProbe, 1);
+	return FirstByte == 1;
+}
+
+void CBinaryData::SwapBytes(void* const Data, size_t ByteCount, size_t ComponentByteCount)
+{
+	if (ComponentByteCount <= 1) return;
+
+	byte* const Bytes{ (byte*)Data };
+	for (size_t iComponent = 0; iComponent + ComponentByteCount <= ByteCount; iComponent += ComponentByteCount)
+	{
+		std::reverse(Bytes + iComponent, Bytes + iComponent + ComponentByteCount);
+	}
+}
@@ -1,18 +1,34 @@
 #pragma once
 
 #include "SharedHeader.h"
+#include "MappedFile.h"
+#include "LZCodec.h"
+#include <type_traits>
 
 class CBinaryData
 {
 public:
 	CBinaryData() {}
 	CBinaryData(const std::vector<byte>& vBytes) : m_vBytes{ vBytes } {}
+	CBinaryData(std::vector<byte>&& vBytes) : m_vBytes{ std::move(vBytes) } {}
 	~CBinaryData() {}
 
 public:
 	void Clear();
+	// @important: compressed files (see CLZCodec) are decompressed transparently by both loads
 	bool LoadFromFile(const std::string FileName);
-	bool SaveToFile(const std::string FileName);
+	// @important: atomic (written to FileName + ".tmp" first, then renamed)
+	bool SaveToFile(const std::string FileName, bool bShouldCompress = false);
+	// Reads straight from the mapped file (read-only), so the file is never copied as a whole
+	// (unless it's compressed, then it's decompressed into the buffer)
+	bool LoadFromMappedFile(const std::string FileName);
+	// Replaces everything with the bytes decompressed from the frame, which may be in this buffer or its read view
+	bool Decompress(const byte* const Frame, size_t FrameByteCount);
+	// Reads from memory owned by someone else (read-only)
+	// @important: Data must outlive the reads
+	void SetReadView(const byte* const Data, size_t ByteCount);
+	// @important: call before writing large data, so that the buffer grows only once
+	void Reserve(size_t ByteCount);
 
 public:
 	void WriteBool(bool Value);
@@ -23,6 +39,7 @@ public:
 	void WriteUint8(uint8_t Value);
 	void WriteUint16(uint16_t Value);
 	void WriteUint32(uint32_t Value);
+	void WriteUint64(uint64_t Value);
 	void WriteFloat(float Value);
 	void WriteXMFLOAT2(const XMFLOAT2& Value);
 	void WriteXMFLOAT3(const XMFLOAT3& Value);
@@ -35,10 +52,33 @@ public:
 	void WriteStringWithPrefixedLength(const std::string& String);
 	void WriteNullTerminatedString(const std::string& String);
 
+	// Writes Count contiguous elements with one copy
+	// @important: files are little-endian, so elements are swapped per ComponentByteCount on big-endian hosts
+	// (e.g. 4 for float/uint32_t based types, 1 for RGBA8 pixels)
+	template<typename T>
+	void WriteArray(const T* const Data, size_t Count, size_t ComponentByteCount = 4)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		assert(sizeof(T) % ComponentByteCount == 0 || ComponentByteCount > sizeof(T));
+		if (Count == 0) return;
+
+		size_t Offset{ m_vBytes.size() };
+		WriteRaw(Data, sizeof(T) * Count);
+		if (!IsLittleEndian()) SwapBytes(&m_vBytes[Offset], sizeof(T) * Count, (ComponentByteCount > sizeof(T)) ? sizeof(T) : ComponentByteCount);
+	}
+
+	template<typename T>
+	void WriteArray(const std::vector<T>& vData, size_t ComponentByteCount = 4)
+	{
+		if (vData.size()) WriteArray(&vData[0], vData.size(), ComponentByteCount);
+	}
+
 public:
 	bool ReadSkip(size_t SkippingByteCount);
 	bool ReadByte(byte& Out);
 	bool ReadBytes(size_t ByteCount, std::vector<byte>& Out);
+	// Points OutData at the bytes instead of copying them, valid as long as the source is
+	bool ReadBytesInPlace(size_t ByteCount, const byte*& OutData);
 	bool ReadBool(bool& Out);
 	bool ReadChar(char& Out);
 	bool ReadInt8(int8_t& Out);
@@ -47,6 +87,7 @@ public:
 	bool ReadUint8(uint8_t& Out);
 	bool ReadUint16(uint16_t& Out);
 	bool ReadUint32(uint32_t& Out);
+	bool ReadUint64(uint64_t& Out);
 	bool ReadFloat(float& Out);
 	bool ReadXMFLOAT2(XMFLOAT2& Out);
 	bool ReadXMFLOAT3(XMFLOAT3& Out);
@@ -58,6 +99,33 @@ public:
 	bool ReadStringWithPrefixedLength(uint32_t& OutLength, std::string& OutString);
 	bool ReadNullTerminatedString(std::string& Out);
 
+	// Reads Count contiguous elements with one copy (see WriteArray())
+	template<typename T>
+	bool ReadArray(T* const Out, size_t Count, size_t ComponentByteCount = 4)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "T must be trivially copyable");
+		assert(sizeof(T) % ComponentByteCount == 0 || ComponentByteCount > sizeof(T));
+		if (Count == 0) return true;
+
+		if (!ReadRaw(Out, sizeof(T) * Count)) return false;
+		if (!IsLittleEndian()) SwapBytes(Out, sizeof(T) * Count, (ComponentByteCount > sizeof(T)) ? sizeof(T) : ComponentByteCount);
+		return true;
+	}
+
+	// @important: Out is resized to Count, but left empty if there aren't enough bytes
+	template<typename T>
+	bool ReadArray(std::vector<T>& Out, size_t Count, size_t ComponentByteCount = 4)
+	{
+		if (Count > GetRemainingByteCount() / sizeof(T))
+		{
+			Out.clear();
+			return false;
+		}
+
+		Out.resize(Count);
+		return (Count == 0) ? true : ReadArray(&Out[0], Count, ComponentByteCount);
+	}
+
 // @important: below are for more convenient reading of built-in types, though less safer
 	byte ReadByte();
 	bool ReadBool();
@@ -68,11 +136,28 @@ public:
 	uint8_t ReadUint8();
 	uint16_t ReadUint16();
 	uint32_t ReadUint32();
+	uint64_t ReadUint64();
 	float ReadFloat();
 
 public:
 	void AppendBytes(const std::vector<byte>& SrcBytes);
-	const std::vector<byte> GetBytes() const;
+	// @important: written bytes only, so it's empty while reading a mapped file or a view
+	const std::vector<byte>& GetBytes() const;
+	// @important: leaves this empty
+	std::vector<byte> MoveBytes();
+	size_t GetRemainingByteCount() const;
+
+private:
+	void ClearReadView();
+	const byte* GetReadBytes() const;
+	size_t GetReadByteCount() const;
+
+	void WriteRaw(const void* const Data, size_t ByteCount);
+	bool ReadRaw(void* const Out, size_t ByteCount);
+
+private:
+	static bool IsLittleEndian();
+	static void SwapBytes(void* const Data, size_t ByteCount, size_t ComponentByteCount);
 
 private:
 	static constexpr size_t KBoolByteCount{ 1 };
@@ -82,6 +167,7 @@ private:
 	static constexpr size_t KUint8ByteCount{ 1 };
 	static constexpr size_t KUint16ByteCount{ 2 };
 	static constexpr size_t KUint32ByteCount{ 4 };
+	static constexpr size_t KUint64ByteCount{ 8 };
 	static constexpr size_t KFloatByteCount{ 4 };
 	static constexpr size_t KXMFLOAT2ByteCount{ 4 * 2 };
 	static constexpr size_t KXMFLOAT3ByteCount{ 4 * 3 };
@@ -90,6 +176,11 @@ private:
 	static constexpr size_t KXMMATRIXByteCount{ 4 * 16 };
 
 private:
-	std::vector<byte>	m_vBytes{};
-	size_t				m_ReadByteOffset{};
+	std::vector<byte>				m_vBytes{};
+	size_t							m_ReadByteOffset{};
+
+	// @important: when set, reads come from here instead of m_vBytes
+	const byte*						m_PtrReadView{};
+	size_t							m_ReadViewByteCount{};
+	std::unique_ptr<CMappedFile>	m_MappedFile{};
 };
\ No newline at end of file
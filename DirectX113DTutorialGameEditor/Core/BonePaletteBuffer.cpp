@@ -0,0 +1,154 @@
+#include "BonePaletteBuffer.h"
+
+using std::max;
+
+void CBonePalettePacker::Clear()
+{
+	m_PackedMatrixCount = 0;
+	m_PackedPaletteCount = 0;
+}
+
+uint32_t CBonePalettePacker::Pack(const XMMATRIX* const BoneMatrices, uint32_t BoneMatrixCount)
+{
+	assert(BoneMatrices);
+
+	uint32_t Offset{ m_PackedMatrixCount };
+	if (m_vPackedMatrices.size() < (size_t)Offset + BoneMatrixCount)
+	{
+		m_vPackedMatrices.resize(max(m_vPackedMatrices.size() * 2, (size_t)Offset + BoneMatrixCount));
+	}
+
+	// XMMATRIX and XMFLOAT4X4 share the same memory layout
+	memcpy(&m_vPackedMatrices[Offset], BoneMatrices, sizeof(XMFLOAT4X4) * BoneMatrixCount);
+	m_PackedMatrixCount += BoneMatrixCount;
+	++m_PackedPaletteCount;
+
+	return Offset;
+}
+
+const XMFLOAT4X4* CBonePalettePacker::GetPackedMatrices() const
+{
+	return (m_vPackedMatrices.empty()) ? nullptr : &m_vPackedMatrices[0];
+}
+
+uint32_t CBonePalettePacker::GetPackedMatrixCount() const
+{
+	return m_PackedMatrixCount;
+}
+
+uint32_t CBonePalettePacker::GetPackedPaletteCount() const
+{
+	return m_PackedPaletteCount;
+}
+
+size_t CBonePalettePacker::GetPackedByteCount() const
+{
+	return sizeof(XMFLOAT4X4) * m_PackedMatrixCount;
+}
+
+void CBonePaletteBuffer::Create(uint32_t MatrixCapacity)
+{
+	CreateBuffer(max(MatrixCapacity, 1u));
+}
+
+void CBonePaletteBuffer::CreateBuffer(uint32_t MatrixCapacity)
+{
+	m_SRV.Reset();
+	m_Buffer.Reset();
+
+	D3D11_BUFFER_DESC BufferDesc{};
+	BufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	BufferDesc.ByteWidth = static_cast<UINT>(sizeof(XMFLOAT4X4) * MatrixCapacity);
+	BufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	BufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+	BufferDesc.StructureByteStride = sizeof(XMFLOAT4X4);
+	BufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+
+	assert(SUCCEEDED(m_PtrDevice->CreateBuffer(&BufferDesc, nullptr, m_Buffer.GetAddressOf())));
+
+	D3D11_SHADER_RESOURCE_VIEW_DESC SRVDesc{};
+	SRVDesc.Format = DXGI_FORMAT_UNKNOWN;
+	SRVDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+	SRVDesc.Buffer.FirstElement = 0;
+	SRVDesc.Buffer.NumElements = MatrixCapacity;
+
+	assert(SUCCEEDED(m_PtrDevice->CreateShaderResourceView(m_Buffer.Get(), &SRVDesc, m_SRV.GetAddressOf())));
+
+	m_MatrixCapacity = MatrixCapacity;
+}
+
+void CBonePaletteBuffer::Reset()
+{
+	m_Packer.Clear();
+}
+
+uint32_t CBonePaletteBuffer::Allocate(const XMMATRIX* const BoneMatrices, uint32_t BoneMatrixCount)
+{
+	return m_Packer.Pack(BoneMatrices, BoneMatrixCount);
+}
+
+void CBonePaletteBuffer::Upload()
+{
+	m_UploadedByteCount = 0;
+
+	uint32_t PackedMatrixCount{ m_Packer.GetPackedMatrixCount() };
+	if (PackedMatrixCount == 0) return;
+
+	// @important: grows geometrically, so that the buffer is recreated only a few times
+	if (PackedMatrixCount > m_MatrixCapacity)
+	{
+		uint32_t NewMatrixCapacity{ max(m_MatrixCapacity, 1u) };
+		while (NewMatrixCapacity < PackedMatrixCount) NewMatrixCapacity *= 2;
+		CreateBuffer(NewMatrixCapacity);
+	}
+
+	D3D11_MAPPED_SUBRESOURCE MappedSubresource{};
+	if (SUCCEEDED(m_PtrDeviceContext->Map(m_Buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedSubresource)))
+	{
+		// @important: only the packed range is written, not the whole capacity
+		memcpy(MappedSubresource.pData, m_Packer.GetPackedMatrices(), m_Packer.GetPackedByteCount());
+
+		m_PtrDeviceContext->Unmap(m_Buffer.Get(), 0);
+
+		m_UploadedByteCount = m_Packer.GetPackedByteCount();
+	}
+}
+
+void CBonePaletteBuffer::Use(EShaderType eShaderType, uint32_t Slot) const
+{
+	switch (eShaderType)
+	{
+	case EShaderType::VertexShader:
+		m_PtrDeviceContext->VSSetShaderResources(Slot, 1, m_SRV.GetAddressOf());
+		break;
+	case EShaderType::HullShader:
+		m_PtrDeviceContext->HSSetShaderResources(Slot, 1, m_SRV.GetAddressOf());
+		break;
+	case EShaderType::DomainShader:
+		m_PtrDeviceContext->DSSetShaderResources(Slot, 1, m_SRV.GetAddressOf());
+		break;
+	case EShaderType::GeometryShader:
+		m_PtrDeviceContext->GSSetShaderResources(Slot, 1, m_SRV.GetAddressOf());
+		break;
+	case EShaderType::PixelShader:
+		m_PtrDeviceContext->PSSetShaderResources(Slot, 1, m_SRV.GetAddressOf());
+		break;
+	default:
+		break;
+	}
+}
+
+const CBonePalettePacker& CBonePaletteBuffer::GetPacker() const
+{
+	return m_Packer;
+}
+
+uint32_t CBonePaletteBuffer::GetMatrixCapacity() const
+{
+	return m_MatrixCapacity;
+}
+
+size_t CBonePaletteBuffer::GetUploadedByteCount() const
+{
+	return m_UploadedByteCount;
+}
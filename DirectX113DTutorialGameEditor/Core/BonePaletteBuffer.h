@@ -0,0 +1,73 @@
+#pragma once
+
+#include "SharedHeader.h"
+
+// CPU-side packing of every object's bone palette into one contiguous array (doesn't need a device)
+class CBonePalettePacker
+{
+public:
+	CBonePalettePacker() {}
+	~CBonePalettePacker() {}
+
+public:
+	void Clear();
+
+	// Returns the offset (in matrices) of the packed palette
+	uint32_t Pack(const XMMATRIX* const BoneMatrices, uint32_t BoneMatrixCount);
+
+public:
+	const XMFLOAT4X4* GetPackedMatrices() const;
+	uint32_t GetPackedMatrixCount() const;
+	uint32_t GetPackedPaletteCount() const;
+	size_t GetPackedByteCount() const;
+
+private:
+	// @important: never shrinks, so that packing doesn't allocate once the frame's peak is reached
+	std::vector<XMFLOAT4X4>	m_vPackedMatrices{};
+	uint32_t				m_PackedMatrixCount{};
+	uint32_t				m_PackedPaletteCount{};
+};
+
+// One structured buffer shared by every CPU-skinned object, uploaded once per frame
+class CBonePaletteBuffer
+{
+public:
+	CBonePaletteBuffer(ID3D11Device* const PtrDevice, ID3D11DeviceContext* const PtrDeviceContext) :
+		m_PtrDevice{ PtrDevice }, m_PtrDeviceContext{ PtrDeviceContext }
+	{
+		assert(m_PtrDevice);
+		assert(m_PtrDeviceContext);
+	}
+	~CBonePaletteBuffer() {}
+
+public:
+	void Create(uint32_t MatrixCapacity = KDefaultMatrixCapacity);
+
+	// @important: call Reset() at the beginning of the frame and Upload() after every palette is allocated
+	void Reset();
+	uint32_t Allocate(const XMMATRIX* const BoneMatrices, uint32_t BoneMatrixCount);
+	void Upload();
+	void Use(EShaderType eShaderType, uint32_t Slot) const;
+
+public:
+	const CBonePalettePacker& GetPacker() const;
+	uint32_t GetMatrixCapacity() const;
+	size_t GetUploadedByteCount() const;
+
+private:
+	void CreateBuffer(uint32_t MatrixCapacity);
+
+public:
+	static constexpr uint32_t KDefaultMatrixCapacity{ 1024 };
+
+private:
+	ID3D11Device* const					m_PtrDevice{};
+	ID3D11DeviceContext* const			m_PtrDeviceContext{};
+
+private:
+	CBonePalettePacker					m_Packer{};
+	ComPtr<ID3D11Buffer>				m_Buffer{};
+	ComPtr<ID3D11ShaderResourceView>	m_SRV{};
+	uint32_t							m_MatrixCapacity{};
+	size_t								m_UploadedByteCount{};
+};
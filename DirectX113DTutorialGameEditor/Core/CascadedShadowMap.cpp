@@ -1,6 +1,7 @@
 #include "CascadedShadowMap.h"
 #include "FullScreenQuad.h"
 #include "ShadowMapFrustum.h"
+#include "ShadowCasterCuller.h"
 #include "../Model/Object3DLine.h"
 
 using std::make_unique;
@@ -114,13 +115,23 @@ bool CCascadedShadowMap::ShouldUpdate(size_t LOD) const
 void CCascadedShadowMap::Set(size_t LOD, const XMMATRIX& Projection, const XMVECTOR& EyePosition,
 	const XMVECTOR& ViewDirection, const XMVECTOR& DirectionToLight)
 {
-	float ZNear{ (LOD == 0) ? 0.1f : m_vLODData[LOD - 1].ZFar };
-	float ZFar{ m_vLODData[LOD].ZFar };
+	SetRenderTarget(LOD);
+	UpdateFrustum(LOD, Projection, EyePosition, ViewDirection, DirectionToLight);
+}
 
+void CCascadedShadowMap::SetRenderTarget(size_t LOD)
+{
 	m_PtrDeviceContext->RSSetViewports(1, &m_vShadowMaps[LOD].Viewport);
 
 	m_PtrDeviceContext->OMSetRenderTargets(0, nullptr, m_vShadowMaps[LOD].DSV.Get());
 	m_PtrDeviceContext->ClearDepthStencilView(m_vShadowMaps[LOD].DSV.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+}
+
+void CCascadedShadowMap::UpdateFrustum(size_t LOD, const XMMATRIX& Projection, const XMVECTOR& EyePosition,
+	const XMVECTOR& ViewDirection, const XMVECTOR& DirectionToLight)
+{
+	float ZNear{ (LOD == 0) ? 0.1f : m_vLODData[LOD - 1].ZFar };
+	float ZFar{ m_vLODData[LOD].ZFar };
 
 	m_vShadowMapFrustums[LOD] = CalculateShadowMapFrustum(Projection, EyePosition, ViewDirection, DirectionToLight, ZNear, ZFar);
 	m_vShadowMapFrustumVertices[LOD] = CalculateShadowMapFrustumVertices(DirectionToLight, m_vShadowMapFrustums[LOD]);
@@ -256,3 +267,20 @@ const SFrustumVertices& CCascadedShadowMap::GetShadowMapFrustumVertices(size_t L
 {
 	return m_vShadowMapFrustumVertices[LOD];
 }
+
+SShadowCascadeVolume CCascadedShadowMap::GetShadowCascadeVolume(size_t LOD) const
+{
+	const SShadowMapFrustum& ShadowMapFrustum{ m_vShadowMapFrustums[LOD] };
+
+	SShadowCascadeVolume Result{};
+	Result.LightPosition = ShadowMapFrustum.LightPosition;
+	Result.LightForward = ShadowMapFrustum.LightForward;
+	Result.LightUp = ShadowMapFrustum.LightUp;
+	Result.LightRight = ShadowMapFrustum.LightRight;
+	Result.HalfSize = ShadowMapFrustum.HalfSize;
+	for (size_t iVertex = 0; iVertex < 8; ++iVertex)
+	{
+		Result.ViewSliceVertices[iVertex] = m_vViewFrustumVertices[LOD].Vertices[iVertex];
+	}
+	return Result;
+}
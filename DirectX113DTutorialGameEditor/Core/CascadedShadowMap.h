@@ -6,6 +6,7 @@ class CObject3DLine;
 class CFullScreenQuad;
 struct SShadowMapFrustum;
 struct SFrustumVertices;
+struct SShadowCascadeVolume;
 
 // Cascaded shadow map for directional light (orthogonal projection)
 class CCascadedShadowMap final
@@ -65,6 +66,9 @@ public:
 public:
 	bool ShouldUpdate(size_t LOD) const;
 	void Set(size_t LOD, const XMMATRIX& Projection, const XMVECTOR& EyePosition, const XMVECTOR& ViewDirection, const XMVECTOR& DirectionToLight);
+	// Set() split in two, so that every cascade can be culled and recorded before any of them is drawn
+	void UpdateFrustum(size_t LOD, const XMMATRIX& Projection, const XMVECTOR& EyePosition, const XMVECTOR& ViewDirection, const XMVECTOR& DirectionToLight);
+	void SetRenderTarget(size_t LOD);
 
 public:
 	void CaptureFrustums();
@@ -79,6 +83,8 @@ public:
 	const XMMATRIX& GetTransposedSpaceMatrix(size_t LOD) const;
 	const SFrustumVertices& GetViewFrustumVertices(size_t LOD) const;
 	const SFrustumVertices& GetShadowMapFrustumVertices(size_t LOD) const;
+	// @important: valid after Set() or UpdateFrustum() was called for the LOD
+	SShadowCascadeVolume GetShadowCascadeVolume(size_t LOD) const;
 
 private:
 	ID3D11Device* const				m_PtrDevice{};
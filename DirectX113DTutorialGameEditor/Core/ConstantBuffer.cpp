@@ -1,4 +1,12 @@
 #include "ConstantBuffer.h"
+#include "ConstantBufferRing.h"
+
+void CConstantBuffer::ShouldUseUploadRing(bool bShouldUse)
+{
+	assert(!m_ConstantBuffer);
+
+	m_bShouldUseUploadRing = bShouldUse;
+}
 
 void CConstantBuffer::Create()
 {
@@ -14,21 +22,70 @@ void CConstantBuffer::Create()
 	SubresourceData.pSysMem = m_PtrData;
 
 	assert(SUCCEEDED(m_PtrDevice->CreateBuffer(&BufferDesc, &SubresourceData, m_ConstantBuffer.GetAddressOf())));
+
+	m_UploadState.Hash = CStateCache::Hash(m_PtrData, m_DataByteWidth);
+	m_UploadState.bIsValid = true;
+
+	// @important: the buffer above is still needed when the ring is full
+	if (m_bShouldUseUploadRing) m_PtrUploadRing = CConstantBufferRing::Get(m_PtrDeviceContext);
 }
 
 void CConstantBuffer::Update()
 {
-	D3D11_MAPPED_SUBRESOURCE MappedSubresource{};
-	if (SUCCEEDED(m_PtrDeviceContext->Map(m_ConstantBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedSubresource)))
+	// @important: a ring block can't be reused across frames even if the data is the same
+	if (m_PtrUploadRing && m_UploadFrameIndex != m_PtrUploadRing->GetFrameIndex()) m_UploadState.bIsValid = false;
+
+	if (!m_PtrStateCache->ShouldUpload(m_UploadState, m_PtrData, m_DataByteWidth)) return;
+
+	Upload();
+}
+
+void CConstantBuffer::Use(EShaderType eShaderType, uint32_t Slot) const
+{
+	// Not updated in this frame yet, so the last data is uploaded again
+	if (m_PtrUploadRing && m_UploadFrameIndex != m_PtrUploadRing->GetFrameIndex()) Upload();
+
+	if (!m_PtrStateCache->ShouldBindConstantBuffer((uint32_t)eShaderType, Slot, this, GetBoundOffset())) return;
+
+	Bind(eShaderType, Slot);
+}
+
+void CConstantBuffer::Upload() const
+{
+	if (m_PtrUploadRing)
 	{
-		memcpy(MappedSubresource.pData, m_PtrData, m_DataByteWidth);
+		m_UploadFrameIndex = m_PtrUploadRing->GetFrameIndex();
+		m_bIsInUploadRing = m_PtrUploadRing->Upload(m_PtrData, (uint32_t)m_DataByteWidth, m_UploadRingOffset);
+	}
 
-		m_PtrDeviceContext->Unmap(m_ConstantBuffer.Get(), 0);
+	if (!m_bIsInUploadRing)
+	{
+		D3D11_MAPPED_SUBRESOURCE MappedSubresource{};
+		if (SUCCEEDED(m_PtrDeviceContext->Map(m_ConstantBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedSubresource)))
+		{
+			memcpy(MappedSubresource.pData, m_PtrData, m_DataByteWidth);
+
+			m_PtrDeviceContext->Unmap(m_ConstantBuffer.Get(), 0);
+		}
+		else
+		{
+			m_UploadState.bIsValid = false;
+		}
 	}
+
+	if (m_PtrUploadRing) RebindAfterUpload();
 }
 
-void CConstantBuffer::Use(EShaderType eShaderType, uint32_t Slot) const
+void CConstantBuffer::Bind(EShaderType eShaderType, uint32_t Slot) const
 {
+	m_BoundSlotMasks[(uint32_t)eShaderType] |= (uint16_t)(1 << Slot);
+
+	if (m_bIsInUploadRing)
+	{
+		m_PtrUploadRing->Use(eShaderType, Slot, m_UploadRingOffset, (uint32_t)m_DataByteWidth);
+		return;
+	}
+
 	switch (eShaderType)
 	{
 	case EShaderType::VertexShader:
@@ -50,3 +107,30 @@ void CConstantBuffer::Use(EShaderType eShaderType, uint32_t Slot) const
 		break;
 	}
 }
+
+void CConstantBuffer::RebindAfterUpload() const
+{
+	// @important: the data has moved, so the slots this buffer is still bound to must be bound again
+	for (uint32_t iStage = 0; iStage < CStateCache::KStageCount; ++iStage)
+	{
+		if (!m_BoundSlotMasks[iStage]) continue;
+
+		for (uint32_t iSlot = 0; iSlot < CStateCache::KConstantBufferSlotCount; ++iSlot)
+		{
+			if (!(m_BoundSlotMasks[iStage] & (1 << iSlot))) continue;
+
+			if (!m_PtrStateCache->IsConstantBufferBound(iStage, iSlot, this))
+			{
+				m_BoundSlotMasks[iStage] &= (uint16_t)~(1 << iSlot);
+				continue;
+			}
+
+			if (m_PtrStateCache->ShouldBindConstantBuffer(iStage, iSlot, this, GetBoundOffset())) Bind((EShaderType)iStage, iSlot);
+		}
+	}
+}
+
+uint32_t CConstantBuffer::GetBoundOffset() const
+{
+	return (m_bIsInUploadRing) ? m_UploadRingOffset : KOwnBufferOffset;
+}
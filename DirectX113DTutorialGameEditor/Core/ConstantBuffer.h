@@ -1,12 +1,16 @@
 #pragma once
 
 #include "SharedHeader.h"
+#include "StateCache.h"
+
+class CConstantBufferRing;
 
 class CConstantBuffer
 {
 public:
 	CConstantBuffer(ID3D11Device* const PtrDevice, ID3D11DeviceContext* const PtrDeviceContext, const void* const PtrData, size_t DataByteWidth) :
-		m_PtrDevice{ PtrDevice }, m_PtrDeviceContext{ PtrDeviceContext }, m_PtrData{ PtrData }, m_DataByteWidth{ DataByteWidth }
+		m_PtrDevice{ PtrDevice }, m_PtrDeviceContext{ PtrDeviceContext }, m_PtrStateCache{ &CStateCache::Get(PtrDeviceContext) },
+		m_PtrData{ PtrData }, m_DataByteWidth{ DataByteWidth }
 	{
 		assert(m_PtrDevice);
 		assert(m_PtrDeviceContext);
@@ -16,13 +20,29 @@ public:
 	~CConstantBuffer() {}
 
 public:
+	// For the buffers that are updated many times per frame (e.g. per object)
+	// @important: must be called before Create(), it has no effect if there's no CConstantBufferRing for the device context
+	void ShouldUseUploadRing(bool bShouldUse);
+
 	void Create();
+	// @important: skipped when the data is the same as the last uploaded one (see CStateCache)
 	void Update();
+	// @important: skipped when the buffer is already bound to the slot (see CStateCache)
 	void Use(EShaderType eShaderType, uint32_t Slot) const;
 
+private:
+	void Upload() const;
+	void Bind(EShaderType eShaderType, uint32_t Slot) const;
+	void RebindAfterUpload() const;
+	uint32_t GetBoundOffset() const;
+
+private:
+	static constexpr uint32_t KOwnBufferOffset{ UINT32_MAX };
+
 private:
 	ID3D11Device* const			m_PtrDevice{};
 	ID3D11DeviceContext* const	m_PtrDeviceContext{};
+	CStateCache* const			m_PtrStateCache{};
 
 private:
 	const size_t				m_DataByteWidth{};
@@ -30,4 +50,13 @@ private:
 
 private:
 	ComPtr<ID3D11Buffer>		m_ConstantBuffer{};
-};
\ No newline at end of file
+	mutable SUploadState		m_UploadState{};
+
+private:
+	bool						m_bShouldUseUploadRing{};
+	CConstantBufferRing*		m_PtrUploadRing{};
+	mutable bool				m_bIsInUploadRing{};	// false when the ring was full
+	mutable uint32_t			m_UploadRingOffset{};
+	mutable uint64_t			m_UploadFrameIndex{};	// a ring block is valid only in the frame it's allocated in
+	mutable uint16_t			m_BoundSlotMasks[CStateCache::KStageCount]{};
+};
@@ -0,0 +1,173 @@
+#include "ConstantBufferRing.h"
+
+using std::max;
+using std::vector;
+using std::pair;
+
+static vector<pair<const ID3D11DeviceContext*, CConstantBufferRing*>>& GetRegisteredRings()
+{
+	static vector<pair<const ID3D11DeviceContext*, CConstantBufferRing*>> s_vRings{};
+	return s_vRings;
+}
+
+CConstantBufferRing::~CConstantBufferRing()
+{
+	auto& vRings{ GetRegisteredRings() };
+	for (auto iter = vRings.begin(); iter != vRings.end(); ++iter)
+	{
+		if (iter->second == this)
+		{
+			vRings.erase(iter);
+			break;
+		}
+	}
+}
+
+CConstantBufferRing* CConstantBufferRing::Get(const ID3D11DeviceContext* const PtrDeviceContext)
+{
+	for (const auto& Ring : GetRegisteredRings())
+	{
+		if (Ring.first == PtrDeviceContext) return Ring.second;
+	}
+	return nullptr;
+}
+
+bool CConstantBufferRing::Create(uint32_t ByteCapacity)
+{
+	D3D11_FEATURE_DATA_D3D11_OPTIONS Options{};
+	if (FAILED(m_PtrDevice->CheckFeatureSupport(D3D11_FEATURE_D3D11_OPTIONS, &Options, sizeof(Options)))) return false;
+	if (!Options.ConstantBufferOffsetting || !Options.MapNoOverwriteOnDynamicConstantBuffer) return false;
+	if (FAILED(m_PtrDeviceContext->QueryInterface(IID_PPV_ARGS(m_DeviceContext1.ReleaseAndGetAddressOf())))) return false;
+
+	m_Allocator.Create(max(ByteCapacity, KBlockAlignment), KBlockAlignment);
+
+	D3D11_BUFFER_DESC BufferDesc{};
+	BufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	BufferDesc.ByteWidth = m_Allocator.GetByteCapacity();
+	BufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	BufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	if (FAILED(m_PtrDevice->CreateBuffer(&BufferDesc, nullptr, m_Buffer.ReleaseAndGetAddressOf()))) return false;
+
+	D3D11_QUERY_DESC QueryDesc{};
+	QueryDesc.Query = D3D11_QUERY_EVENT;
+	for (auto& FrameQuery : m_FrameQueries)
+	{
+		if (FAILED(m_PtrDevice->CreateQuery(&QueryDesc, FrameQuery.ReleaseAndGetAddressOf()))) return false;
+	}
+
+	if (!Get(m_PtrDeviceContext)) GetRegisteredRings().emplace_back(m_PtrDeviceContext, this);
+	return true;
+}
+
+void CConstantBufferRing::BeginFrame()
+{
+	m_UploadedByteCount = 0;
+	if (!m_Buffer) return;
+
+	while (m_CompletedFrameIndex + 1 < m_FrameIndex)
+	{
+		// @important: the oldest frame's query is reused by this frame, so it must be waited for when every query is in flight
+		uint64_t OldestFrameIndex{ m_CompletedFrameIndex + 1 };
+		bool bShouldWait{ m_FrameIndex - OldestFrameIndex >= KMaxFramesInFlight };
+		if (!IsFrameCompleted(OldestFrameIndex, bShouldWait)) break;
+		m_CompletedFrameIndex = OldestFrameIndex;
+	}
+	m_Allocator.Retire(m_CompletedFrameIndex);
+}
+
+void CConstantBufferRing::EndFrame()
+{
+	if (!m_Buffer) return;
+
+	m_Allocator.EndFrame(m_FrameIndex);
+	m_PtrDeviceContext->End(m_FrameQueries[m_FrameIndex % KMaxFramesInFlight].Get());
+	++m_FrameIndex;
+}
+
+bool CConstantBufferRing::Upload(const void* const PtrData, uint32_t ByteWidth, uint32_t& OutOffset)
+{
+	assert(PtrData);
+	if (!m_Buffer) return false;
+
+	uint32_t Offset{};
+	while (!m_Allocator.Allocate(ByteWidth, Offset))
+	{
+		// The ring is full, so the oldest frame in flight must be finished first
+		if (!m_Allocator.HasPendingFrame()) return false;
+
+		uint64_t OldestFrameIndex{ m_Allocator.GetOldestPendingFenceValue() };
+		IsFrameCompleted(OldestFrameIndex, true);
+		m_CompletedFrameIndex = max(m_CompletedFrameIndex, OldestFrameIndex);
+		m_Allocator.Retire(m_CompletedFrameIndex);
+	}
+
+	D3D11_MAPPED_SUBRESOURCE MappedSubresource{};
+	if (FAILED(m_PtrDeviceContext->Map(m_Buffer.Get(), 0, D3D11_MAP_WRITE_NO_OVERWRITE, 0, &MappedSubresource))) return false;
+
+	memcpy((uint8_t*)MappedSubresource.pData + Offset, PtrData, ByteWidth);
+
+	m_PtrDeviceContext->Unmap(m_Buffer.Get(), 0);
+
+	m_UploadedByteCount += ByteWidth;
+	OutOffset = Offset;
+	return true;
+}
+
+void CConstantBufferRing::Use(EShaderType eShaderType, uint32_t Slot, uint32_t Offset, uint32_t ByteWidth) const
+{
+	// In 16-byte constants (multiples of 16 constants)
+	const UINT FirstConstant{ Offset / 16 };
+	const UINT ConstantCount{ ((ByteWidth + KBlockAlignment - 1) & ~(KBlockAlignment - 1)) / 16 };
+	ID3D11Buffer* const Buffer{ m_Buffer.Get() };
+
+	switch (eShaderType)
+	{
+	case EShaderType::VertexShader:
+		m_DeviceContext1->VSSetConstantBuffers1(Slot, 1, &Buffer, &FirstConstant, &ConstantCount);
+		break;
+	case EShaderType::HullShader:
+		m_DeviceContext1->HSSetConstantBuffers1(Slot, 1, &Buffer, &FirstConstant, &ConstantCount);
+		break;
+	case EShaderType::DomainShader:
+		m_DeviceContext1->DSSetConstantBuffers1(Slot, 1, &Buffer, &FirstConstant, &ConstantCount);
+		break;
+	case EShaderType::GeometryShader:
+		m_DeviceContext1->GSSetConstantBuffers1(Slot, 1, &Buffer, &FirstConstant, &ConstantCount);
+		break;
+	case EShaderType::PixelShader:
+		m_DeviceContext1->PSSetConstantBuffers1(Slot, 1, &Buffer, &FirstConstant, &ConstantCount);
+		break;
+	default:
+		break;
+	}
+}
+
+bool CConstantBufferRing::IsFrameCompleted(uint64_t FrameIndex, bool bShouldWait) const
+{
+	ID3D11Query* const Query{ m_FrameQueries[FrameIndex % KMaxFramesInFlight].Get() };
+	if (!bShouldWait) return (m_PtrDeviceContext->GetData(Query, nullptr, 0, D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_FALSE);
+
+	// @important: anything but S_FALSE (e.g. device removal) ends the wait
+	while (m_PtrDeviceContext->GetData(Query, nullptr, 0, 0) == S_FALSE);
+	return true;
+}
+
+uint64_t CConstantBufferRing::GetFrameIndex() const
+{
+	return m_FrameIndex;
+}
+
+uint32_t CConstantBufferRing::GetUploadedByteCount() const
+{
+	return m_UploadedByteCount;
+}
+
+uint32_t CConstantBufferRing::GetUsedByteSize() const
+{
+	return m_Allocator.GetUsedByteSize();
+}
+
+uint32_t CConstantBufferRing::GetByteCapacity() const
+{
+	return m_Allocator.GetByteCapacity();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "SharedHeader.h"
+#include "RingAllocator.h"
+#include <d3d11_1.h>
+
+// One large dynamic constant buffer that per-object constant data is sub-allocated from every frame
+// Blocks are written with MAP_WRITE_NO_OVERWRITE and bound by offset (XXSetConstantBuffers1)
+// @important: requires Direct3D 11.1 constant buffer offsetting, Create() fails otherwise
+class CConstantBufferRing
+{
+public:
+	CConstantBufferRing(ID3D11Device* const PtrDevice, ID3D11DeviceContext* const PtrDeviceContext) :
+		m_PtrDevice{ PtrDevice }, m_PtrDeviceContext{ PtrDeviceContext }
+	{
+		assert(m_PtrDevice);
+		assert(m_PtrDeviceContext);
+	}
+	~CConstantBufferRing();
+
+public:
+	// The ring created for the device context (nullptr if none was created or it's not supported)
+	static CConstantBufferRing* Get(const ID3D11DeviceContext* const PtrDeviceContext);
+
+public:
+	bool Create(uint32_t ByteCapacity = KDefaultByteCapacity);
+
+	// Retires the frames the GPU has finished
+	void BeginFrame();
+	// Fences the allocations of this frame
+	void EndFrame();
+
+	// Returns false when the data doesn't fit even after waiting for the frames in flight
+	bool Upload(const void* const PtrData, uint32_t ByteWidth, uint32_t& OutOffset);
+	void Use(EShaderType eShaderType, uint32_t Slot, uint32_t Offset, uint32_t ByteWidth) const;
+
+public:
+	uint64_t GetFrameIndex() const;
+	uint32_t GetUploadedByteCount() const;
+	uint32_t GetUsedByteSize() const;
+	uint32_t GetByteCapacity() const;
+
+private:
+	bool IsFrameCompleted(uint64_t FrameIndex, bool bShouldWait) const;
+
+public:
+	static constexpr uint32_t KBlockAlignment{ 256 }; // 16 constants, required by XXSetConstantBuffers1
+	static constexpr uint32_t KMaxFramesInFlight{ 3 };
+	static constexpr uint32_t KDefaultByteCapacity{ 4 * 1024 * 1024 };
+
+private:
+	ID3D11Device* const				m_PtrDevice{};
+	ID3D11DeviceContext* const		m_PtrDeviceContext{};
+	ComPtr<ID3D11DeviceContext1>	m_DeviceContext1{};
+
+private:
+	ComPtr<ID3D11Buffer>			m_Buffer{};
+	ComPtr<ID3D11Query>				m_FrameQueries[KMaxFramesInFlight]{};
+	CRingAllocator					m_Allocator{};
+
+	uint64_t						m_FrameIndex{ 1 };
+	uint64_t						m_CompletedFrameIndex{};
+	uint32_t						m_UploadedByteCount{}; // this frame
+};
@@ -0,0 +1,65 @@
+#include "DirtyRangeTracker.h"
+#include <algorithm>
+
+using std::max;
+using std::vector;
+
+void CDirtyRangeTracker::MarkDirty(uint32_t First, uint32_t Count)
+{
+	if (Count == 0) return;
+
+	// @important: the ends are summed in 64 bits, and must fit in 32 bits so that every merged Count does too
+	const uint64_t KEnd{ (uint64_t)First + Count };
+	assert(KEnd <= UINT32_MAX);
+
+	// @important: consecutive marks (e.g. updating every instance in order) extend the last range instead of adding one
+	if (m_vRanges.size())
+	{
+		SRange& Last{ m_vRanges.back() };
+		const uint64_t KLastEnd{ (uint64_t)Last.First + Last.Count };
+		if (First >= Last.First && First <= KLastEnd)
+		{
+			Last.Count = (uint32_t)(max(KLastEnd, KEnd) - Last.First);
+			return;
+		}
+	}
+
+	m_vRanges.emplace_back(SRange{ First, Count });
+}
+
+void CDirtyRangeTracker::Clear()
+{
+	m_vRanges.clear();
+}
+
+bool CDirtyRangeTracker::IsDirty() const
+{
+	return !m_vRanges.empty();
+}
+
+const vector<CDirtyRangeTracker::SRange>& CDirtyRangeTracker::Coalesce(uint32_t MergeGap)
+{
+	if (m_vRanges.size() <= 1) return m_vRanges;
+
+	std::sort(m_vRanges.begin(), m_vRanges.end(), [](const SRange& A, const SRange& B) { return A.First < B.First; });
+
+	size_t MergedCount{ 1 };
+	for (size_t iRange = 1; iRange < m_vRanges.size(); ++iRange)
+	{
+		SRange& Merged{ m_vRanges[MergedCount - 1] };
+		const SRange& Range{ m_vRanges[iRange] };
+
+		uint64_t MergedEnd{ (uint64_t)Merged.First + Merged.Count };
+		if ((uint64_t)Range.First <= MergedEnd + MergeGap)
+		{
+			Merged.Count = (uint32_t)(max(MergedEnd, (uint64_t)Range.First + Range.Count) - Merged.First);
+		}
+		else
+		{
+			m_vRanges[MergedCount++] = Range;
+		}
+	}
+	m_vRanges.resize(MergedCount);
+
+	return m_vRanges;
+}
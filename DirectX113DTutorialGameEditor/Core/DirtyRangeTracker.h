@@ -0,0 +1,34 @@
+#pragma once
+
+// @important: pure CPU, so that it doesn't depend on any device
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+// Collects the element ranges changed since the last upload and merges them into as few uploads as possible
+class CDirtyRangeTracker
+{
+public:
+	struct SRange
+	{
+		uint32_t	First{};
+		uint32_t	Count{};
+	};
+
+public:
+	CDirtyRangeTracker() {}
+	~CDirtyRangeTracker() {}
+
+public:
+	// First + Count must not exceed UINT32_MAX
+	void MarkDirty(uint32_t First, uint32_t Count = 1);
+	void Clear();
+	bool IsDirty() const;
+
+	// Sorts and merges the overlapping and adjacent ranges, and also the ones separated by MergeGap elements or less
+	// (uploading a few clean elements is cheaper than another upload call)
+	const std::vector<SRange>& Coalesce(uint32_t MergeGap = 0);
+
+private:
+	std::vector<SRange>	m_vRanges{};
+};
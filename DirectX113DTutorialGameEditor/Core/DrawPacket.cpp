@@ -0,0 +1,191 @@
+#include "DrawPacket.h"
+#include <chrono>
+
+using std::vector;
+
+void CDrawPacketQueue::Clear()
+{
+	m_vPackets.clear();
+}
+
+void CDrawPacketQueue::Push(uint64_t SortKey, uint32_t ObjectIndex, uint32_t MeshIndex)
+{
+	m_vPackets.emplace_back(SDrawPacket{ SortKey, ObjectIndex, MeshIndex });
+}
+
+void CDrawPacketQueue::Sort()
+{
+	static constexpr uint32_t KRadixPassCount{ sizeof(uint64_t) };
+	static constexpr uint32_t KBucketCount{ 256 };
+
+	const size_t KPacketCount{ m_vPackets.size() };
+	if (KPacketCount <= 1) return;
+
+	m_vScratchPackets.resize(KPacketCount);
+
+	// @important: all histograms are built in one read
+	uint32_t Histograms[KRadixPassCount][KBucketCount]{};
+	for (const auto& Packet : m_vPackets)
+	{
+		for (uint32_t iRadixPass = 0; iRadixPass < KRadixPassCount; ++iRadixPass)
+		{
+			++Histograms[iRadixPass][(Packet.SortKey >> (iRadixPass * 8)) & 0xFF];
+		}
+	}
+
+	SDrawPacket* PtrSource{ &m_vPackets[0] };
+	SDrawPacket* PtrDestination{ &m_vScratchPackets[0] };
+	for (uint32_t iRadixPass = 0; iRadixPass < KRadixPassCount; ++iRadixPass)
+	{
+		uint32_t* const Histogram{ Histograms[iRadixPass] };
+		const uint32_t Shift{ iRadixPass * 8 };
+
+		// The byte is the same for every packet (e.g. the pass), so this radix pass wouldn't change the order
+		if (Histogram[(PtrSource[0].SortKey >> Shift) & 0xFF] == KPacketCount) continue;
+
+		uint32_t Offset{};
+		for (uint32_t iBucket = 0; iBucket < KBucketCount; ++iBucket)
+		{
+			uint32_t Count{ Histogram[iBucket] };
+			Histogram[iBucket] = Offset;
+			Offset += Count;
+		}
+
+		for (size_t iPacket = 0; iPacket < KPacketCount; ++iPacket)
+		{
+			const SDrawPacket& Packet{ PtrSource[iPacket] };
+			PtrDestination[Histogram[(Packet.SortKey >> Shift) & 0xFF]++] = Packet;
+		}
+
+		std::swap(PtrSource, PtrDestination);
+	}
+
+	if (PtrSource != &m_vPackets[0]) m_vPackets.swap(m_vScratchPackets);
+}
+
+const vector<SDrawPacket>& CDrawPacketQueue::GetPackets() const
+{
+	return m_vPackets;
+}
+
+uint64_t CDrawPacketQueue::MakeSortKey(uint32_t Pass, uint32_t ShaderSet, uint32_t MaterialSet, uint32_t DepthBucket)
+{
+	assert(Pass < (1u << KPassBitCount));
+	assert(ShaderSet < (1u << KShaderSetBitCount));
+	assert(MaterialSet < (1u << KMaterialSetBitCount));
+	assert(DepthBucket < (1u << KDepthBucketBitCount));
+
+	uint64_t SortKey{ Pass };
+	SortKey = (SortKey << KShaderSetBitCount) | ShaderSet;
+	SortKey = (SortKey << KMaterialSetBitCount) | MaterialSet;
+	SortKey = (SortKey << KDepthBucketBitCount) | DepthBucket;
+	return SortKey;
+}
+
+uint32_t CDrawPacketQueue::GetShaderSet(uint64_t SortKey)
+{
+	return (uint32_t)((SortKey >> (KMaterialSetBitCount + KDepthBucketBitCount)) & ((1u << KShaderSetBitCount) - 1));
+}
+
+uint32_t CDrawPacketQueue::GetMaterialSet(uint64_t SortKey)
+{
+	return (uint32_t)((SortKey >> KDepthBucketBitCount) & ((1u << KMaterialSetBitCount) - 1));
+}
+
+uint32_t CDrawPacketQueue::QuantizeDepth(float Depth, float ZFar)
+{
+	static constexpr uint32_t KMaxDepthBucket{ (1u << KDepthBucketBitCount) - 1 };
+
+	if (Depth <= 0.0f || ZFar <= 0.0f) return 0;
+	if (Depth >= ZFar) return KMaxDepthBucket;
+	return (uint32_t)(Depth / ZFar * (float)KMaxDepthBucket);
+}
+
+double CDrawPacketQueue::MeasureSortTime(uint32_t PacketCount, uint32_t IterationCount)
+{
+	if (PacketCount == 0 || IterationCount == 0) return 0.0;
+
+	// @important: fixed seed (xorshift), so that the results are comparable between runs
+	uint64_t State{ 0x9E3779B97F4A7C15 };
+	auto Random{ [&State]()
+		{
+			State ^= State << 13;
+			State ^= State >> 7;
+			State ^= State << 17;
+			return State;
+		}
+	};
+
+	vector<SDrawPacket> vSourcePackets(PacketCount);
+	for (uint32_t iPacket = 0; iPacket < PacketCount; ++iPacket)
+	{
+		// A realistic distribution: few shader sets, many materials, random depth
+		uint64_t Bits{ Random() };
+		uint64_t SortKey{ MakeSortKey(0, (uint32_t)(Bits & 0x3F), (uint32_t)((Bits >> 8) & 0xFFFF), (uint32_t)((Bits >> 32) & 0xFFFF)) };
+		vSourcePackets[iPacket] = SDrawPacket{ SortKey, iPacket, 0 };
+	}
+
+	CDrawPacketQueue Queue{};
+	double TotalMicroseconds{};
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
+	{
+		Queue.m_vPackets = vSourcePackets;
+
+		auto StartTimePoint{ std::chrono::steady_clock::now() };
+		Queue.Sort();
+		TotalMicroseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - StartTimePoint).count();
+	}
+
+	return TotalMicroseconds / IterationCount;
+}
+
+void CDrawStateTracker::Invalidate()
+{
+	m_ObjectIndex = KInvalidState;
+	m_ShaderSet = KInvalidState;
+	m_MaterialSet = KInvalidState;
+}
+
+void CDrawStateTracker::ResetCounters()
+{
+	m_StateChangeCount = 0;
+	m_AvoidedStateChangeCount = 0;
+}
+
+bool CDrawStateTracker::ShouldSetObject(uint32_t ObjectIndex)
+{
+	return ShouldSet(m_ObjectIndex, ObjectIndex);
+}
+
+bool CDrawStateTracker::ShouldSetShaderSet(uint32_t ShaderSet)
+{
+	return ShouldSet(m_ShaderSet, ShaderSet);
+}
+
+bool CDrawStateTracker::ShouldSetMaterialSet(uint32_t MaterialSet)
+{
+	return ShouldSet(m_MaterialSet, MaterialSet);
+}
+
+uint32_t CDrawStateTracker::GetStateChangeCount() const
+{
+	return m_StateChangeCount;
+}
+
+uint32_t CDrawStateTracker::GetAvoidedStateChangeCount() const
+{
+	return m_AvoidedStateChangeCount;
+}
+
+bool CDrawStateTracker::ShouldSet(uint32_t& Current, uint32_t New)
+{
+	if (Current == New)
+	{
+		++m_AvoidedStateChangeCount;
+		return false;
+	}
+
+	Current = New;
+	++m_StateChangeCount;
+	return true;
+}
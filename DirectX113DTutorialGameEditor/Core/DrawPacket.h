@@ -0,0 +1,87 @@
+#pragma once
+
+// @important: pure CPU, so that it doesn't depend on any device
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+// One mesh draw of one object
+struct SDrawPacket
+{
+	uint64_t	SortKey{};
+	uint32_t	ObjectIndex{};
+	uint32_t	MeshIndex{};
+};
+
+// Draw packets sorted by a 64-bit key, so that the draws sharing the same states are submitted together
+// Sort key layout (MSB -> LSB): pass (8) | shader set (16) | material set (24) | depth bucket (16)
+class CDrawPacketQueue
+{
+public:
+	CDrawPacketQueue() {}
+	~CDrawPacketQueue() {}
+
+public:
+	void Clear();
+	void Push(uint64_t SortKey, uint32_t ObjectIndex, uint32_t MeshIndex);
+
+	// Stable LSD radix sort (8 bits per pass), the bytes that are the same for every packet are skipped
+	void Sort();
+
+	const std::vector<SDrawPacket>& GetPackets() const;
+
+public:
+	static uint64_t MakeSortKey(uint32_t Pass, uint32_t ShaderSet, uint32_t MaterialSet, uint32_t DepthBucket);
+	static uint32_t GetShaderSet(uint64_t SortKey);
+	static uint32_t GetMaterialSet(uint64_t SortKey);
+
+	// Depth is quantized linearly in [0, ZFar] (near to far)
+	static uint32_t QuantizeDepth(float Depth, float ZFar);
+
+	// Sorts PacketCount random packets IterationCount times and returns the average time in microseconds
+	static double MeasureSortTime(uint32_t PacketCount, uint32_t IterationCount);
+
+public:
+	static constexpr uint32_t KPassBitCount{ 8 };
+	static constexpr uint32_t KShaderSetBitCount{ 16 };
+	static constexpr uint32_t KMaterialSetBitCount{ 24 };
+	static constexpr uint32_t KDepthBucketBitCount{ 16 };
+
+private:
+	std::vector<SDrawPacket>	m_vPackets{};
+	std::vector<SDrawPacket>	m_vScratchPackets{};
+};
+
+// Remembers the last set states so that the redundant ones are skipped, and counts both
+class CDrawStateTracker
+{
+public:
+	CDrawStateTracker() {}
+	~CDrawStateTracker() {}
+
+public:
+	// @important: must be called whenever the states are set by someone else (e.g. at the beginning of a pass)
+	void Invalidate();
+	void ResetCounters();
+
+	bool ShouldSetObject(uint32_t ObjectIndex);
+	bool ShouldSetShaderSet(uint32_t ShaderSet);
+	bool ShouldSetMaterialSet(uint32_t MaterialSet);
+
+	uint32_t GetStateChangeCount() const;
+	uint32_t GetAvoidedStateChangeCount() const;
+
+private:
+	bool ShouldSet(uint32_t& Current, uint32_t New);
+
+private:
+	static constexpr uint32_t KInvalidState{ UINT32_MAX };
+
+private:
+	uint32_t	m_ObjectIndex{ KInvalidState };
+	uint32_t	m_ShaderSet{ KInvalidState };
+	uint32_t	m_MaterialSet{ KInvalidState };
+
+	uint32_t	m_StateChangeCount{};
+	uint32_t	m_AvoidedStateChangeCount{};
+};
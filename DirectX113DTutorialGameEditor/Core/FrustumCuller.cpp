@@ -0,0 +1,85 @@
+#include "FrustumCuller.h"
+
+using namespace DirectX;
+
+void CFrustumCuller::SetFrustum(const BoundingFrustum& Frustum)
+{
+	// @important: DirectXCollision planes point outward, so a point is inside when every plane distance is <= 0
+	XMVECTOR Planes[6]{};
+	Frustum.GetPlanes(&Planes[0], &Planes[1], &Planes[2], &Planes[3], &Planes[4], &Planes[5]);
+	SetPlanes(Planes, 6);
+}
+
+void CFrustumCuller::SetPlanes(const XMVECTOR* const Planes, uint32_t PlaneCount)
+{
+	assert(Planes);
+	assert(PlaneCount <= KMaxPlaneCount);
+
+	m_PlaneCount = PlaneCount;
+	for (uint32_t iPlane = 0; iPlane < m_PlaneCount; ++iPlane)
+	{
+		m_Planes[iPlane] = XMPlaneNormalize(Planes[iPlane]);
+
+		m_PlaneComponents[iPlane][0] = XMVectorSplatX(m_Planes[iPlane]);
+		m_PlaneComponents[iPlane][1] = XMVectorSplatY(m_Planes[iPlane]);
+		m_PlaneComponents[iPlane][2] = XMVectorSplatZ(m_Planes[iPlane]);
+		m_PlaneComponents[iPlane][3] = XMVectorSplatW(m_Planes[iPlane]);
+	}
+}
+
+bool CFrustumCuller::IsVisible(const XMFLOAT4& Sphere) const
+{
+	XMVECTOR Center{ XMVectorSet(Sphere.x, Sphere.y, Sphere.z, 1.0f) };
+	for (uint32_t iPlane = 0; iPlane < m_PlaneCount; ++iPlane)
+	{
+		if (XMVectorGetX(XMPlaneDot(m_Planes[iPlane], Center)) > Sphere.w) return false;
+	}
+	return true;
+}
+
+uint32_t CFrustumCuller::Cull(const XMFLOAT4* const Spheres, uint32_t SphereCount, std::vector<uint32_t>& vOutVisibleIndices) const
+{
+	if (SphereCount == 0) return 0;
+	assert(Spheres);
+
+	// @important: reserve the worst case once and write without branching, then trim
+	const size_t KStartIndex{ vOutVisibleIndices.size() };
+	vOutVisibleIndices.resize(KStartIndex + SphereCount);
+	uint32_t* const PtrOut{ &vOutVisibleIndices[KStartIndex] };
+	uint32_t VisibleCount{};
+
+	const uint32_t KBatchedSphereCount{ SphereCount & ~3u };
+	for (uint32_t iSphere = 0; iSphere < KBatchedSphereCount; iSphere += 4)
+	{
+		// AoS -> SoA (rows become X, Y, Z, Radius)
+		XMMATRIX Batch{ XMMatrixTranspose(XMMATRIX(
+			XMLoadFloat4(&Spheres[iSphere + 0]), XMLoadFloat4(&Spheres[iSphere + 1]),
+			XMLoadFloat4(&Spheres[iSphere + 2]), XMLoadFloat4(&Spheres[iSphere + 3]))) };
+
+		XMVECTOR Outside{ XMVectorFalseInt() };
+		for (uint32_t iPlane = 0; iPlane < m_PlaneCount; ++iPlane)
+		{
+			const XMVECTOR* const PlaneComponents{ m_PlaneComponents[iPlane] };
+			XMVECTOR Distance{ XMVectorMultiplyAdd(PlaneComponents[0], Batch.r[0], PlaneComponents[3]) };
+			Distance = XMVectorMultiplyAdd(PlaneComponents[1], Batch.r[1], Distance);
+			Distance = XMVectorMultiplyAdd(PlaneComponents[2], Batch.r[2], Distance);
+			Outside = XMVectorOrInt(Outside, XMVectorGreater(Distance, Batch.r[3]));
+		}
+
+		XMUINT4 OutsideMask{};
+		XMStoreUInt4(&OutsideMask, Outside);
+		PtrOut[VisibleCount] = iSphere + 0; VisibleCount += (OutsideMask.x == 0);
+		PtrOut[VisibleCount] = iSphere + 1; VisibleCount += (OutsideMask.y == 0);
+		PtrOut[VisibleCount] = iSphere + 2; VisibleCount += (OutsideMask.z == 0);
+		PtrOut[VisibleCount] = iSphere + 3; VisibleCount += (OutsideMask.w == 0);
+	}
+
+	for (uint32_t iSphere = KBatchedSphereCount; iSphere < SphereCount; ++iSphere)
+	{
+		PtrOut[VisibleCount] = iSphere;
+		VisibleCount += (IsVisible(Spheres[iSphere])) ? 1 : 0;
+	}
+
+	vOutVisibleIndices.resize(KStartIndex + VisibleCount);
+	return VisibleCount;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+// @important: pure CPU (DirectXMath only), so that it doesn't depend on any device
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+
+// Bounding spheres are tested against the 6 frustum planes, 4 spheres at a time
+class CFrustumCuller
+{
+public:
+	CFrustumCuller() {}
+	~CFrustumCuller() {}
+
+public:
+	// Frustum must be in the same space as the spheres (world space)
+	void SetFrustum(const DirectX::BoundingFrustum& Frustum);
+
+	// Planes must point outward (a point is inside when every plane distance is <= 0), PlaneCount <= KMaxPlaneCount
+	void SetPlanes(const DirectX::XMVECTOR* const Planes, uint32_t PlaneCount);
+
+	// Sphere: xyz = center, w = radius
+	bool IsVisible(const DirectX::XMFLOAT4& Sphere) const;
+
+	// Appends the indices of the visible spheres to vOutVisibleIndices (compacted, in order) and returns the visible count
+	uint32_t Cull(const DirectX::XMFLOAT4* const Spheres, uint32_t SphereCount, std::vector<uint32_t>& vOutVisibleIndices) const;
+
+public:
+	static constexpr uint32_t KMaxPlaneCount{ 6 };
+
+private:
+	// [Plane][Component] (each component is splatted to all 4 lanes)
+	DirectX::XMVECTOR	m_PlaneComponents[KMaxPlaneCount][4]{};
+	DirectX::XMVECTOR	m_Planes[KMaxPlaneCount]{};
+	uint32_t			m_PlaneCount{};
+};
@@ -3,7 +3,10 @@
 
 #include "Game.h"
 #include "BinaryData.h"
+#include "SceneContainer.h"
 #include "FileDialog.h"
+#include "../Model/AnimationCompressor.h"
+#include "../Model/VertexPacker.h"
 
 using std::max;
 using std::min;
@@ -631,10 +634,12 @@ void CGame::_CreateInputDevices()
 
 void CGame::_CreateConstantBuffers()
 {
+	// @important: must be created before the constant buffers that use it
+	m_ConstantBufferRing = make_unique<CConstantBufferRing>(m_Device.Get(), m_DeviceContext.Get());
+	if (!m_ConstantBufferRing->Create()) m_ConstantBufferRing.reset();
+
 	m_CBSpace = make_unique<CConstantBuffer>(m_Device.Get(), m_DeviceContext.Get(),
 		&m_CBSpaceData, sizeof(m_CBSpaceData));
-	m_CBAnimationBones = make_unique<CConstantBuffer>(m_Device.Get(), m_DeviceContext.Get(),
-		&m_CBAnimationBonesData, sizeof(m_CBAnimationBonesData));
 	m_CBAnimation = make_unique<CConstantBuffer>(m_Device.Get(), m_DeviceContext.Get(),
 		&m_CBAnimationData, sizeof(m_CBAnimationData));
 	m_CBTerrain = make_unique<CConstantBuffer>(m_Device.Get(), m_DeviceContext.Get(),
@@ -666,8 +671,13 @@ void CGame::_CreateConstantBuffers()
 	m_CBSceneMaterial = make_unique<CConstantBuffer>(m_Device.Get(), m_DeviceContext.Get(),
 		&m_CBSceneMaterialData, sizeof(m_CBSceneMaterialData));
 
+	// Updated per object
+	m_CBSpace->ShouldUseUploadRing(true);
+	m_CBAnimation->ShouldUseUploadRing(true);
+	m_CBTessFactor->ShouldUseUploadRing(true);
+	m_CBDisplacement->ShouldUseUploadRing(true);
+
 	m_CBSpace->Create();
-	m_CBAnimationBones->Create();
 	m_CBAnimation->Create();
 	m_CBTerrain->Create();
 	m_CBWind->Create();
@@ -683,6 +693,9 @@ void CGame::_CreateConstantBuffers()
 	m_CBGBufferUnpacking->Create();
 	m_CBShadowMap->Create();
 	m_CBSceneMaterial->Create();
+
+	m_BonePaletteBuffer = make_unique<CBonePaletteBuffer>(m_Device.Get(), m_DeviceContext.Get());
+	m_BonePaletteBuffer->Create();
 }
 
 void CGame::_CreateBaseShaders()
@@ -694,10 +707,9 @@ void CGame::_CreateBaseShaders()
 		m_CBSpace->Use(EShaderType::VertexShader, 0);
 
 		m_VSAnimation = make_unique<CShader>(m_Device.Get(), m_DeviceContext.Get());
-		m_VSAnimation->Create(EShaderType::VertexShader, CShader::EVersion::_4_0, bShouldCompileShaders, L"Shader\\VSAnimation.hlsl", "main",
+		m_VSAnimation->Create(EShaderType::VertexShader, CShader::EVersion::_5_0, bShouldCompileShaders, L"Shader\\VSAnimation.hlsl", "main",
 			CObject3D::KInputElementDescs, ARRAYSIZE(CObject3D::KInputElementDescs));
 		m_VSAnimation->ReserveConstantBufferSlots(KVSSharedCBCount);
-		m_VSAnimation->AttachConstantBuffer(m_CBAnimationBones.get());
 		m_VSAnimation->AttachConstantBuffer(m_CBAnimation.get());
 
 		m_VSBase = make_unique<CShader>(m_Device.Get(), m_DeviceContext.Get());
@@ -1008,6 +1020,8 @@ const std::string& CGame::GetSceneDirectory() const
 
 void CGame::EmptyScene()
 {
+	m_SceneLoadingData.reset();
+
 	DeselectAll();
 	ClearCopyList();
 	ClearObject3Ds();
@@ -1028,30 +1042,185 @@ void CGame::EmptyScene()
 
 void CGame::LoadScene(const string& FileName, const std::string& SceneContentDirectory)
 {
+	BeginLoadingScene(FileName, SceneContentDirectory);
+
+	// @important: waits for the decoding, so that the scene is complete when this returns
+	UpdateSceneLoading(DBL_MAX, true);
+}
+
+void CGame::BeginLoadingScene(const string& FileName, const std::string& SceneContentDirectory)
+{
+	m_SceneLoadStartTimePoint = steady_clock::now();
+	m_SceneFileName = FileName;
+	m_SceneContentDirectory = SceneContentDirectory;
+
 	EmptyScene();
 
-	string ReadString{};
-	XMVECTOR ReadXMVECTOR{};
+	m_SceneSaveCache = CSceneContainer::SSaveCache();
 
-	CBinaryData SceneBinaryData{};
-	SceneBinaryData.LoadFromFile(FileName);
+	auto SceneLoadingData{ make_unique<SSceneLoadingData>() };
+	if (!SceneLoadingData->SceneContainer.Open(FileName))
+	{
+		// @important: legacy (flat) scene files are still imported, but at once
+		CBinaryData SceneBinaryData{};
+		SceneBinaryData.LoadFromMappedFile(FileName);
 
-	// Scene Intelligence (Patterns)
+		LoadLegacyScene(SceneBinaryData);
+
+		m_SceneLoadMilliseconds = std::chrono::duration<double, std::milli>(steady_clock::now() - m_SceneLoadStartTimePoint).count();
+		m_bIsSceneFirstFramePending = true;
+		return;
+	}
+
+	SSceneLoadingData& Data{ *SceneLoadingData };
+	Data.SceneContainer.ReadChunk(ESceneChunkType::ObjectTable, Data.ObjectTableBinary);
+	Data.SceneContainer.ReadChunk(ESceneChunkType::InstanceTable, Data.InstanceTableBinary);
+	Data.Object3DCount = Data.ObjectTableBinary.ReadUint32();
+	Data.StepCount = KSceneLoadingStepObject3D + Data.Object3DCount + 1;
+
+	// CPU stage
+	Data.SceneDecoder.Start(Data.SceneContainer);
+
+	m_SceneLoadingData = std::move(SceneLoadingData);
+}
+
+bool CGame::IsLoadingScene() const
+{
+	return (m_SceneLoadingData) ? true : false;
+}
+
+float CGame::GetSceneLoadingProgress() const
+{
+	if (!m_SceneLoadingData) return 1.0f;
+
+	// @important: the CPU and the GPU stage weigh the same
+	const SSceneLoadingData& Data{ *m_SceneLoadingData };
+	return (Data.SceneDecoder.GetProgress() + (float)Data.NextStep / (float)Data.StepCount) * 0.5f;
+}
+
+bool CGame::UpdateSceneLoading(double BudgetMilliseconds, bool bShouldWaitForDecoding)
+{
+	if (!m_SceneLoadingData) return true;
+
+	SSceneLoadingData& Data{ *m_SceneLoadingData };
+	CSceneDecoder& SceneDecoder{ Data.SceneDecoder };
+	CBinaryData ChunkBinary{};
+	string ReadString{};
+
+	// GPU stage: creates the resources from the decoded data, one step at a time until the budget runs out
+	// @important: a step is never split, so a single big object can exceed the budget
+	auto StartTimePoint{ steady_clock::now() };
+	while (Data.NextStep < Data.StepCount)
 	{
-		size_t PatternCount{ SceneBinaryData.ReadUint32() };
-		for (size_t iPattern = 0; iPattern < PatternCount; ++iPattern)
+		const uint32_t KStep{ Data.NextStep };
+		if (KStep == KSceneLoadingStepPatterns)
 		{
-			SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+			// Scene Intelligence (Patterns)
+			if (Data.SceneContainer.ReadChunk(ESceneChunkType::Patterns, ChunkBinary)) ReadScenePatterns(ChunkBinary);
+		}
+		else if (KStep == KSceneLoadingStepTerrain)
+		{
+			// Terrain
+			if (!SceneDecoder.IsTerrainDecoded())
+			{
+				if (!bShouldWaitForDecoding) return false;
+				SceneDecoder.WaitForTerrain();
+			}
+
+			LoadTerrain(SceneDecoder.TakeTerrain());
+		}
+		else if (KStep < KSceneLoadingStepObject3D + Data.Object3DCount)
+		{
+			// Object3D
+			const uint32_t KObject3DIndex{ KStep - KSceneLoadingStepObject3D };
+			if (!SceneDecoder.IsObject3DDecoded(KObject3DIndex))
+			{
+				if (!bShouldWaitForDecoding) return false;
+				SceneDecoder.WaitForObject3D(KObject3DIndex);
+			}
+
+			// @important: the name is in the object table, so that the OB3D is read only once
+			string Object3DName{};
+			bool bIsRigged{};
+			Data.ObjectTableBinary.ReadStringWithPrefixedLength(Object3DName);
+			Data.ObjectTableBinary.ReadBool(bIsRigged);
+			EObjectRole eObjectRole{ (EObjectRole)Data.ObjectTableBinary.ReadUint8() };
+
+			InsertObject3D(Object3DName);
+			CObject3D* const Object3D{ GetObject3D(Object3DName) };
+			if (Data.SceneContainer.ReadChunk(ESceneChunkType::Object3D, ChunkBinary, KObject3DIndex))
+			{
+				Object3D->LoadOB3D(ChunkBinary, bIsRigged, SceneDecoder.GetObject3DModel(KObject3DIndex));
+			}
+
+			// physics engine
+			m_PhysicsEngine.RegisterObject(Object3D, eObjectRole);
+
+			// instance
+			{
+				const auto& vInstanceCPUData{ Object3D->GetInstanceCPUDataVector() };
+				uint32_t PatternCount{ Data.InstanceTableBinary.ReadUint32() };
+				for (uint32_t iPattern = 0; iPattern < PatternCount; ++iPattern)
+				{
+					uint32_t InstanceIndex{ Data.InstanceTableBinary.ReadUint32() };
+					Data.InstanceTableBinary.ReadStringWithPrefixedLength(ReadString);
+					if (InstanceIndex < vInstanceCPUData.size())
+					{
+						SObjectIdentifier Identifier{ Object3D, vInstanceCPUData[InstanceIndex].Name };
+						m_Intelligence->RegisterPattern(Identifier, GetPattern(ReadString));
+					}
+				}
+			}
+		}
+		else
+		{
+			// Editor camera & Camera
+			if (Data.SceneContainer.ReadChunk(ESceneChunkType::Cameras, ChunkBinary)) ReadSceneCameras(ChunkBinary);
 
-			InsertPattern(ReadString);
+			// Light
+			if (Data.SceneContainer.ReadChunk(ESceneChunkType::Lights, ChunkBinary)) ReadSceneLights(ChunkBinary);
+
+			// Scene material
+			if (Data.SceneContainer.ReadChunk(ESceneChunkType::SceneMaterial, ChunkBinary)) ReadSceneMaterial(ChunkBinary);
+
+			// Light probe
+			if (Data.SceneContainer.ReadChunk(ESceneChunkType::LightProbe, ChunkBinary)) ReadSceneLightProbe(ChunkBinary);
+
+			// Directional & Ambient light
+			if (Data.SceneContainer.ReadChunk(ESceneChunkType::GlobalLight, ChunkBinary)) ReadSceneGlobalLight(ChunkBinary);
 		}
+		++Data.NextStep;
+
+		if (std::chrono::duration<double, std::milli>(steady_clock::now() - StartTimePoint).count() >= BudgetMilliseconds) break;
 	}
+	if (Data.NextStep < Data.StepCount) return false;
 
-	// Terrain
+	// @important: so that saving the scene right after loading it only writes what has been changed since
+	Data.SceneContainer.FillSaveCache(m_SceneFileName, m_bShouldCompressSavedFiles, m_SceneSaveCache);
+	for (size_t iObject3D = 0; iObject3D < m_vObject3Ds.size(); ++iObject3D)
 	{
-		SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
-		LoadTerrain(ReadString);
+		m_vObject3Ds[iObject3D]->ClearSaveDirty(Data.SceneContainer.GetChunkRawHash(ESceneChunkType::Object3D, (uint32_t)iObject3D));
 	}
+	m_SavedInstanceTableHash = Data.SceneContainer.GetChunkRawHash(ESceneChunkType::InstanceTable);
+	m_bIsInstanceTableDirty = false;
+
+	// @important: the decoder is destroyed before the scene container it reads from
+	m_SceneLoadingData.reset();
+
+	m_SceneLoadMilliseconds = std::chrono::duration<double, std::milli>(steady_clock::now() - m_SceneLoadStartTimePoint).count();
+	m_bIsSceneFirstFramePending = true;
+	return true;
+}
+
+void CGame::LoadLegacyScene(CBinaryData& SceneBinaryData)
+{
+	string ReadString{};
+
+	// Scene Intelligence (Patterns)
+	ReadScenePatterns(SceneBinaryData);
+
+	// Terrain
+	ReadSceneTerrain(SceneBinaryData);
 	
 	// Object3D
 	{
@@ -1100,6 +1269,48 @@ void CGame::LoadScene(const string& FileName, const std::string& SceneContentDir
 		}
 	}
 
+	// Editor camera & Camera
+	ReadSceneCameras(SceneBinaryData);
+	
+	// Light
+	ReadSceneLights(SceneBinaryData);
+
+	// Scene material
+	ReadSceneMaterial(SceneBinaryData);
+
+	// Light probe
+	ReadSceneLightProbe(SceneBinaryData);
+
+	// Directional & Ambient light
+	ReadSceneGlobalLight(SceneBinaryData);
+}
+
+void CGame::ReadScenePatterns(CBinaryData& SceneBinaryData)
+{
+	string ReadString{};
+
+	size_t PatternCount{ SceneBinaryData.ReadUint32() };
+	for (size_t iPattern = 0; iPattern < PatternCount; ++iPattern)
+	{
+		SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+
+		InsertPattern(ReadString);
+	}
+}
+
+void CGame::ReadSceneTerrain(CBinaryData& SceneBinaryData)
+{
+	string ReadString{};
+
+	SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+	LoadTerrain(ReadString);
+}
+
+void CGame::ReadSceneCameras(CBinaryData& SceneBinaryData)
+{
+	string ReadString{};
+	XMVECTOR ReadXMVECTOR{};
+
 	// Editor camera
 	{
 		m_EditorCamera->SetType((CCamera::EType)SceneBinaryData.ReadUint32());
@@ -1137,112 +1348,135 @@ void CGame::LoadScene(const string& FileName, const std::string& SceneContentDir
 			m_CameraRep->UpdateInstanceWorldMatrix(ReadString);
 		}
 	}
-	
-	// Light
+}
+
+void CGame::ReadSceneLights(CBinaryData& SceneBinaryData)
+{
+	for (uint32_t iLightType = 0; iLightType < CLight::KLightTypeCount; ++iLightType)
 	{
-		for (uint32_t iLightType = 0; iLightType < CLight::KLightTypeCount; ++iLightType)
-		{
-			uint32_t LightType{ SceneBinaryData.ReadUint32() };
+		uint32_t LightType{ SceneBinaryData.ReadUint32() };
 
-			uint32_t LightCount{ SceneBinaryData.ReadUint32() };
+		uint32_t LightCount{ SceneBinaryData.ReadUint32() };
 
-			for (uint32_t iLight = 0; iLight < LightCount; ++iLight)
-			{
-				CLight::SInstanceCPUData InstanceCPUData{};
-				CLight::SInstanceGPUData InstanceGPUData{};
+		for (uint32_t iLight = 0; iLight < LightCount; ++iLight)
+		{
+			CLight::SInstanceCPUData InstanceCPUData{};
+			CLight::SInstanceGPUData InstanceGPUData{};
 
-				SceneBinaryData.ReadStringWithPrefixedLength(InstanceCPUData.Name);
-				InstanceCPUData.eType = (CLight::EType)SceneBinaryData.ReadUint32();
+			SceneBinaryData.ReadStringWithPrefixedLength(InstanceCPUData.Name);
+			InstanceCPUData.eType = (CLight::EType)SceneBinaryData.ReadUint32();
 
-				SceneBinaryData.ReadXMVECTOR(InstanceGPUData.Position);
-				SceneBinaryData.ReadXMVECTOR(InstanceGPUData.Color);
-				SceneBinaryData.ReadXMVECTOR(InstanceGPUData.Direction);
-				SceneBinaryData.ReadFloat(InstanceGPUData.Range);
-				SceneBinaryData.ReadFloat(InstanceGPUData.Theta);
+			SceneBinaryData.ReadXMVECTOR(InstanceGPUData.Position);
+			SceneBinaryData.ReadXMVECTOR(InstanceGPUData.Color);
+			SceneBinaryData.ReadXMVECTOR(InstanceGPUData.Direction);
+			SceneBinaryData.ReadFloat(InstanceGPUData.Range);
+			SceneBinaryData.ReadFloat(InstanceGPUData.Theta);
 
-				InsertLight(InstanceCPUData.eType, InstanceCPUData.Name);
+			InsertLight(InstanceCPUData.eType, InstanceCPUData.Name);
 
-				m_LightArray[(uint32_t)InstanceCPUData.eType]->SetInstanceGPUData(InstanceCPUData.Name, InstanceGPUData);
-				m_LightRep->SetInstancePosition(InstanceCPUData.Name, InstanceGPUData.Position);
-			}
+			m_LightArray[(uint32_t)InstanceCPUData.eType]->SetInstanceGPUData(InstanceCPUData.Name, InstanceGPUData);
+			m_LightRep->SetInstancePosition(InstanceCPUData.Name, InstanceGPUData.Position);
 		}
 	}
+}
 
-	// Scene material
-	{
-		SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
-		m_SceneMaterial->SetTextureFileName(ETextureType::BaseColorTexture, ReadString);
+void CGame::ReadSceneMaterial(CBinaryData& SceneBinaryData)
+{
+	string ReadString{};
 
-		SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
-		m_SceneMaterial->SetTextureFileName(ETextureType::NormalTexture, ReadString);
-		
-		SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
-		m_SceneMaterial->SetTextureFileName(ETextureType::OpacityTexture, ReadString);
-		
-		SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
-		m_SceneMaterial->SetTextureFileName(ETextureType::RoughnessTexture, ReadString);
-		
-		SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
-		m_SceneMaterial->SetTextureFileName(ETextureType::MetalnessTexture, ReadString);
-		
-		SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
-		m_SceneMaterial->SetTextureFileName(ETextureType::AmbientOcclusionTexture, ReadString);
+	SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+	m_SceneMaterial->SetTextureFileName(ETextureType::BaseColorTexture, ReadString);
 
-		m_SceneMaterialTextureSet->CreateTextures(*m_SceneMaterial);
+	SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+	m_SceneMaterial->SetTextureFileName(ETextureType::NormalTexture, ReadString);
+	
+	SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+	m_SceneMaterial->SetTextureFileName(ETextureType::OpacityTexture, ReadString);
+	
+	SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+	m_SceneMaterial->SetTextureFileName(ETextureType::RoughnessTexture, ReadString);
+	
+	SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+	m_SceneMaterial->SetTextureFileName(ETextureType::MetalnessTexture, ReadString);
+	
+	SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+	m_SceneMaterial->SetTextureFileName(ETextureType::AmbientOcclusionTexture, ReadString);
 
-		UpdateSceneMaterial();
-	}
+	m_SceneMaterialTextureSet->CreateTextures(*m_SceneMaterial);
 
-	// Light probe
-	{
-		SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
-		m_EnvironmentTexture->CreateCubeMapFromFile(ReadString);
-		m_EnvironmentTexture->SetSlot(KEnvironmentTextureSlot);
-		m_EnvironmentCubemapRep->UnfoldCubemap(m_EnvironmentTexture->GetShaderResourceViewPtr());
+	UpdateSceneMaterial();
+}
 
-		SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
-		m_IrradianceTexture->CreateCubeMapFromFile(ReadString);
-		m_IrradianceTexture->SetSlot(KIrradianceTextureSlot);
-		m_IrradianceCubemapRep->UnfoldCubemap(m_IrradianceTexture->GetShaderResourceViewPtr());
+void CGame::ReadSceneLightProbe(CBinaryData& SceneBinaryData)
+{
+	string ReadString{};
 
-		SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
-		m_PrefilteredRadianceTexture->CreateCubeMapFromFile(ReadString);
-		m_PrefilteredRadianceTexture->SetSlot(KPrefilteredRadianceTextureSlot);
-		m_PrefilteredRadianceCubemapRep->UnfoldCubemap(m_PrefilteredRadianceTexture->GetShaderResourceViewPtr());
+	SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+	m_EnvironmentTexture->CreateCubeMapFromFile(ReadString);
+	m_EnvironmentTexture->SetSlot(KEnvironmentTextureSlot);
+	m_EnvironmentCubemapRep->UnfoldCubemap(m_EnvironmentTexture->GetShaderResourceViewPtr());
 
-		SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
-		m_IntegratedBRDFTexture->CreateCubeMapFromFile(ReadString);
-		m_IntegratedBRDFTexture->SetSlot(KIntegratedBRDFTextureSlot);
+	SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+	m_IrradianceTexture->CreateCubeMapFromFile(ReadString);
+	m_IrradianceTexture->SetSlot(KIrradianceTextureSlot);
+	m_IrradianceCubemapRep->UnfoldCubemap(m_IrradianceTexture->GetShaderResourceViewPtr());
 
-		UpdateCBGlobalLightProbeData();
-	}
+	SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+	m_PrefilteredRadianceTexture->CreateCubeMapFromFile(ReadString);
+	m_PrefilteredRadianceTexture->SetSlot(KPrefilteredRadianceTextureSlot);
+	m_PrefilteredRadianceCubemapRep->UnfoldCubemap(m_PrefilteredRadianceTexture->GetShaderResourceViewPtr());
 
-	// Directional & Ambient light
-	{
-		SceneBinaryData.ReadXMVECTOR(m_CBGlobalLightData.DirectionalLightDirection);
-		SceneBinaryData.ReadXMFLOAT3(m_CBGlobalLightData.DirectionalLightColor);
-		SceneBinaryData.ReadXMFLOAT3(m_CBGlobalLightData.AmbientLightColor);
-		SceneBinaryData.ReadFloat(m_CBGlobalLightData.AmbientLightIntensity);
-		SceneBinaryData.ReadFloat(m_CBGlobalLightData.Exposure);
+	SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+	m_IntegratedBRDFTexture->CreateCubeMapFromFile(ReadString);
+	m_IntegratedBRDFTexture->SetSlot(KIntegratedBRDFTextureSlot);
 
-		m_CBGlobalLight->Update();
-	}
+	UpdateCBGlobalLightProbeData();
+}
+
+void CGame::ReadSceneGlobalLight(CBinaryData& SceneBinaryData)
+{
+	SceneBinaryData.ReadXMVECTOR(m_CBGlobalLightData.DirectionalLightDirection);
+	SceneBinaryData.ReadXMFLOAT3(m_CBGlobalLightData.DirectionalLightColor);
+	SceneBinaryData.ReadXMFLOAT3(m_CBGlobalLightData.AmbientLightColor);
+	SceneBinaryData.ReadFloat(m_CBGlobalLightData.AmbientLightIntensity);
+	SceneBinaryData.ReadFloat(m_CBGlobalLightData.Exposure);
+
+	m_CBGlobalLight->Update();
 }
 
 void CGame::SaveScene(const string& FileName, const std::string& SceneContentDirectory)
 {
-	std::filesystem::remove_all(SceneContentDirectory.c_str());
-	std::filesystem::create_directory(SceneContentDirectory.c_str());
+	auto StartTimePoint{ steady_clock::now() };
 
-	CBinaryData SceneBinaryData{};
+	// @important: the content directory is kept, so that the terrain is written only when it has changed
+	std::error_code ErrorCode{};
+	std::filesystem::create_directories(SceneContentDirectory.c_str(), ErrorCode);
+
+	// @important: a failed save empties the save cache, so the second try serializes every object again
+	// (e.g. when the file of the last save has been changed or removed since)
+	if (!_SaveScene(FileName, SceneContentDirectory) && !_SaveScene(FileName, SceneContentDirectory))
+	{
+		MB_WARN(("   ߽ϴ. (" + FileName + ")").c_str(), "  ");
+	}
+
+	m_SceneSaveMilliseconds = std::chrono::duration<double, std::milli>(steady_clock::now() - StartTimePoint).count();
+}
+
+bool CGame::_SaveScene(const string& FileName, const std::string& SceneContentDirectory)
+{
+	std::error_code ErrorCode{};
+	CSceneContainer SceneContainer{};
+	CBinaryData ChunkBinary{};
 
 	// Scene Intelligence (Patterns)
 	{
-		SceneBinaryData.WriteUint32((uint32_t)m_vPatterns.size());
+		ChunkBinary.WriteUint32((uint32_t)m_vPatterns.size());
 		for (const auto& Pattern : m_vPatterns)
 		{
-			SceneBinaryData.WriteStringWithPrefixedLength(Pattern->GetFileName());
+			ChunkBinary.WriteStringWithPrefixedLength(Pattern->GetFileName());
 		}
+
+		SceneContainer.AddChunk(ESceneChunkType::Patterns, ChunkBinary);
 	}
 	
 	// Terrain
@@ -1251,85 +1485,118 @@ void CGame::SaveScene(const string& FileName, const std::string& SceneContentDir
 		{
 			if (m_Terrain->GetFileName().empty())
 			{
-				m_Terrain->Save(SceneContentDirectory + "terrain.terr");
+				m_Terrain->Save(SceneContentDirectory + "terrain.terr", m_bShouldCompressSavedFiles);
+			}
+			else if (m_Terrain->ShouldSave() || !std::filesystem::exists(m_Terrain->GetFileName(), ErrorCode))
+			{
+				m_Terrain->Save(m_Terrain->GetFileName(), m_bShouldCompressSavedFiles);
 			}
 
-			SceneBinaryData.WriteStringWithPrefixedLength(m_Terrain->GetFileName());
+			ChunkBinary.WriteStringWithPrefixedLength(m_Terrain->GetFileName());
 		}
 		else
 		{
-			SceneBinaryData.WriteUint32(0);
+			ChunkBinary.WriteUint32(0);
 		}
+
+		SceneContainer.AddChunk(ESceneChunkType::Terrain, ChunkBinary);
 	}
 
 	// Object3D
+	// @important: clean objects (see CObject3D::IsSaveDirty()) reuse their chunks of the last save instead of being serialized again
+	vector<vector<byte>> vObject3DBytes(m_vObject3Ds.size()); // empty for the clean objects
 	{
-		uint32_t Object3DCount{ (uint32_t)m_vObject3Ds.size() };
-		SceneBinaryData.WriteUint32(Object3DCount);
-		if (Object3DCount)
+		CBinaryData ObjectTableBinary{};
+		CBinaryData InstanceTableBinary{};
+		CBinaryData Object3DBinary{};
+
+		// @important: the instance table refers to the instances by index, so any dirty object might have changed it
+		bool bIsInstanceTableDirty{ m_bIsInstanceTableDirty ||
+			!CSceneContainer::IsChunkCached(m_SceneSaveCache, m_SavedInstanceTableHash, m_bShouldCompressSavedFiles) };
+		for (const auto& Object3D : m_vObject3Ds)
 		{
-			for (const auto& Object3D : m_vObject3Ds)
-			{
-				// @important: always save OB3D
-				{
-					Object3D->SaveOB3D(SceneContentDirectory + Object3D->GetName() + ".ob3d");
-				}
+			if (Object3D->IsSaveDirty()) bIsInstanceTableDirty = true;
+		}
 
-				SceneBinaryData.WriteStringWithPrefixedLength(Object3D->GetOB3DFileName());
+		ObjectTableBinary.WriteUint32((uint32_t)m_vObject3Ds.size());
+		for (size_t iObject3D = 0; iObject3D < m_vObject3Ds.size(); ++iObject3D)
+		{
+			const auto& Object3D{ m_vObject3Ds[iObject3D] };
+			ObjectTableBinary.WriteStringWithPrefixedLength(Object3D->GetName());
 
-				// @important
-				SceneBinaryData.WriteBool(Object3D->IsRigged());
+			// @important
+			ObjectTableBinary.WriteBool(Object3D->IsRigged());
 
-				EObjectRole eObjectRole{ m_PhysicsEngine.GetObjectRole(Object3D.get()) };
-				SceneBinaryData.WriteUint8((uint8_t)eObjectRole);
+			EObjectRole eObjectRole{ m_PhysicsEngine.GetObjectRole(Object3D.get()) };
+			ObjectTableBinary.WriteUint8((uint8_t)eObjectRole);
+
+			// instance
+			if (bIsInstanceTableDirty)
+			{
+				const auto& vInstanceCPUData{ Object3D->GetInstanceCPUDataVector() };
 
-				// instance
+				uint32_t PatternCount{};
+				for (const auto& InstanceCPUData : vInstanceCPUData)
 				{
-					SceneBinaryData.WriteBool(Object3D->IsInstanced());
-					if (Object3D->IsInstanced())
-					{
-						for (const auto& InstanceCPUData : Object3D->GetInstanceCPUDataVector())
-						{
-							SObjectIdentifier Identifier{ Object3D.get(), InstanceCPUData.Name };
+					if (m_Intelligence->HasPattern(SObjectIdentifier{ Object3D.get(), InstanceCPUData.Name })) ++PatternCount;
+				}
 
-							bool bHasPattern{ m_Intelligence->HasPattern(Identifier) };
-							SceneBinaryData.WriteBool(bHasPattern);
-							if (bHasPattern)
-							{
-								CPattern* Pattern{ m_Intelligence->GetPattern(Identifier) };
-								SceneBinaryData.WriteStringWithPrefixedLength(Pattern->GetFileName());
-							}
-						}
+				InstanceTableBinary.WriteUint32(PatternCount);
+				for (uint32_t iInstance = 0; iInstance < (uint32_t)vInstanceCPUData.size(); ++iInstance)
+				{
+					SObjectIdentifier Identifier{ Object3D.get(), vInstanceCPUData[iInstance].Name };
+					if (m_Intelligence->HasPattern(Identifier))
+					{
+						CPattern* Pattern{ m_Intelligence->GetPattern(Identifier) };
+						InstanceTableBinary.WriteUint32(iInstance);
+						InstanceTableBinary.WriteStringWithPrefixedLength(Pattern->GetFileName());
 					}
 				}
 			}
+
+			// @important: OB3Ds are embedded in the scene
+			if (Object3D->IsSaveDirty() ||
+				!CSceneContainer::IsChunkCached(m_SceneSaveCache, Object3D->GetSavedChunkHash(), m_bShouldCompressSavedFiles))
+			{
+				Object3D->SaveOB3D(Object3DBinary);
+				vObject3DBytes[iObject3D] = Object3DBinary.MoveBytes();
+			}
 		}
-	}
 
-	// Editor camera
-	{
-		SceneBinaryData.WriteUint32((uint32_t)m_EditorCamera->GetType());
-		SceneBinaryData.WriteXMVECTOR(m_EditorCamera->GetTranslation());
-		SceneBinaryData.WriteFloat(m_EditorCamera->GetPitch());
-		SceneBinaryData.WriteFloat(m_EditorCamera->GetYaw());
-		SceneBinaryData.WriteFloat(m_EditorCamera->GetMovementFactor());
+		SceneContainer.AddChunk(ESceneChunkType::ObjectTable, ObjectTableBinary);
+		if (bIsInstanceTableDirty)
+		{
+			SceneContainer.AddChunk(ESceneChunkType::InstanceTable, InstanceTableBinary);
+		}
+		else
+		{
+			SceneContainer.AddCachedChunk(ESceneChunkType::InstanceTable, m_SavedInstanceTableHash);
+		}
 	}
 
-	// Camera
+	// Editor camera & Camera
 	{
+		ChunkBinary.WriteUint32((uint32_t)m_EditorCamera->GetType());
+		ChunkBinary.WriteXMVECTOR(m_EditorCamera->GetTranslation());
+		ChunkBinary.WriteFloat(m_EditorCamera->GetPitch());
+		ChunkBinary.WriteFloat(m_EditorCamera->GetYaw());
+		ChunkBinary.WriteFloat(m_EditorCamera->GetMovementFactor());
+
 		uint32_t CameraCount{ (uint32_t)m_vCameras.size() };
-		SceneBinaryData.WriteUint32(CameraCount);
+		ChunkBinary.WriteUint32(CameraCount);
 		for (const auto& Camera : m_vCameras)
 		{
-			SceneBinaryData.WriteStringWithPrefixedLength(Camera->GetName());
-			SceneBinaryData.WriteUint32((uint32_t)Camera->GetType());
-			SceneBinaryData.WriteXMVECTOR(Camera->GetTranslation());
-			SceneBinaryData.WriteFloat(Camera->GetPitch());
-			SceneBinaryData.WriteFloat(Camera->GetYaw());
-			SceneBinaryData.WriteFloat(Camera->GetMovementFactor());
-			SceneBinaryData.WriteFloat(Camera->GetZoomDistance());
-			SceneBinaryData.WriteBool(IsPlayerCamera(Camera.get()));
+			ChunkBinary.WriteStringWithPrefixedLength(Camera->GetName());
+			ChunkBinary.WriteUint32((uint32_t)Camera->GetType());
+			ChunkBinary.WriteXMVECTOR(Camera->GetTranslation());
+			ChunkBinary.WriteFloat(Camera->GetPitch());
+			ChunkBinary.WriteFloat(Camera->GetYaw());
+			ChunkBinary.WriteFloat(Camera->GetMovementFactor());
+			ChunkBinary.WriteFloat(Camera->GetZoomDistance());
+			ChunkBinary.WriteBool(IsPlayerCamera(Camera.get()));
 		}
+
+		SceneContainer.AddChunk(ESceneChunkType::Cameras, ChunkBinary);
 	}
 
 	// LightArray
@@ -1337,10 +1604,10 @@ void CGame::SaveScene(const string& FileName, const std::string& SceneContentDir
 		for (auto& Light : m_LightArray)
 		{
 			uint32_t LightType{ (uint32_t)Light->GetType() };
-			SceneBinaryData.WriteUint32(LightType);
+			ChunkBinary.WriteUint32(LightType);
 
 			uint32_t LightCount{ (uint32_t)Light->GetInstanceCount() };
-			SceneBinaryData.WriteUint32(LightCount);
+			ChunkBinary.WriteUint32(LightCount);
 
 			if (LightCount)
 			{
@@ -1349,47 +1616,269 @@ void CGame::SaveScene(const string& FileName, const std::string& SceneContentDir
 					const auto& InstanceCPUData{ Light->GetInstanceCPUData(LightPair.first) };
 					const auto& InstanceGPUData{ Light->GetInstanceGPUData(LightPair.first) };
 
-					SceneBinaryData.WriteStringWithPrefixedLength(InstanceCPUData.Name);
-					SceneBinaryData.WriteUint32((uint32_t)InstanceCPUData.eType);
+					ChunkBinary.WriteStringWithPrefixedLength(InstanceCPUData.Name);
+					ChunkBinary.WriteUint32((uint32_t)InstanceCPUData.eType);
 
-					SceneBinaryData.WriteXMVECTOR(InstanceGPUData.Position);
-					SceneBinaryData.WriteXMVECTOR(InstanceGPUData.Color);
-					SceneBinaryData.WriteXMVECTOR(InstanceGPUData.Direction);
-					SceneBinaryData.WriteFloat(InstanceGPUData.Range);
-					SceneBinaryData.WriteFloat(InstanceGPUData.Theta);
+					ChunkBinary.WriteXMVECTOR(InstanceGPUData.Position);
+					ChunkBinary.WriteXMVECTOR(InstanceGPUData.Color);
+					ChunkBinary.WriteXMVECTOR(InstanceGPUData.Direction);
+					ChunkBinary.WriteFloat(InstanceGPUData.Range);
+					ChunkBinary.WriteFloat(InstanceGPUData.Theta);
 				}
 			}
 		}
+
+		SceneContainer.AddChunk(ESceneChunkType::Lights, ChunkBinary);
 	}
 
 	// Scene material
 	{
-		SceneBinaryData.WriteStringWithPrefixedLength(m_SceneMaterial->GetTextureFileName(ETextureType::BaseColorTexture));
-		SceneBinaryData.WriteStringWithPrefixedLength(m_SceneMaterial->GetTextureFileName(ETextureType::NormalTexture));
-		SceneBinaryData.WriteStringWithPrefixedLength(m_SceneMaterial->GetTextureFileName(ETextureType::OpacityTexture));
-		SceneBinaryData.WriteStringWithPrefixedLength(m_SceneMaterial->GetTextureFileName(ETextureType::RoughnessTexture));
-		SceneBinaryData.WriteStringWithPrefixedLength(m_SceneMaterial->GetTextureFileName(ETextureType::MetalnessTexture));
-		SceneBinaryData.WriteStringWithPrefixedLength(m_SceneMaterial->GetTextureFileName(ETextureType::AmbientOcclusionTexture));
+		ChunkBinary.WriteStringWithPrefixedLength(m_SceneMaterial->GetTextureFileName(ETextureType::BaseColorTexture));
+		ChunkBinary.WriteStringWithPrefixedLength(m_SceneMaterial->GetTextureFileName(ETextureType::NormalTexture));
+		ChunkBinary.WriteStringWithPrefixedLength(m_SceneMaterial->GetTextureFileName(ETextureType::OpacityTexture));
+		ChunkBinary.WriteStringWithPrefixedLength(m_SceneMaterial->GetTextureFileName(ETextureType::RoughnessTexture));
+		ChunkBinary.WriteStringWithPrefixedLength(m_SceneMaterial->GetTextureFileName(ETextureType::MetalnessTexture));
+		ChunkBinary.WriteStringWithPrefixedLength(m_SceneMaterial->GetTextureFileName(ETextureType::AmbientOcclusionTexture));
+
+		SceneContainer.AddChunk(ESceneChunkType::SceneMaterial, ChunkBinary);
 	}
 
 	// Light probe
 	{
-		SceneBinaryData.WriteStringWithPrefixedLength(m_EnvironmentTexture->GetFileName());
-		SceneBinaryData.WriteStringWithPrefixedLength(m_IrradianceTexture->GetFileName());
-		SceneBinaryData.WriteStringWithPrefixedLength(m_PrefilteredRadianceTexture->GetFileName());
-		SceneBinaryData.WriteStringWithPrefixedLength(m_IntegratedBRDFTexture->GetFileName());
+		ChunkBinary.WriteStringWithPrefixedLength(m_EnvironmentTexture->GetFileName());
+		ChunkBinary.WriteStringWithPrefixedLength(m_IrradianceTexture->GetFileName());
+		ChunkBinary.WriteStringWithPrefixedLength(m_PrefilteredRadianceTexture->GetFileName());
+		ChunkBinary.WriteStringWithPrefixedLength(m_IntegratedBRDFTexture->GetFileName());
+
+		SceneContainer.AddChunk(ESceneChunkType::LightProbe, ChunkBinary);
 	}
 
 	// Directional & Ambient light
 	{
-		SceneBinaryData.WriteXMVECTOR(m_CBGlobalLightData.DirectionalLightDirection);
-		SceneBinaryData.WriteXMFLOAT3(m_CBGlobalLightData.DirectionalLightColor);
-		SceneBinaryData.WriteXMFLOAT3(m_CBGlobalLightData.AmbientLightColor);
-		SceneBinaryData.WriteFloat(m_CBGlobalLightData.AmbientLightIntensity);
-		SceneBinaryData.WriteFloat(m_CBGlobalLightData.Exposure);
+		ChunkBinary.WriteXMVECTOR(m_CBGlobalLightData.DirectionalLightDirection);
+		ChunkBinary.WriteXMFLOAT3(m_CBGlobalLightData.DirectionalLightColor);
+		ChunkBinary.WriteXMFLOAT3(m_CBGlobalLightData.AmbientLightColor);
+		ChunkBinary.WriteFloat(m_CBGlobalLightData.AmbientLightIntensity);
+		ChunkBinary.WriteFloat(m_CBGlobalLightData.Exposure);
+
+		SceneContainer.AddChunk(ESceneChunkType::GlobalLight, ChunkBinary);
+	}
+
+	// @important: the OB3D chunks (the big ones) come last, so that all the small chunks are read from the first few pages
+	for (size_t iObject3D = 0; iObject3D < vObject3DBytes.size(); ++iObject3D)
+	{
+		if (vObject3DBytes[iObject3D].empty())
+		{
+			SceneContainer.AddCachedChunk(ESceneChunkType::Object3D, m_vObject3Ds[iObject3D]->GetSavedChunkHash());
+		}
+		else
+		{
+			SceneContainer.AddChunk(ESceneChunkType::Object3D, std::move(vObject3DBytes[iObject3D]));
+		}
 	}
 	
-	SceneBinaryData.SaveToFile(FileName);
+	// @important: only the chunks that have changed since the last save or load are compressed again
+	if (!SceneContainer.SaveToFile(FileName, m_bShouldCompressSavedFiles, &m_SceneSaveCache)) return false;
+
+	for (size_t iObject3D = 0; iObject3D < m_vObject3Ds.size(); ++iObject3D)
+	{
+		m_vObject3Ds[iObject3D]->ClearSaveDirty(SceneContainer.GetChunkRawHash(ESceneChunkType::Object3D, (uint32_t)iObject3D));
+	}
+	m_SavedInstanceTableHash = SceneContainer.GetChunkRawHash(ESceneChunkType::InstanceTable);
+	m_bIsInstanceTableDirty = false;
+	return true;
+}
+
+bool CGame::ConvertLegacyScene(const string& LegacyFileName, const string& FileName)
+{
+	if (CSceneContainer::IsSceneContainer(LegacyFileName)) return false;
+
+	CBinaryData SceneBinaryData{};
+	if (!SceneBinaryData.LoadFromMappedFile(LegacyFileName)) return false;
+
+	CSceneContainer SceneContainer{};
+	CBinaryData ChunkBinary{};
+	string ReadString{};
+	bool bIsValid{ true };
+
+	// @important: the chunks except the object ones have the same layout as the legacy sections
+	auto CopyString{ [&]()
+		{
+			SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+			ChunkBinary.WriteStringWithPrefixedLength(ReadString);
+		}
+	};
+	auto CopyBytes{ [&](size_t ByteCount)
+		{
+			const byte* PtrBytes{};
+			if (SceneBinaryData.ReadBytesInPlace(ByteCount, PtrBytes))
+			{
+				ChunkBinary.WriteArray(PtrBytes, ByteCount, 1);
+			}
+			else
+			{
+				bIsValid = false;
+			}
+		}
+	};
+	auto CopyUint32{ [&]()
+		{
+			uint32_t Value{ SceneBinaryData.ReadUint32() };
+			ChunkBinary.WriteUint32(Value);
+			return Value;
+		}
+	};
+
+	// Scene Intelligence (Patterns)
+	{
+		uint32_t PatternCount{ CopyUint32() };
+		for (uint32_t iPattern = 0; iPattern < PatternCount; ++iPattern)
+		{
+			CopyString();
+		}
+
+		SceneContainer.AddChunk(ESceneChunkType::Patterns, ChunkBinary);
+	}
+
+	// Terrain
+	{
+		CopyString();
+
+		SceneContainer.AddChunk(ESceneChunkType::Terrain, ChunkBinary);
+	}
+
+	// Object3D
+	vector<vector<byte>> vObject3DBytes{};
+	{
+		CBinaryData ObjectTableBinary{};
+		CBinaryData InstanceTableBinary{};
+		CBinaryData Object3DBinary{};
+		string Object3DName{};
+		uint32_t InstanceCount{};
+		vector<uint32_t> vPatternInstanceIndices{};
+		vector<string> vPatternFileNames{};
+
+		uint32_t Object3DCount{ SceneBinaryData.ReadUint32() };
+		ObjectTableBinary.WriteUint32(Object3DCount);
+		for (uint32_t iObject3D = 0; iObject3D < Object3DCount; ++iObject3D)
+		{
+			SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+			bool bIsRigged{ SceneBinaryData.ReadBool() };
+			uint8_t ObjectRole{ SceneBinaryData.ReadUint8() };
+
+			// @important: the OB3D file is embedded as it is
+			if (!Object3DBinary.LoadFromFile(ReadString)) return false;
+			if (!CObject3D::ReadOB3DSummary(Object3DBinary, Object3DName, InstanceCount)) return false;
+
+			ObjectTableBinary.WriteStringWithPrefixedLength(Object3DName);
+			ObjectTableBinary.WriteBool(bIsRigged);
+			ObjectTableBinary.WriteUint8(ObjectRole);
+
+			// instance
+			{
+				vPatternInstanceIndices.clear();
+				vPatternFileNames.clear();
+
+				bool bIsInstanced{ SceneBinaryData.ReadBool() };
+				if (bIsInstanced)
+				{
+					for (uint32_t iInstance = 0; iInstance < InstanceCount; ++iInstance)
+					{
+						bool bHasPattern{ SceneBinaryData.ReadBool() };
+						if (bHasPattern)
+						{
+							SceneBinaryData.ReadStringWithPrefixedLength(ReadString);
+							vPatternInstanceIndices.emplace_back(iInstance);
+							vPatternFileNames.emplace_back(ReadString);
+						}
+					}
+				}
+
+				InstanceTableBinary.WriteUint32((uint32_t)vPatternInstanceIndices.size());
+				for (size_t iPattern = 0; iPattern < vPatternInstanceIndices.size(); ++iPattern)
+				{
+					InstanceTableBinary.WriteUint32(vPatternInstanceIndices[iPattern]);
+					InstanceTableBinary.WriteStringWithPrefixedLength(vPatternFileNames[iPattern]);
+				}
+			}
+
+			vObject3DBytes.emplace_back(Object3DBinary.MoveBytes());
+		}
+
+		SceneContainer.AddChunk(ESceneChunkType::ObjectTable, ObjectTableBinary);
+		SceneContainer.AddChunk(ESceneChunkType::InstanceTable, InstanceTableBinary);
+	}
+
+	// Editor camera & Camera
+	{
+		CopyBytes(4 + 16 + 4 * 3);
+
+		uint32_t CameraCount{ CopyUint32() };
+		for (uint32_t iCamera = 0; iCamera < CameraCount; ++iCamera)
+		{
+			CopyString();
+			CopyBytes(4 + 16 + 4 * 4 + 1);
+		}
+
+		SceneContainer.AddChunk(ESceneChunkType::Cameras, ChunkBinary);
+	}
+
+	// Light
+	{
+		for (uint32_t iLightType = 0; iLightType < CLight::KLightTypeCount; ++iLightType)
+		{
+			CopyUint32(); // Light type
+
+			uint32_t LightCount{ CopyUint32() };
+			for (uint32_t iLight = 0; iLight < LightCount; ++iLight)
+			{
+				CopyString();
+				CopyBytes(4 + 16 * 3 + 4 * 2);
+			}
+		}
+
+		SceneContainer.AddChunk(ESceneChunkType::Lights, ChunkBinary);
+	}
+
+	// Scene material
+	{
+		for (uint32_t iTexture = 0; iTexture < 6; ++iTexture)
+		{
+			CopyString();
+		}
+
+		SceneContainer.AddChunk(ESceneChunkType::SceneMaterial, ChunkBinary);
+	}
+
+	// Light probe
+	{
+		for (uint32_t iTexture = 0; iTexture < 4; ++iTexture)
+		{
+			CopyString();
+		}
+
+		SceneContainer.AddChunk(ESceneChunkType::LightProbe, ChunkBinary);
+	}
+
+	// Directional & Ambient light
+	{
+		CopyBytes(16 + 4 * 3 + 4 * 3 + 4 + 4);
+
+		SceneContainer.AddChunk(ESceneChunkType::GlobalLight, ChunkBinary);
+	}
+
+	for (auto& vBytes : vObject3DBytes)
+	{
+		SceneContainer.AddChunk(ESceneChunkType::Object3D, std::move(vBytes));
+	}
+
+	// @important: every byte of the legacy file must have been consumed
+	if (!bIsValid || SceneBinaryData.GetRemainingByteCount() != 0) return false;
+
+	if (!SceneContainer.SaveToFile(FileName)) return false;
+
+	CSceneContainer WrittenSceneContainer{};
+	return WrittenSceneContainer.Open(FileName) && WrittenSceneContainer.Verify();
 }
 
 void CGame::SetProjectionMatrices(float FOV, float NearZ, float FarZ)
@@ -1487,12 +1976,6 @@ void CGame::UpdateCBSpace(const XMMATRIX& World, const XMMATRIX& Projection)
 	m_CBSpace->Update();
 }
 
-void CGame::UpdateCBAnimationBoneMatrices(const XMMATRIX* const BoneMatrices)
-{
-	memcpy(m_CBAnimationBonesData.BoneMatrices, BoneMatrices, sizeof(SCBAnimationBonesData));
-	m_CBAnimationBones->Update();
-}
-
 void CGame::UpdateCBAnimationData(const CObject3D::SCBAnimationData& Data)
 {
 	m_CBAnimationData = Data;
@@ -1763,12 +2246,26 @@ void CGame::LoadTerrain(const string& TerrainFileName)
 	UpdateCBTerrainMaskingSpace(m_Terrain->GetMaskingSpaceData());
 }
 
+void CGame::LoadTerrain(std::unique_ptr<STERRData> TerrainFileData)
+{
+	if (!TerrainFileData)
+	{
+		m_Terrain.reset();
+		return;
+	}
+
+	m_Terrain = make_unique<CTerrain>(m_Device.Get(), m_DeviceContext.Get(), this);
+	m_Terrain->Load(std::move(TerrainFileData));
+	UpdateCBTerrainData(m_Terrain->GetTerrainData());
+	UpdateCBTerrainMaskingSpace(m_Terrain->GetMaskingSpaceData());
+}
+
 void CGame::SaveTerrain(const string& TerrainFileName)
 {
 	if (!m_Terrain) return;
 	if (TerrainFileName.empty()) return;
 
-	m_Terrain->Save(TerrainFileName);
+	m_Terrain->Save(TerrainFileName, m_bShouldCompressSavedFiles);
 }
 
 void CGame::ClearCopyList()
@@ -2222,6 +2719,7 @@ bool CGame::InsertObject3D(const string& Name)
 	{
 		m_vObject3Ds.emplace_back(make_unique<CObject3D>(Name, m_Device.Get(), m_DeviceContext.Get()));
 		m_mapObject3DNameToIndex[Name] = m_vObject3Ds.size() - 1;
+		m_bIsInstanceTableDirty = true;
 
 		return true;
 	}
@@ -2283,12 +2781,14 @@ void CGame::DeleteObject3D(const string& Name)
 	string SavedName{ Name };
 	m_vObject3Ds.pop_back();
 	m_mapObject3DNameToIndex.erase(SavedName);
+	m_bIsInstanceTableDirty = true;
 }
 
 void CGame::ClearObject3Ds()
 {
 	m_mapObject3DNameToIndex.clear();
 	m_vObject3Ds.clear();
+	m_bIsInstanceTableDirty = true;
 	DeselectType(EObjectType::Object3D);
 }
 
@@ -2305,6 +2805,7 @@ CObject3D* CGame::GetObject3D(const string& Name, bool bShowWarning) const
 void CGame::DeleteObject3DInstance(CObject3D* Object3D, const std::string& Name)
 {
 	m_Intelligence->DeregisterPattern(SObjectIdentifier(Object3D, Name));
+	m_bIsInstanceTableDirty = true;
 
 	Object3D->DeleteInstance(Name);
 }
@@ -3615,6 +4116,20 @@ void CGame::Update3DGizmos()
 
 void CGame::BeginRendering(const FLOAT* ClearColor)
 {
+	// @important: the previous frame might have been finished by someone who doesn't go through the state cache
+	CStateCache& StateCache{ CStateCache::Get(m_DeviceContext.Get()) };
+	StateCache.Invalidate();
+	StateCache.ResetCounters();
+
+	if (m_ConstantBufferRing) m_ConstantBufferRing->BeginFrame();
+
+	// @important: LoadScene() might have been called in the middle of the previous frame
+	if (m_bIsSceneFirstFramePending)
+	{
+		m_bIsSceneFirstFramePending = false;
+		m_bIsDrawingSceneFirstFrame = true;
+	}
+
 	ID3D11SamplerState* LinearWrapSampler{ m_CommonStates->LinearWrap() };
 	ID3D11SamplerState* LinearClampSampler{ m_CommonStates->LinearClamp() };
 	m_DeviceContext->PSSetSamplers(0, 1, &LinearWrapSampler);
@@ -3625,6 +4140,9 @@ void CGame::BeginRendering(const FLOAT* ClearColor)
 
 	m_MatrixView = m_PtrCurrentCamera->GetViewMatrix();
 
+	BoundingFrustum::CreateFromMatrix(m_ViewFrustum, m_MatrixProjection);
+	m_ViewFrustum.Transform(m_ViewFrustum, XMMatrixInverse(nullptr, m_MatrixView));
+
 	if (m_EnvironmentTexture) m_EnvironmentTexture->Use();
 	if (m_IrradianceTexture) m_IrradianceTexture->Use();
 	if (m_PrefilteredRadianceTexture) m_PrefilteredRadianceTexture->Use();
@@ -3676,6 +4194,9 @@ void CGame::Update()
 		m_CBTerrainData.Time = m_CBEditorTimeData.NormalizedTime;
 	}
 
+	// Scene loading (GPU stage)
+	if (m_SceneLoadingData) UpdateSceneLoading(KSceneLoadingBudgetMilliseconds);
+
 	// Capture inputs
 	m_CapturedKeyboardState = GetKeyState();
 	m_CapturedMouseState = GetMouseState();
@@ -3879,6 +4400,15 @@ void CGame::Draw()
 		SetUniversalRSState();
 	}
 
+	// @important: every object is animated once per frame, before any pass (shadow cascades draw the same objects again)
+	AnimateObject3Ds();
+	CullObject3Ds();
+	UpdateObject3DMaterialSets();
+
+	m_DrawPacketCount = 0;
+	m_DrawStateChangeCount = 0;
+	m_AvoidedDrawStateChangeCount = 0;
+
 	// Deferred shading
 	{
 		// @important
@@ -3897,44 +4427,18 @@ void CGame::Draw()
 		DrawTerrainOpaqueParts(m_DeltaTime_s);
 
 		// Opaque Object3Ds
-		DrawOpaqueObject3Ds();
+		DrawOpaqueObject3Ds(false, false, &m_vVisibleObject3DIndices, true);
 
 		if (bShouldDrawNormals)
 		{
-			m_DeviceContext->GSSetShader(nullptr, nullptr, 0);
+			CShader::Unbind(m_DeviceContext.Get(), EShaderType::GeometryShader);
 		}
 
 		// Directional light shadow map
 		{
 			m_bIsDeferredRenderTargetsSet = false;
 
-			XMMATRIX SavedViewMatrix{ m_MatrixView };
-			XMMATRIX SavedProjectionMatrix{ m_MatrixProjection };
-
-			const XMVECTOR& EyePosition{ m_PtrCurrentCamera->GetEyePosition() };
-			const XMVECTOR& ViewDirection{ m_PtrCurrentCamera->GetForward() };
-
-			size_t LODCount{ m_CascadedShadowMap->GetLODCount() };
-			m_CBShadowMapData.LODCount = static_cast<uint32_t>(LODCount);
-			for (size_t iLOD = 0; iLOD < LODCount; ++iLOD)
-			{
-				if (m_CascadedShadowMap->ShouldUpdate(iLOD))
-				{
-					m_CascadedShadowMap->Set(iLOD, SavedProjectionMatrix, EyePosition, ViewDirection, m_CBGlobalLightData.DirectionalLightDirection);
-
-					// @important
-					m_MatrixView = m_CascadedShadowMap->GetViewMatrix(iLOD);
-					m_MatrixProjection = m_CascadedShadowMap->GetProjectionMatrix(iLOD);
-					m_CBShadowMapData.ShadowMapSpaceMatrix[iLOD] = m_CascadedShadowMap->GetTransposedSpaceMatrix(iLOD);
-					if (iLOD < CCascadedShadowMap::KLODCountMax) m_CBShadowMapData.ShadowMapZFars[iLOD] = m_CascadedShadowMap->GetZFar(iLOD);
-
-					DrawOpaqueObject3Ds(true, true);
-				}
-			}
-
-			m_DeviceContext->RSSetViewports(1, &m_vViewports[0]);
-			m_MatrixView = SavedViewMatrix;
-			m_MatrixProjection = SavedProjectionMatrix;
+			DrawShadowCascades();
 		}
 
 		// @important
@@ -4010,8 +4514,8 @@ void CGame::Draw()
 				m_LightArray[1]->Light();
 			}
 
-			m_DeviceContext->HSSetShader(nullptr, nullptr, 0);
-			m_DeviceContext->DSSetShader(nullptr, nullptr, 0);
+			CShader::Unbind(m_DeviceContext.Get(), EShaderType::HullShader);
+			CShader::Unbind(m_DeviceContext.Get(), EShaderType::DomainShader);
 
 			m_DeviceContext->OMSetBlendState(nullptr, nullptr, 0xFFFFFFFF);
 			SetUniversalRSState();
@@ -4132,13 +4636,13 @@ void CGame::Draw()
 		m_DeviceContext->OMSetBlendState(m_CommonStates->NonPremultiplied(), nullptr, 0xFFFFFFFF);
 
 		// Transparent Object3Ds
-		for (auto& Object3D : m_vObject3Ds)
+		for (auto iObject3D : m_vVisibleObject3DIndices)
 		{
+			auto& Object3D{ m_vObject3Ds[iObject3D] };
 			if (!Object3D->IsTransparent()) continue;
 
-			Object3D->Animate(m_DeltaTime_s);
 			Object3D->UpdateWorldMatrix();
-			DrawObject3D(Object3D.get());
+			DrawObject3D(Object3D.get(), EFlagsObject3DRendering::DrawVisibleInstances);
 
 			if (EFLAG_HAS(m_eFlagsRendering, EFlagsRendering::DrawBoundingVolumes))
 			{
@@ -4149,7 +4653,7 @@ void CGame::Draw()
 
 		if (bShouldDrawNormals)
 		{
-			m_DeviceContext->GSSetShader(nullptr, nullptr, 0);
+			CShader::Unbind(m_DeviceContext.Get(), EShaderType::GeometryShader);
 		}
 	}
 
@@ -4182,8 +4686,8 @@ void CGame::Draw()
 			m_LightArray[1]->Light();
 		}
 
-		m_DeviceContext->HSSetShader(nullptr, nullptr, 0);
-		m_DeviceContext->DSSetShader(nullptr, nullptr, 0);
+		CShader::Unbind(m_DeviceContext.Get(), EShaderType::HullShader);
+		CShader::Unbind(m_DeviceContext.Get(), EShaderType::DomainShader);
 
 		SetUniversalRSState();
 	}
@@ -4191,7 +4695,7 @@ void CGame::Draw()
 	// Object2D & BMFontRenderer & Billboard
 	{
 		m_DeviceContext->OMSetDepthStencilState(m_CommonStates->DepthNone(), 0);
-		m_DeviceContext->GSSetShader(nullptr, nullptr, 0);
+		CShader::Unbind(m_DeviceContext.Get(), EShaderType::GeometryShader);
 
 		DrawObject2Ds();
 
@@ -4211,55 +4715,492 @@ void CGame::Draw()
 	}
 }
 
-void CGame::DrawOpaqueObject3Ds(bool bIgnoreOwnTexture, bool bUseVoidPS)
+void CGame::AnimateObject3Ds()
 {
-	// Opaque Object3Ds
+	// @important: CPU-skinned palettes are packed into one buffer and uploaded once, instead of a constant buffer update per draw
+	m_BonePaletteBuffer->Reset();
 	for (auto& Object3D : m_vObject3Ds)
 	{
-		if (Object3D->IsTransparent()) continue;
-		if (Object3D->IsRigged())
+		if (!Object3D->IsRigged()) continue;
+
+		Object3D->UpdateAnimationLOD(m_PtrCurrentCamera->GetEyePosition(), m_ViewFrustum);
+		Object3D->Animate(m_DeltaTime_s);
+
+		if (!Object3D->GetAnimationData().bUseGPUSkinning && Object3D->GetAnimationBoneMatrixCount())
+		{
+			Object3D->SetAnimationBoneMatrixOffset(
+				m_BonePaletteBuffer->Allocate(Object3D->GetAnimationBoneMatrices(), Object3D->GetAnimationBoneMatrixCount()));
+		}
+	}
+	m_BonePaletteBuffer->Upload();
+}
+
+void CGame::CullObject3Ds()
+{
+	auto StartTimePoint{ steady_clock::now() };
+
+	// @important: once per frame before any test or pass, so that every pass (recorded on any thread) only reads them
+	for (auto& Object3D : m_vObject3Ds)
+	{
+		Object3D->UpdateWorldMatrix();
+	}
+
+	m_FrustumCuller.SetFrustum(m_ViewFrustum);
+
+	const COcclusionCuller* PtrOcclusionCuller{};
+	if (m_bUseOcclusionCulling)
+	{
+		RasterizeOccluders();
+		PtrOcclusionCuller = &m_OcclusionCuller;
+	}
+
+	m_Object3DTotalInstanceCount = 0;
+	m_Object3DCulledInstanceCount = 0;
+	m_vObject3DBoundingSpheres.clear();
+	m_vObject3DCullingCandidateIndices.clear();
+	m_vVisibleObject3DIndices.clear();
+	for (uint32_t iObject3D = 0; iObject3D < (uint32_t)m_vObject3Ds.size(); ++iObject3D)
+	{
+		CObject3D* const Object3D{ m_vObject3Ds[iObject3D].get() };
+		if (Object3D->IsInstanced())
+		{
+			size_t InstanceCount{ Object3D->GetInstanceCount() };
+			size_t VisibleInstanceCount{ Object3D->CullInstances(m_FrustumCuller, PtrOcclusionCuller) };
+			m_Object3DTotalInstanceCount += InstanceCount;
+			m_Object3DCulledInstanceCount += InstanceCount - VisibleInstanceCount;
+			if (VisibleInstanceCount) m_vVisibleObject3DIndices.emplace_back(iObject3D);
+		}
+		else
+		{
+			// @important: non-instanced objects are tested together below
+			XMFLOAT4 BoundingSphere{};
+			XMStoreFloat4(&BoundingSphere, XMVectorSetW(
+				Object3D->GetTransform().Translation + Object3D->GetOuterBoundingSphereCenterOffset(), Object3D->GetOuterBoundingSphereRadius()));
+			m_vObject3DBoundingSpheres.emplace_back(BoundingSphere);
+			m_vObject3DCullingCandidateIndices.emplace_back(iObject3D);
+		}
+	}
+
+	if (m_vObject3DBoundingSpheres.size())
+	{
+		size_t VisibleIndexStart{ m_vVisibleObject3DIndices.size() };
+		m_FrustumCuller.Cull(&m_vObject3DBoundingSpheres[0], (uint32_t)m_vObject3DBoundingSpheres.size(), m_vVisibleObject3DIndices);
+
+		// @important: occluded candidates are compacted out in place
+		size_t VisibleEnd{ VisibleIndexStart };
+		for (size_t iVisible = VisibleIndexStart; iVisible < m_vVisibleObject3DIndices.size(); ++iVisible)
 		{
-			UpdateCBAnimationData(Object3D->GetAnimationData());
+			uint32_t iCandidate{ m_vVisibleObject3DIndices[iVisible] };
+			if (PtrOcclusionCuller && !PtrOcclusionCuller->IsVisible(m_vObject3DBoundingSpheres[iCandidate])) continue;
 
-			if (!Object3D->HasBakedAnimationTexture())
+			m_vVisibleObject3DIndices[VisibleEnd++] = m_vObject3DCullingCandidateIndices[iCandidate];
+		}
+		m_vVisibleObject3DIndices.resize(VisibleEnd);
+		m_Object3DTotalInstanceCount += m_vObject3DBoundingSpheres.size();
+		m_Object3DCulledInstanceCount += m_vObject3DBoundingSpheres.size() - (VisibleEnd - VisibleIndexStart);
+
+		// @important: keep the draw order of m_vObject3Ds
+		std::sort(m_vVisibleObject3DIndices.begin(), m_vVisibleObject3DIndices.end());
+	}
+
+	m_Object3DCullingMicroseconds = std::chrono::duration<double, std::micro>(steady_clock::now() - StartTimePoint).count();
+
+	// @important: mesh LODs are picked from the main view and reused by the shadow passes, so that shadows match what is seen
+	for (auto& Object3D : m_vObject3Ds)
+	{
+		Object3D->UpdateMeshLOD(m_PtrCurrentCamera->GetEyePosition(), XMVectorGetY(m_MatrixProjection.r[1]));
+	}
+	m_MeshLODTriangleCount = 0;
+	m_MeshLOD0TriangleCount = 0;
+	for (uint32_t iObject3D : m_vVisibleObject3DIndices)
+	{
+		const CObject3D* const Object3D{ m_vObject3Ds[iObject3D].get() };
+		size_t InstanceCount{ (Object3D->IsInstanced()) ? Object3D->GetVisibleInstanceCount() : 1 };
+		m_MeshLODTriangleCount += Object3D->GetMeshLODTriangleCount(Object3D->GetCurrentMeshLOD()) * InstanceCount;
+		m_MeshLOD0TriangleCount += Object3D->GetMeshLODTriangleCount(0) * InstanceCount;
+	}
+
+	// @important: instances changed by the editor or animation are uploaded once per frame, before any pass uses them
+	m_InstanceUploadedByteCount = 0;
+	for (const auto& Object3D : m_vObject3Ds)
+	{
+		if (Object3D->IsInstanced()) m_InstanceUploadedByteCount += Object3D->FlushInstanceBuffer();
+	}
+}
+
+void CGame::RasterizeOccluders()
+{
+	auto StartTimePoint{ steady_clock::now() };
+
+	m_OcclusionCuller.BeginFrame(m_MatrixView * m_MatrixProjection, m_PtrCurrentCamera->GetEyePosition());
+	for (const auto& Object3D : m_vObject3Ds)
+	{
+		Object3D->AddOccluders(m_OcclusionCuller, m_FrustumCuller);
+	}
+	m_OcclusionCuller.RasterizeOccluders(&m_FrameTaskScheduler);
+
+	m_OcclusionRasterizationMicroseconds = std::chrono::duration<double, std::micro>(steady_clock::now() - StartTimePoint).count();
+}
+
+void CGame::UpdateObject3DMaterialSets()
+{
+	// @important: numbered every frame, so that the sets never run out of the sort key's bits however the materials are edited
+	m_umapMaterialSets.clear();
+	m_vObject3DMaterialSetOffsets.resize(m_vObject3Ds.size());
+	m_vObject3DMaterialSets.clear();
+
+	uint32_t NextMaterialSet{};
+	for (size_t iObject3D = 0; iObject3D < m_vObject3Ds.size(); ++iObject3D)
+	{
+		const auto& Object3D{ m_vObject3Ds[iObject3D] };
+		m_vObject3DMaterialSetOffsets[iObject3D] = (uint32_t)m_vObject3DMaterialSets.size();
+		for (size_t iMaterial = 0; iMaterial < Object3D->GetMaterialCount(); ++iMaterial)
+		{
+			uint64_t MaterialStateHash{};
+			if (Object3D->GetMaterialStateHash(iMaterial, MaterialStateHash))
 			{
-				UpdateCBAnimationBoneMatrices(Object3D->GetAnimationBoneMatrices());
+				auto Result{ m_umapMaterialSets.try_emplace(MaterialStateHash, NextMaterialSet) };
+				if (Result.second) ++NextMaterialSet;
+				m_vObject3DMaterialSets.emplace_back(Result.first->second);
 			}
+			else
+			{
+				m_vObject3DMaterialSets.emplace_back(NextMaterialSet++);
+			}
+		}
+	}
+	assert(NextMaterialSet <= (1u << CDrawPacketQueue::KMaterialSetBitCount));
+}
+
+void CGame::CullShadowCasters(size_t LOD)
+{
+	m_ShadowCasterCuller.SetCascade(m_CascadedShadowMap->GetShadowCascadeVolume(LOD));
+
+	auto& vCasterIndices{ m_vShadowCasterObject3DIndices[LOD] };
+	vCasterIndices.clear();
+
+	// @important: reuses the bounding spheres gathered by CullObject3Ds()
+	if (m_vObject3DBoundingSpheres.size())
+	{
+		m_ShadowCasterCuller.Cull(&m_vObject3DBoundingSpheres[0], (uint32_t)m_vObject3DBoundingSpheres.size(), vCasterIndices);
+		for (auto& CasterIndex : vCasterIndices)
+		{
+			CasterIndex = m_vObject3DCullingCandidateIndices[CasterIndex];
+		}
+	}
+
+	// Instanced objects cast shadows with all of their instances if any of them is a caster
+	for (uint32_t iObject3D = 0; iObject3D < (uint32_t)m_vObject3Ds.size(); ++iObject3D)
+	{
+		const CObject3D* const Object3D{ m_vObject3Ds[iObject3D].get() };
+		if (!Object3D->IsInstanced()) continue;
 
-			Object3D->Animate(m_DeltaTime_s);
+		const auto& vInstanceBoundingSpheres{ Object3D->GetInstanceBoundingSpheres() };
+		if (vInstanceBoundingSpheres.empty()) continue;
+		if (m_ShadowCasterCuller.HasAnyCaster(&vInstanceBoundingSpheres[0], (uint32_t)vInstanceBoundingSpheres.size()))
+		{
+			vCasterIndices.emplace_back(iObject3D);
 		}
+	}
 
-		Object3D->UpdateWorldMatrix();
-		EFlagsObject3DRendering eFlagsRendering{};
-		if (bIgnoreOwnTexture) eFlagsRendering |= EFlagsObject3DRendering::IgnoreOwnTextures;
-		if (bUseVoidPS) eFlagsRendering |= EFlagsObject3DRendering::UseVoidPS;
-		DrawObject3D(Object3D.get(), eFlagsRendering);
+	std::sort(vCasterIndices.begin(), vCasterIndices.end());
+}
 
-		if (EFLAG_HAS(m_eFlagsRendering, EFlagsRendering::DrawBoundingVolumes))
+void CGame::DrawOpaqueObject3Ds(bool bIgnoreOwnTexture, bool bUseVoidPS,
+	const std::vector<uint32_t>* const PtrObject3DIndices, bool bDrawVisibleInstances)
+{
+	EFlagsObject3DRendering eFlagsRendering{};
+	if (bIgnoreOwnTexture) eFlagsRendering |= EFlagsObject3DRendering::IgnoreOwnTextures;
+	if (bUseVoidPS) eFlagsRendering |= EFlagsObject3DRendering::UseVoidPS;
+	if (bDrawVisibleInstances) eFlagsRendering |= EFlagsObject3DRendering::DrawVisibleInstances;
+
+	RecordOpaqueObject3Ds(m_RenderCommandList, m_DrawPacketQueue, eFlagsRendering, PtrObject3DIndices);
+	ReplayObject3DCommands(m_RenderCommandList, eFlagsRendering);
+
+	DrawOpaqueObject3DBoundingVolumes(PtrObject3DIndices);
+}
+
+void CGame::RecordOpaqueObject3Ds(CRenderCommandList& CommandList, CDrawPacketQueue& DrawPacketQueue,
+	EFlagsObject3DRendering eFlagsRendering, const std::vector<uint32_t>* const PtrObject3DIndices) const
+{
+	const uint32_t Pass{ EFLAG_HAS(eFlagsRendering, EFlagsObject3DRendering::UseVoidPS) ? KDrawPassDepthOnly : KDrawPassOpaque };
+	const XMVECTOR& EyePosition{ m_PtrCurrentCamera->GetEyePosition() };
+	const XMVECTOR& ViewDirection{ m_PtrCurrentCamera->GetForward() };
+
+	// Opaque Object3Ds (one packet per mesh)
+	DrawPacketQueue.Clear();
+	size_t Object3DCount{ (PtrObject3DIndices) ? PtrObject3DIndices->size() : m_vObject3Ds.size() };
+	for (size_t iObject3D = 0; iObject3D < Object3DCount; ++iObject3D)
+	{
+		uint32_t Object3DIndex{ (uint32_t)((PtrObject3DIndices) ? (*PtrObject3DIndices)[iObject3D] : iObject3D) };
+		const auto& Object3D{ m_vObject3Ds[Object3DIndex] };
+		if (Object3D->IsTransparent()) continue;
+
+		uint32_t ShaderSet{ GetObject3DShaderSet(Object3D.get(), eFlagsRendering) };
+		float Depth{ XMVectorGetX(XMVector3Dot(
+			Object3D->GetTransform().Translation + Object3D->GetOuterBoundingSphereCenterOffset() - EyePosition, ViewDirection)) };
+		uint32_t DepthBucket{ CDrawPacketQueue::QuantizeDepth(Depth, m_FarZ) };
+		for (uint32_t iMesh = 0; iMesh < (uint32_t)Object3D->GetMeshCount(); ++iMesh)
 		{
-			DrawBoundingSphereRep(Object3D->GetTransform().Translation + Object3D->GetOuterBoundingSphereCenterOffset(),
-				Object3D->GetOuterBoundingSphereRadius());
+			// @important: objects with the same material CB and registered textures share a material set (see UpdateObject3DMaterialSets())
+			uint32_t MaterialSet{ m_vObject3DMaterialSets[m_vObject3DMaterialSetOffsets[Object3DIndex] + Object3D->GetMeshMaterialID(iMesh)] };
+			DrawPacketQueue.Push(CDrawPacketQueue::MakeSortKey(Pass, ShaderSet, MaterialSet, DepthBucket), Object3DIndex, iMesh);
+		}
+	}
+
+	DrawPacketQueue.Sort();
+
+	CommandList.Clear();
+	CommandList.RecordDrawPackets(DrawPacketQueue.GetPackets());
+}
+
+void CGame::ReplayObject3DCommands(const CRenderCommandList& CommandList, EFlagsObject3DRendering eFlagsRendering)
+{
+	m_ImmediateRenderBackend.SetRenderingFlags(eFlagsRendering);
+	CommandList.Replay(m_ImmediateRenderBackend);
+
+	m_DrawPacketCount += CommandList.GetCommandCount(ERenderCommandType::DrawMesh);
+	m_DrawStateChangeCount += CommandList.GetStateTracker().GetStateChangeCount();
+	m_AvoidedDrawStateChangeCount += CommandList.GetStateTracker().GetAvoidedStateChangeCount();
+
+	CShader::Unbind(m_DeviceContext.Get(), EShaderType::HullShader);
+	CShader::Unbind(m_DeviceContext.Get(), EShaderType::DomainShader);
+	m_DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	SetUniversalRSState();
+}
+
+void CGame::DrawOpaqueObject3DBoundingVolumes(const std::vector<uint32_t>* const PtrObject3DIndices)
+{
+	if (!EFLAG_HAS(m_eFlagsRendering, EFlagsRendering::DrawBoundingVolumes)) return;
+
+	size_t Object3DCount{ (PtrObject3DIndices) ? PtrObject3DIndices->size() : m_vObject3Ds.size() };
+	for (size_t iObject3D = 0; iObject3D < Object3DCount; ++iObject3D)
+	{
+		auto& Object3D{ m_vObject3Ds[(PtrObject3DIndices) ? (*PtrObject3DIndices)[iObject3D] : iObject3D] };
+		if (Object3D->IsTransparent()) continue;
 
-			if (Object3D->HasInnerBoundingVolumes())
+		DrawBoundingSphereRep(Object3D->GetTransform().Translation + Object3D->GetOuterBoundingSphereCenterOffset(),
+			Object3D->GetOuterBoundingSphereRadius());
+
+		if (Object3D->HasInnerBoundingVolumes())
+		{
+			for (const auto& BoundingVolume : Object3D->GetInnerBoundingVolumeVector())
 			{
-				for (const auto& BoundingVolume : Object3D->GetInnerBoundingVolumeVector())
+				if (BoundingVolume.eType == EBoundingVolumeType::BoundingSphere)
 				{
-					if (BoundingVolume.eType == EBoundingVolumeType::BoundingSphere)
-					{
-						DrawBoundingSphereRep(Object3D->GetTransform().Translation + BoundingVolume.Center, 
-							BoundingVolume.Data.BS.Radius);
-					}
-					else
-					{
-						DrawAxisAlignedBoundingBoxRep(Object3D->GetTransform().Translation + BoundingVolume.Center,
-							BoundingVolume.Data.AABBHalfSizes.x, BoundingVolume.Data.AABBHalfSizes.y, BoundingVolume.Data.AABBHalfSizes.z);
-					}
+					DrawBoundingSphereRep(Object3D->GetTransform().Translation + BoundingVolume.Center, 
+						BoundingVolume.Data.BS.Radius);
+				}
+				else
+				{
+					DrawAxisAlignedBoundingBoxRep(Object3D->GetTransform().Translation + BoundingVolume.Center,
+						BoundingVolume.Data.AABBHalfSizes.x, BoundingVolume.Data.AABBHalfSizes.y, BoundingVolume.Data.AABBHalfSizes.z);
 				}
 			}
 		}
 	}
 }
 
+void CGame::DrawShadowCascades()
+{
+	XMMATRIX SavedViewMatrix{ m_MatrixView };
+	XMMATRIX SavedProjectionMatrix{ m_MatrixProjection };
+
+	const XMVECTOR& EyePosition{ m_PtrCurrentCamera->GetEyePosition() };
+	const XMVECTOR& ViewDirection{ m_PtrCurrentCamera->GetForward() };
+
+	size_t LODCount{ m_CascadedShadowMap->GetLODCount() };
+	m_CBShadowMapData.LODCount = static_cast<uint32_t>(LODCount);
+	if (m_vShadowRenderCommandLists.size() != LODCount)
+	{
+		m_vShadowRenderCommandLists.resize(LODCount);
+		m_vShadowDrawPacketQueues.resize(LODCount);
+	}
+
+	// Set up and cull
+	bool bShouldUpdate[CCascadedShadowMap::KLODCountMax]{};
+	for (size_t iLOD = 0; iLOD < LODCount; ++iLOD)
+	{
+		// @important: ShouldUpdate() advances the frame counter of the LOD, so it must be called only once per frame
+		bShouldUpdate[iLOD] = m_CascadedShadowMap->ShouldUpdate(iLOD);
+		if (!bShouldUpdate[iLOD]) continue;
+
+		m_CascadedShadowMap->UpdateFrustum(iLOD, SavedProjectionMatrix, EyePosition, ViewDirection, m_CBGlobalLightData.DirectionalLightDirection);
+
+		m_CBShadowMapData.ShadowMapSpaceMatrix[iLOD] = m_CascadedShadowMap->GetTransposedSpaceMatrix(iLOD);
+		if (iLOD < CCascadedShadowMap::KLODCountMax) m_CBShadowMapData.ShadowMapZFars[iLOD] = m_CascadedShadowMap->GetZFar(iLOD);
+
+		CullShadowCasters(iLOD);
+	}
+
+	// Record
+	const EFlagsObject3DRendering eFlagsRendering{ EFlagsObject3DRendering::IgnoreOwnTextures | EFlagsObject3DRendering::UseVoidPS };
+	auto Record{ [&](size_t iLOD, CRenderCommandList& CommandList)
+		{
+			if (!bShouldUpdate[iLOD])
+			{
+				CommandList.Clear();
+				return;
+			}
+			RecordOpaqueObject3Ds(CommandList, m_vShadowDrawPacketQueues[iLOD], eFlagsRendering, &m_vShadowCasterObject3DIndices[iLOD]);
+		}
+	};
+
+	// @important: handing a few objects over to the workers costs more than recording them
+	size_t ShadowCasterCount{};
+	for (size_t iLOD = 0; iLOD < LODCount; ++iLOD)
+	{
+		if (bShouldUpdate[iLOD]) ShadowCasterCount += m_vShadowCasterObject3DIndices[iLOD].size();
+	}
+	if (ShadowCasterCount >= KParallelShadowRecordMinObjectCount)
+	{
+		CRenderCommandList::RecordInParallel(m_vShadowRenderCommandLists, Record, m_FrameTaskScheduler);
+	}
+	else
+	{
+		for (size_t iLOD = 0; iLOD < LODCount; ++iLOD)
+		{
+			Record(iLOD, m_vShadowRenderCommandLists[iLOD]);
+		}
+	}
+
+	// Replay
+	for (size_t iLOD = 0; iLOD < LODCount; ++iLOD)
+	{
+		if (!bShouldUpdate[iLOD]) continue;
+
+		m_CascadedShadowMap->SetRenderTarget(iLOD);
+
+		// @important
+		m_MatrixView = m_CascadedShadowMap->GetViewMatrix(iLOD);
+		m_MatrixProjection = m_CascadedShadowMap->GetProjectionMatrix(iLOD);
+
+		ReplayObject3DCommands(m_vShadowRenderCommandLists[iLOD], eFlagsRendering);
+		DrawOpaqueObject3DBoundingVolumes(&m_vShadowCasterObject3DIndices[iLOD]);
+	}
+
+	m_DeviceContext->RSSetViewports(1, &m_vViewports[0]);
+	m_MatrixView = SavedViewMatrix;
+	m_MatrixProjection = SavedProjectionMatrix;
+}
+
+void CGame::CImmediateRenderBackend::SetRenderingFlags(EFlagsObject3DRendering eFlagsRendering)
+{
+	m_eFlagsRendering = eFlagsRendering;
+}
+
+void CGame::CImmediateRenderBackend::SetShaderSet(uint32_t ShaderSet)
+{
+	m_Game.SetObject3DShaderSet(ShaderSet);
+}
+
+void CGame::CImmediateRenderBackend::SetObjectStates(uint32_t ObjectIndex)
+{
+	m_Game.SetObject3DStates(m_Game.m_vObject3Ds[ObjectIndex].get());
+}
+
+void CGame::CImmediateRenderBackend::SetMaterial(uint32_t ObjectIndex, uint32_t MeshIndex)
+{
+	m_Game.m_vObject3Ds[ObjectIndex]->UseMeshMaterial(MeshIndex,
+		EFLAG_HAS(m_eFlagsRendering, EFlagsObject3DRendering::IgnoreOwnTextures));
+}
+
+void CGame::CImmediateRenderBackend::DrawMesh(uint32_t ObjectIndex, uint32_t MeshIndex)
+{
+	m_Game.m_vObject3Ds[ObjectIndex]->DrawMesh(MeshIndex, m_eFlagsRendering);
+}
+
+uint32_t CGame::GetObject3DShaderSet(const CObject3D* const PtrObject3D, EFlagsObject3DRendering eFlagsRendering) const
+{
+	uint32_t ShaderSet{};
+	if (PtrObject3D->IsRigged())
+	{
+		ShaderSet |= KShaderSetVSAnimation;
+	}
+	else if (PtrObject3D->IsInstanced())
+	{
+		ShaderSet |= KShaderSetVSInstanced;
+	}
+	if (PtrObject3D->ShouldTessellate()) ShaderSet |= KShaderSetTessellation;
+	if (EFLAG_HAS(eFlagsRendering, EFlagsObject3DRendering::UseVoidPS))
+	{
+		ShaderSet |= KShaderSetPSVoid;
+	}
+	else if (m_bIsDeferredRenderTargetsSet)
+	{
+		ShaderSet |= KShaderSetPSGBuffer;
+	}
+	if (EFLAG_HAS(PtrObject3D->GetRenderingFlags(), CObject3D::EFlagsRendering::NoCulling)) ShaderSet |= KShaderSetNoCulling;
+	return ShaderSet;
+}
+
+void CGame::SetObject3DShaderSet(uint32_t ShaderSet)
+{
+	if (ShaderSet & KShaderSetVSAnimation)
+	{
+		m_VSAnimation->Use();
+		m_BonePaletteBuffer->Use(EShaderType::VertexShader, KBonePaletteSlot);
+	}
+	else if (ShaderSet & KShaderSetVSInstanced)
+	{
+		m_VSBase_Instanced->Use();
+	}
+	else
+	{
+		m_VSBase->Use();
+	}
+
+	if (ShaderSet & KShaderSetTessellation)
+	{
+		m_HSStatic->Use();
+		m_DSStatic->Use();
+		m_DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST);
+	}
+	else
+	{
+		CShader::Unbind(m_DeviceContext.Get(), EShaderType::HullShader);
+		CShader::Unbind(m_DeviceContext.Get(), EShaderType::DomainShader);
+		m_DeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	}
+
+	if (ShaderSet & KShaderSetPSVoid)
+	{
+		m_PSBase_Void->Use();
+	}
+	else if (ShaderSet & KShaderSetPSGBuffer)
+	{
+		m_PSBase_GBuffer->Use();
+	}
+	else
+	{
+		m_PSBase->Use();
+	}
+
+	if (ShaderSet & KShaderSetNoCulling)
+	{
+		m_DeviceContext->RSSetState(m_CommonStates->CullNone());
+	}
+	else
+	{
+		SetUniversalRSState();
+	}
+}
+
+void CGame::SetObject3DStates(const CObject3D* const PtrObject3D)
+{
+	UpdateCBSpace(PtrObject3D->GetWorldMatrix());
+
+	if (PtrObject3D->IsRigged()) UpdateCBAnimationData(PtrObject3D->GetAnimationData());
+
+	if (PtrObject3D->ShouldTessellate())
+	{
+		UpdateCBTessFactorData(PtrObject3D->GetTessFactorData());
+		UpdateCBDisplacementData(PtrObject3D->GetDisplacementData());
+	}
+
+	PtrObject3D->UseBakedAnimationTexture();
+}
+
 void CGame::DrawObject3D(CObject3D* const PtrObject3D, EFlagsObject3DRendering eFlagsRendering, size_t OneInstanceIndex)
 {
 	if (!PtrObject3D) return;
@@ -4274,6 +5215,9 @@ void CGame::DrawObject3D(CObject3D* const PtrObject3D, EFlagsObject3DRendering e
 	if (PtrObject3D->IsRigged())
 	{
 		m_VSAnimation->Use();
+
+		UpdateCBAnimationData(PtrObject3D->GetAnimationData());
+		m_BonePaletteBuffer->Use(EShaderType::VertexShader, KBonePaletteSlot);
 	}
 	else
 	{
@@ -4309,8 +5253,8 @@ void CGame::DrawObject3D(CObject3D* const PtrObject3D, EFlagsObject3DRendering e
 
 	if (PtrObject3D->ShouldTessellate())
 	{
-		m_DeviceContext->HSSetShader(nullptr, nullptr, 0);
-		m_DeviceContext->DSSetShader(nullptr, nullptr, 0);
+		CShader::Unbind(m_DeviceContext.Get(), EShaderType::HullShader);
+		CShader::Unbind(m_DeviceContext.Get(), EShaderType::DomainShader);
 	}
 
 	if (EFLAG_HAS(PtrObject3D->GetRenderingFlags(), CObject3D::EFlagsRendering::NoCulling))
@@ -4415,7 +5359,7 @@ void CGame::DrawPickingRay()
 
 	UpdateCBSpace();
 	
-	m_DeviceContext->GSSetShader(nullptr, nullptr, 0);
+	CShader::Unbind(m_DeviceContext.Get(), EShaderType::GeometryShader);
 	
 	m_PSLine->Use();
 
@@ -4428,7 +5372,7 @@ void CGame::DrawPickedTriangle()
 
 	UpdateCBSpace();
 	
-	m_DeviceContext->GSSetShader(nullptr, nullptr, 0);
+	CShader::Unbind(m_DeviceContext.Get(), EShaderType::GeometryShader);
 	
 	m_PSBase_RawVertexColor->Use();
 
@@ -4586,8 +5530,8 @@ void CGame::DrawTerrainOpaqueParts(float DeltaTime)
 
 	if (m_Terrain->ShouldTessellate())
 	{
-		m_DeviceContext->HSSetShader(nullptr, nullptr, 0);
-		m_DeviceContext->DSSetShader(nullptr, nullptr, 0);
+		CShader::Unbind(m_DeviceContext.Get(), EShaderType::HullShader);
+		CShader::Unbind(m_DeviceContext.Get(), EShaderType::DomainShader);
 	}
 
 	if (false)
@@ -4846,6 +5790,9 @@ void CGame::DrawEditorGUI()
 
 	ImGui::Render();
 	ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+
+	// ImGui binds its own shaders and constant buffers
+	CStateCache::Get(m_DeviceContext.Get()).Invalidate();
 }
 
 void CGame::DrawEditorGUIMenuBar()
@@ -5436,16 +6383,212 @@ void CGame::DrawEditorGUIWindowPropertyEditor()
 					ItemsWidth = min(ItemsWidth, KItemsMaxWidth);
 					float ItemsOffsetX{ WindowWidth - ItemsWidth - 20 };
 
-					// TODO
-					// Instance culling data
-					if (false)
+					// View frustum culling data (non-instanced objects count as one instance)
 					{
 						ImGui::AlignTextToFramePadding();
 						ImGui::Text((u8"Total Instance Count: " + to_string(m_Object3DTotalInstanceCount)).c_str());
 
+						ImGui::AlignTextToFramePadding();
+						ImGui::Text((u8"Visible Instance Count: " + to_string(m_Object3DTotalInstanceCount - m_Object3DCulledInstanceCount)).c_str());
+
 						ImGui::AlignTextToFramePadding();
 						ImGui::Text((u8"Culled Instance Count: " + to_string(m_Object3DCulledInstanceCount)).c_str());
 
+						ImGui::AlignTextToFramePadding();
+						ImGui::Text(u8"Culling Time: %.1f us", m_Object3DCullingMicroseconds);
+
+						for (size_t iLOD = 0; iLOD < m_CascadedShadowMap->GetLODCount(); ++iLOD)
+						{
+							ImGui::AlignTextToFramePadding();
+							ImGui::Text(u8"Shadow Casters (LOD %d): %d", (int)iLOD, (int)m_vShadowCasterObject3DIndices[iLOD].size());
+						}
+
+						ImGui::Separator();
+
+						// Draw packets (sorted submission)
+						ImGui::AlignTextToFramePadding();
+						ImGui::Text(u8"Draw Packets: %d", (int)m_DrawPacketCount);
+
+						ImGui::AlignTextToFramePadding();
+						ImGui::Text(u8"State Changes: %d (Avoided: %d)", (int)m_DrawStateChangeCount, (int)m_AvoidedDrawStateChangeCount);
+
+						// Recorded commands per pass (draws / state sets)
+						{
+							auto GetStateCommandCount{ [](const CRenderCommandList& CommandList)
+								{
+									return (int)(CommandList.GetCommandCount(ERenderCommandType::SetShaderSet) +
+										CommandList.GetCommandCount(ERenderCommandType::SetObjectStates) +
+										CommandList.GetCommandCount(ERenderCommandType::SetMaterial));
+								}
+							};
+
+							ImGui::AlignTextToFramePadding();
+							ImGui::Text(u8"Commands (Main): %d / %d", (int)m_RenderCommandList.GetCommandCount(ERenderCommandType::DrawMesh),
+								GetStateCommandCount(m_RenderCommandList));
+
+							for (size_t iLOD = 0; iLOD < m_vShadowRenderCommandLists.size(); ++iLOD)
+							{
+								const CRenderCommandList& CommandList{ m_vShadowRenderCommandLists[iLOD] };
+								ImGui::AlignTextToFramePadding();
+								ImGui::Text(u8"Commands (Shadow %d): %d / %d", (int)iLOD, (int)CommandList.GetCommandCount(ERenderCommandType::DrawMesh),
+									GetStateCommandCount(CommandList));
+							}
+						}
+
+						// State cache (shader and constant buffer binds, constant buffer uploads)
+						{
+							const SStateCacheCounters& Counters{ CStateCache::Get(m_DeviceContext.Get()).GetCounters() };
+
+							ImGui::AlignTextToFramePadding();
+							ImGui::Text(u8"Binds: %d (Skipped: %d)", (int)Counters.IssuedBindCount, (int)Counters.SkippedBindCount);
+
+							ImGui::AlignTextToFramePadding();
+							ImGui::Text(u8"CB Uploads: %d (Skipped: %d)", (int)Counters.IssuedUploadCount, (int)Counters.SkippedUploadCount);
+						}
+
+						ImGui::AlignTextToFramePadding();
+						if (m_ConstantBufferRing)
+						{
+							ImGui::Text(u8"CB Ring: %.1f KB/frame (In Flight: %d / %d KB)", m_ConstantBufferRing->GetUploadedByteCount() / 1024.0f,
+								(int)(m_ConstantBufferRing->GetUsedByteSize() / 1024), (int)(m_ConstantBufferRing->GetByteCapacity() / 1024));
+						}
+						else
+						{
+							ImGui::Text(u8"CB Ring: Unsupported (Direct3D 11.1)");
+						}
+
+						ImGui::AlignTextToFramePadding();
+						ImGui::Text(u8"Instance Uploads: %.1f KB/frame", m_InstanceUploadedByteCount / 1024.0f);
+
+						// Occlusion culling
+						{
+							const COcclusionCuller::SStatistics& Statistics{ m_OcclusionCuller.GetStatistics() };
+
+							ImGui::AlignTextToFramePadding();
+							ImGui::Text(u8"Ŭ ø");
+							ImGui::SameLine(ItemsOffsetX);
+							ImGui::Checkbox(u8"##Ŭ ø", &m_bUseOcclusionCulling);
+
+							if (m_bUseOcclusionCulling)
+							{
+								ImGui::AlignTextToFramePadding();
+								ImGui::Text(u8"Occluders: %d / %d (Triangles: %d, %.0f us)", (int)Statistics.OccluderCount,
+									(int)Statistics.QueuedOccluderCount, (int)Statistics.TriangleCount, m_OcclusionRasterizationMicroseconds);
+
+								ImGui::AlignTextToFramePadding();
+								ImGui::Text(u8"Occluded: %d / %d", (int)Statistics.OccludedCount, (int)Statistics.TestedCount);
+							}
+						}
+
+						// Mesh LOD
+						{
+							ImGui::AlignTextToFramePadding();
+							ImGui::Text(u8"Mesh LOD Triangles: %d / %d", (int)m_MeshLODTriangleCount, (int)m_MeshLOD0TriangleCount);
+						}
+
+						// Texture registry
+						{
+							const STextureRegistryCounters& Counters{ CTextureRegistry::Get().GetCounters() };
+							ImGui::AlignTextToFramePadding();
+							ImGui::Text(u8"Textures: %d (%.1f MB, %.1f MB shared) Hit: %d / Miss: %d", (int)Counters.TextureCount,
+								Counters.ResidentByteCount / (1024.0 * 1024.0), Counters.SharedByteCount / (1024.0 * 1024.0),
+								(int)Counters.HitCount, (int)Counters.MissCount);
+						}
+
+						// Scene load
+						{
+							ImGui::AlignTextToFramePadding();
+							ImGui::Text(u8"Scene Load: %.0f ms (First Frame: %.0f ms)", m_SceneLoadMilliseconds, m_SceneFirstFrameMilliseconds);
+							if (m_SceneSaveMilliseconds > 0.0)
+							{
+								ImGui::Text(u8"Scene Save: %.0f ms (%u/%u chunks changed%s)", m_SceneSaveMilliseconds,
+									m_SceneSaveCache.LastDirtyChunkCount, m_SceneSaveCache.LastChunkCount,
+									(m_SceneSaveCache.bWasLastFileWritten) ? "" : ", not written");
+							}
+
+							if (m_SceneFileName.size())
+							{
+								if (ImGui::Button(u8" ٽ ҷ "))
+								{
+									LoadScene(m_SceneFileName, m_SceneContentDirectory);
+								}
+
+								// @important: CPU stage only, scene containers only
+								if (ImGui::Button(u8" ڵ "))
+								{
+									m_SceneDecodeBenchmarkMillisecondsSingleThread = CSceneDecoder::MeasureDecodeTime(m_SceneFileName, 1, 4);
+									m_SceneDecodeBenchmarkMillisecondsMultiThread = CSceneDecoder::MeasureDecodeTime(m_SceneFileName, 0, 4);
+								}
+								ImGui::Text(u8"Scene Decode: %.1f ms (1 thread) / %.1f ms (%d threads)",
+									m_SceneDecodeBenchmarkMillisecondsSingleThread, m_SceneDecodeBenchmarkMillisecondsMultiThread,
+									(int)max(thread::hardware_concurrency(), 2u) - 1);
+							}
+						}
+
+						if (ImGui::Button(u8"200k Ŷ  "))
+						{
+							m_DrawPacketSortMicroseconds = CDrawPacketQueue::MeasureSortTime(200'000, 10);
+						}
+						if (m_DrawPacketSortMicroseconds > 0.0)
+						{
+							ImGui::SameLine();
+							ImGui::Text(u8"%.0f us", m_DrawPacketSortMicroseconds);
+						}
+
+						if (ImGui::Button(u8"4x 50k Ŀǵ  "))
+						{
+							m_RenderCommandRecordMicroseconds = CRenderCommandList::MeasureRecordTime(4, 50'000, 10, 1);
+							m_ParallelRenderCommandRecordMicroseconds = CRenderCommandList::MeasureRecordTime(4, 50'000, 10);
+						}
+						if (m_RenderCommandRecordMicroseconds > 0.0)
+						{
+							ImGui::SameLine();
+							ImGui::Text(u8"%.0f us (: %.0f us)", m_RenderCommandRecordMicroseconds, m_ParallelRenderCommandRecordMicroseconds);
+						}
+
+						if (ImGui::Button(u8"128x128 ׸ ܼȭ "))
+						{
+							m_MeshSimplifyBenchmarkMicroseconds = CMeshSimplifier::MeasureSimplifyTime(128, 3);
+						}
+						if (m_MeshSimplifyBenchmarkMicroseconds > 0.0)
+						{
+							ImGui::SameLine();
+							ImGui::Text(u8"%.0f us", m_MeshSimplifyBenchmarkMicroseconds);
+						}
+
+						if (ImGui::Button(u8"128x128 ׸  ĳ ȭ "))
+						{
+							m_MeshOptimizeBenchmarkMicroseconds = CMeshOptimizer::MeasureOptimizeTime(128, 3, &m_MeshOptimizeBenchmarkStatistics);
+						}
+						if (m_MeshOptimizeBenchmarkMicroseconds > 0.0)
+						{
+							ImGui::SameLine();
+							ImGui::Text(u8"%.0f us (ACMR: %.2f -> %.2f, ATVR: %.2f -> %.2f)", m_MeshOptimizeBenchmarkMicroseconds,
+								m_MeshOptimizeBenchmarkStatistics.Before.ACMR, m_MeshOptimizeBenchmarkStatistics.After.ACMR,
+								m_MeshOptimizeBenchmarkStatistics.Before.ATVR, m_MeshOptimizeBenchmarkStatistics.After.ATVR);
+						}
+
+						if (ImGui::Button(u8"4k Ʈ Ŭ  (1080p)"))
+						{
+							m_LightClusterBenchmarkMicroseconds = CLightClusterBuilder::MeasureBuildTime(4096, 10);
+						}
+						if (m_LightClusterBenchmarkMicroseconds > 0.0)
+						{
+							ImGui::SameLine();
+							ImGui::Text(u8"%.0f us", m_LightClusterBenchmarkMicroseconds);
+						}
+
+						if (ImGui::Button(u8"Ŭ  (256 Ŭ, 10k ڽ)"))
+						{
+							m_OcclusionRasterizationBenchmarkMicroseconds = COcclusionCuller::MeasureRasterizationTime(256, 10);
+							m_OcclusionTestBenchmarkMicroseconds = COcclusionCuller::MeasureTestTime(10'000, 10);
+						}
+						if (m_OcclusionRasterizationBenchmarkMicroseconds > 0.0)
+						{
+							ImGui::SameLine();
+							ImGui::Text(u8"%.0f us + %.0f us", m_OcclusionRasterizationBenchmarkMicroseconds, m_OcclusionTestBenchmarkMicroseconds);
+						}
+
 						ImGui::Separator();
 					}
 
@@ -5717,11 +6860,13 @@ void CGame::DrawEditorGUIWindowPropertyEditor()
 										if (ImGui::Button(u8"߰"))
 										{
 											Object3D->GetInnerBoundingVolumeVector().emplace_back();
+											Object3D->MarkSaveDirty();
 										}
 
 										ImGui::SameLine();
 										if (ImGui::Button(u8"") && Object3D->HasInnerBoundingVolumes())
 										{
+											Object3D->MarkSaveDirty();
 											auto& vInnerBoundingVolumes{ Object3D->GetInnerBoundingVolumeVector() };
 											if (SelectedBoundingVolumeIndex != (int)(vInnerBoundingVolumes.size() - 1))
 											{
@@ -5750,6 +6895,8 @@ void CGame::DrawEditorGUIWindowPropertyEditor()
 										{
 											if (ImGui::TreeNode(u8"λ "))
 											{
+												// @important: edited in place
+												Object3D->MarkSaveDirty();
 												auto& vInnerBoundingVolumes{ Object3D->GetInnerBoundingVolumeVector() };
 												if (SelectedBoundingVolumeIndex >= vInnerBoundingVolumes.size())
 												{
@@ -5817,6 +6964,126 @@ void CGame::DrawEditorGUIWindowPropertyEditor()
 
 								ImGui::Separator();
 
+								// Mesh LOD
+								if (ImGui::TreeNode(u8"޽ LOD"))
+								{
+									const uint32_t KMeshLODCount{ Object3D->GetMeshLODCount() };
+									ImGui::AlignTextToFramePadding();
+									ImGui::Text(u8" LOD");
+									ImGui::SameLine(ItemsOffsetX);
+									ImGui::Text(u8"%d / %d", (int)Object3D->GetCurrentMeshLOD(), (int)KMeshLODCount);
+
+									for (uint32_t iLOD = 0; iLOD < KMeshLODCount; ++iLOD)
+									{
+										ImGui::AlignTextToFramePadding();
+										ImGui::Text(u8"LOD %d", (int)iLOD);
+										ImGui::SameLine(ItemsOffsetX);
+										ImGui::Text(u8"%d ﰢ", (int)Object3D->GetMeshLODTriangleCount(iLOD));
+									}
+
+									if (ImGui::Button(u8"LOD "))
+									{
+										auto StartTimePoint{ steady_clock::now() };
+										Object3D->GenerateMeshLODs();
+										m_MeshLODGenerationMilliseconds = std::chrono::duration<double, std::milli>(steady_clock::now() - StartTimePoint).count();
+									}
+									ImGui::SameLine();
+									if (ImGui::Button(u8"LOD "))
+									{
+										Object3D->ClearMeshLODs();
+									}
+									if (m_MeshLODGenerationMilliseconds > 0.0)
+									{
+										ImGui::SameLine();
+										ImGui::Text(u8"%.1f ms", m_MeshLODGenerationMilliseconds);
+									}
+
+									ImGui::TreePop();
+								}
+
+								if (ImGui::Button(u8"MESH /ε "))
+								{
+									CMeshPorter::MeasureMESHThroughput(Object3D->GetModel(), 10, m_MESHWriteBenchmarkMBps, m_MESHReadBenchmarkMBps);
+								}
+								if (m_MESHWriteBenchmarkMBps > 0.0)
+								{
+									ImGui::SameLine();
+									ImGui::Text(u8" %.0f MB/s, ε %.0f MB/s", m_MESHWriteBenchmarkMBps, m_MESHReadBenchmarkMBps);
+								}
+
+								const string& ModelFileName{ Object3D->GetModelFileName() };
+								size_t ModelFileExtensionAt{ ModelFileName.find_last_of('.') };
+								string ModelFileExtension{ (ModelFileExtensionAt == string::npos) ? "" : ModelFileName.substr(ModelFileExtensionAt + 1) };
+								for (auto& c : ModelFileExtension) c = toupper(c);
+								if (ModelFileExtension == "MESH")
+								{
+									if (ImGui::Button(u8"MESH  Ʈ "))
+									{
+										CMeshPorter::MeasureMESHImportTime(ModelFileName, 10,
+											m_MESHImportBenchmarkMilliseconds, m_MESHMappedImportBenchmarkMilliseconds);
+									}
+									if (m_MESHImportBenchmarkMilliseconds > 0.0)
+									{
+										ImGui::SameLine();
+										ImGui::Text(u8"%.1f ms (: %.1f ms)", m_MESHImportBenchmarkMilliseconds, m_MESHMappedImportBenchmarkMilliseconds);
+									}
+
+									if (ImGui::Button(u8"MESH   "))
+									{
+										CLZCodec::MeasureFile(ModelFileName, 10, m_MESHCompressionBenchmark);
+									}
+									if (m_MESHCompressionBenchmark.RawByteCount)
+									{
+										ImGui::SameLine();
+										ImGui::Text(u8" %.2f,  %.0f MB/s,  %.2f GB/s", m_MESHCompressionBenchmark.Ratio,
+											m_MESHCompressionBenchmark.EncodeMBps, m_MESHCompressionBenchmark.DecodeGBps);
+									}
+								}
+
+								// Vertex packing
+								{
+									bool bShouldPackVertices{ Object3D->ShouldPackVertices() };
+									if (ImGui::Checkbox(u8"  ", &bShouldPackVertices))
+									{
+										Object3D->ShouldPackVertices(bShouldPackVertices);
+									}
+
+									static const CObject3D* ReportedObject3D{};
+									static CVertexPacker::SReport VertexPackingReport{};
+									ImGui::SameLine();
+									if (ImGui::Button(u8"  "))
+									{
+										CVertexPacker VertexPacker{};
+										VertexPackingReport = VertexPacker.CreateReport(Object3D->GetModel());
+										ReportedObject3D = Object3D;
+									}
+
+									if (ReportedObject3D == Object3D)
+									{
+										const auto& Report{ VertexPackingReport };
+										ImGui::Text(u8" %.2f (%zu B -> %zu B), ޽ %u / %u", Report.CompressionRatio,
+											Report.RawByteCount, Report.PackedByteCount, Report.PackedMeshCount, Report.MeshCount);
+										ImGui::Text(u8" - ִ :  %.5f, UV %.5f,  %.5f", Report.MaxDirectionError, Report.MaxTexCoordError, Report.MaxColorError);
+										ImGui::Text(u8" - ڵ %.2f M/", Report.UnpackedVerticesPerSecond / 1000000.0);
+									}
+								}
+
+								ImGui::Separator();
+
+								// Occluder
+								{
+									bool bIsOccluder{ Object3D->IsOccluder() };
+									ImGui::AlignTextToFramePadding();
+									ImGui::Text(u8"Ŭ");
+									ImGui::SameLine(ItemsOffsetX);
+									if (ImGui::Checkbox(u8"##Ŭ", &bIsOccluder))
+									{
+										Object3D->IsOccluder(bIsOccluder);
+									}
+								}
+
+								ImGui::Separator();
+
 								// Tessellation data
 								if (ImGui::TreeNode(u8"׼̼"))
 								{
@@ -5874,6 +7141,9 @@ void CGame::DrawEditorGUIWindowPropertyEditor()
 
 									if (Object3D->GetMaterialCount() > 0)
 									{
+										// @important: the materials are edited in place
+										Object3D->MarkSaveDirty();
+
 										static CMaterialData* capturedMaterialData{};
 										static CMaterialTextureSet* capturedMaterialTextureSet{};
 										static ETextureType ecapturedTextureType{};
@@ -5942,6 +7212,14 @@ void CGame::DrawEditorGUIWindowPropertyEditor()
 													Object3D->SaveBakedAnimationTexture(FileDialog.GetRelativeFileName());
 												}
 											}
+
+											ImGui::SameLine();
+
+											bool bShouldBakeHalfFloat{ Object3D->ShouldBakeHalfFloatAnimationTexture() };
+											if (ImGui::Checkbox(u8"16Ʈ", &bShouldBakeHalfFloat))
+											{
+												Object3D->ShouldBakeHalfFloatAnimationTexture(bShouldBakeHalfFloat);
+											}
 										}
 
 										ImGui::SameLine();
@@ -6009,10 +7287,133 @@ void CGame::DrawEditorGUIWindowPropertyEditor()
 											ImGui::AlignTextToFramePadding();
 											ImGui::Text(u8"Ʈ ִϸ̼ ID");
 											ImGui::SameLine(ItemsOffsetX);
+											static float BlendTime{};
 											int AnimationID{ (int)Object3D->GetAnimationID(Identifier) };
 											if (ImGui::SliderInt(u8"##Ʈ ִϸ̼ ID", &AnimationID, 0, AnimationCount - 1))
 											{
-												Object3D->SetAnimation(SObjectIdentifier(Object3D), AnimationID);
+												Object3D->SetAnimation(SObjectIdentifier(Object3D), AnimationID, EAnimationOption::Repeat, true, BlendTime);
+											}
+
+											ImGui::AlignTextToFramePadding();
+											ImGui::Text(u8" ð");
+											ImGui::SameLine(ItemsOffsetX);
+											ImGui::SliderFloat(u8"## ð", &BlendTime, 0.0f, 1.0f, "%.2f s");
+
+											// Animation layer
+											static int LayerAnimationID{};
+											static char LayerMaskRootNodeName[KAssetNameMaxLength]{};
+											LayerAnimationID = max(min(LayerAnimationID, AnimationCount - 1), 0);
+											ImGui::AlignTextToFramePadding();
+											ImGui::Text(u8"̾ ִϸ̼ ID");
+											ImGui::SameLine(ItemsOffsetX);
+											ImGui::SliderInt(u8"##̾ ִϸ̼ ID", &LayerAnimationID, 0, AnimationCount - 1);
+
+											ImGui::AlignTextToFramePadding();
+											ImGui::Text(u8"̾ ũ ");
+											ImGui::SameLine(ItemsOffsetX);
+											ImGui::InputText(u8"##̾ ũ ", LayerMaskRootNodeName, KAssetNameMaxLength);
+
+											if (ImGui::Button(u8"̾ "))
+											{
+												Object3D->SetAnimationLayer(LayerAnimationID, LayerMaskRootNodeName, BlendTime);
+											}
+											ImGui::SameLine();
+											if (ImGui::Button(u8"̾ "))
+											{
+												Object3D->ClearAnimationLayer(BlendTime);
+											}
+
+											static const CObject3D* MeasuredObject3D{};
+											static double UnblendedMicroseconds{};
+											static double BlendedMicroseconds{};
+											if (ImGui::Button(u8"  "))
+											{
+												Object3D->MeasurePoseEvaluationTime(1000, UnblendedMicroseconds, BlendedMicroseconds);
+												MeasuredObject3D = Object3D;
+											}
+											if (MeasuredObject3D == Object3D)
+											{
+												ImGui::Text(u8" -  %.2f us,  %.2f us", UnblendedMicroseconds, BlendedMicroseconds);
+											}
+
+											// Animation LOD
+											CObject3D::SAnimationLODSettings AnimationLODSettings{ Object3D->GetAnimationLODSettings() };
+											bool bIsAnimationLODChanged{ false };
+											bIsAnimationLODChanged |= ImGui::Checkbox(u8"ִϸ̼ LOD", &AnimationLODSettings.bUseAnimationLOD);
+											if (AnimationLODSettings.bUseAnimationLOD)
+											{
+												ImGui::AlignTextToFramePadding();
+												ImGui::Text(u8" ֱ  Ÿ");
+												ImGui::SameLine(ItemsOffsetX);
+												bIsAnimationLODChanged |= ImGui::DragFloat(u8"## ֱ  Ÿ", &AnimationLODSettings.ReducedRateDistance, 0.1f, 0.0f, 1000.0f, "%.1f");
+
+												ImGui::AlignTextToFramePadding();
+												ImGui::Text(u8" ֱ ()");
+												ImGui::SameLine(ItemsOffsetX);
+												int ReducedRateInterval{ (int)AnimationLODSettings.ReducedRateInterval };
+												if (ImGui::SliderInt(u8"## ֱ ()", &ReducedRateInterval, 1, 16))
+												{
+													AnimationLODSettings.ReducedRateInterval = (uint32_t)ReducedRateInterval;
+													bIsAnimationLODChanged = true;
+												}
+
+												ImGui::AlignTextToFramePadding();
+												ImGui::Text(u8"   Ÿ");
+												ImGui::SameLine(ItemsOffsetX);
+												bIsAnimationLODChanged |= ImGui::DragFloat(u8"##   Ÿ", &AnimationLODSettings.LeafBoneSkipDistance, 0.1f, 0.0f, 1000.0f, "%.1f");
+
+												bIsAnimationLODChanged |= ImGui::Checkbox(u8"ȭ ۿ ", &AnimationLODSettings.bShouldFreezeOffscreen);
+
+												uint32_t TotalEvaluatedBoneCount{};
+												uint32_t TotalSkippedBoneCount{};
+												for (const auto& Object3DPtr : m_vObject3Ds)
+												{
+													TotalEvaluatedBoneCount += Object3DPtr->GetAnimationLODStatistics().EvaluatedBoneCount;
+													TotalSkippedBoneCount += Object3DPtr->GetAnimationLODStatistics().SkippedBoneCount;
+												}
+												const auto& AnimationLODStatistics{ Object3D->GetAnimationLODStatistics() };
+												ImGui::Text(u8" - 򰡵  %u,   %u", AnimationLODStatistics.EvaluatedBoneCount, AnimationLODStatistics.SkippedBoneCount);
+												ImGui::Text(u8" - ü: 򰡵  %u,   %u", TotalEvaluatedBoneCount, TotalSkippedBoneCount);
+											}
+											if (bIsAnimationLODChanged) Object3D->SetAnimationLODSettings(AnimationLODSettings);
+
+											// Bone palette (CPU skinning)
+											ImGui::Text(u8" -   %u", Object3D->GetAnimationBoneMatrixCount());
+											ImGui::Text(u8" -  ȷƮ ε: ȷƮ %u, %.1f KB/", m_BonePaletteBuffer->GetPacker().GetPackedPaletteCount(),
+												m_BonePaletteBuffer->GetUploadedByteCount() / 1024.0);
+										}
+
+										// Animation compression
+										bool bShouldCompressAnimations{ Object3D->ShouldCompressAnimations() };
+										if (ImGui::Checkbox(u8"ִϸ̼  ", &bShouldCompressAnimations))
+										{
+											Object3D->ShouldCompressAnimations(bShouldCompressAnimations);
+										}
+
+										static const CObject3D* ReportedObject3D{};
+										static vector<CAnimationCompressor::SReport> vCompressionReports{};
+										ImGui::SameLine();
+										if (ImGui::Button(u8" "))
+										{
+											CAnimationCompressor AnimationCompressor{};
+											vCompressionReports.clear();
+											for (const auto& Animation : Object3D->GetModel().vAnimations)
+											{
+												vCompressionReports.emplace_back(AnimationCompressor.CreateReport(Animation));
+											}
+											ReportedObject3D = Object3D;
+										}
+
+										if (ReportedObject3D == Object3D)
+										{
+											for (const auto& Report : vCompressionReports)
+											{
+												ImGui::Text(u8"%s:  %.2f (%zu B -> %zu B)", Report.AnimationName.c_str(),
+													Report.CompressionRatio, Report.RawByteCount, Report.CompressedByteCount);
+												ImGui::Text(u8" - Ű %u -> %u,  Ʈ %u,  Ʈ %u", Report.RawKeyCount, Report.CompressedKeyCount,
+													Report.ConstantTrackCount, Report.RawTrackCount);
+												ImGui::Text(u8" - ִ  %.5f (%s)", Report.MaxBoneSpaceError, Report.MaxErrorNodeName.c_str());
+												ImGui::Text(u8" - ڵ %.2f MŰ/", Report.DecodedKeysPerSecond / 1000000.0);
 											}
 										}
 
@@ -6214,6 +7615,7 @@ void CGame::DrawEditorGUIWindowPropertyEditor()
 													}
 													m_Intelligence->RegisterPattern(Object3D, m_vPatterns[iSelectedPattern].get());
 												}
+												m_bIsInstanceTableDirty = true;
 
 												bClosing = true;
 											}
@@ -6259,6 +7661,7 @@ void CGame::DrawEditorGUIWindowPropertyEditor()
 											}
 											m_Intelligence->DeregisterPattern(Object3D);
 										}
+										m_bIsInstanceTableDirty = true;
 									}
 
 									ImGui::TreePop();
@@ -7815,35 +9218,49 @@ void CGame::DrawEditorGUIWindowSceneEditor()
 		ImGui::SetNextWindowSizeConstraints(ImVec2(400, 60), ImVec2(500, 600));
 		if (ImGui::Begin(u8" ", &m_EditorGUIBools.bShowWindowSceneEditor, ImGuiWindowFlags_AlwaysAutoResize))
 		{
-			//  
-			if (ImGui::Button(u8" "))
+			if (IsLoadingScene())
 			{
-				EmptyScene();
+				//  ҷ 
+				ImGui::AlignTextToFramePadding();
+				ImGui::Text(u8" ҷ ");
+				ImGui::SameLine();
+				ImGui::ProgressBar(GetSceneLoadingProgress(), ImVec2(200, 0));
 			}
+			else
+			{
+				//  
+				if (ImGui::Button(u8" "))
+				{
+					EmptyScene();
+				}
 
-			ImGui::SameLine();
+				ImGui::SameLine();
 
-			//  
-			if (ImGui::Button(u8" "))
-			{
-				static CFileDialog FileDialog{ GetSceneDirectory() };
-				if (FileDialog.SaveFileDialog(" (*.scene)\0*.scene\0", " ", ".scene"))
+				//  
+				if (ImGui::Button(u8" "))
 				{
-					SaveScene(FileDialog.GetRelativeFileName(), "Scene\\" + FileDialog.GetFileNameWithoutExt() + '\\');
+					static CFileDialog FileDialog{ GetSceneDirectory() };
+					if (FileDialog.SaveFileDialog(" (*.scene)\0*.scene\0", " ", ".scene"))
+					{
+						SaveScene(FileDialog.GetRelativeFileName(), "Scene\\" + FileDialog.GetFileNameWithoutExt() + '\\');
+					}
 				}
-			}
 
-			ImGui::SameLine();
+				ImGui::SameLine();
 
-			//  ҷ
-			if (ImGui::Button(u8" ҷ"))
-			{
-				static CFileDialog FileDialog{ GetSceneDirectory() };
-				
-				if (FileDialog.OpenFileDialog(" (*.scene)\0*.scene\0", " ҷ"))
+				//  ҷ
+				if (ImGui::Button(u8" ҷ"))
 				{
-					LoadScene(FileDialog.GetRelativeFileName(), "Scene\\" + FileDialog.GetFileNameWithoutExt() + '\\');
+					static CFileDialog FileDialog{ GetSceneDirectory() };
+				
+					if (FileDialog.OpenFileDialog(" (*.scene)\0*.scene\0", " ҷ"))
+					{
+						BeginLoadingScene(FileDialog.GetRelativeFileName(), "Scene\\" + FileDialog.GetFileNameWithoutExt() + '\\');
+					}
 				}
+
+				// @important: large chunks, terrains and OB3Ds only (old files load either way)
+				ImGui::Checkbox(u8"  ", &m_bShouldCompressSavedFiles);
 			}
 
 			ImGui::Separator();
@@ -7874,7 +9291,7 @@ void CGame::DrawEditorGUIWindowSceneEditor()
 							}
 							else
 							{
-								Object3D->SaveOB3D(FileDialog.GetFileName());
+								Object3D->SaveOB3D(FileDialog.GetFileName(), m_bShouldCompressSavedFiles);
 							}
 						}
 					}
@@ -8268,13 +9685,6 @@ void CGame::EndRendering()
 				{
 					CObject3D* const Object3D{ (CObject3D*)SelectionData.PtrObject };
 
-					if (Object3D->IsRigged())
-					{
-						Object3D->Animate(0);
-						UpdateCBAnimationBoneMatrices(Object3D->GetAnimationBoneMatrices());
-						UpdateCBAnimationData(Object3D->GetAnimationData());
-					}
-
 					if (SelectionData.eObjectType == EObjectType::Object3DInstance)
 					{
 						size_t InstanceIndex{ Object3D->GetInstanceIndex(SelectionData.Name) };
@@ -8314,8 +9724,16 @@ void CGame::EndRendering()
 		DrawEditorGUI();
 	}
 
+	if (m_ConstantBufferRing) m_ConstantBufferRing->EndFrame();
+
 	m_SwapChain->Present(0, 0);
 
+	if (m_bIsDrawingSceneFirstFrame)
+	{
+		m_SceneFirstFrameMilliseconds = std::chrono::duration<double, std::milli>(steady_clock::now() - m_SceneLoadStartTimePoint).count();
+		m_bIsDrawingSceneFirstFrame = false;
+	}
+
 	m_bLeftButtonPressedOnce = false;
 	m_bLeftButtonUpOnce = false;
 }
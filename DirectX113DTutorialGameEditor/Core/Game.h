@@ -11,6 +11,18 @@
 #include "Camera.h"
 #include "Shader.h"
 #include "ConstantBuffer.h"
+#include "ConstantBufferRing.h"
+#include "BonePaletteBuffer.h"
+#include "FrustumCuller.h"
+#include "ShadowCasterCuller.h"
+#include "DrawPacket.h"
+#include "RenderCommandList.h"
+#include "TaskScheduler.h"
+#include "LightClusterBuilder.h"
+#include "OcclusionCuller.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "LZCodec.h"
 #include "Material.h"
 #include "PrimitiveGenerator.h"
 #include "Terrain.h"
@@ -19,6 +31,8 @@
 #include "CascadedShadowMap.h"
 #include "FullScreenQuad.h"
 #include "BMFontRenderer.h"
+#include "SceneContainer.h"
+#include "SceneDecoder.h"
 #include "../Model/Object3D.h"
 #include "../Model/Object3DLine.h"
 #include "../Model/Object2D.h"
@@ -35,6 +49,8 @@
 #include "ImGui/imgui_impl_win32.h"
 #include "ImGui/imgui_impl_dx11.h"
 
+class CBinaryData;
+
 class CGame
 {
 public:
@@ -125,11 +141,6 @@ public:
 		XMFLOAT2	Reserved{};
 	};
 
-	struct SCBAnimationBonesData // Update every frame (when CPU skinning is used)
-	{
-		XMMATRIX	BoneMatrices[CObject3D::KMaxBoneMatrixCount]{};
-	};
-
 	struct SCBSkyTimeData
 	{
 		float		SkyTime{};
@@ -363,6 +374,40 @@ public:
 		ComPtr<ID3D11ShaderResourceView>	MetalAOSRV{};
 	};
 
+	// State of BeginLoadingScene() kept across frames
+	struct SSceneLoadingData
+	{
+		CSceneContainer	SceneContainer{};
+		CSceneDecoder	SceneDecoder{}; // @important: declared after SceneContainer, which it reads from
+		CBinaryData		ObjectTableBinary{};
+		CBinaryData		InstanceTableBinary{};
+		uint32_t		Object3DCount{};
+		uint32_t		NextStep{};
+		uint32_t		StepCount{};
+	};
+
+private:
+	// Replays recorded Object3D commands through the immediate context
+	class CImmediateRenderBackend final : public CRenderBackend
+	{
+	public:
+		CImmediateRenderBackend(CGame& Game) : m_Game{ Game } {}
+		~CImmediateRenderBackend() {}
+
+	public:
+		void SetRenderingFlags(EFlagsObject3DRendering eFlagsRendering);
+
+	public:
+		void SetShaderSet(uint32_t ShaderSet) override;
+		void SetObjectStates(uint32_t ObjectIndex) override;
+		void SetMaterial(uint32_t ObjectIndex, uint32_t MeshIndex) override;
+		void DrawMesh(uint32_t ObjectIndex, uint32_t MeshIndex) override;
+
+	private:
+		CGame&					m_Game;
+		EFlagsObject3DRendering	m_eFlagsRendering{};
+	};
+
 public:
 	CGame(HINSTANCE hInstance, const XMFLOAT2& WindowSize) : m_hInstance{ hInstance }, m_WindowSize{ WindowSize } {}
 	~CGame() {}
@@ -401,9 +446,37 @@ public:
 
 public:
 	void EmptyScene();
+	// Loads both scene containers (see CSceneContainer) and legacy (flat) scene files
 	void LoadScene(const std::string& FileName, const std::string& SceneContentDirectory);
+	// Decodes the scene container on worker threads and creates its resources over the next frames (see Update())
+	// @important: legacy scene files are loaded at once
+	void BeginLoadingScene(const std::string& FileName, const std::string& SceneContentDirectory);
+	bool IsLoadingScene() const;
+	// 0 to 1
+	float GetSceneLoadingProgress() const;
+	// Saves a scene container, with the OB3Ds embedded
 	void SaveScene(const std::string& FileName, const std::string& SceneContentDirectory);
 
+public:
+	// Needs no device, so that it can be run from the command line (see main.cpp)
+	static bool ConvertLegacyScene(const std::string& LegacyFileName, const std::string& FileName);
+
+private:
+	// GPU stage of BeginLoadingScene(), returns true when the scene is loaded
+	// @important: returns early when the next asset is not decoded yet, unless bShouldWaitForDecoding is true
+	bool UpdateSceneLoading(double BudgetMilliseconds, bool bShouldWaitForDecoding = false);
+	void LoadLegacyScene(CBinaryData& SceneBinaryData);
+	// @important: clean objects reuse their chunks of the last save, returns false (with the save cache emptied) if that fails
+	bool _SaveScene(const std::string& FileName, const std::string& SceneContentDirectory);
+	// @important: shared by scene container chunks and legacy scene files
+	void ReadScenePatterns(CBinaryData& SceneBinaryData);
+	void ReadSceneTerrain(CBinaryData& SceneBinaryData);
+	void ReadSceneCameras(CBinaryData& SceneBinaryData);
+	void ReadSceneLights(CBinaryData& SceneBinaryData);
+	void ReadSceneMaterial(CBinaryData& SceneBinaryData);
+	void ReadSceneLightProbe(CBinaryData& SceneBinaryData);
+	void ReadSceneGlobalLight(CBinaryData& SceneBinaryData);
+
 // Advanced settings
 public:
 	void SetProjectionMatrices(float FOV, float NearZ, float FarZ);
@@ -418,7 +491,6 @@ public:
 private:
 	void UpdateCBSpace(const XMMATRIX& World = KMatrixIdentity);
 	void UpdateCBSpace(const XMMATRIX& World, const XMMATRIX& Projection);
-	void UpdateCBAnimationBoneMatrices(const XMMATRIX* const BoneMatrices);
 	void UpdateCBAnimationData(const CObject3D::SCBAnimationData& Data);
 	void UpdateCBTerrainData(const CTerrain::SCBTerrainData& Data);
 	void UpdateCBWindData(const CTerrain::SCBWindData& Data);
@@ -459,6 +531,8 @@ public:
 public:
 	void CreateTerrain(const XMFLOAT2& TerrainSize, uint32_t MaskingDetail, float UniformScaling);
 	void LoadTerrain(const std::string& TerrainFileName);
+	// TerrainFileData is decoded beforehand (see CTerrain::DecodeFile())
+	void LoadTerrain(std::unique_ptr<STERRData> TerrainFileData);
 	void SaveTerrain(const std::string& TerrainFileName);
 	CTerrain* GetTerrain() const { return m_Terrain.get(); }
 
@@ -594,7 +668,26 @@ public:
 	auto GetDeltaTime() const->float;
 
 private:
-	void DrawOpaqueObject3Ds(bool bIgnoreOwnTexture = false, bool bUseVoidPS = false);
+	void AnimateObject3Ds();
+	void CullObject3Ds();
+	// Rasterizes the largest occluders in the view frustum for the main view
+	void RasterizeOccluders();
+	void CullShadowCasters(size_t LOD);
+	// Numbers the materials of every object, objects with the same material state share a material set
+	void UpdateObject3DMaterialSets();
+	// PtrObject3DIndices: culled list of m_vObject3Ds indices (nullptr means every object)
+	void DrawOpaqueObject3Ds(bool bIgnoreOwnTexture = false, bool bUseVoidPS = false,
+		const std::vector<uint32_t>* const PtrObject3DIndices = nullptr, bool bDrawVisibleInstances = false);
+	// @important: only reads the objects (world matrices are updated by CullObject3Ds()), so that passes can be recorded in parallel
+	void RecordOpaqueObject3Ds(CRenderCommandList& CommandList, CDrawPacketQueue& DrawPacketQueue,
+		EFlagsObject3DRendering eFlagsRendering, const std::vector<uint32_t>* const PtrObject3DIndices) const;
+	void ReplayObject3DCommands(const CRenderCommandList& CommandList, EFlagsObject3DRendering eFlagsRendering);
+	void DrawOpaqueObject3DBoundingVolumes(const std::vector<uint32_t>* const PtrObject3DIndices);
+	// Every cascade is culled and recorded (in parallel) before any of them is drawn
+	void DrawShadowCascades();
+	uint32_t GetObject3DShaderSet(const CObject3D* const PtrObject3D, EFlagsObject3DRendering eFlagsRendering) const;
+	void SetObject3DShaderSet(uint32_t ShaderSet);
+	void SetObject3DStates(const CObject3D* const PtrObject3D);
 	void DrawObject3D(CObject3D* const PtrObject3D,
 		EFlagsObject3DRendering eFlagsRendering = EFlagsObject3DRendering::None, size_t OneInstanceIndex = 0);
 	void DrawBoundingSphereRep(const XMVECTOR& Center, float Radius);
@@ -680,6 +773,24 @@ private:
 	static constexpr int KIrradianceTextureSlot{ 51 };
 	static constexpr int KPrefilteredRadianceTextureSlot{ 52 };
 	static constexpr int KIntegratedBRDFTextureSlot{ 53 };
+	static constexpr int KBonePaletteSlot{ 1 }; // VS
+	static constexpr double KSceneLoadingBudgetMilliseconds{ 8.0 }; // per frame
+
+	// Scene loading steps (then one per object and the rest of the scene)
+	static constexpr uint32_t KSceneLoadingStepPatterns{ 0 };
+	static constexpr uint32_t KSceneLoadingStepTerrain{ 1 };
+	static constexpr uint32_t KSceneLoadingStepObject3D{ 2 };
+
+	// Draw packets' sort key
+	static constexpr uint32_t KDrawPassOpaque{ 0 };
+	static constexpr uint32_t KDrawPassDepthOnly{ 1 };
+	static constexpr uint32_t KShaderSetVSInstanced{ 0x01 };
+	static constexpr uint32_t KShaderSetVSAnimation{ 0x02 };
+	static constexpr uint32_t KShaderSetTessellation{ 0x04 };
+	static constexpr uint32_t KShaderSetPSVoid{ 0x08 };
+	static constexpr uint32_t KShaderSetPSGBuffer{ 0x10 };
+	static constexpr uint32_t KShaderSetNoCulling{ 0x20 };
+	static constexpr size_t KParallelShadowRecordMinObjectCount{ 256 }; // fewer shadow casters are recorded on the main thread
 	static constexpr int KEditorCameraID{ -999 };
 	static constexpr float KEditorCameraDefaultMovementFactor{ 3.0f };
 	static constexpr size_t KInvalidIndex{ SIZE_T_MAX };
@@ -743,8 +854,8 @@ private:
 
 // Constant buffer
 private:
+	std::unique_ptr<CConstantBufferRing>	m_ConstantBufferRing{}; // nullptr if Direct3D 11.1 isn't supported
 	std::unique_ptr<CConstantBuffer>		m_CBSpace{};
-	std::unique_ptr<CConstantBuffer>		m_CBAnimationBones{};
 	std::unique_ptr<CConstantBuffer>		m_CBAnimation{};
 	std::unique_ptr<CConstantBuffer>		m_CBTerrain{};
 	std::unique_ptr<CConstantBuffer>		m_CBWind{};
@@ -760,9 +871,9 @@ private:
 	std::unique_ptr<CConstantBuffer>		m_CBGBufferUnpacking{};
 	std::unique_ptr<CConstantBuffer>		m_CBShadowMap{};
 	std::unique_ptr<CConstantBuffer>		m_CBSceneMaterial{};
+	std::unique_ptr<CBonePaletteBuffer>		m_BonePaletteBuffer{};
 
 	SCBSpaceData							m_CBSpaceData{};
-	SCBAnimationBonesData					m_CBAnimationBonesData{};
 	CObject3D::SCBAnimationData				m_CBAnimationData{};
 	CTerrain::SCBTerrainData				m_CBTerrainData{};
 	CTerrain::SCBWindData					m_CBWindData{};
@@ -784,6 +895,60 @@ private:
 	std::vector<std::unique_ptr<CObject3D>>		m_vObject3Ds{};
 	size_t										m_Object3DTotalInstanceCount{};
 	size_t										m_Object3DCulledInstanceCount{};
+	double										m_Object3DCullingMicroseconds{};
+	CFrustumCuller								m_FrustumCuller{};
+	std::vector<XMFLOAT4>						m_vObject3DBoundingSpheres{}; // non-instanced objects only
+	std::vector<uint32_t>						m_vObject3DCullingCandidateIndices{};
+	std::vector<uint32_t>						m_vVisibleObject3DIndices{}; // compacted, in m_vObject3Ds order
+	CShadowCasterCuller							m_ShadowCasterCuller{};
+	std::vector<uint32_t>						m_vShadowCasterObject3DIndices[CCascadedShadowMap::KLODCountMax]{}; // [LOD]
+	CDrawPacketQueue							m_DrawPacketQueue{};
+	CRenderCommandList							m_RenderCommandList{}; // main view
+	std::vector<CDrawPacketQueue>				m_vShadowDrawPacketQueues{}; // [LOD]
+	std::vector<CRenderCommandList>				m_vShadowRenderCommandLists{}; // [LOD]
+	CTaskScheduler								m_FrameTaskScheduler{}; // per-frame CPU work, the workers are kept between frames
+	std::unordered_map<uint64_t, uint32_t>		m_umapMaterialSets{}; // material state hash -> material set, per frame
+	std::vector<uint32_t>						m_vObject3DMaterialSetOffsets{}; // [Object3D] into m_vObject3DMaterialSets
+	std::vector<uint32_t>						m_vObject3DMaterialSets{}; // [Object3D's material]
+	CImmediateRenderBackend						m_ImmediateRenderBackend{ *this };
+	size_t										m_DrawPacketCount{}; // per frame
+	uint32_t									m_DrawStateChangeCount{}; // per frame
+	uint32_t									m_AvoidedDrawStateChangeCount{}; // per frame
+	double										m_DrawPacketSortMicroseconds{}; // benchmark
+	double										m_RenderCommandRecordMicroseconds{}; // benchmark, 1 thread
+	double										m_ParallelRenderCommandRecordMicroseconds{}; // benchmark
+	size_t										m_InstanceUploadedByteCount{}; // per frame
+	COcclusionCuller							m_OcclusionCuller{}; // main view only, shadow casters behind occluders still cast shadows
+	bool										m_bUseOcclusionCulling{ true };
+	double										m_OcclusionRasterizationMicroseconds{};
+	double										m_OcclusionRasterizationBenchmarkMicroseconds{}; // benchmark
+	double										m_OcclusionTestBenchmarkMicroseconds{}; // benchmark
+	size_t										m_MeshLODTriangleCount{}; // per frame, visible
+	size_t										m_MeshLOD0TriangleCount{}; // per frame, visible, as if every LOD were 0
+	double										m_MeshLODGenerationMilliseconds{}; // of the last GenerateMeshLODs()
+	double										m_MeshSimplifyBenchmarkMicroseconds{}; // benchmark
+	double										m_MeshOptimizeBenchmarkMicroseconds{}; // benchmark
+	SMeshOptimizationStatistics					m_MeshOptimizeBenchmarkStatistics{}; // benchmark
+	double										m_MESHWriteBenchmarkMBps{}; // benchmark
+	double										m_MESHReadBenchmarkMBps{}; // benchmark
+	double										m_MESHImportBenchmarkMilliseconds{}; // benchmark, read into memory
+	double										m_MESHMappedImportBenchmarkMilliseconds{}; // benchmark, mapped
+	SLZBenchmark								m_MESHCompressionBenchmark{}; // benchmark
+	std::string									m_SceneFileName{}; // of the last LoadScene()
+	std::string									m_SceneContentDirectory{}; // of the last LoadScene()
+	std::chrono::steady_clock::time_point		m_SceneLoadStartTimePoint{};
+	bool										m_bIsSceneFirstFramePending{};
+	bool										m_bIsDrawingSceneFirstFrame{};
+	double										m_SceneLoadMilliseconds{}; // of the last LoadScene()
+	double										m_SceneFirstFrameMilliseconds{}; // from the last LoadScene() to the end of its first frame
+	std::unique_ptr<SSceneLoadingData>			m_SceneLoadingData{}; // nullptr unless loading
+	double										m_SceneDecodeBenchmarkMillisecondsSingleThread{}; // benchmark
+	double										m_SceneDecodeBenchmarkMillisecondsMultiThread{}; // benchmark
+	CSceneContainer::SSaveCache					m_SceneSaveCache{}; // of the last SaveScene() or LoadScene()
+	double										m_SceneSaveMilliseconds{}; // of the last SaveScene()
+	bool										m_bIsInstanceTableDirty{ true }; // objects or patterns changed since the last SaveScene() or LoadScene()
+	uint64_t									m_SavedInstanceTableHash{}; // see CSceneContainer::GetChunkRawHash()
+	bool										m_bShouldCompressSavedFiles{ true }; // scenes, terrains and OB3Ds (see CLZCodec)
 
 	std::vector<std::unique_ptr<CObject3DLine>>	m_vObject3DLines{};
 	std::vector<std::unique_ptr<CObject2D>>		m_vObject2Ds{};
@@ -816,6 +981,7 @@ private:
 // Light
 private:
 	std::unique_ptr<CLight>					m_LightArray[2]{}; // 0 for PointLight, 1 for SpotLight
+	double									m_LightClusterBenchmarkMicroseconds{};
 	std::unique_ptr<CBillboard>				m_LightRep{};
 	size_t									m_LightCreationCounter{};
 	std::unordered_map<std::string, size_t>	m_umapLightNames{};
@@ -984,6 +1150,7 @@ private:
 	float									m_NearZ{};
 	float									m_FarZ{};
 	XMMATRIX								m_MatrixView{};
+	BoundingFrustum							m_ViewFrustum{}; // world space
 
 // Input
 private:
@@ -0,0 +1,468 @@
+#include "LZCodec.h"
+#include "MappedFile.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+using std::min;
+using std::string;
+using std::vector;
+
+// LZ4 block format limits, so that a block is also valid for any LZ4 decoder
+static constexpr size_t KMinMatchByteCount{ 4 };
+static constexpr size_t KLastLiteralByteCount{ 5 }; // the last bytes are always literals
+static constexpr size_t KMatchSearchLimit{ 12 }; // no match starts within the last bytes
+static constexpr uint32_t KHashBitCount{ 13 };
+static constexpr size_t KWildCopyByteCount{ 16 };
+
+static uint32_t ReadU32(const uint8_t* const Data)
+{
+	uint32_t Value{};
+	memcpy(&Value, Data, 4);
+	return Value;
+}
+
+static uint32_t HashU32(uint32_t Value)
+{
+	return (Value * 2654435761u) >> (32 - KHashBitCount);
+}
+
+void CLZCodec::Compress(const uint8_t* const Data, size_t ByteCount, vector<uint8_t>& vOut)
+{
+	assert(Data || ByteCount == 0);
+
+	vOut.clear();
+	vOut.reserve(KHeaderByteCount + ByteCount / 2);
+
+	// 8B (string) Signature
+	vOut.insert(vOut.end(), KSignature, KSignature + KSignatureLength);
+
+	// 8B (uint64_t) Raw byte count
+	uint64_t RawByteCount{ ByteCount };
+	vOut.insert(vOut.end(), (const uint8_t*)&RawByteCount, (const uint8_t*)&RawByteCount + 8);
+
+	vector<uint16_t> vHashTable(size_t(1) << KHashBitCount);
+	vector<uint8_t> vFiltered(KBlockByteCount);
+	vector<uint8_t> vPayload(KBlockByteCount);
+	vector<uint8_t> vBestPayload(KBlockByteCount);
+	for (size_t Offset = 0; Offset < ByteCount; Offset += KBlockByteCount)
+	{
+		const size_t KRawByteCount{ min(KBlockByteCount, ByteCount - Offset) };
+		const uint8_t* const KRawBlock{ Data + Offset };
+
+		// @important: every filter is tried, since which one wins depends on what the block holds (floats, indices, pixels, strings...)
+		ELZFilter eBestFilter{ ELZFilter::None };
+		size_t BestPayloadByteCount{};
+		for (uint8_t iFilter = 0; iFilter < (uint8_t)ELZFilter::COUNT; ++iFilter)
+		{
+			ELZFilter eFilter{ (ELZFilter)iFilter };
+			const uint8_t* Source{ KRawBlock };
+			if (eFilter != ELZFilter::None)
+			{
+				ApplyFilter(eFilter, KRawBlock, KRawByteCount, &vFiltered[0]);
+				Source = &vFiltered[0];
+			}
+
+			// Only payloads smaller than the best so far (or than the raw block) are kept
+			// @important: a filter has to win by 1/16 or more, since filtered blocks decode slower (shorter matches and the revert)
+			size_t Capacity{ (BestPayloadByteCount) ? BestPayloadByteCount - 1 : KRawByteCount - 1 };
+			if (eFilter != ELZFilter::None && BestPayloadByteCount) Capacity = BestPayloadByteCount - BestPayloadByteCount / 16;
+			size_t PayloadByteCount{ (Capacity) ? CompressBlock(Source, KRawByteCount, &vPayload[0], Capacity, vHashTable) : 0 };
+			if (PayloadByteCount)
+			{
+				eBestFilter = eFilter;
+				BestPayloadByteCount = PayloadByteCount;
+				vBestPayload.swap(vPayload);
+			}
+		}
+
+		// 1B (uint8_t, enum) Filter
+		// 4B (uint32_t) Payload byte count
+		// Payload
+		uint32_t PayloadHeader{ (uint32_t)BestPayloadByteCount };
+		if (BestPayloadByteCount == 0)
+		{
+			eBestFilter = ELZFilter::None;
+			PayloadHeader = (uint32_t)KRawByteCount | KStoredFlag;
+		}
+		vOut.emplace_back((uint8_t)eBestFilter);
+		vOut.insert(vOut.end(), (const uint8_t*)&PayloadHeader, (const uint8_t*)&PayloadHeader + 4);
+		if (BestPayloadByteCount)
+		{
+			vOut.insert(vOut.end(), vBestPayload.begin(), vBestPayload.begin() + BestPayloadByteCount);
+		}
+		else
+		{
+			vOut.insert(vOut.end(), KRawBlock, KRawBlock + KRawByteCount);
+		}
+	}
+}
+
+bool CLZCodec::Decompress(const uint8_t* const Frame, size_t FrameByteCount, uint8_t* const Dst, size_t DstByteCount)
+{
+	uint64_t RawByteCount{};
+	if (!GetRawByteCount(Frame, FrameByteCount, RawByteCount) || RawByteCount != DstByteCount) return false;
+
+	// Filtered blocks are decoded here first, the rest straight into Dst
+	vector<uint8_t> vFiltered{};
+	size_t FrameOffset{ KHeaderByteCount };
+	for (size_t DstOffset = 0; DstOffset < DstByteCount; DstOffset += KBlockByteCount)
+	{
+		const size_t KRawByteCount{ min(KBlockByteCount, DstByteCount - DstOffset) };
+		if (FrameByteCount - FrameOffset < KBlockHeaderByteCount) return false;
+
+		ELZFilter eFilter{ (ELZFilter)Frame[FrameOffset] };
+		uint32_t PayloadHeader{ ReadU32(Frame + FrameOffset + 1) };
+		FrameOffset += KBlockHeaderByteCount;
+		if (eFilter >= ELZFilter::COUNT) return false;
+
+		const bool KIsStored{ (PayloadHeader & KStoredFlag) != 0 };
+		const size_t KPayloadByteCount{ PayloadHeader & ~KStoredFlag };
+		if (FrameByteCount - FrameOffset < KPayloadByteCount) return false;
+
+		const uint8_t* const KPayload{ Frame + FrameOffset };
+		FrameOffset += KPayloadByteCount;
+		if (KIsStored)
+		{
+			if (KPayloadByteCount != KRawByteCount) return false;
+
+			memcpy(Dst + DstOffset, KPayload, KRawByteCount);
+			continue;
+		}
+
+		if (eFilter == ELZFilter::None)
+		{
+			if (!DecompressBlock(KPayload, KPayloadByteCount, Dst + DstOffset, KRawByteCount)) return false;
+		}
+		else
+		{
+			vFiltered.resize(KBlockByteCount);
+			if (!DecompressBlock(KPayload, KPayloadByteCount, &vFiltered[0], KRawByteCount)) return false;
+			RevertFilter(eFilter, &vFiltered[0], KRawByteCount, Dst + DstOffset);
+		}
+	}
+
+	return (FrameOffset == FrameByteCount);
+}
+
+bool CLZCodec::IsCompressed(const uint8_t* const Data, size_t ByteCount)
+{
+	return (Data && ByteCount >= KHeaderByteCount && memcmp(Data, KSignature, KSignatureLength) == 0);
+}
+
+bool CLZCodec::GetRawByteCount(const uint8_t* const Frame, size_t FrameByteCount, uint64_t& OutRawByteCount)
+{
+	if (!IsCompressed(Frame, FrameByteCount)) return false;
+
+	memcpy(&OutRawByteCount, Frame + KSignatureLength, 8);
+
+	// @important: LZ4 sequences can't expand more than 255 times, so a broken count is caught before anything is allocated for it
+	return (OutRawByteCount / 256 <= FrameByteCount);
+}
+
+bool CLZCodec::MeasureFile(const string& FileName, uint32_t IterationCount, SLZBenchmark& Out)
+{
+	Out = SLZBenchmark();
+	if (IterationCount == 0) return false;
+
+	CMappedFile MappedFile{};
+	if (!MappedFile.Open(FileName)) return false;
+
+	const uint8_t* const KData{ MappedFile.GetData() };
+	const size_t KByteCount{ MappedFile.GetSize() };
+	vector<uint8_t> vRaw(KData, KData + KByteCount); // @important: page faults of the mapping aren't measured
+	vector<uint8_t> vFrame{};
+	vector<uint8_t> vDecompressed(KByteCount);
+
+	auto StartTimePoint{ std::chrono::steady_clock::now() };
+	Compress(vRaw.data(), vRaw.size(), vFrame);
+	double EncodeSeconds{ std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTimePoint).count() };
+
+	double DecodeSeconds{};
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
+	{
+		StartTimePoint = std::chrono::steady_clock::now();
+		bool bIsDecompressed{ Decompress(vFrame.data(), vFrame.size(), vDecompressed.data(), vDecompressed.size()) };
+		DecodeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTimePoint).count();
+
+		if (!bIsDecompressed) return false;
+	}
+	if (vRaw != vDecompressed) return false;
+
+	Out.RawByteCount = KByteCount;
+	Out.CompressedByteCount = vFrame.size();
+	Out.Ratio = (double)Out.RawByteCount / (double)Out.CompressedByteCount;
+	Out.EncodeMBps = (EncodeSeconds > 0.0) ? (double)KByteCount / EncodeSeconds / (1024.0 * 1024.0) : 0.0;
+	Out.DecodeGBps = (DecodeSeconds > 0.0) ? (double)KByteCount * IterationCount / DecodeSeconds / (1024.0 * 1024.0 * 1024.0) : 0.0;
+	return true;
+}
+
+size_t CLZCodec::CompressBlock(const uint8_t* const Src, size_t SrcByteCount, uint8_t* const Dst, size_t DstCapacity,
+	vector<uint16_t>& vHashTable)
+{
+	assert(SrcByteCount <= KBlockByteCount);
+
+	size_t DstOffset{};
+	auto WriteLength{ [&](size_t Length)
+		{
+			for (; Length >= 255; Length -= 255)
+			{
+				if (DstOffset >= DstCapacity) return false;
+				Dst[DstOffset++] = 255;
+			}
+			if (DstOffset >= DstCapacity) return false;
+			Dst[DstOffset++] = (uint8_t)Length;
+			return true;
+		}
+	};
+	auto WriteSequence{ [&](const uint8_t* const Literals, size_t LiteralByteCount, size_t MatchOffset, size_t MatchByteCount)
+		{
+			if (DstOffset >= DstCapacity) return false;
+
+			// 1B Token: literal length (high 4 bits) & match length - 4 (low 4 bits), 15 meaning more bytes follow
+			const size_t KMatchLengthCode{ (MatchByteCount) ? MatchByteCount - KMinMatchByteCount : 0 };
+			Dst[DstOffset++] = (uint8_t)((min(LiteralByteCount, (size_t)15) << 4) | min(KMatchLengthCode, (size_t)15));
+			if (LiteralByteCount >= 15 && !WriteLength(LiteralByteCount - 15)) return false;
+
+			if (DstCapacity - DstOffset < LiteralByteCount) return false;
+			memcpy(Dst + DstOffset, Literals, LiteralByteCount);
+			DstOffset += LiteralByteCount;
+
+			// @important: the last sequence has no match
+			if (MatchByteCount == 0) return true;
+
+			if (DstCapacity - DstOffset < 2) return false;
+			Dst[DstOffset++] = (uint8_t)(MatchOffset & 0xFF);
+			Dst[DstOffset++] = (uint8_t)(MatchOffset >> 8);
+			if (KMatchLengthCode >= 15 && !WriteLength(KMatchLengthCode - 15)) return false;
+			return true;
+		}
+	};
+
+	size_t Anchor{};
+	if (SrcByteCount > KMatchSearchLimit)
+	{
+		std::fill(vHashTable.begin(), vHashTable.end(), (uint16_t)0);
+
+		const size_t KMatchEnd{ SrcByteCount - KLastLiteralByteCount };
+		const size_t KSearchEnd{ SrcByteCount - KMatchSearchLimit };
+		size_t Position{ 1 }; // @important: 0 is what an empty hash table entry points at, so it's inserted first
+		vHashTable[HashU32(ReadU32(Src))] = 0;
+		while (Position <= KSearchEnd)
+		{
+			// Skips faster and faster through data that doesn't match (incompressible data costs little)
+			size_t Reference{};
+			bool bIsFound{};
+			for (uint32_t SearchCount = 1 << 6; Position <= KSearchEnd; ++SearchCount)
+			{
+				uint32_t Hash{ HashU32(ReadU32(Src + Position)) };
+				Reference = vHashTable[Hash];
+				vHashTable[Hash] = (uint16_t)Position;
+				if (Reference < Position && ReadU32(Src + Reference) == ReadU32(Src + Position))
+				{
+					bIsFound = true;
+					break;
+				}
+				Position += SearchCount >> 6;
+			}
+			if (!bIsFound) break;
+
+			// Extends the match backwards over the pending literals
+			while (Position > Anchor && Reference > 0 && Src[Position - 1] == Src[Reference - 1])
+			{
+				--Position;
+				--Reference;
+			}
+
+			size_t MatchByteCount{ KMinMatchByteCount };
+			while (Position + MatchByteCount < KMatchEnd && Src[Position + MatchByteCount] == Src[Reference + MatchByteCount])
+			{
+				++MatchByteCount;
+			}
+
+			if (!WriteSequence(Src + Anchor, Position - Anchor, Position - Reference, MatchByteCount)) return 0;
+
+			Position += MatchByteCount;
+			Anchor = Position;
+			if (Position <= KSearchEnd) vHashTable[HashU32(ReadU32(Src + Position - 2))] = (uint16_t)(Position - 2);
+		}
+	}
+
+	if (!WriteSequence(Src + Anchor, SrcByteCount - Anchor, 0, 0)) return 0;
+	return DstOffset;
+}
+
+bool CLZCodec::DecompressBlock(const uint8_t* const Src, size_t SrcByteCount, uint8_t* const Dst, size_t DstByteCount)
+{
+	size_t SrcOffset{};
+	size_t DstOffset{};
+	auto ReadLength{ [&](size_t& Length)
+		{
+			uint8_t Byte{};
+			do
+			{
+				if (SrcOffset >= SrcByteCount) return false;
+				Byte = Src[SrcOffset++];
+				Length += Byte;
+			} while (Byte == 255);
+			return true;
+		}
+	};
+
+	while (SrcOffset < SrcByteCount)
+	{
+		const uint8_t KToken{ Src[SrcOffset++] };
+
+		// @important: short sequences (no extra length bytes) are the most common ones, so they skip every check they can
+		// It never takes the last sequence, since that one ends the block with fewer than 15 literals
+		if (KToken < 0xF0 && (KToken & 15) < 15 &&
+			SrcByteCount - SrcOffset >= KWildCopyByteCount + 2 && DstByteCount - DstOffset >= KWildCopyByteCount * 2 + 18)
+		{
+			const size_t KLiteralByteCount{ (size_t)(KToken >> 4) };
+			memcpy(Dst + DstOffset, Src + SrcOffset, KWildCopyByteCount);
+			SrcOffset += KLiteralByteCount;
+			DstOffset += KLiteralByteCount;
+
+			const size_t KMatchOffset{ (size_t)(Src[SrcOffset] | (Src[SrcOffset + 1] << 8)) };
+			SrcOffset += 2;
+			if (KMatchOffset >= 8 && KMatchOffset <= DstOffset)
+			{
+				// At most 18 bytes
+				const uint8_t* const KMatchSrc{ Dst + DstOffset - KMatchOffset };
+				memcpy(Dst + DstOffset, KMatchSrc, 8);
+				memcpy(Dst + DstOffset + 8, KMatchSrc + 8, 8);
+				memcpy(Dst + DstOffset + 16, KMatchSrc + 16, 2);
+				DstOffset += (KToken & 15) + KMinMatchByteCount;
+				continue;
+			}
+
+			// Close repeats take the checked path below
+			SrcOffset -= 2;
+			SrcOffset -= KLiteralByteCount;
+			DstOffset -= KLiteralByteCount;
+		}
+
+		size_t LiteralByteCount{ (size_t)(KToken >> 4) };
+		if (LiteralByteCount == 15 && !ReadLength(LiteralByteCount)) return false;
+		if (SrcByteCount - SrcOffset < LiteralByteCount || DstByteCount - DstOffset < LiteralByteCount) return false;
+
+		// @important: short runs are copied 16 bytes at once when both sides have room for it (the extra bytes get overwritten later)
+		if (LiteralByteCount <= KWildCopyByteCount &&
+			SrcByteCount - SrcOffset >= KWildCopyByteCount && DstByteCount - DstOffset >= KWildCopyByteCount)
+		{
+			memcpy(Dst + DstOffset, Src + SrcOffset, KWildCopyByteCount);
+		}
+		else
+		{
+			memcpy(Dst + DstOffset, Src + SrcOffset, LiteralByteCount);
+		}
+		SrcOffset += LiteralByteCount;
+		DstOffset += LiteralByteCount;
+
+		// The last sequence ends with its literals
+		if (SrcOffset == SrcByteCount) break;
+
+		if (SrcByteCount - SrcOffset < 2) return false;
+		const size_t KMatchOffset{ (size_t)(Src[SrcOffset] | (Src[SrcOffset + 1] << 8)) };
+		SrcOffset += 2;
+		if (KMatchOffset == 0 || KMatchOffset > DstOffset) return false;
+
+		size_t MatchByteCount{ (size_t)(KToken & 15) };
+		if (MatchByteCount == 15 && !ReadLength(MatchByteCount)) return false;
+		MatchByteCount += KMinMatchByteCount;
+		if (DstByteCount - DstOffset < MatchByteCount) return false;
+
+		// @important: a match may overlap what it's copying (repeats)
+		uint8_t* const KMatchDst{ Dst + DstOffset };
+		const uint8_t* const KMatchSrc{ KMatchDst - KMatchOffset };
+		const bool KCanCopyWild{ DstByteCount - DstOffset >= MatchByteCount + KWildCopyByteCount };
+		if (KCanCopyWild && KMatchOffset >= KWildCopyByteCount)
+		{
+			for (size_t Copied = 0; Copied < MatchByteCount; Copied += KWildCopyByteCount)
+			{
+				memcpy(KMatchDst + Copied, KMatchSrc + Copied, KWildCopyByteCount);
+			}
+		}
+		else if (KCanCopyWild && KMatchOffset >= 8)
+		{
+			for (size_t Copied = 0; Copied < MatchByteCount; Copied += 8)
+			{
+				memcpy(KMatchDst + Copied, KMatchSrc + Copied, 8);
+			}
+		}
+		else if (KMatchOffset >= MatchByteCount)
+		{
+			memcpy(KMatchDst, KMatchSrc, MatchByteCount);
+		}
+		else if (KMatchOffset == 1)
+		{
+			memset(KMatchDst, *KMatchSrc, MatchByteCount);
+		}
+		else
+		{
+			// What is copied so far repeats the period as well, so each copy can take twice as much from the start of the match
+			for (size_t Copied = 0; Copied < MatchByteCount; )
+			{
+				const size_t KChunkByteCount{ min(Copied + KMatchOffset, MatchByteCount - Copied) };
+				memcpy(KMatchDst + Copied, KMatchSrc, KChunkByteCount);
+				Copied += KChunkByteCount;
+			}
+		}
+		DstOffset += MatchByteCount;
+	}
+
+	return (DstOffset == DstByteCount);
+}
+
+void CLZCodec::ApplyFilter(ELZFilter eFilter, const uint8_t* const Src, size_t ByteCount, uint8_t* const Dst)
+{
+	assert(eFilter != ELZFilter::None);
+
+	// @important: the bytes that don't make a whole component stay at the end as they are
+	const size_t KComponentCount{ ByteCount / 4 };
+	uint8_t* const Planes[4]{ Dst, Dst + KComponentCount, Dst + KComponentCount * 2, Dst + KComponentCount * 3 };
+	uint8_t Previous[4]{};
+	for (size_t iComponent = 0; iComponent < KComponentCount; ++iComponent)
+	{
+		const uint8_t* const KComponent{ Src + iComponent * 4 };
+		for (size_t iPlane = 0; iPlane < 4; ++iPlane)
+		{
+			Planes[iPlane][iComponent] = (uint8_t)(KComponent[iPlane] - Previous[iPlane]);
+			if (eFilter == ELZFilter::Shuffle4Delta) Previous[iPlane] = KComponent[iPlane];
+		}
+	}
+	memcpy(Dst + KComponentCount * 4, Src + KComponentCount * 4, ByteCount - KComponentCount * 4);
+}
+
+void CLZCodec::RevertFilter(ELZFilter eFilter, const uint8_t* const Src, size_t ByteCount, uint8_t* const Dst)
+{
+	assert(eFilter != ELZFilter::None);
+
+	// @important: one pass writing whole components, since this runs for every filtered block that is decoded
+	const size_t KComponentCount{ ByteCount / 4 };
+	const uint8_t* const Planes[4]{ Src, Src + KComponentCount, Src + KComponentCount * 2, Src + KComponentCount * 3 };
+	if (eFilter == ELZFilter::Shuffle4Delta)
+	{
+		uint8_t Sums[4]{};
+		for (size_t iComponent = 0; iComponent < KComponentCount; ++iComponent)
+		{
+			Sums[0] += Planes[0][iComponent];
+			Sums[1] += Planes[1][iComponent];
+			Sums[2] += Planes[2][iComponent];
+			Sums[3] += Planes[3][iComponent];
+			memcpy(Dst + iComponent * 4, Sums, 4);
+		}
+	}
+	else
+	{
+		for (size_t iComponent = 0; iComponent < KComponentCount; ++iComponent)
+		{
+			uint8_t* const Component{ Dst + iComponent * 4 };
+			Component[0] = Planes[0][iComponent];
+			Component[1] = Planes[1][iComponent];
+			Component[2] = Planes[2][iComponent];
+			Component[3] = Planes[3][iComponent];
+		}
+	}
+	memcpy(Dst + KComponentCount * 4, Src + KComponentCount * 4, ByteCount - KComponentCount * 4);
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+// @important: pure CPU, so that it can be tested and measured without a device
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cassert>
+
+// @important: stored in files, so never reorder (append before COUNT)
+enum class ELZFilter : uint8_t
+{
+	None,
+	Shuffle4, // bytes of 4-byte components grouped into 4 planes (the exponents of floats line up)
+	Shuffle4Delta, // and each plane stored as differences (smooth arrays, e.g. positions and height maps)
+
+	COUNT
+};
+
+struct SLZBenchmark
+{
+	uint64_t	RawByteCount{};
+	uint64_t	CompressedByteCount{};
+	double		Ratio{}; // raw / compressed
+	double		EncodeMBps{};
+	double		DecodeGBps{};
+};
+
+// LZ4-class codec (LZ4 block format: greedy hash matching, no entropy coding) for file payloads
+// Data is split into independent blocks, each stored with the filter that compresses it best (or stored as it is),
+// so that a block can be decoded straight into its destination without any other block
+//
+// Frame:
+// 8B (string) Signature
+// 8B (uint64_t) Raw byte count
+// Blocks of KBlockByteCount raw bytes (the last one may be shorter):
+//   1B (uint8_t, enum) Filter
+//   4B (uint32_t) Payload byte count, the highest bit set if the payload is stored as it is
+//   Payload
+class CLZCodec
+{
+public:
+	CLZCodec() {}
+	~CLZCodec() {}
+
+public:
+	// vOut is replaced by the frame
+	static void Compress(const uint8_t* const Data, size_t ByteCount, std::vector<uint8_t>& vOut);
+	// Decodes the frame straight into Dst block by block, DstByteCount must be the raw byte count
+	// Returns false if the frame is broken (nothing is written past Dst + DstByteCount)
+	static bool Decompress(const uint8_t* const Frame, size_t FrameByteCount, uint8_t* const Dst, size_t DstByteCount);
+
+public:
+	// Reads only the signature
+	static bool IsCompressed(const uint8_t* const Data, size_t ByteCount);
+	// Returns false if it's not a frame or the count can't be right
+	static bool GetRawByteCount(const uint8_t* const Frame, size_t FrameByteCount, uint64_t& OutRawByteCount);
+
+public:
+	// Compresses the file once and decompresses it IterationCount times
+	// Returns false if it can't be read or doesn't round-trip
+	static bool MeasureFile(const std::string& FileName, uint32_t IterationCount, SLZBenchmark& Out);
+
+public:
+	static constexpr size_t KBlockByteCount{ 64 * 1024 }; // @important: match offsets are 16-bit
+	static constexpr size_t KHeaderByteCount{ 8 + 8 };
+	static constexpr size_t KBlockHeaderByteCount{ 1 + 4 };
+
+private:
+	// LZ4 block format, returns the payload byte count or 0 if it doesn't fit DstCapacity
+	static size_t CompressBlock(const uint8_t* const Src, size_t SrcByteCount, uint8_t* const Dst, size_t DstCapacity,
+		std::vector<uint16_t>& vHashTable);
+	static bool DecompressBlock(const uint8_t* const Src, size_t SrcByteCount, uint8_t* const Dst, size_t DstByteCount);
+
+	static void ApplyFilter(ELZFilter eFilter, const uint8_t* const Src, size_t ByteCount, uint8_t* const Dst);
+	static void RevertFilter(ELZFilter eFilter, const uint8_t* const Src, size_t ByteCount, uint8_t* const Dst);
+
+private:
+	static constexpr char KSignature[]{ "KJW_LZCF" };
+	static constexpr size_t KSignatureLength{ 8 };
+	static constexpr uint32_t KStoredFlag{ 0x80000000 };
+};
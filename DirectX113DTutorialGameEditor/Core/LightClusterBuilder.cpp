@@ -0,0 +1,394 @@
+#include "LightClusterBuilder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace DirectX;
+using std::max;
+using std::min;
+
+void CLightClusterBuilder::SetGrid(uint32_t ScreenWidth, uint32_t ScreenHeight, uint32_t TileSize, uint32_t SliceCount,
+	float NearZ, float FarZ, const XMMATRIX& ProjectionMatrix)
+{
+	assert(ScreenWidth && ScreenHeight && TileSize && SliceCount);
+	assert(NearZ > 0.0f && FarZ > NearZ);
+
+	XMFLOAT4X4 Projection{};
+	XMStoreFloat4x4(&Projection, ProjectionMatrix);
+
+	if (m_ScreenWidth == ScreenWidth && m_ScreenHeight == ScreenHeight && m_TileSize == TileSize && m_SliceCount == SliceCount &&
+		m_NearZ == NearZ && m_FarZ == FarZ && m_ProjectionX == Projection._11 && m_ProjectionY == Projection._22) return;
+
+	m_ScreenWidth = ScreenWidth;
+	m_ScreenHeight = ScreenHeight;
+	m_TileSize = TileSize;
+	m_TileCountX = (ScreenWidth + TileSize - 1) / TileSize;
+	m_TileCountXPadded = (m_TileCountX + 3) & ~3u;
+	m_TileCountY = (ScreenHeight + TileSize - 1) / TileSize;
+	m_SliceCount = SliceCount;
+	m_NearZ = NearZ;
+	m_FarZ = FarZ;
+	m_SliceScale = (float)SliceCount / logf(FarZ / NearZ);
+	m_ProjectionX = Projection._11;
+	m_ProjectionY = Projection._22;
+
+	// @important: exponential slices, so that clusters keep a similar shape at every depth
+	m_vSliceDepths.resize(SliceCount + 1);
+	for (uint32_t iSlice = 0; iSlice <= SliceCount; ++iSlice)
+	{
+		m_vSliceDepths[iSlice] = NearZ * powf(FarZ / NearZ, (float)iSlice / (float)SliceCount);
+	}
+
+	m_vTileCenterX.resize((size_t)SliceCount * m_TileCountXPadded);
+	m_vTileExtentX.resize((size_t)SliceCount * m_TileCountXPadded);
+	m_vTileCenterY.resize((size_t)SliceCount * m_TileCountY);
+	m_vTileExtentY.resize((size_t)SliceCount * m_TileCountY);
+	for (uint32_t iSlice = 0; iSlice < SliceCount; ++iSlice)
+	{
+		const float KZ0{ m_vSliceDepths[iSlice] };
+		const float KZ1{ m_vSliceDepths[iSlice + 1] };
+
+		for (uint32_t iTileX = 0; iTileX < m_TileCountXPadded; ++iTileX)
+		{
+			size_t Index{ (size_t)iSlice * m_TileCountXPadded + iTileX };
+			if (iTileX >= m_TileCountX)
+			{
+				// @important: padding tiles are too far away to ever be touched
+				m_vTileCenterX[Index] = 1e30f;
+				m_vTileExtentX[Index] = 0.0f;
+				continue;
+			}
+
+			float NdcMin{ (float)(iTileX * TileSize) / ScreenWidth * 2.0f - 1.0f };
+			float NdcMax{ (float)min((iTileX + 1) * TileSize, ScreenWidth) / ScreenWidth * 2.0f - 1.0f };
+			float MinX{ min(NdcMin * KZ0, NdcMin * KZ1) / m_ProjectionX };
+			float MaxX{ max(NdcMax * KZ0, NdcMax * KZ1) / m_ProjectionX };
+			m_vTileCenterX[Index] = (MinX + MaxX) * 0.5f;
+			m_vTileExtentX[Index] = (MaxX - MinX) * 0.5f;
+		}
+
+		for (uint32_t iTileY = 0; iTileY < m_TileCountY; ++iTileY)
+		{
+			size_t Index{ (size_t)iSlice * m_TileCountY + iTileY };
+
+			float NdcMax{ 1.0f - (float)(iTileY * TileSize) / ScreenHeight * 2.0f };
+			float NdcMin{ 1.0f - (float)min((iTileY + 1) * TileSize, ScreenHeight) / ScreenHeight * 2.0f };
+			float MinY{ min(NdcMin * KZ0, NdcMin * KZ1) / m_ProjectionY };
+			float MaxY{ max(NdcMax * KZ0, NdcMax * KZ1) / m_ProjectionY };
+			m_vTileCenterY[Index] = (MinY + MaxY) * 0.5f;
+			m_vTileExtentY[Index] = (MaxY - MinY) * 0.5f;
+		}
+	}
+
+	m_vClusters.assign(GetClusterCount(), SCluster());
+	m_vLightIndices.clear();
+	m_Statistics = SStatistics();
+}
+
+void CLightClusterBuilder::ClearLights()
+{
+	m_vLights.clear();
+}
+
+void CLightClusterBuilder::AddPointLight(const XMVECTOR& Position, float Range)
+{
+	SLight Light{};
+	XMStoreFloat4(&Light.Sphere, XMVectorSetW(Position, Range));
+
+	m_vLights.emplace_back(Light);
+}
+
+void CLightClusterBuilder::AddSpotLight(const XMVECTOR& Position, const XMVECTOR& Direction, float Range, float HalfAngle)
+{
+	assert(HalfAngle > 0.0f && HalfAngle < XM_PIDIV2);
+
+	SLight Light{};
+	Light.bIsSpotLight = true;
+	XMScalarSinCos(&Light.ConeSin, &Light.ConeCos, HalfAngle);
+	Light.ConeRange = Range / Light.ConeCos; // @important: the lit volume is a sphere sector, as in DSSpotLight
+	XMStoreFloat3(&Light.ConeApex, Position);
+	XMStoreFloat3(&Light.ConeDirection, Direction);
+
+	// Tightest bounding sphere of the sphere sector
+	float CenterDistance{};
+	float Radius{};
+	if (HalfAngle < XM_PIDIV4)
+	{
+		CenterDistance = Radius = Light.ConeRange / (2.0f * Light.ConeCos);
+	}
+	else
+	{
+		CenterDistance = Light.ConeRange * Light.ConeCos;
+		Radius = Light.ConeRange * Light.ConeSin;
+	}
+	XMStoreFloat4(&Light.Sphere, XMVectorSetW(XMVectorMultiplyAdd(Direction, XMVectorReplicate(CenterDistance), Position), Radius));
+
+	m_vLights.emplace_back(Light);
+}
+
+void CLightClusterBuilder::Build()
+{
+	assert(m_SliceCount);
+
+	m_vAssignments.clear();
+	for (uint32_t iLight = 0; iLight < (uint32_t)m_vLights.size(); ++iLight)
+	{
+		AssignLight(iLight);
+	}
+
+	// @important: counting sort by cluster, stable so that every cluster lists its lights in the order they were added
+	m_vClusters.assign(GetClusterCount(), SCluster());
+	for (uint64_t Assignment : m_vAssignments)
+	{
+		++m_vClusters[(uint32_t)(Assignment >> 32)].Count;
+	}
+
+	m_Statistics = SStatistics();
+	uint32_t Offset{};
+	for (SCluster& Cluster : m_vClusters)
+	{
+		Cluster.Offset = Offset;
+		Offset += Cluster.Count;
+
+		m_Statistics.NonEmptyClusterCount += (Cluster.Count) ? 1 : 0;
+		m_Statistics.MaxLightCountPerCluster = max(m_Statistics.MaxLightCountPerCluster, Cluster.Count);
+
+		Cluster.Count = 0;
+	}
+	m_Statistics.LightIndexCount = Offset;
+
+	m_vLightIndices.resize(m_vAssignments.size());
+	for (uint64_t Assignment : m_vAssignments)
+	{
+		SCluster& Cluster{ m_vClusters[(uint32_t)(Assignment >> 32)] };
+		m_vLightIndices[(size_t)Cluster.Offset + Cluster.Count] = (uint32_t)Assignment;
+		++Cluster.Count;
+	}
+}
+
+void CLightClusterBuilder::AssignLight(uint32_t LightIndex)
+{
+	const SLight& Light{ m_vLights[LightIndex] };
+	const float KCenterX{ Light.Sphere.x };
+	const float KCenterY{ Light.Sphere.y };
+	const float KCenterZ{ Light.Sphere.z };
+	const float KRadius{ Light.Sphere.w };
+
+	float MinZ{ max(KCenterZ - KRadius, m_NearZ) };
+	float MaxZ{ min(KCenterZ + KRadius, m_FarZ) };
+	if (MinZ > MaxZ) return;
+
+	const XMVECTOR KZero{ XMVectorZero() };
+	const XMVECTOR KCenterXs{ XMVectorReplicate(KCenterX) };
+
+	// Spot light cone (apex, axis, angle and range) against the bounding spheres of 4 clusters at a time
+	const XMVECTOR KConeDirectionXs{ XMVectorReplicate(Light.ConeDirection.x) };
+	const XMVECTOR KConeCoss{ XMVectorReplicate(Light.ConeCos) };
+	const XMVECTOR KConeSins{ XMVectorReplicate(Light.ConeSin) };
+	const XMVECTOR KConeRanges{ XMVectorReplicate(Light.ConeRange) };
+	const XMVECTOR KConeApexXs{ XMVectorReplicate(Light.ConeApex.x) };
+
+	const uint32_t KMinSlice{ GetSliceIndex(MinZ) };
+	const uint32_t KMaxSlice{ GetSliceIndex(MaxZ) };
+	for (uint32_t iSlice = KMinSlice; iSlice <= KMaxSlice; ++iSlice)
+	{
+		const float KZ0{ m_vSliceDepths[iSlice] };
+		const float KZ1{ m_vSliceDepths[iSlice + 1] };
+		float DistanceZ{ max(max(KZ0 - KCenterZ, KCenterZ - KZ1), 0.0f) };
+		float RemainingZ{ KRadius * KRadius - DistanceZ * DistanceZ };
+		if (RemainingZ < 0.0f) continue;
+
+		uint32_t MinTileX{}, MaxTileX{}, MinTileY{}, MaxTileY{};
+		if (!GetTileRange(KCenterX - KRadius, KCenterX + KRadius, KCenterY - KRadius, KCenterY + KRadius,
+			max(MinZ, KZ0), min(MaxZ, KZ1), MinTileX, MaxTileX, MinTileY, MaxTileY)) continue;
+
+		const float* const PtrTileCenterX{ &m_vTileCenterX[(size_t)iSlice * m_TileCountXPadded] };
+		const float* const PtrTileExtentX{ &m_vTileExtentX[(size_t)iSlice * m_TileCountXPadded] };
+		const float KClusterCenterZ{ (KZ0 + KZ1) * 0.5f };
+		const float KClusterExtentZ{ (KZ1 - KZ0) * 0.5f };
+
+		for (uint32_t iTileY = MinTileY; iTileY <= MaxTileY; ++iTileY)
+		{
+			const float KClusterCenterY{ m_vTileCenterY[(size_t)iSlice * m_TileCountY + iTileY] };
+			const float KClusterExtentY{ m_vTileExtentY[(size_t)iSlice * m_TileCountY + iTileY] };
+			float DistanceY{ max(fabsf(KCenterY - KClusterCenterY) - KClusterExtentY, 0.0f) };
+			float Remaining{ RemainingZ - DistanceY * DistanceY };
+			if (Remaining < 0.0f) continue;
+
+			const XMVECTOR KRemainings{ XMVectorReplicate(Remaining) };
+
+			// Cone terms that are the same for the whole row
+			const float KConeVY{ KClusterCenterY - Light.ConeApex.y };
+			const float KConeVZ{ KClusterCenterZ - Light.ConeApex.z };
+			const XMVECTOR KConeVYZDots{ XMVectorReplicate(KConeVY * Light.ConeDirection.y + KConeVZ * Light.ConeDirection.z) };
+			const XMVECTOR KConeVYZLengthSqs{ XMVectorReplicate(KConeVY * KConeVY + KConeVZ * KConeVZ) };
+			const XMVECTOR KExtentYZLengthSqs{ XMVectorReplicate(KClusterExtentY * KClusterExtentY + KClusterExtentZ * KClusterExtentZ) };
+
+			for (uint32_t iTileX = MinTileX & ~3u; iTileX <= MaxTileX; iTileX += 4)
+			{
+				XMVECTOR TileCenterXs{ XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(PtrTileCenterX + iTileX)) };
+				XMVECTOR TileExtentXs{ XMLoadFloat4(reinterpret_cast<const XMFLOAT4*>(PtrTileExtentX + iTileX)) };
+
+				// Sphere against AABB
+				XMVECTOR DistanceXs{ XMVectorMax(XMVectorSubtract(XMVectorAbs(XMVectorSubtract(KCenterXs, TileCenterXs)), TileExtentXs), KZero) };
+				XMVECTOR Intersects{ XMVectorLessOrEqual(XMVectorMultiply(DistanceXs, DistanceXs), KRemainings) };
+
+				if (Light.bIsSpotLight)
+				{
+					XMVECTOR ClusterRadii{ XMVectorSqrt(XMVectorMultiplyAdd(TileExtentXs, TileExtentXs, KExtentYZLengthSqs)) };
+					XMVECTOR ConeVXs{ XMVectorSubtract(TileCenterXs, KConeApexXs) };
+					XMVECTOR AxisDistances{ XMVectorMultiplyAdd(ConeVXs, KConeDirectionXs, KConeVYZDots) };
+					XMVECTOR LengthSqs{ XMVectorMultiplyAdd(ConeVXs, ConeVXs, KConeVYZLengthSqs) };
+					XMVECTOR PerpendicularDistances{ XMVectorSqrt(XMVectorMax(XMVectorNegativeMultiplySubtract(AxisDistances, AxisDistances, LengthSqs), KZero)) };
+
+					// Distance from the cluster center to the cone surface
+					XMVECTOR ConeDistances{ XMVectorNegativeMultiplySubtract(AxisDistances, KConeSins, XMVectorMultiply(KConeCoss, PerpendicularDistances)) };
+					Intersects = XMVectorAndInt(Intersects, XMVectorLessOrEqual(ConeDistances, ClusterRadii));
+					Intersects = XMVectorAndInt(Intersects, XMVectorLessOrEqual(AxisDistances, XMVectorAdd(ClusterRadii, KConeRanges)));
+					Intersects = XMVectorAndInt(Intersects, XMVectorGreaterOrEqual(AxisDistances, XMVectorNegate(ClusterRadii)));
+				}
+
+				XMUINT4 IntersectionMask{};
+				XMStoreUInt4(&IntersectionMask, Intersects);
+				const uint32_t KLaneMasks[4]{ IntersectionMask.x, IntersectionMask.y, IntersectionMask.z, IntersectionMask.w };
+				for (uint32_t iLane = 0; iLane < 4; ++iLane)
+				{
+					uint32_t TileX{ iTileX + iLane };
+					if (!KLaneMasks[iLane] || TileX < MinTileX || TileX > MaxTileX) continue;
+
+					m_vAssignments.emplace_back(((uint64_t)GetClusterIndex(TileX, iTileY, iSlice) << 32) | LightIndex);
+				}
+			}
+		}
+	}
+}
+
+bool CLightClusterBuilder::GetTileRange(float MinX, float MaxX, float MinY, float MaxY, float MinZ, float MaxZ,
+	uint32_t& OutMinTileX, uint32_t& OutMaxTileX, uint32_t& OutMinTileY, uint32_t& OutMaxTileY) const
+{
+	assert(MinZ > 0.0f);
+
+	// @important: x / z is monotonic in z for a fixed x, so the projected extremes are at the corners
+	float NdcMinX{ min(MinX / MinZ, MinX / MaxZ) * m_ProjectionX };
+	float NdcMaxX{ max(MaxX / MinZ, MaxX / MaxZ) * m_ProjectionX };
+	float NdcMinY{ min(MinY / MinZ, MinY / MaxZ) * m_ProjectionY };
+	float NdcMaxY{ max(MaxY / MinZ, MaxY / MaxZ) * m_ProjectionY };
+	if (NdcMaxX < -1.0f || NdcMinX > 1.0f || NdcMaxY < -1.0f || NdcMinY > 1.0f) return false;
+
+	const float KTilesPerNdcX{ 0.5f * (float)m_ScreenWidth / (float)m_TileSize };
+	const float KTilesPerNdcY{ 0.5f * (float)m_ScreenHeight / (float)m_TileSize };
+	auto ToTile{ [](float Tile, uint32_t TileCount) { return (uint32_t)min(max(Tile, 0.0f), (float)(TileCount - 1)); } };
+
+	OutMinTileX = ToTile((NdcMinX + 1.0f) * KTilesPerNdcX, m_TileCountX);
+	OutMaxTileX = ToTile((NdcMaxX + 1.0f) * KTilesPerNdcX, m_TileCountX);
+	OutMinTileY = ToTile((1.0f - NdcMaxY) * KTilesPerNdcY, m_TileCountY); // @important: tile rows go downwards
+	OutMaxTileY = ToTile((1.0f - NdcMinY) * KTilesPerNdcY, m_TileCountY);
+	return true;
+}
+
+uint32_t CLightClusterBuilder::GetClusterIndex(uint32_t TileX, uint32_t TileY, uint32_t Slice) const
+{
+	return (Slice * m_TileCountY + TileY) * m_TileCountX + TileX;
+}
+
+uint32_t CLightClusterBuilder::GetSliceIndex(float ViewZ) const
+{
+	if (ViewZ <= m_NearZ) return 0;
+	return min((uint32_t)(logf(ViewZ / m_NearZ) * m_SliceScale), m_SliceCount - 1);
+}
+
+uint32_t CLightClusterBuilder::GetTileCountX() const
+{
+	return m_TileCountX;
+}
+
+uint32_t CLightClusterBuilder::GetTileCountY() const
+{
+	return m_TileCountY;
+}
+
+uint32_t CLightClusterBuilder::GetSliceCount() const
+{
+	return m_SliceCount;
+}
+
+uint32_t CLightClusterBuilder::GetClusterCount() const
+{
+	return m_TileCountX * m_TileCountY * m_SliceCount;
+}
+
+uint32_t CLightClusterBuilder::GetLightCount() const
+{
+	return (uint32_t)m_vLights.size();
+}
+
+const std::vector<CLightClusterBuilder::SCluster>& CLightClusterBuilder::GetClusters() const
+{
+	return m_vClusters;
+}
+
+const std::vector<uint32_t>& CLightClusterBuilder::GetLightIndices() const
+{
+	return m_vLightIndices;
+}
+
+const CLightClusterBuilder::SStatistics& CLightClusterBuilder::GetStatistics() const
+{
+	return m_Statistics;
+}
+
+double CLightClusterBuilder::MeasureBuildTime(uint32_t LightCount, uint32_t IterationCount)
+{
+	if (IterationCount == 0) return 0.0;
+
+	constexpr uint32_t KScreenWidth{ 1920 };
+	constexpr uint32_t KScreenHeight{ 1080 };
+	constexpr float KAspectRatio{ (float)KScreenWidth / (float)KScreenHeight };
+	constexpr float KFOV{ 50.0f / 360.0f * XM_2PI };
+	constexpr float KNearZ{ 0.1f };
+	constexpr float KFarZ{ 1000.0f };
+
+	CLightClusterBuilder Builder{};
+	Builder.SetGrid(KScreenWidth, KScreenHeight, KDefaultTileSize, KDefaultSliceCount, KNearZ, KFarZ,
+		XMMatrixPerspectiveFovLH(KFOV, KAspectRatio, KNearZ, KFarZ));
+
+	// @important: fixed seed (xorshift), so that the results are comparable between runs
+	uint64_t State{ 0x9E3779B97F4A7C15 };
+	auto Random{ [&State](float Min, float Max)
+		{
+			State ^= State << 13;
+			State ^= State >> 7;
+			State ^= State << 17;
+			return Min + (Max - Min) * (float)(State >> 40) / (float)(1 << 24);
+		}
+	};
+
+	// Lights are spread over the view frustum up to 200 units away
+	const float KTanHalfFOV{ tanf(KFOV * 0.5f) };
+	for (uint32_t iLight = 0; iLight < LightCount; ++iLight)
+	{
+		float Z{ Random(1.0f, 200.0f) };
+		XMVECTOR Position{ XMVectorSet(Random(-1.0f, 1.0f) * Z * KTanHalfFOV * KAspectRatio, Random(-1.0f, 1.0f) * Z * KTanHalfFOV, Z, 1.0f) };
+		float Range{ Random(1.0f, 8.0f) };
+		if (iLight & 1)
+		{
+			XMVECTOR Direction{ XMVector3Normalize(XMVectorSet(Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), Random(-1.0f, 1.0f), 0.0f)) };
+			if (XMVector3Equal(Direction, XMVectorZero())) Direction = XMVectorSet(0, -1, 0, 0);
+			Builder.AddSpotLight(Position, Direction, Range, Random(0.2f, 0.8f));
+		}
+		else
+		{
+			Builder.AddPointLight(Position, Range);
+		}
+	}
+
+	double TotalMicroseconds{};
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
+	{
+		auto StartTimePoint{ std::chrono::steady_clock::now() };
+		Builder.Build();
+		TotalMicroseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - StartTimePoint).count();
+	}
+
+	return TotalMicroseconds / IterationCount;
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+// @important: pure CPU (DirectXMath only), so that it doesn't depend on any device
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <DirectXMath.h>
+
+// Assigns point and spot lights to view-space froxel clusters (screen tiles x exponential depth slices)
+// The output is one (Offset, Count) pair per cluster into a compact light index list,
+// so that both can be uploaded as they are (StructuredBuffer<uint2>, StructuredBuffer<uint>) for a single clustered shading pass
+// Light indices are in the order the lights were added
+class CLightClusterBuilder
+{
+public:
+	struct SCluster
+	{
+		uint32_t	Offset{}; // into the light index list
+		uint32_t	Count{};
+	};
+
+	struct SStatistics
+	{
+		uint32_t	NonEmptyClusterCount{};
+		uint32_t	MaxLightCountPerCluster{};
+		uint32_t	LightIndexCount{};
+	};
+
+private:
+	// View space
+	struct SLight
+	{
+		DirectX::XMFLOAT4	Sphere{}; // bounding sphere, xyz = center, w = radius
+		DirectX::XMFLOAT3	ConeApex{};
+		DirectX::XMFLOAT3	ConeDirection{};
+		float				ConeRange{}; // from the apex
+		float				ConeCos{}; // of the half angle
+		float				ConeSin{}; // of the half angle
+		bool				bIsSpotLight{};
+	};
+
+public:
+	CLightClusterBuilder() {}
+	~CLightClusterBuilder() {}
+
+public:
+	// ProjectionMatrix must be a left-handed perspective projection without offset (XMMatrixPerspectiveFovLH)
+	// Cluster bounds are rebuilt only when any parameter changes
+	void SetGrid(uint32_t ScreenWidth, uint32_t ScreenHeight, uint32_t TileSize, uint32_t SliceCount,
+		float NearZ, float FarZ, const DirectX::XMMATRIX& ProjectionMatrix);
+
+	void ClearLights();
+	// Position in view space
+	void AddPointLight(const DirectX::XMVECTOR& Position, float Range);
+	// Position and Direction (normalized) in view space, Range along Direction, HalfAngle in radians (< pi/2)
+	void AddSpotLight(const DirectX::XMVECTOR& Position, const DirectX::XMVECTOR& Direction, float Range, float HalfAngle);
+
+	void Build();
+
+public:
+	// Slice-major: (Slice * TileCountY + TileY) * TileCountX + TileX, TileY = 0 is the top row
+	uint32_t GetClusterIndex(uint32_t TileX, uint32_t TileY, uint32_t Slice) const;
+	// View-space depth to slice (clamped)
+	uint32_t GetSliceIndex(float ViewZ) const;
+
+	uint32_t GetTileCountX() const;
+	uint32_t GetTileCountY() const;
+	uint32_t GetSliceCount() const;
+	uint32_t GetClusterCount() const;
+	uint32_t GetLightCount() const;
+
+	const std::vector<SCluster>& GetClusters() const;
+	const std::vector<uint32_t>& GetLightIndices() const;
+	const SStatistics& GetStatistics() const;
+
+public:
+	// Builds the clusters of LightCount random lights (half of them spot lights) on a 1920x1080 grid
+	// IterationCount times and returns the average time in microseconds
+	static double MeasureBuildTime(uint32_t LightCount, uint32_t IterationCount);
+
+public:
+	static constexpr uint32_t KDefaultTileSize{ 64 };
+	static constexpr uint32_t KDefaultSliceCount{ 24 };
+
+private:
+	// Appends the clusters of one light to the (cluster, light) pairs
+	void AssignLight(uint32_t LightIndex);
+	// Returns false when the view-space box is off the screen
+	bool GetTileRange(float MinX, float MaxX, float MinY, float MaxY, float MinZ, float MaxZ,
+		uint32_t& OutMinTileX, uint32_t& OutMaxTileX, uint32_t& OutMinTileY, uint32_t& OutMaxTileY) const;
+
+private:
+	uint32_t				m_ScreenWidth{};
+	uint32_t				m_ScreenHeight{};
+	uint32_t				m_TileSize{};
+	uint32_t				m_TileCountX{};
+	uint32_t				m_TileCountXPadded{}; // multiple of 4
+	uint32_t				m_TileCountY{};
+	uint32_t				m_SliceCount{};
+	float					m_NearZ{};
+	float					m_FarZ{};
+	float					m_SliceScale{}; // SliceCount / log(FarZ / NearZ)
+	float					m_ProjectionX{}; // _11
+	float					m_ProjectionY{}; // _22
+
+	// Cluster bounds (view-space AABBs) split by the axis they depend on, so that 4 tiles of a row are tested at a time
+	std::vector<float>		m_vSliceDepths{}; // [Slice + 1]
+	std::vector<float>		m_vTileCenterX{}; // [Slice][TileXPadded]
+	std::vector<float>		m_vTileExtentX{}; // [Slice][TileXPadded]
+	std::vector<float>		m_vTileCenterY{}; // [Slice][TileY]
+	std::vector<float>		m_vTileExtentY{}; // [Slice][TileY]
+
+	std::vector<SLight>		m_vLights{};
+	std::vector<uint64_t>	m_vAssignments{}; // (ClusterIndex << 32) | LightIndex
+
+	std::vector<SCluster>	m_vClusters{};
+	std::vector<uint32_t>	m_vLightIndices{};
+	SStatistics				m_Statistics{};
+};
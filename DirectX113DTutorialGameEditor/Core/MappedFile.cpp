@@ -0,0 +1,117 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+CMappedFile::~CMappedFile()
+{
+	Close();
+}
+
+bool CMappedFile::Open(const std::string& FileName)
+{
+	Close();
+
+#ifdef _WIN32
+	HANDLE FileHandle{ CreateFileA(FileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+		FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr) };
+	if (FileHandle == INVALID_HANDLE_VALUE) return false;
+
+	LARGE_INTEGER FileSize{};
+	if (!GetFileSizeEx(FileHandle, &FileSize))
+	{
+		CloseHandle(FileHandle);
+		return false;
+	}
+	m_FileHandle = FileHandle;
+	m_Size = (size_t)FileSize.QuadPart;
+
+	// @important: an empty file can't be mapped, but it is still a valid (empty) file
+	if (m_Size)
+	{
+		HANDLE MappingHandle{ CreateFileMappingA(FileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr) };
+		if (MappingHandle == nullptr)
+		{
+			Close();
+			return false;
+		}
+		m_MappingHandle = MappingHandle;
+
+		m_PtrData = (const uint8_t*)MapViewOfFile(MappingHandle, FILE_MAP_READ, 0, 0, 0);
+		if (m_PtrData == nullptr)
+		{
+			Close();
+			return false;
+		}
+	}
+#else
+	m_FileDescriptor = open(FileName.c_str(), O_RDONLY);
+	if (m_FileDescriptor < 0) return false;
+
+	struct stat FileStat {};
+	if (fstat(m_FileDescriptor, &FileStat) != 0)
+	{
+		Close();
+		return false;
+	}
+	m_Size = (size_t)FileStat.st_size;
+
+	// @important: an empty file can't be mapped, but it is still a valid (empty) file
+	if (m_Size)
+	{
+		void* PtrData{ mmap(nullptr, m_Size, PROT_READ, MAP_PRIVATE, m_FileDescriptor, 0) };
+		if (PtrData == MAP_FAILED)
+		{
+			Close();
+			return false;
+		}
+		m_PtrData = (const uint8_t*)PtrData;
+
+		// Assets are read front to back once
+		madvise(PtrData, m_Size, MADV_SEQUENTIAL);
+	}
+#endif
+
+	m_bIsOpen = true;
+	return true;
+}
+
+void CMappedFile::Close()
+{
+#ifdef _WIN32
+	if (m_PtrData) UnmapViewOfFile(m_PtrData);
+	if (m_MappingHandle) CloseHandle((HANDLE)m_MappingHandle);
+	if (m_FileHandle) CloseHandle((HANDLE)m_FileHandle);
+	m_MappingHandle = nullptr;
+	m_FileHandle = nullptr;
+#else
+	if (m_PtrData) munmap((void*)m_PtrData, m_Size);
+	if (m_FileDescriptor >= 0) close(m_FileDescriptor);
+	m_FileDescriptor = -1;
+#endif
+
+	m_PtrData = nullptr;
+	m_Size = 0;
+	m_bIsOpen = false;
+}
+
+bool CMappedFile::IsOpen() const
+{
+	return m_bIsOpen;
+}
+
+const uint8_t* CMappedFile::GetData() const
+{
+	return m_PtrData;
+}
+
+size_t CMappedFile::GetSize() const
+{
+	return m_Size;
+}
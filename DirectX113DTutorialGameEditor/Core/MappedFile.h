@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+
+// Read-only view of a whole file mapped into memory (Win32 file mapping or POSIX mmap)
+// @important: pages are loaded on first access and can be dropped by the OS at any time,
+// so a mapped file costs no heap memory and is never copied as a whole
+class CMappedFile
+{
+public:
+	CMappedFile() {}
+	~CMappedFile();
+
+	CMappedFile(const CMappedFile&) = delete;
+	CMappedFile& operator=(const CMappedFile&) = delete;
+
+public:
+	bool Open(const std::string& FileName);
+	void Close();
+
+public:
+	bool IsOpen() const;
+	const uint8_t* GetData() const;
+	size_t GetSize() const;
+
+private:
+	const uint8_t*	m_PtrData{};
+	size_t			m_Size{};
+	bool			m_bIsOpen{};
+
+#ifdef _WIN32
+	void*			m_FileHandle{};
+	void*			m_MappingHandle{};
+#else
+	int				m_FileDescriptor{ -1 };
+#endif
+};
@@ -8,6 +8,20 @@ using std::vector;
 using std::string;
 using std::wstring;
 using std::make_unique;
+using std::max;
+
+// GPU side of CTextureRegistry, indexed by registry handle
+struct SRegisteredTexture
+{
+	ComPtr<ID3D11Texture2D>				Texture2D{};
+	ComPtr<ID3D11ShaderResourceView>	ShaderResourceView{};
+};
+
+static vector<SRegisteredTexture>& GetRegisteredTextures()
+{
+	static vector<SRegisteredTexture> s_vRegisteredTextures{};
+	return s_vRegisteredTextures;
+}
 
 bool CTexture::CreateTextureFromFile(const string& FileName, bool bShouldGenerateMipMap)
 {
@@ -123,6 +137,72 @@ void CTexture::CreateTextureFromMemory(const vector<uint8_t>& RawData, bool bSho
 	m_bIsCreated = true;
 }
 
+bool CTexture::CreateSharedTextureFromFile(const string& FileName, bool bShouldGenerateMipMap)
+{
+	ReleaseResources();
+
+	m_FileName = FileName;
+	if (AcquireRegisteredTexture(CTextureRegistry::MakeFileKey(FileName, bShouldGenerateMipMap))) return true;
+
+	if (!CreateTextureFromFile(FileName, bShouldGenerateMipMap))
+	{
+		ReleaseResources(); // @important: drops the reserved handle
+		return false;
+	}
+
+	RegisterTexture();
+	return true;
+}
+
+bool CTexture::CreateSharedTextureFromMemory(const vector<uint8_t>& RawData, bool bShouldGenerateMipMap)
+{
+	ReleaseResources();
+
+	if (RawData.empty()) return false;
+
+	if (AcquireRegisteredTexture(CTextureRegistry::MakeMemoryKey(&RawData[0], RawData.size(), bShouldGenerateMipMap))) return true;
+
+	CreateTextureFromMemory(RawData, bShouldGenerateMipMap);
+	if (!m_bIsCreated)
+	{
+		ReleaseResources(); // @important: drops the reserved handle
+		return false;
+	}
+
+	RegisterTexture();
+	return true;
+}
+
+bool CTexture::AcquireRegisteredTexture(const string& Key)
+{
+	auto& vRegisteredTextures{ GetRegisteredTextures() };
+
+	bool bIsRegistered{ CTextureRegistry::Get().Acquire(Key, m_RegistryHandle) };
+	if (m_RegistryHandle >= vRegisteredTextures.size()) vRegisteredTextures.resize((size_t)m_RegistryHandle + 1);
+	if (!bIsRegistered) return false;
+
+	const SRegisteredTexture& RegisteredTexture{ vRegisteredTextures[m_RegistryHandle] };
+	m_Texture2D = RegisteredTexture.Texture2D;
+	m_ShaderResourceView = RegisteredTexture.ShaderResourceView;
+
+	UpdateTextureInfo();
+
+	m_bIsCreated = true;
+
+	return true;
+}
+
+void CTexture::RegisterTexture()
+{
+	assert(m_RegistryHandle != CTextureRegistry::KInvalidHandle);
+
+	SRegisteredTexture& RegisteredTexture{ GetRegisteredTextures()[m_RegistryHandle] };
+	RegisteredTexture.Texture2D = m_Texture2D;
+	RegisteredTexture.ShaderResourceView = m_ShaderResourceView;
+
+	CTextureRegistry::Get().SetResidentByteCount(m_RegistryHandle, GetResidentByteCount());
+}
+
 void CTexture::CreateBlankTexture(EFormat Format, const XMFLOAT2& TextureSize)
 {
 	m_TextureSize = TextureSize;
@@ -218,6 +298,13 @@ void CTexture::CopyTexture(ID3D11Texture2D* const Texture)
 
 void CTexture::ReleaseResources()
 {
+	if (m_RegistryHandle != CTextureRegistry::KInvalidHandle)
+	{
+		// @important: the last one releases the registered texture
+		if (CTextureRegistry::Get().Release(m_RegistryHandle)) GetRegisteredTextures()[m_RegistryHandle] = SRegisteredTexture{};
+		m_RegistryHandle = CTextureRegistry::KInvalidHandle;
+	}
+
 	m_ShaderResourceView.Reset();
 	m_Texture2D.Reset();
 	m_bIsCreated = false;
@@ -298,6 +385,26 @@ void CTexture::UpdateTextureInfo()
 	m_TextureSize.y = static_cast<float>(m_Texture2DDesc.Height);
 }
 
+uint64_t CTexture::GetResidentByteCount() const
+{
+	if (!m_Texture2D) return 0;
+
+	uint64_t ByteCount{};
+	size_t Width{ m_Texture2DDesc.Width };
+	size_t Height{ m_Texture2DDesc.Height };
+	for (UINT iMipLevel = 0; iMipLevel < m_Texture2DDesc.MipLevels; ++iMipLevel)
+	{
+		size_t RowPitch{};
+		size_t SlicePitch{};
+		if (FAILED(ComputePitch(m_Texture2DDesc.Format, Width, Height, RowPitch, SlicePitch))) break;
+
+		ByteCount += SlicePitch;
+		Width = max(Width / 2, (size_t)1);
+		Height = max(Height / 2, (size_t)1);
+	}
+	return ByteCount * m_Texture2DDesc.ArraySize;
+}
+
 void CTexture::UpdateTextureRawData(const SPixel8Uint* const PtrData)
 {
 	D3D11_MAPPED_SUBRESOURCE MappedSubresource{};
@@ -342,6 +449,29 @@ void CTexture::UpdateTextureRawData(const SPixel32Uint* const PtrData)
 	}
 }
 
+void CTexture::UpdateTextureRawData(const SPixel64Float* const PtrData)
+{
+	D3D11_MAPPED_SUBRESOURCE MappedSubresource{};
+	if (SUCCEEDED(m_PtrDeviceContext->Map(m_Texture2D.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedSubresource)))
+	{
+		size_t SrcRowPixelCount{ (size_t)m_TextureSize.x };
+		size_t SrcRowCount{ (size_t)m_TextureSize.y };
+		uint8_t* PtrDest{ (uint8_t*)MappedSubresource.pData };
+
+		UINT RowCount{ (MappedSubresource.DepthPitch) ?
+			MappedSubresource.DepthPitch / MappedSubresource.RowPitch :
+			static_cast<UINT>(SrcRowCount) };
+		for (UINT iRow = 0; iRow < RowCount; ++iRow)
+		{
+			memcpy(PtrDest + (static_cast<size_t>(iRow) * MappedSubresource.RowPitch),
+				PtrData + (static_cast<size_t>(iRow) * SrcRowPixelCount),
+				SrcRowPixelCount * sizeof(SPixel64Float));
+		}
+
+		m_PtrDeviceContext->Unmap(m_Texture2D.Get(), 0);
+	}
+}
+
 void CTexture::UpdateTextureRawData(const SPixel128Float* const PtrData)
 {
 	D3D11_MAPPED_SUBRESOURCE MappedSubresource{};
@@ -420,7 +550,7 @@ void CMaterialTextureSet::CreateTexture(ETextureType eType, CMaterialData& Mater
 		STextureData& TextureData{ MaterialData.GetTextureData(eType) };
 		if (TextureData.vRawData.empty())
 		{
-			if (!m_Textures[iTexture].CreateTextureFromFile(TextureData.FileName, true))
+			if (!m_Textures[iTexture].CreateSharedTextureFromFile(TextureData.FileName, true))
 			{
 				// @important: failed to load texture
 
@@ -430,7 +560,8 @@ void CMaterialTextureSet::CreateTexture(ETextureType eType, CMaterialData& Mater
 		}
 		else
 		{
-			m_Textures[iTexture].CreateTextureFromMemory(TextureData.vRawData, true);
+			// @important: embedded textures are keyed by the hash of their data, so identical ones are decoded only once
+			m_Textures[iTexture].CreateSharedTextureFromMemory(TextureData.vRawData, true);
 			TextureData.vRawData.clear(); // @important
 		}
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SharedHeader.h"
+#include "TextureRegistry.h"
 
 struct SPixel8Uint
 {
@@ -15,6 +16,14 @@ struct SPixel32Uint
 	uint8_t A{};
 };
 
+struct alignas(2) SPixel64Float
+{
+	uint16_t R{}; // half
+	uint16_t G{}; // half
+	uint16_t B{}; // half
+	uint16_t A{}; // half
+};
+
 struct alignas(4) SPixel128Float
 {
 	float R{};
@@ -146,11 +155,20 @@ public:
 		assert(m_PtrDevice);
 		assert(m_PtrDeviceContext);
 	}
-	~CTexture() {}
+	~CTexture() { ReleaseResources(); }
+
+	// @important: a copy would release the shared texture twice
+	CTexture(const CTexture&) = delete;
+	CTexture& operator=(const CTexture&) = delete;
 
 public:
 	bool CreateTextureFromFile(const std::string& FileName, bool bShouldGenerateMipMap);
 	void CreateTextureFromMemory(const std::vector<uint8_t>& RawData, bool bShouldGenerateMipMap);
+
+	// Shares the texture with every other CTexture created from the same file or the same data (see CTextureRegistry)
+	// @important: shared textures must not be written to
+	bool CreateSharedTextureFromFile(const std::string& FileName, bool bShouldGenerateMipMap);
+	bool CreateSharedTextureFromMemory(const std::vector<uint8_t>& RawData, bool bShouldGenerateMipMap);
 	void CreateBlankTexture(EFormat Format, const XMFLOAT2& TextureSize);
 	
 	// No mipmap auto generation.
@@ -166,10 +184,14 @@ public:
 
 private:
 	void UpdateTextureInfo();
+	// Returns true if the texture was registered, otherwise m_RegistryHandle is reserved for RegisterTexture()
+	bool AcquireRegisteredTexture(const std::string& Key);
+	void RegisterTexture();
 
 public:
 	void UpdateTextureRawData(const SPixel8Uint* const PtrData);
 	void UpdateTextureRawData(const SPixel32Uint* const PtrData);
+	void UpdateTextureRawData(const SPixel64Float* const PtrData);
 	void UpdateTextureRawData(const SPixel128Float* const PtrData);
 	void SetSlot(UINT Slot);
 	void SetShaderType(EShaderType eShaderType);
@@ -184,6 +206,10 @@ public:
 	ID3D11Texture2D* GetTexture2DPtr() const { return (m_Texture2D) ? m_Texture2D.Get() : nullptr; }
 	ID3D11ShaderResourceView* GetShaderResourceViewPtr() { return (m_ShaderResourceView) ? m_ShaderResourceView.Get() : nullptr; }
 	uint32_t GetMipLevels() const { return m_Texture2DDesc.MipLevels; }
+	bool IsShared() const { return (m_RegistryHandle != CTextureRegistry::KInvalidHandle); }
+	uint32_t GetRegistryHandle() const { return m_RegistryHandle; }
+	// Including every mip level
+	uint64_t GetResidentByteCount() const;
 
 private:
 	ID3D11Device* const					m_PtrDevice{};
@@ -197,6 +223,7 @@ private:
 	bool								m_bIsCreated{ false };
 	bool								m_bIssRGB{ false };
 	bool								m_bIsHDR{ false };
+	uint32_t							m_RegistryHandle{ CTextureRegistry::KInvalidHandle };
 
 private:
 	ComPtr<ID3D11Texture2D>				m_Texture2D{};
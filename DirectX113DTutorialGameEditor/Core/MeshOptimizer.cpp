@@ -0,0 +1,422 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+using namespace DirectX;
+using std::max;
+using std::min;
+using std::vector;
+
+// Tom Forsyth, "Linear-Speed Vertex Cache Optimisation"
+static constexpr float KCacheDecayPower{ 1.5f };
+static constexpr float KLastTriangleScore{ 0.75f };
+static constexpr float KValenceBoostScale{ 2.0f };
+static constexpr float KValenceBoostPower{ 0.5f };
+
+void CMeshOptimizer::OptimizeVertexCache(vector<uint32_t>& vIndices, uint32_t VertexCount)
+{
+	assert(vIndices.size() % 3 == 0);
+
+	const uint32_t KTriangleCount{ (uint32_t)(vIndices.size() / 3) };
+	if (KTriangleCount == 0) return;
+
+	vector<uint32_t> vTriangleOffsets{};
+	vector<uint32_t> vTriangles{};
+	BuildAdjacency(vIndices, VertexCount, vTriangleOffsets, vTriangles);
+
+	// @important: the adjacent triangles that are not emitted yet are kept at the front of each vertex's range
+	vector<uint32_t> vRemainingTriangleCounts(VertexCount);
+	vector<int32_t> vCachePositions(VertexCount, -1);
+	vector<float> vVertexScores(VertexCount);
+	for (uint32_t iVertex = 0; iVertex < VertexCount; ++iVertex)
+	{
+		vRemainingTriangleCounts[iVertex] = vTriangleOffsets[iVertex + 1] - vTriangleOffsets[iVertex];
+		vVertexScores[iVertex] = GetVertexScore(-1, vRemainingTriangleCounts[iVertex]);
+	}
+
+	vector<float> vTriangleScores(KTriangleCount);
+	vector<bool> vIsEmitted(KTriangleCount);
+	uint32_t BestTriangle{};
+	for (uint32_t iTriangle = 0; iTriangle < KTriangleCount; ++iTriangle)
+	{
+		const uint32_t* const PtrTriangle{ &vIndices[iTriangle * 3] };
+		vTriangleScores[iTriangle] = vVertexScores[PtrTriangle[0]] + vVertexScores[PtrTriangle[1]] + vVertexScores[PtrTriangle[2]];
+		if (vTriangleScores[iTriangle] > vTriangleScores[BestTriangle]) BestTriangle = iTriangle;
+	}
+
+	vector<uint32_t> vOptimizedIndices{};
+	vOptimizedIndices.reserve(vIndices.size());
+
+	// LRU, the 3 extra entries hold the vertices that are pushed out by the last triangle
+	uint32_t Cache[KCacheSize + 3]{};
+	uint32_t NewCache[KCacheSize + 3]{};
+	uint32_t CacheCount{};
+	uint32_t NextUnemittedTriangle{};
+	while (BestTriangle != UINT32_MAX)
+	{
+		const uint32_t* const PtrTriangle{ &vIndices[BestTriangle * 3] };
+		vOptimizedIndices.insert(vOptimizedIndices.end(), PtrTriangle, PtrTriangle + 3);
+		vIsEmitted[BestTriangle] = true;
+
+		uint32_t NewCacheCount{};
+		for (uint32_t iCorner = 0; iCorner < 3; ++iCorner)
+		{
+			const uint32_t KVertex{ PtrTriangle[iCorner] };
+			NewCache[NewCacheCount++] = KVertex;
+
+			uint32_t* const PtrAdjacency{ &vTriangles[vTriangleOffsets[KVertex]] };
+			uint32_t& RemainingTriangleCount{ vRemainingTriangleCounts[KVertex] };
+			for (uint32_t iAdjacent = 0; iAdjacent < RemainingTriangleCount; ++iAdjacent)
+			{
+				if (PtrAdjacency[iAdjacent] == BestTriangle)
+				{
+					std::swap(PtrAdjacency[iAdjacent], PtrAdjacency[RemainingTriangleCount - 1]);
+					--RemainingTriangleCount;
+					break;
+				}
+			}
+		}
+		for (uint32_t iCache = 0; iCache < CacheCount; ++iCache)
+		{
+			const uint32_t KVertex{ Cache[iCache] };
+			if (KVertex != PtrTriangle[0] && KVertex != PtrTriangle[1] && KVertex != PtrTriangle[2])
+			{
+				NewCache[NewCacheCount++] = KVertex;
+			}
+		}
+
+		// @important: the scores of the pushed out vertices are updated as well, since they've lost their cache bonus
+		for (uint32_t iCache = 0; iCache < NewCacheCount; ++iCache)
+		{
+			const uint32_t KVertex{ NewCache[iCache] };
+			vCachePositions[KVertex] = (iCache < KCacheSize) ? (int32_t)iCache : -1;
+			vVertexScores[KVertex] = GetVertexScore(vCachePositions[KVertex], vRemainingTriangleCounts[KVertex]);
+		}
+		CacheCount = min(NewCacheCount, KCacheSize);
+		std::copy(NewCache, NewCache + CacheCount, Cache);
+
+		// The next triangle is the best one that uses any of the updated vertices
+		BestTriangle = UINT32_MAX;
+		float BestScore{ -1.0f };
+		for (uint32_t iCache = 0; iCache < NewCacheCount; ++iCache)
+		{
+			const uint32_t KVertex{ NewCache[iCache] };
+			const uint32_t* const PtrAdjacency{ &vTriangles[vTriangleOffsets[KVertex]] };
+			for (uint32_t iAdjacent = 0; iAdjacent < vRemainingTriangleCounts[KVertex]; ++iAdjacent)
+			{
+				const uint32_t KTriangle{ PtrAdjacency[iAdjacent] };
+				const uint32_t* const PtrAdjacentTriangle{ &vIndices[KTriangle * 3] };
+				float& Score{ vTriangleScores[KTriangle] };
+				Score = vVertexScores[PtrAdjacentTriangle[0]] + vVertexScores[PtrAdjacentTriangle[1]] + vVertexScores[PtrAdjacentTriangle[2]];
+				if (Score > BestScore)
+				{
+					BestScore = Score;
+					BestTriangle = KTriangle;
+				}
+			}
+		}
+
+		// @important: a dead end (nothing in the cache is used anymore) continues from the first triangle not emitted yet,
+		// instead of searching all of them for the best score, which keeps it linear
+		if (BestTriangle == UINT32_MAX)
+		{
+			while (NextUnemittedTriangle < KTriangleCount && vIsEmitted[NextUnemittedTriangle]) ++NextUnemittedTriangle;
+			if (NextUnemittedTriangle < KTriangleCount) BestTriangle = NextUnemittedTriangle;
+		}
+	}
+
+	assert(vOptimizedIndices.size() == vIndices.size());
+	vIndices.swap(vOptimizedIndices);
+}
+
+void CMeshOptimizer::OptimizeOverdraw(vector<uint32_t>& vIndices, const vector<XMFLOAT3>& vPositions, float Threshold)
+{
+	assert(vIndices.size() % 3 == 0);
+
+	const uint32_t KTriangleCount{ (uint32_t)(vIndices.size() / 3) };
+	if (KTriangleCount == 0) return;
+
+	// FIFO cache of KAnalysisCacheSize entries: a vertex is cached if it was transformed less than KAnalysisCacheSize misses ago
+	vector<uint32_t> vCacheTimestamps(vPositions.size());
+	uint32_t Timestamp{ KAnalysisCacheSize + 1 };
+	auto GetMissCount{ [&](uint32_t iTriangle)
+		{
+			uint32_t MissCount{};
+			for (uint32_t iCorner = 0; iCorner < 3; ++iCorner)
+			{
+				const uint32_t KVertex{ vIndices[iTriangle * 3 + iCorner] };
+				if (Timestamp - vCacheTimestamps[KVertex] > KAnalysisCacheSize)
+				{
+					vCacheTimestamps[KVertex] = Timestamp++;
+					++MissCount;
+				}
+			}
+			return MissCount;
+		}
+	};
+	auto ResetCache{ [&]() { Timestamp += KAnalysisCacheSize + 1; } };
+
+	// Hard boundaries: triangles whose vertices all miss the cache, where splitting costs nothing
+	vector<uint32_t> vHardClusterOffsets{};
+	for (uint32_t iTriangle = 0; iTriangle < KTriangleCount; ++iTriangle)
+	{
+		if (GetMissCount(iTriangle) == 3) vHardClusterOffsets.emplace_back(iTriangle);
+	}
+	if (vHardClusterOffsets.empty() || vHardClusterOffsets[0] != 0) vHardClusterOffsets.insert(vHardClusterOffsets.begin(), 0);
+	vHardClusterOffsets.emplace_back(KTriangleCount);
+
+	// Soft boundaries: a hard cluster is split again wherever the ACMR so far is within Threshold of the cluster's
+	vector<uint32_t> vClusterOffsets{};
+	for (size_t iHardCluster = 0; iHardCluster + 1 < vHardClusterOffsets.size(); ++iHardCluster)
+	{
+		const uint32_t KBegin{ vHardClusterOffsets[iHardCluster] };
+		const uint32_t KEnd{ vHardClusterOffsets[iHardCluster + 1] };
+
+		ResetCache();
+		uint32_t ClusterMissCount{};
+		for (uint32_t iTriangle = KBegin; iTriangle < KEnd; ++iTriangle) ClusterMissCount += GetMissCount(iTriangle);
+		const float KClusterThreshold{ Threshold * (float)ClusterMissCount / (float)(KEnd - KBegin) };
+
+		vClusterOffsets.emplace_back(KBegin);
+		ResetCache();
+		uint32_t RunningMissCount{};
+		uint32_t RunningTriangleCount{};
+		for (uint32_t iTriangle = KBegin; iTriangle < KEnd; ++iTriangle)
+		{
+			RunningMissCount += GetMissCount(iTriangle);
+			++RunningTriangleCount;
+			if (iTriangle + 1 < KEnd && (float)RunningMissCount / (float)RunningTriangleCount <= KClusterThreshold)
+			{
+				vClusterOffsets.emplace_back(iTriangle + 1);
+				ResetCache();
+				RunningMissCount = 0;
+				RunningTriangleCount = 0;
+			}
+		}
+	}
+	vClusterOffsets.emplace_back(KTriangleCount);
+	const uint32_t KClusterCount{ (uint32_t)vClusterOffsets.size() - 1 };
+
+	// Area-weighted centroid and normal of each cluster
+	vector<XMFLOAT3> vClusterCentroids(KClusterCount);
+	vector<XMFLOAT3> vClusterNormals(KClusterCount);
+	XMVECTOR MeshCentroid{};
+	float MeshArea{};
+	for (uint32_t iCluster = 0; iCluster < KClusterCount; ++iCluster)
+	{
+		XMVECTOR Centroid{};
+		XMVECTOR Normal{};
+		float Area{};
+		for (uint32_t iTriangle = vClusterOffsets[iCluster]; iTriangle < vClusterOffsets[iCluster + 1]; ++iTriangle)
+		{
+			XMVECTOR P0{ XMLoadFloat3(&vPositions[vIndices[iTriangle * 3 + 0]]) };
+			XMVECTOR P1{ XMLoadFloat3(&vPositions[vIndices[iTriangle * 3 + 1]]) };
+			XMVECTOR P2{ XMLoadFloat3(&vPositions[vIndices[iTriangle * 3 + 2]]) };
+			XMVECTOR Cross{ XMVector3Cross(P1 - P0, P2 - P0) }; // length: twice the area
+			float TriangleArea{ XMVectorGetX(XMVector3Length(Cross)) * 0.5f };
+
+			Centroid = Centroid + (P0 + P1 + P2) * (TriangleArea / 3.0f);
+			Normal = Normal + Cross;
+			Area += TriangleArea;
+		}
+		MeshCentroid = MeshCentroid + Centroid;
+		MeshArea += Area;
+
+		XMStoreFloat3(&vClusterCentroids[iCluster], (Area > 0.0f) ? Centroid / Area : Centroid);
+		XMStoreFloat3(&vClusterNormals[iCluster], XMVector3Normalize(Normal));
+	}
+	if (MeshArea > 0.0f) MeshCentroid = MeshCentroid / MeshArea;
+
+	// @important: clusters facing away from the center are drawn first, since they are the most likely to occlude the rest
+	vector<float> vClusterSortKeys(KClusterCount);
+	vector<uint32_t> vSortedClusters(KClusterCount);
+	for (uint32_t iCluster = 0; iCluster < KClusterCount; ++iCluster)
+	{
+		XMVECTOR Normal{ XMLoadFloat3(&vClusterNormals[iCluster]) };
+		XMVECTOR Centroid{ XMLoadFloat3(&vClusterCentroids[iCluster]) };
+		vClusterSortKeys[iCluster] = XMVectorGetX(XMVector3Dot(Centroid - MeshCentroid, Normal));
+		vSortedClusters[iCluster] = iCluster;
+	}
+	std::stable_sort(vSortedClusters.begin(), vSortedClusters.end(),
+		[&](uint32_t A, uint32_t B) { return vClusterSortKeys[A] > vClusterSortKeys[B]; });
+
+	vector<uint32_t> vOptimizedIndices{};
+	vOptimizedIndices.reserve(vIndices.size());
+	for (uint32_t iCluster : vSortedClusters)
+	{
+		vOptimizedIndices.insert(vOptimizedIndices.end(),
+			vIndices.begin() + vClusterOffsets[iCluster] * 3, vIndices.begin() + vClusterOffsets[iCluster + 1] * 3);
+	}
+	vIndices.swap(vOptimizedIndices);
+}
+
+void CMeshOptimizer::OptimizeVertexFetch(vector<uint32_t>& vIndices, uint32_t VertexCount, vector<uint32_t>& vOutRemap)
+{
+	vOutRemap.assign(VertexCount, UINT32_MAX);
+
+	uint32_t NextVertex{};
+	for (uint32_t& Index : vIndices)
+	{
+		assert(Index < VertexCount);
+		if (vOutRemap[Index] == UINT32_MAX) vOutRemap[Index] = NextVertex++;
+		Index = vOutRemap[Index];
+	}
+	for (uint32_t& Remap : vOutRemap)
+	{
+		if (Remap == UINT32_MAX) Remap = NextVertex++;
+	}
+	assert(NextVertex == VertexCount);
+}
+
+SVertexCacheStatistics CMeshOptimizer::AnalyzeVertexCache(const vector<uint32_t>& vIndices, uint32_t VertexCount, uint32_t CacheSize)
+{
+	assert(vIndices.size() % 3 == 0);
+	assert(CacheSize);
+
+	SVertexCacheStatistics Statistics{};
+	Statistics.TriangleCount = (uint32_t)(vIndices.size() / 3);
+
+	vector<uint32_t> vCacheTimestamps(VertexCount);
+	vector<bool> vIsReferenced(VertexCount);
+	uint32_t Timestamp{ CacheSize + 1 };
+	for (uint32_t Index : vIndices)
+	{
+		assert(Index < VertexCount);
+		if (Timestamp - vCacheTimestamps[Index] > CacheSize)
+		{
+			vCacheTimestamps[Index] = Timestamp++;
+			++Statistics.TransformedVertexCount;
+		}
+		if (!vIsReferenced[Index])
+		{
+			vIsReferenced[Index] = true;
+			++Statistics.VertexCount;
+		}
+	}
+
+	AccumulateStatistics(Statistics, SVertexCacheStatistics());
+	return Statistics;
+}
+
+void CMeshOptimizer::AccumulateStatistics(SVertexCacheStatistics& Sum, const SVertexCacheStatistics& Other)
+{
+	Sum.TriangleCount += Other.TriangleCount;
+	Sum.VertexCount += Other.VertexCount;
+	Sum.TransformedVertexCount += Other.TransformedVertexCount;
+	Sum.ACMR = (Sum.TriangleCount) ? (float)Sum.TransformedVertexCount / (float)Sum.TriangleCount : 0.0f;
+	Sum.ATVR = (Sum.VertexCount) ? (float)Sum.TransformedVertexCount / (float)Sum.VertexCount : 0.0f;
+}
+
+double CMeshOptimizer::MeasureOptimizeTime(uint32_t GridSize, uint32_t IterationCount, SMeshOptimizationStatistics* const PtrOutStatistics)
+{
+	if (GridSize < 2 || IterationCount == 0) return 0.0;
+
+	// @important: fixed seed (xorshift), so that the results are comparable between runs
+	uint64_t State{ 0x9E3779B97F4A7C15 };
+	auto Random{ [&State]()
+		{
+			State ^= State << 13;
+			State ^= State >> 7;
+			State ^= State << 17;
+			return State;
+		}
+	};
+
+	vector<XMFLOAT3> vPositions{};
+	for (uint32_t iZ = 0; iZ < GridSize; ++iZ)
+	{
+		for (uint32_t iX = 0; iX < GridSize; ++iX)
+		{
+			vPositions.emplace_back((float)iX, 0.0f, (float)iZ);
+		}
+	}
+	vector<uint32_t> vIndices{};
+	for (uint32_t iZ = 0; iZ + 1 < GridSize; ++iZ)
+	{
+		for (uint32_t iX = 0; iX + 1 < GridSize; ++iX)
+		{
+			uint32_t I{ iZ * GridSize + iX };
+			vIndices.insert(vIndices.end(), { I, I + GridSize, I + 1, I + 1, I + GridSize, I + GridSize + 1 });
+		}
+	}
+
+	// Worst case of a source: the triangles in no particular order
+	const uint32_t KTriangleCount{ (uint32_t)(vIndices.size() / 3) };
+	for (uint32_t iTriangle = KTriangleCount - 1; iTriangle > 0; --iTriangle)
+	{
+		uint32_t iOther{ (uint32_t)(Random() % (iTriangle + 1)) };
+		std::swap_ranges(vIndices.begin() + iTriangle * 3, vIndices.begin() + iTriangle * 3 + 3, vIndices.begin() + iOther * 3);
+	}
+
+	const uint32_t KVertexCount{ (uint32_t)vPositions.size() };
+	vector<uint32_t> vOptimizedIndices{};
+	vector<uint32_t> vRemap{};
+	double TotalMicroseconds{};
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
+	{
+		vOptimizedIndices = vIndices;
+
+		auto StartTimePoint{ std::chrono::steady_clock::now() };
+		OptimizeVertexCache(vOptimizedIndices, KVertexCount);
+		OptimizeOverdraw(vOptimizedIndices, vPositions);
+		OptimizeVertexFetch(vOptimizedIndices, KVertexCount, vRemap);
+		TotalMicroseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - StartTimePoint).count();
+	}
+
+	if (PtrOutStatistics)
+	{
+		PtrOutStatistics->Before = AnalyzeVertexCache(vIndices, KVertexCount);
+		PtrOutStatistics->After = AnalyzeVertexCache(vOptimizedIndices, KVertexCount);
+	}
+
+	return TotalMicroseconds / IterationCount;
+}
+
+void CMeshOptimizer::BuildAdjacency(const vector<uint32_t>& vIndices, uint32_t VertexCount,
+	vector<uint32_t>& vOutTriangleOffsets, vector<uint32_t>& vOutTriangles)
+{
+	vOutTriangleOffsets.assign(VertexCount + 1, 0);
+	for (uint32_t Index : vIndices)
+	{
+		assert(Index < VertexCount);
+		++vOutTriangleOffsets[Index + 1];
+	}
+	for (uint32_t iVertex = 0; iVertex < VertexCount; ++iVertex)
+	{
+		vOutTriangleOffsets[iVertex + 1] += vOutTriangleOffsets[iVertex];
+	}
+
+	vOutTriangles.resize(vIndices.size());
+	vector<uint32_t> vFillCounts(VertexCount);
+	for (size_t iIndex = 0; iIndex < vIndices.size(); ++iIndex)
+	{
+		const uint32_t KVertex{ vIndices[iIndex] };
+		vOutTriangles[vOutTriangleOffsets[KVertex] + vFillCounts[KVertex]++] = (uint32_t)(iIndex / 3);
+	}
+}
+
+float CMeshOptimizer::GetVertexScore(int32_t CachePosition, uint32_t RemainingTriangleCount)
+{
+	// @important: a vertex that isn't used by any triangle left mustn't attract anything
+	if (RemainingTriangleCount == 0) return -1.0f;
+
+	float Score{};
+	if (CachePosition >= 0)
+	{
+		// The vertices of the last triangle get a fixed score, so that it isn't (almost) repeated
+		if (CachePosition < 3)
+		{
+			Score = KLastTriangleScore;
+		}
+		else
+		{
+			float Scale{ 1.0f - (float)(CachePosition - 3) / (float)(KCacheSize - 3) };
+			Score = powf(Scale, KCacheDecayPower);
+		}
+	}
+
+	// Vertices with few triangles left are boosted, so that they are finished instead of left behind
+	Score += KValenceBoostScale * powf((float)RemainingTriangleCount, -KValenceBoostPower);
+	return Score;
+}
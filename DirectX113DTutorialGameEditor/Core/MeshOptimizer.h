@@ -0,0 +1,68 @@
+#pragma once
+
+// @important: pure CPU (DirectXMath only), so that it doesn't depend on any device
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <DirectXMath.h>
+
+// Post-transform vertex cache efficiency of an index list, simulated with a FIFO cache
+struct SVertexCacheStatistics
+{
+	uint32_t	TriangleCount{};
+	uint32_t	VertexCount{}; // referenced by the indices
+	uint32_t	TransformedVertexCount{}; // cache misses
+	float		ACMR{}; // average cache miss ratio: transformed vertices per triangle (0.5 at best, 3 at worst)
+	float		ATVR{}; // average transformed vertex ratio: transformed vertices per vertex (1 at best)
+};
+
+struct SMeshOptimizationStatistics
+{
+	SVertexCacheStatistics	Before{};
+	SVertexCacheStatistics	After{};
+};
+
+// Import-time reordering of indexed triangle lists for the GPU:
+// 1) OptimizeVertexCache() orders the triangles so that their vertices are still in the post-transform cache (Tom Forsyth's scoring)
+// 2) OptimizeOverdraw() splits that order into clusters and draws the outward-facing ones first, at the cost of a bounded ACMR loss
+// 3) OptimizeVertexFetch() renumbers the vertices in the order they are first used, so that vertex fetches are sequential
+// Only the order changes, the triangles themselves (and their winding) are kept
+class CMeshOptimizer
+{
+public:
+	CMeshOptimizer() {}
+	~CMeshOptimizer() {}
+
+public:
+	// Indices: 3 per triangle
+	static void OptimizeVertexCache(std::vector<uint32_t>& vIndices, uint32_t VertexCount);
+
+	// Expects indices optimized by OptimizeVertexCache()
+	// Threshold: how much worse than its cluster's ACMR a split can make it (1.05 = 5%)
+	static void OptimizeOverdraw(std::vector<uint32_t>& vIndices, const std::vector<DirectX::XMFLOAT3>& vPositions,
+		float Threshold = KDefaultOverdrawThreshold);
+
+	// vOutRemap[old vertex] = new vertex, unreferenced vertices are moved to the end (the vertex count is kept)
+	static void OptimizeVertexFetch(std::vector<uint32_t>& vIndices, uint32_t VertexCount, std::vector<uint32_t>& vOutRemap);
+
+	static SVertexCacheStatistics AnalyzeVertexCache(const std::vector<uint32_t>& vIndices, uint32_t VertexCount,
+		uint32_t CacheSize = KAnalysisCacheSize);
+	// Sums the counts of Other into Sum, so that the ratios of several meshes are weighted by their size
+	static void AccumulateStatistics(SVertexCacheStatistics& Sum, const SVertexCacheStatistics& Other);
+
+public:
+	// Optimizes a GridSize x GridSize grid whose triangles are shuffled IterationCount times
+	// and returns the average time in microseconds
+	static double MeasureOptimizeTime(uint32_t GridSize, uint32_t IterationCount, SMeshOptimizationStatistics* const PtrOutStatistics = nullptr);
+
+public:
+	static constexpr uint32_t KCacheSize{ 32 }; // modeled by OptimizeVertexCache() (LRU)
+	static constexpr uint32_t KAnalysisCacheSize{ 16 }; // FIFO, a conservative guess of the hardware
+	static constexpr float KDefaultOverdrawThreshold{ 1.05f };
+
+private:
+	// Vertex to triangle adjacency (CSR)
+	static void BuildAdjacency(const std::vector<uint32_t>& vIndices, uint32_t VertexCount,
+		std::vector<uint32_t>& vOutTriangleOffsets, std::vector<uint32_t>& vOutTriangles);
+	static float GetVertexScore(int32_t CachePosition, uint32_t RemainingTriangleCount);
+};
@@ -0,0 +1,361 @@
+#include "MeshSimplifier.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <unordered_map>
+
+using namespace DirectX;
+using std::max;
+using std::min;
+using std::vector;
+
+void CMeshSimplifier::SetMesh(const vector<XMFLOAT3>& vPositions, const vector<uint32_t>& vIndices,
+	const vector<uint32_t>* const PtrVertexGroups)
+{
+	assert(vIndices.size() % 3 == 0);
+	assert(!PtrVertexGroups || PtrVertexGroups->size() == vPositions.size());
+
+	const uint32_t KVertexCount{ (uint32_t)vPositions.size() };
+	m_vPositions = vPositions;
+	m_vIndices = vIndices;
+	m_vVertexGroups = (PtrVertexGroups) ? *PtrVertexGroups : vector<uint32_t>(KVertexCount);
+	m_Error = 0;
+
+	// Quadrics of the planes of the adjacent triangles (area-weighted)
+	m_vQuadrics.assign(KVertexCount, SQuadric());
+	for (size_t iIndex = 0; iIndex < m_vIndices.size(); iIndex += 3)
+	{
+		XMVECTOR P0{ XMLoadFloat3(&m_vPositions[m_vIndices[iIndex + 0]]) };
+		XMVECTOR P1{ XMLoadFloat3(&m_vPositions[m_vIndices[iIndex + 1]]) };
+		XMVECTOR P2{ XMLoadFloat3(&m_vPositions[m_vIndices[iIndex + 2]]) };
+		XMVECTOR Cross{ XMVector3Cross(P1 - P0, P2 - P0) };
+		float DoubleArea{ XMVectorGetX(XMVector3Length(Cross)) };
+		if (DoubleArea <= 0.0f) continue;
+
+		XMVECTOR Normal{ Cross / DoubleArea };
+		double D{ -(double)XMVectorGetX(XMVector3Dot(Normal, P0)) };
+		for (uint32_t iCorner = 0; iCorner < 3; ++iCorner)
+		{
+			AddPlane(m_vQuadrics[m_vIndices[iIndex + iCorner]], Normal, D, DoubleArea * 0.5);
+		}
+	}
+
+	// @important: an edge used by only one triangle is open (a border or a seam between split vertices)
+	std::unordered_map<uint64_t, uint32_t> umapEdgeUseCounts{};
+	umapEdgeUseCounts.reserve(m_vIndices.size());
+	for (size_t iIndex = 0; iIndex < m_vIndices.size(); iIndex += 3)
+	{
+		for (uint32_t iCorner = 0; iCorner < 3; ++iCorner)
+		{
+			uint32_t A{ m_vIndices[iIndex + iCorner] };
+			uint32_t B{ m_vIndices[iIndex + (iCorner + 1) % 3] };
+			++umapEdgeUseCounts[((uint64_t)min(A, B) << 32) | max(A, B)];
+		}
+	}
+	m_vIsLocked.assign(KVertexCount, false);
+	for (const auto& EdgeUseCount : umapEdgeUseCounts)
+	{
+		if (EdgeUseCount.second != 1) continue;
+
+		m_vIsLocked[(uint32_t)(EdgeUseCount.first >> 32)] = true;
+		m_vIsLocked[(uint32_t)(EdgeUseCount.first & 0xFFFFFFFF)] = true;
+	}
+}
+
+uint32_t CMeshSimplifier::Simplify(uint32_t TargetTriangleCount, float MaxError)
+{
+	const uint32_t KVertexCount{ (uint32_t)m_vPositions.size() };
+	const float KMaxCost{ MaxError * MaxError };
+
+	m_vRemap.resize(KVertexCount);
+	while (GetTriangleCount() > TargetTriangleCount)
+	{
+		BuildAdjacency();
+
+		// Every half edge of every triangle is a candidate
+		m_vCollapses.clear();
+		for (size_t iIndex = 0; iIndex < m_vIndices.size(); iIndex += 3)
+		{
+			for (uint32_t iCorner = 0; iCorner < 3; ++iCorner)
+			{
+				uint32_t A{ m_vIndices[iIndex + iCorner] };
+				uint32_t B{ m_vIndices[iIndex + (iCorner + 1) % 3] };
+				if (m_vVertexGroups[A] != m_vVertexGroups[B]) continue;
+
+				if (!m_vIsLocked[A])
+				{
+					float Cost{ GetCost(A, B) };
+					if (Cost <= KMaxCost) m_vCollapses.emplace_back(SCollapse{ A, B, Cost });
+				}
+				if (!m_vIsLocked[B])
+				{
+					float Cost{ GetCost(B, A) };
+					if (Cost <= KMaxCost) m_vCollapses.emplace_back(SCollapse{ B, A, Cost });
+				}
+			}
+		}
+		if (m_vCollapses.empty()) break;
+
+		std::sort(m_vCollapses.begin(), m_vCollapses.end(), [](const SCollapse& A, const SCollapse& B) { return A.Cost < B.Cost; });
+
+		// @important: the cheapest collapses that don't share any triangle are done in one pass,
+		// so that the costs and the validity checks of this pass stay correct
+		for (uint32_t iVertex = 0; iVertex < KVertexCount; ++iVertex) m_vRemap[iVertex] = iVertex;
+		m_vIsTouched.assign(KVertexCount, false);
+
+		uint32_t RemainingTriangleCount{ GetTriangleCount() };
+		uint32_t CollapseCount{};
+		for (const SCollapse& Collapse : m_vCollapses)
+		{
+			if (RemainingTriangleCount <= TargetTriangleCount) break;
+			if (m_vIsTouched[Collapse.From] || m_vIsTouched[Collapse.To]) continue;
+			if (!IsValidCollapse(Collapse.From, Collapse.To)) continue;
+
+			// @important: both one-rings are touched, as the adjacency isn't updated until the end of the pass
+			uint32_t RemovedTriangleCount{};
+			for (uint32_t iAdjacent = m_vTriangleOffsets[Collapse.From]; iAdjacent < m_vTriangleOffsets[Collapse.From + 1]; ++iAdjacent)
+			{
+				const uint32_t* const Triangle{ &m_vIndices[m_vTriangles[iAdjacent] * 3] };
+				for (uint32_t iCorner = 0; iCorner < 3; ++iCorner)
+				{
+					m_vIsTouched[Triangle[iCorner]] = true;
+					if (Triangle[iCorner] == Collapse.To) ++RemovedTriangleCount;
+				}
+			}
+			for (uint32_t iAdjacent = m_vTriangleOffsets[Collapse.To]; iAdjacent < m_vTriangleOffsets[Collapse.To + 1]; ++iAdjacent)
+			{
+				const uint32_t* const Triangle{ &m_vIndices[m_vTriangles[iAdjacent] * 3] };
+				for (uint32_t iCorner = 0; iCorner < 3; ++iCorner) m_vIsTouched[Triangle[iCorner]] = true;
+			}
+
+			m_vRemap[Collapse.From] = Collapse.To;
+			AddQuadric(m_vQuadrics[Collapse.To], m_vQuadrics[Collapse.From]);
+			m_Error = max(m_Error, sqrtf(Collapse.Cost));
+			RemainingTriangleCount -= min(RemovedTriangleCount, RemainingTriangleCount);
+			++CollapseCount;
+		}
+		if (CollapseCount == 0) break;
+
+		// Remap and remove the degenerate triangles
+		size_t IndexCount{};
+		for (size_t iIndex = 0; iIndex < m_vIndices.size(); iIndex += 3)
+		{
+			uint32_t I0{ m_vRemap[m_vIndices[iIndex + 0]] };
+			uint32_t I1{ m_vRemap[m_vIndices[iIndex + 1]] };
+			uint32_t I2{ m_vRemap[m_vIndices[iIndex + 2]] };
+			if (I0 == I1 || I1 == I2 || I2 == I0) continue;
+
+			m_vIndices[IndexCount++] = I0;
+			m_vIndices[IndexCount++] = I1;
+			m_vIndices[IndexCount++] = I2;
+		}
+		m_vIndices.resize(IndexCount);
+	}
+
+	return GetTriangleCount();
+}
+
+void CMeshSimplifier::BuildAdjacency()
+{
+	const uint32_t KVertexCount{ (uint32_t)m_vPositions.size() };
+
+	m_vTriangleOffsets.assign(KVertexCount + 1, 0);
+	for (uint32_t Index : m_vIndices) ++m_vTriangleOffsets[Index + 1];
+	for (uint32_t iVertex = 0; iVertex < KVertexCount; ++iVertex) m_vTriangleOffsets[iVertex + 1] += m_vTriangleOffsets[iVertex];
+
+	m_vTriangles.resize(m_vIndices.size());
+	m_vScratchA.assign(m_vTriangleOffsets.begin(), m_vTriangleOffsets.end() - 1);
+	for (size_t iIndex = 0; iIndex < m_vIndices.size(); ++iIndex)
+	{
+		m_vTriangles[m_vScratchA[m_vIndices[iIndex]]++] = (uint32_t)(iIndex / 3);
+	}
+}
+
+float CMeshSimplifier::GetCost(uint32_t From, uint32_t To) const
+{
+	const SQuadric& Quadric{ m_vQuadrics[From] };
+	if (Quadric.Weight <= 0.0) return 0.0f;
+
+	// @important: normalized by the area, so that the cost is a squared distance
+	return (float)max(EvaluateQuadric(Quadric, m_vPositions[To]) / Quadric.Weight, 0.0);
+}
+
+bool CMeshSimplifier::IsValidCollapse(uint32_t From, uint32_t To)
+{
+	const XMVECTOR KTo{ XMLoadFloat3(&m_vPositions[To]) };
+
+	// Flips
+	uint32_t SharedTriangleCount{};
+	for (uint32_t iAdjacent = m_vTriangleOffsets[From]; iAdjacent < m_vTriangleOffsets[From + 1]; ++iAdjacent)
+	{
+		const uint32_t* const Triangle{ &m_vIndices[m_vTriangles[iAdjacent] * 3] };
+		if (Triangle[0] == To || Triangle[1] == To || Triangle[2] == To)
+		{
+			++SharedTriangleCount;
+			continue;
+		}
+
+		XMVECTOR P[3]{};
+		XMVECTOR Q[3]{};
+		for (uint32_t iCorner = 0; iCorner < 3; ++iCorner)
+		{
+			P[iCorner] = XMLoadFloat3(&m_vPositions[Triangle[iCorner]]);
+			Q[iCorner] = (Triangle[iCorner] == From) ? KTo : P[iCorner];
+		}
+		XMVECTOR OldNormal{ XMVector3Cross(P[1] - P[0], P[2] - P[0]) };
+		XMVECTOR NewNormal{ XMVector3Cross(Q[1] - Q[0], Q[2] - Q[0]) };
+		float Dot{ XMVectorGetX(XMVector3Dot(OldNormal, NewNormal)) };
+		float LengthProduct{ XMVectorGetX(XMVector3Length(OldNormal)) * XMVectorGetX(XMVector3Length(NewNormal)) };
+		if (Dot <= KMinNormalCos * LengthProduct) return false;
+	}
+
+	// Link condition: the only vertices adjacent to both must be the opposite corners of the shared triangles
+	m_vScratchA.clear();
+	for (uint32_t iAdjacent = m_vTriangleOffsets[From]; iAdjacent < m_vTriangleOffsets[From + 1]; ++iAdjacent)
+	{
+		const uint32_t* const Triangle{ &m_vIndices[m_vTriangles[iAdjacent] * 3] };
+		for (uint32_t iCorner = 0; iCorner < 3; ++iCorner) m_vScratchA.emplace_back(Triangle[iCorner]);
+	}
+	m_vScratchB.clear();
+	for (uint32_t iAdjacent = m_vTriangleOffsets[To]; iAdjacent < m_vTriangleOffsets[To + 1]; ++iAdjacent)
+	{
+		const uint32_t* const Triangle{ &m_vIndices[m_vTriangles[iAdjacent] * 3] };
+		for (uint32_t iCorner = 0; iCorner < 3; ++iCorner) m_vScratchB.emplace_back(Triangle[iCorner]);
+	}
+	std::sort(m_vScratchA.begin(), m_vScratchA.end());
+	m_vScratchA.erase(std::unique(m_vScratchA.begin(), m_vScratchA.end()), m_vScratchA.end());
+	std::sort(m_vScratchB.begin(), m_vScratchB.end());
+	m_vScratchB.erase(std::unique(m_vScratchB.begin(), m_vScratchB.end()), m_vScratchB.end());
+
+	uint32_t CommonCount{};
+	for (size_t iA = 0, iB = 0; iA < m_vScratchA.size() && iB < m_vScratchB.size();)
+	{
+		if (m_vScratchA[iA] < m_vScratchB[iB])
+		{
+			++iA;
+		}
+		else if (m_vScratchB[iB] < m_vScratchA[iA])
+		{
+			++iB;
+		}
+		else
+		{
+			if (m_vScratchA[iA] != From && m_vScratchA[iA] != To) ++CommonCount;
+			++iA;
+			++iB;
+		}
+	}
+	return CommonCount <= SharedTriangleCount;
+}
+
+const vector<uint32_t>& CMeshSimplifier::GetIndices() const
+{
+	return m_vIndices;
+}
+
+uint32_t CMeshSimplifier::GetTriangleCount() const
+{
+	return (uint32_t)(m_vIndices.size() / 3);
+}
+
+float CMeshSimplifier::GetError() const
+{
+	return m_Error;
+}
+
+uint32_t CMeshSimplifier::GetLockedVertexCount() const
+{
+	return (uint32_t)std::count(m_vIsLocked.begin(), m_vIsLocked.end(), true);
+}
+
+void CMeshSimplifier::AddPlane(SQuadric& Quadric, const XMVECTOR& Normal, double D, double Weight)
+{
+	double X{ XMVectorGetX(Normal) };
+	double Y{ XMVectorGetY(Normal) };
+	double Z{ XMVectorGetZ(Normal) };
+
+	Quadric.A00 += Weight * X * X;
+	Quadric.A01 += Weight * X * Y;
+	Quadric.A02 += Weight * X * Z;
+	Quadric.A11 += Weight * Y * Y;
+	Quadric.A12 += Weight * Y * Z;
+	Quadric.A22 += Weight * Z * Z;
+	Quadric.B0 += Weight * X * D;
+	Quadric.B1 += Weight * Y * D;
+	Quadric.B2 += Weight * Z * D;
+	Quadric.C += Weight * D * D;
+	Quadric.Weight += Weight;
+}
+
+void CMeshSimplifier::AddQuadric(SQuadric& Quadric, const SQuadric& Other)
+{
+	Quadric.A00 += Other.A00;
+	Quadric.A01 += Other.A01;
+	Quadric.A02 += Other.A02;
+	Quadric.A11 += Other.A11;
+	Quadric.A12 += Other.A12;
+	Quadric.A22 += Other.A22;
+	Quadric.B0 += Other.B0;
+	Quadric.B1 += Other.B1;
+	Quadric.B2 += Other.B2;
+	Quadric.C += Other.C;
+	Quadric.Weight += Other.Weight;
+}
+
+double CMeshSimplifier::EvaluateQuadric(const SQuadric& Quadric, const XMFLOAT3& Position)
+{
+	double X{ Position.x };
+	double Y{ Position.y };
+	double Z{ Position.z };
+
+	return Quadric.A00 * X * X + Quadric.A11 * Y * Y + Quadric.A22 * Z * Z +
+		2.0 * (Quadric.A01 * X * Y + Quadric.A02 * X * Z + Quadric.A12 * Y * Z) +
+		2.0 * (Quadric.B0 * X + Quadric.B1 * Y + Quadric.B2 * Z) + Quadric.C;
+}
+
+double CMeshSimplifier::MeasureSimplifyTime(uint32_t GridSize, uint32_t IterationCount)
+{
+	if (GridSize < 2 || IterationCount == 0) return 0.0;
+
+	// @important: fixed seed (xorshift), so that the results are comparable between runs
+	uint64_t State{ 0x9E3779B97F4A7C15 };
+	auto Random{ [&State]()
+		{
+			State ^= State << 13;
+			State ^= State >> 7;
+			State ^= State << 17;
+			return (float)(State >> 40) / (float)(1 << 24);
+		}
+	};
+
+	vector<XMFLOAT3> vPositions{};
+	for (uint32_t iZ = 0; iZ < GridSize; ++iZ)
+	{
+		for (uint32_t iX = 0; iX < GridSize; ++iX)
+		{
+			vPositions.emplace_back((float)iX, Random() * 0.1f, (float)iZ);
+		}
+	}
+	vector<uint32_t> vIndices{};
+	for (uint32_t iZ = 0; iZ + 1 < GridSize; ++iZ)
+	{
+		for (uint32_t iX = 0; iX + 1 < GridSize; ++iX)
+		{
+			uint32_t I{ iZ * GridSize + iX };
+			vIndices.insert(vIndices.end(), { I, I + GridSize, I + 1, I + 1, I + GridSize, I + GridSize + 1 });
+		}
+	}
+
+	CMeshSimplifier Simplifier{};
+	double TotalMicroseconds{};
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
+	{
+		auto StartTimePoint{ std::chrono::steady_clock::now() };
+		Simplifier.SetMesh(vPositions, vIndices);
+		Simplifier.Simplify((uint32_t)(vIndices.size() / 3 / 4), FLT_MAX);
+		TotalMicroseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - StartTimePoint).count();
+	}
+
+	return TotalMicroseconds / IterationCount;
+}
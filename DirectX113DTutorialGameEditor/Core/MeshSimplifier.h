@@ -0,0 +1,90 @@
+#pragma once
+
+// @important: pure CPU (DirectXMath only), so that it doesn't depend on any device
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <DirectXMath.h>
+
+// Quadric error edge-collapse simplification for LOD generation
+// Vertices are collapsed into one of their neighbors (half-edge collapse), so that the vertex buffer is shared by every LOD
+// and only the index list changes (vertex attributes and skin weights are kept as they are)
+// @important: vertices on open edges are locked, which keeps both the mesh borders and the UV/normal seams (split vertices)
+class CMeshSimplifier
+{
+private:
+	// Sum of area-weighted squared distances to planes: x^T A x + 2 b.x + c
+	struct SQuadric
+	{
+		double	A00{}, A01{}, A02{}, A11{}, A12{}, A22{};
+		double	B0{}, B1{}, B2{};
+		double	C{};
+		double	Weight{}; // area
+	};
+
+	struct SCollapse
+	{
+		uint32_t	From{};
+		uint32_t	To{};
+		float		Cost{}; // squared distance
+	};
+
+public:
+	CMeshSimplifier() {}
+	~CMeshSimplifier() {}
+
+public:
+	// Positions: one per vertex, Indices: 3 per triangle
+	// VertexGroups (one per vertex, optional): vertices are collapsed only into vertices of the same group (e.g. the most weighted bone)
+	void SetMesh(const std::vector<DirectX::XMFLOAT3>& vPositions, const std::vector<uint32_t>& vIndices,
+		const std::vector<uint32_t>* const PtrVertexGroups = nullptr);
+
+	// Continues from the last result, so that a LOD chain is simplified step by step
+	// Stops at TargetTriangleCount or before any collapse would move the surface farther than MaxError (model space)
+	// Returns the triangle count
+	uint32_t Simplify(uint32_t TargetTriangleCount, float MaxError);
+
+public:
+	const std::vector<uint32_t>& GetIndices() const;
+	uint32_t GetTriangleCount() const;
+	// The largest distance any collapse moved the surface by (model space)
+	float GetError() const;
+	uint32_t GetLockedVertexCount() const;
+
+public:
+	// Simplifies a GridSize x GridSize bumpy grid to a quarter of its triangles IterationCount times
+	// and returns the average time in microseconds
+	static double MeasureSimplifyTime(uint32_t GridSize, uint32_t IterationCount);
+
+public:
+	static constexpr float KMinNormalCos{ 0.25f }; // collapses that turn a triangle by more than ~75 degrees are rejected
+
+private:
+	void BuildAdjacency();
+	float GetCost(uint32_t From, uint32_t To) const;
+	// Rejects collapses that would flip a triangle or make the mesh non-manifold
+	bool IsValidCollapse(uint32_t From, uint32_t To);
+
+private:
+	static void AddPlane(SQuadric& Quadric, const DirectX::XMVECTOR& Normal, double D, double Weight);
+	static void AddQuadric(SQuadric& Quadric, const SQuadric& Other);
+	static double EvaluateQuadric(const SQuadric& Quadric, const DirectX::XMFLOAT3& Position);
+
+private:
+	std::vector<DirectX::XMFLOAT3>	m_vPositions{};
+	std::vector<uint32_t>			m_vVertexGroups{};
+	std::vector<uint32_t>			m_vIndices{};
+	std::vector<SQuadric>			m_vQuadrics{};
+	std::vector<bool>				m_vIsLocked{};
+	float							m_Error{};
+
+	// Vertex to triangle adjacency of the current indices (CSR)
+	std::vector<uint32_t>			m_vTriangleOffsets{};
+	std::vector<uint32_t>			m_vTriangles{};
+
+	std::vector<SCollapse>			m_vCollapses{};
+	std::vector<uint32_t>			m_vRemap{};
+	std::vector<bool>				m_vIsTouched{};
+	std::vector<uint32_t>			m_vScratchA{};
+	std::vector<uint32_t>			m_vScratchB{};
+};
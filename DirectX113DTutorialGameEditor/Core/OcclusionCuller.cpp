@@ -0,0 +1,525 @@
+#include "OcclusionCuller.h"
+#include "TaskScheduler.h"
+#include <algorithm>
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <thread>
+
+using namespace DirectX;
+using std::max;
+using std::min;
+using std::vector;
+
+void COcclusionCuller::SetResolution(uint32_t Width, uint32_t Height)
+{
+	assert(Width && Height);
+	assert((Width & 3) == 0);
+
+	m_Width = Width;
+	m_Height = Height;
+
+	m_vDepthLevels.clear();
+	uint32_t LevelWidth{ Width };
+	uint32_t LevelHeight{ Height };
+	while (true)
+	{
+		m_vDepthLevels.emplace_back();
+		m_vDepthLevels.back().Width = LevelWidth;
+		m_vDepthLevels.back().Height = LevelHeight;
+		m_vDepthLevels.back().vDepths.assign((size_t)LevelWidth * LevelHeight, 1.0f);
+
+		if (LevelWidth == 1 && LevelHeight == 1) break;
+		LevelWidth = (LevelWidth + 1) / 2;
+		LevelHeight = (LevelHeight + 1) / 2;
+	}
+}
+
+void COcclusionCuller::SetBudget(uint32_t MaxOccluderCount, uint32_t MaxTriangleCount)
+{
+	m_MaxOccluderCount = MaxOccluderCount;
+	m_MaxTriangleCount = MaxTriangleCount;
+}
+
+void COcclusionCuller::BeginFrame(const XMMATRIX& ViewProjectionMatrix, const XMVECTOR& EyePosition)
+{
+	if (m_vDepthLevels.empty()) SetResolution(m_Width, m_Height);
+
+	XMStoreFloat4x4(&m_ViewProjectionMatrix, ViewProjectionMatrix);
+	XMStoreFloat3(&m_EyePosition, EyePosition);
+
+	// @important: every level is cleared, so that nothing is occluded until the occluders are rasterized
+	for (auto& Level : m_vDepthLevels)
+	{
+		std::fill(Level.vDepths.begin(), Level.vDepths.end(), 1.0f);
+	}
+
+	m_vQueuedOccluders.clear();
+	m_vScreenTriangles.clear();
+	m_Statistics = SStatistics();
+}
+
+void COcclusionCuller::AddOccluder(const SOccluderMesh* const PtrMesh, const XMMATRIX& WorldMatrix, const XMFLOAT4& BoundingSphere)
+{
+	if (!PtrMesh || PtrMesh->vIndices.size() < 3) return;
+
+	float DX{ BoundingSphere.x - m_EyePosition.x };
+	float DY{ BoundingSphere.y - m_EyePosition.y };
+	float DZ{ BoundingSphere.z - m_EyePosition.z };
+	float Distance{ sqrtf(DX * DX + DY * DY + DZ * DZ) };
+
+	SQueuedOccluder Occluder{};
+	Occluder.PtrMesh = PtrMesh;
+	XMStoreFloat4x4(&Occluder.WorldMatrix, WorldMatrix);
+	Occluder.ScreenSize = BoundingSphere.w / max(Distance, 0.001f);
+	m_vQueuedOccluders.emplace_back(Occluder);
+
+	++m_Statistics.QueuedOccluderCount;
+}
+
+void COcclusionCuller::RasterizeOccluders(CTaskScheduler* const PtrTaskScheduler)
+{
+	if (m_vDepthLevels.empty()) SetResolution(m_Width, m_Height);
+
+	// @important: the largest occluders on screen first, until the budget runs out
+	std::sort(m_vQueuedOccluders.begin(), m_vQueuedOccluders.end(),
+		[](const SQueuedOccluder& A, const SQueuedOccluder& B) { return A.ScreenSize > B.ScreenSize; });
+
+	const XMMATRIX KViewProjection{ XMLoadFloat4x4(&m_ViewProjectionMatrix) };
+	uint32_t TriangleCount{};
+	m_vScreenTriangles.clear();
+	for (const SQueuedOccluder& Occluder : m_vQueuedOccluders)
+	{
+		if (m_Statistics.OccluderCount >= m_MaxOccluderCount) break;
+
+		const SOccluderMesh& Mesh{ *Occluder.PtrMesh };
+		const uint32_t KMeshTriangleCount{ (uint32_t)(Mesh.vIndices.size() / 3) };
+		if (TriangleCount + KMeshTriangleCount > m_MaxTriangleCount) continue; // smaller ones may still fit
+		TriangleCount += KMeshTriangleCount;
+		++m_Statistics.OccluderCount;
+
+		const XMMATRIX KWorldViewProjection{ XMLoadFloat4x4(&Occluder.WorldMatrix) * KViewProjection };
+		m_vClipPositions.resize(Mesh.vPositions.size());
+		for (size_t iPosition = 0; iPosition < Mesh.vPositions.size(); ++iPosition)
+		{
+			XMStoreFloat4(&m_vClipPositions[iPosition], XMVector3Transform(XMLoadFloat3(&Mesh.vPositions[iPosition]), KWorldViewProjection));
+		}
+
+		for (size_t iIndex = 0; iIndex + 2 < Mesh.vIndices.size(); iIndex += 3)
+		{
+			SetUpTriangle(
+				XMLoadFloat4(&m_vClipPositions[Mesh.vIndices[iIndex + 0]]),
+				XMLoadFloat4(&m_vClipPositions[Mesh.vIndices[iIndex + 1]]),
+				XMLoadFloat4(&m_vClipPositions[Mesh.vIndices[iIndex + 2]]));
+		}
+	}
+	m_Statistics.TriangleCount = (uint32_t)m_vScreenTriangles.size();
+
+	// Row bands are independent, so that each worker writes its own rows without any synchronization
+	uint32_t ThreadCount{ (PtrTaskScheduler) ? max(std::thread::hardware_concurrency(), 1u) : 1 };
+	ThreadCount = min(ThreadCount, max(m_Statistics.TriangleCount / KMinTriangleCountPerThread, 1u));
+	if (ThreadCount == 1)
+	{
+		RasterizeBand(0, m_Height);
+	}
+	else
+	{
+		const uint32_t KBandCount{ min(ThreadCount * 4, m_Height) };
+		const uint32_t KBandRowCount{ (m_Height + KBandCount - 1) / KBandCount };
+
+		PtrTaskScheduler->Reset();
+		for (uint32_t FirstRow = 0; FirstRow < m_Height; FirstRow += KBandRowCount)
+		{
+			PtrTaskScheduler->AddTask([this, FirstRow, KBandRowCount]() { RasterizeBand(FirstRow, min(KBandRowCount, m_Height - FirstRow)); });
+		}
+		PtrTaskScheduler->Start();
+		PtrTaskScheduler->Wait(true); // @important: the calling thread works, too
+	}
+
+	BuildPyramid();
+}
+
+void COcclusionCuller::SetUpTriangle(const XMVECTOR& ClipV0, const XMVECTOR& ClipV1, const XMVECTOR& ClipV2)
+{
+	// Sutherland-Hodgman against the near plane (z >= 0), so a triangle becomes 0, 1 or 2 triangles
+	const XMVECTOR KVertices[3]{ ClipV0, ClipV1, ClipV2 };
+	XMVECTOR ClippedVertices[4]{};
+	uint32_t ClippedVertexCount{};
+	for (uint32_t iVertex = 0; iVertex < 3; ++iVertex)
+	{
+		const XMVECTOR& KCurr{ KVertices[iVertex] };
+		const XMVECTOR& KNext{ KVertices[(iVertex + 1) % 3] };
+		float CurrZ{ XMVectorGetZ(KCurr) };
+		float NextZ{ XMVectorGetZ(KNext) };
+
+		if (CurrZ >= 0.0f) ClippedVertices[ClippedVertexCount++] = KCurr;
+		if ((CurrZ >= 0.0f) != (NextZ >= 0.0f))
+		{
+			ClippedVertices[ClippedVertexCount++] = XMVectorLerp(KCurr, KNext, CurrZ / (CurrZ - NextZ));
+		}
+	}
+	if (ClippedVertexCount < 3) return;
+
+	AddScreenTriangle(ClippedVertices[0], ClippedVertices[1], ClippedVertices[2]);
+	if (ClippedVertexCount == 4) AddScreenTriangle(ClippedVertices[0], ClippedVertices[2], ClippedVertices[3]);
+}
+
+void COcclusionCuller::AddScreenTriangle(const XMVECTOR& ClipV0, const XMVECTOR& ClipV1, const XMVECTOR& ClipV2)
+{
+	const XMVECTOR KClipVertices[3]{ ClipV0, ClipV1, ClipV2 };
+
+	SScreenTriangle Triangle{};
+	float Z[3]{};
+	for (uint32_t iVertex = 0; iVertex < 3; ++iVertex)
+	{
+		XMFLOAT4 ClipVertex{};
+		XMStoreFloat4(&ClipVertex, KClipVertices[iVertex]);
+
+		float InverseW{ 1.0f / ClipVertex.w };
+		Triangle.X[iVertex] = (ClipVertex.x * InverseW * 0.5f + 0.5f) * (float)m_Width;
+		Triangle.Y[iVertex] = (0.5f - ClipVertex.y * InverseW * 0.5f) * (float)m_Height;
+		Z[iVertex] = min(ClipVertex.z * InverseW, 1.0f);
+	}
+
+	float Area{ (Triangle.X[1] - Triangle.X[0]) * (Triangle.Y[2] - Triangle.Y[0]) - (Triangle.X[2] - Triangle.X[0]) * (Triangle.Y[1] - Triangle.Y[0]) };
+	if (fabsf(Area) < 1e-6f) return;
+
+	// @important: occluders are double-sided, so the winding is made positive instead of culling back faces
+	if (Area < 0.0f)
+	{
+		std::swap(Triangle.X[1], Triangle.X[2]);
+		std::swap(Triangle.Y[1], Triangle.Y[2]);
+		std::swap(Z[1], Z[2]);
+		Area = -Area;
+	}
+
+	float InverseArea{ 1.0f / Area };
+	Triangle.DepthA = ((Z[1] - Z[0]) * (Triangle.Y[2] - Triangle.Y[0]) - (Z[2] - Z[0]) * (Triangle.Y[1] - Triangle.Y[0])) * InverseArea;
+	Triangle.DepthB = ((Triangle.X[1] - Triangle.X[0]) * (Z[2] - Z[0]) - (Triangle.X[2] - Triangle.X[0]) * (Z[1] - Z[0])) * InverseArea;
+	Triangle.DepthC = Z[0] - Triangle.DepthA * Triangle.X[0] - Triangle.DepthB * Triangle.Y[0];
+
+	// Pixels whose centers (+0.5) are inside the bounds, clamped before the conversion so that huge coordinates don't overflow
+	float MinX{ min(min(Triangle.X[0], Triangle.X[1]), Triangle.X[2]) };
+	float MaxX{ max(max(Triangle.X[0], Triangle.X[1]), Triangle.X[2]) };
+	float MinY{ min(min(Triangle.Y[0], Triangle.Y[1]), Triangle.Y[2]) };
+	float MaxY{ max(max(Triangle.Y[0], Triangle.Y[1]), Triangle.Y[2]) };
+	Triangle.MinX = (int32_t)ceilf(min(max(MinX - 0.5f, 0.0f), (float)m_Width));
+	Triangle.MaxX = (int32_t)floorf(max(min(MaxX - 0.5f, (float)(m_Width - 1)), -1.0f));
+	Triangle.MinY = (int32_t)ceilf(min(max(MinY - 0.5f, 0.0f), (float)m_Height));
+	Triangle.MaxY = (int32_t)floorf(max(min(MaxY - 0.5f, (float)(m_Height - 1)), -1.0f));
+	if (Triangle.MinX > Triangle.MaxX || Triangle.MinY > Triangle.MaxY) return;
+
+	m_vScreenTriangles.emplace_back(Triangle);
+}
+
+void COcclusionCuller::RasterizeBand(uint32_t FirstRow, uint32_t RowCount)
+{
+	SDepthLevel& DepthBuffer{ m_vDepthLevels[0] };
+	const int32_t KFirstRow{ (int32_t)FirstRow };
+	const int32_t KLastRow{ (int32_t)(FirstRow + RowCount - 1) };
+	const XMVECTOR KZero{ XMVectorZero() };
+	const XMVECTOR KLaneCenters{ XMVectorSet(0.5f, 1.5f, 2.5f, 3.5f) };
+
+	for (const SScreenTriangle& Triangle : m_vScreenTriangles)
+	{
+		const int32_t KMinY{ max(Triangle.MinY, KFirstRow) };
+		const int32_t KMaxY{ min(Triangle.MaxY, KLastRow) };
+		if (KMinY > KMaxY) continue;
+
+		const float* const X{ Triangle.X };
+		const float* const Y{ Triangle.Y };
+
+		// Edge function of edge (i, j) along a row: (Yi - Yj) * x + (Xj - Xi) * (y - Yi) + (Yj - Yi) * Xi (>= 0 inside)
+		const XMVECTOR KEdgeSlopes[3]{ XMVectorReplicate(Y[0] - Y[1]), XMVectorReplicate(Y[1] - Y[2]), XMVectorReplicate(Y[2] - Y[0]) };
+		const XMVECTOR KDepthA{ XMVectorReplicate(Triangle.DepthA) };
+		const int32_t KStartX{ Triangle.MinX & ~3 };
+
+		for (int32_t iY = KMinY; iY <= KMaxY; ++iY)
+		{
+			const float KPixelY{ (float)iY + 0.5f };
+			const XMVECTOR KEdgeOffsets[3]
+			{
+				XMVectorReplicate((X[1] - X[0]) * (KPixelY - Y[0]) + (Y[1] - Y[0]) * X[0]),
+				XMVectorReplicate((X[2] - X[1]) * (KPixelY - Y[1]) + (Y[2] - Y[1]) * X[1]),
+				XMVectorReplicate((X[0] - X[2]) * (KPixelY - Y[2]) + (Y[0] - Y[2]) * X[2]),
+			};
+			const XMVECTOR KDepthOffset{ XMVectorReplicate(Triangle.DepthB * KPixelY + Triangle.DepthC) };
+
+			float* const PtrRow{ &DepthBuffer.vDepths[(size_t)iY * m_Width] };
+			for (int32_t iX = KStartX; iX <= Triangle.MaxX; iX += 4)
+			{
+				XMVECTOR PixelXs{ XMVectorAdd(XMVectorReplicate((float)iX), KLaneCenters) };
+				XMVECTOR Inside{ XMVectorGreaterOrEqual(XMVectorMultiplyAdd(KEdgeSlopes[0], PixelXs, KEdgeOffsets[0]), KZero) };
+				Inside = XMVectorAndInt(Inside, XMVectorGreaterOrEqual(XMVectorMultiplyAdd(KEdgeSlopes[1], PixelXs, KEdgeOffsets[1]), KZero));
+				Inside = XMVectorAndInt(Inside, XMVectorGreaterOrEqual(XMVectorMultiplyAdd(KEdgeSlopes[2], PixelXs, KEdgeOffsets[2]), KZero));
+
+				XMFLOAT4* const PtrDepths{ reinterpret_cast<XMFLOAT4*>(PtrRow + iX) };
+				XMVECTOR Depths{ XMLoadFloat4(PtrDepths) };
+				XMVECTOR TriangleDepths{ XMVectorMultiplyAdd(KDepthA, PixelXs, KDepthOffset) };
+				XMStoreFloat4(PtrDepths, XMVectorSelect(Depths, XMVectorMin(Depths, TriangleDepths), Inside));
+			}
+		}
+	}
+}
+
+void COcclusionCuller::BuildPyramid()
+{
+	for (size_t iLevel = 1; iLevel < m_vDepthLevels.size(); ++iLevel)
+	{
+		const SDepthLevel& KSource{ m_vDepthLevels[iLevel - 1] };
+		SDepthLevel& Dest{ m_vDepthLevels[iLevel] };
+		for (uint32_t iY = 0; iY < Dest.Height; ++iY)
+		{
+			const float* const PtrRow0{ &KSource.vDepths[(size_t)min(iY * 2 + 0, KSource.Height - 1) * KSource.Width] };
+			const float* const PtrRow1{ &KSource.vDepths[(size_t)min(iY * 2 + 1, KSource.Height - 1) * KSource.Width] };
+			for (uint32_t iX = 0; iX < Dest.Width; ++iX)
+			{
+				uint32_t X0{ min(iX * 2 + 0, KSource.Width - 1) };
+				uint32_t X1{ min(iX * 2 + 1, KSource.Width - 1) };
+				Dest.vDepths[(size_t)iY * Dest.Width + iX] = max(max(PtrRow0[X0], PtrRow0[X1]), max(PtrRow1[X0], PtrRow1[X1]));
+			}
+		}
+	}
+}
+
+bool COcclusionCuller::IsVisible(const XMFLOAT3& Center, const XMFLOAT3& Extents) const
+{
+	if (m_vDepthLevels.empty()) return true;
+	++m_Statistics.TestedCount;
+
+	// Corners = center +- each axis (transformed once)
+	const XMMATRIX KViewProjection{ XMLoadFloat4x4(&m_ViewProjectionMatrix) };
+	const XMVECTOR KClipCenter{ XMVector3Transform(XMLoadFloat3(&Center), KViewProjection) };
+	const XMVECTOR KClipAxes[3]
+	{
+		XMVectorScale(KViewProjection.r[0], Extents.x),
+		XMVectorScale(KViewProjection.r[1], Extents.y),
+		XMVectorScale(KViewProjection.r[2], Extents.z),
+	};
+
+	float MinX{ +FLT_MAX };
+	float MaxX{ -FLT_MAX };
+	float MinY{ +FLT_MAX };
+	float MaxY{ -FLT_MAX };
+	float MinZ{ +FLT_MAX };
+	for (uint32_t iCorner = 0; iCorner < 8; ++iCorner)
+	{
+		XMVECTOR ClipCorner{ KClipCenter };
+		ClipCorner = (iCorner & 1) ? XMVectorAdd(ClipCorner, KClipAxes[0]) : XMVectorSubtract(ClipCorner, KClipAxes[0]);
+		ClipCorner = (iCorner & 2) ? XMVectorAdd(ClipCorner, KClipAxes[1]) : XMVectorSubtract(ClipCorner, KClipAxes[1]);
+		ClipCorner = (iCorner & 4) ? XMVectorAdd(ClipCorner, KClipAxes[2]) : XMVectorSubtract(ClipCorner, KClipAxes[2]);
+
+		XMFLOAT4 Corner{};
+		XMStoreFloat4(&Corner, ClipCorner);
+		if (Corner.z < 0.0f) return true; // @important: crossing the near plane, the projected bounds are meaningless
+
+		float InverseW{ 1.0f / Corner.w };
+		MinX = min(MinX, Corner.x * InverseW);
+		MaxX = max(MaxX, Corner.x * InverseW);
+		MinY = min(MinY, Corner.y * InverseW);
+		MaxY = max(MaxY, Corner.y * InverseW);
+		MinZ = min(MinZ, Corner.z * InverseW);
+	}
+
+	// Off the screen, which is up to the frustum culling
+	if (MaxX < -1.0f || MinX > 1.0f || MaxY < -1.0f || MinY > 1.0f) return true;
+
+	const int32_t KMinPixelX{ (int32_t)max((MinX * 0.5f + 0.5f) * (float)m_Width, 0.0f) };
+	const int32_t KMaxPixelX{ (int32_t)min((MaxX * 0.5f + 0.5f) * (float)m_Width, (float)(m_Width - 1)) };
+	const int32_t KMinPixelY{ (int32_t)max((0.5f - MaxY * 0.5f) * (float)m_Height, 0.0f) };
+	const int32_t KMaxPixelY{ (int32_t)min((0.5f - MinY * 0.5f) * (float)m_Height, (float)(m_Height - 1)) };
+
+	// @important: the finest level where the bounds cover at most 4x4 texels
+	uint32_t iLevel{};
+	while (iLevel + 1 < (uint32_t)m_vDepthLevels.size() &&
+		(((KMaxPixelX >> iLevel) - (KMinPixelX >> iLevel)) >= 4 || ((KMaxPixelY >> iLevel) - (KMinPixelY >> iLevel)) >= 4))
+	{
+		++iLevel;
+	}
+
+	const SDepthLevel& KLevel{ m_vDepthLevels[iLevel] };
+	float MaxDepth{};
+	for (int32_t iY = KMinPixelY >> iLevel; iY <= (KMaxPixelY >> iLevel); ++iY)
+	{
+		for (int32_t iX = KMinPixelX >> iLevel; iX <= (KMaxPixelX >> iLevel); ++iX)
+		{
+			MaxDepth = max(MaxDepth, KLevel.vDepths[(size_t)iY * KLevel.Width + iX]);
+		}
+	}
+
+	if (MinZ > MaxDepth)
+	{
+		++m_Statistics.OccludedCount;
+		return false;
+	}
+	return true;
+}
+
+bool COcclusionCuller::IsVisible(const XMFLOAT4& Sphere) const
+{
+	return IsVisible(XMFLOAT3(Sphere.x, Sphere.y, Sphere.z), XMFLOAT3(Sphere.w, Sphere.w, Sphere.w));
+}
+
+uint32_t COcclusionCuller::GetWidth() const
+{
+	return m_Width;
+}
+
+uint32_t COcclusionCuller::GetHeight() const
+{
+	return m_Height;
+}
+
+float COcclusionCuller::GetDepth(uint32_t X, uint32_t Y) const
+{
+	assert(X < m_Width && Y < m_Height);
+	if (m_vDepthLevels.empty()) return 1.0f;
+	return m_vDepthLevels[0].vDepths[(size_t)Y * m_Width + X];
+}
+
+uint32_t COcclusionCuller::GetPyramidLevelCount() const
+{
+	return (uint32_t)m_vDepthLevels.size();
+}
+
+const COcclusionCuller::SStatistics& COcclusionCuller::GetStatistics() const
+{
+	return m_Statistics;
+}
+
+SOccluderMesh COcclusionCuller::CreateBoxOccluderMesh(const XMFLOAT3& Extents)
+{
+	SOccluderMesh Mesh{};
+	for (uint32_t iCorner = 0; iCorner < 8; ++iCorner)
+	{
+		Mesh.vPositions.emplace_back(
+			(iCorner & 1) ? +Extents.x : -Extents.x,
+			(iCorner & 2) ? +Extents.y : -Extents.y,
+			(iCorner & 4) ? +Extents.z : -Extents.z);
+	}
+
+	// Two triangles per face (-X, +X, -Y, +Y, -Z, +Z)
+	Mesh.vIndices =
+	{
+		0, 4, 6,  0, 6, 2,
+		1, 3, 7,  1, 7, 5,
+		0, 1, 5,  0, 5, 4,
+		2, 6, 7,  2, 7, 3,
+		0, 2, 3,  0, 3, 1,
+		4, 5, 7,  4, 7, 6,
+	};
+	return Mesh;
+}
+
+// Random boxes in front of a camera at the origin looking at +Z, spread over its view frustum
+static void GenerateBenchmarkBoxes(uint32_t BoxCount, uint64_t& State, vector<XMFLOAT3>& vOutCenters, vector<XMFLOAT3>& vOutExtents)
+{
+	// @important: xorshift, so that the results are comparable between runs
+	auto Random{ [&State](float Min, float Max)
+		{
+			State ^= State << 13;
+			State ^= State >> 7;
+			State ^= State << 17;
+			return Min + (Max - Min) * (float)(State >> 40) / (float)(1 << 24);
+		}
+	};
+
+	vOutCenters.resize(BoxCount);
+	vOutExtents.resize(BoxCount);
+	for (uint32_t iBox = 0; iBox < BoxCount; ++iBox)
+	{
+		float Z{ Random(5.0f, 100.0f) };
+		vOutCenters[iBox] = XMFLOAT3(Random(-0.8f, 0.8f) * Z, Random(-0.4f, 0.4f) * Z, Z);
+		vOutExtents[iBox] = XMFLOAT3(Random(0.5f, 5.0f), Random(0.5f, 5.0f), Random(0.5f, 5.0f));
+	}
+}
+
+static XMMATRIX GetBenchmarkViewProjection()
+{
+	return XMMatrixPerspectiveFovLH(50.0f / 360.0f * XM_2PI, 2.0f, 0.1f, 1000.0f);
+}
+
+double COcclusionCuller::MeasureRasterizationTime(uint32_t OccluderCount, uint32_t IterationCount, uint32_t ThreadCount)
+{
+	if (OccluderCount == 0 || IterationCount == 0) return 0.0;
+
+	uint64_t State{ 0x9E3779B97F4A7C15 };
+	vector<XMFLOAT3> vCenters{};
+	vector<XMFLOAT3> vExtents{};
+	GenerateBenchmarkBoxes(OccluderCount, State, vCenters, vExtents);
+
+	vector<SOccluderMesh> vMeshes(OccluderCount);
+	for (uint32_t iOccluder = 0; iOccluder < OccluderCount; ++iOccluder)
+	{
+		vMeshes[iOccluder] = CreateBoxOccluderMesh(vExtents[iOccluder]);
+	}
+
+	COcclusionCuller Culler{};
+	Culler.SetBudget(OccluderCount, OccluderCount * 12);
+
+	// @important: the workers are created before the measurement, as they are kept between frames in the game
+	CTaskScheduler TaskScheduler{};
+	if (ThreadCount != 1)
+	{
+		TaskScheduler.Start((ThreadCount) ? ThreadCount - 1 : 0);
+		TaskScheduler.Wait();
+	}
+
+	double TotalMicroseconds{};
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
+	{
+		auto StartTimePoint{ std::chrono::steady_clock::now() };
+		Culler.BeginFrame(GetBenchmarkViewProjection(), XMVectorZero());
+		for (uint32_t iOccluder = 0; iOccluder < OccluderCount; ++iOccluder)
+		{
+			const XMFLOAT3& Center{ vCenters[iOccluder] };
+			const XMFLOAT3& Extents{ vExtents[iOccluder] };
+			float Radius{ sqrtf(Extents.x * Extents.x + Extents.y * Extents.y + Extents.z * Extents.z) };
+			Culler.AddOccluder(&vMeshes[iOccluder], XMMatrixTranslation(Center.x, Center.y, Center.z), XMFLOAT4(Center.x, Center.y, Center.z, Radius));
+		}
+		Culler.RasterizeOccluders((ThreadCount != 1) ? &TaskScheduler : nullptr);
+		TotalMicroseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - StartTimePoint).count();
+	}
+
+	return TotalMicroseconds / IterationCount;
+}
+
+double COcclusionCuller::MeasureTestTime(uint32_t BoxCount, uint32_t IterationCount)
+{
+	if (BoxCount == 0 || IterationCount == 0) return 0.0;
+
+	uint64_t State{ 0x9E3779B97F4A7C15 };
+	vector<XMFLOAT3> vOccluderCenters{};
+	vector<XMFLOAT3> vOccluderExtents{};
+	GenerateBenchmarkBoxes(KDefaultMaxOccluderCount, State, vOccluderCenters, vOccluderExtents);
+
+	vector<SOccluderMesh> vMeshes(KDefaultMaxOccluderCount);
+	COcclusionCuller Culler{};
+	Culler.BeginFrame(GetBenchmarkViewProjection(), XMVectorZero());
+	for (uint32_t iOccluder = 0; iOccluder < KDefaultMaxOccluderCount; ++iOccluder)
+	{
+		const XMFLOAT3& Center{ vOccluderCenters[iOccluder] };
+		vMeshes[iOccluder] = CreateBoxOccluderMesh(vOccluderExtents[iOccluder]);
+		Culler.AddOccluder(&vMeshes[iOccluder], XMMatrixTranslation(Center.x, Center.y, Center.z), XMFLOAT4(Center.x, Center.y, Center.z, 1.0f));
+	}
+	Culler.RasterizeOccluders();
+
+	vector<XMFLOAT3> vCenters{};
+	vector<XMFLOAT3> vExtents{};
+	GenerateBenchmarkBoxes(BoxCount, State, vCenters, vExtents);
+
+	double TotalMicroseconds{};
+	uint32_t VisibleCount{};
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
+	{
+		auto StartTimePoint{ std::chrono::steady_clock::now() };
+		for (uint32_t iBox = 0; iBox < BoxCount; ++iBox)
+		{
+			VisibleCount += (Culler.IsVisible(vCenters[iBox], vExtents[iBox])) ? 1 : 0;
+		}
+		TotalMicroseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - StartTimePoint).count();
+	}
+	(void)VisibleCount;
+
+	return TotalMicroseconds / IterationCount;
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+// @important: pure CPU (DirectXMath only), so that it doesn't depend on any device
+#include <vector>
+#include <cstdint>
+#include <cassert>
+#include <DirectXMath.h>
+
+class CTaskScheduler;
+
+// Model-space occluder triangles, authored per object or simplified from its model
+struct SOccluderMesh
+{
+	std::vector<DirectX::XMFLOAT3>	vPositions{};
+	std::vector<uint32_t>			vIndices{}; // 3 per triangle
+};
+
+// Software occlusion culling
+// A budgeted set of the largest occluders on screen is rasterized into a low-resolution depth buffer
+// (4 pixels at a time, in row bands on the workers of a task scheduler), then a farthest-depth pyramid is built from it
+// so that every bounding box is tested against a handful of texels
+// @important: depth is post-projection z in [0, 1] (near to far), so the view projection must not be reversed
+class COcclusionCuller
+{
+public:
+	struct SStatistics
+	{
+		uint32_t	QueuedOccluderCount{};
+		uint32_t	OccluderCount{}; // rasterized
+		uint32_t	TriangleCount{}; // rasterized, after near plane clipping
+		uint32_t	TestedCount{};
+		uint32_t	OccludedCount{};
+	};
+
+private:
+	struct SQueuedOccluder
+	{
+		const SOccluderMesh*	PtrMesh{};
+		DirectX::XMFLOAT4X4		WorldMatrix{};
+		float					ScreenSize{}; // radius / distance
+	};
+
+	// In pixels, depth is the plane z = DepthA * x + DepthB * y + DepthC
+	struct SScreenTriangle
+	{
+		float		X[3]{};
+		float		Y[3]{};
+		float		DepthA{};
+		float		DepthB{};
+		float		DepthC{};
+		int32_t		MinX{};
+		int32_t		MaxX{};
+		int32_t		MinY{};
+		int32_t		MaxY{};
+	};
+
+	struct SDepthLevel
+	{
+		uint32_t			Width{};
+		uint32_t			Height{};
+		std::vector<float>	vDepths{};
+	};
+
+public:
+	COcclusionCuller() {}
+	~COcclusionCuller() {}
+
+public:
+	// Width must be a multiple of 4
+	void SetResolution(uint32_t Width, uint32_t Height);
+	void SetBudget(uint32_t MaxOccluderCount, uint32_t MaxTriangleCount);
+
+	// Clears the depth buffer and the queued occluders
+	void BeginFrame(const DirectX::XMMATRIX& ViewProjectionMatrix, const DirectX::XMVECTOR& EyePosition);
+	// BoundingSphere (world space, xyz = center, w = radius) ranks the occluders, only the largest ones on screen are rasterized
+	void AddOccluder(const SOccluderMesh* const PtrMesh, const DirectX::XMMATRIX& WorldMatrix, const DirectX::XMFLOAT4& BoundingSphere);
+	// Row bands are spread over the workers of TaskScheduler and the calling thread (nullptr rasterizes on the calling thread alone)
+	// @important: TaskScheduler must not be running another batch, and it's reset before the bands are added
+	void RasterizeOccluders(CTaskScheduler* const PtrTaskScheduler = nullptr);
+
+	// World-space AABB, boxes crossing the near plane are always visible
+	bool IsVisible(const DirectX::XMFLOAT3& Center, const DirectX::XMFLOAT3& Extents) const;
+	// Sphere: xyz = center, w = radius (tested as its bounding box)
+	bool IsVisible(const DirectX::XMFLOAT4& Sphere) const;
+
+public:
+	uint32_t GetWidth() const;
+	uint32_t GetHeight() const;
+	// Rasterized depth of the pixel (1 where nothing was rasterized)
+	float GetDepth(uint32_t X, uint32_t Y) const;
+	uint32_t GetPyramidLevelCount() const;
+	const SStatistics& GetStatistics() const;
+
+public:
+	// A closed box (12 triangles), centered at the origin
+	static SOccluderMesh CreateBoxOccluderMesh(const DirectX::XMFLOAT3& Extents);
+
+	// Rasterizes OccluderCount random boxes IterationCount times and returns the average time in microseconds
+	// ThreadCount 0 means one per hardware thread, 1 rasterizes on the calling thread alone
+	static double MeasureRasterizationTime(uint32_t OccluderCount, uint32_t IterationCount, uint32_t ThreadCount = 0);
+	// Tests BoxCount random boxes against random occluders IterationCount times and returns the average time in microseconds
+	static double MeasureTestTime(uint32_t BoxCount, uint32_t IterationCount);
+
+public:
+	static constexpr uint32_t KDefaultWidth{ 256 };
+	static constexpr uint32_t KDefaultHeight{ 128 };
+	static constexpr uint32_t KDefaultMaxOccluderCount{ 32 };
+	static constexpr uint32_t KDefaultMaxTriangleCount{ 4096 };
+	static constexpr uint32_t KMinTriangleCountPerThread{ 128 }; // fewer triangles are rasterized on the calling thread
+
+private:
+	// Clips the triangle against the near plane
+	void SetUpTriangle(const DirectX::XMVECTOR& ClipV0, const DirectX::XMVECTOR& ClipV1, const DirectX::XMVECTOR& ClipV2);
+	void AddScreenTriangle(const DirectX::XMVECTOR& ClipV0, const DirectX::XMVECTOR& ClipV1, const DirectX::XMVECTOR& ClipV2);
+	void RasterizeBand(uint32_t FirstRow, uint32_t RowCount);
+	void BuildPyramid();
+
+private:
+	uint32_t						m_Width{ KDefaultWidth };
+	uint32_t						m_Height{ KDefaultHeight };
+	uint32_t						m_MaxOccluderCount{ KDefaultMaxOccluderCount };
+	uint32_t						m_MaxTriangleCount{ KDefaultMaxTriangleCount };
+
+	DirectX::XMFLOAT4X4				m_ViewProjectionMatrix{};
+	DirectX::XMFLOAT3				m_EyePosition{};
+
+	std::vector<SQueuedOccluder>	m_vQueuedOccluders{};
+	std::vector<DirectX::XMFLOAT4>	m_vClipPositions{};
+	std::vector<SScreenTriangle>	m_vScreenTriangles{};
+	std::vector<SDepthLevel>		m_vDepthLevels{}; // [0] is the depth buffer, the others keep the farthest depth of 2x2 texels
+
+	mutable SStatistics				m_Statistics{};
+};
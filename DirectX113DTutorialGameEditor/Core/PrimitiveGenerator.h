@@ -3,6 +3,7 @@
 #include <unordered_map>
 
 #include "Math.h"
+#include "MeshOptimizer.h"
 #include "../Model/Object3D.h"
 #include "../Model/Object3DLine.h"
 #include "../Model/Object2D.h"
@@ -17,6 +18,7 @@ static std::string ConvertXMVECTORToString(const XMVECTOR& Vector);
 static void CalculateNormals(SMesh& Mesh);
 static void AverageNormals(SMesh& Mesh);
 static void CalculateTangents(SMesh& Mesh);
+static SMeshOptimizationStatistics OptimizeMesh(SMesh& Mesh, bool bReorderVertices, std::vector<uint32_t>* const PtrOutVertexRemap = nullptr);
 static std::vector<STriangle> GenerateContinuousQuads(int QuadCount);
 static SMesh GenerateTriangle(const XMVECTOR& V0, const XMVECTOR& V1, const XMVECTOR& V2, const XMVECTOR& Color = KColorWhite);
 static SMesh GenerateTriangle(const XMVECTOR& V0, const XMVECTOR& V1, const XMVECTOR& V2, const XMVECTOR& Color0, const XMVECTOR& Color1, const XMVECTOR& Color2);
@@ -218,6 +220,65 @@ static void AverageTangents(SMesh& Mesh)
 	}
 }
 
+// Reorders the triangles for the post-transform vertex cache and for overdraw,
+// then (if bReorderVertices) the vertices in the order they're first used, along with their skin weights and the LOD triangles
+// PtrOutVertexRemap: [old vertex] = new vertex, so that anything else that refers to the vertices can follow
+// @important: code that addresses vertices by how they were generated (e.g. the terrain grid) mustn't reorder them
+static SMeshOptimizationStatistics OptimizeMesh(SMesh& Mesh, bool bReorderVertices, std::vector<uint32_t>* const PtrOutVertexRemap)
+{
+	static_assert(sizeof(STriangle) == sizeof(uint32_t) * 3, "STriangle must be 3 packed indices");
+
+	SMeshOptimizationStatistics Statistics{};
+	if (PtrOutVertexRemap) PtrOutVertexRemap->clear();
+	if (Mesh.vTriangles.empty()) return Statistics;
+
+	const uint32_t KVertexCount{ (uint32_t)Mesh.vVertices.size() };
+	const uint32_t* const PtrIndices{ &Mesh.vTriangles[0].I0 };
+	std::vector<uint32_t> vIndices(PtrIndices, PtrIndices + Mesh.vTriangles.size() * 3);
+	std::vector<XMFLOAT3> vPositions(KVertexCount);
+	for (uint32_t iVertex = 0; iVertex < KVertexCount; ++iVertex)
+	{
+		XMStoreFloat3(&vPositions[iVertex], Mesh.vVertices[iVertex].Position);
+	}
+
+	Statistics.Before = CMeshOptimizer::AnalyzeVertexCache(vIndices, KVertexCount);
+	CMeshOptimizer::OptimizeVertexCache(vIndices, KVertexCount);
+	CMeshOptimizer::OptimizeOverdraw(vIndices, vPositions);
+
+	std::vector<uint32_t> vRemap{};
+	if (bReorderVertices)
+	{
+		CMeshOptimizer::OptimizeVertexFetch(vIndices, KVertexCount, vRemap);
+
+		std::vector<SVertex3D> vVertices(KVertexCount);
+		for (uint32_t iVertex = 0; iVertex < KVertexCount; ++iVertex) vVertices[vRemap[iVertex]] = Mesh.vVertices[iVertex];
+		Mesh.vVertices.swap(vVertices);
+
+		// @important: skin weights are per vertex, so they must follow the vertices
+		if (Mesh.vAnimationVertices.size() == KVertexCount)
+		{
+			std::vector<SAnimationVertex> vAnimationVertices(KVertexCount);
+			for (uint32_t iVertex = 0; iVertex < KVertexCount; ++iVertex) vAnimationVertices[vRemap[iVertex]] = Mesh.vAnimationVertices[iVertex];
+			Mesh.vAnimationVertices.swap(vAnimationVertices);
+		}
+
+		for (auto& vLODTriangles : Mesh.vLODTriangles)
+		{
+			for (STriangle& Triangle : vLODTriangles)
+			{
+				Triangle.I0 = vRemap[Triangle.I0];
+				Triangle.I1 = vRemap[Triangle.I1];
+				Triangle.I2 = vRemap[Triangle.I2];
+			}
+		}
+	}
+	Statistics.After = CMeshOptimizer::AnalyzeVertexCache(vIndices, KVertexCount);
+
+	memcpy(&Mesh.vTriangles[0], &vIndices[0], sizeof(uint32_t) * vIndices.size());
+	if (PtrOutVertexRemap) PtrOutVertexRemap->swap(vRemap);
+	return Statistics;
+}
+
 static std::vector<STriangle> GenerateContinuousQuads(int QuadCount)
 {
 	std::vector<STriangle> vTriangles{};
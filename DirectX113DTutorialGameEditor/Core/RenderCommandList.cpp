@@ -0,0 +1,232 @@
+#include "RenderCommandList.h"
+#include "TaskScheduler.h"
+#include <chrono>
+
+using std::vector;
+
+void CNullRenderBackend::SetShaderSet(uint32_t ShaderSet)
+{
+	++m_CommandCounts[(size_t)ERenderCommandType::SetShaderSet];
+}
+
+void CNullRenderBackend::SetObjectStates(uint32_t ObjectIndex)
+{
+	++m_CommandCounts[(size_t)ERenderCommandType::SetObjectStates];
+}
+
+void CNullRenderBackend::SetMaterial(uint32_t ObjectIndex, uint32_t MeshIndex)
+{
+	++m_CommandCounts[(size_t)ERenderCommandType::SetMaterial];
+}
+
+void CNullRenderBackend::DrawMesh(uint32_t ObjectIndex, uint32_t MeshIndex)
+{
+	++m_CommandCounts[(size_t)ERenderCommandType::DrawMesh];
+}
+
+void CNullRenderBackend::ResetCounters()
+{
+	for (auto& CommandCount : m_CommandCounts) CommandCount = 0;
+}
+
+uint32_t CNullRenderBackend::GetCommandCount(ERenderCommandType eType) const
+{
+	assert(eType < ERenderCommandType::COUNT);
+
+	return m_CommandCounts[(size_t)eType];
+}
+
+void CRenderCommandList::Clear()
+{
+	m_vCommands.clear();
+	for (auto& CommandCount : m_CommandCounts) CommandCount = 0;
+
+	m_StateTracker.Invalidate();
+	m_StateTracker.ResetCounters();
+}
+
+void CRenderCommandList::RecordSetShaderSet(uint32_t ShaderSet)
+{
+	m_vCommands.emplace_back(SRenderCommand{ ERenderCommandType::SetShaderSet, 0, 0, ShaderSet });
+	++m_CommandCounts[(size_t)ERenderCommandType::SetShaderSet];
+}
+
+void CRenderCommandList::RecordSetObjectStates(uint32_t ObjectIndex)
+{
+	m_vCommands.emplace_back(SRenderCommand{ ERenderCommandType::SetObjectStates, ObjectIndex, 0, 0 });
+	++m_CommandCounts[(size_t)ERenderCommandType::SetObjectStates];
+}
+
+void CRenderCommandList::RecordSetMaterial(uint32_t ObjectIndex, uint32_t MeshIndex)
+{
+	m_vCommands.emplace_back(SRenderCommand{ ERenderCommandType::SetMaterial, ObjectIndex, MeshIndex, 0 });
+	++m_CommandCounts[(size_t)ERenderCommandType::SetMaterial];
+}
+
+void CRenderCommandList::RecordDrawMesh(uint32_t ObjectIndex, uint32_t MeshIndex)
+{
+	m_vCommands.emplace_back(SRenderCommand{ ERenderCommandType::DrawMesh, ObjectIndex, MeshIndex, 0 });
+	++m_CommandCounts[(size_t)ERenderCommandType::DrawMesh];
+}
+
+void CRenderCommandList::RecordDrawPackets(const vector<SDrawPacket>& vPackets)
+{
+	m_vCommands.reserve(m_vCommands.size() + vPackets.size() * 2);
+	for (const SDrawPacket& Packet : vPackets)
+	{
+		uint32_t ShaderSet{ CDrawPacketQueue::GetShaderSet(Packet.SortKey) };
+		if (m_StateTracker.ShouldSetShaderSet(ShaderSet)) RecordSetShaderSet(ShaderSet);
+
+		if (m_StateTracker.ShouldSetObject(Packet.ObjectIndex)) RecordSetObjectStates(Packet.ObjectIndex);
+
+		if (m_StateTracker.ShouldSetMaterialSet(CDrawPacketQueue::GetMaterialSet(Packet.SortKey)))
+		{
+			RecordSetMaterial(Packet.ObjectIndex, Packet.MeshIndex);
+		}
+
+		RecordDrawMesh(Packet.ObjectIndex, Packet.MeshIndex);
+	}
+}
+
+void CRenderCommandList::Replay(CRenderBackend& Backend) const
+{
+	for (const SRenderCommand& Command : m_vCommands)
+	{
+		switch (Command.eType)
+		{
+		case ERenderCommandType::SetShaderSet:
+			Backend.SetShaderSet(Command.ShaderSet);
+			break;
+		case ERenderCommandType::SetObjectStates:
+			Backend.SetObjectStates(Command.ObjectIndex);
+			break;
+		case ERenderCommandType::SetMaterial:
+			Backend.SetMaterial(Command.ObjectIndex, Command.MeshIndex);
+			break;
+		case ERenderCommandType::DrawMesh:
+			Backend.DrawMesh(Command.ObjectIndex, Command.MeshIndex);
+			break;
+		default:
+			assert(false);
+			break;
+		}
+	}
+}
+
+const vector<SRenderCommand>& CRenderCommandList::GetCommands() const
+{
+	return m_vCommands;
+}
+
+uint32_t CRenderCommandList::GetCommandCount(ERenderCommandType eType) const
+{
+	assert(eType < ERenderCommandType::COUNT);
+
+	return m_CommandCounts[(size_t)eType];
+}
+
+const CDrawStateTracker& CRenderCommandList::GetStateTracker() const
+{
+	return m_StateTracker;
+}
+
+void CRenderCommandList::RecordInParallel(vector<CRenderCommandList>& vLists,
+	const std::function<void(size_t, CRenderCommandList&)>& Record, CTaskScheduler& TaskScheduler)
+{
+	const size_t KListCount{ vLists.size() };
+	if (KListCount == 0) return;
+
+	if (KListCount == 1)
+	{
+		Record(0, vLists[0]);
+		return;
+	}
+
+	TaskScheduler.Reset();
+	for (size_t iList = 0; iList < KListCount; ++iList)
+	{
+		TaskScheduler.AddTask([&, iList]() { Record(iList, vLists[iList]); });
+	}
+	TaskScheduler.Start();
+	TaskScheduler.Wait(true); // @important: the calling thread works, too
+}
+
+double CRenderCommandList::MeasureRecordTime(uint32_t ListCount, uint32_t PacketCount, uint32_t IterationCount, uint32_t ThreadCount)
+{
+	if (ListCount == 0 || PacketCount == 0 || IterationCount == 0) return 0.0;
+
+	// @important: fixed seed (xorshift), so that the results are comparable between runs
+	uint64_t State{ 0x9E3779B97F4A7C15 };
+	auto Random{ [&State]()
+		{
+			State ^= State << 13;
+			State ^= State >> 7;
+			State ^= State << 17;
+			return State;
+		}
+	};
+
+	// A realistic distribution: few shader sets, a few meshes per object, random depth
+	vector<vector<uint64_t>> vvSortKeys(ListCount, vector<uint64_t>(PacketCount));
+	for (auto& vSortKeys : vvSortKeys)
+	{
+		for (auto& SortKey : vSortKeys)
+		{
+			uint64_t Bits{ Random() };
+			SortKey = CDrawPacketQueue::MakeSortKey(0, (uint32_t)(Bits & 0x3F), (uint32_t)((Bits >> 8) & 0xFFFF), (uint32_t)((Bits >> 32) & 0xFFFF));
+		}
+	}
+
+	vector<CRenderCommandList> vLists(ListCount);
+	vector<CDrawPacketQueue> vQueues(ListCount);
+	auto Record{ [&](size_t iList, CRenderCommandList& List)
+		{
+			CDrawPacketQueue& Queue{ vQueues[iList] };
+			Queue.Clear();
+			for (uint32_t iPacket = 0; iPacket < PacketCount; ++iPacket)
+			{
+				Queue.Push(vvSortKeys[iList][iPacket], iPacket / 4, iPacket % 4);
+			}
+			Queue.Sort();
+
+			List.Clear();
+			List.RecordDrawPackets(Queue.GetPackets());
+		}
+	};
+
+	// @important: the workers are created before the measurement, as they are kept between frames in the game
+	CTaskScheduler TaskScheduler{};
+	if (ThreadCount != 1)
+	{
+		TaskScheduler.Start((ThreadCount) ? ThreadCount - 1 : 0);
+		TaskScheduler.Wait();
+	}
+
+	double TotalMicroseconds{};
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
+	{
+		auto StartTimePoint{ std::chrono::steady_clock::now() };
+		if (ThreadCount == 1)
+		{
+			for (size_t iList = 0; iList < vLists.size(); ++iList)
+			{
+				Record(iList, vLists[iList]);
+			}
+		}
+		else
+		{
+			RecordInParallel(vLists, Record, TaskScheduler);
+		}
+		TotalMicroseconds += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - StartTimePoint).count();
+	}
+
+	// @important: every packet must have been recorded as one draw
+	CNullRenderBackend NullBackend{};
+	for (const auto& List : vLists)
+	{
+		List.Replay(NullBackend);
+	}
+	assert(NullBackend.GetCommandCount(ERenderCommandType::DrawMesh) == ListCount * PacketCount);
+
+	return TotalMicroseconds / IterationCount;
+}
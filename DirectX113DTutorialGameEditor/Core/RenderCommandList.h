@@ -0,0 +1,109 @@
+#pragma once
+
+// @important: pure CPU (objects are referred to by index), so that it can be recorded on any thread and replayed by any backend
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cassert>
+#include "DrawPacket.h"
+
+class CTaskScheduler;
+
+enum class ERenderCommandType : uint8_t
+{
+	SetShaderSet,
+	SetObjectStates, // constant buffer updates of the object
+	SetMaterial, // constant buffer update and textures of the mesh material
+	DrawMesh,
+
+	COUNT
+};
+
+struct SRenderCommand
+{
+	ERenderCommandType	eType{};
+	uint32_t			ObjectIndex{};
+	uint32_t			MeshIndex{};
+	uint32_t			ShaderSet{};
+};
+
+// What the recorded commands are replayed on
+class CRenderBackend
+{
+public:
+	CRenderBackend() {}
+	virtual ~CRenderBackend() {}
+
+public:
+	virtual void SetShaderSet(uint32_t ShaderSet) = 0;
+	virtual void SetObjectStates(uint32_t ObjectIndex) = 0;
+	virtual void SetMaterial(uint32_t ObjectIndex, uint32_t MeshIndex) = 0;
+	virtual void DrawMesh(uint32_t ObjectIndex, uint32_t MeshIndex) = 0;
+};
+
+// Only counts the commands, so that a frame can be recorded and replayed without any device
+class CNullRenderBackend final : public CRenderBackend
+{
+public:
+	CNullRenderBackend() {}
+	~CNullRenderBackend() {}
+
+public:
+	void SetShaderSet(uint32_t ShaderSet) override;
+	void SetObjectStates(uint32_t ObjectIndex) override;
+	void SetMaterial(uint32_t ObjectIndex, uint32_t MeshIndex) override;
+	void DrawMesh(uint32_t ObjectIndex, uint32_t MeshIndex) override;
+
+public:
+	void ResetCounters();
+	uint32_t GetCommandCount(ERenderCommandType eType) const;
+
+private:
+	uint32_t	m_CommandCounts[(size_t)ERenderCommandType::COUNT]{};
+};
+
+// Commands of one pass, recorded from sorted draw packets with the redundant state sets already skipped
+// @important: each recording thread must own its list (and its draw packet queue)
+class CRenderCommandList
+{
+public:
+	CRenderCommandList() {}
+	~CRenderCommandList() {}
+
+public:
+	// @important: also forgets the recorded states, as the list may be replayed after someone else set them
+	void Clear();
+
+	void RecordSetShaderSet(uint32_t ShaderSet);
+	void RecordSetObjectStates(uint32_t ObjectIndex);
+	void RecordSetMaterial(uint32_t ObjectIndex, uint32_t MeshIndex);
+	void RecordDrawMesh(uint32_t ObjectIndex, uint32_t MeshIndex);
+
+	// Packets must be sorted (see CDrawPacketQueue::Sort())
+	void RecordDrawPackets(const std::vector<SDrawPacket>& vPackets);
+
+	void Replay(CRenderBackend& Backend) const;
+
+public:
+	const std::vector<SRenderCommand>& GetCommands() const;
+	uint32_t GetCommandCount(ERenderCommandType eType) const;
+	// State changes recorded by RecordDrawPackets()
+	const CDrawStateTracker& GetStateTracker() const;
+
+public:
+	// Calls Record(ListIndex, List) once for every list, spread over the workers of TaskScheduler and the calling thread
+	// A single list is recorded on the calling thread alone
+	// @important: TaskScheduler must not be running another batch, and it's reset before the lists are added
+	static void RecordInParallel(std::vector<CRenderCommandList>& vLists,
+		const std::function<void(size_t, CRenderCommandList&)>& Record, CTaskScheduler& TaskScheduler);
+
+	// Sorts and records ListCount lists of PacketCount random packets IterationCount times
+	// and returns the average time in microseconds
+	// ThreadCount 0 means one per hardware thread, 1 records on the calling thread alone
+	static double MeasureRecordTime(uint32_t ListCount, uint32_t PacketCount, uint32_t IterationCount, uint32_t ThreadCount = 0);
+
+private:
+	std::vector<SRenderCommand>	m_vCommands{};
+	uint32_t					m_CommandCounts[(size_t)ERenderCommandType::COUNT]{};
+	CDrawStateTracker			m_StateTracker{};
+};
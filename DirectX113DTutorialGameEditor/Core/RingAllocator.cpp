@@ -0,0 +1,108 @@
+#include "RingAllocator.h"
+
+void CRingAllocator::Create(uint32_t ByteCapacity, uint32_t Alignment)
+{
+	assert(Alignment && (Alignment & (Alignment - 1)) == 0);
+	assert(ByteCapacity >= Alignment);
+
+	m_Alignment = Alignment;
+	m_ByteCapacity = ByteCapacity & ~(Alignment - 1);
+
+	m_Head = 0;
+	m_Tail = 0;
+	m_UsedByteSize = 0;
+	m_FrameByteSize = 0;
+	m_dqPendingFrames.clear();
+}
+
+bool CRingAllocator::Allocate(uint32_t ByteSize, uint32_t& OutOffset)
+{
+	const uint32_t KAlignedByteSize{ (ByteSize + m_Alignment - 1) & ~(m_Alignment - 1) };
+	if (KAlignedByteSize == 0 || KAlignedByteSize > m_ByteCapacity) return false;
+	if (m_UsedByteSize == m_ByteCapacity) return false;
+
+	if (m_Head >= m_Tail)
+	{
+		// Free: [Head, Capacity) and [0, Tail)
+		if (m_ByteCapacity - m_Head >= KAlignedByteSize)
+		{
+			OutOffset = m_Head;
+		}
+		else if (m_Tail >= KAlignedByteSize)
+		{
+			// @important: wrap around, the bytes left at the end belong to this frame so that they're retired together
+			uint32_t SkippedByteSize{ m_ByteCapacity - m_Head };
+			m_UsedByteSize += SkippedByteSize;
+			m_FrameByteSize += SkippedByteSize;
+			OutOffset = 0;
+		}
+		else
+		{
+			return false;
+		}
+	}
+	else
+	{
+		// Free: [Head, Tail)
+		if (m_Tail - m_Head < KAlignedByteSize) return false;
+		OutOffset = m_Head;
+	}
+
+	m_Head = OutOffset + KAlignedByteSize;
+	if (m_Head == m_ByteCapacity) m_Head = 0;
+	m_UsedByteSize += KAlignedByteSize;
+	m_FrameByteSize += KAlignedByteSize;
+	return true;
+}
+
+void CRingAllocator::EndFrame(uint64_t FenceValue)
+{
+	assert(m_dqPendingFrames.empty() || m_dqPendingFrames.back().FenceValue < FenceValue);
+
+	m_dqPendingFrames.emplace_back(SFrame{ FenceValue, m_FrameByteSize, m_Head });
+	m_FrameByteSize = 0;
+}
+
+void CRingAllocator::Retire(uint64_t CompletedFenceValue)
+{
+	while (m_dqPendingFrames.size() && m_dqPendingFrames.front().FenceValue <= CompletedFenceValue)
+	{
+		const SFrame& Frame{ m_dqPendingFrames.front() };
+		m_UsedByteSize -= Frame.ByteSize;
+		m_Tail = Frame.EndOffset;
+		m_dqPendingFrames.pop_front();
+	}
+
+	// @important: restart from the beginning when nothing is in flight, so that fewer allocations need to wrap
+	if (m_UsedByteSize == 0)
+	{
+		m_Head = 0;
+		m_Tail = 0;
+	}
+}
+
+bool CRingAllocator::HasPendingFrame() const
+{
+	return !m_dqPendingFrames.empty();
+}
+
+uint64_t CRingAllocator::GetOldestPendingFenceValue() const
+{
+	assert(HasPendingFrame());
+	return m_dqPendingFrames.front().FenceValue;
+}
+
+uint32_t CRingAllocator::GetByteCapacity() const
+{
+	return m_ByteCapacity;
+}
+
+uint32_t CRingAllocator::GetUsedByteSize() const
+{
+	return m_UsedByteSize;
+}
+
+uint32_t CRingAllocator::GetAlignment() const
+{
+	return m_Alignment;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+// @important: pure CPU (offsets and fence values only), so that it doesn't depend on any device
+#include <deque>
+#include <cstdint>
+#include <cassert>
+
+// Linear sub-allocator over a ring of ByteCapacity bytes
+// Allocations of a frame are fenced by EndFrame() and can't be overwritten until Retire() is called with that fence value
+class CRingAllocator
+{
+	struct SFrame
+	{
+		uint64_t	FenceValue{};
+		uint32_t	ByteSize{};		// including the bytes skipped by wrapping
+		uint32_t	EndOffset{};
+	};
+
+public:
+	CRingAllocator() {}
+	~CRingAllocator() {}
+
+public:
+	// Alignment must be a power of 2
+	void Create(uint32_t ByteCapacity, uint32_t Alignment);
+
+	// Returns false when the ring is full (the caller may retire frames and try again)
+	bool Allocate(uint32_t ByteSize, uint32_t& OutOffset);
+
+	// FenceValue must increase monotonically
+	void EndFrame(uint64_t FenceValue);
+
+	// Frees all the frames whose fence value <= CompletedFenceValue
+	void Retire(uint64_t CompletedFenceValue);
+
+public:
+	bool HasPendingFrame() const;
+	uint64_t GetOldestPendingFenceValue() const;
+	uint32_t GetByteCapacity() const;
+	uint32_t GetUsedByteSize() const;
+	uint32_t GetAlignment() const;
+
+private:
+	uint32_t			m_ByteCapacity{};
+	uint32_t			m_Alignment{ 1 };
+
+	uint32_t			m_Head{};			// next allocation
+	uint32_t			m_Tail{};			// oldest byte in flight
+	uint32_t			m_UsedByteSize{};
+	uint32_t			m_FrameByteSize{};	// current frame
+
+	std::deque<SFrame>	m_dqPendingFrames{};
+};
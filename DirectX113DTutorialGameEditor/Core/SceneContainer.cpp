@@ -0,0 +1,605 @@
+#include "SceneContainer.h"
+#include <cstring>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+
+using std::string;
+using std::vector;
+
+void CSceneContainer::AddChunk(ESceneChunkType eType, CBinaryData& ChunkData)
+{
+	AddChunk(eType, ChunkData.MoveBytes());
+}
+
+void CSceneContainer::AddChunk(ESceneChunkType eType, vector<byte>&& vChunkBytes)
+{
+	assert(eType < ESceneChunkType::COUNT);
+
+	SChunk Chunk{};
+	Chunk.eType = eType;
+
+	m_vChunkIndicesByType[(size_t)eType].emplace_back((uint32_t)m_vChunks.size());
+	m_vChunks.emplace_back(Chunk);
+	m_vChunkBytes.emplace_back(std::move(vChunkBytes));
+	m_vIsChunkCached.emplace_back(false);
+}
+
+void CSceneContainer::AddCachedChunk(ESceneChunkType eType, uint64_t RawHash)
+{
+	assert(eType < ESceneChunkType::COUNT);
+
+	SChunk Chunk{};
+	Chunk.eType = eType;
+	Chunk.RawHash = RawHash;
+
+	m_vChunkIndicesByType[(size_t)eType].emplace_back((uint32_t)m_vChunks.size());
+	m_vChunks.emplace_back(Chunk);
+	m_vChunkBytes.emplace_back();
+	m_vIsChunkCached.emplace_back(true);
+}
+
+bool CSceneContainer::SaveToFile(const string& FileName, bool bShouldCompress, SSaveCache* const PtrSaveCache)
+{
+	assert(m_vChunks.size() == m_vChunkBytes.size());
+	assert(m_vChunks.size() == m_vIsChunkCached.size());
+
+	// @important: what a chunk is stored as depends on the compression, so a cache filled with another one is of no use
+	if (PtrSaveCache && PtrSaveCache->bIsCompressing != bShouldCompress)
+	{
+		*PtrSaveCache = SSaveCache();
+		PtrSaveCache->bIsCompressing = bShouldCompress;
+	}
+
+	// @important: the stored bytes of the unchanged chunks are copied from the file of the last save,
+	// as long as it hasn't been changed since (the same size and table of contents)
+	CMappedFile LastFile{};
+	if (PtrSaveCache && !PtrSaveCache->umapStoredChunks.empty() && LastFile.Open(PtrSaveCache->FileName))
+	{
+		if (LastFile.GetSize() != PtrSaveCache->FileByteCount || PtrSaveCache->TableOfContentsEnd > LastFile.GetSize() ||
+			HashBytes(LastFile.GetData(), (size_t)PtrSaveCache->TableOfContentsEnd) != PtrSaveCache->FileHash)
+		{
+			LastFile.Close();
+		}
+	}
+
+	// Stored bytes of each chunk: its own, its frame, or those of the same raw bytes in the last file
+	vector<const byte*> vPtrStoredBytes(m_vChunks.size());
+	vector<bool> vIsHashed(m_vChunks.size());
+	uint32_t DirtyChunkCount{};
+	vector<byte> vFrame{};
+	for (size_t iChunk = 0; iChunk < m_vChunks.size(); ++iChunk)
+	{
+		SChunk& Chunk{ m_vChunks[iChunk] };
+		vector<byte>& vBytes{ m_vChunkBytes[iChunk] };
+		vPtrStoredBytes[iChunk] = vBytes.data();
+		Chunk.ByteCount = vBytes.size();
+
+		if (PtrSaveCache && !Chunk.bIsCompressed)
+		{
+			if (!m_vIsChunkCached[iChunk]) Chunk.RawHash = HashRawBytes(vBytes.data(), vBytes.size());
+
+			auto found{ PtrSaveCache->umapStoredChunks.find(Chunk.RawHash) };
+			const SSaveCache::SStoredChunk* PtrStoredChunk{ (found != PtrSaveCache->umapStoredChunks.end()) ? &found->second : nullptr };
+			if (PtrStoredChunk && !m_vIsChunkCached[iChunk] && PtrStoredChunk->RawByteCount != vBytes.size()) PtrStoredChunk = nullptr;
+
+			// @important: uncompressed chunks that are still serialized need nothing from the last file
+			const bool KNeedsLastFile{ PtrStoredChunk && (PtrStoredChunk->bIsCompressed || m_vIsChunkCached[iChunk]) };
+			if (KNeedsLastFile && (!LastFile.IsOpen() || PtrStoredChunk->Offset > LastFile.GetSize() ||
+				PtrStoredChunk->ByteCount > LastFile.GetSize() - PtrStoredChunk->Offset))
+			{
+				PtrStoredChunk = nullptr;
+			}
+
+			if (PtrStoredChunk)
+			{
+				if (KNeedsLastFile)
+				{
+					Chunk.bIsCompressed = PtrStoredChunk->bIsCompressed;
+					Chunk.RawByteCount = PtrStoredChunk->RawByteCount;
+					Chunk.ByteCount = PtrStoredChunk->ByteCount;
+					vPtrStoredBytes[iChunk] = LastFile.GetData() + PtrStoredChunk->Offset;
+				}
+				Chunk.Hash = PtrStoredChunk->Hash;
+				vIsHashed[iChunk] = true;
+				continue;
+			}
+		}
+
+		// @important: a cached chunk has no bytes to fall back on
+		if (m_vIsChunkCached[iChunk])
+		{
+			if (PtrSaveCache)
+			{
+				*PtrSaveCache = SSaveCache();
+				PtrSaveCache->bIsCompressing = bShouldCompress;
+			}
+			return false;
+		}
+		++DirtyChunkCount;
+
+		// @important: chunks that compress are replaced by their frames, so the container can't be saved uncompressed afterwards
+		if (!bShouldCompress || Chunk.bIsCompressed || vBytes.size() < KMinCompressedChunkByteCount) continue;
+
+		CLZCodec::Compress(vBytes.data(), vBytes.size(), vFrame);
+		if (vFrame.size() >= vBytes.size()) continue;
+
+		Chunk.bIsCompressed = true;
+		Chunk.RawByteCount = vBytes.size();
+		vBytes.swap(vFrame);
+		vPtrStoredBytes[iChunk] = vBytes.data();
+		Chunk.ByteCount = vBytes.size();
+	}
+
+	// Lay out the chunks after the table of contents
+	const uint64_t KTableOfContentsEnd{ KHeaderByteCount + KChunkEntryByteCount * m_vChunks.size() };
+	uint64_t Offset{ KTableOfContentsEnd };
+	for (size_t iChunk = 0; iChunk < m_vChunks.size(); ++iChunk)
+	{
+		SChunk& Chunk{ m_vChunks[iChunk] };
+
+		Offset = (Offset + KChunkAlignment - 1) / KChunkAlignment * KChunkAlignment;
+
+		Chunk.Offset = Offset;
+		if (!Chunk.bIsCompressed) Chunk.RawByteCount = Chunk.ByteCount;
+		if (!vIsHashed[iChunk]) Chunk.Hash = HashBytes(vPtrStoredBytes[iChunk], (size_t)Chunk.ByteCount);
+
+		Offset += Chunk.ByteCount;
+	}
+
+	CBinaryData FileBinary{};
+
+	// 8B (string) Signature
+	FileBinary.WriteString(KSignature, KSignatureLength);
+
+	// 4B (in total) Version
+	FileBinary.WriteUint16(KVersionMajor);
+	FileBinary.WriteUint8(KVersionMinor);
+	FileBinary.WriteUint8(KVersionSubminor);
+
+	// 4B (uint32_t) Chunk count
+	FileBinary.WriteUint32((uint32_t)m_vChunks.size());
+
+	// Table of contents
+	for (const SChunk& Chunk : m_vChunks)
+	{
+		// 4B (uint32_t, enum) Chunk type
+		FileBinary.WriteUint32((uint32_t)Chunk.eType);
+
+		// 4B (uint32_t) Is compressed
+		FileBinary.WriteUint32((Chunk.bIsCompressed) ? 1 : 0);
+
+		// 8B (uint64_t) Offset
+		FileBinary.WriteUint64(Chunk.Offset);
+
+		// 8B (uint64_t) Byte count (stored)
+		FileBinary.WriteUint64(Chunk.ByteCount);
+
+		// 8B (uint64_t) Raw byte count
+		FileBinary.WriteUint64(Chunk.RawByteCount);
+
+		// 8B (uint64_t) Hash
+		FileBinary.WriteUint64(Chunk.Hash);
+	}
+
+	// @important: the table of contents hashes every chunk, so the same one means the same file
+	const uint64_t KFileHash{ HashBytes(FileBinary.GetBytes().data(), FileBinary.GetBytes().size()) };
+	const bool KShouldWrite{ !PtrSaveCache || !LastFile.IsOpen() || PtrSaveCache->FileName != FileName || PtrSaveCache->FileHash != KFileHash };
+	if (KShouldWrite)
+	{
+		FileBinary.Reserve((size_t)Offset);
+
+		// Chunks
+		const vector<byte> vPadding(KChunkAlignment);
+		for (size_t iChunk = 0; iChunk < m_vChunks.size(); ++iChunk)
+		{
+			size_t PaddingByteCount{ (size_t)m_vChunks[iChunk].Offset - FileBinary.GetBytes().size() };
+			if (PaddingByteCount) FileBinary.WriteArray(vPadding.data(), PaddingByteCount, 1);
+
+			if (m_vChunks[iChunk].ByteCount) FileBinary.WriteArray(vPtrStoredBytes[iChunk], (size_t)m_vChunks[iChunk].ByteCount, 1);
+		}
+
+		// @important: the last file can't be replaced while it's mapped
+		LastFile.Close();
+
+		if (!FileBinary.SaveToFile(FileName))
+		{
+			if (PtrSaveCache)
+			{
+				*PtrSaveCache = SSaveCache();
+				PtrSaveCache->bIsCompressing = bShouldCompress;
+			}
+			return false;
+		}
+	}
+
+	if (PtrSaveCache)
+	{
+		// Only the chunks of this save are kept
+		SSaveCache NewSaveCache{};
+		NewSaveCache.bIsCompressing = bShouldCompress;
+		NewSaveCache.FileName = FileName;
+		NewSaveCache.FileByteCount = Offset;
+		NewSaveCache.TableOfContentsEnd = KTableOfContentsEnd;
+		NewSaveCache.FileHash = KFileHash;
+		NewSaveCache.LastChunkCount = (uint32_t)m_vChunks.size();
+		NewSaveCache.LastDirtyChunkCount = DirtyChunkCount;
+		NewSaveCache.bWasLastFileWritten = KShouldWrite;
+		for (const SChunk& Chunk : m_vChunks)
+		{
+			// @important: chunks that were compressed by a save without the cache have no raw hash
+			if (Chunk.RawHash == 0) continue;
+			if (NewSaveCache.umapStoredChunks.count(Chunk.RawHash)) continue;
+
+			SSaveCache::SStoredChunk& StoredChunk{ NewSaveCache.umapStoredChunks[Chunk.RawHash] };
+			StoredChunk.RawByteCount = Chunk.RawByteCount;
+			StoredChunk.bIsCompressed = Chunk.bIsCompressed;
+			StoredChunk.Offset = Chunk.Offset;
+			StoredChunk.ByteCount = Chunk.ByteCount;
+			StoredChunk.Hash = Chunk.Hash;
+		}
+		*PtrSaveCache = std::move(NewSaveCache);
+	}
+
+	return true;
+}
+
+bool CSceneContainer::Open(const string& FileName)
+{
+	Close();
+
+	if (!m_MappedFile.Open(FileName)) return false;
+
+	const byte* const Data{ m_MappedFile.GetData() };
+	const size_t KFileByteCount{ m_MappedFile.GetSize() };
+	if (KFileByteCount < KHeaderByteCount || memcmp(Data, KSignature, KSignatureLength) != 0)
+	{
+		Close();
+		return false;
+	}
+
+	CBinaryData HeaderBinary{};
+	HeaderBinary.SetReadView(Data, KFileByteCount);
+
+	// 8B (string) Signature
+	HeaderBinary.ReadSkip(KSignatureLength);
+
+	// 4B (in total) Version
+	uint16_t VersionMajor{ HeaderBinary.ReadUint16() };
+	uint8_t VersionMinor{ HeaderBinary.ReadUint8() };
+	uint8_t VersionSubminor{ HeaderBinary.ReadUint8() };
+	uint32_t Version{ (uint32_t)(VersionSubminor | (VersionMinor << 8) | (VersionMajor << 16)) };
+	if (Version > (uint32_t)(KVersionSubminor | (KVersionMinor << 8) | (KVersionMajor << 16)))
+	{
+		Close();
+		return false;
+	}
+
+	m_Version = Version;
+
+	// @important: version 1.0.0 has no compression fields
+	const bool KHasCompression{ Version >= (uint32_t)((0x01 << 8) | (0x0001 << 16)) };
+	const size_t KEntryByteCount{ (KHasCompression) ? KChunkEntryByteCount : KChunkEntryByteCountV100 };
+
+	// 4B (uint32_t) Chunk count
+	uint32_t ChunkCount{ HeaderBinary.ReadUint32() };
+	if (ChunkCount > (KFileByteCount - KHeaderByteCount) / KEntryByteCount)
+	{
+		Close();
+		return false;
+	}
+
+	m_vChunks.resize(ChunkCount);
+	for (uint32_t iChunk = 0; iChunk < ChunkCount; ++iChunk)
+	{
+		SChunk& Chunk{ m_vChunks[iChunk] };
+
+		Chunk.eType = (ESceneChunkType)HeaderBinary.ReadUint32();
+		if (KHasCompression) Chunk.bIsCompressed = (HeaderBinary.ReadUint32() != 0);
+		HeaderBinary.ReadUint64(Chunk.Offset);
+		HeaderBinary.ReadUint64(Chunk.ByteCount);
+		Chunk.RawByteCount = Chunk.ByteCount;
+		if (KHasCompression) HeaderBinary.ReadUint64(Chunk.RawByteCount);
+		HeaderBinary.ReadUint64(Chunk.Hash);
+
+		if (Chunk.Offset > KFileByteCount || Chunk.ByteCount > KFileByteCount - Chunk.Offset ||
+			(!Chunk.bIsCompressed && Chunk.RawByteCount != Chunk.ByteCount))
+		{
+			Close();
+			return false;
+		}
+
+		// @important: unknown (newer) chunk types are kept in the table of contents but never read
+		if (Chunk.eType < ESceneChunkType::COUNT) m_vChunkIndicesByType[(size_t)Chunk.eType].emplace_back(iChunk);
+	}
+
+	return true;
+}
+
+void CSceneContainer::Close()
+{
+	m_vChunks.clear();
+	for (auto& vChunkIndices : m_vChunkIndicesByType) vChunkIndices.clear();
+	m_vChunkBytes.clear();
+	m_vIsChunkCached.clear();
+	m_Version = 0;
+
+	m_MappedFile.Close();
+}
+
+bool CSceneContainer::ReadChunk(ESceneChunkType eType, CBinaryData& Out, uint32_t Index, bool bShouldVerifyHash) const
+{
+	const SChunk* const Chunk{ GetChunk(eType, Index) };
+	if (!Chunk || !IsOpen())
+	{
+		Out.Clear();
+		return false;
+	}
+
+	const byte* const Data{ m_MappedFile.GetData() + Chunk->Offset };
+	if (bShouldVerifyHash && HashBytes(Data, (size_t)Chunk->ByteCount) != Chunk->Hash)
+	{
+		Out.Clear();
+		return false;
+	}
+
+	if (Chunk->bIsCompressed)
+	{
+		// @important: decompressing is const, so chunks can be read from several threads at once (see CSceneDecoder)
+		uint64_t RawByteCount{};
+		if (!CLZCodec::GetRawByteCount(Data, (size_t)Chunk->ByteCount, RawByteCount) || RawByteCount != Chunk->RawByteCount)
+		{
+			Out.Clear();
+			return false;
+		}
+		return Out.Decompress(Data, (size_t)Chunk->ByteCount);
+	}
+
+	Out.SetReadView(Data, (size_t)Chunk->ByteCount);
+	return true;
+}
+
+bool CSceneContainer::Verify() const
+{
+	if (!IsOpen()) return false;
+
+	for (const SChunk& Chunk : m_vChunks)
+	{
+		if (HashBytes(m_MappedFile.GetData() + Chunk.Offset, (size_t)Chunk.ByteCount) != Chunk.Hash) return false;
+	}
+	return true;
+}
+
+bool CSceneContainer::FillSaveCache(const string& FileName, bool bShouldCompress, SSaveCache& Out)
+{
+	Out = SSaveCache();
+	Out.bIsCompressing = bShouldCompress;
+	if (!IsOpen()) return false;
+
+	CBinaryData ChunkBinary{};
+	for (SChunk& Chunk : m_vChunks)
+	{
+		const byte* const KStoredBytes{ m_MappedFile.GetData() + Chunk.Offset };
+		const byte* RawBytes{ KStoredBytes };
+		if (Chunk.bIsCompressed)
+		{
+			if (!ChunkBinary.Decompress(KStoredBytes, (size_t)Chunk.ByteCount) || ChunkBinary.GetBytes().size() != Chunk.RawByteCount) continue;
+			RawBytes = ChunkBinary.GetBytes().data();
+		}
+		Chunk.RawHash = HashRawBytes(RawBytes, (size_t)Chunk.RawByteCount);
+
+		// @important: a save would compress large chunks if it compresses at all, so the other ones wouldn't be stored the same way
+		const bool KWouldBeCompressed{ bShouldCompress && Chunk.RawByteCount >= KMinCompressedChunkByteCount };
+		if (Chunk.bIsCompressed != KWouldBeCompressed) continue;
+
+		SSaveCache::SStoredChunk& StoredChunk{ Out.umapStoredChunks[Chunk.RawHash] };
+		StoredChunk.RawByteCount = Chunk.RawByteCount;
+		StoredChunk.bIsCompressed = Chunk.bIsCompressed;
+		StoredChunk.Offset = Chunk.Offset;
+		StoredChunk.ByteCount = Chunk.ByteCount;
+		StoredChunk.Hash = Chunk.Hash;
+	}
+
+	// @important: an older table of contents is hashed as well, it can't match one that's written now but it still tells a changed file
+	const size_t KEntryByteCount{ (m_Version >= (uint32_t)((0x01 << 8) | (0x0001 << 16))) ? KChunkEntryByteCount : KChunkEntryByteCountV100 };
+	Out.FileName = FileName;
+	Out.FileByteCount = m_MappedFile.GetSize();
+	Out.TableOfContentsEnd = KHeaderByteCount + KEntryByteCount * m_vChunks.size();
+	Out.FileHash = HashBytes(m_MappedFile.GetData(), (size_t)Out.TableOfContentsEnd);
+	return true;
+}
+
+bool CSceneContainer::IsOpen() const
+{
+	return m_MappedFile.IsOpen();
+}
+
+const vector<CSceneContainer::SChunk>& CSceneContainer::GetChunks() const
+{
+	return m_vChunks;
+}
+
+uint32_t CSceneContainer::GetChunkCount(ESceneChunkType eType) const
+{
+	assert(eType < ESceneChunkType::COUNT);
+
+	return (uint32_t)m_vChunkIndicesByType[(size_t)eType].size();
+}
+
+uint64_t CSceneContainer::GetChunkRawHash(ESceneChunkType eType, uint32_t Index) const
+{
+	const SChunk* const Chunk{ GetChunk(eType, Index) };
+	return (Chunk) ? Chunk->RawHash : 0;
+}
+
+bool CSceneContainer::IsSceneContainer(const string& FileName)
+{
+	CMappedFile MappedFile{};
+	if (!MappedFile.Open(FileName)) return false;
+	if (MappedFile.GetSize() < KHeaderByteCount) return false;
+
+	return (memcmp(MappedFile.GetData(), KSignature, KSignatureLength) == 0);
+}
+
+uint64_t CSceneContainer::HashBytes(const byte* const Data, size_t ByteCount)
+{
+	static constexpr uint64_t KOffsetBasis{ 0xCBF29CE484222325 };
+	static constexpr uint64_t KPrime{ 0x100000001B3 };
+
+	uint64_t Hash{ KOffsetBasis };
+	for (size_t iByte = 0; iByte < ByteCount; ++iByte)
+	{
+		Hash ^= Data[iByte];
+		Hash *= KPrime;
+	}
+	return Hash;
+}
+
+uint64_t CSceneContainer::HashRawBytes(const byte* const Data, size_t ByteCount)
+{
+	static constexpr uint64_t KPrime1{ 0x9E3779B185EBCA87 };
+	static constexpr uint64_t KPrime2{ 0xC2B2AE3D27D4EB4F };
+	auto Round{ [](uint64_t Lane, uint64_t Word)
+		{
+			Lane += Word * KPrime2;
+			Lane = (Lane << 31) | (Lane >> 33);
+			return Lane * KPrime1;
+		}
+	};
+
+	// @important: the lanes are independent, so the multiplications overlap
+	uint64_t Lanes[4]{ KPrime1 + KPrime2, KPrime2, 0, 0 - KPrime1 };
+	size_t Offset{};
+	for (; Offset + 32 <= ByteCount; Offset += 32)
+	{
+		uint64_t Words[4]{};
+		memcpy(Words, Data + Offset, 32);
+		Lanes[0] = Round(Lanes[0], Words[0]);
+		Lanes[1] = Round(Lanes[1], Words[1]);
+		Lanes[2] = Round(Lanes[2], Words[2]);
+		Lanes[3] = Round(Lanes[3], Words[3]);
+	}
+
+	uint64_t Hash{ ByteCount * KPrime1 };
+	for (uint64_t Lane : Lanes)
+	{
+		Hash = Round(Hash ^ Round(0, Lane), 0) + KPrime2;
+	}
+	for (; Offset < ByteCount; ++Offset)
+	{
+		Hash = Round(Hash, Data[Offset] + 1);
+	}
+
+	// Avalanche
+	Hash ^= Hash >> 33;
+	Hash *= KPrime2;
+	Hash ^= Hash >> 29;
+	return Hash;
+}
+
+bool CSceneContainer::IsChunkCached(const SSaveCache& SaveCache, uint64_t RawHash, bool bShouldCompress)
+{
+	return (SaveCache.bIsCompressing == bShouldCompress) && SaveCache.umapStoredChunks.count(RawHash);
+}
+
+bool CSceneContainer::MeasureIncrementalSaveTime(const string& FileName, uint32_t ChunkCount, size_t ChunkByteCount,
+	const vector<uint32_t>& vDirtyChunkCounts, bool bShouldCompress, vector<SIncrementalSaveBenchmark>& vOut)
+{
+	vOut.clear();
+	if (ChunkCount == 0 || ChunkByteCount < 64) return false;
+
+	// Smooth float arrays, like the vertices of the objects
+	vector<vector<byte>> vChunks(ChunkCount);
+	for (uint32_t iChunk = 0; iChunk < ChunkCount; ++iChunk)
+	{
+		vector<float> vFloats(ChunkByteCount / 4);
+		for (size_t iFloat = 0; iFloat < vFloats.size(); ++iFloat)
+		{
+			vFloats[iFloat] = sinf((float)(iFloat / 4) * 0.01f + (float)iChunk) * 100.0f + (float)(iFloat % 4);
+		}
+		vChunks[iChunk].resize(ChunkByteCount);
+		memcpy(vChunks[iChunk].data(), vFloats.data(), vFloats.size() * 4);
+	}
+
+	// @important: like the objects of the editor, clean chunks with a cache are added without their bytes (see AddCachedChunk())
+	vector<bool> vIsChunkDirty(ChunkCount, true);
+	vector<uint64_t> vRawHashes(ChunkCount);
+	auto Save{ [&](const string& SavingFileName, SSaveCache* const PtrSaveCache, double& OutMilliseconds)
+		{
+			CSceneContainer SceneContainer{};
+			for (uint32_t iChunk = 0; iChunk < ChunkCount; ++iChunk)
+			{
+				if (PtrSaveCache && !vIsChunkDirty[iChunk] && IsChunkCached(*PtrSaveCache, vRawHashes[iChunk], bShouldCompress))
+				{
+					SceneContainer.AddCachedChunk(ESceneChunkType::Object3D, vRawHashes[iChunk]);
+				}
+				else
+				{
+					SceneContainer.AddChunk(ESceneChunkType::Object3D, vector<byte>(vChunks[iChunk]));
+				}
+			}
+
+			auto StartTimePoint{ std::chrono::steady_clock::now() };
+			bool bResult{ SceneContainer.SaveToFile(SavingFileName, bShouldCompress, PtrSaveCache) };
+			OutMilliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTimePoint).count();
+			if (bResult && PtrSaveCache)
+			{
+				for (uint32_t iChunk = 0; iChunk < ChunkCount; ++iChunk)
+				{
+					vRawHashes[iChunk] = SceneContainer.GetChunkRawHash(ESceneChunkType::Object3D, iChunk);
+				}
+				vIsChunkDirty.assign(ChunkCount, false);
+			}
+			return bResult;
+		}
+	};
+
+	SSaveCache SaveCache{};
+	double Milliseconds{};
+	if (!Save(FileName, &SaveCache, Milliseconds)) return false;
+
+	const string KFullFileName{ FileName + ".full" };
+	float Movement{};
+	for (uint32_t DirtyChunkCount : vDirtyChunkCounts)
+	{
+		// Moves an instance (the first float) of the dirty objects
+		DirtyChunkCount = std::min(DirtyChunkCount, ChunkCount);
+		Movement += 1.0f;
+		for (uint32_t iDirtyChunk = 0; iDirtyChunk < DirtyChunkCount; ++iDirtyChunk)
+		{
+			const size_t KChunkIndex{ (size_t)iDirtyChunk * ChunkCount / DirtyChunkCount };
+			vector<byte>& vChunk{ vChunks[KChunkIndex] };
+			vIsChunkDirty[KChunkIndex] = true;
+			float Value{};
+			memcpy(&Value, vChunk.data(), 4);
+			Value = Value + Movement;
+			memcpy(vChunk.data(), &Value, 4);
+		}
+
+		SIncrementalSaveBenchmark Benchmark{};
+		Benchmark.DirtyChunkCount = DirtyChunkCount;
+		if (!Save(FileName, &SaveCache, Benchmark.Milliseconds)) return false;
+		if (!Save(KFullFileName, nullptr, Benchmark.FullMilliseconds)) return false;
+
+		CMappedFile File{};
+		CMappedFile FullFile{};
+		Benchmark.bIsIdentical = File.Open(FileName) && FullFile.Open(KFullFileName) && File.GetSize() == FullFile.GetSize() &&
+			memcmp(File.GetData(), FullFile.GetData(), File.GetSize()) == 0;
+		vOut.emplace_back(Benchmark);
+	}
+
+	std::error_code ErrorCode{};
+	std::filesystem::remove(FileName, ErrorCode);
+	std::filesystem::remove(KFullFileName, ErrorCode);
+	return true;
+}
+
+const CSceneContainer::SChunk* CSceneContainer::GetChunk(ESceneChunkType eType, uint32_t Index) const
+{
+	if (eType >= ESceneChunkType::COUNT) return nullptr;
+
+	const vector<uint32_t>& vChunkIndices{ m_vChunkIndicesByType[(size_t)eType] };
+	if (Index >= vChunkIndices.size()) return nullptr;
+
+	return &m_vChunks[vChunkIndices[Index]];
+}
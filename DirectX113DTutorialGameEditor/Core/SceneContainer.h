@@ -0,0 +1,160 @@
+#pragma once
+
+// @important: no device is needed, so that scenes can be converted without creating the editor window
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "BinaryData.h"
+#include "MappedFile.h"
+#include "LZCodec.h"
+
+// @important: stored in files, so never reorder (append before COUNT)
+enum class ESceneChunkType : uint32_t
+{
+	Patterns,
+	Terrain,
+	ObjectTable, // names, rigged flags and physics roles of the objects
+	InstanceTable, // patterns of the instances
+	Object3D, // one per object (in the object table order), the whole OB3D: transforms, instances, meshes and materials
+	Cameras, // the editor camera comes first
+	Lights,
+	SceneMaterial,
+	LightProbe,
+	GlobalLight, // directional & ambient light
+
+	COUNT
+};
+
+// Scene file made of chunks with a table of contents in front,
+// so that a loader can seek straight to the chunks it needs and read them in place from the mapped file
+// Large chunks can be stored compressed (see CLZCodec), those are decompressed while being read instead
+class CSceneContainer
+{
+public:
+	struct SChunk
+	{
+		ESceneChunkType	eType{};
+		bool			bIsCompressed{};
+		uint64_t		Offset{}; // from the beginning of the file
+		uint64_t		ByteCount{}; // stored in the file
+		uint64_t		RawByteCount{}; // after decompression (the same as ByteCount if not compressed)
+		uint64_t		Hash{}; // of the stored bytes (see HashBytes()), so that it's verified without decompressing
+		uint64_t		RawHash{}; // HashRawBytes() of the raw bytes, in memory only (0 if unknown)
+	};
+
+	// Where the last save (or FillSaveCache()) of a scene left its chunks, so that the next save only encodes the chunks that changed
+	// and doesn't write the file at all if nothing did
+	// @important: no chunk bytes are kept, unchanged chunks are copied from FileName, which must still be the file that was saved
+	// Chunks are found by the hash of their raw bytes, so every change is caught, however it was made
+	struct SSaveCache
+	{
+		struct SStoredChunk
+		{
+			uint64_t			RawByteCount{};
+			bool				bIsCompressed{};
+			uint64_t			Offset{}; // in FileName
+			uint64_t			ByteCount{}; // stored
+			uint64_t			Hash{}; // of the stored bytes
+		};
+
+		std::unordered_map<uint64_t, SStoredChunk>	umapStoredChunks{}; // by HashRawBytes() of the raw bytes
+		bool										bIsCompressing{};
+		std::string									FileName{};
+		uint64_t									FileByteCount{};
+		uint64_t									TableOfContentsEnd{}; // the header and the table of contents
+		uint64_t									FileHash{}; // of the header and the table of contents, which hash everything else
+
+		// Of the last save
+		uint32_t									LastChunkCount{};
+		uint32_t									LastDirtyChunkCount{}; // encoded and hashed again
+		bool										bWasLastFileWritten{};
+	};
+
+	struct SIncrementalSaveBenchmark
+	{
+		uint32_t	DirtyChunkCount{};
+		double		Milliseconds{}; // with the cache of the previous save
+		double		FullMilliseconds{}; // without any cache
+		bool		bIsIdentical{}; // the two files, byte for byte
+	};
+
+public:
+	CSceneContainer() {}
+	~CSceneContainer() {}
+
+public:
+	// @important: chunks are written in the order they are added and ChunkData is left empty
+	void AddChunk(ESceneChunkType eType, CBinaryData& ChunkData);
+	void AddChunk(ESceneChunkType eType, std::vector<byte>&& vChunkBytes);
+	// Adds the chunk of the last save whose raw bytes hash to RawHash, without serializing it again
+	// @important: check IsChunkCached() first, SaveToFile() fails if the chunk can't be copied from the file of the last save
+	void AddCachedChunk(ESceneChunkType eType, uint64_t RawHash);
+	// @important: only chunks of KMinCompressedChunkByteCount or more are compressed, and only if they get smaller
+	// With PtrSaveCache, chunks that haven't changed since it was filled reuse their stored bytes (the file is the same as a full save)
+	// @important: the cache is emptied if it fails, so that the next save is a full one
+	bool SaveToFile(const std::string& FileName, bool bShouldCompress = false, SSaveCache* const PtrSaveCache = nullptr);
+
+	// The file stays mapped until Close() or the next Open()
+	bool Open(const std::string& FileName);
+	void Close();
+
+	// Index counts the chunks of the same type
+	// @important: Out reads straight from the mapped file, so it must not be read after Close()
+	// (compressed chunks are decompressed into Out instead)
+	bool ReadChunk(ESceneChunkType eType, CBinaryData& Out, uint32_t Index = 0, bool bShouldVerifyHash = false) const;
+	// Checks every chunk against its hash
+	bool Verify() const;
+	// Fills the cache from the open file, so that the first save after loading is incremental as well
+	// @important: chunks that a save with bShouldCompress wouldn't store the same way are left out
+	// The raw hashes of all the chunks are kept (see GetChunkRawHash())
+	bool FillSaveCache(const std::string& FileName, bool bShouldCompress, SSaveCache& Out);
+
+public:
+	bool IsOpen() const;
+	const std::vector<SChunk>& GetChunks() const;
+	uint32_t GetChunkCount(ESceneChunkType eType) const;
+	// Known after SaveToFile() or FillSaveCache(), 0 otherwise
+	uint64_t GetChunkRawHash(ESceneChunkType eType, uint32_t Index = 0) const;
+
+public:
+	// Reads only the signature
+	static bool IsSceneContainer(const std::string& FileName);
+	// 64-bit FNV-1a
+	static uint64_t HashBytes(const byte* const Data, size_t ByteCount);
+	// 64-bit, 4 lanes of 8-byte words: several times faster than HashBytes(), for telling chunks apart in memory (never stored)
+	static uint64_t HashRawBytes(const byte* const Data, size_t ByteCount);
+	static bool IsChunkCached(const SSaveCache& SaveCache, uint64_t RawHash, bool bShouldCompress);
+
+public:
+	// Saves ChunkCount synthetic object chunks to FileName, then for each dirty count changes that many of them
+	// and saves them both incrementally and fully (to FileName + ".full"), both files are removed afterwards
+	// Returns false if a save fails
+	static bool MeasureIncrementalSaveTime(const std::string& FileName, uint32_t ChunkCount, size_t ChunkByteCount,
+		const std::vector<uint32_t>& vDirtyChunkCounts, bool bShouldCompress, std::vector<SIncrementalSaveBenchmark>& vOut);
+
+private:
+	const SChunk* GetChunk(ESceneChunkType eType, uint32_t Index) const;
+
+public:
+	static constexpr uint16_t KVersionMajor{ 0x0001 };
+	static constexpr uint8_t KVersionMinor{ 0x01 };
+	static constexpr uint8_t KVersionSubminor{ 0x00 };
+	static constexpr size_t KChunkAlignment{ 16 }; // so that arrays in chunks stay aligned in the mapped file
+	static constexpr size_t KMinCompressedChunkByteCount{ 4 * 1024 }; // smaller ones gain too little to be worth decompressing
+
+private:
+	static constexpr char KSignature[]{ "KJW_SCNC" };
+	static constexpr size_t KSignatureLength{ 8 };
+	static constexpr size_t KHeaderByteCount{ KSignatureLength + 4 + 4 };
+	static constexpr size_t KChunkEntryByteCount{ 4 + 4 + 8 + 8 + 8 + 8 };
+	static constexpr size_t KChunkEntryByteCountV100{ 4 + 8 + 8 + 8 }; // version 1.0.0 (no compression)
+
+private:
+	std::vector<SChunk>					m_vChunks{};
+	std::vector<uint32_t>				m_vChunkIndicesByType[(size_t)ESceneChunkType::COUNT]{};
+	std::vector<std::vector<byte>>		m_vChunkBytes{}; // writing only
+	std::vector<bool>					m_vIsChunkCached{}; // writing only (see AddCachedChunk())
+	uint32_t							m_Version{}; // of the open file
+	CMappedFile							m_MappedFile{};
+};
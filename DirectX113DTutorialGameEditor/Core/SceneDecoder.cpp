@@ -0,0 +1,201 @@
+#include "SceneDecoder.h"
+#include "Terrain.h"
+#include "../Model/Object3D.h"
+#include "../Model/MeshPorter.h"
+#include <chrono>
+#include <unordered_map>
+
+using std::string;
+using std::vector;
+using std::pair;
+using std::make_unique;
+
+static bool IsMESHFileName(const string& FileName)
+{
+	size_t ExtensionDot{ FileName.find_last_of('.') };
+	if (ExtensionDot == string::npos) return false;
+
+	string Extension{ FileName.substr(ExtensionDot + 1) };
+	for (char& ch : Extension)
+	{
+		ch = toupper(ch);
+	}
+	return (Extension == "MESH");
+}
+
+CSceneDecoder::~CSceneDecoder()
+{
+}
+
+void CSceneDecoder::Start(const CSceneContainer& SceneContainer, uint32_t ThreadCount)
+{
+	// Terrain
+	{
+		CBinaryData TerrainBinary{};
+		string TerrainFileName{};
+		if (SceneContainer.ReadChunk(ESceneChunkType::Terrain, TerrainBinary)) TerrainBinary.ReadStringWithPrefixedLength(TerrainFileName);
+
+		if (TerrainFileName.size())
+		{
+			m_TerrainTask = m_TaskScheduler.AddTask([this, TerrainFileName]()
+				{
+					m_Terrain = CTerrain::DecodeFile(TerrainFileName);
+				});
+		}
+	}
+
+	// Object3D
+	{
+		const uint32_t KObject3DCount{ SceneContainer.GetChunkCount(ESceneChunkType::Object3D) };
+
+		// @important: the headers are read here (they are small), so that the tasks and their dependencies are known up front
+		vector<CObject3D::SOB3DHeader> vHeaders(KObject3DCount);
+		std::unordered_map<string, uint32_t> umapModelFileReferenceCounts{};
+		CBinaryData Object3DBinary{};
+		for (uint32_t iObject3D = 0; iObject3D < KObject3DCount; ++iObject3D)
+		{
+			CObject3D::SOB3DHeader& Header{ vHeaders[iObject3D] };
+			if (!SceneContainer.ReadChunk(ESceneChunkType::Object3D, Object3DBinary, iObject3D) ||
+				!CObject3D::ReadOB3DHeader(Object3DBinary, Header))
+			{
+				Header = CObject3D::SOB3DHeader{};
+				continue;
+			}
+
+			if (!Header.PtrMeshData && IsMESHFileName(Header.ModelFileName)) ++umapModelFileReferenceCounts[Header.ModelFileName];
+		}
+
+		m_vObject3DModels.resize(KObject3DCount);
+		m_vObject3DTasks.assign(KObject3DCount, KInvalidTask);
+		std::unordered_map<string, pair<uint32_t, SMESHData*>> umapSharedModels{}; // file name to (task, model)
+		for (uint32_t iObject3D = 0; iObject3D < KObject3DCount; ++iObject3D)
+		{
+			const CObject3D::SOB3DHeader& Header{ vHeaders[iObject3D] };
+			if (Header.PtrMeshData)
+			{
+				// Embedded MESH, decoded in place from the mapped scene container
+				m_vObject3DModels[iObject3D] = make_unique<SMESHData>();
+				SMESHData* const PtrModel{ m_vObject3DModels[iObject3D].get() };
+				const byte* const PtrMeshData{ Header.PtrMeshData };
+				const size_t KMeshDataByteCount{ Header.MeshDataByteCount };
+
+				m_vObject3DTasks[iObject3D] = m_TaskScheduler.AddTask([PtrModel, PtrMeshData, KMeshDataByteCount]()
+					{
+						CMeshPorter MeshPorter{ PtrMeshData, KMeshDataByteCount };
+						MeshPorter.ReadMESHData(*PtrModel);
+					});
+			}
+			else if (IsMESHFileName(Header.ModelFileName))
+			{
+				m_vObject3DModels[iObject3D] = make_unique<SMESHData>();
+				SMESHData* const PtrModel{ m_vObject3DModels[iObject3D].get() };
+				const string& ModelFileName{ Header.ModelFileName };
+
+				if (umapModelFileReferenceCounts[ModelFileName] == 1)
+				{
+					m_vObject3DTasks[iObject3D] = m_TaskScheduler.AddTask([PtrModel, ModelFileName]()
+						{
+							CMeshPorter MeshPorter{};
+							MeshPorter.ImportMESH(ModelFileName, *PtrModel);
+						});
+				}
+				else
+				{
+					// @important: imported once and then copied for every object, as each object owns its model
+					auto found{ umapSharedModels.find(ModelFileName) };
+					if (found == umapSharedModels.end())
+					{
+						m_vSharedModels.emplace_back(make_unique<SMESHData>());
+						SMESHData* const PtrSharedModel{ m_vSharedModels.back().get() };
+
+						uint32_t ImportTask{ m_TaskScheduler.AddTask([PtrSharedModel, ModelFileName]()
+							{
+								CMeshPorter MeshPorter{};
+								MeshPorter.ImportMESH(ModelFileName, *PtrSharedModel);
+							}) };
+						found = umapSharedModels.emplace(ModelFileName, pair<uint32_t, SMESHData*>(ImportTask, PtrSharedModel)).first;
+					}
+
+					SMESHData* const PtrSharedModel{ found->second.second };
+					m_vObject3DTasks[iObject3D] = m_TaskScheduler.AddTask([PtrModel, PtrSharedModel]()
+						{
+							*PtrModel = *PtrSharedModel;
+						}, { found->second.first });
+				}
+			}
+		}
+	}
+
+	m_TaskScheduler.Start(ThreadCount);
+}
+
+void CSceneDecoder::Wait()
+{
+	m_TaskScheduler.Wait();
+}
+
+void CSceneDecoder::WaitForTerrain()
+{
+	if (m_TerrainTask != KInvalidTask) m_TaskScheduler.WaitForTask(m_TerrainTask);
+}
+
+void CSceneDecoder::WaitForObject3D(uint32_t Object3DIndex)
+{
+	if (Object3DIndex >= m_vObject3DTasks.size()) return;
+	if (m_vObject3DTasks[Object3DIndex] != KInvalidTask) m_TaskScheduler.WaitForTask(m_vObject3DTasks[Object3DIndex]);
+}
+
+bool CSceneDecoder::IsTerrainDecoded() const
+{
+	return (m_TerrainTask == KInvalidTask) || m_TaskScheduler.IsTaskFinished(m_TerrainTask);
+}
+
+bool CSceneDecoder::IsObject3DDecoded(uint32_t Object3DIndex) const
+{
+	if (Object3DIndex >= m_vObject3DTasks.size()) return true;
+	return (m_vObject3DTasks[Object3DIndex] == KInvalidTask) || m_TaskScheduler.IsTaskFinished(m_vObject3DTasks[Object3DIndex]);
+}
+
+float CSceneDecoder::GetProgress() const
+{
+	uint32_t TaskCount{ m_TaskScheduler.GetTaskCount() };
+	if (TaskCount == 0) return 1.0f;
+
+	return (float)m_TaskScheduler.GetFinishedTaskCount() / (float)TaskCount;
+}
+
+std::unique_ptr<STERRData> CSceneDecoder::TakeTerrain()
+{
+	assert(IsTerrainDecoded());
+
+	return std::move(m_Terrain);
+}
+
+SMESHData* CSceneDecoder::GetObject3DModel(uint32_t Object3DIndex)
+{
+	if (Object3DIndex >= m_vObject3DModels.size()) return nullptr;
+
+	assert(IsObject3DDecoded(Object3DIndex));
+
+	return m_vObject3DModels[Object3DIndex].get();
+}
+
+double CSceneDecoder::MeasureDecodeTime(const string& FileName, uint32_t ThreadCount, uint32_t IterationCount)
+{
+	if (IterationCount == 0) return 0.0;
+
+	CSceneContainer SceneContainer{};
+	if (!SceneContainer.Open(FileName)) return 0.0;
+
+	double TotalMilliseconds{};
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
+	{
+		CSceneDecoder SceneDecoder{};
+
+		auto StartTimePoint{ std::chrono::steady_clock::now() };
+		SceneDecoder.Start(SceneContainer, ThreadCount);
+		SceneDecoder.Wait();
+		TotalMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTimePoint).count();
+	}
+	return TotalMilliseconds / IterationCount;
+}
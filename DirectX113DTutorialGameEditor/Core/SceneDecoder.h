@@ -0,0 +1,63 @@
+#pragma once
+
+// @important: no device is needed, so that the CPU stage of loading a scene runs on worker threads (and can be measured headless)
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include "SceneContainer.h"
+#include "TaskScheduler.h"
+
+struct SMESHData;
+struct STERRData;
+
+// CPU stage of loading a scene container: decodes the terrain and the models of the objects on worker threads,
+// one task per asset (MESH files shared by several objects are imported once)
+// The GPU resources are created from the decoded data on the main thread afterwards (see CGame::UpdateSceneLoading())
+class CSceneDecoder
+{
+public:
+	CSceneDecoder() {}
+	~CSceneDecoder();
+
+	CSceneDecoder(const CSceneDecoder&) = delete;
+	CSceneDecoder& operator=(const CSceneDecoder&) = delete;
+
+public:
+	// @important: SceneContainer must stay open while decoding
+	void Start(const CSceneContainer& SceneContainer, uint32_t ThreadCount = 0);
+	void Wait();
+
+	void WaitForTerrain();
+	void WaitForObject3D(uint32_t Object3DIndex);
+
+public:
+	bool IsTerrainDecoded() const;
+	bool IsObject3DDecoded(uint32_t Object3DIndex) const;
+	// 0 to 1
+	float GetProgress() const;
+
+	// nullptr if the scene has no terrain
+	std::unique_ptr<STERRData> TakeTerrain();
+	// nullptr if the model can't be decoded without a device (e.g. models loaded by Assimp)
+	// @important: the caller may move from it
+	SMESHData* GetObject3DModel(uint32_t Object3DIndex);
+
+public:
+	// Decodes the scene container IterationCount times and returns the average time in milliseconds
+	// ThreadCount 0 means one per hardware thread but the calling one
+	static double MeasureDecodeTime(const std::string& FileName, uint32_t ThreadCount, uint32_t IterationCount);
+
+public:
+	static constexpr uint32_t KInvalidTask{ UINT32_MAX };
+
+private:
+	std::unique_ptr<STERRData>				m_Terrain{};
+	uint32_t								m_TerrainTask{ KInvalidTask };
+	std::vector<std::unique_ptr<SMESHData>>	m_vObject3DModels{}; // nullptr if not decoded here
+	std::vector<uint32_t>					m_vObject3DTasks{};
+	std::vector<std::unique_ptr<SMESHData>>	m_vSharedModels{}; // MESH files referred to by several objects
+
+	// @important: declared last, so that the tasks have finished before the data they write is destroyed
+	CTaskScheduler							m_TaskScheduler{};
+};
@@ -70,7 +70,11 @@ void CShader::Create(EShaderType Type, EVersion eVersion, bool bShouldCompile, c
 	{
 		D3DCompileFromFile(FileName.c_str(), nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE, EntryPoint.c_str(),
 			(ShaderPrefix + VersionSuffix).c_str(), D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION, 0, m_Blob.ReleaseAndGetAddressOf(), nullptr);
-		if (!m_Blob) MB_WARN(KCompileFailureMessage, KCompileFailureTitle);
+		if (!m_Blob)
+		{
+			MB_WARN(KCompileFailureMessage, KCompileFailureTitle);
+			return;
+		}
 	}
 	else
 	{
@@ -125,110 +129,86 @@ void CShader::Create(EShaderType Type, EVersion eVersion, bool bShouldCompile, c
 	}
 }
 
-bool CShader::CompileCSO(EShaderType Type, EVersion eVersion, const std::wstring& FileName, const std::string& EntryPoint)
+void CShader::ReserveConstantBufferSlots(uint32_t Count)
 {
-	ComPtr<ID3DBlob> Blob{};
+	m_SlotCounter = Count;
+}
 
-	string VersionSuffix{};
-	switch (eVersion)
-	{
-	case CShader::EVersion::_4_0:
-		VersionSuffix = "_4_0";
-		break;
-	case CShader::EVersion::_4_1:
-		VersionSuffix = "_4_1";
-		break;
-	case CShader::EVersion::_5_0:
-		VersionSuffix = "_5_0";
-		break;
-	case CShader::EVersion::_5_1:
-		VersionSuffix = "_5_1";
-		break;
-	default:
-		break;
-	}
+void CShader::AttachConstantBuffer(const CConstantBuffer* const ConstantBuffer, int32_t Slot)
+{
+	uint32_t uSlot{ (Slot == -1) ? m_SlotCounter : (uint32_t)Slot };
+	m_vAttachedConstantBuffers.emplace_back(ConstantBuffer, uSlot);
 
-	string ShaderPrefix{};
-	switch (Type)
+	++m_SlotCounter;
+}
+
+void CShader::Use() const
+{
+	switch (m_ShaderType)
 	{
 	case EShaderType::VertexShader:
-		ShaderPrefix = "vs";
+		if (m_PtrStateCache->ShouldBindShader((uint32_t)m_ShaderType, m_VertexShader.Get()))
+		{
+			m_PtrDeviceContext->VSSetShader(m_VertexShader.Get(), nullptr, 0);
+			if (m_InputLayout) m_PtrDeviceContext->IASetInputLayout(m_InputLayout.Get());
+		}
 		break;
 	case EShaderType::HullShader:
-		ShaderPrefix = "hs";
+		if (m_PtrStateCache->ShouldBindShader((uint32_t)m_ShaderType, m_HullShader.Get()))
+		{
+			m_PtrDeviceContext->HSSetShader(m_HullShader.Get(), nullptr, 0);
+		}
 		break;
 	case EShaderType::DomainShader:
-		ShaderPrefix = "ds";
+		if (m_PtrStateCache->ShouldBindShader((uint32_t)m_ShaderType, m_DomainShader.Get()))
+		{
+			m_PtrDeviceContext->DSSetShader(m_DomainShader.Get(), nullptr, 0);
+		}
 		break;
 	case EShaderType::GeometryShader:
-		ShaderPrefix = "gs";
+		if (m_PtrStateCache->ShouldBindShader((uint32_t)m_ShaderType, m_GeometryShader.Get()))
+		{
+			m_PtrDeviceContext->GSSetShader(m_GeometryShader.Get(), nullptr, 0);
+		}
 		break;
 	case EShaderType::PixelShader:
-		ShaderPrefix = "ps";
+		if (m_PtrStateCache->ShouldBindShader((uint32_t)m_ShaderType, m_PixelShader.Get()))
+		{
+			m_PtrDeviceContext->PSSetShader(m_PixelShader.Get(), nullptr, 0);
+		}
 		break;
 	default:
 		break;
 	}
 
-	if (SUCCEEDED(D3DCompileFromFile(FileName.c_str(), nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE, EntryPoint.c_str(),
-		(ShaderPrefix + VersionSuffix).c_str(), D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION, 0, Blob.ReleaseAndGetAddressOf(), nullptr)))
+	for (const SAttachedConstantBuffer& AttachedConstantBuffer : m_vAttachedConstantBuffers)
 	{
-		const void* PtrBuffer{ Blob->GetBufferPointer() };
-		size_t BufferSize{ Blob->GetBufferSize() };
-
-		auto Dot{ FileName.find_last_of('.') };
-		wstring wEntryPoint{ EntryPoint.begin(), EntryPoint.end() };
-		wstring CSOFileName{ FileName.substr(0, Dot) + ((EntryPoint == "main") ? L"" : L"_" + wEntryPoint) + L".cso" };
-
-		std::ofstream ofs{};
-		ofs.open(CSOFileName, ofs.binary);
-		ofs.write((const char*)PtrBuffer, BufferSize);
-		ofs.close();
-
-		return true;
+		AttachedConstantBuffer.PtrConstantBuffer->Use(m_ShaderType, AttachedConstantBuffer.AttachedSlot);
 	}
-	return false;
 }
 
-void CShader::ReserveConstantBufferSlots(uint32_t Count)
-{
-	m_SlotCounter = Count;
-}
-
-void CShader::AttachConstantBuffer(const CConstantBuffer* const ConstantBuffer, int32_t Slot)
+void CShader::Unbind(ID3D11DeviceContext* const PtrDeviceContext, EShaderType eShaderType)
 {
-	uint32_t uSlot{ (Slot == -1) ? m_SlotCounter : (uint32_t)Slot };
-	m_vAttachedConstantBuffers.emplace_back(ConstantBuffer, uSlot);
+	if (!CStateCache::Get(PtrDeviceContext).ShouldBindShader((uint32_t)eShaderType, nullptr)) return;
 
-	++m_SlotCounter;
-}
-
-void CShader::Use() const
-{
-	switch (m_ShaderType)
+	switch (eShaderType)
 	{
 	case EShaderType::VertexShader:
-		m_PtrDeviceContext->VSSetShader(m_VertexShader.Get(), nullptr, 0);
-		if (m_InputLayout) m_PtrDeviceContext->IASetInputLayout(m_InputLayout.Get());
+		PtrDeviceContext->VSSetShader(nullptr, nullptr, 0);
 		break;
 	case EShaderType::HullShader:
-		m_PtrDeviceContext->HSSetShader(m_HullShader.Get(), nullptr, 0);
+		PtrDeviceContext->HSSetShader(nullptr, nullptr, 0);
 		break;
 	case EShaderType::DomainShader:
-		m_PtrDeviceContext->DSSetShader(m_DomainShader.Get(), nullptr, 0);
+		PtrDeviceContext->DSSetShader(nullptr, nullptr, 0);
 		break;
 	case EShaderType::GeometryShader:
-		m_PtrDeviceContext->GSSetShader(m_GeometryShader.Get(), nullptr, 0);
+		PtrDeviceContext->GSSetShader(nullptr, nullptr, 0);
 		break;
 	case EShaderType::PixelShader:
-		m_PtrDeviceContext->PSSetShader(m_PixelShader.Get(), nullptr, 0);
+		PtrDeviceContext->PSSetShader(nullptr, nullptr, 0);
 		break;
 	default:
 		break;
 	}
-
-	for (const SAttachedConstantBuffer& AttachedConstantBuffer : m_vAttachedConstantBuffers)
-	{
-		AttachedConstantBuffer.PtrConstantBuffer->Use(m_ShaderType, AttachedConstantBuffer.AttachedSlot);
-	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SharedHeader.h"
+#include "StateCache.h"
 
 class CConstantBuffer;
 
@@ -31,7 +32,7 @@ private:
 
 public:
 	CShader(ID3D11Device* const PtrDevice, ID3D11DeviceContext* const PtrDeviceContext) :
-		m_PtrDevice{ PtrDevice }, m_PtrDeviceContext{ PtrDeviceContext }
+		m_PtrDevice{ PtrDevice }, m_PtrDeviceContext{ PtrDeviceContext }, m_PtrStateCache{ &CStateCache::Get(PtrDeviceContext) }
 	{
 		assert(m_PtrDevice); 
 		assert(m_PtrDeviceContext); 
@@ -42,18 +43,21 @@ public:
 	void Create(EShaderType Type, EVersion eVersion, bool bShouldCompile, const std::wstring& FileName, const std::string& EntryPoint,
 		const D3D11_INPUT_ELEMENT_DESC* InputElementDescs = nullptr, UINT NumElements = 0);
 
-	bool CompileCSO(EShaderType Type, EVersion eVersion, const std::wstring& FileName, const std::string& EntryPoint);
-
 public:
 	void ReserveConstantBufferSlots(uint32_t Count);
 	void AttachConstantBuffer(const CConstantBuffer* const ConstantBuffer, int32_t Slot = -1);
 
 public:
+	// @important: skipped when the shader is already bound (see CStateCache)
 	void Use() const;
 
+	// Use this instead of calling XXSetShader(nullptr, ...) directly, so that the state cache stays in sync
+	static void Unbind(ID3D11DeviceContext* const PtrDeviceContext, EShaderType eShaderType);
+
 private:
 	ID3D11Device* const						m_PtrDevice{};
 	ID3D11DeviceContext* const				m_PtrDeviceContext{};
+	CStateCache* const						m_PtrStateCache{};
 
 private:
 	ComPtr<ID3DBlob>						m_Blob{};
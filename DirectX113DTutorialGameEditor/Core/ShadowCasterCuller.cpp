@@ -0,0 +1,110 @@
+#include "ShadowCasterCuller.h"
+
+using namespace DirectX;
+
+void CShadowCasterCuller::SetCascade(const SShadowCascadeVolume& Volume)
+{
+	XMVECTOR CasterVolumePlanes[5]{};
+	CalculateCasterVolumePlanes(Volume, CasterVolumePlanes);
+	m_CasterVolumeCuller.SetPlanes(CasterVolumePlanes, 5);
+
+	CalculateViewSlicePlanes(Volume.ViewSliceVertices, m_ViewSlicePlanes);
+
+	m_LightForward = XMVector3Normalize(Volume.LightForward);
+	m_FarDistance = XMVectorGetX(XMVector3Dot(Volume.LightPosition, m_LightForward)) + Volume.HalfSize.z * 2.0f;
+}
+
+void CShadowCasterCuller::CalculateCasterVolumePlanes(const SShadowCascadeVolume& Volume, XMVECTOR(&OutPlanes)[5])
+{
+	XMVECTOR Right{ XMVector3Normalize(Volume.LightRight) };
+	XMVECTOR Up{ XMVector3Normalize(Volume.LightUp) };
+	XMVECTOR Forward{ XMVector3Normalize(Volume.LightForward) };
+	XMVECTOR BoxCenter{ Volume.LightPosition + Forward * Volume.HalfSize.z };
+
+	float RightDot{ XMVectorGetX(XMVector3Dot(Right, BoxCenter)) };
+	float UpDot{ XMVectorGetX(XMVector3Dot(Up, BoxCenter)) };
+	float ForwardDot{ XMVectorGetX(XMVector3Dot(Forward, BoxCenter)) };
+
+	OutPlanes[0] = XMVectorSetW(Right, -RightDot - Volume.HalfSize.x);
+	OutPlanes[1] = XMVectorSetW(-Right, +RightDot - Volume.HalfSize.x);
+	OutPlanes[2] = XMVectorSetW(Up, -UpDot - Volume.HalfSize.y);
+	OutPlanes[3] = XMVectorSetW(-Up, +UpDot - Volume.HalfSize.y);
+	OutPlanes[4] = XMVectorSetW(Forward, -ForwardDot - Volume.HalfSize.z);
+}
+
+void CShadowCasterCuller::CalculateViewSlicePlanes(const XMVECTOR(&Vertices)[8], XMVECTOR(&OutPlanes)[6])
+{
+	// Each face by 3 of its vertices (see SFrustumVertices)
+	static constexpr uint32_t KFaceVertexIndices[6][3]
+	{
+		{ 0, 1, 2 }, // near
+		{ 4, 5, 6 }, // far
+		{ 0, 2, 4 }, // A side
+		{ 1, 3, 5 }, // B side
+		{ 0, 1, 4 }, // upper
+		{ 2, 3, 6 }  // lower
+	};
+
+	XMVECTOR Centroid{ XMVectorZero() };
+	for (const auto& Vertex : Vertices) Centroid += Vertex;
+	Centroid = XMVectorSetW(Centroid / 8.0f, 1.0f);
+
+	for (uint32_t iFace = 0; iFace < 6; ++iFace)
+	{
+		const auto& Indices{ KFaceVertexIndices[iFace] };
+		XMVECTOR Plane{ XMPlaneNormalize(XMPlaneFromPoints(Vertices[Indices[0]], Vertices[Indices[1]], Vertices[Indices[2]])) };
+
+		// @important: winding differs per face, so the plane is flipped to point away from the centroid
+		if (XMVectorGetX(XMPlaneDot(Plane, Centroid)) > 0.0f) Plane = -Plane;
+		OutPlanes[iFace] = Plane;
+	}
+}
+
+bool CShadowCasterCuller::ReachesViewSlice(const XMFLOAT4& Sphere) const
+{
+	XMVECTOR Begin{ XMVectorSet(Sphere.x, Sphere.y, Sphere.z, 1.0f) };
+	float Length{ m_FarDistance - XMVectorGetX(XMVector3Dot(Begin, m_LightForward)) };
+	if (Length < 0.0f) Length = 0.0f;
+	XMVECTOR End{ XMVectorSetW(Begin + m_LightForward * Length, 1.0f) };
+
+	// The swept sphere (capsule) is outside when both ends are outside the same plane
+	for (const auto& Plane : m_ViewSlicePlanes)
+	{
+		float BeginDistance{ XMVectorGetX(XMPlaneDot(Plane, Begin)) };
+		float EndDistance{ XMVectorGetX(XMPlaneDot(Plane, End)) };
+		if (BeginDistance > Sphere.w && EndDistance > Sphere.w) return false;
+	}
+	return true;
+}
+
+bool CShadowCasterCuller::IsCaster(const XMFLOAT4& Sphere) const
+{
+	return m_CasterVolumeCuller.IsVisible(Sphere) && ReachesViewSlice(Sphere);
+}
+
+bool CShadowCasterCuller::HasAnyCaster(const XMFLOAT4* const Spheres, uint32_t SphereCount) const
+{
+	for (uint32_t iSphere = 0; iSphere < SphereCount; ++iSphere)
+	{
+		if (IsCaster(Spheres[iSphere])) return true;
+	}
+	return false;
+}
+
+uint32_t CShadowCasterCuller::Cull(const XMFLOAT4* const Spheres, uint32_t SphereCount, std::vector<uint32_t>& vOutCasterIndices) const
+{
+	// The box test is batched, then the survivors are compacted in place by the (scalar) view slice test
+	const size_t KStartIndex{ vOutCasterIndices.size() };
+	m_CasterVolumeCuller.Cull(Spheres, SphereCount, vOutCasterIndices);
+
+	size_t CasterEnd{ KStartIndex };
+	for (size_t iCandidate = KStartIndex; iCandidate < vOutCasterIndices.size(); ++iCandidate)
+	{
+		uint32_t SphereIndex{ vOutCasterIndices[iCandidate] };
+		vOutCasterIndices[CasterEnd] = SphereIndex;
+		CasterEnd += (ReachesViewSlice(Spheres[SphereIndex])) ? 1 : 0;
+	}
+	vOutCasterIndices.resize(CasterEnd);
+
+	return (uint32_t)(CasterEnd - KStartIndex);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+// @important: pure CPU (DirectXMath only), so that it doesn't depend on any device
+#include "FrustumCuller.h"
+
+// Light-space box of one shadow map cascade and the view frustum slice it covers
+struct SShadowCascadeVolume
+{
+	DirectX::XMVECTOR	LightPosition{};			// center of the box's near face
+	DirectX::XMVECTOR	LightForward{};
+	DirectX::XMVECTOR	LightUp{};
+	DirectX::XMVECTOR	LightRight{};
+	DirectX::XMFLOAT3	HalfSize{};
+	DirectX::XMVECTOR	ViewSliceVertices[8]{};		// same order as SFrustumVertices
+};
+
+// Selects the shadow casters of one cascade
+// 1) the caster must intersect the cascade's box extruded toward the light (casters in front of the box still cast into it)
+// 2) the caster's shadow (the sphere swept along the light direction) must reach the view slice of the cascade,
+//    which drops casters that only shadow receivers covered by a smaller cascade
+class CShadowCasterCuller
+{
+public:
+	CShadowCasterCuller() {}
+	~CShadowCasterCuller() {}
+
+public:
+	void SetCascade(const SShadowCascadeVolume& Volume);
+
+	bool IsCaster(const DirectX::XMFLOAT4& Sphere) const;
+	bool HasAnyCaster(const DirectX::XMFLOAT4* const Spheres, uint32_t SphereCount) const;
+
+	// Appends the indices of the casters to vOutCasterIndices (compacted, in order) and returns the caster count
+	uint32_t Cull(const DirectX::XMFLOAT4* const Spheres, uint32_t SphereCount, std::vector<uint32_t>& vOutCasterIndices) const;
+
+public:
+	// Outward planes: right, left, up, down, far (no near plane, it's extruded toward the light)
+	static void CalculateCasterVolumePlanes(const SShadowCascadeVolume& Volume, DirectX::XMVECTOR(&OutPlanes)[5]);
+
+	// Outward planes of the convex hull of the 8 frustum vertices
+	static void CalculateViewSlicePlanes(const DirectX::XMVECTOR(&Vertices)[8], DirectX::XMVECTOR(&OutPlanes)[6]);
+
+private:
+	bool ReachesViewSlice(const DirectX::XMFLOAT4& Sphere) const;
+
+private:
+	CFrustumCuller		m_CasterVolumeCuller{};
+	DirectX::XMVECTOR	m_ViewSlicePlanes[6]{};
+	DirectX::XMVECTOR	m_LightForward{};
+	float				m_FarDistance{}; // along LightForward
+};
@@ -0,0 +1,123 @@
+#include "StateCache.h"
+#include <cstring>
+
+using std::vector;
+using std::pair;
+using std::unique_ptr;
+using std::make_unique;
+
+CStateCache& CStateCache::Get(const void* const PtrDeviceContext)
+{
+	// @important: there's usually only the immediate context, so a linear search is enough
+	static vector<pair<const void*, unique_ptr<CStateCache>>> s_vStateCaches{};
+
+	for (auto& StateCache : s_vStateCaches)
+	{
+		if (StateCache.first == PtrDeviceContext) return *StateCache.second;
+	}
+	s_vStateCaches.emplace_back(PtrDeviceContext, make_unique<CStateCache>());
+	return *s_vStateCaches.back().second;
+}
+
+bool CStateCache::ShouldBindShader(uint32_t Stage, const void* const PtrShader)
+{
+	assert(Stage < KStageCount);
+
+	if (m_bIsShaderKnown[Stage] && m_BoundShaders[Stage] == PtrShader)
+	{
+		++m_Counters.SkippedBindCount;
+		return false;
+	}
+
+	m_BoundShaders[Stage] = PtrShader;
+	m_bIsShaderKnown[Stage] = true;
+	++m_Counters.IssuedBindCount;
+	return true;
+}
+
+bool CStateCache::ShouldBindConstantBuffer(uint32_t Stage, uint32_t Slot, const void* const PtrBuffer, uint32_t Offset)
+{
+	assert(Stage < KStageCount);
+	assert(Slot < KConstantBufferSlotCount);
+
+	if (m_bIsConstantBufferKnown[Stage][Slot] && m_BoundConstantBuffers[Stage][Slot] == PtrBuffer &&
+		m_BoundConstantBufferOffsets[Stage][Slot] == Offset)
+	{
+		++m_Counters.SkippedBindCount;
+		return false;
+	}
+
+	m_BoundConstantBuffers[Stage][Slot] = PtrBuffer;
+	m_BoundConstantBufferOffsets[Stage][Slot] = Offset;
+	m_bIsConstantBufferKnown[Stage][Slot] = true;
+	++m_Counters.IssuedBindCount;
+	return true;
+}
+
+bool CStateCache::IsConstantBufferBound(uint32_t Stage, uint32_t Slot, const void* const PtrBuffer) const
+{
+	assert(Stage < KStageCount);
+	assert(Slot < KConstantBufferSlotCount);
+
+	return m_bIsConstantBufferKnown[Stage][Slot] && m_BoundConstantBuffers[Stage][Slot] == PtrBuffer;
+}
+
+bool CStateCache::ShouldUpload(SUploadState& InOutUploadState, const void* const PtrData, size_t ByteWidth)
+{
+	uint64_t DataHash{ Hash(PtrData, ByteWidth) };
+	if (InOutUploadState.bIsValid && InOutUploadState.Hash == DataHash)
+	{
+		++m_Counters.SkippedUploadCount;
+		return false;
+	}
+
+	InOutUploadState.Hash = DataHash;
+	InOutUploadState.bIsValid = true;
+	++m_Counters.IssuedUploadCount;
+	return true;
+}
+
+void CStateCache::Invalidate()
+{
+	for (auto& bIsKnown : m_bIsShaderKnown) bIsKnown = false;
+	for (auto& bIsKnownPerStage : m_bIsConstantBufferKnown)
+	{
+		for (auto& bIsKnown : bIsKnownPerStage) bIsKnown = false;
+	}
+}
+
+void CStateCache::ResetCounters()
+{
+	m_Counters = SStateCacheCounters();
+}
+
+const SStateCacheCounters& CStateCache::GetCounters() const
+{
+	return m_Counters;
+}
+
+uint64_t CStateCache::Hash(const void* const PtrData, size_t ByteWidth)
+{
+	static constexpr uint64_t KOffsetBasis{ 0xCBF29CE484222325 };
+	static constexpr uint64_t KPrime{ 0x100000001B3 };
+
+	assert(PtrData);
+
+	// @important: constant buffers are 16-byte aligned, so 8 bytes are consumed at a time
+	const uint8_t* const Bytes{ (const uint8_t*)PtrData };
+	const size_t KWordByteWidth{ ByteWidth & ~(size_t)7 };
+	uint64_t Result{ KOffsetBasis };
+	for (size_t iByte = 0; iByte < KWordByteWidth; iByte += 8)
+	{
+		uint64_t Word{};
+		memcpy(&Word, Bytes + iByte, 8);
+		Result ^= Word;
+		Result *= KPrime;
+	}
+	for (size_t iByte = KWordByteWidth; iByte < ByteWidth; ++iByte)
+	{
+		Result ^= Bytes[iByte];
+		Result *= KPrime;
+	}
+	return Result;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+// @important: pure CPU (bindings are opaque pointers), so that it can be driven by a mock device context
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cassert>
+
+struct SStateCacheCounters
+{
+	uint32_t	IssuedBindCount{};
+	uint32_t	SkippedBindCount{};
+	uint32_t	IssuedUploadCount{};
+	uint32_t	SkippedUploadCount{};
+};
+
+// What was last uploaded to one buffer
+struct SUploadState
+{
+	uint64_t	Hash{};
+	bool		bIsValid{};
+};
+
+// Shadow copy of the shaders and the constant buffers bound to one device context
+// @important: anything that binds them without going through the cache must call Invalidate()
+class CStateCache
+{
+public:
+	CStateCache() {}
+	~CStateCache() {}
+
+public:
+	// One cache per device context (created on first use)
+	static CStateCache& Get(const void* const PtrDeviceContext);
+
+public:
+	bool ShouldBindShader(uint32_t Stage, const void* const PtrShader);
+	// Offset: for buffers that are bound by offset (see CConstantBufferRing)
+	bool ShouldBindConstantBuffer(uint32_t Stage, uint32_t Slot, const void* const PtrBuffer, uint32_t Offset = 0);
+	bool IsConstantBufferBound(uint32_t Stage, uint32_t Slot, const void* const PtrBuffer) const;
+	bool ShouldUpload(SUploadState& InOutUploadState, const void* const PtrData, size_t ByteWidth);
+
+	void Invalidate();
+	void ResetCounters();
+	const SStateCacheCounters& GetCounters() const;
+
+public:
+	// FNV-1a (over 8-byte words)
+	static uint64_t Hash(const void* const PtrData, size_t ByteWidth);
+
+public:
+	static constexpr uint32_t KStageCount{ 5 }; // same order as EShaderType
+	static constexpr uint32_t KConstantBufferSlotCount{ 14 };
+
+private:
+	const void*			m_BoundShaders[KStageCount]{};
+	const void*			m_BoundConstantBuffers[KStageCount][KConstantBufferSlotCount]{};
+	uint32_t			m_BoundConstantBufferOffsets[KStageCount][KConstantBufferSlotCount]{};
+	bool				m_bIsShaderKnown[KStageCount]{};
+	bool				m_bIsConstantBufferKnown[KStageCount][KConstantBufferSlotCount]{};
+
+	SStateCacheCounters	m_Counters{};
+};
@@ -0,0 +1,172 @@
+#include "TaskScheduler.h"
+#include <algorithm>
+
+using std::max;
+using std::vector;
+
+CTaskScheduler::~CTaskScheduler()
+{
+	// @important: tasks refer to data owned by someone else, so they must never outlive it
+	if (m_bIsStarted) Wait();
+
+	{
+		std::lock_guard<std::mutex> Lock{ m_Mutex };
+		m_bIsShuttingDown = true;
+	}
+	m_TaskReadyCondition.notify_all();
+
+	for (auto& Thread : m_vThreads)
+	{
+		Thread.join();
+	}
+}
+
+uint32_t CTaskScheduler::AddTask(const std::function<void()>& Function, const vector<uint32_t>& vDependencies)
+{
+	assert(!m_bIsStarted);
+
+	uint32_t TaskIndex{ (uint32_t)m_vTasks.size() };
+
+	STask Task{};
+	Task.Function = Function;
+	for (uint32_t Dependency : vDependencies)
+	{
+		assert(Dependency < TaskIndex);
+
+		m_vTasks[Dependency].vDependents.emplace_back(TaskIndex);
+		++Task.RemainingDependencyCount;
+	}
+	m_vTasks.emplace_back(std::move(Task));
+
+	return TaskIndex;
+}
+
+void CTaskScheduler::Start(uint32_t ThreadCount)
+{
+	assert(!m_bIsStarted);
+	m_bIsStarted = true;
+
+	if (m_vThreads.empty())
+	{
+		if (ThreadCount == 0) ThreadCount = max(std::thread::hardware_concurrency(), 2u) - 1;
+		for (uint32_t iThread = 0; iThread < ThreadCount; ++iThread)
+		{
+			m_vThreads.emplace_back(&CTaskScheduler::Work, this);
+		}
+	}
+
+	if (m_vTasks.empty()) return;
+
+	{
+		std::lock_guard<std::mutex> Lock{ m_Mutex };
+
+		// @important: reversed, so that the ready tasks are popped in the order they were added
+		for (uint32_t iTask = (uint32_t)m_vTasks.size(); iTask > 0; --iTask)
+		{
+			if (m_vTasks[iTask - 1].RemainingDependencyCount == 0) m_vReadyTaskIndices.emplace_back(iTask - 1);
+		}
+	}
+	m_TaskReadyCondition.notify_all();
+}
+
+void CTaskScheduler::WaitForTask(uint32_t TaskIndex)
+{
+	assert(m_bIsStarted);
+	assert(TaskIndex < m_vTasks.size());
+
+	std::unique_lock<std::mutex> Lock{ m_Mutex };
+	m_TaskFinishedCondition.wait(Lock, [&] { return m_vTasks[TaskIndex].bIsFinished; });
+}
+
+void CTaskScheduler::Wait(bool bShouldRunTasks)
+{
+	assert(m_bIsStarted);
+
+	const uint32_t KTaskCount{ (uint32_t)m_vTasks.size() };
+
+	std::unique_lock<std::mutex> Lock{ m_Mutex };
+	while (m_FinishedTaskCount < KTaskCount)
+	{
+		if (bShouldRunTasks && m_vReadyTaskIndices.size())
+		{
+			RunReadyTask(Lock);
+			continue;
+		}
+
+		m_TaskFinishedCondition.wait(Lock, [&]
+			{
+				return (m_FinishedTaskCount == KTaskCount) || (bShouldRunTasks && m_vReadyTaskIndices.size());
+			});
+	}
+}
+
+void CTaskScheduler::Reset()
+{
+	assert(!m_bIsStarted || IsFinished());
+
+	std::lock_guard<std::mutex> Lock{ m_Mutex };
+	m_vTasks.clear();
+	m_vReadyTaskIndices.clear();
+	m_FinishedTaskCount = 0;
+	m_bIsStarted = false;
+}
+
+bool CTaskScheduler::IsTaskFinished(uint32_t TaskIndex) const
+{
+	assert(TaskIndex < m_vTasks.size());
+
+	std::lock_guard<std::mutex> Lock{ m_Mutex };
+	return m_vTasks[TaskIndex].bIsFinished;
+}
+
+bool CTaskScheduler::IsFinished() const
+{
+	std::lock_guard<std::mutex> Lock{ m_Mutex };
+	return (m_FinishedTaskCount == (uint32_t)m_vTasks.size());
+}
+
+uint32_t CTaskScheduler::GetTaskCount() const
+{
+	return (uint32_t)m_vTasks.size();
+}
+
+uint32_t CTaskScheduler::GetFinishedTaskCount() const
+{
+	std::lock_guard<std::mutex> Lock{ m_Mutex };
+	return m_FinishedTaskCount;
+}
+
+void CTaskScheduler::Work()
+{
+	std::unique_lock<std::mutex> Lock{ m_Mutex };
+	while (true)
+	{
+		m_TaskReadyCondition.wait(Lock, [&] { return m_vReadyTaskIndices.size() || m_bIsShuttingDown; });
+		if (m_vReadyTaskIndices.empty()) break; // shutting down
+
+		RunReadyTask(Lock);
+	}
+}
+
+void CTaskScheduler::RunReadyTask(std::unique_lock<std::mutex>& Lock)
+{
+	uint32_t TaskIndex{ m_vReadyTaskIndices.back() };
+	m_vReadyTaskIndices.pop_back();
+
+	// @important: the function and the dependents of a task never change after Start()
+	Lock.unlock();
+	m_vTasks[TaskIndex].Function();
+	Lock.lock();
+
+	STask& Task{ m_vTasks[TaskIndex] };
+	Task.bIsFinished = true;
+	++m_FinishedTaskCount;
+
+	for (uint32_t Dependent : Task.vDependents)
+	{
+		if (--m_vTasks[Dependent].RemainingDependencyCount == 0) m_vReadyTaskIndices.emplace_back(Dependent);
+	}
+
+	m_TaskReadyCondition.notify_all();
+	m_TaskFinishedCondition.notify_all();
+}
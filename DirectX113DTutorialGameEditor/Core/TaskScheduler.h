@@ -0,0 +1,73 @@
+#pragma once
+
+// @important: pure CPU, tasks must never touch the device context
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cassert>
+
+// Runs tasks on a pool of worker threads, each task as soon as every task it depends on has finished
+// @important: tasks are added before Start(), and a task can only depend on tasks added before it
+// The workers are kept between batches (see Reset()), so that per-frame work doesn't create threads every frame
+class CTaskScheduler
+{
+public:
+	CTaskScheduler() {}
+	~CTaskScheduler();
+
+	CTaskScheduler(const CTaskScheduler&) = delete;
+	CTaskScheduler& operator=(const CTaskScheduler&) = delete;
+
+public:
+	// Returns the task index
+	uint32_t AddTask(const std::function<void()>& Function, const std::vector<uint32_t>& vDependencies = {});
+
+	// ThreadCount 0 means one per hardware thread but the calling one, which usually has other work to do
+	// @important: the workers are created by the first Start() only, later batches run on the same workers
+	void Start(uint32_t ThreadCount = 0);
+
+	// Blocks until the task has finished
+	void WaitForTask(uint32_t TaskIndex);
+	// Blocks until every task has finished
+	// If bShouldRunTasks is true, the calling thread runs ready tasks while it waits
+	void Wait(bool bShouldRunTasks = false);
+
+	// Removes every task so that the next batch can be added, the workers are kept
+	// @important: every task must have finished
+	void Reset();
+
+public:
+	bool IsTaskFinished(uint32_t TaskIndex) const;
+	bool IsFinished() const;
+	uint32_t GetTaskCount() const;
+	uint32_t GetFinishedTaskCount() const;
+
+private:
+	void Work();
+	// @important: Lock must own m_Mutex and there must be a ready task
+	void RunReadyTask(std::unique_lock<std::mutex>& Lock);
+
+private:
+	struct STask
+	{
+		std::function<void()>	Function{};
+		std::vector<uint32_t>	vDependents{};
+		uint32_t				RemainingDependencyCount{};
+		bool					bIsFinished{};
+	};
+
+private:
+	std::vector<STask>			m_vTasks{};
+	std::vector<uint32_t>		m_vReadyTaskIndices{}; // LIFO
+	uint32_t					m_FinishedTaskCount{};
+	bool						m_bIsStarted{};
+	bool						m_bIsShuttingDown{};
+
+	std::vector<std::thread>	m_vThreads{};
+	mutable std::mutex			m_Mutex{};
+	std::condition_variable		m_TaskReadyCondition{};
+	std::condition_variable		m_TaskFinishedCondition{};
+};
@@ -58,13 +58,16 @@ void CTerrain::Create(const XMFLOAT2& TerrainSize, const CMaterialData& Material
 
 void CTerrain::Load(const string& FileName)
 {
-	m_vFoliages.clear();
+	Load(DecodeFile(FileName));
+}
 
-	m_TerrainFileData = make_unique<STERRData>(KTessFactorMin, KTessFactorMin, KMaskingDefaultDetail, KDefaultFoliagePlacingDetail);
-	m_TerrainFileData->FileName = FileName;
+void CTerrain::Load(std::unique_ptr<STERRData> TerrainFileData)
+{
+	assert(TerrainFileData);
 
-	CMeshPorter MeshPorter{};
-	MeshPorter.ImportTerrain(FileName, *m_TerrainFileData);
+	m_vFoliages.clear();
+
+	m_TerrainFileData = std::move(TerrainFileData);
 
 	m_CBTerrainData.TerrainSizeX = m_TerrainFileData->SizeX;
 	m_CBTerrainData.TerrainSizeZ = m_TerrainFileData->SizeZ;
@@ -88,7 +91,18 @@ void CTerrain::Load(const string& FileName)
 	}
 }
 
-bool CTerrain::Save(const string& FileName)
+std::unique_ptr<STERRData> CTerrain::DecodeFile(const string& FileName)
+{
+	auto TerrainFileData{ make_unique<STERRData>(KTessFactorMin, KTessFactorMin, KMaskingDefaultDetail, KDefaultFoliagePlacingDetail) };
+	TerrainFileData->FileName = FileName;
+
+	CMeshPorter MeshPorter{};
+	MeshPorter.ImportTerrain(FileName, *TerrainFileData);
+
+	return TerrainFileData;
+}
+
+bool CTerrain::Save(const string& FileName, bool bShouldCompress)
 {
 	if (!m_Object3DTerrain) return false;
 
@@ -101,7 +115,7 @@ bool CTerrain::Save(const string& FileName)
 		m_TerrainFileData->vFoliageData[iFoliage].vInstanceData = m_vFoliages[iFoliage]->GetInstanceCPUDataVector();
 	}
 	
-	MeshPorter.ExportTerrain(FileName, *m_TerrainFileData);
+	MeshPorter.ExportTerrain(FileName, *m_TerrainFileData, bShouldCompress);
 
 	m_TerrainFileData->bShouldSave = false;
 
@@ -1002,7 +1016,7 @@ void CTerrain::DrawTerrain(bool bDrawNormals)
 
 	if (bDrawNormals)
 	{
-		m_PtrDeviceContext->GSSetShader(nullptr, nullptr, 0);
+		CShader::Unbind(m_PtrDeviceContext, EShaderType::GeometryShader);
 	}
 }
 
@@ -1023,8 +1037,8 @@ void CTerrain::DrawWater()
 
 	//m_PtrDeviceContext->OMSetDepthStencilState(m_PtrGame->GetCommonStates()->DepthDefault(), 0);
 
-	m_PtrDeviceContext->HSSetShader(nullptr, nullptr, 0);
-	m_PtrDeviceContext->DSSetShader(nullptr, nullptr, 0);
+	CShader::Unbind(m_PtrDeviceContext, EShaderType::HullShader);
+	CShader::Unbind(m_PtrDeviceContext, EShaderType::DomainShader);
 }
 
 void CTerrain::DrawFoliageCluster()
@@ -1041,8 +1055,8 @@ void CTerrain::DrawFoliageCluster()
 	m_PtrGame->GetBaseShader(CGame::EBaseShader::VSFoliage)->Use();
 	m_PtrGame->GetBaseShader(CGame::EBaseShader::PSFoliage)->Use();
 
-	m_PtrDeviceContext->HSSetShader(nullptr, nullptr, 0);
-	m_PtrDeviceContext->DSSetShader(nullptr, nullptr, 0);
+	CShader::Unbind(m_PtrDeviceContext, EShaderType::HullShader);
+	CShader::Unbind(m_PtrDeviceContext, EShaderType::DomainShader);
 
 	for (const auto& Foliage : m_vFoliages)
 	{
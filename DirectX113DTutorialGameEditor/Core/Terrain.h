@@ -60,7 +60,13 @@ public:
 public:
 	void Create(const XMFLOAT2& TerrainSize, const CMaterialData& MaterialData, uint32_t MaskingDetail, float UniformScaling = 1.0f);
 	void Load(const std::string& FileName);
-	bool Save(const std::string& FileName);
+	// Creates the resources of terrain data that has already been decoded (see DecodeFile())
+	void Load(std::unique_ptr<STERRData> TerrainFileData);
+	bool Save(const std::string& FileName, bool bShouldCompress = false);
+
+public:
+	// CPU stage of Load(), needs no device so that it can be run on any thread
+	static std::unique_ptr<STERRData> DecodeFile(const std::string& FileName);
 
 private:
 	void Scale(const XMVECTOR& Scaling);
@@ -0,0 +1,171 @@
+#include "TextureRegistry.h"
+#include "StateCache.h"
+#include <cctype>
+#include <cstdio>
+
+using std::string;
+using std::vector;
+
+CTextureRegistry& CTextureRegistry::Get()
+{
+	static CTextureRegistry s_TextureRegistry{};
+	return s_TextureRegistry;
+}
+
+bool CTextureRegistry::Acquire(const string& Key, uint32_t& OutHandle)
+{
+	auto found{ m_umapHandles.find(Key) };
+	if (found != m_umapHandles.end())
+	{
+		OutHandle = found->second;
+
+		SEntry& Entry{ m_vEntries[OutHandle] };
+		++Entry.ReferenceCount;
+
+		++m_Counters.HitCount;
+		++m_Counters.ReferenceCount;
+		m_Counters.SharedByteCount += Entry.ResidentByteCount;
+		return true;
+	}
+
+	if (m_vFreeHandles.size())
+	{
+		OutHandle = m_vFreeHandles.back();
+		m_vFreeHandles.pop_back();
+	}
+	else
+	{
+		OutHandle = (uint32_t)m_vEntries.size();
+		m_vEntries.emplace_back();
+	}
+
+	SEntry& Entry{ m_vEntries[OutHandle] };
+	Entry.Key = Key;
+	Entry.ReferenceCount = 1;
+	Entry.ResidentByteCount = 0;
+	m_umapHandles.emplace(Key, OutHandle);
+
+	++m_Counters.MissCount;
+	++m_Counters.TextureCount;
+	++m_Counters.ReferenceCount;
+	return false;
+}
+
+bool CTextureRegistry::Release(uint32_t Handle)
+{
+	assert(Handle < m_vEntries.size());
+
+	SEntry& Entry{ m_vEntries[Handle] };
+	assert(Entry.ReferenceCount);
+
+	--Entry.ReferenceCount;
+	--m_Counters.ReferenceCount;
+	if (Entry.ReferenceCount)
+	{
+		m_Counters.SharedByteCount -= Entry.ResidentByteCount;
+		return false;
+	}
+
+	m_Counters.ResidentByteCount -= Entry.ResidentByteCount;
+	--m_Counters.TextureCount;
+
+	m_umapHandles.erase(Entry.Key);
+	Entry = SEntry{};
+	m_vFreeHandles.emplace_back(Handle);
+	return true;
+}
+
+void CTextureRegistry::SetResidentByteCount(uint32_t Handle, uint64_t ByteCount)
+{
+	assert(Handle < m_vEntries.size());
+
+	SEntry& Entry{ m_vEntries[Handle] };
+	assert(Entry.ReferenceCount);
+
+	m_Counters.ResidentByteCount -= Entry.ResidentByteCount;
+	m_Counters.SharedByteCount -= Entry.ResidentByteCount * (Entry.ReferenceCount - 1);
+
+	Entry.ResidentByteCount = ByteCount;
+
+	m_Counters.ResidentByteCount += Entry.ResidentByteCount;
+	m_Counters.SharedByteCount += Entry.ResidentByteCount * (Entry.ReferenceCount - 1);
+}
+
+void CTextureRegistry::ResetCounters()
+{
+	m_Counters.HitCount = 0;
+	m_Counters.MissCount = 0;
+}
+
+uint32_t CTextureRegistry::GetReferenceCount(uint32_t Handle) const
+{
+	assert(Handle < m_vEntries.size());
+
+	return m_vEntries[Handle].ReferenceCount;
+}
+
+const string& CTextureRegistry::GetKey(uint32_t Handle) const
+{
+	assert(Handle < m_vEntries.size());
+
+	return m_vEntries[Handle].Key;
+}
+
+const STextureRegistryCounters& CTextureRegistry::GetCounters() const
+{
+	return m_Counters;
+}
+
+string CTextureRegistry::MakeFileKey(const string& FileName, bool bHasMipMaps)
+{
+	// e.g. "Asset/Dungeon/../Stone.PNG" -> "file:asset\stone.png"
+	vector<string> vComponents{};
+	string Component{};
+	for (size_t iChar = 0; iChar <= FileName.size(); ++iChar)
+	{
+		char Char{ (iChar < FileName.size()) ? FileName[iChar] : '/' };
+		if (Char == '/' || Char == '\\')
+		{
+			if (Component == "..")
+			{
+				// @important: leading ".." can't be resolved lexically, so they are kept
+				if (vComponents.size() && vComponents.back() != "..")
+				{
+					vComponents.pop_back();
+				}
+				else
+				{
+					vComponents.emplace_back(Component);
+				}
+			}
+			else if (Component.size() && Component != ".")
+			{
+				vComponents.emplace_back(Component);
+			}
+			Component.clear();
+			continue;
+		}
+		Component += (char)tolower((unsigned char)Char);
+	}
+
+	string Key{ "file:" };
+	for (size_t iComponent = 0; iComponent < vComponents.size(); ++iComponent)
+	{
+		if (iComponent) Key += '\\';
+		Key += vComponents[iComponent];
+	}
+	if (!bHasMipMaps) Key += "|nomip";
+	return Key;
+}
+
+string CTextureRegistry::MakeMemoryKey(const uint8_t* const PtrData, size_t ByteCount, bool bHasMipMaps)
+{
+	// @important: the byte count is part of the key, so that a hash collision also needs the same size
+	char Buffer[64]{};
+	snprintf(Buffer, sizeof(Buffer), "mem:%016llx:%llu",
+		(unsigned long long)CStateCache::Hash(PtrData, ByteCount), (unsigned long long)ByteCount);
+
+	string Key{ Buffer };
+	if (!bHasMipMaps) Key += "|nomip";
+	return Key;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+// @important: pure CPU (the textures themselves are kept by CTexture, indexed by handle), so that it can be tested without a device
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cassert>
+
+struct STextureRegistryCounters
+{
+	uint64_t	HitCount{};
+	uint64_t	MissCount{};
+	uint32_t	TextureCount{};
+	uint32_t	ReferenceCount{};
+	uint64_t	ResidentByteCount{};
+	uint64_t	SharedByteCount{}; // that would be resident on top of ResidentByteCount without sharing
+};
+
+// Reference counted textures keyed by normalized file name or by the hash of embedded data,
+// so that every material referring to the same texture shares one copy of it
+// @important: not thread-safe, textures are created on the main thread
+class CTextureRegistry
+{
+public:
+	CTextureRegistry() {}
+	~CTextureRegistry() {}
+
+public:
+	// Process-wide
+	static CTextureRegistry& Get();
+
+public:
+	// Adds a reference and returns true if the key was registered (a hit)
+	// On a miss the caller creates the texture and calls SetResidentByteCount(), or Release() if it fails
+	bool Acquire(const std::string& Key, uint32_t& OutHandle);
+	// Returns true when the last reference was removed, so that the caller can release the texture
+	bool Release(uint32_t Handle);
+	void SetResidentByteCount(uint32_t Handle, uint64_t ByteCount);
+
+	// Hits & misses only
+	void ResetCounters();
+
+public:
+	uint32_t GetReferenceCount(uint32_t Handle) const;
+	const std::string& GetKey(uint32_t Handle) const;
+	const STextureRegistryCounters& GetCounters() const;
+
+public:
+	// Separators, "." and ".." are normalized and the case is ignored (as the file system does)
+	static std::string MakeFileKey(const std::string& FileName, bool bHasMipMaps);
+	static std::string MakeMemoryKey(const uint8_t* const PtrData, size_t ByteCount, bool bHasMipMaps);
+
+public:
+	static constexpr uint32_t KInvalidHandle{ UINT32_MAX };
+
+private:
+	struct SEntry
+	{
+		std::string	Key{};
+		uint32_t	ReferenceCount{};
+		uint64_t	ResidentByteCount{};
+	};
+
+private:
+	std::vector<SEntry>							m_vEntries{}; // indexed by handle
+	std::vector<uint32_t>						m_vFreeHandles{};
+	std::unordered_map<std::string, uint32_t>	m_umapHandles{};
+	STextureRegistryCounters					m_Counters{};
+};
@@ -0,0 +1,358 @@
+#include "AssetCooker.h"
+#include "../Core/TaskScheduler.h"
+#include "../Core/Material.h"
+#include "../Model/AssimpLoader.h"
+#include "../Model/MeshPorter.h"
+#include "../Model/Object3D.h"
+#include "../DirectXTex/DirectXTex.h"
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+
+using std::string;
+using std::wstring;
+using std::vector;
+using std::chrono::steady_clock;
+namespace fs = std::filesystem;
+
+static string GetUpperCaseExtension(const string& FileName)
+{
+	size_t ExtensionDot{ FileName.find_last_of('.') };
+	if (ExtensionDot == string::npos) return string{};
+
+	string Extension{ FileName.substr(ExtensionDot) };
+	for (char& ch : Extension)
+	{
+		ch = toupper(ch);
+	}
+	return Extension;
+}
+
+bool CAssetCooker::Cook(const string& SourceDirectory, const string& OutputDirectory, uint32_t ThreadCount)
+{
+	auto StartTimePoint{ steady_clock::now() };
+
+	m_SourceDirectory = SourceDirectory;
+	m_OutputDirectory = OutputDirectory;
+	m_vAssets.clear();
+
+	std::error_code ErrorCode{};
+	if (!fs::is_directory(m_SourceDirectory, ErrorCode))
+	{
+		printf("[AssetCooker] Source directory not found: %s\n", m_SourceDirectory.c_str());
+		return false;
+	}
+	fs::create_directories(m_OutputDirectory, ErrorCode);
+
+	// @important: a manifest of another cooker version is dropped, so that a new cooker recooks everything
+	const string KManifestPath{ (fs::path(m_OutputDirectory) / KManifestFileName).string() };
+	m_Manifest.Load(KManifestPath, KCookerVersion);
+
+	// Gather assets
+	for (const auto& Entry : fs::recursive_directory_iterator(m_SourceDirectory, ErrorCode))
+	{
+		if (!Entry.is_regular_file()) continue;
+
+		// @important: the output directory may be inside the source directory
+		fs::path RelativeToOutput{ Entry.path().lexically_relative(m_OutputDirectory) };
+		if (!RelativeToOutput.empty() && *RelativeToOutput.begin() != "..") continue;
+
+		string SourceFileName{ Entry.path().string() };
+		bool bIsAsset{};
+		EAssetType eType{ GetAssetType(SourceFileName, bIsAsset) };
+		if (!bIsAsset) continue;
+
+		fs::path OutputPath{ fs::path(m_OutputDirectory) / Entry.path().lexically_relative(m_SourceDirectory) };
+		OutputPath.replace_extension((eType == EAssetType::Model) ? ".MESH" : ".dds");
+
+		m_vAssets.emplace_back();
+		SAsset& Asset{ m_vAssets.back() };
+		Asset.eType = eType;
+		Asset.SourceFileName = SourceFileName;
+		Asset.OutputFileName = OutputPath.string();
+		Asset.ManifestKey = OutputPath.lexically_relative(m_OutputDirectory).generic_string();
+	}
+	std::sort(m_vAssets.begin(), m_vAssets.end(), [](const SAsset& A, const SAsset& B) { return A.SourceFileName < B.SourceFileName; });
+
+	// Cook
+	{
+		CTaskScheduler TaskScheduler{};
+		for (SAsset& Asset : m_vAssets)
+		{
+			SAsset* const PtrAsset{ &Asset };
+			TaskScheduler.AddTask([this, PtrAsset]() { CookAsset(*PtrAsset); });
+		}
+		TaskScheduler.Start(ThreadCount);
+		TaskScheduler.Wait();
+	}
+
+	// @important: failed assets are dropped from the manifest, so that they are retried next time
+	bool bHasFailed{};
+	for (const SAsset& Asset : m_vAssets)
+	{
+		if (Asset.eResult == EResult::Failed)
+		{
+			m_Manifest.Remove(Asset.ManifestKey);
+			bHasFailed = true;
+		}
+		else
+		{
+			m_Manifest.Set(Asset.ManifestKey, Asset.SourceHash);
+		}
+	}
+	m_Manifest.Save(KManifestPath, KCookerVersion);
+
+	m_TotalMilliseconds = std::chrono::duration<double, std::milli>(steady_clock::now() - StartTimePoint).count();
+	return !bHasFailed;
+}
+
+void CAssetCooker::PrintReport() const
+{
+	static constexpr const char* KResultNames[]{ "cooked", "up-to-date", "FAILED" };
+
+	uint32_t ResultCounts[3]{};
+	double CookMilliseconds{};
+	for (const SAsset& Asset : m_vAssets)
+	{
+		++ResultCounts[(size_t)Asset.eResult];
+		CookMilliseconds += Asset.Milliseconds;
+
+		printf("[%-10s] %8.1f ms  %s -> %s", KResultNames[(size_t)Asset.eResult], Asset.Milliseconds,
+			Asset.SourceFileName.c_str(), Asset.OutputFileName.c_str());
+		if (Asset.Message.size()) printf("  (%s)", Asset.Message.c_str());
+		if (Asset.eType == EAssetType::Model && Asset.eResult == EResult::Cooked)
+		{
+			const SMeshOptimizationStatistics& Statistics{ Asset.MeshOptimization };
+			printf("  ACMR %.3f -> %.3f, ATVR %.3f -> %.3f",
+				Statistics.Before.ACMR, Statistics.After.ACMR, Statistics.Before.ATVR, Statistics.After.ATVR);
+		}
+		printf("\n");
+	}
+	printf("%u cooked, %u up-to-date, %u failed: %.1f ms (%.1f ms of work)\n",
+		ResultCounts[(size_t)EResult::Cooked], ResultCounts[(size_t)EResult::UpToDate], ResultCounts[(size_t)EResult::Failed],
+		m_TotalMilliseconds, CookMilliseconds);
+}
+
+const vector<CAssetCooker::SAsset>& CAssetCooker::GetAssets() const
+{
+	return m_vAssets;
+}
+
+void CAssetCooker::CookAsset(SAsset& Asset) const
+{
+	auto StartTimePoint{ steady_clock::now() };
+
+	// @important: the hash is seeded with the cooker version, so that a new cooker recooks everything
+	bool bIsRead{};
+	Asset.SourceHash = CAssetManifest::HashFile(Asset.SourceFileName, KCookerVersion, bIsRead);
+	if (!bIsRead)
+	{
+		Asset.eResult = EResult::Failed;
+		Asset.Message = "can't read the source";
+	}
+	else
+	{
+		if (m_Manifest.IsUpToDate(Asset.ManifestKey, Asset.SourceHash, Asset.OutputFileName))
+		{
+			Asset.eResult = EResult::UpToDate;
+		}
+		else
+		{
+			std::error_code ErrorCode{};
+			fs::create_directories(fs::path(Asset.OutputFileName).parent_path(), ErrorCode);
+
+			bool bIsCooked{ (Asset.eType == EAssetType::Model) ? CookModel(Asset) : CookTexture(Asset) };
+			Asset.eResult = (bIsCooked) ? EResult::Cooked : EResult::Failed;
+		}
+	}
+
+	Asset.Milliseconds = std::chrono::duration<double, std::milli>(steady_clock::now() - StartTimePoint).count();
+}
+
+bool CAssetCooker::CookModel(SAsset& Asset) const
+{
+	bool bIsRigged{};
+	if (!CAssimpLoader::ProbeModelFile(Asset.SourceFileName, bIsRigged))
+	{
+		Asset.Message = "Assimp can't read it";
+		return false;
+	}
+
+	// @important: the loader doesn't create any resource, so it's given no device
+	SMESHData Model{};
+	CAssimpLoader AssimpLoader{};
+	if (bIsRigged)
+	{
+		AssimpLoader.LoadAnimatedModelFromFile(Asset.SourceFileName, &Model, nullptr, nullptr);
+	}
+	else
+	{
+		AssimpLoader.LoadStaticModelFromFile(Asset.SourceFileName, &Model, nullptr, nullptr);
+	}
+	Model.bIsModelRigged = bIsRigged;
+	Asset.MeshOptimization = AssimpLoader.GetMeshOptimizationStatistics();
+
+	// Post-processing (tangents and the vertex cache & fetch order are done by the loader)
+	CObject3D::CalculateEditorBoundingSphereData(Model);
+	CObject3D::GenerateMeshLODs(Model, CObject3D::KDefaultMeshLODCount);
+
+	// @important: external textures in the source directory are cooked as well, so they are referred to by their DDS
+	for (CMaterialData& MaterialData : Model.vMaterialData)
+	{
+		for (int iTexture = 0; iTexture < KMaxTextureCountPerMaterial; ++iTexture)
+		{
+			STextureData& TextureData{ MaterialData.GetTextureData((ETextureType)iTexture) };
+			if (!TextureData.bHasTexture || TextureData.FileName.empty()) continue;
+
+			string CookedTextureFileName{ GetCookedTextureFileName(Asset.SourceFileName, TextureData.FileName) };
+			if (CookedTextureFileName.size()) TextureData.FileName = CookedTextureFileName;
+		}
+	}
+
+	// @important: always compressed, since cooked MESH files are read once and shipped
+	CMeshPorter MeshPorter{};
+	MeshPorter.ExportMESH(Asset.OutputFileName, Model, true);
+
+	std::error_code ErrorCode{};
+	if (!fs::exists(Asset.OutputFileName, ErrorCode))
+	{
+		Asset.Message = "can't write the output";
+		return false;
+	}
+	return true;
+}
+
+bool CAssetCooker::CookTexture(SAsset& Asset) const
+{
+	wstring wSourceFileName{ fs::path(Asset.SourceFileName).wstring() };
+	wstring wOutputFileName{ fs::path(Asset.OutputFileName).wstring() };
+	string Extension{ GetUpperCaseExtension(Asset.SourceFileName) };
+
+	// @important: DDS files are already GPU-ready
+	if (Extension == ".DDS")
+	{
+		std::error_code ErrorCode{};
+		if (!fs::copy_file(Asset.SourceFileName, Asset.OutputFileName, fs::copy_options::overwrite_existing, ErrorCode))
+		{
+			Asset.Message = "can't copy it";
+			return false;
+		}
+		return true;
+	}
+
+	// @important: WIC needs COM on every thread that uses it
+	HRESULT hrCOM{ CoInitializeEx(nullptr, COINIT_MULTITHREADED) };
+
+	bool bResult{ false };
+	ScratchImage SourceImage{};
+	TexMetadata Metadata{};
+	HRESULT hr{ (Extension == ".TGA") ?
+		LoadFromTGAFile(wSourceFileName.c_str(), &Metadata, SourceImage) :
+		LoadFromWICFile(wSourceFileName.c_str(), WIC_FLAGS_NONE, &Metadata, SourceImage) };
+	if (FAILED(hr))
+	{
+		Asset.Message = "can't decode it";
+	}
+	else
+	{
+		ScratchImage MipChain{};
+		if (Metadata.mipLevels == 1 && (Metadata.width > 1 || Metadata.height > 1))
+		{
+			hr = GenerateMipMaps(SourceImage.GetImages(), SourceImage.GetImageCount(), Metadata, TEX_FILTER_DEFAULT, 0, MipChain);
+		}
+		else
+		{
+			MipChain = std::move(SourceImage);
+		}
+
+		if (FAILED(hr))
+		{
+			Asset.Message = "can't generate the mipmaps";
+		}
+		else
+		{
+			const TexMetadata& MipMetadata{ MipChain.GetMetadata() };
+
+			// @important: block compression needs the top level to be a multiple of 4 (D3D11), otherwise it's kept uncompressed
+			if (MipMetadata.width % 4 == 0 && MipMetadata.height % 4 == 0)
+			{
+				bool bIsSRGB{ IsSRGB(MipMetadata.format) };
+				DXGI_FORMAT Format{ (MipChain.IsAlphaAllOpaque()) ?
+					((bIsSRGB) ? DXGI_FORMAT_BC1_UNORM_SRGB : DXGI_FORMAT_BC1_UNORM) :
+					((bIsSRGB) ? DXGI_FORMAT_BC3_UNORM_SRGB : DXGI_FORMAT_BC3_UNORM) };
+
+				ScratchImage CompressedImage{};
+				hr = Compress(MipChain.GetImages(), MipChain.GetImageCount(), MipMetadata, Format, TEX_COMPRESS_DEFAULT,
+					TEX_THRESHOLD_DEFAULT, CompressedImage);
+				if (SUCCEEDED(hr))
+				{
+					hr = SaveToDDSFile(CompressedImage.GetImages(), CompressedImage.GetImageCount(), CompressedImage.GetMetadata(),
+						DDS_FLAGS_NONE, wOutputFileName.c_str());
+				}
+			}
+			else
+			{
+				hr = SaveToDDSFile(MipChain.GetImages(), MipChain.GetImageCount(), MipMetadata, DDS_FLAGS_NONE, wOutputFileName.c_str());
+			}
+
+			if (FAILED(hr))
+			{
+				Asset.Message = "can't compress or write it";
+			}
+			else
+			{
+				bResult = true;
+			}
+		}
+	}
+
+	if (SUCCEEDED(hrCOM)) CoUninitialize();
+
+	return bResult;
+}
+
+string CAssetCooker::GetCookedTextureFileName(const string& ModelFileName, const string& TextureFileName) const
+{
+	// @important: model files refer to textures either as they are (relative to the working directory) or relative to the model
+	std::error_code ErrorCode{};
+	fs::path TexturePath{ TextureFileName };
+	if (!fs::exists(TexturePath, ErrorCode))
+	{
+		TexturePath = fs::path(ModelFileName).parent_path() / TextureFileName;
+		if (!fs::exists(TexturePath, ErrorCode))
+		{
+			TexturePath = fs::path(ModelFileName).parent_path() / fs::path(TextureFileName).filename();
+			if (!fs::exists(TexturePath, ErrorCode)) return string{};
+		}
+	}
+
+	bool bIsAsset{};
+	if (GetAssetType(TexturePath.string(), bIsAsset) != EAssetType::Texture || !bIsAsset) return string{};
+
+	fs::path RelativePath{ fs::weakly_canonical(TexturePath, ErrorCode).lexically_relative(fs::weakly_canonical(m_SourceDirectory, ErrorCode)) };
+	if (RelativePath.empty() || *RelativePath.begin() == "..") return string{};
+
+	fs::path CookedPath{ fs::path(m_OutputDirectory) / RelativePath };
+	CookedPath.replace_extension(".dds");
+	return CookedPath.string();
+}
+
+CAssetCooker::EAssetType CAssetCooker::GetAssetType(const string& FileName, bool& bOutIsAsset)
+{
+	static constexpr const char* KModelExtensions[]{ ".FBX", ".OBJ", ".DAE", ".3DS", ".BLEND", ".GLTF", ".GLB" };
+	static constexpr const char* KTextureExtensions[]{ ".PNG", ".JPG", ".JPEG", ".BMP", ".TGA", ".TIF", ".TIFF", ".DDS" };
+
+	string Extension{ GetUpperCaseExtension(FileName) };
+	bOutIsAsset = true;
+	for (const char* const ModelExtension : KModelExtensions)
+	{
+		if (Extension == ModelExtension) return EAssetType::Model;
+	}
+	for (const char* const TextureExtension : KTextureExtensions)
+	{
+		if (Extension == TextureExtension) return EAssetType::Texture;
+	}
+	bOutIsAsset = false;
+	return EAssetType::Model;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// @important: needs no device nor window, so that assets can be cooked from the command line (see main.cpp)
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "../Core/MeshOptimizer.h"
+#include "../Core/AssetManifest.h"
+
+// Converts the models (FBX, OBJ, ...) of a directory into compressed MESH files and its textures into block compressed DDS files with mipmaps,
+// one task per asset on worker threads, so that shipping builds never import through Assimp nor decode images at runtime
+// Assets whose source hasn't changed since they were last cooked (by content hash, see the manifest) are skipped
+class CAssetCooker
+{
+public:
+	enum class EAssetType
+	{
+		Model,
+		Texture
+	};
+
+	enum class EResult
+	{
+		Cooked,
+		UpToDate,
+		Failed
+	};
+
+	struct SAsset
+	{
+		EAssetType	eType{};
+		std::string	SourceFileName{};
+		std::string	OutputFileName{};
+		std::string	ManifestKey{}; // output file name relative to the output directory
+		uint64_t	SourceHash{};
+		EResult		eResult{};
+		double		Milliseconds{};
+		std::string	Message{}; // why it failed
+
+		SMeshOptimizationStatistics	MeshOptimization{}; // models only
+	};
+
+public:
+	CAssetCooker() {}
+	~CAssetCooker() {}
+
+public:
+	// ThreadCount 0 means one per hardware thread but the calling one
+	// Returns false if any asset failed
+	bool Cook(const std::string& SourceDirectory, const std::string& OutputDirectory, uint32_t ThreadCount = 0);
+	// One line per asset and the totals, to stdout
+	void PrintReport() const;
+
+public:
+	const std::vector<SAsset>& GetAssets() const;
+
+private:
+	void CookAsset(SAsset& Asset) const;
+	bool CookModel(SAsset& Asset) const;
+	bool CookTexture(SAsset& Asset) const;
+
+	// Where the texture a model refers to is cooked to, or an empty string if it's not in the source directory
+	std::string GetCookedTextureFileName(const std::string& ModelFileName, const std::string& TextureFileName) const;
+
+private:
+	static EAssetType GetAssetType(const std::string& FileName, bool& bOutIsAsset);
+
+private:
+	static constexpr uint32_t KCookerVersion{ 3 }; // @important: increase it whenever the output of the cooker changes
+	static constexpr char KManifestFileName[]{ "AssetCooker.manifest" };
+
+private:
+	std::string				m_SourceDirectory{};
+	std::string				m_OutputDirectory{};
+	std::vector<SAsset>		m_vAssets{};
+	CAssetManifest			m_Manifest{};
+	double					m_TotalMilliseconds{};
+};
@@ -0,0 +1,434 @@
+#include "AnimationCompressor.h"
+#include <chrono>
+
+using std::vector;
+using std::string;
+using std::max;
+using std::min;
+
+using SKey = SMeshAnimation::SNodeAnimation::SKey;
+
+static constexpr float KSqrt2{ 1.41421356f };
+static constexpr float KInvSqrt2{ 0.70710678f };
+
+// Worst-case rotation error (radians) of smallest-three quantization
+// Each stored component is off by at most half a step (1 / (sqrt(2) * 32767)), the reconstructed component adds up to twice that,
+// and the angle is twice the quaternion difference
+static constexpr float KQuaternionQuantizationError{ 2.0f * 4.0f * KInvSqrt2 / 32767.0f };
+
+void CAnimationCompressor::Compress(const SMeshAnimation& Animation, std::vector<SCompressedNodeAnimation>& vOutNodeAnimations) const
+{
+	vOutNodeAnimations.clear();
+	vOutNodeAnimations.resize(Animation.vNodeAnimations.size());
+	for (size_t iNodeAnimation = 0; iNodeAnimation < Animation.vNodeAnimations.size(); ++iNodeAnimation)
+	{
+		const SMeshAnimation::SNodeAnimation& NodeAnimation{ Animation.vNodeAnimations[iNodeAnimation] };
+		SCompressedNodeAnimation& CompressedNodeAnimation{ vOutNodeAnimations[iNodeAnimation] };
+
+		CompressedNodeAnimation.Index = NodeAnimation.Index;
+		CompressedNodeAnimation.Name = NodeAnimation.Name;
+
+		CompressTrack(NodeAnimation.vPositionKeys, false, m_Settings.PositionErrorBudget, CompressedNodeAnimation.PositionTrack);
+		CompressTrack(NodeAnimation.vRotationKeys, true, m_Settings.RotationErrorBudget, CompressedNodeAnimation.RotationTrack);
+		CompressTrack(NodeAnimation.vScalingKeys, false, m_Settings.ScalingErrorBudget, CompressedNodeAnimation.ScalingTrack);
+	}
+}
+
+void CAnimationCompressor::Decompress(const std::vector<SCompressedNodeAnimation>& vNodeAnimations, SMeshAnimation& OutAnimation) const
+{
+	OutAnimation.vNodeAnimations.clear();
+	OutAnimation.vNodeAnimations.resize(vNodeAnimations.size());
+	OutAnimation.umapNodeAnimationNameToIndex.clear();
+	for (size_t iNodeAnimation = 0; iNodeAnimation < vNodeAnimations.size(); ++iNodeAnimation)
+	{
+		const SCompressedNodeAnimation& CompressedNodeAnimation{ vNodeAnimations[iNodeAnimation] };
+		SMeshAnimation::SNodeAnimation& NodeAnimation{ OutAnimation.vNodeAnimations[iNodeAnimation] };
+
+		NodeAnimation.Index = CompressedNodeAnimation.Index;
+		NodeAnimation.Name = CompressedNodeAnimation.Name;
+
+		DecompressTrack(CompressedNodeAnimation.PositionTrack, false, NodeAnimation.vPositionKeys);
+		DecompressTrack(CompressedNodeAnimation.RotationTrack, true, NodeAnimation.vRotationKeys);
+		DecompressTrack(CompressedNodeAnimation.ScalingTrack, false, NodeAnimation.vScalingKeys);
+
+		// @important
+		OutAnimation.umapNodeAnimationNameToIndex[NodeAnimation.Name] = NodeAnimation.Index;
+	}
+}
+
+CAnimationCompressor::SReport CAnimationCompressor::CreateReport(const SMeshAnimation& Animation) const
+{
+	SReport Report{};
+	Report.AnimationName = Animation.Name;
+
+	vector<SCompressedNodeAnimation> vCompressedNodeAnimations{};
+	Compress(Animation, vCompressedNodeAnimations);
+
+	SMeshAnimation DecodedAnimation{};
+	Decompress(vCompressedNodeAnimations, DecodedAnimation);
+
+	Report.RawByteCount = GetRawByteCount(Animation);
+	Report.CompressedByteCount = GetCompressedByteCount(vCompressedNodeAnimations);
+	Report.CompressionRatio = (Report.CompressedByteCount) ? (float)Report.RawByteCount / (float)Report.CompressedByteCount : 0.0f;
+
+	for (size_t iNodeAnimation = 0; iNodeAnimation < Animation.vNodeAnimations.size(); ++iNodeAnimation)
+	{
+		const SMeshAnimation::SNodeAnimation& Raw{ Animation.vNodeAnimations[iNodeAnimation] };
+		const SMeshAnimation::SNodeAnimation& Decoded{ DecodedAnimation.vNodeAnimations[iNodeAnimation] };
+		const SCompressedNodeAnimation& Compressed{ vCompressedNodeAnimations[iNodeAnimation] };
+
+		Report.RawKeyCount += (uint32_t)(Raw.vPositionKeys.size() + Raw.vRotationKeys.size() + Raw.vScalingKeys.size());
+		Report.CompressedKeyCount += (uint32_t)(Decoded.vPositionKeys.size() + Decoded.vRotationKeys.size() + Decoded.vScalingKeys.size());
+
+		if (Compressed.PositionTrack.eType == SCompressedAnimationTrack::EType::Constant) ++Report.ConstantTrackCount;
+		if (Compressed.RotationTrack.eType == SCompressedAnimationTrack::EType::Constant) ++Report.ConstantTrackCount;
+		if (Compressed.ScalingTrack.eType == SCompressedAnimationTrack::EType::Constant) ++Report.ConstantTrackCount;
+		if (Compressed.PositionTrack.eType == SCompressedAnimationTrack::EType::Raw) ++Report.RawTrackCount;
+		if (Compressed.RotationTrack.eType == SCompressedAnimationTrack::EType::Raw) ++Report.RawTrackCount;
+		if (Compressed.ScalingTrack.eType == SCompressedAnimationTrack::EType::Raw) ++Report.RawTrackCount;
+
+		// Sample at every half tick so that errors between the kept keys are also measured
+		for (float AnimationTick = 0.0f; AnimationTick <= Animation.Duration; AnimationTick += 0.5f)
+		{
+			float Error{ CalculateBoneSpaceError(Raw, Decoded, AnimationTick) };
+			if (Error > Report.MaxBoneSpaceError)
+			{
+				Report.MaxBoneSpaceError = Error;
+				Report.MaxErrorNodeName = Raw.Name;
+			}
+		}
+	}
+
+	// Decode throughput
+	{
+		SMeshAnimation BenchmarkAnimation{};
+		auto Start{ std::chrono::steady_clock::now() };
+		for (uint32_t iIteration = 0; iIteration < KDecodeBenchmarkIterationCount; ++iIteration)
+		{
+			Decompress(vCompressedNodeAnimations, BenchmarkAnimation);
+		}
+		auto End{ std::chrono::steady_clock::now() };
+
+		double Seconds{ std::chrono::duration<double>(End - Start).count() };
+		if (Seconds > 0.0)
+		{
+			Report.DecodedKeysPerSecond = (double)Report.CompressedKeyCount * KDecodeBenchmarkIterationCount / Seconds;
+		}
+	}
+
+	return Report;
+}
+
+size_t CAnimationCompressor::GetRawByteCount(const SMeshAnimation& Animation)
+{
+	size_t Result{};
+	for (const auto& NodeAnimation : Animation.vNodeAnimations)
+	{
+		// Index + <@PrefString> Name + 3 key counts
+		Result += 4 + 4 + NodeAnimation.Name.size() + 4 * 3;
+
+		// (float) Time + (XMVECTOR) Value
+		Result += (NodeAnimation.vPositionKeys.size() + NodeAnimation.vRotationKeys.size() + NodeAnimation.vScalingKeys.size()) * (4 + 16);
+	}
+	return Result;
+}
+
+size_t CAnimationCompressor::GetCompressedByteCount(const std::vector<SCompressedNodeAnimation>& vNodeAnimations)
+{
+	auto GetTrackByteCount = [](const SCompressedAnimationTrack& Track)
+	{
+		switch (Track.eType)
+		{
+		case SCompressedAnimationTrack::EType::Constant:
+			return (size_t)(1 + 16);
+		case SCompressedAnimationTrack::EType::Quantized:
+			return (size_t)(1 + 4 + 12 + 12) + Track.vTimes.size() * 4 + Track.vValues.size() * 2;
+		case SCompressedAnimationTrack::EType::Raw:
+			return (size_t)(1 + 4) + Track.vTimes.size() * (4 + 16);
+		default:
+			return (size_t)1;
+		}
+	};
+
+	size_t Result{};
+	for (const auto& NodeAnimation : vNodeAnimations)
+	{
+		// Index + <@PrefString> Name
+		Result += 4 + 4 + NodeAnimation.Name.size();
+
+		Result += GetTrackByteCount(NodeAnimation.PositionTrack);
+		Result += GetTrackByteCount(NodeAnimation.RotationTrack);
+		Result += GetTrackByteCount(NodeAnimation.ScalingTrack);
+	}
+	return Result;
+}
+
+void CAnimationCompressor::CompressTrack(const std::vector<SMeshAnimation::SNodeAnimation::SKey>& vKeys, bool bIsRotation, float ErrorBudget,
+	SCompressedAnimationTrack& OutTrack) const
+{
+	OutTrack = SCompressedAnimationTrack();
+
+	if (vKeys.empty())
+	{
+		OutTrack.eType = SCompressedAnimationTrack::EType::Empty;
+		return;
+	}
+
+	// Constant track elimination
+	bool bIsConstant{ true };
+	for (const auto& Key : vKeys)
+	{
+		if (CalculateKeyError(vKeys.front().Value, Key.Value, bIsRotation) > ErrorBudget)
+		{
+			bIsConstant = false;
+			break;
+		}
+	}
+	if (bIsConstant)
+	{
+		OutTrack.eType = SCompressedAnimationTrack::EType::Constant;
+		XMStoreFloat4(&OutTrack.ConstantValue, vKeys.front().Value);
+		return;
+	}
+
+	// @important: half of the budget is spent on key elimination, the other half is left for quantization
+	vector<SKey> vReducedKeys{};
+	EliminateLinearKeys(vKeys, bIsRotation, ErrorBudget * 0.5f, vReducedKeys);
+
+	OutTrack.eType = SCompressedAnimationTrack::EType::Quantized;
+	OutTrack.vTimes.resize(vReducedKeys.size());
+	OutTrack.vValues.resize(vReducedKeys.size() * 3);
+
+	if (bIsRotation)
+	{
+		for (size_t iKey = 0; iKey < vReducedKeys.size(); ++iKey)
+		{
+			OutTrack.vTimes[iKey] = vReducedKeys[iKey].Time;
+			QuantizeQuaternion(vReducedKeys[iKey].Value, &OutTrack.vValues[iKey * 3]);
+		}
+	}
+	else
+	{
+		XMVECTOR Min{ vReducedKeys.front().Value };
+		XMVECTOR Max{ vReducedKeys.front().Value };
+		for (const auto& Key : vReducedKeys)
+		{
+			Min = XMVectorMin(Min, Key.Value);
+			Max = XMVectorMax(Max, Key.Value);
+		}
+		XMStoreFloat3(&OutTrack.RangeMin, Min);
+		XMStoreFloat3(&OutTrack.RangeExtent, Max - Min);
+
+		XMVECTOR Extent{ Max - Min };
+		XMVECTOR InvExtent{ XMVectorSelect(XMVectorReciprocal(Extent), XMVectorZero(), XMVectorEqual(Extent, XMVectorZero())) };
+		for (size_t iKey = 0; iKey < vReducedKeys.size(); ++iKey)
+		{
+			OutTrack.vTimes[iKey] = vReducedKeys[iKey].Time;
+
+			XMFLOAT3 Normalized{};
+			XMStoreFloat3(&Normalized, XMVectorSaturate((vReducedKeys[iKey].Value - Min) * InvExtent));
+			OutTrack.vValues[iKey * 3 + 0] = (uint16_t)(Normalized.x * KQuantizedMax + 0.5f);
+			OutTrack.vValues[iKey * 3 + 1] = (uint16_t)(Normalized.y * KQuantizedMax + 0.5f);
+			OutTrack.vValues[iKey * 3 + 2] = (uint16_t)(Normalized.z * KQuantizedMax + 0.5f);
+		}
+	}
+
+	// @important: if quantization could spend more than the budget left after key elimination, keep the reduced keys unquantized
+	if (CalculateQuantizationError(OutTrack, bIsRotation) > ErrorBudget * 0.5f)
+	{
+		OutTrack.eType = SCompressedAnimationTrack::EType::Raw;
+		OutTrack.RangeMin = XMFLOAT3();
+		OutTrack.RangeExtent = XMFLOAT3();
+		OutTrack.vValues.clear();
+		OutTrack.vRawValues.resize(vReducedKeys.size());
+		for (size_t iKey = 0; iKey < vReducedKeys.size(); ++iKey)
+		{
+			XMStoreFloat4(&OutTrack.vRawValues[iKey], vReducedKeys[iKey].Value);
+		}
+	}
+}
+
+void CAnimationCompressor::DecompressTrack(const SCompressedAnimationTrack& Track, bool bIsRotation,
+	std::vector<SMeshAnimation::SNodeAnimation::SKey>& vOutKeys) const
+{
+	vOutKeys.clear();
+
+	switch (Track.eType)
+	{
+	case SCompressedAnimationTrack::EType::Constant:
+		vOutKeys.resize(1);
+		vOutKeys.front().Value = XMLoadFloat4(&Track.ConstantValue);
+		break;
+	case SCompressedAnimationTrack::EType::Quantized:
+	{
+		vOutKeys.resize(Track.vTimes.size());
+
+		XMVECTOR Min{ XMLoadFloat3(&Track.RangeMin) };
+		XMVECTOR Extent{ XMLoadFloat3(&Track.RangeExtent) };
+		for (size_t iKey = 0; iKey < vOutKeys.size(); ++iKey)
+		{
+			const uint16_t* const Values{ &Track.vValues[iKey * 3] };
+
+			vOutKeys[iKey].Time = Track.vTimes[iKey];
+			if (bIsRotation)
+			{
+				vOutKeys[iKey].Value = DequantizeQuaternion(Values);
+			}
+			else
+			{
+				XMVECTOR Normalized{ XMVectorSet(Values[0], Values[1], Values[2], 0) / (float)KQuantizedMax };
+				vOutKeys[iKey].Value = Min + Normalized * Extent;
+			}
+		}
+		break;
+	}
+	case SCompressedAnimationTrack::EType::Raw:
+		vOutKeys.resize(Track.vTimes.size());
+		for (size_t iKey = 0; iKey < vOutKeys.size(); ++iKey)
+		{
+			vOutKeys[iKey].Time = Track.vTimes[iKey];
+			vOutKeys[iKey].Value = XMLoadFloat4(&Track.vRawValues[iKey]);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+void CAnimationCompressor::EliminateLinearKeys(const std::vector<SMeshAnimation::SNodeAnimation::SKey>& vKeys, bool bIsRotation, float ErrorBudget,
+	std::vector<SMeshAnimation::SNodeAnimation::SKey>& vOutKeys) const
+{
+	vOutKeys.clear();
+	vOutKeys.emplace_back(vKeys.front());
+	if (vKeys.size() == 1) return;
+
+	size_t iLastKeptKey{};
+	for (size_t iKey = 1; iKey < vKeys.size() - 1; ++iKey)
+	{
+		// Check if every key between the last kept key and the next key can be reproduced by interpolation
+		const SKey& KeyA{ vKeys[iLastKeptKey] };
+		const SKey& KeyB{ vKeys[iKey + 1] };
+		float TimeSpan{ KeyB.Time - KeyA.Time };
+
+		bool bCanEliminate{ TimeSpan > 0.0f };
+		for (size_t iSkippedKey = iLastKeptKey + 1; bCanEliminate && iSkippedKey <= iKey; ++iSkippedKey)
+		{
+			float t{ (vKeys[iSkippedKey].Time - KeyA.Time) / TimeSpan };
+			XMVECTOR Interpolated{ (bIsRotation) ? XMQuaternionSlerp(KeyA.Value, KeyB.Value, t) : XMVectorLerp(KeyA.Value, KeyB.Value, t) };
+			if (CalculateKeyError(Interpolated, vKeys[iSkippedKey].Value, bIsRotation) > ErrorBudget) bCanEliminate = false;
+		}
+
+		if (!bCanEliminate)
+		{
+			vOutKeys.emplace_back(vKeys[iKey]);
+			iLastKeptKey = iKey;
+		}
+	}
+
+	vOutKeys.emplace_back(vKeys.back());
+}
+
+float CAnimationCompressor::CalculateKeyError(const XMVECTOR& A, const XMVECTOR& B, bool bIsRotation) const
+{
+	if (bIsRotation)
+	{
+		// Angle between the two rotations (q and -q represent the same rotation)
+		float Dot{ fabsf(XMVectorGetX(XMQuaternionDot(XMQuaternionNormalize(A), XMQuaternionNormalize(B)))) };
+		return 2.0f * acosf(min(Dot, 1.0f));
+	}
+	return XMVectorGetX(XMVector3Length(A - B));
+}
+
+float CAnimationCompressor::CalculateQuantizationError(const SCompressedAnimationTrack& Track, bool bIsRotation) const
+{
+	if (bIsRotation) return KQuaternionQuantizationError;
+
+	// Each component is off by at most half a step (RangeExtent / 65535 / 2)
+	XMVECTOR Extent{ XMLoadFloat3(&Track.RangeExtent) };
+	return XMVectorGetX(XMVector3Length(Extent)) / (2.0f * KQuantizedMax);
+}
+
+float CAnimationCompressor::CalculateBoneSpaceError(const SMeshAnimation::SNodeAnimation& A, const SMeshAnimation::SNodeAnimation& B, float AnimationTick) const
+{
+	static const XMVECTOR KDefaultScaling{ XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f) };
+	static const XMVECTOR KProbes[]
+	{
+		XMVectorSet(0, 0, 0, 1),
+		XMVectorSet(KErrorProbeDistance, 0, 0, 1),
+		XMVectorSet(0, KErrorProbeDistance, 0, 1),
+		XMVectorSet(0, 0, KErrorProbeDistance, 1)
+	};
+
+	auto GetLocalTransform = [&](const SMeshAnimation::SNodeAnimation& NodeAnimation)
+	{
+		XMMATRIX MatrixPosition{ XMMatrixTranslationFromVector(
+			InterpolateAnimationKeys(NodeAnimation.vPositionKeys, AnimationTick, false, XMVectorZero())) };
+		XMMATRIX MatrixRotation{ XMMatrixRotationQuaternion(
+			InterpolateAnimationKeys(NodeAnimation.vRotationKeys, AnimationTick, true, XMQuaternionIdentity())) };
+		XMMATRIX MatrixScaling{ XMMatrixScalingFromVector(
+			InterpolateAnimationKeys(NodeAnimation.vScalingKeys, AnimationTick, false, KDefaultScaling)) };
+		return MatrixScaling * MatrixRotation * MatrixPosition;
+	};
+
+	XMMATRIX TransformA{ GetLocalTransform(A) };
+	XMMATRIX TransformB{ GetLocalTransform(B) };
+
+	float MaxError{};
+	for (const auto& Probe : KProbes)
+	{
+		XMVECTOR PA{ XMVector3TransformCoord(Probe, TransformA) };
+		XMVECTOR PB{ XMVector3TransformCoord(Probe, TransformB) };
+		MaxError = max(MaxError, XMVectorGetX(XMVector3Length(PA - PB)));
+	}
+	return MaxError;
+}
+
+void CAnimationCompressor::QuantizeQuaternion(const XMVECTOR& Quaternion, uint16_t* const OutValues)
+{
+	XMFLOAT4 Q{};
+	XMStoreFloat4(&Q, XMQuaternionNormalize(Quaternion));
+	float Components[4]{ Q.x, Q.y, Q.z, Q.w };
+
+	// Drop the largest component, it's reconstructed from the unit-length constraint
+	uint32_t iLargest{};
+	for (uint32_t iComponent = 1; iComponent < 4; ++iComponent)
+	{
+		if (fabsf(Components[iComponent]) > fabsf(Components[iLargest])) iLargest = iComponent;
+	}
+	float Sign{ (Components[iLargest] < 0.0f) ? -1.0f : +1.0f };
+
+	// The other three components are in [-1/sqrt(2), +1/sqrt(2)]
+	uint32_t iOut{};
+	for (uint32_t iComponent = 0; iComponent < 4; ++iComponent)
+	{
+		if (iComponent == iLargest) continue;
+
+		float Normalized{ (Components[iComponent] * Sign * KSqrt2 + 1.0f) * 0.5f };
+		Normalized = max(min(Normalized, 1.0f), 0.0f);
+		OutValues[iOut++] = (uint16_t)(Normalized * KQuaternionComponentMax + 0.5f);
+	}
+
+	// 2 bits for the dropped component index
+	OutValues[0] |= (uint16_t)((iLargest & 1) << 15);
+	OutValues[1] |= (uint16_t)(((iLargest >> 1) & 1) << 15);
+}
+
+XMVECTOR CAnimationCompressor::DequantizeQuaternion(const uint16_t* const Values)
+{
+	uint32_t iLargest{ (uint32_t)((Values[0] >> 15) | ((Values[1] >> 15) << 1)) };
+
+	float Components[4]{};
+	float SquaredSum{};
+	uint32_t iIn{};
+	for (uint32_t iComponent = 0; iComponent < 4; ++iComponent)
+	{
+		if (iComponent == iLargest) continue;
+
+		float Normalized{ (float)(Values[iIn++] & KQuaternionComponentMax) / (float)KQuaternionComponentMax };
+		Components[iComponent] = (Normalized * 2.0f - 1.0f) * KInvSqrt2;
+		SquaredSum += Components[iComponent] * Components[iComponent];
+	}
+	Components[iLargest] = sqrtf(max(1.0f - SquaredSum, 0.0f));
+
+	return XMQuaternionNormalize(XMVectorSet(Components[0], Components[1], Components[2], Components[3]));
+}
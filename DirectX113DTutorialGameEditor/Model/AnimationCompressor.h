@@ -0,0 +1,104 @@
+#pragma once
+
+#include "MeshPorter.h"
+
+struct SCompressedAnimationTrack
+{
+	enum class EType : uint8_t
+	{
+		Empty,
+		Constant,
+		Quantized,
+		Raw
+	};
+
+	EType					eType{};
+
+	// Constant track
+	XMFLOAT4				ConstantValue{};
+
+	// Quantized track
+	// @important: position & scaling are range-quantized to 16 bits per component,
+	//             rotation is smallest-three quantized (2 bits for the dropped component + 3 * 15 bits)
+	XMFLOAT3				RangeMin{};
+	XMFLOAT3				RangeExtent{};
+	std::vector<float>		vTimes{};
+	std::vector<uint16_t>	vValues{}; // 3 per key
+
+	// Raw track
+	// @important: used when the quantization error doesn't fit in the error budget left after key elimination
+	std::vector<XMFLOAT4>	vRawValues{}; // 1 per key (vTimes is shared with the quantized track)
+};
+
+struct SCompressedNodeAnimation
+{
+	uint32_t					Index{};
+	std::string					Name{};
+	SCompressedAnimationTrack	PositionTrack{};
+	SCompressedAnimationTrack	RotationTrack{};
+	SCompressedAnimationTrack	ScalingTrack{};
+};
+
+class CAnimationCompressor
+{
+public:
+	struct SSettings
+	{
+		float	PositionErrorBudget{ 0.0005f };	// distance in bone space
+		float	RotationErrorBudget{ 0.0005f };	// radians
+		float	ScalingErrorBudget{ 0.0005f };	// absolute per component
+	};
+
+	struct SReport
+	{
+		std::string	AnimationName{};
+		size_t		RawByteCount{};
+		size_t		CompressedByteCount{};
+		float		CompressionRatio{};
+		uint32_t	RawKeyCount{};
+		uint32_t	CompressedKeyCount{};
+		uint32_t	ConstantTrackCount{};
+		uint32_t	RawTrackCount{};
+		float		MaxBoneSpaceError{};
+		std::string	MaxErrorNodeName{};
+		double		DecodedKeysPerSecond{};
+	};
+
+public:
+	CAnimationCompressor() {}
+	CAnimationCompressor(const SSettings& Settings) : m_Settings{ Settings } {}
+	~CAnimationCompressor() {}
+
+public:
+	void Compress(const SMeshAnimation& Animation, std::vector<SCompressedNodeAnimation>& vOutNodeAnimations) const;
+	void Decompress(const std::vector<SCompressedNodeAnimation>& vNodeAnimations, SMeshAnimation& OutAnimation) const;
+	SReport CreateReport(const SMeshAnimation& Animation) const;
+
+public:
+	static size_t GetRawByteCount(const SMeshAnimation& Animation);
+	static size_t GetCompressedByteCount(const std::vector<SCompressedNodeAnimation>& vNodeAnimations);
+
+private:
+	void CompressTrack(const std::vector<SMeshAnimation::SNodeAnimation::SKey>& vKeys, bool bIsRotation, float ErrorBudget,
+		SCompressedAnimationTrack& OutTrack) const;
+	void DecompressTrack(const SCompressedAnimationTrack& Track, bool bIsRotation,
+		std::vector<SMeshAnimation::SNodeAnimation::SKey>& vOutKeys) const;
+	void EliminateLinearKeys(const std::vector<SMeshAnimation::SNodeAnimation::SKey>& vKeys, bool bIsRotation, float ErrorBudget,
+		std::vector<SMeshAnimation::SNodeAnimation::SKey>& vOutKeys) const;
+	float CalculateKeyError(const XMVECTOR& A, const XMVECTOR& B, bool bIsRotation) const;
+	float CalculateQuantizationError(const SCompressedAnimationTrack& Track, bool bIsRotation) const;
+	float CalculateBoneSpaceError(const SMeshAnimation::SNodeAnimation& A, const SMeshAnimation::SNodeAnimation& B, float AnimationTick) const;
+
+private:
+	static void QuantizeQuaternion(const XMVECTOR& Quaternion, uint16_t* const OutValues);
+	static XMVECTOR DequantizeQuaternion(const uint16_t* const Values);
+
+public:
+	static constexpr uint16_t KQuantizedMax{ 0xFFFF };
+	static constexpr uint16_t KQuaternionComponentMax{ 0x7FFF };
+	static constexpr float KErrorProbeDistance{ 1.0f };
+	static constexpr uint32_t KDecodeBenchmarkIterationCount{ 16 };
+
+private:
+	SSettings	m_Settings{};
+};
@@ -53,6 +53,8 @@ void CAssimpLoader::LoadStaticModelFromFile(const string& FileName, SMESHData* c
 		CalculateTangents(Mesh);
 	}
 
+	OptimizeMeshes(Model);
+
 	LoadMaterialsFromFile(m_Scene, Device, DeviceContext, Model->vMaterialData);
 }
 
@@ -99,6 +101,9 @@ void CAssimpLoader::LoadAnimatedModelFromFile(const string& FileName, SMESHData*
 	//  Mesh Vertex  Bone BlendWeights Ѵ.
 	MatchWeightsAndVertices(Model);
 
+	// @important: after the weights are matched, so that they are reordered along with the vertices
+	OptimizeMeshes(Model);
+
 	// Scene Animation ҷ´.
 	LoadAnimations(m_Scene, Model);
 
@@ -163,6 +168,29 @@ void CAssimpLoader::AddAnimationFromFile(const string& FileName, SMESHData* cons
 	}
 }
 
+const SMeshOptimizationStatistics& CAssimpLoader::GetMeshOptimizationStatistics() const
+{
+	return m_MeshOptimizationStatistics;
+}
+
+bool CAssimpLoader::ProbeModelFile(const string& FileName, bool& bOutIsRigged)
+{
+	Assimp::Importer AssimpImporter{};
+	const aiScene* const Scene{ AssimpImporter.ReadFile(FileName, aiProcess_ValidateDataStructure) };
+	if (!Scene || !Scene->HasMeshes() || !Scene->mRootNode) return false;
+
+	bOutIsRigged = false;
+	for (unsigned int iMesh{}; iMesh < Scene->mNumMeshes; ++iMesh)
+	{
+		if (Scene->mMeshes[iMesh]->HasBones())
+		{
+			bOutIsRigged = true;
+			break;
+		}
+	}
+	return true;
+}
+
 void CAssimpLoader::LoadMeshesFromFile(const aiScene* const Scene, vector<SMesh>& vMeshes)
 {
 	unsigned int MeshCount{ Scene->mNumMeshes };
@@ -430,6 +458,29 @@ void CAssimpLoader::MatchWeightsAndVertices(SMESHData* const Model)
 	}
 }
 
+void CAssimpLoader::OptimizeMeshes(SMESHData* const Model)
+{
+	m_MeshOptimizationStatistics = SMeshOptimizationStatistics();
+
+	vector<uint32_t> vVertexRemap{};
+	for (uint32_t iMesh = 0; iMesh < (uint32_t)Model->vMeshes.size(); ++iMesh)
+	{
+		SMeshOptimizationStatistics Statistics{ OptimizeMesh(Model->vMeshes[iMesh], true, &vVertexRemap) };
+		CMeshOptimizer::AccumulateStatistics(m_MeshOptimizationStatistics.Before, Statistics.Before);
+		CMeshOptimizer::AccumulateStatistics(m_MeshOptimizationStatistics.After, Statistics.After);
+		if (vVertexRemap.empty()) continue;
+
+		// @important: the blend weights are saved with the model (MESH), so they must refer to the reordered vertices as well
+		for (auto& BoneNode : Model->vTreeNodes)
+		{
+			for (auto& BlendWeight : BoneNode.vBlendWeights)
+			{
+				if (BlendWeight.MeshIndex == iMesh) BlendWeight.VertexID = vVertexRemap[BlendWeight.VertexID];
+			}
+		}
+	}
+}
+
 void CAssimpLoader::LoadAnimations(const aiScene* const Scene, SMESHData* const Model)
 {
 	if (Scene->mNumAnimations)
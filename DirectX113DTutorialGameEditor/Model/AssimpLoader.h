@@ -2,6 +2,7 @@
 
 #include "../Core/SharedHeader.h"
 #include "ObjectTypes.h"
+#include "../Core/MeshOptimizer.h"
 
 struct aiScene;
 struct aiString;
@@ -21,6 +22,14 @@ public:
 	void LoadAnimatedModelFromFile(const std::string& FileName, SMESHData* const Model, ID3D11Device* Device, ID3D11DeviceContext* DeviceContext);
 	void AddAnimationFromFile(const std::string& FileName, SMESHData* const Model);
 
+public:
+	// Of every mesh of the last loaded model, before & after the loader reordered them
+	const SMeshOptimizationStatistics& GetMeshOptimizationStatistics() const;
+
+public:
+	// Reads the file without post-processing, returns false if Assimp can't read it
+	static bool ProbeModelFile(const std::string& FileName, bool& bOutIsRigged);
+
 private:
 	void LoadMeshesFromFile(const aiScene* const Scene, std::vector<SMesh>& vMeshes);
 	void LoadMaterialsFromFile(const aiScene* const Scene, ID3D11Device* const Device, ID3D11DeviceContext* const DeviceContext,
@@ -36,5 +45,9 @@ private:
 	void LoadAnimations(const aiScene* const Scene, SMESHData* const Model);
 
 private:
-	const aiScene*		m_Scene{};
+	void OptimizeMeshes(SMESHData* const Model);
+
+private:
+	const aiScene*					m_Scene{};
+	SMeshOptimizationStatistics		m_MeshOptimizationStatistics{};
 };
\ No newline at end of file
@@ -2,6 +2,10 @@
 #include "../Core/BinaryData.h"
 #include "../Core/Material.h"
 #include "Object3D.h"
+#include "AnimationCompressor.h"
+#include "VertexPacker.h"
+#include <chrono>
+#include <filesystem>
 
 using std::vector;
 using std::unique_ptr;
@@ -18,6 +22,17 @@ CMeshPorter::CMeshPorter(const std::vector<byte>& vBytes)
 	m_BinaryData = make_unique<CBinaryData>(vBytes);
 }
 
+CMeshPorter::CMeshPorter(std::vector<byte>&& vBytes)
+{
+	m_BinaryData = make_unique<CBinaryData>(std::move(vBytes));
+}
+
+CMeshPorter::CMeshPorter(const byte* const Data, size_t ByteCount)
+{
+	m_BinaryData = make_unique<CBinaryData>();
+	m_BinaryData->SetReadView(Data, ByteCount);
+}
+
 CMeshPorter::~CMeshPorter()
 {
 }
@@ -26,16 +41,19 @@ void CMeshPorter::ImportMESH(const std::string& FileName, SMESHData& MESHFile)
 {
 	m_BinaryData->Clear();
 	
-	m_BinaryData->LoadFromFile(FileName);
+	// @important: arrays are copied from the mapped file straight into MESHFile
+	m_BinaryData->LoadFromMappedFile(FileName);
 	ReadMESHData(MESHFile);
+
+	m_BinaryData->Clear(); // unmaps
 }
 
-void CMeshPorter::ExportMESH(const std::string& FileName, const SMESHData& MESHFile)
+void CMeshPorter::ExportMESH(const std::string& FileName, const SMESHData& MESHFile, bool bShouldCompress)
 {
 	m_BinaryData->Clear();
 
 	WriteMESHData(MESHFile);
-	m_BinaryData->SaveToFile(FileName);
+	m_BinaryData->SaveToFile(FileName, bShouldCompress);
 }
 
 void CMeshPorter::ImportTerrain(const std::string& FileName, STERRData& Data)
@@ -44,7 +62,7 @@ void CMeshPorter::ImportTerrain(const std::string& FileName, STERRData& Data)
 	
 	m_BinaryData->Clear();
 
-	m_BinaryData->LoadFromFile(FileName);
+	m_BinaryData->LoadFromMappedFile(FileName);
 
 	// 8B Signature (TERR_KJW)
 	m_BinaryData->ReadSkip(8);
@@ -69,11 +87,8 @@ void CMeshPorter::ImportTerrain(const std::string& FileName, STERRData& Data)
 	Data.vHeightMapTextureRawData.resize(m_BinaryData->ReadUint32());
 
 	// HeightMap texture raw data
-	for (SPixel8Uint& Pixel : Data.vHeightMapTextureRawData)
-	{
-		// 1B (uint8_t) R (UNORM)
-		Pixel.R = m_BinaryData->ReadUint8();
-	}
+	// 1B (uint8_t) * ?? R (UNORM)
+	m_BinaryData->ReadArray(Data.vHeightMapTextureRawData, Data.vHeightMapTextureRawData.size(), 1);
 	
 
 	// 1B (bool) bShouldDrawWater
@@ -93,14 +108,8 @@ void CMeshPorter::ImportTerrain(const std::string& FileName, STERRData& Data)
 	Data.vMaskingTextureRawData.resize(m_BinaryData->ReadUint32());
 
 	// Masking texture raw data
-	for (SPixel32Uint& Pixel : Data.vMaskingTextureRawData)
-	{
-		// 4B (uint8_t * 4) RGBA (UNORM)
-		Pixel.R = m_BinaryData->ReadUint8();
-		Pixel.G = m_BinaryData->ReadUint8();
-		Pixel.B = m_BinaryData->ReadUint8();
-		Pixel.A = m_BinaryData->ReadUint8();
-	}
+	// 4B (uint8_t * 4) * ?? RGBA (UNORM)
+	m_BinaryData->ReadArray(Data.vMaskingTextureRawData, Data.vMaskingTextureRawData.size(), 1);
 
 
 	// 1B (bool) bHasFoliageCluster
@@ -116,11 +125,8 @@ void CMeshPorter::ImportTerrain(const std::string& FileName, STERRData& Data)
 	Data.vFoliagePlacingTextureRawData.resize(m_BinaryData->ReadUint32());
 
 	// Foliage placing texture raw data
-	for (SPixel8Uint& Pixel : Data.vFoliagePlacingTextureRawData)
-	{
-		// 1B (uint8_t) R (UNORM)
-		Pixel.R = m_BinaryData->ReadUint8();
-	}
+	// 1B (uint8_t) * ?? R (UNORM)
+	m_BinaryData->ReadArray(Data.vFoliagePlacingTextureRawData, Data.vFoliagePlacingTextureRawData.size(), 1);
 
 	// 1B (uint8_t) Foliage count
 	Data.vFoliageData.resize(m_BinaryData->ReadUint8());
@@ -168,11 +174,13 @@ void CMeshPorter::ImportTerrain(const std::string& FileName, STERRData& Data)
 		Data.vMaterialData[iMaterial].Index(iMaterial);
 	}
 
+	m_BinaryData->Clear(); // unmaps
+
 	// @important: right after importing the terrain, it doens't need to be saved again!
 	Data.bShouldSave = false;
 }
 
-void CMeshPorter::ExportTerrain(const std::string& FileName, const STERRData& Data)
+void CMeshPorter::ExportTerrain(const std::string& FileName, const STERRData& Data, bool bShouldCompress)
 {
 	m_BinaryData->Clear();
 
@@ -200,11 +208,8 @@ void CMeshPorter::ExportTerrain(const std::string& FileName, const STERRData& Da
 	m_BinaryData->WriteUint32((uint32_t)Data.vHeightMapTextureRawData.size());
 
 	// HeightMap texture raw data
-	for (const SPixel8Uint& Pixel : Data.vHeightMapTextureRawData)
-	{
-		// 1B (uint8_t) R (UNORM)
-		m_BinaryData->WriteUint8(Pixel.R);
-	}
+	// 1B (uint8_t) * ?? R (UNORM)
+	m_BinaryData->WriteArray(Data.vHeightMapTextureRawData, 1);
 
 
 	// 1B (bool) bShouldDrawWater
@@ -224,14 +229,8 @@ void CMeshPorter::ExportTerrain(const std::string& FileName, const STERRData& Da
 	m_BinaryData->WriteUint32((uint32_t)Data.vMaskingTextureRawData.size());
 
 	// Masking texture raw data
-	for (const SPixel32Uint& Pixel : Data.vMaskingTextureRawData)
-	{
-		// 4B (uint8_t * 4) RGBA (UNORM)
-		m_BinaryData->WriteUint8(Pixel.R);
-		m_BinaryData->WriteUint8(Pixel.G);
-		m_BinaryData->WriteUint8(Pixel.B);
-		m_BinaryData->WriteUint8(Pixel.A);
-	}
+	// 4B (uint8_t * 4) * ?? RGBA (UNORM)
+	m_BinaryData->WriteArray(Data.vMaskingTextureRawData, 1);
 
 
 	// 1B (bool) bHasFoliageCluster
@@ -247,11 +246,8 @@ void CMeshPorter::ExportTerrain(const std::string& FileName, const STERRData& Da
 	m_BinaryData->WriteUint32((uint32_t)Data.vFoliagePlacingTextureRawData.size());
 
 	// Foliage placing texture raw data
-	for (const SPixel8Uint& Pixel : Data.vFoliagePlacingTextureRawData)
-	{
-		// 1B (uint8_t) R (UNORM)
-		m_BinaryData->WriteUint8(Pixel.R);
-	}
+	// 1B (uint8_t) * ?? R (UNORM)
+	m_BinaryData->WriteArray(Data.vFoliagePlacingTextureRawData, 1);
 
 	// # 1B (uint8_t) Foliage count
 	m_BinaryData->WriteUint8((uint8_t)Data.vFoliageData.size());
@@ -289,7 +285,7 @@ void CMeshPorter::ExportTerrain(const std::string& FileName, const STERRData& Da
 
 	WriteModelMaterials(Data.vMaterialData);
 
-	m_BinaryData->SaveToFile(FileName);
+	m_BinaryData->SaveToFile(FileName, bShouldCompress);
 }
 
 void CMeshPorter::ReadMESHData(SMESHData& MESHData)
@@ -310,6 +306,12 @@ void CMeshPorter::ReadMESHData(SMESHData& MESHData)
 		m_BinaryData->ReadBool(MESHData.bIgnoreSceneMaterial);
 	}
 
+	// 1B (bool) bUsePackedVertices
+	if (Version >= 0x10008)
+	{
+		m_BinaryData->ReadBool(MESHData.bUsePackedVertices);
+	}
+
 	// 1B (uint8_t) Material count
 	MESHData.vMaterialData.resize(m_BinaryData->ReadUint8());
 
@@ -329,25 +331,40 @@ void CMeshPorter::ReadMESHData(SMESHData& MESHData)
 		// # ### VERTEX ###
 		// 4B (uint32_t) Vertex count
 		Mesh.vVertices.resize(m_BinaryData->ReadUint32());
-		for (SVertex3D& Vertex : Mesh.vVertices)
+
+		// 1B (bool) bArePackedVertices
+		bool bArePackedVertices{ (Version >= 0x10008) ? m_BinaryData->ReadBool() : false };
+		if (bArePackedVertices)
+		{
+			ReadPackedVertices(Mesh.vVertices);
+		}
+		else if (Version >= 0x10007)
 		{
-			// # 4B (uint32_t) Vertex index
-			m_BinaryData->ReadUint32();
+			// 80B (XMVECTOR * 5) * ?? Position, Color, TexCoord, Normal, Tangent
+			m_BinaryData->ReadArray(Mesh.vVertices, Mesh.vVertices.size());
+		}
+		else
+		{
+			for (SVertex3D& Vertex : Mesh.vVertices)
+			{
+				// # 4B (uint32_t) Vertex index
+				m_BinaryData->ReadUint32();
 
-			// # 16B (XMVECTOR) Position
-			m_BinaryData->ReadXMVECTOR(Vertex.Position);
+				// # 16B (XMVECTOR) Position
+				m_BinaryData->ReadXMVECTOR(Vertex.Position);
 
-			// # 16B (XMVECTOR) Color
-			m_BinaryData->ReadXMVECTOR(Vertex.Color);
+				// # 16B (XMVECTOR) Color
+				m_BinaryData->ReadXMVECTOR(Vertex.Color);
 
-			// # 16B (XMVECTOR) TexCoord
-			m_BinaryData->ReadXMVECTOR(Vertex.TexCoord);
+				// # 16B (XMVECTOR) TexCoord
+				m_BinaryData->ReadXMVECTOR(Vertex.TexCoord);
 
-			// # 16B (XMVECTOR) Normal
-			m_BinaryData->ReadXMVECTOR(Vertex.Normal);
+				// # 16B (XMVECTOR) Normal
+				m_BinaryData->ReadXMVECTOR(Vertex.Normal);
 
-			// 16B (XMVECTOR) Tangent
-			m_BinaryData->ReadXMVECTOR(Vertex.Tangent);
+				// 16B (XMVECTOR) Tangent
+				m_BinaryData->ReadXMVECTOR(Vertex.Tangent);
+			}
 		}
 
 		if (Version >= 0x10002)
@@ -358,23 +375,31 @@ void CMeshPorter::ReadMESHData(SMESHData& MESHData)
 			// 4B (uint32_t) Animation vertex count
 			Mesh.vAnimationVertices.resize(m_BinaryData->ReadUint32());
 
-			for (uint32_t iAnimationVertex = 0; iAnimationVertex < (uint32_t)Mesh.vAnimationVertices.size(); ++iAnimationVertex)
+			if (Version >= 0x10007)
 			{
-				// 4B (uint32_t) Animation vertex index
-				m_BinaryData->ReadUint32();
-
-				SAnimationVertex& AnimationVertex{ Mesh.vAnimationVertices[iAnimationVertex] };
-
-				// 4B * ?? (uint32_t) Bone IDs
-				for (auto& BoneID : AnimationVertex.BoneIDs)
-				{
-					m_BinaryData->ReadUint32(BoneID);
-				}
-
-				// 4B * ?? (float) Weights
-				for (auto& Weight : AnimationVertex.Weights)
+				// (4B * ?? (uint32_t) Bone IDs, 4B * ?? (float) Weights) * ??
+				m_BinaryData->ReadArray(Mesh.vAnimationVertices, Mesh.vAnimationVertices.size());
+			}
+			else
+			{
+				for (uint32_t iAnimationVertex = 0; iAnimationVertex < (uint32_t)Mesh.vAnimationVertices.size(); ++iAnimationVertex)
 				{
-					m_BinaryData->ReadFloat(Weight);
+					// 4B (uint32_t) Animation vertex index
+					m_BinaryData->ReadUint32();
+
+					SAnimationVertex& AnimationVertex{ Mesh.vAnimationVertices[iAnimationVertex] };
+
+					// 4B * ?? (uint32_t) Bone IDs
+					for (auto& BoneID : AnimationVertex.BoneIDs)
+					{
+						m_BinaryData->ReadUint32(BoneID);
+					}
+
+					// 4B * ?? (float) Weights
+					for (auto& Weight : AnimationVertex.Weights)
+					{
+						m_BinaryData->ReadFloat(Weight);
+					}
 				}
 			}
 		}
@@ -382,19 +407,41 @@ void CMeshPorter::ReadMESHData(SMESHData& MESHData)
 		// # ### TRIANGLE ###
 		// 4B (uint32_t) Triangle count
 		Mesh.vTriangles.resize(m_BinaryData->ReadUint32());
-		for (STriangle& Triangle : Mesh.vTriangles)
+		if (Version >= 0x10007)
 		{
-			// # 4B (uint32_t) Triangle index
-			m_BinaryData->ReadUint32();
+			// 4B * 3 (uint32_t) * ?? Vertex IDs
+			m_BinaryData->ReadArray(Mesh.vTriangles, Mesh.vTriangles.size());
+		}
+		else
+		{
+			for (STriangle& Triangle : Mesh.vTriangles)
+			{
+				// # 4B (uint32_t) Triangle index
+				m_BinaryData->ReadUint32();
 
-			// # 4B (uint32_t) Vertex ID 0
-			m_BinaryData->ReadUint32(Triangle.I0);
+				// # 4B (uint32_t) Vertex ID 0
+				m_BinaryData->ReadUint32(Triangle.I0);
 
-			// # 4B (uint32_t) Vertex ID 1
-			m_BinaryData->ReadUint32(Triangle.I1);
+				// # 4B (uint32_t) Vertex ID 1
+				m_BinaryData->ReadUint32(Triangle.I1);
 
-			// # 4B (uint32_t) Vertex ID 2
-			m_BinaryData->ReadUint32(Triangle.I2);
+				// # 4B (uint32_t) Vertex ID 2
+				m_BinaryData->ReadUint32(Triangle.I2);
+			}
+		}
+
+		if (Version >= 0x10006)
+		{
+			// # ### LOD ###
+			// 1B (uint8_t) LOD count (LOD 0 excluded)
+			Mesh.vLODTriangles.resize(m_BinaryData->ReadUint8());
+			for (auto& vLODTriangles : Mesh.vLODTriangles)
+			{
+				// 4B (uint32_t) Triangle count
+				// 4B * 3 (uint32_t) * ?? Vertex IDs
+				uint32_t TriangleCount{ m_BinaryData->ReadUint32() };
+				m_BinaryData->ReadArray(vLODTriangles, TriangleCount);
+			}
 		}
 	}
 
@@ -470,6 +517,12 @@ void CMeshPorter::ReadMESHData(SMESHData& MESHData)
 		// 4B (uint32_t) Model bone count
 		m_BinaryData->ReadUint32(MESHData.ModelBoneCount);
 
+		// 1B (bool) bUseCompressedAnimations
+		if (Version >= 0x10005)
+		{
+			m_BinaryData->ReadBool(MESHData.bUseCompressedAnimations);
+		}
+
 		// 4B (uint32_t) Animation count
 		MESHData.vAnimations.resize(m_BinaryData->ReadUint32());
 		for (auto& Animation : MESHData.vAnimations)
@@ -483,6 +536,12 @@ void CMeshPorter::ReadMESHData(SMESHData& MESHData)
 			// 4B (float) Ticks per second
 			m_BinaryData->ReadFloat(Animation.TicksPerSecond);
 
+			if (MESHData.bUseCompressedAnimations)
+			{
+				ReadCompressedNodeAnimations(Animation);
+				continue;
+			}
+
 			// 4B (uint32_t) Node animation count
 			Animation.vNodeAnimations.resize(m_BinaryData->ReadUint32());
 			for (auto& NodeAnimation : Animation.vNodeAnimations)
@@ -621,9 +680,24 @@ void CMeshPorter::WriteMESHData(const SMESHData& MESHData)
 {
 	static constexpr uint16_t KVersionMajor{ 0x0001 };
 	static constexpr uint8_t KVersionMinor{ 0x00 };
-	static constexpr uint8_t KVersionSubminor{ 0x04 };
+	static constexpr uint8_t KVersionSubminor{ 0x08 };
 	uint32_t Version{ (uint32_t)(KVersionSubminor | (KVersionMinor << 8) | (KVersionMajor << 16)) };
 
+	// @important: vertices, animation vertices and triangles are written as they are in memory
+	static_assert(sizeof(SVertex3D) == 16 * 5, "SVertex3D layout changed, MESH version must be raised");
+	static_assert(sizeof(SAnimationVertex) == 4 * 2 * SAnimationVertex::KMaxWeightCount, "SAnimationVertex layout changed, MESH version must be raised");
+	static_assert(sizeof(STriangle) == 4 * 3, "STriangle layout changed, MESH version must be raised");
+	static_assert(sizeof(SPackedVertexAttributes) == 2 * 6, "SPackedVertexAttributes layout changed, MESH version must be raised");
+
+	size_t ArrayByteCount{};
+	for (const SMesh& Mesh : MESHData.vMeshes)
+	{
+		ArrayByteCount += sizeof(SVertex3D) * Mesh.vVertices.size() + sizeof(SAnimationVertex) * Mesh.vAnimationVertices.size() +
+			sizeof(STriangle) * Mesh.vTriangles.size();
+		for (const auto& vLODTriangles : Mesh.vLODTriangles) ArrayByteCount += sizeof(STriangle) * vLODTriangles.size();
+	}
+	m_BinaryData->Reserve(m_BinaryData->GetBytes().size() + ArrayByteCount + 4096); // + headers, materials and animations (grows if more)
+
 	// 8B Signature
 	m_BinaryData->WriteString("KJW_MESH", 8);
 
@@ -638,11 +712,19 @@ void CMeshPorter::WriteMESHData(const SMESHData& MESHData)
 		m_BinaryData->WriteBool(MESHData.bIgnoreSceneMaterial);
 	}
 
+	// 1B (bool) bUsePackedVertices
+	if (Version >= 0x10008)
+	{
+		m_BinaryData->WriteBool(MESHData.bUsePackedVertices);
+	}
+
 	WriteModelMaterials(MESHData.vMaterialData);
 
 	// 1B (uint8_t) Mesh count
 	m_BinaryData->WriteUint8((uint8_t)MESHData.vMeshes.size());
 
+	CVertexPacker VertexPacker{};
+
 	for (uint8_t iMesh = 0; iMesh < (uint8_t)MESHData.vMeshes.size(); ++iMesh)
 	{
 		// 1B (uint8_t) Mesh index
@@ -656,27 +738,18 @@ void CMeshPorter::WriteMESHData(const SMESHData& MESHData)
 		// 4B (uint32_t) Vertex count
 		m_BinaryData->WriteUint32((uint32_t)Mesh.vVertices.size());
 
-		for (uint32_t iVertex = 0; iVertex < (uint32_t)Mesh.vVertices.size(); ++iVertex)
+		// 1B (bool) bArePackedVertices
+		SPackedVertices PackedVertices{};
+		bool bArePackedVertices{ MESHData.bUsePackedVertices && VertexPacker.Pack(Mesh.vVertices, PackedVertices) };
+		m_BinaryData->WriteBool(bArePackedVertices);
+		if (bArePackedVertices)
 		{
-			// 4B (uint32_t) Vertex index
-			m_BinaryData->WriteUint32(iVertex);
-
-			const SVertex3D& Vertex{ Mesh.vVertices[iVertex] };
-
-			// 16B (XMVECTOR) Position
-			m_BinaryData->WriteXMVECTOR(Vertex.Position);
-
-			// 16B (XMVECTOR) Color
-			m_BinaryData->WriteXMVECTOR(Vertex.Color);
-
-			// 16B (XMVECTOR) TexCoord
-			m_BinaryData->WriteXMVECTOR(Vertex.TexCoord);
-
-			// 16B (XMVECTOR) Normal
-			m_BinaryData->WriteXMVECTOR(Vertex.Normal);
-
-			// 16B (XMVECTOR) Tangent
-			m_BinaryData->WriteXMVECTOR(Vertex.Tangent);
+			WritePackedVertices(PackedVertices);
+		}
+		else
+		{
+			// 80B (XMVECTOR * 5) * ?? Position, Color, TexCoord, Normal, Tangent
+			m_BinaryData->WriteArray(Mesh.vVertices);
 		}
 
 		if (Version >= 0x10002)
@@ -687,44 +760,28 @@ void CMeshPorter::WriteMESHData(const SMESHData& MESHData)
 			// 4B (uint32_t) Animation vertex count
 			m_BinaryData->WriteUint32((uint32_t)Mesh.vAnimationVertices.size());
 
-			for (uint32_t iAnimationVertex = 0; iAnimationVertex < (uint32_t)Mesh.vAnimationVertices.size(); ++iAnimationVertex)
-			{
-				// 4B (uint32_t) Animation vertex index
-				m_BinaryData->WriteUint32(iAnimationVertex);
-
-				const SAnimationVertex& AnimationVertex{ Mesh.vAnimationVertices[iAnimationVertex] };
-
-				// 4B * ?? (uint32_t) Bone IDs
-				for (const auto& BoneID : AnimationVertex.BoneIDs)
-				{
-					m_BinaryData->WriteUint32(BoneID);
-				}
-
-				// 4B * ?? (float) Weights
-				for (const auto& Weight : AnimationVertex.Weights)
-				{
-					m_BinaryData->WriteFloat(Weight);
-				}
-			}
+			// (4B * ?? (uint32_t) Bone IDs, 4B * ?? (float) Weights) * ??
+			m_BinaryData->WriteArray(Mesh.vAnimationVertices);
 		}
 
 		// 4B (uint32_t) Triangle count
 		m_BinaryData->WriteUint32((uint32_t)Mesh.vTriangles.size());
-		for (uint32_t iTriangle = 0; iTriangle < (uint32_t)Mesh.vTriangles.size(); ++iTriangle)
-		{
-			// 4B (uint32_t) Triangle index
-			m_BinaryData->WriteUint32(iTriangle);
 
-			const STriangle& Triangle{ Mesh.vTriangles[iTriangle] };
+		// 4B * 3 (uint32_t) * ?? Vertex IDs
+		m_BinaryData->WriteArray(Mesh.vTriangles);
 
-			// 4B (uint32_t) Vertex ID 0
-			m_BinaryData->WriteUint32(Triangle.I0);
-
-			// 4B (uint32_t) Vertex ID 1
-			m_BinaryData->WriteUint32(Triangle.I1);
+		if (Version >= 0x10006)
+		{
+			// 1B (uint8_t) LOD count (LOD 0 excluded)
+			m_BinaryData->WriteUint8((uint8_t)Mesh.vLODTriangles.size());
+			for (const auto& vLODTriangles : Mesh.vLODTriangles)
+			{
+				// 4B (uint32_t) Triangle count
+				m_BinaryData->WriteUint32((uint32_t)vLODTriangles.size());
 
-			// 4B (uint32_t) Vertex ID 2
-			m_BinaryData->WriteUint32(Triangle.I2);
+				// 4B * 3 (uint32_t) * ?? Vertex IDs
+				m_BinaryData->WriteArray(vLODTriangles);
+			}
 		}
 	}
 
@@ -794,6 +851,12 @@ void CMeshPorter::WriteMESHData(const SMESHData& MESHData)
 		// 4B (uint32_t) Model bone count
 		m_BinaryData->WriteUint32(MESHData.ModelBoneCount);
 
+		// 1B (bool) bUseCompressedAnimations
+		if (Version >= 0x10005)
+		{
+			m_BinaryData->WriteBool(MESHData.bUseCompressedAnimations);
+		}
+
 		// 4B (uint32_t) Animation count
 		m_BinaryData->WriteUint32((uint32_t)MESHData.vAnimations.size());
 		for (const auto& Animation : MESHData.vAnimations)
@@ -807,6 +870,13 @@ void CMeshPorter::WriteMESHData(const SMESHData& MESHData)
 			// 4B (float) Ticks per second
 			m_BinaryData->WriteFloat(Animation.TicksPerSecond);
 
+			if (MESHData.bUseCompressedAnimations)
+			{
+				WriteCompressedNodeAnimations(Animation);
+				continue;
+			}
+
+
 			// 4B (uint32_t) Node animation count
 			m_BinaryData->WriteUint32((uint32_t)Animation.vNodeAnimations.size());
 			for (const auto& NodeAnimation : Animation.vNodeAnimations)
@@ -925,7 +995,320 @@ void CMeshPorter::WriteModelMaterials(const std::vector<CMaterialData>& vMateria
 	}
 }
 
-const std::vector<byte> CMeshPorter::GetBytes() const
+void CMeshPorter::ReadCompressedNodeAnimations(SMeshAnimation& Animation)
+{
+	vector<SCompressedNodeAnimation> vCompressedNodeAnimations{};
+
+	// 4B (uint32_t) Node animation count
+	vCompressedNodeAnimations.resize(m_BinaryData->ReadUint32());
+	for (auto& CompressedNodeAnimation : vCompressedNodeAnimations)
+	{
+		// 4B (uint32_t) Node animation index
+		m_BinaryData->ReadUint32(CompressedNodeAnimation.Index);
+
+		// <@PrefString> Node animation name
+		m_BinaryData->ReadStringWithPrefixedLength(CompressedNodeAnimation.Name);
+
+		// Position track
+		ReadCompressedAnimationTrack(CompressedNodeAnimation.PositionTrack);
+
+		// Rotation track
+		ReadCompressedAnimationTrack(CompressedNodeAnimation.RotationTrack);
+
+		// Scaling track
+		ReadCompressedAnimationTrack(CompressedNodeAnimation.ScalingTrack);
+	}
+
+	// @important: keys are decoded once at load time; the runtime sampler interpolates between the kept keys
+	CAnimationCompressor AnimationCompressor{};
+	AnimationCompressor.Decompress(vCompressedNodeAnimations, Animation);
+}
+
+void CMeshPorter::WriteCompressedNodeAnimations(const SMeshAnimation& Animation)
+{
+	vector<SCompressedNodeAnimation> vCompressedNodeAnimations{};
+
+	CAnimationCompressor AnimationCompressor{};
+	AnimationCompressor.Compress(Animation, vCompressedNodeAnimations);
+
+	// 4B (uint32_t) Node animation count
+	m_BinaryData->WriteUint32((uint32_t)vCompressedNodeAnimations.size());
+	for (const auto& CompressedNodeAnimation : vCompressedNodeAnimations)
+	{
+		// 4B (uint32_t) Node animation index
+		m_BinaryData->WriteUint32(CompressedNodeAnimation.Index);
+
+		// <@PrefString> Node animation name
+		m_BinaryData->WriteStringWithPrefixedLength(CompressedNodeAnimation.Name);
+
+		// Position track
+		WriteCompressedAnimationTrack(CompressedNodeAnimation.PositionTrack);
+
+		// Rotation track
+		WriteCompressedAnimationTrack(CompressedNodeAnimation.RotationTrack);
+
+		// Scaling track
+		WriteCompressedAnimationTrack(CompressedNodeAnimation.ScalingTrack);
+	}
+}
+
+void CMeshPorter::ReadCompressedAnimationTrack(SCompressedAnimationTrack& Track)
+{
+	// 1B (uint8_t) Track type
+	Track.eType = (SCompressedAnimationTrack::EType)m_BinaryData->ReadUint8();
+
+	if (Track.eType == SCompressedAnimationTrack::EType::Constant)
+	{
+		// 16B (XMFLOAT4) Constant value
+		m_BinaryData->ReadXMFLOAT4(Track.ConstantValue);
+	}
+	else if (Track.eType == SCompressedAnimationTrack::EType::Quantized)
+	{
+		// 4B (uint32_t) Key count
+		uint32_t KeyCount{ m_BinaryData->ReadUint32() };
+		Track.vTimes.resize(KeyCount);
+		Track.vValues.resize(KeyCount * 3);
+
+		// 12B (XMFLOAT3) Range min
+		m_BinaryData->ReadXMFLOAT3(Track.RangeMin);
+
+		// 12B (XMFLOAT3) Range extent
+		m_BinaryData->ReadXMFLOAT3(Track.RangeExtent);
+
+		for (uint32_t iKey = 0; iKey < KeyCount; ++iKey)
+		{
+			// 4B (float) Time
+			m_BinaryData->ReadFloat(Track.vTimes[iKey]);
+
+			// 2B * 3 (uint16_t) Quantized value
+			m_BinaryData->ReadUint16(Track.vValues[iKey * 3 + 0]);
+			m_BinaryData->ReadUint16(Track.vValues[iKey * 3 + 1]);
+			m_BinaryData->ReadUint16(Track.vValues[iKey * 3 + 2]);
+		}
+	}
+	else if (Track.eType == SCompressedAnimationTrack::EType::Raw)
+	{
+		// 4B (uint32_t) Key count
+		uint32_t KeyCount{ m_BinaryData->ReadUint32() };
+		Track.vTimes.resize(KeyCount);
+		Track.vRawValues.resize(KeyCount);
+
+		for (uint32_t iKey = 0; iKey < KeyCount; ++iKey)
+		{
+			// 4B (float) Time
+			m_BinaryData->ReadFloat(Track.vTimes[iKey]);
+
+			// 16B (XMFLOAT4) Value
+			m_BinaryData->ReadXMFLOAT4(Track.vRawValues[iKey]);
+		}
+	}
+}
+
+void CMeshPorter::WriteCompressedAnimationTrack(const SCompressedAnimationTrack& Track)
+{
+	// 1B (uint8_t) Track type
+	m_BinaryData->WriteUint8((uint8_t)Track.eType);
+
+	if (Track.eType == SCompressedAnimationTrack::EType::Constant)
+	{
+		// 16B (XMFLOAT4) Constant value
+		m_BinaryData->WriteXMFLOAT4(Track.ConstantValue);
+	}
+	else if (Track.eType == SCompressedAnimationTrack::EType::Quantized)
+	{
+		// 4B (uint32_t) Key count
+		uint32_t KeyCount{ (uint32_t)Track.vTimes.size() };
+		m_BinaryData->WriteUint32(KeyCount);
+
+		// 12B (XMFLOAT3) Range min
+		m_BinaryData->WriteXMFLOAT3(Track.RangeMin);
+
+		// 12B (XMFLOAT3) Range extent
+		m_BinaryData->WriteXMFLOAT3(Track.RangeExtent);
+
+		for (uint32_t iKey = 0; iKey < KeyCount; ++iKey)
+		{
+			// 4B (float) Time
+			m_BinaryData->WriteFloat(Track.vTimes[iKey]);
+
+			// 2B * 3 (uint16_t) Quantized value
+			m_BinaryData->WriteUint16(Track.vValues[iKey * 3 + 0]);
+			m_BinaryData->WriteUint16(Track.vValues[iKey * 3 + 1]);
+			m_BinaryData->WriteUint16(Track.vValues[iKey * 3 + 2]);
+		}
+	}
+	else if (Track.eType == SCompressedAnimationTrack::EType::Raw)
+	{
+		// 4B (uint32_t) Key count
+		uint32_t KeyCount{ (uint32_t)Track.vTimes.size() };
+		m_BinaryData->WriteUint32(KeyCount);
+
+		for (uint32_t iKey = 0; iKey < KeyCount; ++iKey)
+		{
+			// 4B (float) Time
+			m_BinaryData->WriteFloat(Track.vTimes[iKey]);
+
+			// 16B (XMFLOAT4) Value
+			m_BinaryData->WriteXMFLOAT4(Track.vRawValues[iKey]);
+		}
+	}
+}
+
+void CMeshPorter::ReadPackedVertices(std::vector<SVertex3D>& vOutVertices)
+{
+	SPackedVertices Packed{};
+
+	// 12B (XMFLOAT3) * ?? Positions
+	m_BinaryData->ReadArray(Packed.vPositions, vOutVertices.size());
+
+	// 12B (int16_t * 2 Normal, int16_t * 2 Tangent, half * 2 TexCoord) * ?? Attributes
+	m_BinaryData->ReadArray(Packed.vAttributes, vOutVertices.size(), 2);
+
+	// 1B (bool) bHasVertexColors
+	m_BinaryData->ReadBool(Packed.bHasVertexColors);
+	if (Packed.bHasVertexColors)
+	{
+		// 4B (RGBA8) * ?? Colors
+		m_BinaryData->ReadArray(Packed.vColors, vOutVertices.size());
+	}
+	else
+	{
+		// 16B (XMFLOAT4) Constant color
+		m_BinaryData->ReadXMFLOAT4(Packed.ConstantColor);
+	}
+
+	CVertexPacker::Unpack(Packed, vOutVertices);
+}
+
+void CMeshPorter::WritePackedVertices(const SPackedVertices& Packed)
+{
+	// 12B (XMFLOAT3) * ?? Positions
+	m_BinaryData->WriteArray(Packed.vPositions);
+
+	// 12B (int16_t * 2 Normal, int16_t * 2 Tangent, half * 2 TexCoord) * ?? Attributes
+	m_BinaryData->WriteArray(Packed.vAttributes, 2);
+
+	// 1B (bool) bHasVertexColors
+	m_BinaryData->WriteBool(Packed.bHasVertexColors);
+	if (Packed.bHasVertexColors)
+	{
+		// 4B (RGBA8) * ?? Colors
+		m_BinaryData->WriteArray(Packed.vColors);
+	}
+	else
+	{
+		// 16B (XMFLOAT4) Constant color
+		m_BinaryData->WriteXMFLOAT4(Packed.ConstantColor);
+	}
+}
+
+const std::vector<byte>& CMeshPorter::GetBytes() const
 {
 	return m_BinaryData->GetBytes();
 }
+
+void CMeshPorter::MeasureMESHThroughput(const SMESHData& MESHData, uint32_t IterationCount, double& OutWriteMBps, double& OutReadMBps)
+{
+	OutWriteMBps = OutReadMBps = 0.0;
+	if (IterationCount == 0) return;
+
+	double WriteSeconds{};
+	double ReadSeconds{};
+	size_t ByteCount{};
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
+	{
+		auto StartTimePoint{ std::chrono::steady_clock::now() };
+		CMeshPorter Writer{};
+		Writer.WriteMESHData(MESHData);
+		WriteSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTimePoint).count();
+		ByteCount = Writer.GetBytes().size();
+
+		CMeshPorter Reader{ Writer.GetBytes() };
+		SMESHData ReadMESHData{};
+		StartTimePoint = std::chrono::steady_clock::now();
+		Reader.ReadMESHData(ReadMESHData);
+		ReadSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTimePoint).count();
+	}
+
+	const double KMegaBytes{ (double)ByteCount * IterationCount / (1024.0 * 1024.0) };
+	if (WriteSeconds > 0.0) OutWriteMBps = KMegaBytes / WriteSeconds;
+	if (ReadSeconds > 0.0) OutReadMBps = KMegaBytes / ReadSeconds;
+}
+
+void CMeshPorter::MeasureMESHImportTime(const std::string& FileName, uint32_t IterationCount, double& OutReadMilliseconds, double& OutMappedMilliseconds)
+{
+	OutReadMilliseconds = OutMappedMilliseconds = 0.0;
+	if (IterationCount == 0) return;
+
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
+	{
+		auto StartTimePoint{ std::chrono::steady_clock::now() };
+		{
+			CMeshPorter Porter{};
+			SMESHData MESHData{};
+			Porter.m_BinaryData->LoadFromFile(FileName);
+			Porter.ReadMESHData(MESHData);
+		}
+		OutReadMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTimePoint).count();
+
+		StartTimePoint = std::chrono::steady_clock::now();
+		{
+			CMeshPorter Porter{};
+			SMESHData MESHData{};
+			Porter.ImportMESH(FileName, MESHData);
+		}
+		OutMappedMilliseconds += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - StartTimePoint).count();
+	}
+
+	OutReadMilliseconds /= IterationCount;
+	OutMappedMilliseconds /= IterationCount;
+}
+
+bool CMeshPorter::MeasureVertexPacking(const std::string& FileName, uint32_t IterationCount, SVertexPackingBenchmark& Out)
+{
+	Out = SVertexPackingBenchmark();
+	if (IterationCount == 0) return false;
+
+	SMESHData MESHData{};
+	{
+		CMeshPorter Porter{};
+		if (!Porter.m_BinaryData->LoadFromMappedFile(FileName)) return false;
+		Porter.ReadMESHData(MESHData);
+	}
+
+	std::error_code ErrorCode{};
+	const std::filesystem::path KTemporaryDirectory{ std::filesystem::temp_directory_path(ErrorCode) };
+	bool bResult{ true };
+	for (bool bUsePackedVertices : { false, true })
+	{
+		const char* const KTemporaryName{ (bUsePackedVertices) ? "MeasureVertexPacking_packed.mesh" : "MeasureVertexPacking_raw.mesh" };
+		const string KTemporaryFileName{ (KTemporaryDirectory / KTemporaryName).string() };
+		MESHData.bUsePackedVertices = bUsePackedVertices;
+		{
+			CMeshPorter Porter{};
+			Porter.WriteMESHData(MESHData);
+			if (!Porter.m_BinaryData->SaveToFile(KTemporaryFileName))
+			{
+				bResult = false;
+				break;
+			}
+		}
+
+		double ReadMilliseconds{};
+		double MappedMilliseconds{};
+		MeasureMESHImportTime(KTemporaryFileName, IterationCount, ReadMilliseconds, MappedMilliseconds);
+		const size_t KByteCount{ (size_t)std::filesystem::file_size(KTemporaryFileName, ErrorCode) };
+		if (bUsePackedVertices)
+		{
+			Out.PackedByteCount = KByteCount;
+			Out.PackedImportMilliseconds = MappedMilliseconds;
+		}
+		else
+		{
+			Out.RawByteCount = KByteCount;
+			Out.RawImportMilliseconds = MappedMilliseconds;
+		}
+		std::filesystem::remove(KTemporaryFileName, ErrorCode);
+	}
+	return bResult;
+}
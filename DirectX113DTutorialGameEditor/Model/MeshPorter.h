@@ -2,11 +2,14 @@
 
 #include "../Core/SharedHeader.h"
 #include "ObjectTypes.h"
+#include <algorithm>
 
 class CBinaryData;
 class CMaterialData;
 struct SPixel8Uint;
 struct SPixel32Uint;
+struct SCompressedAnimationTrack;
+struct SPackedVertices;
 
 struct SMeshAnimation
 {
@@ -35,6 +38,27 @@ struct SMeshAnimation
 	std::string								Name{};
 };
 
+// Linear interpolation for position & scaling keys, spherical linear interpolation for rotation keys
+inline XMVECTOR InterpolateAnimationKeys(const std::vector<SMeshAnimation::SNodeAnimation::SKey>& vKeys, float AnimationTick,
+	bool bIsRotation, const XMVECTOR& DefaultValue)
+{
+	if (vKeys.empty()) return DefaultValue;
+	if (vKeys.size() == 1 || AnimationTick <= vKeys.front().Time) return vKeys.front().Value;
+	if (AnimationTick >= vKeys.back().Time) return vKeys.back().Value;
+
+	// @important: keys are sorted by time, so binary search for the first key after AnimationTick
+	auto KeyB{ std::upper_bound(vKeys.begin(), vKeys.end(), AnimationTick,
+		[](float Tick, const SMeshAnimation::SNodeAnimation::SKey& Key) { return Tick < Key.Time; }) };
+	auto KeyA{ KeyB - 1 };
+
+	float TimeSpan{ KeyB->Time - KeyA->Time };
+	if (TimeSpan <= 0.0f) return KeyA->Value;
+
+	float t{ (AnimationTick - KeyA->Time) / TimeSpan };
+	if (bIsRotation) return XMQuaternionSlerp(KeyA->Value, KeyB->Value, t);
+	return XMVectorLerp(KeyA->Value, KeyB->Value, t);
+}
+
 struct SMeshTreeNode
 {
 	struct SBlendWeight
@@ -68,6 +92,8 @@ struct SMESHData
 	std::unordered_map<std::string, size_t>	umapTreeNodeNameToIndex{};
 	uint32_t								ModelBoneCount{};
 	std::vector<SMeshAnimation>				vAnimations{};
+	bool									bUseCompressedAnimations{ false };
+	bool									bUsePackedVertices{ false }; // meshes that don't fit the error budgets are stored as they are
 
 	bool									bUseMultipleTexturesInSingleMesh{ false };
 	bool									bIgnoreSceneMaterial{ false };
@@ -117,19 +143,31 @@ public:
 	bool bShouldSave{ true };
 };
 
+struct SVertexPackingBenchmark
+{
+	size_t	RawByteCount{}; // of the file with raw vertices
+	size_t	PackedByteCount{}; // of the file with packed vertices
+	double	RawImportMilliseconds{};
+	double	PackedImportMilliseconds{};
+};
+
 class CMeshPorter
 {
 public:
 	CMeshPorter();
 	CMeshPorter(const std::vector<byte>& vBytes);
+	CMeshPorter(std::vector<byte>&& vBytes);
+	// @important: reads from Data in place, so Data must outlive the reads
+	CMeshPorter(const byte* const Data, size_t ByteCount);
 	~CMeshPorter();
 
 public:
 	void ImportMESH(const std::string& FileName, SMESHData& MESHFile);
-	void ExportMESH(const std::string& FileName, const SMESHData& MESHFile);
+	// @important: compressed files (see CLZCodec) are imported transparently
+	void ExportMESH(const std::string& FileName, const SMESHData& MESHFile, bool bShouldCompress = false);
 
 	void ImportTerrain(const std::string& FileName, STERRData& Data);
-	void ExportTerrain(const std::string& FileName, const STERRData& Data);
+	void ExportTerrain(const std::string& FileName, const STERRData& Data, bool bShouldCompress = false);
 
 public:
 	void ReadMESHData(SMESHData& MESHData);
@@ -139,8 +177,25 @@ private:
 	void ReadModelMaterials(std::vector<CMaterialData>& vMaterialData);
 	void WriteModelMaterials(const std::vector<CMaterialData>& vMaterialData);
 
+	void ReadCompressedNodeAnimations(SMeshAnimation& Animation);
+	void WriteCompressedNodeAnimations(const SMeshAnimation& Animation);
+	void ReadCompressedAnimationTrack(SCompressedAnimationTrack& Track);
+	void WriteCompressedAnimationTrack(const SCompressedAnimationTrack& Track);
+
+	void ReadPackedVertices(std::vector<SVertex3D>& vOutVertices);
+	void WritePackedVertices(const SPackedVertices& Packed);
+
+public:
+	const std::vector<byte>& GetBytes() const;
+
 public:
-	const std::vector<byte> GetBytes() const;
+	// Writes and reads MESHData in memory IterationCount times and returns the average throughputs in MB/s
+	static void MeasureMESHThroughput(const SMESHData& MESHData, uint32_t IterationCount, double& OutWriteMBps, double& OutReadMBps);
+	// Imports the file IterationCount times, read into memory first and mapped, and returns the average times in milliseconds
+	static void MeasureMESHImportTime(const std::string& FileName, uint32_t IterationCount, double& OutReadMilliseconds, double& OutMappedMilliseconds);
+	// Saves the MESH file again with raw and with packed vertices (uncompressed, to temporary files) and imports each IterationCount times
+	// Returns false if the file can't be read or the copies can't be written
+	static bool MeasureVertexPacking(const std::string& FileName, uint32_t IterationCount, SVertexPackingBenchmark& Out);
 
 private:
 	std::unique_ptr<CBinaryData> m_BinaryData{};
@@ -3,8 +3,16 @@
 #include "MeshPorter.h"
 #include "../Core/BinaryData.h"
 #include "../Core/ConstantBuffer.h"
+#include "../Core/FrustumCuller.h"
 #include "../Core/Material.h"
+#include "../Core/MeshOptimizer.h"
+#include "../Core/MeshSimplifier.h"
 #include "../Core/Shader.h"
+#include "../Core/StateCache.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <DirectXPackedVector.h>
 
 using std::max;
 using std::min;
@@ -12,6 +20,7 @@ using std::vector;
 using std::string;
 using std::to_string;
 using std::make_unique;
+using std::chrono::steady_clock;
 
 CObject3D::CObject3D(const std::string& Name, ID3D11Device* const PtrDevice, ID3D11DeviceContext* const PtrDeviceContext) :
 	m_Name{ Name }, m_PtrDevice{ PtrDevice }, m_PtrDeviceContext{ PtrDeviceContext }
@@ -26,6 +35,7 @@ CObject3D::~CObject3D()
 
 void CObject3D::Create(const SMESHData& MESHData)
 {
+	MarkSaveDirty();
 	m_Model = make_unique<SMESHData>(MESHData);
 
 	m_OuterBoundingSphere = MESHData.EditorBoundingSphereData;
@@ -35,8 +45,21 @@ void CObject3D::Create(const SMESHData& MESHData)
 	m_bIsCreated = true;
 }
 
+void CObject3D::Create(SMESHData&& MESHData)
+{
+	MarkSaveDirty();
+	m_Model = make_unique<SMESHData>(std::move(MESHData));
+
+	m_OuterBoundingSphere = m_Model->EditorBoundingSphereData;
+
+	InitializeModelData();
+
+	m_bIsCreated = true;
+}
+
 void CObject3D::Create(const SMesh& Mesh, const CMaterialData& MaterialData)
 {
+	MarkSaveDirty();
 	SMESHData Model{};
 	Model.vMeshes.emplace_back(Mesh);
 	Model.vMaterialData.emplace_back(MaterialData);
@@ -46,11 +69,13 @@ void CObject3D::Create(const SMesh& Mesh, const CMaterialData& MaterialData)
 
 void CObject3D::Create(const SMesh& Mesh)
 {
+	MarkSaveDirty();
 	Create(Mesh, CMaterialData());
 }
 
-void CObject3D::CreateFromFile(const string& FileName, bool bIsModelRigged)
+void CObject3D::CreateFromFile(const string& FileName, bool bIsModelRigged, SMESHData* const PtrDecodedModel)
 {
+	MarkSaveDirty();
 	m_ModelFileName = FileName;
 
 	size_t found{ m_ModelFileName.find_last_of(L'.') };
@@ -63,11 +88,18 @@ void CObject3D::CreateFromFile(const string& FileName, bool bIsModelRigged)
 	if (Ext == ".MESH")
 	{
 		// MESH file
-		CMeshPorter MeshPorter{};
-		SMESHData MESHData{};
-		MeshPorter.ImportMESH(m_ModelFileName, MESHData);
-		
-		Create(MESHData);
+		if (PtrDecodedModel)
+		{
+			Create(std::move(*PtrDecodedModel));
+		}
+		else
+		{
+			CMeshPorter MeshPorter{};
+			SMESHData MESHData{};
+			MeshPorter.ImportMESH(m_ModelFileName, MESHData);
+
+			Create(std::move(MESHData));
+		}
 	}
 	else
 	{
@@ -84,6 +116,13 @@ void CObject3D::CreateFromFile(const string& FileName, bool bIsModelRigged)
 			AssimpLoader.LoadStaticModelFromFile(FileName, &Model, m_PtrDevice, m_PtrDeviceContext);
 		}
 		OutputDebugString(("- Model [" + FileName + "] loaded. [" + to_string(GetTickCount64() - StartTimePoint) + "] elapsed.\n").c_str());
+		{
+			const SMeshOptimizationStatistics& Statistics{ AssimpLoader.GetMeshOptimizationStatistics() };
+			char Buffer[128]{};
+			snprintf(Buffer, sizeof(Buffer), "- Vertex cache: ACMR %.3f -> %.3f, ATVR %.3f -> %.3f\n",
+				Statistics.Before.ACMR, Statistics.After.ACMR, Statistics.Before.ATVR, Statistics.After.ATVR);
+			OutputDebugString(Buffer);
+		}
 
 		Create(Model);
 
@@ -95,7 +134,10 @@ void CObject3D::CreateFromFile(const string& FileName, bool bIsModelRigged)
 
 void CObject3D::InitializeModelData()
 {
+	m_vBakedAnimations.clear(); // @important: baked bone matrices depend on the node tree
+
 	_CreateMeshBuffers();
+	CreateOccluderMesh();
 	_CreateMaterialTextures();
 	_CreateConstantBuffers();
 	_InitializeAnimationData();
@@ -155,17 +197,36 @@ void CObject3D::__CreateMeshBuffer(size_t MeshIndex, bool IsAnimated)
 	}
 
 	{
+		SMeshBuffers& MeshBuffers{ m_vMeshBuffers[MeshIndex] };
+
+		// @important: every LOD shares one index buffer (LOD 0 first)
+		vector<STriangle> vLODTriangles{};
+		const vector<STriangle>* PtrTriangles{ &Mesh.vTriangles };
+		MeshBuffers.vLODIndexOffsets.assign(1, 0);
+		MeshBuffers.vLODIndexCounts.assign(1, static_cast<UINT>(Mesh.vTriangles.size() * 3));
+		if (Mesh.vLODTriangles.size())
+		{
+			vLODTriangles = Mesh.vTriangles;
+			for (const auto& vTriangles : Mesh.vLODTriangles)
+			{
+				MeshBuffers.vLODIndexOffsets.emplace_back(static_cast<UINT>(vLODTriangles.size() * 3));
+				MeshBuffers.vLODIndexCounts.emplace_back(static_cast<UINT>(vTriangles.size() * 3));
+				vLODTriangles.insert(vLODTriangles.end(), vTriangles.begin(), vTriangles.end());
+			}
+			PtrTriangles = &vLODTriangles;
+		}
+
 		D3D11_BUFFER_DESC BufferDesc{};
 		BufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-		BufferDesc.ByteWidth = static_cast<UINT>(sizeof(STriangle) * Mesh.vTriangles.size());
+		BufferDesc.ByteWidth = static_cast<UINT>(sizeof(STriangle) * PtrTriangles->size());
 		BufferDesc.CPUAccessFlags = 0;
 		BufferDesc.MiscFlags = 0;
 		BufferDesc.StructureByteStride = 0;
 		BufferDesc.Usage = D3D11_USAGE_DEFAULT;
 
 		D3D11_SUBRESOURCE_DATA SubresourceData{};
-		SubresourceData.pSysMem = &Mesh.vTriangles[0];
-		m_PtrDevice->CreateBuffer(&BufferDesc, &SubresourceData, &m_vMeshBuffers[MeshIndex].IndexBuffer);
+		SubresourceData.pSysMem = &(*PtrTriangles)[0];
+		m_PtrDevice->CreateBuffer(&BufferDesc, &SubresourceData, &MeshBuffers.IndexBuffer);
 	}
 }
 
@@ -201,14 +262,23 @@ void CObject3D::__CreateMaterialTexture(size_t Index)
 void CObject3D::_CreateConstantBuffers()
 {
 	m_CBMaterial = make_unique<CConstantBuffer>(m_PtrDevice, m_PtrDeviceContext, &m_CBMaterialData, sizeof(m_CBMaterialData));
+	m_CBMaterial->ShouldUseUploadRing(true);
 	m_CBMaterial->Create();
 }
 
 void CObject3D::CalculateEditorBoundingSphereData()
+{
+	CalculateEditorBoundingSphereData(*m_Model);
+
+	m_OuterBoundingSphere.Data.BS.RadiusBias = m_Model->EditorBoundingSphereData.Data.BS.RadiusBias;
+	m_OuterBoundingSphere.Center = m_Model->EditorBoundingSphereData.Center;
+}
+
+void CObject3D::CalculateEditorBoundingSphereData(SMESHData& Model)
 {
 	size_t VertexCount{};
 	XMVECTOR VertexCenter{};
-	for (const auto& Mesh : m_Model->vMeshes)
+	for (const auto& Mesh : Model.vMeshes)
 	{
 		for (const auto& Vertex : Mesh.vVertices)
 		{
@@ -219,7 +289,7 @@ void CObject3D::CalculateEditorBoundingSphereData()
 	VertexCenter /= static_cast<float>(VertexCount);
 
 	float MaxLengthSqaure{};
-	for (const auto& Mesh : m_Model->vMeshes)
+	for (const auto& Mesh : Model.vMeshes)
 	{
 		for (const auto& Vertex : Mesh.vVertices)
 		{
@@ -228,8 +298,8 @@ void CObject3D::CalculateEditorBoundingSphereData()
 		}
 	}
 
-	m_OuterBoundingSphere.Data.BS.RadiusBias = m_Model->EditorBoundingSphereData.Data.BS.RadiusBias = sqrt(MaxLengthSqaure);
-	m_OuterBoundingSphere.Center = m_Model->EditorBoundingSphereData.Center = VertexCenter;
+	Model.EditorBoundingSphereData.Data.BS.RadiusBias = sqrt(MaxLengthSqaure);
+	Model.EditorBoundingSphereData.Center = VertexCenter;
 }
 
 void CObject3D::_InitializeAnimationData()
@@ -241,16 +311,38 @@ void CObject3D::_InitializeAnimationData()
 	}
 
 	m_vAnimationBehaviorStartTicks.resize(m_Model->vAnimations.size());
+
+	__InitializePoseEvaluationData();
+}
+
+void CObject3D::__InitializePoseEvaluationData()
+{
+	const size_t KNodeCount{ m_Model->vTreeNodes.size() };
+
+	m_PoseEvaluator.Initialize(*m_Model);
+
+	m_vBasePose.resize(KNodeCount);
+	m_vBlendPose.resize(KNodeCount);
+	m_vLayerMaskWeights.resize(KNodeCount);
+	m_vAnimatedBoneMatrices.assign(m_PoseEvaluator.GetBoneMatrixCount(), XMMatrixIdentity());
+	m_bIsObjectPoseValid = false;
 }
 
 void CObject3D::LoadOB3D(const std::string& OB3DFileName, bool bIsRigged)
 {
+	MarkSaveDirty();
 	m_OB3DFileName = OB3DFileName;
 
 	CBinaryData Object3DBinary{};
-	string ReadString{};
+	Object3DBinary.LoadFromMappedFile(OB3DFileName);
 
-	Object3DBinary.LoadFromFile(OB3DFileName);
+	LoadOB3D(Object3DBinary, bIsRigged);
+}
+
+void CObject3D::LoadOB3D(CBinaryData& Object3DBinary, bool bIsRigged, SMESHData* const PtrDecodedModel)
+{
+	MarkSaveDirty();
+	string ReadString{};
 
 	// 8B (string) Signature
 	Object3DBinary.ReadSkip(8);
@@ -274,21 +366,29 @@ void CObject3D::LoadOB3D(const std::string& OB3DFileName, bool bIsRigged)
 		// 4B (uint32_t) Mesh byte count
 		// ?? (byte) Mesh bytes
 
+		// @important: the mesh is decoded in place from the mapped file
 		size_t MeshDataByteCount{ Object3DBinary.ReadUint32() };
-		vector<byte> MeshDataBinary{};
-		Object3DBinary.ReadBytes(MeshDataByteCount, MeshDataBinary);
+		const byte* PtrMeshData{};
+		Object3DBinary.ReadBytesInPlace(MeshDataByteCount, PtrMeshData);
 		
-		CMeshPorter MeshPorter{ MeshDataBinary };
-		SMESHData MeshData{};
-		MeshPorter.ReadMESHData(MeshData);
+		if (PtrDecodedModel)
+		{
+			Create(std::move(*PtrDecodedModel));
+		}
+		else
+		{
+			CMeshPorter MeshPorter{ PtrMeshData, (PtrMeshData) ? MeshDataByteCount : 0 };
+			SMESHData MeshData{};
+			MeshPorter.ReadMESHData(MeshData);
 
-		Create(MeshData);
+			Create(std::move(MeshData));
+		}
 	}
 	else
 	{
 		// <@PrefString> Model file name
 		Object3DBinary.ReadStringWithPrefixedLength(ReadString);
-		CreateFromFile(ReadString, bIsRigged);
+		CreateFromFile(ReadString, bIsRigged, PtrDecodedModel);
 	}
 	
 	// ### ComponentTransform ###
@@ -419,18 +519,36 @@ void CObject3D::LoadOB3D(const std::string& OB3DFileName, bool bIsRigged)
 			}
 		}
 	}
+
+	// ### Animation LOD ###
+	if (Version >= 0x10006)
+	{
+		SAnimationLODSettings AnimationLODSettings{};
+		Object3DBinary.ReadBool(AnimationLODSettings.bUseAnimationLOD);
+		Object3DBinary.ReadFloat(AnimationLODSettings.ReducedRateDistance);
+		Object3DBinary.ReadUint32(AnimationLODSettings.ReducedRateInterval);
+		Object3DBinary.ReadFloat(AnimationLODSettings.LeafBoneSkipDistance);
+		Object3DBinary.ReadBool(AnimationLODSettings.bShouldFreezeOffscreen);
+		SetAnimationLODSettings(AnimationLODSettings);
+	}
 }
 
-void CObject3D::SaveOB3D(const std::string& OB3DFileName)
+void CObject3D::SaveOB3D(const std::string& OB3DFileName, bool bShouldCompress)
 {
-	static constexpr uint16_t KVersionMajor{ 0x0001 };
-	static constexpr uint8_t KVersionMinor{ 0x00 };
-	static constexpr uint8_t KVersionSubminor{ 0x05 };
-	uint32_t Version{ (uint32_t)(KVersionSubminor | (KVersionMinor << 8) | (KVersionMajor << 16)) };
-
 	m_OB3DFileName = OB3DFileName;
 
 	CBinaryData Object3DBinary{};
+	SaveOB3D(Object3DBinary);
+
+	Object3DBinary.SaveToFile(OB3DFileName, bShouldCompress);
+}
+
+void CObject3D::SaveOB3D(CBinaryData& Object3DBinary)
+{
+	static constexpr uint16_t KVersionMajor{ 0x0001 };
+	static constexpr uint8_t KVersionMinor{ 0x00 };
+	static constexpr uint8_t KVersionSubminor{ 0x06 };
+	uint32_t Version{ (uint32_t)(KVersionSubminor | (KVersionMinor << 8) | (KVersionMajor << 16)) };
 
 	// 8B (string) Signature
 	Object3DBinary.WriteString("KJW_OB3D", 8);
@@ -463,7 +581,7 @@ void CObject3D::SaveOB3D(const std::string& OB3DFileName)
 			// ?? (byte) Mesh bytes
 			CMeshPorter MeshPorter{};
 			MeshPorter.WriteMESHData(*m_Model);
-			vector<byte> MeshBytes{ MeshPorter.GetBytes() };
+			const vector<byte>& MeshBytes{ MeshPorter.GetBytes() };
 
 			Object3DBinary.WriteUint32((uint32_t)MeshBytes.size());
 			Object3DBinary.AppendBytes(MeshBytes);
@@ -595,12 +713,97 @@ void CObject3D::SaveOB3D(const std::string& OB3DFileName)
 		}
 	}
 
-	Object3DBinary.SaveToFile(OB3DFileName);
+	// ### Animation LOD ###
+	if (Version >= 0x10006)
+	{
+		Object3DBinary.WriteBool(m_AnimationLODSettings.bUseAnimationLOD);
+		Object3DBinary.WriteFloat(m_AnimationLODSettings.ReducedRateDistance);
+		Object3DBinary.WriteUint32(m_AnimationLODSettings.ReducedRateInterval);
+		Object3DBinary.WriteFloat(m_AnimationLODSettings.LeafBoneSkipDistance);
+		Object3DBinary.WriteBool(m_AnimationLODSettings.bShouldFreezeOffscreen);
+	}
+}
+
+bool CObject3D::ReadOB3DHeader(CBinaryData& Object3DBinary, SOB3DHeader& Out)
+{
+	// @important: follows the layout of LoadOB3D()
+
+	// 8B (string) Signature
+	string Signature{};
+	if (!Object3DBinary.ReadString(Signature, 8) || Signature != "KJW_OB3D") return false;
+
+	// 4B (in total) Version
+	uint16_t VersionMajor{ Object3DBinary.ReadUint16() };
+	uint8_t VersionMinor{ Object3DBinary.ReadUint8() };
+	uint8_t VersionSubminor{ Object3DBinary.ReadUint8() };
+	Out.Version = (uint32_t)(VersionSubminor | (VersionMinor << 8) | (VersionMajor << 16));
+
+	// <@PrefString> Object3D name
+	if (!Object3DBinary.ReadStringWithPrefixedLength(Out.Name)) return false;
+
+	// 1B (bool) bIsPickable
+	if (Out.Version >= 0x10005) Object3DBinary.ReadBool();
+
+	// 1B (bool) bContainMeshData
+	bool bContainMeshData{ Object3DBinary.ReadBool() };
+	if (bContainMeshData)
+	{
+		// 4B (uint32_t) Mesh byte count
+		// ?? (byte) Mesh bytes
+		Out.MeshDataByteCount = Object3DBinary.ReadUint32();
+		Out.PtrMeshData = nullptr;
+		if (!Object3DBinary.ReadBytesInPlace(Out.MeshDataByteCount, Out.PtrMeshData)) return false;
+		Out.ModelFileName.clear();
+	}
+	else
+	{
+		// <@PrefString> Model file name
+		Out.PtrMeshData = nullptr;
+		Out.MeshDataByteCount = 0;
+		Object3DBinary.ReadStringWithPrefixedLength(Out.ModelFileName);
+	}
+	return true;
+}
+
+bool CObject3D::ReadOB3DSummary(CBinaryData& Object3DBinary, std::string& OutName, uint32_t& OutInstanceCount)
+{
+	// @important: follows the layout of LoadOB3D() up to the instance count
+	SOB3DHeader Header{};
+	if (!ReadOB3DHeader(Object3DBinary, Header)) return false;
+
+	OutName = Header.Name;
+	const uint32_t Version{ Header.Version };
+
+	// ### ComponentTransform ###
+	Object3DBinary.ReadSkip(16 + 4 * 3 + 16);
+
+	// ### ComponentPhysics ###
+	{
+		if (Version < 0x10005) Object3DBinary.ReadBool(); // ComponentPhysics.bIsPickable
+
+		Object3DBinary.ReadSkip(16 + 4);
+
+		if (Version >= 0x10002)
+		{
+			size_t BoundingVolumeCount{ Object3DBinary.ReadUint32() };
+			if (BoundingVolumeCount) Object3DBinary.ReadSkip(BoundingVolumeCount * (16 + 1 + 4 * 3));
+		}
+	}
+
+	// ### ComponentRender ###
+	{
+		Object3DBinary.ReadBool();
+		if (Version < 0x10005) Object3DBinary.ReadBool(); // ComponentRender.bShouldAnimate
+	}
+
+	// ### Instance ###
+	return Object3DBinary.ReadUint32(OutInstanceCount);
 }
 
 void CObject3D::ExportEmbeddedTextures(const std::string& Directory)
 {
 	if (!m_Model) return;
+	MarkSaveDirty();
 
 	size_t iMaterial{};
 	for (const auto& MaterialTextureSet : m_vMaterialTextureSets)
@@ -635,6 +838,7 @@ void CObject3D::ExportEmbeddedTexture(CMaterialTextureSet* const MaterialTexture
 
 void CObject3D::AddAnimationFromFile(const string& FileName, const string& AnimationName)
 {
+	MarkSaveDirty();
 	if (!m_Model->bIsModelRigged) return;
 
 	CAssimpLoader AssimpLoader{};
@@ -655,6 +859,7 @@ void CObject3D::AddAnimationFromFile(const string& FileName, const string& Anima
 
 void CObject3D::RegisterAnimation(uint32_t AnimationID, EAnimationRegistrationType eRegisteredType)
 {
+	MarkSaveDirty();
 	if (eRegisteredType == EAnimationRegistrationType::NotRegistered) return;
 
 	if (m_umapRegisteredAnimationTypeToIndex.find(eRegisteredType) == m_umapRegisteredAnimationTypeToIndex.end())
@@ -673,6 +878,7 @@ void CObject3D::RegisterAnimation(uint32_t AnimationID, EAnimationRegistrationTy
 
 void CObject3D::SetAnimationName(uint32_t AnimationID, const string& Name)
 {
+	MarkSaveDirty();
 	if (m_Model->vAnimations.empty())
 	{
 		MB_WARN("ִϸ̼  ʽϴ.", "ִϸ̼ ̸  ");
@@ -690,6 +896,7 @@ void CObject3D::SetAnimationName(uint32_t AnimationID, const string& Name)
 
 void CObject3D::SetAnimationTicksPerSecond(uint32_t AnimationID, float TPS)
 {
+	MarkSaveDirty();
 	if (m_Model->vAnimations.empty())
 	{
 		MB_WARN("ִϸ̼  ʽϴ.", "ִϸ̼ ̸  ");
@@ -701,9 +908,16 @@ void CObject3D::SetAnimationTicksPerSecond(uint32_t AnimationID, float TPS)
 
 void CObject3D::SetAnimationBehaviorStartTick(uint32_t AnimationID, float BehaviorStartTick)
 {
+	MarkSaveDirty();
 	m_vAnimationBehaviorStartTicks[AnimationID] = BehaviorStartTick;
 }
 
+void CObject3D::ShouldCompressAnimations(bool bShouldCompress)
+{
+	MarkSaveDirty();
+	if (m_Model) m_Model->bUseCompressedAnimations = bShouldCompress;
+}
+
 bool CObject3D::HasAnimations() const
 {
 	return (m_Model->vAnimations.size()) ? true : false;
@@ -750,7 +964,17 @@ float CObject3D::GetAnimationDuration(uint32_t AnimationID) const
 
 const DirectX::XMMATRIX* CObject3D::GetAnimationBoneMatrices() const
 {
-	return m_AnimatedBoneMatrices;
+	return (m_vAnimatedBoneMatrices.empty()) ? nullptr : &m_vAnimatedBoneMatrices[0];
+}
+
+uint32_t CObject3D::GetAnimationBoneMatrixCount() const
+{
+	return m_PoseEvaluator.GetBoneMatrixCount();
+}
+
+bool CObject3D::ShouldCompressAnimations() const
+{
+	return m_Model->bUseCompressedAnimations;
 }
 
 bool CObject3D::IsCurrentAnimationRegisteredAs(const SObjectIdentifier& Identifier, EAnimationRegistrationType eRegistrationType) const
@@ -848,7 +1072,7 @@ float CObject3D::GetInstanceCurrentAnimationBehaviorStartTick(const std::string&
 }
 
 void CObject3D::SetAnimation(const SObjectIdentifier& Identifier, uint32_t AnimationID, 
-	EAnimationOption eAnimationOption, bool bShouldIgnoreCurrentAnimation)
+	EAnimationOption eAnimationOption, bool bShouldIgnoreCurrentAnimation, float BlendTime)
 {
 	if (Identifier.InstanceName.size())
 	{
@@ -856,12 +1080,12 @@ void CObject3D::SetAnimation(const SObjectIdentifier& Identifier, uint32_t Anima
 	}
 	else
 	{
-		SetObjectAnimation(AnimationID, eAnimationOption, bShouldIgnoreCurrentAnimation);
+		SetObjectAnimation(AnimationID, eAnimationOption, bShouldIgnoreCurrentAnimation, BlendTime);
 	}
 }
 
 void CObject3D::SetAnimation(const SObjectIdentifier& Identifier, EAnimationRegistrationType eRegisteredType, 
-	EAnimationOption eAnimationOption, bool bShouldIgnoreCurrentAnimation)
+	EAnimationOption eAnimationOption, bool bShouldIgnoreCurrentAnimation, float BlendTime)
 {
 	if (Identifier.InstanceName.size())
 	{
@@ -869,167 +1093,494 @@ void CObject3D::SetAnimation(const SObjectIdentifier& Identifier, EAnimationRegi
 	}
 	else
 	{
-		SetObjectAnimation(eRegisteredType, eAnimationOption, bShouldIgnoreCurrentAnimation);
+		SetObjectAnimation(eRegisteredType, eAnimationOption, bShouldIgnoreCurrentAnimation, BlendTime);
 	}
 }
 
-void CObject3D::SetObjectAnimation(uint32_t AnimationID, EAnimationOption eAnimationOption, bool bShouldIgnoreCurrentAnimation)
+void CObject3D::SetAnimationLayer(uint32_t AnimationID, const std::string& MaskRootNodeName, float BlendTime, EAnimationOption eAnimationOption)
 {
 	size_t AnimationCount{ GetAnimationCount() };
 	if (AnimationCount == 0) return;
+	if (m_Model->vTreeNodes.empty()) return;
 
 	AnimationID = min(AnimationID, static_cast<uint32_t>(AnimationCount - 1));
 
-	if (!bShouldIgnoreCurrentAnimation)
+	if (MaskRootNodeName.empty())
 	{
-		if (m_CurrentAnimationID == AnimationID) return;
-		if (m_CurrentAnimationPlayCount == 0) return;
+		std::fill(m_vLayerMaskWeights.begin(), m_vLayerMaskWeights.end(), 1.0f);
 	}
+	else
+	{
+		if (m_Model->umapTreeNodeNameToIndex.find(MaskRootNodeName) == m_Model->umapTreeNodeNameToIndex.end()) return;
 
-	m_AnimationTick = 0; // @important
-	m_CurrentAnimationID = AnimationID;
-	m_CurrentAnimationPlayCount = 0;
-	m_eCurrentAnimationOption = eAnimationOption;
-}
+		std::fill(m_vLayerMaskWeights.begin(), m_vLayerMaskWeights.end(), 0.0f);
 
-void CObject3D::SetObjectAnimation(EAnimationRegistrationType eRegisteredType, EAnimationOption eAnimationOption, bool bShouldIgnoreCurrentAnimation)
-{
-	if (m_umapRegisteredAnimationTypeToIndex.find(eRegisteredType) == m_umapRegisteredAnimationTypeToIndex.end()) return;
-	size_t RegisteredAnimationIndex{ m_umapRegisteredAnimationTypeToIndex.at(eRegisteredType) };
-	uint32_t AnimationID{ m_vRegisteredAnimationIDs[RegisteredAnimationIndex] };
-	SetObjectAnimation(AnimationID, eAnimationOption, bShouldIgnoreCurrentAnimation);
+		// Mask the whole subtree of the root node (depth-first, without recursion)
+		size_t MaskRootNodeIndex{ m_Model->umapTreeNodeNameToIndex.at(MaskRootNodeName) };
+		m_vLayerMaskWeights[MaskRootNodeIndex] = 1.0f;
+		for (size_t iNode = MaskRootNodeIndex; iNode < m_Model->vTreeNodes.size(); ++iNode)
+		{
+			if (m_vLayerMaskWeights[iNode] == 0.0f) continue;
+			for (auto iChild : m_Model->vTreeNodes[iNode].vChildNodeIndices)
+			{
+				m_vLayerMaskWeights[iChild] = 1.0f;
+			}
+		}
+	}
+
+	m_bIsAnimationLayerActive = true;
+	m_LayerAnimationID = AnimationID;
+	m_LayerAnimationTick = 0;
+	m_eLayerAnimationOption = eAnimationOption;
+	m_LayerTargetWeight = 1.0f;
+	m_LayerBlendTime = BlendTime;
+	if (BlendTime <= 0.0f) m_LayerWeight = 1.0f;
 }
 
-void CObject3D::SetInstanceAnimation(const std::string& InstanceName, uint32_t AnimationID, EAnimationOption eAnimationOption, bool bShouldIgnoreCurrentAnimation)
+void CObject3D::ClearAnimationLayer(float BlendTime)
 {
-	size_t AnimationCount{ GetAnimationCount() };
-	if (AnimationCount == 0) return;
-
-	AnimationID = min(AnimationID, static_cast<uint32_t>(AnimationCount - 1));
-
-	auto& InstanceCPUData{ GetInstanceCPUData(InstanceName) };
-	auto& InstanceGPUData{ GetInstanceGPUData(InstanceName) };
-	if (!bShouldIgnoreCurrentAnimation)
+	m_LayerTargetWeight = 0.0f;
+	m_LayerBlendTime = BlendTime;
+	if (BlendTime <= 0.0f)
 	{
-		if (InstanceGPUData.CurrAnimID == AnimationID) return;
-		if (InstanceCPUData.CurrAnimPlayCount == 0) return;
+		m_LayerWeight = 0.0f;
+		m_bIsAnimationLayerActive = false;
 	}
-
-	InstanceGPUData.AnimTick = 0; // @important
-	InstanceGPUData.CurrAnimID = AnimationID;
-	InstanceCPUData.CurrAnimPlayCount = 0;
-	InstanceCPUData.eCurrAnimOption = eAnimationOption;
 }
 
-void CObject3D::SetInstanceAnimation(const std::string& InstanceName, EAnimationRegistrationType eRegisteredType, EAnimationOption eAnimationOption, bool bShouldIgnoreCurrentAnimation)
+bool CObject3D::IsBlendingAnimations() const
 {
-	if (m_umapRegisteredAnimationTypeToIndex.find(eRegisteredType) == m_umapRegisteredAnimationTypeToIndex.end()) return;
-	size_t RegisteredAnimationIndex{ m_umapRegisteredAnimationTypeToIndex.at(eRegisteredType) };
-	uint32_t AnimationID{ m_vRegisteredAnimationIDs[RegisteredAnimationIndex] };
-	SetInstanceAnimation(InstanceName, AnimationID, eAnimationOption, bShouldIgnoreCurrentAnimation);
+	return (m_CrossfadeTime > 0.0f) || m_bIsAnimationLayerActive;
 }
 
-const SComponentTransform& CObject3D::GetTransform(const SObjectIdentifier& Identifier) const
+void CObject3D::MeasurePoseEvaluationTime(uint32_t IterationCount, double& OutUnblendedMicroseconds, double& OutBlendedMicroseconds) const
 {
-	if (Identifier.InstanceName.size())
-	{
-		return GetInstanceTransform(Identifier.InstanceName);
-	}
-	return GetTransform();
+	OutUnblendedMicroseconds = OutBlendedMicroseconds = 0;
+	if (!HasAnimations()) return;
+
+	uint32_t OtherAnimationID{ (m_CurrentAnimationID + 1) % (uint32_t)GetAnimationCount() };
+	m_PoseEvaluator.MeasurePoseEvaluationTime(m_CurrentAnimationID, OtherAnimationID, m_AnimationTick, &m_vLayerMaskWeights, IterationCount,
+		OutUnblendedMicroseconds, OutBlendedMicroseconds);
 }
 
-const SComponentPhysics& CObject3D::GetPhysics(const SObjectIdentifier& Identifier) const
+void CObject3D::SetAnimationLODSettings(const SAnimationLODSettings& Settings)
 {
-	if (Identifier.InstanceName.size())
-	{
-		return GetInstancePhysics(Identifier.InstanceName);
-	}
-	return GetPhysics();
+	MarkSaveDirty();
+	m_AnimationLODSettings = Settings;
+	m_AnimationLODSettings.ReducedRateInterval = max(m_AnimationLODSettings.ReducedRateInterval, (uint32_t)1);
 }
 
-CObject3D::EFlagsRendering CObject3D::GetRenderingFlags() const
+const CObject3D::SAnimationLODSettings& CObject3D::GetAnimationLODSettings() const
 {
-	return m_eFlagsRendering;
+	return m_AnimationLODSettings;
 }
 
-const SBoundingVolume& CObject3D::GetOuterBoundingSphere(const SObjectIdentifier& Identifier) const
+void CObject3D::UpdateAnimationLOD(const XMVECTOR& EyePosition, const BoundingFrustum& ViewFrustum)
 {
-	if (Identifier.InstanceName.size())
-	{
-		return GetInstanceOuterBoundingSphere(Identifier.InstanceName);
-	}
-	return GetOuterBoundingSphere();
+	if (!m_AnimationLODSettings.bUseAnimationLOD) return;
+
+	XMVECTOR Center{ m_ComponentTransform.Translation + m_OuterBoundingSphere.Center };
+	m_AnimationLODDistance = XMVectorGetX(XMVector3Length(Center - EyePosition));
+
+	BoundingSphere Sphere{};
+	XMStoreFloat3(&Sphere.Center, Center);
+	Sphere.Radius = m_OuterBoundingSphere.Data.BS.Radius;
+	m_bIsInViewFrustum = (ViewFrustum.Contains(Sphere) != ContainmentType::DISJOINT);
 }
 
-void CObject3D::TranslateTo(const SObjectIdentifier& Identifier, const XMVECTOR& Prime)
+const CObject3D::SAnimationLODStatistics& CObject3D::GetAnimationLODStatistics() const
 {
-	if (Identifier.InstanceName.size())
-	{
-		TranslateInstanceTo(Identifier.InstanceName, Prime);
-		return;
-	}
-	TranslateTo(Prime);
+	return m_AnimationLODStatistics;
 }
 
-void CObject3D::RotatePitchTo(const SObjectIdentifier& Identifier, float Prime)
+void CObject3D::GenerateMeshLODs(uint32_t LODCount)
 {
-	if (Identifier.InstanceName.size())
-	{
-		RotateInstancePitchTo(Identifier.InstanceName, Prime);
-		return;
-	}
-	RotatePitchTo(Prime);
+	MarkSaveDirty();
+	GenerateMeshLODs(*m_Model, LODCount);
+
+	m_CurrentMeshLOD = 0;
+	_CreateMeshBuffers();
 }
 
-void CObject3D::RotateYawTo(const SObjectIdentifier& Identifier, float Prime)
+void CObject3D::GenerateMeshLODs(SMESHData& Model, uint32_t LODCount)
 {
-	if (Identifier.InstanceName.size())
+	static_assert(sizeof(STriangle) == sizeof(uint32_t) * 3, "STriangle must be 3 packed indices");
+	assert(LODCount >= 1 && LODCount <= KMaxMeshLODCount);
+
+	CMeshSimplifier Simplifier{};
+	vector<XMFLOAT3> vPositions{};
+	vector<uint32_t> vIndices{};
+	vector<uint32_t> vVertexGroups{};
+	for (SMesh& Mesh : Model.vMeshes)
 	{
-		RotateInstanceYawTo(Identifier.InstanceName, Prime);
-		return;
+		Mesh.vLODTriangles.clear();
+		if (Mesh.vTriangles.empty()) continue;
+
+		XMVECTOR Min{ XMVectorReplicate(+FLT_MAX) };
+		XMVECTOR Max{ XMVectorReplicate(-FLT_MAX) };
+		vPositions.resize(Mesh.vVertices.size());
+		for (size_t iVertex = 0; iVertex < Mesh.vVertices.size(); ++iVertex)
+		{
+			XMStoreFloat3(&vPositions[iVertex], Mesh.vVertices[iVertex].Position);
+			Min = XMVectorMin(Min, Mesh.vVertices[iVertex].Position);
+			Max = XMVectorMax(Max, Mesh.vVertices[iVertex].Position);
+		}
+		const float KMeshSize{ XMVectorGetX(XMVector3Length(Max - Min)) };
+
+		const uint32_t* const PtrIndices{ &Mesh.vTriangles[0].I0 };
+		vIndices.assign(PtrIndices, PtrIndices + Mesh.vTriangles.size() * 3);
+
+		// @important: skinned vertices are collapsed only into vertices that mostly follow the same bone,
+		// so that the skin weights of the remaining vertices still fit the surface they cover
+		bool bUseVertexGroups{ Model.bIsModelRigged && Mesh.vAnimationVertices.size() == Mesh.vVertices.size() };
+		if (bUseVertexGroups)
+		{
+			vVertexGroups.resize(Mesh.vVertices.size());
+			for (size_t iVertex = 0; iVertex < Mesh.vAnimationVertices.size(); ++iVertex)
+			{
+				const SAnimationVertex& AnimationVertex{ Mesh.vAnimationVertices[iVertex] };
+				uint32_t iHeaviest{};
+				for (uint32_t iWeight = 1; iWeight < SAnimationVertex::KMaxWeightCount; ++iWeight)
+				{
+					if (AnimationVertex.Weights[iWeight] > AnimationVertex.Weights[iHeaviest]) iHeaviest = iWeight;
+				}
+				vVertexGroups[iVertex] = AnimationVertex.BoneIDs[iHeaviest];
+			}
+		}
+		Simplifier.SetMesh(vPositions, vIndices, (bUseVertexGroups) ? &vVertexGroups : nullptr);
+
+		uint32_t PreviousTriangleCount{ (uint32_t)Mesh.vTriangles.size() };
+		float MaxError{ KMeshSize * KMeshLODMaxErrorRatio };
+		for (uint32_t iLOD = 1; iLOD < LODCount; ++iLOD)
+		{
+			uint32_t TriangleCount{ Simplifier.Simplify(PreviousTriangleCount / 2, MaxError) };
+
+			// @important: a LOD that barely reduces the triangles (e.g. seams everywhere, or the error limit) isn't worth drawing
+			if (TriangleCount == 0 || TriangleCount > PreviousTriangleCount * 4 / 5) break;
+
+			// @important: simplification scatters the triangles, so each LOD is reordered for the vertex cache again
+			vIndices = Simplifier.GetIndices();
+			CMeshOptimizer::OptimizeVertexCache(vIndices, (uint32_t)Mesh.vVertices.size());
+
+			Mesh.vLODTriangles.emplace_back(TriangleCount);
+			memcpy(&Mesh.vLODTriangles.back()[0], &vIndices[0], sizeof(STriangle) * TriangleCount);
+
+			PreviousTriangleCount = TriangleCount;
+			MaxError *= 2.0f;
+		}
 	}
-	RotateYawTo(Prime);
 }
 
-void CObject3D::RotateRollTo(const SObjectIdentifier& Identifier, float Prime)
+double CObject3D::MeasureMeshLODGenerationTime(const string& MESHFileName, uint32_t LODCount, uint32_t IterationCount,
+	vector<size_t>& vOutLODTriangleCounts)
 {
-	if (Identifier.InstanceName.size())
+	vOutLODTriangleCounts.clear();
+	if (IterationCount == 0) return 0.0;
+
+	SMESHData SourceModel{};
+	CMeshPorter MeshPorter{};
+	MeshPorter.ImportMESH(MESHFileName, SourceModel);
+	if (SourceModel.vMeshes.empty()) return 0.0;
+
+	// @important: every iteration starts from the imported meshes, whose copy isn't measured
+	SMESHData Model{};
+	double TotalMilliseconds{};
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
 	{
-		RotateInstanceRollTo(Identifier.InstanceName, Prime);
-		return;
+		Model = SourceModel;
+		auto StartTimePoint{ steady_clock::now() };
+		GenerateMeshLODs(Model, LODCount);
+		TotalMilliseconds += std::chrono::duration<double, std::milli>(steady_clock::now() - StartTimePoint).count();
 	}
-	RotateRollTo(Prime);
-}
 
-void CObject3D::ScaleTo(const SObjectIdentifier& Identifier, const XMVECTOR& Prime)
-{
-	if (Identifier.InstanceName.size())
+	// Meshes that ran out of LODs are drawn with their last one (see GetMeshLODTriangleCount())
+	vOutLODTriangleCounts.resize(LODCount);
+	for (const SMesh& Mesh : Model.vMeshes)
 	{
-		ScaleInstanceTo(Identifier.InstanceName, Prime);
-		return;
+		for (uint32_t iLOD = 0; iLOD < LODCount; ++iLOD)
+		{
+			size_t MeshLOD{ min((size_t)iLOD, Mesh.vLODTriangles.size()) };
+			vOutLODTriangleCounts[iLOD] += (MeshLOD == 0) ? Mesh.vTriangles.size() : Mesh.vLODTriangles[MeshLOD - 1].size();
+		}
 	}
-	ScaleTo(Prime);
+
+	return TotalMilliseconds / IterationCount;
 }
 
-void CObject3D::Translate(const SObjectIdentifier& Identifier, const XMVECTOR& Delta)
+void CObject3D::ClearMeshLODs()
 {
-	if (Identifier.InstanceName.size())
+	MarkSaveDirty();
+	for (SMesh& Mesh : m_Model->vMeshes)
 	{
-		TranslateInstance(Identifier.InstanceName, Delta);
-		return;
+		Mesh.vLODTriangles.clear();
 	}
-	Translate(Delta);
+
+	m_CurrentMeshLOD = 0;
+	_CreateMeshBuffers();
 }
 
-void CObject3D::RotatePitch(const SObjectIdentifier& Identifier, float Delta)
+void CObject3D::UpdateMeshLOD(const XMVECTOR& EyePosition, float ProjectionScaleY)
 {
-	if (Identifier.InstanceName.size())
+	const uint32_t KLODCount{ GetMeshLODCount() };
+	if (KLODCount <= 1)
 	{
-		RotateInstancePitch(Identifier.InstanceName, Delta);
+		m_CurrentMeshLOD = 0;
 		return;
 	}
-	RotatePitch(Delta);
-}
+
+	auto GetScreenSize{ [&](const XMVECTOR& Center, float Radius)
+		{
+			float Distance{ XMVectorGetX(XMVector3Length(Center - EyePosition)) };
+			if (Distance <= Radius) return FLT_MAX;
+			return Radius * ProjectionScaleY / Distance;
+		}
+	};
+
+	float ScreenSize{};
+	if (IsInstanced())
+	{
+		// @important: every instance is drawn with the same LOD, so the largest visible one decides it
+		if (m_vInstanceBoundingSpheres.size() != m_vInstanceCPUData.size())
+		{
+			ScreenSize = FLT_MAX;
+		}
+		else if (m_vVisibleInstanceIndices.size())
+		{
+			for (uint32_t iInstance : m_vVisibleInstanceIndices)
+			{
+				const XMFLOAT4& Sphere{ m_vInstanceBoundingSpheres[iInstance] };
+				ScreenSize = max(ScreenSize, GetScreenSize(XMVectorSet(Sphere.x, Sphere.y, Sphere.z, 1.0f), Sphere.w));
+			}
+		}
+		else
+		{
+			// Shadow casters that are not visible
+			for (const XMFLOAT4& Sphere : m_vInstanceBoundingSpheres)
+			{
+				ScreenSize = max(ScreenSize, GetScreenSize(XMVectorSet(Sphere.x, Sphere.y, Sphere.z, 1.0f), Sphere.w));
+			}
+		}
+	}
+	else
+	{
+		ScreenSize = GetScreenSize(m_ComponentTransform.Translation + m_OuterBoundingSphere.Center, m_OuterBoundingSphere.Data.BS.Radius);
+	}
+
+	uint32_t LOD{ min(m_CurrentMeshLOD, KLODCount - 1) };
+	while (LOD + 1 < KLODCount && ScreenSize < GetMeshLODScreenSize(LOD + 1) * (1.0f - KMeshLODHysteresis)) ++LOD;
+	while (LOD > 0 && ScreenSize > GetMeshLODScreenSize(LOD) * (1.0f + KMeshLODHysteresis)) --LOD;
+	m_CurrentMeshLOD = LOD;
+}
+
+uint32_t CObject3D::GetMeshLODCount() const
+{
+	size_t LODCount{ 1 };
+	for (const SMesh& Mesh : m_Model->vMeshes)
+	{
+		LODCount = max(LODCount, Mesh.vLODTriangles.size() + 1);
+	}
+	return (uint32_t)LODCount;
+}
+
+uint32_t CObject3D::GetCurrentMeshLOD() const
+{
+	return m_CurrentMeshLOD;
+}
+
+size_t CObject3D::GetMeshLODTriangleCount(uint32_t LOD) const
+{
+	size_t TriangleCount{};
+	for (const SMesh& Mesh : m_Model->vMeshes)
+	{
+		size_t MeshLOD{ min((size_t)LOD, Mesh.vLODTriangles.size()) };
+		TriangleCount += (MeshLOD == 0) ? Mesh.vTriangles.size() : Mesh.vLODTriangles[MeshLOD - 1].size();
+	}
+	return TriangleCount;
+}
+
+float CObject3D::GetMeshLODScreenSize(uint32_t LOD)
+{
+	assert(LOD >= 1);
+
+	return KMeshLODFirstScreenSize / (float)(1 << (LOD - 1));
+}
+
+void CObject3D::SetObjectAnimation(uint32_t AnimationID, EAnimationOption eAnimationOption, bool bShouldIgnoreCurrentAnimation, float BlendTime)
+{
+	MarkSaveDirty();
+	size_t AnimationCount{ GetAnimationCount() };
+	if (AnimationCount == 0) return;
+
+	AnimationID = min(AnimationID, static_cast<uint32_t>(AnimationCount - 1));
+
+	if (!bShouldIgnoreCurrentAnimation)
+	{
+		if (m_CurrentAnimationID == AnimationID) return;
+		if (m_CurrentAnimationPlayCount == 0) return;
+	}
+
+	if (BlendTime > 0.0f)
+	{
+		// The outgoing animation keeps playing while it fades out
+		m_CrossfadeAnimationID = m_CurrentAnimationID;
+		m_CrossfadeAnimationTick = m_AnimationTick;
+		m_eCrossfadeAnimationOption = m_eCurrentAnimationOption;
+		m_CrossfadeTime = BlendTime;
+		m_CrossfadeElapsedTime = 0.0f;
+	}
+	else
+	{
+		m_CrossfadeTime = 0.0f;
+	}
+
+	m_AnimationTick = 0; // @important
+	m_CurrentAnimationID = AnimationID;
+	m_CurrentAnimationPlayCount = 0;
+	m_eCurrentAnimationOption = eAnimationOption;
+}
+
+void CObject3D::SetObjectAnimation(EAnimationRegistrationType eRegisteredType, EAnimationOption eAnimationOption, bool bShouldIgnoreCurrentAnimation,
+	float BlendTime)
+{
+	MarkSaveDirty();
+	if (m_umapRegisteredAnimationTypeToIndex.find(eRegisteredType) == m_umapRegisteredAnimationTypeToIndex.end()) return;
+	size_t RegisteredAnimationIndex{ m_umapRegisteredAnimationTypeToIndex.at(eRegisteredType) };
+	uint32_t AnimationID{ m_vRegisteredAnimationIDs[RegisteredAnimationIndex] };
+	SetObjectAnimation(AnimationID, eAnimationOption, bShouldIgnoreCurrentAnimation, BlendTime);
+}
+
+void CObject3D::SetInstanceAnimation(const std::string& InstanceName, uint32_t AnimationID, EAnimationOption eAnimationOption, bool bShouldIgnoreCurrentAnimation)
+{
+	MarkSaveDirty();
+	size_t AnimationCount{ GetAnimationCount() };
+	if (AnimationCount == 0) return;
+
+	AnimationID = min(AnimationID, static_cast<uint32_t>(AnimationCount - 1));
+
+	auto& InstanceCPUData{ GetInstanceCPUData(InstanceName) };
+	auto& InstanceGPUData{ GetInstanceGPUData(InstanceName) };
+	if (!bShouldIgnoreCurrentAnimation)
+	{
+		if (InstanceGPUData.CurrAnimID == AnimationID) return;
+		if (InstanceCPUData.CurrAnimPlayCount == 0) return;
+	}
+
+	InstanceGPUData.AnimTick = 0; // @important
+	InstanceGPUData.CurrAnimID = AnimationID;
+	InstanceCPUData.CurrAnimPlayCount = 0;
+	InstanceCPUData.eCurrAnimOption = eAnimationOption;
+}
+
+void CObject3D::SetInstanceAnimation(const std::string& InstanceName, EAnimationRegistrationType eRegisteredType, EAnimationOption eAnimationOption, bool bShouldIgnoreCurrentAnimation)
+{
+	MarkSaveDirty();
+	if (m_umapRegisteredAnimationTypeToIndex.find(eRegisteredType) == m_umapRegisteredAnimationTypeToIndex.end()) return;
+	size_t RegisteredAnimationIndex{ m_umapRegisteredAnimationTypeToIndex.at(eRegisteredType) };
+	uint32_t AnimationID{ m_vRegisteredAnimationIDs[RegisteredAnimationIndex] };
+	SetInstanceAnimation(InstanceName, AnimationID, eAnimationOption, bShouldIgnoreCurrentAnimation);
+}
+
+const SComponentTransform& CObject3D::GetTransform(const SObjectIdentifier& Identifier) const
+{
+	if (Identifier.InstanceName.size())
+	{
+		return GetInstanceTransform(Identifier.InstanceName);
+	}
+	return GetTransform();
+}
+
+const SComponentPhysics& CObject3D::GetPhysics(const SObjectIdentifier& Identifier) const
+{
+	if (Identifier.InstanceName.size())
+	{
+		return GetInstancePhysics(Identifier.InstanceName);
+	}
+	return GetPhysics();
+}
+
+CObject3D::EFlagsRendering CObject3D::GetRenderingFlags() const
+{
+	return m_eFlagsRendering;
+}
+
+const SBoundingVolume& CObject3D::GetOuterBoundingSphere(const SObjectIdentifier& Identifier) const
+{
+	if (Identifier.InstanceName.size())
+	{
+		return GetInstanceOuterBoundingSphere(Identifier.InstanceName);
+	}
+	return GetOuterBoundingSphere();
+}
+
+void CObject3D::TranslateTo(const SObjectIdentifier& Identifier, const XMVECTOR& Prime)
+{
+	if (Identifier.InstanceName.size())
+	{
+		TranslateInstanceTo(Identifier.InstanceName, Prime);
+		return;
+	}
+	TranslateTo(Prime);
+}
+
+void CObject3D::RotatePitchTo(const SObjectIdentifier& Identifier, float Prime)
+{
+	if (Identifier.InstanceName.size())
+	{
+		RotateInstancePitchTo(Identifier.InstanceName, Prime);
+		return;
+	}
+	RotatePitchTo(Prime);
+}
+
+void CObject3D::RotateYawTo(const SObjectIdentifier& Identifier, float Prime)
+{
+	if (Identifier.InstanceName.size())
+	{
+		RotateInstanceYawTo(Identifier.InstanceName, Prime);
+		return;
+	}
+	RotateYawTo(Prime);
+}
+
+void CObject3D::RotateRollTo(const SObjectIdentifier& Identifier, float Prime)
+{
+	if (Identifier.InstanceName.size())
+	{
+		RotateInstanceRollTo(Identifier.InstanceName, Prime);
+		return;
+	}
+	RotateRollTo(Prime);
+}
+
+void CObject3D::ScaleTo(const SObjectIdentifier& Identifier, const XMVECTOR& Prime)
+{
+	if (Identifier.InstanceName.size())
+	{
+		ScaleInstanceTo(Identifier.InstanceName, Prime);
+		return;
+	}
+	ScaleTo(Prime);
+}
+
+void CObject3D::Translate(const SObjectIdentifier& Identifier, const XMVECTOR& Delta)
+{
+	if (Identifier.InstanceName.size())
+	{
+		TranslateInstance(Identifier.InstanceName, Delta);
+		return;
+	}
+	Translate(Delta);
+}
+
+void CObject3D::RotatePitch(const SObjectIdentifier& Identifier, float Delta)
+{
+	if (Identifier.InstanceName.size())
+	{
+		RotateInstancePitch(Identifier.InstanceName, Delta);
+		return;
+	}
+	RotatePitch(Delta);
+}
 
 void CObject3D::RotateYaw(const SObjectIdentifier& Identifier, float Delta)
 {
@@ -1103,16 +1654,19 @@ void CObject3D::AddLinearVelocity(const SObjectIdentifier& Identifier, const XMV
 
 void CObject3D::SetTransform(const SComponentTransform& NewValue)
 {
+	MarkSaveDirty();
 	m_ComponentTransform = NewValue;
 }
 
 void CObject3D::SetPhysics(const SComponentPhysics& NewValue)
 {
+	MarkSaveDirty();
 	m_ComponentPhysics = NewValue;
 }
 
 void CObject3D::SetRender(const SComponentRender& NewValue)
 {
+	MarkSaveDirty();
 	m_ComponentRender = NewValue;
 }
 
@@ -1148,51 +1702,61 @@ std::vector<SBoundingVolume>& CObject3D::GetInnerBoundingVolumeVector()
 
 void CObject3D::TranslateTo(const XMVECTOR& Prime)
 {
+	MarkSaveDirty();
 	m_ComponentTransform.Translation = Prime;
 }
 
 void CObject3D::RotatePitchTo(float Prime)
 {
+	MarkSaveDirty();
 	m_ComponentTransform.Pitch = Prime;
 }
 
 void CObject3D::RotateYawTo(float Prime)
 {
+	MarkSaveDirty();
 	m_ComponentTransform.Yaw = Prime;
 }
 
 void CObject3D::RotateRollTo(float Prime)
 {
+	MarkSaveDirty();
 	m_ComponentTransform.Roll = Prime;
 }
 
 void CObject3D::ScaleTo(const XMVECTOR& Prime)
 {
+	MarkSaveDirty();
 	m_ComponentTransform.Scaling = Prime;
 }
 
 void CObject3D::Translate(const XMVECTOR& Delta)
 {
+	MarkSaveDirty();
 	m_ComponentTransform.Translation += Delta;
 }
 
 void CObject3D::RotatePitch(float Delta)
 {
+	MarkSaveDirty();
 	m_ComponentTransform.Pitch += Delta;
 }
 
 void CObject3D::RotateYaw(float Delta)
 {
+	MarkSaveDirty();
 	m_ComponentTransform.Yaw += Delta;
 }
 
 void CObject3D::RotateRoll(float Delta)
 {
+	MarkSaveDirty();
 	m_ComponentTransform.Roll += Delta;
 }
 
 void CObject3D::Scale(const XMVECTOR& Delta)
 {
+	MarkSaveDirty();
 	m_ComponentTransform.Scaling += Delta;
 }
 
@@ -1228,78 +1792,55 @@ bool CObject3D::CanBakeAnimationTexture() const
 
 void CObject3D::BakeAnimationTexture()
 {
+	MarkSaveDirty();
 	if (m_Model->vAnimations.empty()) return;
 
-	// TODO: corret sign-ness ??
+	auto StartTimePoint{ steady_clock::now() };
 
-	int32_t AnimationCount{ (int32_t)GetAnimationCount() };
-	int32_t TextureHeight{ KAnimationTextureReservedHeight };
-	vector<int32_t> vAnimationHeights{};
-	for (const auto& Animation : m_Model->vAnimations)
+	// @important: only animations that have changed since the last bake are evaluated
+	uint32_t EvaluatedAnimationCount{ m_PoseEvaluator.BakeAnimations(m_vBakedAnimations) };
+
+	bool bUseHalfFloat{ m_bShouldBakeHalfFloatAnimationTexture };
+	if (bUseHalfFloat && m_PoseEvaluator.GetAnimationTextureHeight(true) > CPoseEvaluator::KAnimationTextureHalfFloatMaxHeight)
 	{
-		vAnimationHeights.emplace_back((int32_t)Animation.Duration + 1);
-		TextureHeight += vAnimationHeights.back();
+		MB_WARN(("ִϸ̼ ؽó ̰ " + to_string(CPoseEvaluator::KAnimationTextureHalfFloatMaxHeight) + " Ѿ 32Ʈ ϴ.").c_str(),
+			"16Ʈ ִϸ̼ ؽó  ");
+		bUseHalfFloat = false;
 	}
+	int32_t TextureHeight{ m_PoseEvaluator.GetAnimationTextureHeight(bUseHalfFloat) };
+	int32_t TextureWidth{ m_PoseEvaluator.GetAnimationTextureWidth() };
 
 	m_BakedAnimationTexture = make_unique<CTexture>(m_PtrDevice, m_PtrDeviceContext);
-	m_BakedAnimationTexture->CreateBlankTexture(CTexture::EFormat::Pixel128Float, XMFLOAT2((float)KAnimationTextureWidth, (float)TextureHeight));
+	m_BakedAnimationTexture->CreateBlankTexture((bUseHalfFloat) ? CTexture::EFormat::Pixel64Float : CTexture::EFormat::Pixel128Float,
+		XMFLOAT2((float)TextureWidth, (float)TextureHeight));
 	m_BakedAnimationTexture->SetShaderType(EShaderType::VertexShader);
 
-	vector<SPixel128Float> vRawData{};
-	
-	vRawData.resize((int64_t)KAnimationTextureWidth * TextureHeight);
-	vRawData[0].R = 'A';
-	vRawData[0].G = 'N';
-	vRawData[0].B = 'I';
-	vRawData[0].A = 'M';
-
-	float fAnimationCount{ (float)AnimationCount };
-	memcpy(&vRawData[1].R, &fAnimationCount, sizeof(float));
-
-	int32_t AnimationHeightSum{ KAnimationTextureReservedHeight };
-	for (int32_t iAnimation = 0; iAnimation < (int32_t)vAnimationHeights.size(); ++iAnimation)
+	if (bUseHalfFloat)
 	{
-		float fAnimationHeightSum{ (float)AnimationHeightSum };
-		memcpy(&vRawData[(int64_t)KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 0].R,
-			&fAnimationHeightSum, sizeof(float));
-		memcpy(&vRawData[(int64_t)KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 0].G,
-			&m_Model->vAnimations[iAnimation].Duration, sizeof(float));
-		memcpy(&vRawData[(int64_t)KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 0].B,
-			&m_Model->vAnimations[iAnimation].TicksPerSecond, sizeof(float));
-		//A
-
-		// RGBA = 4 floats = 16 chars!
-		memcpy(&vRawData[(int64_t)KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 1].R,
-			m_Model->vAnimations[iAnimation].Name.c_str(), sizeof(char) * 16);
-
-		AnimationHeightSum += vAnimationHeights[iAnimation];
+		vector<SPixel64Float> vHalfRawData{};
+		m_PoseEvaluator.BuildAnimationTextureData(m_vBakedAnimations, vHalfRawData);
+		m_BakedAnimationTexture->UpdateTextureRawData(&vHalfRawData[0]);
 	}
-
-	for (int32_t iAnimation = 0; iAnimation < (int32_t)m_Model->vAnimations.size(); ++iAnimation)
+	else
 	{
-		float fAnimationOffset{};
-		memcpy(&fAnimationOffset, &vRawData[(int64_t)KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 0].R, sizeof(float));
+		vector<SPixel128Float> vRawData{};
+		m_PoseEvaluator.BuildAnimationTextureData(m_vBakedAnimations, vRawData);
+		m_BakedAnimationTexture->UpdateTextureRawData(&vRawData[0]);
+	}
 
-		const int32_t KAnimationYOffset{ (int32_t)fAnimationOffset };
-		const int32_t KAnimationOffset{ (int32_t)((int64_t)KAnimationYOffset * KAnimationTextureWidth) };
-		const SMeshAnimation& Animation{ m_Model->vAnimations[iAnimation] };
-		
-		int32_t Duration{ (int32_t)Animation.Duration + 1 };
-		for (int32_t iTime = 0; iTime < Duration; ++iTime)
-		{
-			const int32_t KTimeOffset{ (int32_t)((int64_t)iTime * KAnimationTextureWidth) };
-			CalculateAnimatedBoneMatrices(Animation, (float)iTime, m_Model->vTreeNodes[0], XMMatrixIdentity());
+	OutputDebugString(("- Animation texture baked. [" + to_string(EvaluatedAnimationCount) + "/" + to_string(GetAnimationCount()) +
+		"] animations evaluated. [" + to_string(std::chrono::duration_cast<std::chrono::milliseconds>(steady_clock::now() - StartTimePoint).count()) +
+		"] ms elapsed.\n").c_str());
+}
 
-			for (int32_t iBoneMatrix = 0; iBoneMatrix < (int32_t)KMaxBoneMatrixCount; ++iBoneMatrix)
-			{
-				const auto& BoneMatrix{ m_AnimatedBoneMatrices[iBoneMatrix] };
-				XMMATRIX TransposedBoneMatrix{ XMMatrixTranspose(BoneMatrix) };
-				memcpy(&vRawData[(int64_t)KAnimationOffset + KTimeOffset + (int64_t)iBoneMatrix * 4].R, &TransposedBoneMatrix, sizeof(XMMATRIX));
-			}
-		}
-	}
+void CObject3D::ShouldBakeHalfFloatAnimationTexture(bool bShouldUseHalfFloat)
+{
+	m_bShouldBakeHalfFloatAnimationTexture = bShouldUseHalfFloat;
+}
 
-	m_BakedAnimationTexture->UpdateTextureRawData(&vRawData[0]);
+bool CObject3D::ShouldBakeHalfFloatAnimationTexture() const
+{
+	return m_bShouldBakeHalfFloatAnimationTexture;
 }
 
 void CObject3D::SaveBakedAnimationTexture(const string& FileName)
@@ -1311,6 +1852,7 @@ void CObject3D::SaveBakedAnimationTexture(const string& FileName)
 
 void CObject3D::LoadBakedAnimationTexture(const string& FileName)
 {
+	MarkSaveDirty();
 	if (FileName.empty()) return;
 
 	m_BakedAnimationTexture = make_unique<CTexture>(m_PtrDevice, m_PtrDeviceContext);
@@ -1333,9 +1875,20 @@ void CObject3D::LoadBakedAnimationTexture(const string& FileName)
 	D3D11_MAPPED_SUBRESOURCE MappedSubresource{};
 	if (SUCCEEDED(m_PtrDeviceContext->Map(ReadableAnimationTexture.Get(), 0, D3D11_MAP_READ, 0, &MappedSubresource)))
 	{
+		bool bIsHalfFloat{ AnimationTextureDesc.Format == DXGI_FORMAT_R16G16B16A16_FLOAT };
+		const size_t KTextureWidth{ AnimationTextureDesc.Width }; // @important: depends on the bone count of the rig
+
 		vector<SPixel128Float> vPixels{};
-		vPixels.resize(KAnimationTextureWidth);
-		memcpy(&vPixels[0], MappedSubresource.pData, sizeof(SPixel128Float) * KAnimationTextureWidth);
+		vPixels.resize(KTextureWidth);
+		if (bIsHalfFloat)
+		{
+			PackedVector::XMConvertHalfToFloatStream(&vPixels[0].R, sizeof(float), 
+				(const PackedVector::HALF*)MappedSubresource.pData, sizeof(uint16_t), KTextureWidth * 4);
+		}
+		else
+		{
+			memcpy(&vPixels[0], MappedSubresource.pData, sizeof(SPixel128Float) * KTextureWidth);
+		}
 
 		// Animation count
 		m_Model->vAnimations.clear();
@@ -1343,19 +1896,29 @@ void CObject3D::LoadBakedAnimationTexture(const string& FileName)
 
 		for (int32_t iAnimation = 0; iAnimation < (int32_t)m_Model->vAnimations.size(); ++iAnimation)
 		{
-			m_Model->vAnimations[iAnimation].Duration = vPixels[(int64_t)KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 0].G;
-			m_Model->vAnimations[iAnimation].TicksPerSecond = vPixels[(int64_t)KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 0].B;
+			m_Model->vAnimations[iAnimation].Duration = vPixels[(int64_t)CPoseEvaluator::KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 0].G;
+			m_Model->vAnimations[iAnimation].TicksPerSecond = vPixels[(int64_t)CPoseEvaluator::KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 0].B;
 
-			float NameR{ vPixels[(int64_t)KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 1].R };
-			float NameG{ vPixels[(int64_t)KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 1].G };
-			float NameB{ vPixels[(int64_t)KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 1].B };
-			float NameA{ vPixels[(int64_t)KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 1].A };
+			float NameR{ vPixels[(int64_t)CPoseEvaluator::KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 1].R };
+			float NameG{ vPixels[(int64_t)CPoseEvaluator::KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 1].G };
+			float NameB{ vPixels[(int64_t)CPoseEvaluator::KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 1].B };
+			float NameA{ vPixels[(int64_t)CPoseEvaluator::KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 1].A };
 
 			char Name[16]{};
-			memcpy(&Name[0], &NameR, 4);
-			memcpy(&Name[4], &NameG, 4);
-			memcpy(&Name[8], &NameB, 4);
-			memcpy(&Name[12], &NameA, 4);
+			if (bIsHalfFloat)
+			{
+				// Names are stored in the extra reserved row (2 pixels per name)
+				const uint8_t* const PtrNameRow{ (const uint8_t*)MappedSubresource.pData + MappedSubresource.RowPitch };
+				memcpy(&Name[0], PtrNameRow + (size_t)iAnimation * 2 * sizeof(SPixel64Float), sizeof(Name));
+				Name[15] = 0;
+			}
+			else
+			{
+				memcpy(&Name[0], &NameR, 4);
+				memcpy(&Name[4], &NameG, 4);
+				memcpy(&Name[8], &NameB, 4);
+				memcpy(&Name[12], &NameA, 4);
+			}
 
 			m_Model->vAnimations[iAnimation].Name = Name;
 		}
@@ -1372,6 +1935,7 @@ void CObject3D::LoadBakedAnimationTexture(const string& FileName)
 
 void CObject3D::AddMaterial(const CMaterialData& MaterialData)
 {
+	MarkSaveDirty();
 	m_Model->vMaterialData.emplace_back(MaterialData);
 	m_Model->vMaterialData.back().Index(m_Model->vMaterialData.size() - 1);
 
@@ -1380,6 +1944,7 @@ void CObject3D::AddMaterial(const CMaterialData& MaterialData)
 
 void CObject3D::SetMaterial(size_t Index, const CMaterialData& MaterialData)
 {
+	MarkSaveDirty();
 	assert(Index < m_Model->vMaterialData.size());
 
 	m_Model->vMaterialData[Index] = MaterialData;
@@ -1395,6 +1960,7 @@ size_t CObject3D::GetMaterialCount() const
 
 void CObject3D::ShouldIgnoreSceneMaterial(bool bShouldIgnore)
 {
+	MarkSaveDirty();
 	if (m_Model) m_Model->bIgnoreSceneMaterial = bShouldIgnore;
 }
 
@@ -1403,8 +1969,30 @@ bool CObject3D::ShouldIgnoreSceneMaterial() const
 	return m_Model->bIgnoreSceneMaterial;
 }
 
+void CObject3D::MarkSaveDirty()
+{
+	m_bIsSaveDirty = true;
+}
+
+bool CObject3D::IsSaveDirty() const
+{
+	return m_bIsSaveDirty;
+}
+
+void CObject3D::ClearSaveDirty(uint64_t SavedChunkHash)
+{
+	m_bIsSaveDirty = false;
+	m_SavedChunkHash = SavedChunkHash;
+}
+
+uint64_t CObject3D::GetSavedChunkHash() const
+{
+	return m_SavedChunkHash;
+}
+
 void CObject3D::CreateInstances(const std::vector<SObject3DInstanceCPUData>& vInstanceCPUData, const std::vector<SObject3DInstanceGPUData>& vInstanceGPUData)
 {
+	MarkSaveDirty();
 	if (vInstanceCPUData.empty()) return;
 	if (vInstanceGPUData.empty())
 	{
@@ -1428,18 +2016,20 @@ void CObject3D::CreateInstances(const std::vector<SObject3DInstanceCPUData>& vIn
 		m_mapInstanceNameToIndex[InstanceCPUData.Name] = iInstance;
 	}
 
-	CreateInstanceBuffers();
+	CreateInstanceBuffer(m_vInstanceGPUData.size());
 
 	UpdateAllInstances();
 }
 
 void CObject3D::CreateInstances(const std::vector<SObject3DInstanceCPUData>& vInstanceCPUData)
 {
+	MarkSaveDirty();
 	CreateInstances(vInstanceCPUData, m_vInstanceGPUData);
 }
 
 void CObject3D::CreateInstances(size_t InstanceCount)
 {
+	MarkSaveDirty();
 	if (InstanceCount <= 0) return;
 	if (InstanceCount >= 100'000) return; // TOO MANY INSTANCES
 
@@ -1456,6 +2046,7 @@ void CObject3D::CreateInstances(size_t InstanceCount)
 
 bool CObject3D::InsertInstance()
 {
+	MarkSaveDirty();
 	size_t InstanceCount{ GetInstanceCount() };
 	string AutoGeneratedName{ "inst" + to_string(InstanceCount) };
 
@@ -1480,14 +2071,13 @@ bool CObject3D::InsertInstance()
 
 bool CObject3D::InsertInstance(const string& InstanceName)
 {
+	MarkSaveDirty();
 	if (m_mapInstanceNameToIndex.find(InstanceName) != m_mapInstanceNameToIndex.end())
 	{
 		MB_WARN(("ش ̸(" + InstanceName + ") νϽ ̹ մϴ.").c_str(), "νϽ  ");
 		return false;
 	}
 
-	bool bShouldRecreateInstanceBuffer{ m_vInstanceCPUData.size() == m_vInstanceCPUData.capacity() };
-
 	std::string LimitedName{ InstanceName };
 	if (LimitedName.length() >= SObject3DInstanceCPUData::KMaxNameLengthZeroTerminated)
 	{
@@ -1509,8 +2099,11 @@ bool CObject3D::InsertInstance(const string& InstanceName)
 
 	m_vInstanceGPUData.emplace_back();
 
-	if (m_vInstanceCPUData.size() == 1) CreateInstanceBuffers();
-	if (bShouldRecreateInstanceBuffer) CreateInstanceBuffers();
+	// @important: grows geometrically, so that inserting many instances one by one recreates the buffer only a few times
+	if (m_vInstanceGPUData.size() > m_InstanceBufferCapacity)
+	{
+		CreateInstanceBuffer(max(m_InstanceBufferCapacity * 2, m_vInstanceGPUData.size()));
+	}
 
 	UpdateInstanceWorldMatrix(LimitedName);
 
@@ -1519,6 +2112,7 @@ bool CObject3D::InsertInstance(const string& InstanceName)
 
 void CObject3D::DeleteInstance(const string& InstanceName)
 {
+	MarkSaveDirty();
 	if (m_vInstanceCPUData.empty()) return;
 
 	if (InstanceName.empty())
@@ -1560,12 +2154,13 @@ void CObject3D::DeleteInstance(const string& InstanceName)
 		m_mapInstanceNameToIndex.erase(SavedName);
 		m_mapInstanceNameToIndex[LastInstanceName] = iInstance;
 
-		UpdateInstanceBuffers();
+		MarkInstancesDirty(iInstance);
 	}
 }
 
 void CObject3D::ClearInstances()
 {
+	MarkSaveDirty();
 	m_vInstanceCPUData.clear();
 	m_vInstanceGPUData.clear();
 	m_mapInstanceNameToIndex.clear();
@@ -1573,6 +2168,7 @@ void CObject3D::ClearInstances()
 
 bool CObject3D::ChangeInstanceName(const std::string& OldName, const std::string& NewName)
 {
+	MarkSaveDirty();
 	if (m_mapInstanceNameToIndex.find(OldName) == m_mapInstanceNameToIndex.end())
 	{
 		MB_WARN((" ̸ (" + OldName + ") νϽ  ʽϴ.").c_str(), "̸  ");
@@ -1595,71 +2191,85 @@ bool CObject3D::ChangeInstanceName(const std::string& OldName, const std::string
 
 void CObject3D::TranslateInstanceTo(const std::string& InstanceName, const XMVECTOR& Prime)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Transform.Translation = Prime;
 }
 
 void CObject3D::RotateInstancePitchTo(const std::string& InstanceName, float Prime)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Transform.Pitch = Prime;
 }
 
 void CObject3D::RotateInstanceYawTo(const std::string& InstanceName, float Prime)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Transform.Yaw = Prime;
 }
 
 void CObject3D::RotateInstanceRollTo(const std::string& InstanceName, float Prime)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Transform.Roll = Prime;
 }
 
 void CObject3D::ScaleInstanceTo(const std::string& InstanceName, const XMVECTOR& Prime)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Transform.Scaling = Prime;
 }
 
 void CObject3D::TranslateInstance(const std::string& InstanceName, const XMVECTOR& Delta)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Transform.Translation += Delta;
 }
 
 void CObject3D::RotateInstancePitch(const std::string& InstanceName, float Delta)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Transform.Pitch += Delta;
 }
 
 void CObject3D::RotateInstanceYaw(const std::string& InstanceName, float Delta)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Transform.Yaw += Delta;
 }
 
 void CObject3D::RotateInstanceRoll(const std::string& InstanceName, float Delta)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Transform.Roll += Delta;
 }
 
 void CObject3D::ScaleInstance(const std::string& InstanceName, const XMVECTOR& Delta)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Transform.Scaling += Delta;
 }
 
 void CObject3D::SetInstanceLinearAcceleration(const std::string& InstanceName, const XMVECTOR& Prime)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Physics.LinearAcceleration = Prime;
 }
 
 void CObject3D::SetInstanceLinearVelocity(const std::string& InstanceName, const XMVECTOR& Prime)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Physics.LinearVelocity = Prime;
 }
 
 void CObject3D::AddInstanceLinearAcceleration(const std::string& InstanceName, const XMVECTOR& Delta)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Physics.LinearAcceleration += Delta;
 }
 
 void CObject3D::AddInstanceLinearVelocity(const std::string& InstanceName, const XMVECTOR& Delta)
 {
+	MarkSaveDirty();
 	GetInstanceCPUData(InstanceName).Physics.LinearVelocity += Delta;
 }
 
@@ -1685,6 +2295,7 @@ SObject3DInstanceCPUData& CObject3D::GetInstanceCPUData(const string& InstanceNa
 
 void CObject3D::SetInstanceCPUData(const std::string& InstanceName, const SObject3DInstanceCPUData& Prime)
 {
+	MarkSaveDirty();
 	string SavedName{ InstanceName };
 	auto& InstanceCPUData{ GetInstanceCPUData(InstanceName) };
 	InstanceCPUData = Prime;
@@ -1727,58 +2338,225 @@ const std::string& CObject3D::GetLastInstanceName() const
 	return m_vInstanceCPUData.back().Name;
 }
 
-void CObject3D::_CreateInstanceBuffer(size_t MeshIndex)
+void CObject3D::CreateInstanceBuffer(size_t InstanceCapacity)
 {
+	if (m_vInstanceGPUData.empty()) return;
+
+	m_InstanceBufferCapacity = max(InstanceCapacity, m_vInstanceGPUData.size());
+
 	D3D11_BUFFER_DESC BufferDesc{};
 	BufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	BufferDesc.ByteWidth = static_cast<UINT>(sizeof(SObject3DInstanceGPUData) * m_vInstanceGPUData.capacity()); // @important
-	BufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	BufferDesc.ByteWidth = static_cast<UINT>(sizeof(SObject3DInstanceGPUData) * m_InstanceBufferCapacity);
+	BufferDesc.CPUAccessFlags = 0;
 	BufferDesc.MiscFlags = 0;
 	BufferDesc.StructureByteStride = 0;
-	BufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	BufferDesc.Usage = D3D11_USAGE_DEFAULT; // @important: updated by ranges (UpdateSubresource), not rewritten as a whole
+
+	m_InstanceBuffer.Buffer.Reset();
+	m_PtrDevice->CreateBuffer(&BufferDesc, nullptr, m_InstanceBuffer.Buffer.GetAddressOf());
 
-	D3D11_SUBRESOURCE_DATA SubresourceData{};
-	SubresourceData.pSysMem = &m_vInstanceGPUData[0];
-	m_PtrDevice->CreateBuffer(&BufferDesc, &SubresourceData, &m_vInstanceBuffers[MeshIndex].Buffer);
+	// The new buffer has no content yet
+	MarkAllInstancesDirty();
 }
 
-void CObject3D::CreateInstanceBuffers()
+void CObject3D::MarkInstancesDirty(size_t FirstInstanceIndex, size_t InstanceCount)
 {
-	if (m_vInstanceCPUData.empty()) return;
+	m_InstanceDirtyRanges.MarkDirty((uint32_t)FirstInstanceIndex, (uint32_t)InstanceCount);
+}
 
-	m_vInstanceBuffers.clear();
-	m_vInstanceBuffers.resize(m_Model->vMeshes.size());
-	for (size_t iMesh = 0; iMesh < m_Model->vMeshes.size(); ++iMesh)
+void CObject3D::MarkAllInstancesDirty()
+{
+	m_InstanceDirtyRanges.Clear();
+	m_InstanceDirtyRanges.MarkDirty(0, (uint32_t)m_vInstanceGPUData.size());
+}
+
+size_t CObject3D::FlushInstanceBuffer() const
+{
+	if (!m_InstanceDirtyRanges.IsDirty()) return 0;
+	if (!m_InstanceBuffer.Buffer || m_vInstanceGPUData.empty())
 	{
-		_CreateInstanceBuffer(iMesh);
+		m_InstanceDirtyRanges.Clear();
+		return 0;
 	}
+
+	const uint32_t KInstanceCount{ (uint32_t)m_vInstanceGPUData.size() };
+	size_t UploadedByteCount{};
+	for (const auto& Range : m_InstanceDirtyRanges.Coalesce(KInstanceUploadMergeGap))
+	{
+		// @important: ranges can point past the end after instances are deleted
+		if (Range.First >= KInstanceCount) break;
+		uint32_t Count{ min(Range.Count, KInstanceCount - Range.First) };
+
+		D3D11_BOX Box{};
+		Box.left = static_cast<UINT>(sizeof(SObject3DInstanceGPUData) * Range.First);
+		Box.right = static_cast<UINT>(sizeof(SObject3DInstanceGPUData) * (Range.First + Count));
+		Box.top = 0;
+		Box.bottom = 1;
+		Box.front = 0;
+		Box.back = 1;
+
+		m_PtrDeviceContext->UpdateSubresource(m_InstanceBuffer.Buffer.Get(), 0, &Box, &m_vInstanceGPUData[Range.First], 0, 0);
+
+		UploadedByteCount += Box.right - Box.left;
+	}
+	m_InstanceDirtyRanges.Clear();
+
+	return UploadedByteCount;
 }
 
-void CObject3D::_UpdateInstanceBuffer(size_t MeshIndex)
+void CObject3D::UpdateVisibleInstanceBuffer()
 {
-	if (m_vInstanceGPUData.empty()) return;
-	if (m_vInstanceBuffers.empty()) return;
-	if (!m_vInstanceBuffers[MeshIndex].Buffer) return;
+	if (m_vVisibleInstanceIndices.empty()) return;
+
+	m_vVisibleInstanceGPUData.resize(m_vVisibleInstanceIndices.size());
+	for (size_t iVisibleInstance = 0; iVisibleInstance < m_vVisibleInstanceIndices.size(); ++iVisibleInstance)
+	{
+		m_vVisibleInstanceGPUData[iVisibleInstance] = m_vInstanceGPUData[m_vVisibleInstanceIndices[iVisibleInstance]];
+	}
+
+	// @important: sized like the full instance buffer, so that it's recreated only when instances are added
+	if (!m_VisibleInstanceBuffer.Buffer || m_VisibleInstanceBufferCapacity < m_vVisibleInstanceGPUData.size())
+	{
+		m_VisibleInstanceBufferCapacity = max(m_vInstanceGPUData.capacity(), m_vVisibleInstanceGPUData.size());
+
+		D3D11_BUFFER_DESC BufferDesc{};
+		BufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		BufferDesc.ByteWidth = static_cast<UINT>(sizeof(SObject3DInstanceGPUData) * m_VisibleInstanceBufferCapacity);
+		BufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		BufferDesc.MiscFlags = 0;
+		BufferDesc.StructureByteStride = 0;
+		BufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+
+		m_VisibleInstanceBuffer.Buffer.Reset();
+		m_PtrDevice->CreateBuffer(&BufferDesc, nullptr, m_VisibleInstanceBuffer.Buffer.GetAddressOf());
+	}
 
 	D3D11_MAPPED_SUBRESOURCE MappedSubresource{};
-	if (SUCCEEDED(m_PtrDeviceContext->Map(m_vInstanceBuffers[MeshIndex].Buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedSubresource)))
+	if (SUCCEEDED(m_PtrDeviceContext->Map(m_VisibleInstanceBuffer.Buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedSubresource)))
 	{
-		memcpy(MappedSubresource.pData, &m_vInstanceGPUData[0], sizeof(SObject3DInstanceGPUData) * m_vInstanceGPUData.size());
+		memcpy(MappedSubresource.pData, &m_vVisibleInstanceGPUData[0], sizeof(SObject3DInstanceGPUData) * m_vVisibleInstanceGPUData.size());
 
-		m_PtrDeviceContext->Unmap(m_vInstanceBuffers[MeshIndex].Buffer.Get(), 0);
+		m_PtrDeviceContext->Unmap(m_VisibleInstanceBuffer.Buffer.Get(), 0);
 	}
 }
 
-void CObject3D::UpdateInstanceBuffers()
+size_t CObject3D::CullInstances(const CFrustumCuller& FrustumCuller, const COcclusionCuller* const OcclusionCuller)
 {
-	for (size_t iMesh = 0; iMesh < m_Model->vMeshes.size(); ++iMesh)
+	const uint32_t KInstanceCount{ (uint32_t)m_vInstanceCPUData.size() };
+
+	m_vInstanceBoundingSpheres.resize(KInstanceCount);
+	for (uint32_t iInstance = 0; iInstance < KInstanceCount; ++iInstance)
+	{
+		const SObject3DInstanceCPUData& InstanceCPUData{ m_vInstanceCPUData[iInstance] };
+		XMStoreFloat4(&m_vInstanceBoundingSpheres[iInstance], XMVectorSetW(
+			InstanceCPUData.Transform.Translation + InstanceCPUData.EditorBoundingSphere.Center, InstanceCPUData.EditorBoundingSphere.Data.BS.Radius));
+	}
+
+	m_vVisibleInstanceIndices.clear();
+	if (KInstanceCount) FrustumCuller.Cull(&m_vInstanceBoundingSpheres[0], KInstanceCount, m_vVisibleInstanceIndices);
+
+	if (OcclusionCuller)
+	{
+		// @important: compacted in place, so that the visible instances stay in order
+		size_t VisibleCount{};
+		for (uint32_t iInstance : m_vVisibleInstanceIndices)
+		{
+			if (OcclusionCuller->IsVisible(m_vInstanceBoundingSpheres[iInstance])) m_vVisibleInstanceIndices[VisibleCount++] = iInstance;
+		}
+		m_vVisibleInstanceIndices.resize(VisibleCount);
+	}
+
+	UpdateVisibleInstanceBuffer();
+
+	return m_vVisibleInstanceIndices.size();
+}
+
+void CObject3D::CreateOccluderMesh()
+{
+	m_OccluderMesh.reset();
+
+	size_t TriangleCount{};
+	for (const SMesh& Mesh : m_Model->vMeshes)
+	{
+		TriangleCount += Mesh.vTriangles.size();
+	}
+
+	// @important: only simple models (walls, pillars, floors...) are used as they are, detailed ones need an authored occluder
+	if (TriangleCount == 0 || TriangleCount > KMaxOccluderTriangleCount) return;
+
+	m_OccluderMesh = make_unique<SOccluderMesh>();
+	for (const SMesh& Mesh : m_Model->vMeshes)
+	{
+		const uint32_t KBaseIndex{ (uint32_t)m_OccluderMesh->vPositions.size() };
+		for (const SVertex3D& Vertex : Mesh.vVertices)
+		{
+			XMFLOAT3 Position{};
+			XMStoreFloat3(&Position, Vertex.Position);
+			m_OccluderMesh->vPositions.emplace_back(Position);
+		}
+		for (const STriangle& Triangle : Mesh.vTriangles)
+		{
+			m_OccluderMesh->vIndices.emplace_back(KBaseIndex + Triangle.I0);
+			m_OccluderMesh->vIndices.emplace_back(KBaseIndex + Triangle.I1);
+			m_OccluderMesh->vIndices.emplace_back(KBaseIndex + Triangle.I2);
+		}
+	}
+}
+
+void CObject3D::SetOccluderMesh(const SOccluderMesh& OccluderMesh)
+{
+	m_OccluderMesh = make_unique<SOccluderMesh>(OccluderMesh);
+}
+
+const SOccluderMesh* CObject3D::GetOccluderMesh() const
+{
+	if (!m_bIsOccluder || !m_OccluderMesh) return nullptr;
+	if (IsRigged() || IsTransparent() || ShouldTessellate()) return nullptr;
+	return m_OccluderMesh.get();
+}
+
+void CObject3D::AddOccluders(COcclusionCuller& OcclusionCuller, const CFrustumCuller& FrustumCuller) const
+{
+	const SOccluderMesh* const PtrOccluderMesh{ GetOccluderMesh() };
+	if (!PtrOccluderMesh) return;
+
+	if (IsInstanced())
 	{
-		_UpdateInstanceBuffer(iMesh);
+		for (size_t iInstance = 0; iInstance < m_vInstanceCPUData.size(); ++iInstance)
+		{
+			const SObject3DInstanceCPUData& InstanceCPUData{ m_vInstanceCPUData[iInstance] };
+			XMFLOAT4 BoundingSphere{};
+			XMStoreFloat4(&BoundingSphere, XMVectorSetW(
+				InstanceCPUData.Transform.Translation + InstanceCPUData.EditorBoundingSphere.Center, InstanceCPUData.EditorBoundingSphere.Data.BS.Radius));
+			if (!FrustumCuller.IsVisible(BoundingSphere)) continue;
+
+			OcclusionCuller.AddOccluder(PtrOccluderMesh, m_vInstanceGPUData[iInstance].WorldMatrix, BoundingSphere);
+		}
+	}
+	else
+	{
+		XMFLOAT4 BoundingSphere{};
+		XMStoreFloat4(&BoundingSphere, XMVectorSetW(
+			m_ComponentTransform.Translation + m_OuterBoundingSphere.Center, m_OuterBoundingSphere.Data.BS.Radius));
+		if (!FrustumCuller.IsVisible(BoundingSphere)) return;
+
+		OcclusionCuller.AddOccluder(PtrOccluderMesh, m_WorldMatrix, BoundingSphere);
 	}
 }
 
+size_t CObject3D::GetVisibleInstanceCount() const
+{
+	return m_vVisibleInstanceIndices.size();
+}
+
+const std::vector<XMFLOAT4>& CObject3D::GetInstanceBoundingSpheres() const
+{
+	return m_vInstanceBoundingSpheres;
+}
+
 void CObject3D::UpdateQuadUV(const XMFLOAT2& UVOffset, const XMFLOAT2& UVSize)
 {
+	MarkSaveDirty();
 	float U0{ UVOffset.x };
 	float V0{ UVOffset.y };
 	float U1{ U0 + UVSize.x };
@@ -1794,6 +2572,7 @@ void CObject3D::UpdateQuadUV(const XMFLOAT2& UVOffset, const XMFLOAT2& UVSize)
 
 void CObject3D::UpdateMeshBuffer(size_t MeshIndex)
 {
+	MarkSaveDirty();
 	D3D11_MAPPED_SUBRESOURCE MappedSubresource{};
 	if (SUCCEEDED(m_PtrDeviceContext->Map(m_vMeshBuffers[MeshIndex].VertexBuffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &MappedSubresource)))
 	{
@@ -1875,7 +2654,7 @@ void CObject3D::UpdateInstanceWorldMatrix(const std::string& InstanceName, bool
 	// Update GPU data
 	InstanceGPUData.WorldMatrix = Scaling * BoundingSphereTranslationOpposite * Rotation * Translation * BoundingSphereTranslation;
 
-	if (bUpdateInstanceBuffer) UpdateInstanceBuffers();
+	if (bUpdateInstanceBuffer) MarkInstancesDirty(GetInstanceIndex(InstanceName));
 }
 
 void CObject3D::UpdateInstanceWorldMatrix(const std::string& InstanceName, const XMMATRIX& WorldMatrix)
@@ -1884,7 +2663,7 @@ void CObject3D::UpdateInstanceWorldMatrix(const std::string& InstanceName, const
 
 	GetInstanceGPUData(InstanceName).WorldMatrix = WorldMatrix;
 
-	UpdateInstanceBuffers();
+	MarkInstancesDirty(GetInstanceIndex(InstanceName));
 }
 
 void CObject3D::UpdateAllInstances(bool bUpdateWorldMatrix)
@@ -1896,12 +2675,14 @@ void CObject3D::UpdateAllInstances(bool bUpdateWorldMatrix)
 			UpdateInstanceWorldMatrix(InstanceCPUData.Name, false);
 		}
 	}
-	UpdateInstanceBuffers();
+	MarkAllInstancesDirty();
 }
 
 void CObject3D::SetInstanceHighlight(const std::string& InstanceName, bool bShouldHighlight)
 {
 	GetInstanceGPUData(InstanceName).IsHighlighted = (bShouldHighlight) ? 1.0f : 0.0f;
+
+	MarkInstancesDirty(GetInstanceIndex(InstanceName));
 }
 
 void CObject3D::SetAllInstancesHighlightOff()
@@ -1911,18 +2692,20 @@ void CObject3D::SetAllInstancesHighlightOff()
 		InstanceGPUData.IsHighlighted = 0.0f;
 	}
 
-	UpdateInstanceBuffers();
+	MarkAllInstancesDirty();
 }
 
-void CObject3D::UpdateCBMaterial(const CMaterialData& MaterialData, uint32_t TotalMaterialCount) const
+CObject3D::SCBMaterialData CObject3D::MakeCBMaterialData(const CMaterialData& MaterialData, uint32_t TotalMaterialCount) const
 {
-	//m_CBMaterialData.AmbientColor = MaterialData.AmbientColor();
-	m_CBMaterialData.DiffuseColor = MaterialData.DiffuseColor();
-	//m_CBMaterialData.SpecularColor = MaterialData.SpecularColor();
-	//m_CBMaterialData.SpecularExponent = MaterialData.SpecularExponent();
-	//m_CBMaterialData.SpecularIntensity = MaterialData.SpecularIntensity();
-	m_CBMaterialData.Roughness = MaterialData.Roughness();
-	m_CBMaterialData.Metalness = MaterialData.Metalness();
+	SCBMaterialData CBMaterialData{};
+
+	//CBMaterialData.AmbientColor = MaterialData.AmbientColor();
+	CBMaterialData.DiffuseColor = MaterialData.DiffuseColor();
+	//CBMaterialData.SpecularColor = MaterialData.SpecularColor();
+	//CBMaterialData.SpecularExponent = MaterialData.SpecularExponent();
+	//CBMaterialData.SpecularIntensity = MaterialData.SpecularIntensity();
+	CBMaterialData.Roughness = MaterialData.Roughness();
+	CBMaterialData.Metalness = MaterialData.Metalness();
 
 	uint32_t FlagsHasTexture{};
 	FlagsHasTexture += MaterialData.HasTexture(ETextureType::DiffuseTexture) ? 0x01 : 0;
@@ -1934,7 +2717,7 @@ void CObject3D::UpdateCBMaterial(const CMaterialData& MaterialData, uint32_t Tot
 	FlagsHasTexture += MaterialData.HasTexture(ETextureType::AmbientOcclusionTexture) ? 0x40 : 0;
 	// @empty_slot: Displacement texture is usually not used in PS
 	FlagsHasTexture += m_Model->bIgnoreSceneMaterial ? 0x2000 : 0;
-	m_CBMaterialData.FlagsHasTexture = FlagsHasTexture;
+	CBMaterialData.FlagsHasTexture = FlagsHasTexture;
 
 	uint32_t FlagsIsTextureSRGB{};
 	FlagsIsTextureSRGB += MaterialData.IsTextureSRGB(ETextureType::DiffuseTexture) ? 0x01 : 0;
@@ -1945,9 +2728,16 @@ void CObject3D::UpdateCBMaterial(const CMaterialData& MaterialData, uint32_t Tot
 	FlagsIsTextureSRGB += MaterialData.IsTextureSRGB(ETextureType::MetalnessTexture) ? 0x20 : 0;
 	FlagsIsTextureSRGB += MaterialData.IsTextureSRGB(ETextureType::AmbientOcclusionTexture) ? 0x40 : 0;
 	// @empty_slot: Displacement texture is usually not used in PS
-	m_CBMaterialData.FlagsIsTextureSRGB = FlagsIsTextureSRGB;
+	CBMaterialData.FlagsIsTextureSRGB = FlagsIsTextureSRGB;
 
-	m_CBMaterialData.TotalMaterialCount = TotalMaterialCount;
+	CBMaterialData.TotalMaterialCount = TotalMaterialCount;
+
+	return CBMaterialData;
+}
+
+void CObject3D::UpdateCBMaterial(const CMaterialData& MaterialData, uint32_t TotalMaterialCount) const
+{
+	m_CBMaterialData = MakeCBMaterialData(MaterialData, TotalMaterialCount);
 
 	m_CBMaterial->Update();
 	m_CBMaterial->Use(EShaderType::PixelShader, 0); // @important
@@ -1963,6 +2753,16 @@ void CObject3D::ShouldTessellate(bool Value)
 	m_bShouldTesselate = Value;
 }
 
+bool CObject3D::ShouldPackVertices() const
+{
+	return m_Model->bUsePackedVertices;
+}
+
+void CObject3D::ShouldPackVertices(bool Value)
+{
+	if (m_Model) m_Model->bUsePackedVertices = Value;
+}
+
 void CObject3D::SetTessFactorData(const CObject3D::SCBTessFactorData& Data)
 {
 	m_CBTessFactorData = Data;
@@ -2005,9 +2805,20 @@ bool CObject3D::IsPickable() const
 
 void CObject3D::IsPickable(bool NewValue)
 {
+	MarkSaveDirty();
 	m_bIsPickable = NewValue;
 }
 
+bool CObject3D::IsOccluder() const
+{
+	return m_bIsOccluder;
+}
+
+void CObject3D::IsOccluder(bool NewValue)
+{
+	m_bIsOccluder = NewValue;
+}
+
 bool CObject3D::IsTransparent() const
 {
 	return m_ComponentRender.bIsTransparent;
@@ -2015,6 +2826,7 @@ bool CObject3D::IsTransparent() const
 
 void CObject3D::IsTransparent(bool NewValue)
 {
+	MarkSaveDirty();
 	m_ComponentRender.bIsTransparent = NewValue;
 }
 
@@ -2040,6 +2852,7 @@ SMESHData& CObject3D::GetModel()
 
 void CObject3D::SetName(const std::string& Name)
 {
+	MarkSaveDirty();
 	m_Name = Name;
 }
 
@@ -2050,6 +2863,7 @@ const std::string& CObject3D::GetName() const
 
 void CObject3D::SetModelFileName(const std::string& FileName)
 {
+	MarkSaveDirty();
 	m_ModelFileName = FileName;
 }
 
@@ -2076,12 +2890,14 @@ CMaterialTextureSet* CObject3D::GetMaterialTextureSet(size_t iMaterial)
 
 void CObject3D::SetOuterBoundingSphereCenterOffset(const XMVECTOR& Center)
 {
+	MarkSaveDirty();
 	m_OuterBoundingSphere.Center = Center;
 	if (m_Model) m_Model->EditorBoundingSphereData.Center = m_OuterBoundingSphere.Center;
 }
 
 void CObject3D::SetOuterBoundingSphereRadiusBias(float Radius)
 {
+	MarkSaveDirty();
 	m_OuterBoundingSphere.Data.BS.RadiusBias = Radius;
 	if (m_Model) m_Model->EditorBoundingSphereData.Data.BS.RadiusBias = m_OuterBoundingSphere.Data.BS.RadiusBias;
 }
@@ -2121,43 +2937,62 @@ void CObject3D::Animate(float DeltaTime)
 		{
 			AnimateInstance(InstanceCPUData.Name, DeltaTime);
 		}
-		UpdateInstanceBuffers(); // @important
+		MarkAllInstancesDirty(); // @important
 	}
 	else
 	{
-		if ((m_eCurrentAnimationOption == EAnimationOption::PlayToFirstFrame || m_eCurrentAnimationOption == EAnimationOption::PlayToLastFrame) &&
-			m_CurrentAnimationPlayCount >= 1)
-		{
-			return;
-		}
+		m_AnimationLODStatistics = SAnimationLODStatistics();
 
-		const SMeshAnimation& CurrentAnimation{ m_Model->vAnimations[m_CurrentAnimationID] };
-		m_AnimationTick += CurrentAnimation.TicksPerSecond * DeltaTime;
-		if (m_AnimationTick > CurrentAnimation.Duration)
-		{
-			++m_CurrentAnimationPlayCount;
+		bool bIsFinished{ (m_eCurrentAnimationOption == EAnimationOption::PlayToFirstFrame ||
+			m_eCurrentAnimationOption == EAnimationOption::PlayToLastFrame) && m_CurrentAnimationPlayCount >= 1 };
+		if (bIsFinished && !IsBlendingAnimations()) return;
 
-			if (m_eCurrentAnimationOption == EAnimationOption::Repeat || m_eCurrentAnimationOption == EAnimationOption::PlayToFirstFrame)
+		if (!bIsFinished)
+		{
+			const SMeshAnimation& CurrentAnimation{ m_Model->vAnimations[m_CurrentAnimationID] };
+			m_AnimationTick += CurrentAnimation.TicksPerSecond * DeltaTime;
+			if (m_AnimationTick > CurrentAnimation.Duration)
 			{
-				m_AnimationTick = 0.0f;
+				++m_CurrentAnimationPlayCount;
+
+				if (m_eCurrentAnimationOption == EAnimationOption::Repeat || m_eCurrentAnimationOption == EAnimationOption::PlayToFirstFrame)
+				{
+					m_AnimationTick = 0.0f;
+				}
 			}
 		}
+
+		AdvanceAnimationBlending(DeltaTime);
 	}
 
 	m_CBAnimationData.bIsInstanced = IsInstanced();
 	m_CBAnimationData.AnimationID = m_CurrentAnimationID;
 	m_CBAnimationData.AnimationTick = m_AnimationTick;
-	if (m_BakedAnimationTexture)
+	
+	// @important: blended poses can't be read from the baked texture, so CPU skinning is used while blending
+	if (m_BakedAnimationTexture && (IsInstanced() || !IsBlendingAnimations()))
 	{
 		m_CBAnimationData.bUseGPUSkinning = TRUE;
 	}
 	else
 	{
 		m_CBAnimationData.bUseGPUSkinning = FALSE;
-		CalculateAnimatedBoneMatrices(m_Model->vAnimations[m_CurrentAnimationID], m_AnimationTick, m_Model->vTreeNodes[0], XMMatrixIdentity());
+		if (ShouldEvaluateObjectPose())
+		{
+			EvaluateObjectPose();
+		}
+		else
+		{
+			m_AnimationLODStatistics.SkippedBoneCount = m_PoseEvaluator.GetBoneCount();
+		}
 	}
 }
 
+void CObject3D::SetAnimationBoneMatrixOffset(uint32_t Offset)
+{
+	m_CBAnimationData.BoneMatrixOffset = Offset;
+}
+
 void CObject3D::AnimateInstance(const std::string& InstanceName, float DeltaTime)
 {
 	auto& InstanceCPUData{ GetInstanceCPUData(InstanceName) };
@@ -2182,161 +3017,238 @@ void CObject3D::AnimateInstance(const std::string& InstanceName, float DeltaTime
 	}
 }
 
-void CObject3D::CalculateAnimatedBoneMatrices(const SMeshAnimation& CurrentAnimation, float AnimationTick,
-	const SMeshTreeNode& Node, XMMATRIX ParentTransform)
+void CObject3D::AdvanceAnimationBlending(float DeltaTime)
 {
-	XMMATRIX MatrixTransformation{ Node.MatrixTransformation * ParentTransform };
+	if (m_CrossfadeTime > 0.0f)
+	{
+		const SMeshAnimation& CrossfadeAnimation{ m_Model->vAnimations[m_CrossfadeAnimationID] };
+		m_CrossfadeAnimationTick += CrossfadeAnimation.TicksPerSecond * DeltaTime;
+		if (m_CrossfadeAnimationTick > CrossfadeAnimation.Duration)
+		{
+			m_CrossfadeAnimationTick = (m_eCrossfadeAnimationOption == EAnimationOption::Repeat) ? 0.0f : CrossfadeAnimation.Duration;
+		}
+
+		m_CrossfadeElapsedTime += DeltaTime;
+		if (m_CrossfadeElapsedTime >= m_CrossfadeTime) m_CrossfadeTime = 0.0f;
+	}
 
-	if (Node.bIsBone)
+	if (m_bIsAnimationLayerActive)
 	{
-		if (CurrentAnimation.vNodeAnimations.size())
+		const SMeshAnimation& LayerAnimation{ m_Model->vAnimations[m_LayerAnimationID] };
+		m_LayerAnimationTick += LayerAnimation.TicksPerSecond * DeltaTime;
+		if (m_LayerAnimationTick > LayerAnimation.Duration)
 		{
-			if (CurrentAnimation.umapNodeAnimationNameToIndex.find(Node.Name) != CurrentAnimation.umapNodeAnimationNameToIndex.end())
+			if (m_eLayerAnimationOption == EAnimationOption::Repeat)
+			{
+				m_LayerAnimationTick = 0.0f;
+			}
+			else
 			{
-				size_t NodeAnimationIndex{ CurrentAnimation.umapNodeAnimationNameToIndex.at(Node.Name) };
+				// @important: a finished layer fades itself out
+				m_LayerAnimationTick = (m_eLayerAnimationOption == EAnimationOption::PlayToFirstFrame) ? 0.0f : LayerAnimation.Duration;
+				m_LayerTargetWeight = 0.0f;
+			}
+		}
 
-				const SMeshAnimation::SNodeAnimation& NodeAnimation{ CurrentAnimation.vNodeAnimations[NodeAnimationIndex] };
+		float WeightDelta{ (m_LayerBlendTime > 0.0f) ? DeltaTime / m_LayerBlendTime : 1.0f };
+		if (m_LayerWeight < m_LayerTargetWeight)
+		{
+			m_LayerWeight = min(m_LayerWeight + WeightDelta, m_LayerTargetWeight);
+		}
+		else
+		{
+			m_LayerWeight = max(m_LayerWeight - WeightDelta, m_LayerTargetWeight);
+		}
 
-				XMMATRIX MatrixPosition{ XMMatrixIdentity() };
-				XMMATRIX MatrixRotation{ XMMatrixIdentity() };
-				XMMATRIX MatrixScaling{ XMMatrixIdentity() };
+		if (m_LayerTargetWeight == 0.0f && m_LayerWeight <= 0.0f) m_bIsAnimationLayerActive = false;
+	}
+}
 
-				{
-					const vector<SMeshAnimation::SNodeAnimation::SKey>& vKeys{ NodeAnimation.vPositionKeys };
-					SMeshAnimation::SNodeAnimation::SKey KeyA{};
-					SMeshAnimation::SNodeAnimation::SKey KeyB{};
-					for (uint32_t iKey = 0; iKey < (uint32_t)vKeys.size(); ++iKey)
-					{
-						if (vKeys[iKey].Time <= AnimationTick)
-						{
-							KeyA = vKeys[iKey];
-							KeyB = vKeys[(iKey < (uint32_t)vKeys.size() - 1) ? iKey + 1 : 0];
-						}
-					}
-
-					MatrixPosition = XMMatrixTranslationFromVector(KeyA.Value);
-				}
+bool CObject3D::ShouldEvaluateObjectPose()
+{
+	if (!m_AnimationLODSettings.bUseAnimationLOD || !m_bIsObjectPoseValid) return true;
+	if (m_AnimationLODSettings.bShouldFreezeOffscreen && !m_bIsInViewFrustum) return false;
+	if (m_AnimationLODDistance > m_AnimationLODSettings.ReducedRateDistance && m_AnimationLODSettings.ReducedRateInterval > 1)
+	{
+		// @important: ticks keep advancing every frame, so the next evaluated pose lands on the right time
+		return (++m_AnimationLODFrameCounter % m_AnimationLODSettings.ReducedRateInterval == 0);
+	}
+	return true;
+}
 
-				{
-					const vector<SMeshAnimation::SNodeAnimation::SKey>& vKeys{ NodeAnimation.vRotationKeys };
-					SMeshAnimation::SNodeAnimation::SKey KeyA{};
-					SMeshAnimation::SNodeAnimation::SKey KeyB{};
-					for (uint32_t iKey = 0; iKey < (uint32_t)vKeys.size(); ++iKey)
-					{
-						if (vKeys[iKey].Time <= AnimationTick)
-						{
-							KeyA = vKeys[iKey];
-							KeyB = vKeys[(iKey < (uint32_t)vKeys.size() - 1) ? iKey + 1 : 0];
-						}
-					}
-
-					MatrixRotation = XMMatrixRotationQuaternion(KeyA.Value);
-				}
+void CObject3D::EvaluateObjectPose()
+{
+	if (m_Model->vTreeNodes.empty()) return;
 
-				{
-					const vector<SMeshAnimation::SNodeAnimation::SKey>& vKeys{ NodeAnimation.vScalingKeys };
-					SMeshAnimation::SNodeAnimation::SKey KeyA{};
-					SMeshAnimation::SNodeAnimation::SKey KeyB{};
-					for (uint32_t iKey = 0; iKey < (uint32_t)vKeys.size(); ++iKey)
-					{
-						if (vKeys[iKey].Time <= AnimationTick)
-						{
-							KeyA = vKeys[iKey];
-							KeyB = vKeys[(iKey < (uint32_t)vKeys.size() - 1) ? iKey + 1 : 0];
-						}
-					}
-
-					MatrixScaling = XMMatrixScalingFromVector(KeyA.Value);
-				}
+	// @important: skipped leaf bones need a valid previous pose to keep
+	bool bShouldSkipLeafBones{ m_AnimationLODSettings.bUseAnimationLOD && m_bIsObjectPoseValid &&
+		m_AnimationLODDistance > m_AnimationLODSettings.LeafBoneSkipDistance };
+	m_AnimationLODStatistics.SkippedBoneCount = (bShouldSkipLeafBones) ? m_PoseEvaluator.GetLeafBoneCount() : 0;
+	m_AnimationLODStatistics.EvaluatedBoneCount = m_BoneCount - m_AnimationLODStatistics.SkippedBoneCount;
 
-				MatrixTransformation = MatrixScaling * MatrixRotation * MatrixPosition * ParentTransform;
-			}
-		}
+	m_PoseEvaluator.SampleLocalPose(m_CurrentAnimationID, m_AnimationTick, m_vBasePose, bShouldSkipLeafBones);
 
-		// Transpose at the last moment!
-		m_AnimatedBoneMatrices[Node.BoneIndex] = XMMatrixTranspose(Node.MatrixBoneOffset * MatrixTransformation);
+	if (m_CrossfadeTime > 0.0f)
+	{
+		m_PoseEvaluator.SampleLocalPose(m_CrossfadeAnimationID, m_CrossfadeAnimationTick, m_vBlendPose, bShouldSkipLeafBones);
+		m_PoseEvaluator.BlendLocalPoses(m_vBasePose, m_vBlendPose, 1.0f - m_CrossfadeElapsedTime / m_CrossfadeTime, nullptr, bShouldSkipLeafBones);
 	}
 
-	if (Node.vChildNodeIndices.size())
+	if (m_bIsAnimationLayerActive && m_LayerWeight > 0.0f)
 	{
-		for (auto iChild : Node.vChildNodeIndices)
-		{
-			CalculateAnimatedBoneMatrices(CurrentAnimation, AnimationTick, m_Model->vTreeNodes[iChild], MatrixTransformation);
-		}
+		m_PoseEvaluator.SampleLocalPose(m_LayerAnimationID, m_LayerAnimationTick, m_vBlendPose, bShouldSkipLeafBones);
+		m_PoseEvaluator.BlendLocalPoses(m_vBasePose, m_vBlendPose, m_LayerWeight, &m_vLayerMaskWeights, bShouldSkipLeafBones);
 	}
+
+	m_PoseEvaluator.CalculateAnimatedBoneMatrices(m_vBasePose, m_vAnimatedBoneMatrices.data());
+
+	m_bIsObjectPoseValid = true;
 }
 
 void CObject3D::Draw(EFlagsObject3DRendering eFlagsRendering, size_t OneInstanceIndex) const
 {
 	bool bIgnoreOwnTexture{ EFLAG_HAS(eFlagsRendering, EFlagsObject3DRendering::IgnoreOwnTextures) };
 	bool bDrawOneInstance{ EFLAG_HAS(eFlagsRendering, EFlagsObject3DRendering::DrawOneInstance) };
+	bool bDrawVisibleInstances{ IsInstanced() && !bDrawOneInstance && EFLAG_HAS(eFlagsRendering, EFlagsObject3DRendering::DrawVisibleInstances) };
+	if (bDrawVisibleInstances && m_vVisibleInstanceIndices.empty()) return;
 
-	if (HasBakedAnimationTexture()) m_BakedAnimationTexture->Use();
+	UseBakedAnimationTexture();
 
-	for (size_t iMesh = 0; iMesh < m_Model->vMeshes.size(); ++iMesh)
+	if (ShouldTessellate())
+	{
+		m_PtrDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST);
+	}
+	else
 	{
-		const SMesh& Mesh{ m_Model->vMeshes[iMesh] };
-		const CMaterialData& MaterialData{ m_Model->vMaterialData[Mesh.MaterialID] };
+		m_PtrDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	}
 
+	for (size_t iMesh = 0; iMesh < m_Model->vMeshes.size(); ++iMesh)
+	{
 		// per mesh
-		UpdateCBMaterial(MaterialData, (uint32_t)m_Model->vMaterialData.size());
+		UseMeshMaterial(iMesh, bIgnoreOwnTexture);
+		DrawMesh(iMesh, eFlagsRendering, OneInstanceIndex);
+	}
+}
 
-		if (MaterialData.HasAnyTexture() && !bIgnoreOwnTexture)
+size_t CObject3D::GetMeshCount() const
+{
+	return m_Model->vMeshes.size();
+}
+
+uint32_t CObject3D::GetMeshMaterialID(size_t MeshIndex) const
+{
+	return (uint32_t)m_Model->vMeshes[MeshIndex].MaterialID;
+}
+
+void CObject3D::UseBakedAnimationTexture() const
+{
+	if (HasBakedAnimationTexture()) m_BakedAnimationTexture->Use();
+}
+
+void CObject3D::UseMeshMaterial(size_t MeshIndex, bool bIgnoreOwnTexture) const
+{
+	const SMesh& Mesh{ m_Model->vMeshes[MeshIndex] };
+	const CMaterialData& MaterialData{ m_Model->vMaterialData[Mesh.MaterialID] };
+
+	UpdateCBMaterial(MaterialData, (uint32_t)m_Model->vMaterialData.size());
+
+	if (MaterialData.HasAnyTexture() && !bIgnoreOwnTexture)
+	{
+		if (m_Model->bUseMultipleTexturesInSingleMesh) // This bool is for CTerrain
 		{
-			if (m_Model->bUseMultipleTexturesInSingleMesh) // This bool is for CTerrain
+			for (const CMaterialData& MaterialDatum : m_Model->vMaterialData)
 			{
-				for (const CMaterialData& MaterialDatum : m_Model->vMaterialData)
-				{
-					const CMaterialTextureSet* MaterialTextureSet{ m_vMaterialTextureSets[MaterialDatum.Index()].get() };
-					MaterialTextureSet->UseTextures();
-				}
-			}
-			else
-			{
-				const CMaterialTextureSet* MaterialTextureSet{ m_vMaterialTextureSets[Mesh.MaterialID].get() };
+				const CMaterialTextureSet* MaterialTextureSet{ m_vMaterialTextureSets[MaterialDatum.Index()].get() };
 				MaterialTextureSet->UseTextures();
 			}
 		}
-
-		if (ShouldTessellate())
-		{
-			m_PtrDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_3_CONTROL_POINT_PATCHLIST);
-		}
 		else
 		{
-			m_PtrDeviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+			const CMaterialTextureSet* MaterialTextureSet{ m_vMaterialTextureSets[Mesh.MaterialID].get() };
+			MaterialTextureSet->UseTextures();
 		}
+	}
+}
+
+bool CObject3D::GetMaterialStateHash(size_t MaterialIndex, uint64_t& OutHash) const
+{
+	if (MaterialIndex >= m_Model->vMaterialData.size()) return false;
+	if (m_Model->bUseMultipleTexturesInSingleMesh) return false;
+
+	const CMaterialData& MaterialData{ m_Model->vMaterialData[MaterialIndex] };
+
+	struct SMaterialState
+	{
+		SCBMaterialData	CBMaterialData{};
+		uint32_t		TextureHandles[KMaxTextureCountPerMaterial]{};
+	};
 
-		m_PtrDeviceContext->IASetIndexBuffer(m_vMeshBuffers[iMesh].IndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+	SMaterialState MaterialState{};
+	MaterialState.CBMaterialData = MakeCBMaterialData(MaterialData, (uint32_t)m_Model->vMaterialData.size());
+	for (auto& TextureHandle : MaterialState.TextureHandles) TextureHandle = CTextureRegistry::KInvalidHandle;
 
-		m_PtrDeviceContext->IASetVertexBuffers(0, 1, m_vMeshBuffers[iMesh].VertexBuffer.GetAddressOf(),
-			&m_vMeshBuffers[iMesh].VertexBufferStride, &m_vMeshBuffers[iMesh].VertexBufferOffset);
+	// @important: textures are set only if the material has any (see UseMeshMaterial())
+	if (MaterialData.HasAnyTexture())
+	{
+		if (MaterialIndex >= m_vMaterialTextureSets.size() || !m_vMaterialTextureSets[MaterialIndex]) return false;
 
-		if (IsRigged())
+		const CMaterialTextureSet* const MaterialTextureSet{ m_vMaterialTextureSets[MaterialIndex].get() };
+		for (int iTexture = 0; iTexture < KMaxTextureCountPerMaterial; ++iTexture)
 		{
-			m_PtrDeviceContext->IASetVertexBuffers(1, 1, m_vMeshBuffers[iMesh].VertexBufferAnimation.GetAddressOf(),
-				&m_vMeshBuffers[iMesh].VertexBufferAnimationStride, &m_vMeshBuffers[iMesh].VertexBufferAnimationOffset);
+			const CTexture& Texture{ MaterialTextureSet->GetTexture((ETextureType)iTexture) };
+			if (!Texture.IsCreated()) continue;
+			if (!Texture.IsShared()) return false;
+
+			MaterialState.TextureHandles[iTexture] = Texture.GetRegistryHandle();
 		}
+	}
 
-		if (IsInstanced())
-		{
-			m_PtrDeviceContext->IASetVertexBuffers(2, 1, m_vInstanceBuffers[iMesh].Buffer.GetAddressOf(),
-				&m_vInstanceBuffers[iMesh].Stride, &m_vInstanceBuffers[iMesh].Offset);
+	OutHash = CStateCache::Hash(&MaterialState, sizeof(MaterialState));
+	return true;
+}
 
-			if (bDrawOneInstance)
-			{
-				m_PtrDeviceContext->DrawIndexedInstanced(static_cast<UINT>(Mesh.vTriangles.size() * 3),
-					1, 0, 0, static_cast<UINT>(OneInstanceIndex));
-			}
-			else
-			{
-				m_PtrDeviceContext->DrawIndexedInstanced(static_cast<UINT>(Mesh.vTriangles.size() * 3),
-					static_cast<UINT>(m_vInstanceCPUData.size()), 0, 0, 0);
-			}
+void CObject3D::DrawMesh(size_t MeshIndex, EFlagsObject3DRendering eFlagsRendering, size_t OneInstanceIndex) const
+{
+	bool bDrawOneInstance{ EFLAG_HAS(eFlagsRendering, EFlagsObject3DRendering::DrawOneInstance) };
+	bool bDrawVisibleInstances{ IsInstanced() && !bDrawOneInstance && EFLAG_HAS(eFlagsRendering, EFlagsObject3DRendering::DrawVisibleInstances) };
+	if (bDrawVisibleInstances && m_vVisibleInstanceIndices.empty()) return;
+
+	const SMeshBuffers& MeshBuffers{ m_vMeshBuffers[MeshIndex] };
+	const size_t KLOD{ min((size_t)m_CurrentMeshLOD, MeshBuffers.vLODIndexCounts.size() - 1) };
+	const UINT KIndexCount{ MeshBuffers.vLODIndexCounts[KLOD] };
+	const UINT KStartIndex{ MeshBuffers.vLODIndexOffsets[KLOD] };
+
+	m_PtrDeviceContext->IASetIndexBuffer(m_vMeshBuffers[MeshIndex].IndexBuffer.Get(), DXGI_FORMAT_R32_UINT, 0);
+
+	m_PtrDeviceContext->IASetVertexBuffers(0, 1, m_vMeshBuffers[MeshIndex].VertexBuffer.GetAddressOf(),
+		&m_vMeshBuffers[MeshIndex].VertexBufferStride, &m_vMeshBuffers[MeshIndex].VertexBufferOffset);
+
+	if (IsRigged())
+	{
+		m_PtrDeviceContext->IASetVertexBuffers(1, 1, m_vMeshBuffers[MeshIndex].VertexBufferAnimation.GetAddressOf(),
+			&m_vMeshBuffers[MeshIndex].VertexBufferAnimationStride, &m_vMeshBuffers[MeshIndex].VertexBufferAnimationOffset);
+	}
+
+	if (IsInstanced())
+	{
+		if (!bDrawVisibleInstances) FlushInstanceBuffer();
+
+		const SInstanceBuffer& InstanceBuffer{ (bDrawVisibleInstances) ? m_VisibleInstanceBuffer : m_InstanceBuffer };
+		m_PtrDeviceContext->IASetVertexBuffers(2, 1, InstanceBuffer.Buffer.GetAddressOf(), &InstanceBuffer.Stride, &InstanceBuffer.Offset);
+
+		if (bDrawOneInstance)
+		{
+			m_PtrDeviceContext->DrawIndexedInstanced(KIndexCount, 1, KStartIndex, 0, static_cast<UINT>(OneInstanceIndex));
 		}
 		else
 		{
-			m_PtrDeviceContext->DrawIndexed(static_cast<UINT>(Mesh.vTriangles.size() * 3), 0, 0);
+			m_PtrDeviceContext->DrawIndexedInstanced(KIndexCount,
+				static_cast<UINT>((bDrawVisibleInstances) ? m_vVisibleInstanceIndices.size() : m_vInstanceCPUData.size()), KStartIndex, 0, 0);
 		}
 	}
+	else
+	{
+		m_PtrDeviceContext->DrawIndexed(KIndexCount, KStartIndex, 0);
+	}
 }
@@ -2,9 +2,14 @@
 
 #include "../Core/SharedHeader.h"
 #include "ObjectTypes.h"
+#include "PoseEvaluator.h"
+#include "../Core/DirtyRangeTracker.h"
+#include "../Core/OcclusionCuller.h"
 
 class CAssimpLoader;
+class CBinaryData;
 class CConstantBuffer;
+class CFrustumCuller;
 class CMaterialData;
 class CMaterialTextureSet;
 class CShader;
@@ -19,12 +24,24 @@ enum class EFlagsObject3DRendering
 	None				= 0x00,
 	IgnoreOwnTextures	= 0x01,
 	DrawOneInstance		= 0x02,
-	UseVoidPS			= 0x04
+	UseVoidPS			= 0x04,
+	DrawVisibleInstances	= 0x08 // @important: draws the compacted list written by CullInstances()
 };
 ENUM_CLASS_FLAG(EFlagsObject3DRendering)
 
 class CObject3D
 {
+public:
+	// The beginning of an OB3D, up to where the model comes from
+	struct SOB3DHeader
+	{
+		uint32_t	Version{};
+		std::string	Name{};
+		const byte*	PtrMeshData{}; // the embedded MESH, read in place
+		size_t		MeshDataByteCount{};
+		std::string	ModelFileName{}; // when no MESH is embedded
+	};
+
 public:
 	static constexpr D3D11_INPUT_ELEMENT_DESC KInputElementDescs[]
 	{
@@ -90,6 +107,24 @@ public:
 		BOOL		bIsInstanced{};
 		uint32_t	AnimationID{};
 		float		AnimationTick{};
+		uint32_t	BoneMatrixOffset{}; // in the shared bone palette buffer (CPU skinning)
+		float		Pads[3]{};
+	};
+
+	// @important: only affects CPU pose evaluation (GPU-skinned objects sample the baked texture regardless)
+	struct SAnimationLODSettings
+	{
+		bool		bUseAnimationLOD{ false };
+		float		ReducedRateDistance{ 20.0f };	// beyond this distance, the pose is evaluated every ReducedRateInterval frames
+		uint32_t	ReducedRateInterval{ 3 };
+		float		LeafBoneSkipDistance{ 10.0f };	// beyond this distance, leaf bones (fingers, face, ...) keep their last pose
+		bool		bShouldFreezeOffscreen{ true };
+	};
+
+	struct SAnimationLODStatistics
+	{
+		uint32_t	EvaluatedBoneCount{};
+		uint32_t	SkippedBoneCount{};
 	};
 
 private:
@@ -104,6 +139,8 @@ private:
 		UINT					VertexBufferAnimationOffset{};
 
 		ComPtr<ID3D11Buffer>	IndexBuffer{};
+		std::vector<UINT>		vLODIndexOffsets{}; // [LOD], LOD 0 first and then SMesh::vLODTriangles in the same buffer
+		std::vector<UINT>		vLODIndexCounts{}; // [LOD]
 	};
 
 	struct SInstanceBuffer
@@ -131,9 +168,11 @@ public:
 // Object creation
 public:
 	void Create(const SMESHData& MESHData);
+	void Create(SMESHData&& MESHData);
 	void Create(const SMesh& Mesh, const CMaterialData& MaterialData);
 	void Create(const SMesh& Mesh);
-	void CreateFromFile(const std::string& FileName, bool bIsModelRigged);
+	// PtrDecodedModel (optional): the MESH file already decoded (e.g. on a worker thread), which is moved from
+	void CreateFromFile(const std::string& FileName, bool bIsModelRigged, SMESHData* const PtrDecodedModel = nullptr);
 
 // Object creation (internal)
 private:
@@ -144,19 +183,41 @@ private:
 	void __CreateMaterialTexture(size_t Index);
 	void _CreateConstantBuffers();
 	void _InitializeAnimationData();
+	void __InitializePoseEvaluationData();
 	void CalculateEditorBoundingSphereData();
 
 // Import & export
 public:
 	void LoadOB3D(const std::string& OB3DFileName, bool bIsRigged);
-	void SaveOB3D(const std::string& OB3DFileName);
+	// Reads from memory (e.g. an OB3D chunk of a scene container)
+	// PtrDecodedModel (optional): the model already decoded from the OB3D header (see ReadOB3DHeader()), which is moved from
+	void LoadOB3D(CBinaryData& Object3DBinary, bool bIsRigged, SMESHData* const PtrDecodedModel = nullptr);
+	void SaveOB3D(const std::string& OB3DFileName, bool bShouldCompress = false);
+	void SaveOB3D(CBinaryData& Object3DBinary);
 	void ExportEmbeddedTextures(const std::string& Directory);
 
+	// Reads up to where the model comes from, so that it needs no device
+	static bool ReadOB3DHeader(CBinaryData& Object3DBinary, SOB3DHeader& Out);
+	// Fills Model.EditorBoundingSphereData from the vertices, needs no device
+	static void CalculateEditorBoundingSphereData(SMESHData& Model);
+	// Reads the name and the instance count only, skipping the mesh data, so that it needs no device
+	static bool ReadOB3DSummary(CBinaryData& Object3DBinary, std::string& OutName, uint32_t& OutInstanceCount);
+
 // Import & export (internal)
 private:
 	void ExportEmbeddedTexture(CMaterialTextureSet* const MaterialTextureSet, CMaterialData& MaterialData,
 		ETextureType eTextureType, const std::string& Directory);
 
+// Scene saving
+public:
+	// @important: set by every change that SaveOB3D() writes, so that a scene save can reuse the last OB3D chunk of a clean object
+	// Changes made through non-const references (e.g. GetModel()) must be marked by the caller
+	void MarkSaveDirty();
+	bool IsSaveDirty() const;
+	// SavedChunkHash: CSceneContainer::HashRawBytes() of the OB3D chunk that was saved (or loaded)
+	void ClearSaveDirty(uint64_t SavedChunkHash);
+	uint64_t GetSavedChunkHash() const;
+
 // Instance creation & deletion
 public:
 	void CreateInstances(const std::vector<SObject3DInstanceCPUData>& vInstanceCPUData, const std::vector<SObject3DInstanceGPUData>& vInstanceGPUData);
@@ -186,10 +247,35 @@ private:
 
 // Instance buffer
 private:
-	void _CreateInstanceBuffer(size_t MeshIndex);
-	void CreateInstanceBuffers();
-	void _UpdateInstanceBuffer(size_t MeshIndex = 0);
-	void UpdateInstanceBuffers();
+	void CreateInstanceBuffer(size_t InstanceCapacity);
+	void MarkInstancesDirty(size_t FirstInstanceIndex, size_t InstanceCount = 1);
+	void MarkAllInstancesDirty();
+	void UpdateVisibleInstanceBuffer();
+
+public:
+	// Uploads the instance ranges changed since the last flush, returns the uploaded byte count
+	size_t FlushInstanceBuffer() const;
+
+// Instance culling
+public:
+	// Returns the visible instance count
+	// Occluded instances are removed, too, when OcclusionCuller is given (its occluders must be rasterized)
+	size_t CullInstances(const CFrustumCuller& FrustumCuller, const COcclusionCuller* const OcclusionCuller = nullptr);
+	size_t GetVisibleInstanceCount() const;
+	// @important: updated by CullInstances() (xyz = world center, w = radius)
+	const std::vector<XMFLOAT4>& GetInstanceBoundingSpheres() const;
+
+// Occlusion culling
+public:
+	// Authored occluder (model space) that replaces the one taken from the model
+	void SetOccluderMesh(const SOccluderMesh& OccluderMesh);
+	// nullptr when the object doesn't occlude (not an occluder, rigged, transparent, tessellated, or too detailed)
+	const SOccluderMesh* GetOccluderMesh() const;
+	// Adds the object, or each of its instances, inside the frustum
+	void AddOccluders(COcclusionCuller& OcclusionCuller, const CFrustumCuller& FrustumCuller) const;
+
+private:
+	void CreateOccluderMesh();
 
 // Animation adding & setting (general)
 public:
@@ -198,6 +284,7 @@ public:
 	void SetAnimationName(uint32_t AnimationID, const std::string& Name);
 	void SetAnimationTicksPerSecond(uint32_t AnimationID, float TPS);
 	void SetAnimationBehaviorStartTick(uint32_t AnimationID, float BehaviorStartTick);
+	void ShouldCompressAnimations(bool bShouldCompress);
 
 // Animation info (general)
 public:
@@ -210,6 +297,8 @@ public:
 	float GetAnimationBehaviorStartTick(uint32_t AnimationID) const;
 	float GetAnimationDuration(uint32_t AnimationID) const;
 	const DirectX::XMMATRIX* GetAnimationBoneMatrices() const;
+	uint32_t GetAnimationBoneMatrixCount() const;
+	bool ShouldCompressAnimations() const;
 
 // Animation info (identifier)
 public:
@@ -238,22 +327,64 @@ public:
 	bool HasBakedAnimationTexture() const;
 	bool CanBakeAnimationTexture() const;
 	void BakeAnimationTexture();
+	void ShouldBakeHalfFloatAnimationTexture(bool bShouldUseHalfFloat);
+	bool ShouldBakeHalfFloatAnimationTexture() const;
 	void SaveBakedAnimationTexture(const std::string& FileName);
 	void LoadBakedAnimationTexture(const std::string& FileName);
 
 // Animation setting (identifier)
 public:
+	// @important: BlendTime (crossfade, in seconds) is only applied to non-instanced objects (CPU pose evaluation)
 	void SetAnimation(const SObjectIdentifier& Identifier, uint32_t AnimationID,
-		EAnimationOption eAnimationOption = EAnimationOption::Repeat, bool bShouldIgnoreCurrentAnimation = true);
+		EAnimationOption eAnimationOption = EAnimationOption::Repeat, bool bShouldIgnoreCurrentAnimation = true, float BlendTime = 0.0f);
 	void SetAnimation(const SObjectIdentifier& Identifier, EAnimationRegistrationType eRegisteredType,
-		EAnimationOption eAnimationOption = EAnimationOption::Repeat, bool bShouldIgnoreCurrentAnimation = true);
+		EAnimationOption eAnimationOption = EAnimationOption::Repeat, bool bShouldIgnoreCurrentAnimation = true, float BlendTime = 0.0f);
+
+// Animation blending (object)
+public:
+	// Plays AnimationID over the current animation on the subtree of MaskRootNodeName (empty name means the whole tree)
+	void SetAnimationLayer(uint32_t AnimationID, const std::string& MaskRootNodeName, float BlendTime,
+		EAnimationOption eAnimationOption = EAnimationOption::PlayToLastFrame);
+	void ClearAnimationLayer(float BlendTime);
+	bool IsBlendingAnimations() const;
+	void MeasurePoseEvaluationTime(uint32_t IterationCount, double& OutUnblendedMicroseconds, double& OutBlendedMicroseconds) const;
+
+// Animation LOD (object)
+public:
+	void SetAnimationLODSettings(const SAnimationLODSettings& Settings);
+	const SAnimationLODSettings& GetAnimationLODSettings() const;
+	// @important: call this before Animate() in order to update the viewer-dependent LOD state
+	void UpdateAnimationLOD(const XMVECTOR& EyePosition, const BoundingFrustum& ViewFrustum);
+	const SAnimationLODStatistics& GetAnimationLODStatistics() const;
+
+// Mesh LOD (object)
+public:
+	// Simplifies every mesh into up to LODCount - 1 coarser index lists over the same vertices, halving the triangles each time
+	void GenerateMeshLODs(uint32_t LODCount = KDefaultMeshLODCount);
+	// Needs no device (e.g. for the asset cooker), the mesh buffers are left as they are
+	static void GenerateMeshLODs(SMESHData& Model, uint32_t LODCount);
+	// Generates LODCount LODs of the MESH file IterationCount times and returns the average time in milliseconds (0 if it can't be read)
+	// vOutLODTriangleCounts: the triangle count of every LOD, over all meshes
+	static double MeasureMeshLODGenerationTime(const std::string& MESHFileName, uint32_t LODCount, uint32_t IterationCount,
+		std::vector<size_t>& vOutLODTriangleCounts);
+	void ClearMeshLODs();
+	// Picks the LOD from the projected size of the bounding sphere (the largest visible instance's), with hysteresis
+	// ProjectionScaleY: _22 of the projection matrix
+	void UpdateMeshLOD(const XMVECTOR& EyePosition, float ProjectionScaleY);
+	uint32_t GetMeshLODCount() const;
+	uint32_t GetCurrentMeshLOD() const;
+	size_t GetMeshLODTriangleCount(uint32_t LOD) const;
+
+private:
+	// Projected diameter over the screen height below which LOD is used
+	static float GetMeshLODScreenSize(uint32_t LOD);
 
 // Animation setting (object & instance)
 private:
 	void SetObjectAnimation(uint32_t AnimationID,
-		EAnimationOption eAnimationOption = EAnimationOption::Repeat, bool bShouldIgnoreCurrentAnimation = true);
+		EAnimationOption eAnimationOption = EAnimationOption::Repeat, bool bShouldIgnoreCurrentAnimation = true, float BlendTime = 0.0f);
 	void SetObjectAnimation(EAnimationRegistrationType eRegisteredType,
-		EAnimationOption eAnimationOption = EAnimationOption::Repeat, bool bShouldIgnoreCurrentAnimation = true);
+		EAnimationOption eAnimationOption = EAnimationOption::Repeat, bool bShouldIgnoreCurrentAnimation = true, float BlendTime = 0.0f);
 
 	void SetInstanceAnimation(const std::string& InstanceName, uint32_t AnimationID,
 		EAnimationOption eAnimationOption = EAnimationOption::Repeat, bool bShouldIgnoreCurrentAnimation = true);
@@ -364,22 +495,43 @@ public:
 	void SetAllInstancesHighlightOff();
 
 private:
+	SCBMaterialData MakeCBMaterialData(const CMaterialData& MaterialData, uint32_t TotalMaterialCount) const;
 	void UpdateCBMaterial(const CMaterialData& MaterialData, uint32_t TotalMaterialCount) const;
 
 public:
 	void Animate(float DeltaTime);
+	// @important: the offset of this object's palette in the shared bone palette buffer (this frame)
+	void SetAnimationBoneMatrixOffset(uint32_t Offset);
 
 private:
 	void AnimateInstance(const std::string& InstanceName, float DeltaTime);
-	void CalculateAnimatedBoneMatrices(const SMeshAnimation& CurrentAnimation, float AnimationTick, const SMeshTreeNode& Node, XMMATRIX ParentTransform);
+	void AdvanceAnimationBlending(float DeltaTime);
+	bool ShouldEvaluateObjectPose();
+	void EvaluateObjectPose();
 
 public:
 	void Draw(EFlagsObject3DRendering eFlagsRendering = EFlagsObject3DRendering::None, size_t OneInstanceIndex = 0) const;
 
+	// Mesh by mesh drawing for sorted submission (see CDrawPacketQueue)
+	// @important: the shaders, the topology and the object's constant buffers must be set by the caller
+	size_t GetMeshCount() const;
+	uint32_t GetMeshMaterialID(size_t MeshIndex) const;
+	void UseBakedAnimationTexture() const;
+	void UseMeshMaterial(size_t MeshIndex, bool bIgnoreOwnTexture) const;
+	// Hash of what UseMeshMaterial() sets (the material CB and the registry handles of the textures),
+	// so that objects with the same material share draw states
+	// Returns false if the material can't be shared (textures that aren't registered, or the textures of every material are used at once)
+	bool GetMaterialStateHash(size_t MaterialIndex, uint64_t& OutHash) const;
+	void DrawMesh(size_t MeshIndex, EFlagsObject3DRendering eFlagsRendering = EFlagsObject3DRendering::None, size_t OneInstanceIndex = 0) const;
+
 public:
 	bool ShouldTessellate() const;
 	void ShouldTessellate(bool Value);
 
+	// Saves the vertices in the packed format (see CVertexPacker)
+	bool ShouldPackVertices() const;
+	void ShouldPackVertices(bool Value);
+
 	void SetTessFactorData(const CObject3D::SCBTessFactorData& Data);
 	const CObject3D::SCBTessFactorData& GetTessFactorData() const;
 
@@ -392,6 +544,8 @@ public:
 	bool IsInstanced() const;
 	bool IsPickable() const;
 	void IsPickable(bool NewValue);
+	bool IsOccluder() const;
+	void IsOccluder(bool NewValue);
 	bool IsTransparent() const;
 	void IsTransparent(bool NewValue);
 	bool IsGPUSkinned() const;
@@ -422,12 +576,13 @@ public:
 	static constexpr float KScalingMaxLimit{ +100.0f };
 	static constexpr float KScalingMinLimit{ +0.001f };
 	static constexpr size_t KMaxAnimationNameLength{ 15 };
-	static constexpr uint32_t KMaxBoneMatrixCount{ 60 };
-
-private:
-	static constexpr int32_t KAnimationTextureWidth{ 4 * (int32_t)KMaxBoneMatrixCount };
-	static constexpr int32_t KAnimationTextureReservedHeight{ 1 };
-	static constexpr int32_t KAnimationTextureReservedFirstPixelCount{ 2 };
+	static constexpr uint32_t KInstanceUploadMergeGap{ 8 }; // in instances
+	static constexpr size_t KMaxOccluderTriangleCount{ 256 }; // models with more triangles need an authored occluder
+	static constexpr uint32_t KDefaultMeshLODCount{ 4 };
+	static constexpr uint32_t KMaxMeshLODCount{ 8 };
+	static constexpr float KMeshLODFirstScreenSize{ 0.25f }; // halved for every next LOD
+	static constexpr float KMeshLODHysteresis{ 0.15f }; // relative to the screen size, so that the LOD doesn't flicker at the boundary
+	static constexpr float KMeshLODMaxErrorRatio{ 0.01f }; // of the mesh size, doubled for every next LOD
 
 private:
 	ID3D11Device* const										m_PtrDevice{};
@@ -446,15 +601,24 @@ private:
 	std::string												m_Name{};
 	std::string												m_ModelFileName{};
 	std::string												m_OB3DFileName{};
+	bool													m_bIsSaveDirty{ true };
+	uint64_t												m_SavedChunkHash{};
 	bool													m_bIsCreated{ false };
 	bool													m_bIsPickable{ true };
+	bool													m_bIsOccluder{ true };
+	std::unique_ptr<SOccluderMesh>							m_OccluderMesh{};
+	uint32_t												m_CurrentMeshLOD{};
 	bool													m_bShouldTesselate{ false };
 	std::unique_ptr<SMESHData>								m_Model{};
 	std::vector<std::unique_ptr<CMaterialTextureSet>>		m_vMaterialTextureSets{};
 
 private:
 	std::vector<SMeshBuffers>								m_vMeshBuffers{};
-	std::vector<SInstanceBuffer>							m_vInstanceBuffers{};
+	SInstanceBuffer											m_InstanceBuffer{}; // shared by every mesh
+	size_t													m_InstanceBufferCapacity{};
+	mutable CDirtyRangeTracker								m_InstanceDirtyRanges{};
+	SInstanceBuffer											m_VisibleInstanceBuffer{}; // shared by every mesh
+	size_t													m_VisibleInstanceBufferCapacity{};
 
 private:
 	std::unique_ptr<CConstantBuffer>						m_CBMaterial{};
@@ -469,10 +633,42 @@ private:
 	EAnimationOption										m_eCurrentAnimationOption{};
 
 private:
-	XMMATRIX												m_AnimatedBoneMatrices[KMaxBoneMatrixCount]{};
+	std::vector<XMMATRIX>									m_vAnimatedBoneMatrices{}; // [BoneIndex] (transposed)
 	bool													m_bIsBakedAnimationLoaded{ false };
 	std::unique_ptr<CTexture>								m_BakedAnimationTexture{};
 	SCBAnimationData										m_CBAnimationData{};
+	bool													m_bShouldBakeHalfFloatAnimationTexture{ false };
+	std::vector<SBakedAnimation>							m_vBakedAnimations{};
+
+private:
+	uint32_t												m_CrossfadeAnimationID{};
+	float													m_CrossfadeAnimationTick{};
+	EAnimationOption										m_eCrossfadeAnimationOption{};
+	float													m_CrossfadeTime{};
+	float													m_CrossfadeElapsedTime{};
+
+	bool													m_bIsAnimationLayerActive{ false };
+	uint32_t												m_LayerAnimationID{};
+	float													m_LayerAnimationTick{};
+	EAnimationOption										m_eLayerAnimationOption{};
+	float													m_LayerWeight{};
+	float													m_LayerTargetWeight{};
+	float													m_LayerBlendTime{};
+	std::vector<float>										m_vLayerMaskWeights{};
+
+private:
+	// @important: sized once per model so that evaluating (blended) poses doesn't allocate
+	CPoseEvaluator											m_PoseEvaluator{};
+	std::vector<SNodePose>									m_vBasePose{};
+	std::vector<SNodePose>									m_vBlendPose{};
+	bool													m_bIsObjectPoseValid{ false };
+
+private:
+	SAnimationLODSettings									m_AnimationLODSettings{};
+	SAnimationLODStatistics									m_AnimationLODStatistics{};
+	float													m_AnimationLODDistance{};
+	bool													m_bIsInViewFrustum{ true };
+	uint32_t												m_AnimationLODFrameCounter{};
 
 private:
 	std::unordered_map<EAnimationRegistrationType, size_t>	m_umapRegisteredAnimationTypeToIndex{};
@@ -484,6 +680,11 @@ private:
 	std::vector<SObject3DInstanceGPUData>					m_vInstanceGPUData{};
 	std::vector<SObject3DInstanceCPUData>					m_vInstanceCPUData{};
 	std::map<std::string, size_t>							m_mapInstanceNameToIndex{};
+
+private:
+	std::vector<XMFLOAT4>									m_vInstanceBoundingSpheres{}; // xyz = world center, w = radius
+	std::vector<uint32_t>									m_vVisibleInstanceIndices{};
+	std::vector<SObject3DInstanceGPUData>					m_vVisibleInstanceGPUData{};
 };
 
 ENUM_CLASS_FLAG(CObject3D::EFlagsRendering)
@@ -38,11 +38,12 @@ struct SAnimationVertex
 
 struct SMesh
 {
-	std::vector<SVertex3D>			vVertices{};
-	std::vector<SAnimationVertex>	vAnimationVertices{};
-	std::vector<STriangle>			vTriangles{};
+	std::vector<SVertex3D>					vVertices{};
+	std::vector<SAnimationVertex>			vAnimationVertices{};
+	std::vector<STriangle>					vTriangles{};
+	std::vector<std::vector<STriangle>>		vLODTriangles{}; // LOD 1, 2, ... over the same vertices (LOD 0 is vTriangles)
 
-	uint8_t							MaterialID{};
+	uint8_t									MaterialID{};
 };
 
 class CObject3D;
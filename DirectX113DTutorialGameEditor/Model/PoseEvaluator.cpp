@@ -0,0 +1,418 @@
+#include "PoseEvaluator.h"
+#include "../Core/Material.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <DirectXPackedVector.h>
+
+using std::vector;
+using std::max;
+using std::min;
+using std::chrono::steady_clock;
+
+void CPoseEvaluator::Initialize(const SMESHData& Model)
+{
+	m_PtrModel = &Model;
+
+	const size_t KNodeCount{ Model.vTreeNodes.size() };
+
+	m_vBindPoses.resize(KNodeCount);
+	for (size_t iNode = 0; iNode < KNodeCount; ++iNode)
+	{
+		SNodePose& BindPose{ m_vBindPoses[iNode] };
+		XMMatrixDecompose(&BindPose.Scaling, &BindPose.Rotation, &BindPose.Translation, Model.vTreeNodes[iNode].MatrixTransformation);
+		BindPose.bIsBindPose = true;
+	}
+
+	// @important: child nodes always come after their parent node, so a reverse traversal visits every subtree before its root
+	vector<bool> vHasBoneDescendant(KNodeCount);
+	m_vIsLeafBone.assign(KNodeCount, false);
+	m_BoneCount = m_LeafBoneCount = m_BoneMatrixCount = 0;
+	for (size_t iNode = KNodeCount; iNode > 0; --iNode)
+	{
+		const SMeshTreeNode& Node{ Model.vTreeNodes[iNode - 1] };
+		for (auto iChild : Node.vChildNodeIndices)
+		{
+			if (Model.vTreeNodes[iChild].bIsBone || vHasBoneDescendant[iChild]) vHasBoneDescendant[iNode - 1] = true;
+		}
+		if (!Node.bIsBone) continue;
+
+		++m_BoneCount;
+		m_BoneMatrixCount = max(m_BoneMatrixCount, Node.BoneIndex + 1);
+		if (!vHasBoneDescendant[iNode - 1])
+		{
+			m_vIsLeafBone[iNode - 1] = true;
+			++m_LeafBoneCount;
+		}
+	}
+
+	// @important: resolve node animation names once, instead of looking them up every frame
+	m_vNodeAnimationIndices.resize(Model.vAnimations.size());
+	for (size_t iAnimation = 0; iAnimation < Model.vAnimations.size(); ++iAnimation)
+	{
+		const SMeshAnimation& Animation{ Model.vAnimations[iAnimation] };
+		auto& vNodeAnimationIndices{ m_vNodeAnimationIndices[iAnimation] };
+		vNodeAnimationIndices.assign(KNodeCount, -1);
+		for (size_t iNode = 0; iNode < KNodeCount; ++iNode)
+		{
+			const SMeshTreeNode& Node{ Model.vTreeNodes[iNode] };
+			if (!Node.bIsBone) continue;
+
+			auto found{ Animation.umapNodeAnimationNameToIndex.find(Node.Name) };
+			if (found != Animation.umapNodeAnimationNameToIndex.end()) vNodeAnimationIndices[iNode] = (int32_t)found->second;
+		}
+	}
+}
+
+void CPoseEvaluator::SampleLocalPose(uint32_t AnimationID, float AnimationTick, std::vector<SNodePose>& vOutPose, bool bShouldSkipLeafBones) const
+{
+	static const XMVECTOR KDefaultScaling{ XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f) };
+
+	assert(m_PtrModel);
+	const SMeshAnimation& Animation{ m_PtrModel->vAnimations[AnimationID] };
+	const auto& vNodeAnimationIndices{ m_vNodeAnimationIndices[AnimationID] };
+	for (size_t iNode = 0; iNode < vOutPose.size(); ++iNode)
+	{
+		if (bShouldSkipLeafBones && m_vIsLeafBone[iNode]) continue;
+
+		int32_t NodeAnimationIndex{ vNodeAnimationIndices[iNode] };
+		if (NodeAnimationIndex < 0)
+		{
+			vOutPose[iNode] = m_vBindPoses[iNode];
+			continue;
+		}
+
+		const SMeshAnimation::SNodeAnimation& NodeAnimation{ Animation.vNodeAnimations[NodeAnimationIndex] };
+		SNodePose& Pose{ vOutPose[iNode] };
+
+		// @important: keys are interpolated, so that linearly eliminated keys of compressed animations are reproduced
+		Pose.Translation = InterpolateAnimationKeys(NodeAnimation.vPositionKeys, AnimationTick, false, XMVectorZero());
+		Pose.Rotation = InterpolateAnimationKeys(NodeAnimation.vRotationKeys, AnimationTick, true, XMQuaternionIdentity());
+		Pose.Scaling = InterpolateAnimationKeys(NodeAnimation.vScalingKeys, AnimationTick, false, KDefaultScaling);
+		Pose.bIsBindPose = false;
+	}
+}
+
+void CPoseEvaluator::BlendLocalPoses(std::vector<SNodePose>& vInOutPose, const std::vector<SNodePose>& vPose, float Weight,
+	const std::vector<float>* const PtrMaskWeights, bool bShouldSkipLeafBones) const
+{
+	for (size_t iNode = 0; iNode < vInOutPose.size(); ++iNode)
+	{
+		// @important: skipped leaf bones keep the previous blended pose, their vPose entries are stale
+		if (bShouldSkipLeafBones && m_vIsLeafBone[iNode]) continue;
+
+		float NodeWeight{ (PtrMaskWeights) ? Weight * (*PtrMaskWeights)[iNode] : Weight };
+		if (NodeWeight <= 0.0f) continue;
+
+		SNodePose& Dest{ vInOutPose[iNode] };
+		const SNodePose& Src{ vPose[iNode] };
+		if (NodeWeight >= 1.0f)
+		{
+			Dest = Src;
+			continue;
+		}
+		if (Dest.bIsBindPose && Src.bIsBindPose) continue;
+
+		Dest.Translation = XMVectorLerp(Dest.Translation, Src.Translation, NodeWeight);
+		Dest.Rotation = XMQuaternionSlerp(Dest.Rotation, Src.Rotation, NodeWeight);
+		Dest.Scaling = XMVectorLerp(Dest.Scaling, Src.Scaling, NodeWeight);
+		Dest.bIsBindPose = false;
+	}
+}
+
+void CPoseEvaluator::CalculateAnimatedBoneMatrices(const std::vector<SNodePose>& vPose, XMMATRIX* const OutBoneMatrices) const
+{
+	assert(m_PtrModel);
+	if (m_PtrModel->vTreeNodes.empty()) return;
+
+	CalculateAnimatedBoneMatrices(vPose, m_PtrModel->vTreeNodes[0], XMMatrixIdentity(), OutBoneMatrices);
+}
+
+void CPoseEvaluator::CalculateAnimatedBoneMatrices(const std::vector<SNodePose>& vPose, const SMeshTreeNode& Node, XMMATRIX ParentTransform,
+	XMMATRIX* const OutBoneMatrices) const
+{
+	XMMATRIX MatrixTransformation{ Node.MatrixTransformation * ParentTransform };
+
+	if (Node.bIsBone)
+	{
+		const SNodePose& Pose{ vPose[Node.Index] };
+		if (!Pose.bIsBindPose)
+		{
+			MatrixTransformation = XMMatrixScalingFromVector(Pose.Scaling) * XMMatrixRotationQuaternion(Pose.Rotation) *
+				XMMatrixTranslationFromVector(Pose.Translation) * ParentTransform;
+		}
+
+		// Transpose at the last moment!
+		OutBoneMatrices[Node.BoneIndex] = XMMatrixTranspose(Node.MatrixBoneOffset * MatrixTransformation);
+	}
+
+	if (Node.vChildNodeIndices.size())
+	{
+		for (auto iChild : Node.vChildNodeIndices)
+		{
+			CalculateAnimatedBoneMatrices(vPose, m_PtrModel->vTreeNodes[iChild], MatrixTransformation, OutBoneMatrices);
+		}
+	}
+}
+
+void CPoseEvaluator::MeasurePoseEvaluationTime(uint32_t AnimationID, uint32_t OtherAnimationID, float AnimationTick,
+	const std::vector<float>* const PtrMaskWeights, uint32_t IterationCount, double& OutUnblendedMicroseconds, double& OutBlendedMicroseconds) const
+{
+	OutUnblendedMicroseconds = OutBlendedMicroseconds = 0;
+	if (!m_PtrModel || m_PtrModel->vAnimations.empty() || m_PtrModel->vTreeNodes.empty() || IterationCount == 0) return;
+
+	// @important: scratch is allocated once, so that only the evaluation is measured
+	vector<SNodePose> vBasePose{ m_vBindPoses };
+	vector<SNodePose> vBlendPose{ m_vBindPoses };
+	vector<XMMATRIX> vBoneMatrices(m_BoneMatrixCount);
+
+	auto Start{ steady_clock::now() };
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
+	{
+		SampleLocalPose(AnimationID, AnimationTick, vBasePose);
+		CalculateAnimatedBoneMatrices(vBasePose, vBoneMatrices.data());
+	}
+	auto End{ steady_clock::now() };
+	OutUnblendedMicroseconds = std::chrono::duration<double, std::micro>(End - Start).count() / IterationCount;
+
+	// Crossfade + masked layer, the most expensive case
+	Start = steady_clock::now();
+	for (uint32_t iIteration = 0; iIteration < IterationCount; ++iIteration)
+	{
+		SampleLocalPose(AnimationID, AnimationTick, vBasePose);
+		SampleLocalPose(OtherAnimationID, AnimationTick, vBlendPose);
+		BlendLocalPoses(vBasePose, vBlendPose, 0.5f, nullptr);
+		SampleLocalPose(OtherAnimationID, AnimationTick, vBlendPose);
+		BlendLocalPoses(vBasePose, vBlendPose, 0.5f, PtrMaskWeights);
+		CalculateAnimatedBoneMatrices(vBasePose, vBoneMatrices.data());
+	}
+	End = steady_clock::now();
+	OutBlendedMicroseconds = std::chrono::duration<double, std::micro>(End - Start).count() / IterationCount;
+}
+
+uint32_t CPoseEvaluator::BakeAnimations(std::vector<SBakedAnimation>& vInOutBakedAnimations) const
+{
+	assert(m_PtrModel);
+	const uint32_t KAnimationCount{ (uint32_t)m_PtrModel->vAnimations.size() };
+	vInOutBakedAnimations.resize(KAnimationCount);
+
+	vector<uint32_t> vChangedAnimationIDs{};
+	for (uint32_t iAnimation = 0; iAnimation < KAnimationCount; ++iAnimation)
+	{
+		SBakedAnimation& BakedAnimation{ vInOutBakedAnimations[iAnimation] };
+		uint64_t Hash{ CalculateAnimationBakeHash(iAnimation) };
+		if (BakedAnimation.vBoneMatrices.size() && BakedAnimation.Hash == Hash) continue;
+
+		BakedAnimation.Hash = Hash;
+		vChangedAnimationIDs.emplace_back(iAnimation);
+	}
+	EvaluateAnimations(vChangedAnimationIDs, vInOutBakedAnimations);
+
+	return (uint32_t)vChangedAnimationIDs.size();
+}
+
+void CPoseEvaluator::EvaluateAnimations(const std::vector<uint32_t>& vAnimationIDs, std::vector<SBakedAnimation>& vInOutBakedAnimations) const
+{
+	if (vAnimationIDs.empty()) return;
+
+	const uint32_t KTextureBoneCount{ GetAnimationTextureBoneCount() };
+
+	// Every (animation, tick) pair is an independent job
+	vector<std::pair<uint32_t, int32_t>> vJobs{};
+	for (auto AnimationID : vAnimationIDs)
+	{
+		int32_t Duration{ (int32_t)m_PtrModel->vAnimations[AnimationID].Duration + 1 };
+		vInOutBakedAnimations[AnimationID].vBoneMatrices.assign((size_t)Duration * KTextureBoneCount, XMFLOAT4X4());
+		for (int32_t iTime = 0; iTime < Duration; ++iTime)
+		{
+			vJobs.emplace_back(AnimationID, iTime);
+		}
+	}
+
+	std::atomic<size_t> NextJobIndex{};
+	auto Work{ [&]()
+	{
+		// @important: per-thread scratch, the pose evaluation itself is const
+		vector<SNodePose> vPose{ m_vBindPoses };
+		vector<XMMATRIX> vBoneMatrices(m_BoneMatrixCount);
+		for (size_t iJob = NextJobIndex++; iJob < vJobs.size(); iJob = NextJobIndex++)
+		{
+			uint32_t AnimationID{ vJobs[iJob].first };
+			int32_t iTime{ vJobs[iJob].second };
+
+			SampleLocalPose(AnimationID, (float)iTime, vPose);
+			CalculateAnimatedBoneMatrices(vPose, vBoneMatrices.data());
+
+			XMFLOAT4X4* const PtrDest{ &vInOutBakedAnimations[AnimationID].vBoneMatrices[(size_t)iTime * KTextureBoneCount] };
+			for (uint32_t iBoneMatrix = 0; iBoneMatrix < m_BoneMatrixCount; ++iBoneMatrix)
+			{
+				// Bone matrices are transposed for the bone palette buffer, but the texture stores them as they are
+				XMStoreFloat4x4(&PtrDest[iBoneMatrix], XMMatrixTranspose(vBoneMatrices[iBoneMatrix]));
+			}
+		}
+	} };
+
+	size_t ThreadCount{ min((size_t)max(std::thread::hardware_concurrency(), 1u), vJobs.size()) };
+	vector<std::thread> vThreads{};
+	for (size_t iThread = 1; iThread < ThreadCount; ++iThread)
+	{
+		vThreads.emplace_back(Work);
+	}
+	Work(); // @important: the calling thread works, too
+	for (auto& Thread : vThreads)
+	{
+		Thread.join();
+	}
+}
+
+void CPoseEvaluator::BuildAnimationTextureData(const std::vector<SBakedAnimation>& vBakedAnimations, std::vector<SPixel128Float>& vOutRawData) const
+{
+	BuildAnimationTextureRawData(vBakedAnimations, false, vOutRawData);
+}
+
+void CPoseEvaluator::BuildAnimationTextureData(const std::vector<SBakedAnimation>& vBakedAnimations, std::vector<SPixel64Float>& vOutHalfRawData) const
+{
+	vector<SPixel128Float> vRawData{};
+	BuildAnimationTextureRawData(vBakedAnimations, true, vRawData);
+
+	vOutHalfRawData.resize(vRawData.size());
+	PackedVector::XMConvertFloatToHalfStream(&vOutHalfRawData[0].R, sizeof(uint16_t), &vRawData[0].R, sizeof(float), vRawData.size() * 4);
+
+	// RGBA = 4 halves = 8 chars, 2 pixels per name
+	const int32_t KTextureWidth{ GetAnimationTextureWidth() };
+	for (size_t iAnimation = 0; iAnimation < m_PtrModel->vAnimations.size(); ++iAnimation)
+	{
+		const std::string& AnimationName{ m_PtrModel->vAnimations[iAnimation].Name };
+		char Name[16]{};
+		memcpy(Name, AnimationName.c_str(), min(AnimationName.size(), sizeof(Name) - 1));
+		memcpy(&vOutHalfRawData[(int64_t)KAnimationTextureReservedHeight * KTextureWidth + (int64_t)iAnimation * 2].R, Name, sizeof(Name));
+	}
+}
+
+void CPoseEvaluator::BuildAnimationTextureRawData(const std::vector<SBakedAnimation>& vBakedAnimations, bool bUseHalfFloat,
+	std::vector<SPixel128Float>& vOutRawData) const
+{
+	assert(m_PtrModel);
+	assert(vBakedAnimations.size() == m_PtrModel->vAnimations.size());
+
+	// TODO: corret sign-ness ??
+
+	const int32_t KReservedHeight{ KAnimationTextureReservedHeight + ((bUseHalfFloat) ? 1 : 0) };
+	const int32_t KTextureWidth{ GetAnimationTextureWidth() };
+	const int32_t KTextureHeight{ GetAnimationTextureHeight(bUseHalfFloat) };
+
+	vOutRawData.clear();
+	vOutRawData.resize((int64_t)KTextureWidth * KTextureHeight);
+	vOutRawData[0].R = 'A';
+	vOutRawData[0].G = 'N';
+	vOutRawData[0].B = 'I';
+	vOutRawData[0].A = 'M';
+
+	float fAnimationCount{ (float)m_PtrModel->vAnimations.size() };
+	memcpy(&vOutRawData[1].R, &fAnimationCount, sizeof(float));
+
+	int32_t AnimationHeightSum{ KReservedHeight };
+	for (int32_t iAnimation = 0; iAnimation < (int32_t)m_PtrModel->vAnimations.size(); ++iAnimation)
+	{
+		const SMeshAnimation& Animation{ m_PtrModel->vAnimations[iAnimation] };
+		SPixel128Float& InfoPixel{ vOutRawData[(int64_t)KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 0] };
+
+		float fAnimationHeightSum{ (float)AnimationHeightSum };
+		memcpy(&InfoPixel.R, &fAnimationHeightSum, sizeof(float));
+		memcpy(&InfoPixel.G, &Animation.Duration, sizeof(float));
+		memcpy(&InfoPixel.B, &Animation.TicksPerSecond, sizeof(float));
+		//A
+
+		// RGBA = 4 floats = 16 chars!
+		// @important: zero-padded, so that the texture doesn't depend on what follows the name in memory
+		if (!bUseHalfFloat)
+		{
+			char Name[16]{};
+			memcpy(Name, Animation.Name.c_str(), min(Animation.Name.size(), sizeof(Name) - 1));
+			memcpy(&vOutRawData[(int64_t)KAnimationTextureReservedFirstPixelCount + (int64_t)iAnimation * 2 + 1].R, Name, sizeof(Name));
+		}
+
+		// Bone matrices (TextureWidth == 4 * GetAnimationTextureBoneCount(), so each tick fills a row)
+		const SBakedAnimation& BakedAnimation{ vBakedAnimations[iAnimation] };
+		memcpy(&vOutRawData[(int64_t)AnimationHeightSum * KTextureWidth], &BakedAnimation.vBoneMatrices[0],
+			BakedAnimation.vBoneMatrices.size() * sizeof(XMFLOAT4X4));
+
+		AnimationHeightSum += (int32_t)Animation.Duration + 1;
+	}
+}
+
+int32_t CPoseEvaluator::GetAnimationTextureWidth() const
+{
+	return 4 * (int32_t)GetAnimationTextureBoneCount();
+}
+
+int32_t CPoseEvaluator::GetAnimationTextureHeight(bool bUseHalfFloat) const
+{
+	assert(m_PtrModel);
+	int32_t Height{ KAnimationTextureReservedHeight + ((bUseHalfFloat) ? 1 : 0) };
+	for (const auto& Animation : m_PtrModel->vAnimations)
+	{
+		Height += (int32_t)Animation.Duration + 1;
+	}
+	return Height;
+}
+
+uint32_t CPoseEvaluator::GetAnimationTextureBoneCount() const
+{
+	return max(m_BoneMatrixCount, KAnimationTextureMinBoneCount);
+}
+
+uint64_t CPoseEvaluator::CalculateAnimationBakeHash(uint32_t AnimationID) const
+{
+	// FNV-1a
+	static constexpr uint64_t KOffsetBasis{ 0xCBF29CE484222325 };
+	static constexpr uint64_t KPrime{ 0x100000001B3 };
+
+	uint64_t Hash{ KOffsetBasis };
+	auto HashBytes{ [&Hash](const void* const PtrBytes, size_t ByteCount)
+	{
+		const uint8_t* const Bytes{ (const uint8_t*)PtrBytes };
+		for (size_t iByte = 0; iByte < ByteCount; ++iByte)
+		{
+			Hash ^= Bytes[iByte];
+			Hash *= KPrime;
+		}
+	} };
+
+	const SMeshAnimation& Animation{ m_PtrModel->vAnimations[AnimationID] };
+	const auto& vNodeAnimationIndices{ m_vNodeAnimationIndices[AnimationID] };
+	HashBytes(&Animation.Duration, sizeof(Animation.Duration));
+	HashBytes(vNodeAnimationIndices.data(), vNodeAnimationIndices.size() * sizeof(int32_t));
+	for (const auto& NodeAnimation : Animation.vNodeAnimations)
+	{
+		for (const auto* const PtrKeys : { &NodeAnimation.vPositionKeys, &NodeAnimation.vRotationKeys, &NodeAnimation.vScalingKeys })
+		{
+			for (const auto& Key : *PtrKeys)
+			{
+				HashBytes(&Key.Time, sizeof(Key.Time));
+				HashBytes(&Key.Value, sizeof(Key.Value));
+			}
+		}
+	}
+	return Hash;
+}
+
+const std::vector<SNodePose>& CPoseEvaluator::GetBindPoses() const
+{
+	return m_vBindPoses;
+}
+
+uint32_t CPoseEvaluator::GetBoneCount() const
+{
+	return m_BoneCount;
+}
+
+uint32_t CPoseEvaluator::GetBoneMatrixCount() const
+{
+	return m_BoneMatrixCount;
+}
+
+uint32_t CPoseEvaluator::GetLeafBoneCount() const
+{
+	return m_LeafBoneCount;
+}
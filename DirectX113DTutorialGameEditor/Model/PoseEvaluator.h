@@ -0,0 +1,85 @@
+#pragma once
+
+#include "MeshPorter.h"
+
+struct SPixel64Float;
+struct SPixel128Float;
+
+// Local (parent-space) transform of a tree node
+struct SNodePose
+{
+	XMVECTOR				Translation{};
+	XMVECTOR				Rotation{};
+	XMVECTOR				Scaling{};
+	bool					bIsBindPose{ true }; // @important: bind pose nodes use SMeshTreeNode::MatrixTransformation as it is
+};
+
+// Baked bone matrices of an animation, kept so that only changed animations are re-baked
+struct SBakedAnimation
+{
+	uint64_t				Hash{};
+	std::vector<XMFLOAT4X4>	vBoneMatrices{}; // [(Duration + 1) * GetAnimationTextureBoneCount()]
+};
+
+// CPU pose evaluation of a rigged model: sampling, blending, bone matrices & animation texture baking (doesn't need a device)
+class CPoseEvaluator
+{
+public:
+	CPoseEvaluator() {}
+	~CPoseEvaluator() {}
+
+public:
+	// @important: Model must outlive the evaluator, and it must be re-initialized whenever the tree or the animations change
+	void Initialize(const SMESHData& Model);
+
+public:
+	void SampleLocalPose(uint32_t AnimationID, float AnimationTick, std::vector<SNodePose>& vOutPose, bool bShouldSkipLeafBones = false) const;
+	void BlendLocalPoses(std::vector<SNodePose>& vInOutPose, const std::vector<SNodePose>& vPose, float Weight,
+		const std::vector<float>* const PtrMaskWeights, bool bShouldSkipLeafBones = false) const;
+	// OutBoneMatrices must hold GetBoneMatrixCount() matrices (transposed)
+	void CalculateAnimatedBoneMatrices(const std::vector<SNodePose>& vPose, XMMATRIX* const OutBoneMatrices) const;
+
+	// Average time of one unblended pose and of one crossfaded + masked layer pose
+	void MeasurePoseEvaluationTime(uint32_t AnimationID, uint32_t OtherAnimationID, float AnimationTick, const std::vector<float>* const PtrMaskWeights,
+		uint32_t IterationCount, double& OutUnblendedMicroseconds, double& OutBlendedMicroseconds) const;
+
+// Animation texture baking (see Shader/VSAnimation.hlsl)
+public:
+	// @important: only animations that have changed since the last bake are evaluated, returns the evaluated animation count
+	uint32_t BakeAnimations(std::vector<SBakedAnimation>& vInOutBakedAnimations) const;
+	void BuildAnimationTextureData(const std::vector<SBakedAnimation>& vBakedAnimations, std::vector<SPixel128Float>& vOutRawData) const;
+	// @important: half-float textures store animation names in an extra reserved row, because a half pixel can't hold 16 chars
+	void BuildAnimationTextureData(const std::vector<SBakedAnimation>& vBakedAnimations, std::vector<SPixel64Float>& vOutHalfRawData) const;
+	int32_t GetAnimationTextureWidth() const;
+	int32_t GetAnimationTextureHeight(bool bUseHalfFloat) const;
+	uint32_t GetAnimationTextureBoneCount() const;
+	uint64_t CalculateAnimationBakeHash(uint32_t AnimationID) const;
+
+public:
+	const std::vector<SNodePose>& GetBindPoses() const;
+	uint32_t GetBoneCount() const;
+	uint32_t GetBoneMatrixCount() const;
+	uint32_t GetLeafBoneCount() const;
+
+private:
+	void CalculateAnimatedBoneMatrices(const std::vector<SNodePose>& vPose, const SMeshTreeNode& Node, XMMATRIX ParentTransform,
+		XMMATRIX* const OutBoneMatrices) const;
+	void EvaluateAnimations(const std::vector<uint32_t>& vAnimationIDs, std::vector<SBakedAnimation>& vInOutBakedAnimations) const;
+	void BuildAnimationTextureRawData(const std::vector<SBakedAnimation>& vBakedAnimations, bool bUseHalfFloat,
+		std::vector<SPixel128Float>& vOutRawData) const;
+
+public:
+	static constexpr uint32_t KAnimationTextureMinBoneCount{ 60 }; // @important: keeps textures baked for small rigs in the old layout
+	static constexpr int32_t KAnimationTextureReservedHeight{ 1 };
+	static constexpr int32_t KAnimationTextureReservedFirstPixelCount{ 2 };
+	static constexpr int32_t KAnimationTextureHalfFloatMaxHeight{ 2048 }; // @important: the largest range where half can store every integer (row offsets)
+
+private:
+	const SMESHData*						m_PtrModel{};
+	std::vector<std::vector<int32_t>>		m_vNodeAnimationIndices{}; // [AnimationID][TreeNodeIndex] (-1 if not animated)
+	std::vector<SNodePose>					m_vBindPoses{};
+	std::vector<bool>						m_vIsLeafBone{}; // [TreeNodeIndex] (bones without any bone descendant)
+	uint32_t								m_BoneCount{};
+	uint32_t								m_BoneMatrixCount{}; // max BoneIndex + 1
+	uint32_t								m_LeafBoneCount{};
+};
@@ -0,0 +1,208 @@
+#include "VertexPacker.h"
+#include <DirectXPackedVector.h>
+#include <chrono>
+
+using std::vector;
+using std::max;
+using std::min;
+
+// Largest absolute difference of the 4 components
+static float GetMaxComponentError(const XMVECTOR& A, const XMVECTOR& B)
+{
+	XMFLOAT4 Difference{};
+	XMStoreFloat4(&Difference, XMVectorAbs(A - B));
+	return max(max(Difference.x, Difference.y), max(Difference.z, Difference.w));
+}
+
+bool CVertexPacker::Pack(const std::vector<SVertex3D>& vVertices, SPackedVertices& OutPacked, SReport* const PtrReport) const
+{
+	const size_t KVertexCount{ vVertices.size() };
+	OutPacked.vPositions.resize(KVertexCount);
+	OutPacked.vAttributes.resize(KVertexCount);
+	OutPacked.vColors.clear();
+
+	// @important: a constant color is kept exactly, and it's the common case
+	OutPacked.bHasVertexColors = false;
+	if (KVertexCount) XMStoreFloat4(&OutPacked.ConstantColor, vVertices[0].Color);
+	for (const SVertex3D& Vertex : vVertices)
+	{
+		if (!XMVector4Equal(Vertex.Color, vVertices[0].Color))
+		{
+			OutPacked.bHasVertexColors = true;
+			OutPacked.vColors.resize(KVertexCount);
+			break;
+		}
+	}
+
+	float MaxDirectionError{};
+	float MaxTexCoordError{};
+	float MaxColorError{};
+	for (size_t iVertex = 0; iVertex < KVertexCount; ++iVertex)
+	{
+		const SVertex3D& Vertex{ vVertices[iVertex] };
+		SPackedVertexAttributes& Attributes{ OutPacked.vAttributes[iVertex] };
+
+		// Position is kept exactly, but w is dropped
+		XMStoreFloat3(&OutPacked.vPositions[iVertex], Vertex.Position);
+		if (XMVectorGetW(Vertex.Position) != 1.0f) return false;
+
+		EncodeOctahedral(Vertex.Normal, Attributes.Normal);
+		EncodeOctahedral(Vertex.Tangent, Attributes.Tangent);
+		MaxDirectionError = max(MaxDirectionError, XMVectorGetX(XMVector4Length(DecodeOctahedral(Attributes.Normal) - Vertex.Normal)));
+		MaxDirectionError = max(MaxDirectionError, XMVectorGetX(XMVector4Length(DecodeOctahedral(Attributes.Tangent) - Vertex.Tangent)));
+
+		Attributes.TexCoord[0] = PackedVector::XMConvertFloatToHalf(XMVectorGetX(Vertex.TexCoord));
+		Attributes.TexCoord[1] = PackedVector::XMConvertFloatToHalf(XMVectorGetY(Vertex.TexCoord));
+		XMVECTOR DecodedTexCoord{ XMVectorSet(PackedVector::XMConvertHalfToFloat(Attributes.TexCoord[0]),
+			PackedVector::XMConvertHalfToFloat(Attributes.TexCoord[1]), 0.0f, 0.0f) };
+		MaxTexCoordError = max(MaxTexCoordError, GetMaxComponentError(DecodedTexCoord, Vertex.TexCoord));
+
+		if (OutPacked.bHasVertexColors)
+		{
+			OutPacked.vColors[iVertex] = PackColor(Vertex.Color);
+			MaxColorError = max(MaxColorError, GetMaxComponentError(UnpackColor(OutPacked.vColors[iVertex]), Vertex.Color));
+		}
+	}
+
+	if (PtrReport)
+	{
+		PtrReport->MaxDirectionError = max(PtrReport->MaxDirectionError, MaxDirectionError);
+		PtrReport->MaxTexCoordError = max(PtrReport->MaxTexCoordError, MaxTexCoordError);
+		PtrReport->MaxColorError = max(PtrReport->MaxColorError, MaxColorError);
+	}
+
+	// @important: NaN fails these, too
+	if (!(MaxDirectionError <= m_Settings.DirectionErrorBudget)) return false;
+	if (!(MaxTexCoordError <= m_Settings.TexCoordErrorBudget)) return false;
+	if (!(MaxColorError <= m_Settings.ColorErrorBudget)) return false;
+	return true;
+}
+
+void CVertexPacker::Unpack(const SPackedVertices& Packed, std::vector<SVertex3D>& vOutVertices)
+{
+	assert(Packed.vPositions.size() == Packed.vAttributes.size());
+	assert(!Packed.bHasVertexColors || Packed.vColors.size() == Packed.vPositions.size());
+
+	const size_t KVertexCount{ Packed.vPositions.size() };
+	const XMVECTOR KConstantColor{ XMLoadFloat4(&Packed.ConstantColor) };
+	vOutVertices.resize(KVertexCount);
+	for (size_t iVertex = 0; iVertex < KVertexCount; ++iVertex)
+	{
+		const SPackedVertexAttributes& Attributes{ Packed.vAttributes[iVertex] };
+		SVertex3D& Vertex{ vOutVertices[iVertex] };
+
+		Vertex.Position = XMVectorSetW(XMLoadFloat3(&Packed.vPositions[iVertex]), 1.0f);
+		Vertex.Color = (Packed.bHasVertexColors) ? UnpackColor(Packed.vColors[iVertex]) : KConstantColor;
+		Vertex.TexCoord = XMVectorSet(PackedVector::XMConvertHalfToFloat(Attributes.TexCoord[0]),
+			PackedVector::XMConvertHalfToFloat(Attributes.TexCoord[1]), 0.0f, 0.0f);
+		Vertex.Normal = DecodeOctahedral(Attributes.Normal);
+		Vertex.Tangent = DecodeOctahedral(Attributes.Tangent);
+	}
+}
+
+CVertexPacker::SReport CVertexPacker::CreateReport(const SMESHData& MESHData) const
+{
+	SReport Report{};
+	Report.MeshCount = (uint32_t)MESHData.vMeshes.size();
+
+	vector<SPackedVertices> vPackedVertices{};
+	size_t PackedVertexCount{};
+	for (const SMesh& Mesh : MESHData.vMeshes)
+	{
+		Report.RawByteCount += sizeof(SVertex3D) * Mesh.vVertices.size();
+
+		vPackedVertices.emplace_back();
+		if (Pack(Mesh.vVertices, vPackedVertices.back(), &Report))
+		{
+			Report.PackedByteCount += GetPackedByteCount(vPackedVertices.back());
+			PackedVertexCount += Mesh.vVertices.size();
+			++Report.PackedMeshCount;
+		}
+		else
+		{
+			Report.PackedByteCount += sizeof(SVertex3D) * Mesh.vVertices.size();
+			vPackedVertices.pop_back();
+		}
+	}
+	Report.CompressionRatio = (Report.PackedByteCount) ? (float)Report.RawByteCount / (float)Report.PackedByteCount : 0.0f;
+
+	// Unpack throughput
+	if (PackedVertexCount)
+	{
+		vector<SVertex3D> vVertices{};
+		auto Start{ std::chrono::steady_clock::now() };
+		for (uint32_t iIteration = 0; iIteration < KUnpackBenchmarkIterationCount; ++iIteration)
+		{
+			for (const auto& PackedVertices : vPackedVertices)
+			{
+				Unpack(PackedVertices, vVertices);
+			}
+		}
+		auto End{ std::chrono::steady_clock::now() };
+
+		double Seconds{ std::chrono::duration<double>(End - Start).count() };
+		if (Seconds > 0.0) Report.UnpackedVerticesPerSecond = (double)PackedVertexCount * KUnpackBenchmarkIterationCount / Seconds;
+	}
+
+	return Report;
+}
+
+size_t CVertexPacker::GetPackedByteCount(const SPackedVertices& Packed)
+{
+	return sizeof(XMFLOAT3) * Packed.vPositions.size() + sizeof(SPackedVertexAttributes) * Packed.vAttributes.size() +
+		((Packed.bHasVertexColors) ? sizeof(uint32_t) * Packed.vColors.size() : sizeof(XMFLOAT4));
+}
+
+void CVertexPacker::EncodeOctahedral(const XMVECTOR& Direction, int16_t* const OutValues)
+{
+	XMFLOAT3 D{};
+	XMStoreFloat3(&D, Direction);
+
+	// Project onto the octahedron |x| + |y| + |z| = 1 and fold the lower half over the upper one
+	float L1Norm{ fabsf(D.x) + fabsf(D.y) + fabsf(D.z) };
+	if (L1Norm <= 0.0f)
+	{
+		OutValues[0] = OutValues[1] = 0;
+		return;
+	}
+	float X{ D.x / L1Norm };
+	float Y{ D.y / L1Norm };
+	if (D.z < 0.0f)
+	{
+		float FoldedX{ (1.0f - fabsf(Y)) * ((X >= 0.0f) ? +1.0f : -1.0f) };
+		float FoldedY{ (1.0f - fabsf(X)) * ((Y >= 0.0f) ? +1.0f : -1.0f) };
+		X = FoldedX;
+		Y = FoldedY;
+	}
+
+	OutValues[0] = (int16_t)roundf(max(min(X, 1.0f), -1.0f) * KSnorm16Max);
+	OutValues[1] = (int16_t)roundf(max(min(Y, 1.0f), -1.0f) * KSnorm16Max);
+}
+
+XMVECTOR CVertexPacker::DecodeOctahedral(const int16_t* const Values)
+{
+	float X{ max(Values[0] / KSnorm16Max, -1.0f) };
+	float Y{ max(Values[1] / KSnorm16Max, -1.0f) };
+	float Z{ 1.0f - fabsf(X) - fabsf(Y) };
+	if (Z < 0.0f)
+	{
+		float UnfoldedX{ (1.0f - fabsf(Y)) * ((X >= 0.0f) ? +1.0f : -1.0f) };
+		float UnfoldedY{ (1.0f - fabsf(X)) * ((Y >= 0.0f) ? +1.0f : -1.0f) };
+		X = UnfoldedX;
+		Y = UnfoldedY;
+	}
+	return XMVector3Normalize(XMVectorSet(X, Y, Z, 0.0f));
+}
+
+uint32_t CVertexPacker::PackColor(const XMVECTOR& Color)
+{
+	XMFLOAT4 C{};
+	XMStoreFloat4(&C, XMVectorSaturate(Color));
+	return (uint32_t)(C.x * 255.0f + 0.5f) | ((uint32_t)(C.y * 255.0f + 0.5f) << 8) |
+		((uint32_t)(C.z * 255.0f + 0.5f) << 16) | ((uint32_t)(C.w * 255.0f + 0.5f) << 24);
+}
+
+XMVECTOR CVertexPacker::UnpackColor(uint32_t Color)
+{
+	return XMVectorSet((float)(Color & 0xFF), (float)((Color >> 8) & 0xFF), (float)((Color >> 16) & 0xFF), (float)(Color >> 24)) / 255.0f;
+}
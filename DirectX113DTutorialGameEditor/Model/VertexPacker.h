@@ -0,0 +1,75 @@
+#pragma once
+
+#include "MeshPorter.h"
+
+// 12 bytes, every component is 16 bits
+struct SPackedVertexAttributes
+{
+	int16_t		Normal[2]{};	// octahedral (snorm16)
+	int16_t		Tangent[2]{};	// octahedral (snorm16)
+	uint16_t	TexCoord[2]{};	// half
+};
+
+// Vertices of one mesh in two streams: 12B position + 12B attributes per vertex (SVertex3D is 80B)
+// @important: colors are rarely used, so they are stored only if they vary within the mesh
+struct SPackedVertices
+{
+	std::vector<XMFLOAT3>					vPositions{};
+	std::vector<SPackedVertexAttributes>	vAttributes{};
+	bool									bHasVertexColors{};
+	XMFLOAT4								ConstantColor{};	// when !bHasVertexColors (exact)
+	std::vector<uint32_t>					vColors{};			// RGBA8 (UNORM, R in the lowest byte) when bHasVertexColors
+};
+
+class CVertexPacker
+{
+public:
+	struct SSettings
+	{
+		float	DirectionErrorBudget{ 0.001f };			// distance between the raw and the decoded normal/tangent
+		float	TexCoordErrorBudget{ 1.0f / 2048.0f };	// absolute per component, UVs in [-2, 2] fit in half precision
+		float	ColorErrorBudget{ 1.0f / 255.0f };		// absolute per component, colors must be in [0, 1]
+	};
+
+	struct SReport
+	{
+		size_t		RawByteCount{};
+		size_t		PackedByteCount{};
+		float		CompressionRatio{};
+		uint32_t	MeshCount{};
+		uint32_t	PackedMeshCount{};	// the others exceed the error budgets and are stored as they are
+		float		MaxDirectionError{};
+		float		MaxTexCoordError{};
+		float		MaxColorError{};
+		double		UnpackedVerticesPerSecond{};
+	};
+
+public:
+	CVertexPacker() {}
+	CVertexPacker(const SSettings& Settings) : m_Settings{ Settings } {}
+	~CVertexPacker() {}
+
+public:
+	// Returns false if any vertex doesn't round-trip within the error budgets,
+	// including the components the packed format drops (Position.w must be 1, TexCoord.zw, Normal.w and Tangent.w must be 0)
+	// PtrReport (optional): the max errors are accumulated
+	bool Pack(const std::vector<SVertex3D>& vVertices, SPackedVertices& OutPacked, SReport* const PtrReport = nullptr) const;
+	static void Unpack(const SPackedVertices& Packed, std::vector<SVertex3D>& vOutVertices);
+	SReport CreateReport(const SMESHData& MESHData) const;
+
+public:
+	static size_t GetPackedByteCount(const SPackedVertices& Packed);
+
+private:
+	static void EncodeOctahedral(const XMVECTOR& Direction, int16_t* const OutValues);
+	static XMVECTOR DecodeOctahedral(const int16_t* const Values);
+	static uint32_t PackColor(const XMVECTOR& Color);
+	static XMVECTOR UnpackColor(uint32_t Color);
+
+public:
+	static constexpr float KSnorm16Max{ 32767.0f };
+	static constexpr uint32_t KUnpackBenchmarkIterationCount{ 16 };
+
+private:
+	SSettings	m_Settings{};
+};
@@ -2,7 +2,6 @@
 #define __DEPENDENCY_HLSL__
 
 static const float4x4 KMatrixIdentity = float4x4(1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1);
-static const int KBoneMatrixMaxCount = 60;
 static const float4 KUpDirection = float4(0, 1, 0, 0);
 static const float K1DIVPI = 0.31831;
 static const float KPIDIV2 = 1.57079;
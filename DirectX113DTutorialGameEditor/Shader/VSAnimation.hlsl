@@ -1,20 +1,18 @@
 #include "Base.hlsli"
 #include "iVSCBs.hlsli"
 
-cbuffer cbBones : register(b1)
-{
-	float4x4 BoneMatrices[KBoneMatrixMaxCount]; // For CPU skinning
-}
-
-cbuffer cbAnimation : register(b2)
+cbuffer cbAnimation : register(b1)
 {
 	bool bUseGPUSkinning;
 	bool bIsInstanced;
 	uint g_AnimationID;
 	float g_AnimationTick;
+	uint g_BoneMatrixOffset;
+	float3 Pads;
 }
 
 Texture2D<float4> AnimationTexture : register(t0); // For GPU skinning
+StructuredBuffer<float4x4> BonePalettes : register(t1); // For CPU skinning (shared by every object, sub-allocated per object)
 
 float4x4 GetBoneMatrixFromAnimationTexture(int BoneIndex, int AnimationOffset)
 {
@@ -97,10 +95,10 @@ VS_OUTPUT main(VS_INPUT_ANIMATION Input)
 	}
 	else
 	{
-		FinalBone = BoneMatrices[Input.BoneIndex.x] * Input.BoneWeight.x;
-		FinalBone += BoneMatrices[Input.BoneIndex.y] * Input.BoneWeight.y;
-		FinalBone += BoneMatrices[Input.BoneIndex.z] * Input.BoneWeight.z;
-		FinalBone += BoneMatrices[Input.BoneIndex.w] * Input.BoneWeight.w;
+		FinalBone = BonePalettes[g_BoneMatrixOffset + Input.BoneIndex.x] * Input.BoneWeight.x;
+		FinalBone += BonePalettes[g_BoneMatrixOffset + Input.BoneIndex.y] * Input.BoneWeight.y;
+		FinalBone += BonePalettes[g_BoneMatrixOffset + Input.BoneIndex.z] * Input.BoneWeight.z;
+		FinalBone += BonePalettes[g_BoneMatrixOffset + Input.BoneIndex.w] * Input.BoneWeight.w;
 
 		Input.Position = float4(mul(Input.Position, FinalBone).xyz, 1);
 	}
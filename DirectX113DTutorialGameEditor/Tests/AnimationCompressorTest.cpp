@@ -0,0 +1,82 @@
+#include "Test.h"
+#include "../Model/AnimationCompressor.h"
+
+// Node animations with smooth positions (of Scale), turning rotations and constant scalings
+static SMeshAnimation MakeAnimation(float Scale)
+{
+	SMeshAnimation Animation{};
+	Animation.Name = "test";
+	Animation.Duration = 100.0f;
+	Animation.TicksPerSecond = 30.0f;
+	Animation.vNodeAnimations.resize(4);
+	for (uint32_t iNode = 0; iNode < (uint32_t)Animation.vNodeAnimations.size(); ++iNode)
+	{
+		auto& NodeAnimation{ Animation.vNodeAnimations[iNode] };
+		NodeAnimation.Index = iNode;
+		NodeAnimation.Name = "node" + std::to_string(iNode);
+		for (uint32_t iKey = 0; iKey <= 100; ++iKey)
+		{
+			const float KTime{ (float)iKey };
+			NodeAnimation.vPositionKeys.push_back({ KTime,
+				XMVectorSet(Scale * sinf(KTime * 0.1f + iNode), Scale * cosf(KTime * 0.07f), 0.5f * KTime / 100.0f * Scale, 0) });
+
+			const float KAngle{ KTime * 0.05f + iNode };
+			NodeAnimation.vRotationKeys.push_back({ KTime, XMVectorSet(0, sinf(KAngle * 0.5f), 0, cosf(KAngle * 0.5f)) });
+
+			NodeAnimation.vScalingKeys.push_back({ KTime, XMVectorSet(1, 1, 1, 0) });
+		}
+	}
+	return Animation;
+}
+
+TEST_CASE(AnimationCompressor_RoundTripsWithinTheBudget)
+{
+	CAnimationCompressor::SSettings Settings{};
+	CAnimationCompressor AnimationCompressor{ Settings };
+	const SMeshAnimation KAnimation{ MakeAnimation(1.0f) };
+
+	std::vector<SCompressedNodeAnimation> vNodeAnimations{};
+	AnimationCompressor.Compress(KAnimation, vNodeAnimations);
+	CHECK(vNodeAnimations.size() == KAnimation.vNodeAnimations.size());
+	for (const auto& NodeAnimation : vNodeAnimations)
+	{
+		CHECK(NodeAnimation.ScalingTrack.eType == SCompressedAnimationTrack::EType::Constant);
+		CHECK(NodeAnimation.RotationTrack.eType == SCompressedAnimationTrack::EType::Quantized);
+	}
+
+	SMeshAnimation Decompressed{};
+	AnimationCompressor.Decompress(vNodeAnimations, Decompressed);
+	CHECK(Decompressed.vNodeAnimations.size() == KAnimation.vNodeAnimations.size());
+	for (size_t iNode = 0; iNode < Decompressed.vNodeAnimations.size(); ++iNode)
+	{
+		CHECK(Decompressed.vNodeAnimations[iNode].Name == KAnimation.vNodeAnimations[iNode].Name);
+		CHECK(Decompressed.vNodeAnimations[iNode].Index == KAnimation.vNodeAnimations[iNode].Index);
+	}
+
+	const CAnimationCompressor::SReport KReport{ AnimationCompressor.CreateReport(KAnimation) };
+	CHECK(KReport.CompressedByteCount < KReport.RawByteCount / 4);
+	CHECK(KReport.ConstantTrackCount >= 4);
+	CHECK(KReport.RawTrackCount == 0);
+	CHECK(KReport.MaxBoneSpaceError <= Settings.PositionErrorBudget + Settings.RotationErrorBudget);
+}
+
+TEST_CASE(AnimationCompressor_KeepsRawKeysOverTheBudget)
+{
+	// 16-bit quantization of a 2000-unit range can't meet a 0.0005 budget
+	CAnimationCompressor::SSettings Settings{};
+	CAnimationCompressor AnimationCompressor{ Settings };
+	const SMeshAnimation KAnimation{ MakeAnimation(1000.0f) };
+
+	std::vector<SCompressedNodeAnimation> vNodeAnimations{};
+	AnimationCompressor.Compress(KAnimation, vNodeAnimations);
+	for (const auto& NodeAnimation : vNodeAnimations)
+	{
+		CHECK(NodeAnimation.PositionTrack.eType == SCompressedAnimationTrack::EType::Raw);
+		CHECK(NodeAnimation.PositionTrack.vRawValues.size() == NodeAnimation.PositionTrack.vTimes.size());
+	}
+
+	const CAnimationCompressor::SReport KReport{ AnimationCompressor.CreateReport(KAnimation) };
+	CHECK(KReport.RawTrackCount == 4);
+	CHECK(KReport.MaxBoneSpaceError <= Settings.PositionErrorBudget + Settings.RotationErrorBudget);
+	CHECK(KReport.CompressedByteCount == CAnimationCompressor::GetCompressedByteCount(vNodeAnimations));
+}
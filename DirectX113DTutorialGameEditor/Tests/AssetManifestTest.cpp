@@ -0,0 +1,140 @@
+#include "Test.h"
+#include "../Core/AssetManifest.h"
+#include <filesystem>
+#include <fstream>
+
+static std::string GetTemporaryFileName(const char* const Name)
+{
+	return (std::filesystem::temp_directory_path() / Name).string();
+}
+
+static void WriteFile(const std::string& FileName, const std::string& Content)
+{
+	std::ofstream File{ FileName, std::ofstream::binary | std::ofstream::trunc };
+	File << Content;
+}
+
+static void RemoveFiles(const std::vector<std::string>& vFileNames)
+{
+	std::error_code ErrorCode{};
+	for (const std::string& FileName : vFileNames) std::filesystem::remove(FileName, ErrorCode);
+}
+
+TEST_CASE(AssetManifest_HashesFileContents)
+{
+	const std::string KFileNameA{ GetTemporaryFileName("EditorTests_AssetManifest_A.fbx") };
+	const std::string KFileNameB{ GetTemporaryFileName("EditorTests_AssetManifest_B.fbx") };
+	WriteFile(KFileNameA, "mesh data");
+	WriteFile(KFileNameB, "mesh data");
+
+	// @important: the content is hashed, not the name nor the time, so a copy or a touched file hashes the same
+	bool bIsRead{};
+	const uint64_t KHash{ CAssetManifest::HashFile(KFileNameA, 3, bIsRead) };
+	CHECK(bIsRead);
+	CHECK(CAssetManifest::HashFile(KFileNameB, 3, bIsRead) == KHash && bIsRead);
+	CHECK(CAssetManifest::HashFile(KFileNameA, 4, bIsRead) != KHash);
+
+	WriteFile(KFileNameB, "mesh datA");
+	CHECK(CAssetManifest::HashFile(KFileNameB, 3, bIsRead) != KHash);
+
+	// Empty files are assets too, missing ones aren't read
+	WriteFile(KFileNameB, "");
+	CAssetManifest::HashFile(KFileNameB, 3, bIsRead);
+	CHECK(bIsRead);
+	CAssetManifest::HashFile(KFileNameB + ".missing", 3, bIsRead);
+	CHECK(!bIsRead);
+
+	RemoveFiles({ KFileNameA, KFileNameB });
+}
+
+TEST_CASE(AssetManifest_SkipsUpToDateOutputs)
+{
+	static constexpr uint32_t KCookerVersion{ 3 };
+	const std::string KSourceFileName{ GetTemporaryFileName("EditorTests_AssetManifest_Source.fbx") };
+	const std::string KOutputFileName{ GetTemporaryFileName("EditorTests_AssetManifest_Source.MESH") };
+	const std::string KManifestFileName{ GetTemporaryFileName("EditorTests_AssetManifest.manifest") };
+	const std::string KKey{ "Source.MESH" };
+	RemoveFiles({ KOutputFileName, KManifestFileName });
+	WriteFile(KSourceFileName, "version 1");
+
+	// As CAssetCooker::Cook() does: load the manifest, hash every source, cook what isn't up to date, then record it
+	auto Cook{ [&]()
+	{
+		CAssetManifest Manifest{};
+		Manifest.Load(KManifestFileName, KCookerVersion);
+
+		bool bIsRead{};
+		const uint64_t KHash{ CAssetManifest::HashFile(KSourceFileName, KCookerVersion, bIsRead) };
+		CHECK(bIsRead);
+		if (Manifest.IsUpToDate(KKey, KHash, KOutputFileName)) return false;
+
+		WriteFile(KOutputFileName, "cooked");
+		Manifest.Set(KKey, KHash);
+		CHECK(Manifest.Save(KManifestFileName, KCookerVersion));
+		return true;
+	} };
+
+	CHECK(Cook());
+	CHECK(!Cook());
+	CHECK(!Cook());
+
+	// @important: a changed source is cooked again, an unchanged one (only rewritten) isn't
+	WriteFile(KSourceFileName, "version 2");
+	CHECK(Cook());
+	WriteFile(KSourceFileName, "version 2");
+	CHECK(!Cook());
+
+	// A deleted output is cooked again
+	RemoveFiles({ KOutputFileName });
+	CHECK(Cook());
+	CHECK(!Cook());
+
+	// So is everything after the cooker version changes
+	CAssetManifest Manifest{};
+	CHECK(Manifest.Load(KManifestFileName, KCookerVersion));
+	CHECK(Manifest.GetEntryCount() == 1);
+	CHECK(!Manifest.Load(KManifestFileName, KCookerVersion + 1));
+	CHECK(Manifest.GetEntryCount() == 0);
+
+	// And after a failure, as failed assets are removed from the manifest
+	CHECK(Manifest.Load(KManifestFileName, KCookerVersion));
+	Manifest.Remove(KKey);
+	CHECK(Manifest.Save(KManifestFileName, KCookerVersion));
+	CHECK(Cook());
+	CHECK(!Cook());
+
+	RemoveFiles({ KSourceFileName, KOutputFileName, KManifestFileName });
+}
+
+TEST_CASE(AssetManifest_RoundTripsAndRejectsDamagedFiles)
+{
+	const std::string KManifestFileName{ GetTemporaryFileName("EditorTests_AssetManifest_RoundTrip.manifest") };
+
+	CAssetManifest Manifest{};
+	Manifest.Set("a.MESH", 1);
+	Manifest.Set("textures/b.dds", 0xFEDCBA9876543210);
+	Manifest.Set("", 7);
+	Manifest.Set("a.MESH", 2);
+	CHECK(Manifest.GetEntryCount() == 3);
+	CHECK(Manifest.Save(KManifestFileName, 1));
+	CHECK(!std::filesystem::exists(KManifestFileName + ".tmp"));
+
+	CAssetManifest Loaded{};
+	CHECK(Loaded.Load(KManifestFileName, 1));
+	CHECK(Loaded.GetEntryCount() == 3);
+	CHECK(Loaded.IsUpToDate("a.MESH", 2, KManifestFileName));
+	CHECK(!Loaded.IsUpToDate("a.MESH", 1, KManifestFileName));
+	CHECK(Loaded.IsUpToDate("textures/b.dds", 0xFEDCBA9876543210, KManifestFileName));
+	CHECK(Loaded.IsUpToDate("", 7, KManifestFileName));
+	CHECK(!Loaded.IsUpToDate("c.MESH", 2, KManifestFileName));
+
+	// @important: a truncated manifest is dropped as a whole, so that nothing is skipped by mistake
+	const uintmax_t KByteCount{ std::filesystem::file_size(KManifestFileName) };
+	std::filesystem::resize_file(KManifestFileName, KByteCount - 1);
+	CHECK(!Loaded.Load(KManifestFileName, 1));
+	CHECK(Loaded.GetEntryCount() == 0);
+
+	RemoveFiles({ KManifestFileName });
+	CHECK(!Loaded.Load(KManifestFileName, 1));
+	CHECK(Loaded.GetEntryCount() == 0);
+}
@@ -0,0 +1,380 @@
+#ifdef _WIN32
+#include "../Model/AnimationCompressor.h"
+#include "../Model/PoseEvaluator.h"
+#include "../Core/SceneContainer.h"
+#endif
+#ifdef EDITOR_HAS_DIRECTXMATH
+#include "../Core/FrustumCuller.h"
+#include "../Core/LightClusterBuilder.h"
+#include "../Core/MeshSimplifier.h"
+#include "../Core/OcclusionCuller.h"
+#endif
+#include "../Core/DirtyRangeTracker.h"
+#include "../Core/DrawPacket.h"
+#include "../Core/LZCodec.h"
+#include "../Core/StateCache.h"
+#include "../Core/TaskScheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+// Throughput of the CPU modules, so that changes to them can be measured without the editor
+// Usage: EditorBench [files to compress...]
+
+static double GetSecondsSince(const std::chrono::steady_clock::time_point& StartTimePoint)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - StartTimePoint).count();
+}
+
+static void BenchLZFile(const std::string& FileName)
+{
+	SLZBenchmark Benchmark{};
+	if (!CLZCodec::MeasureFile(FileName, 8, Benchmark))
+	{
+		printf("LZ %s: can't be read or doesn't round-trip\n", FileName.c_str());
+		return;
+	}
+	printf("LZ %s: %llu -> %llu bytes (x%.2f), encode %.1f MB/s, decode %.2f GB/s\n", FileName.c_str(),
+		(unsigned long long)Benchmark.RawByteCount, (unsigned long long)Benchmark.CompressedByteCount, Benchmark.Ratio,
+		Benchmark.EncodeMBps, Benchmark.DecodeGBps);
+}
+
+static void BenchLZ()
+{
+	// 16MB of smooth floats, like the vertices of the MESH files
+	std::vector<float> vFloats(4 * 1024 * 1024);
+	for (size_t iFloat = 0; iFloat < vFloats.size(); ++iFloat)
+	{
+		vFloats[iFloat] = sinf((float)(iFloat / 4) * 0.001f) * 100.0f + (float)(iFloat % 4);
+	}
+
+	const std::string KFileName{ (std::filesystem::temp_directory_path() / "EditorBench_LZ.bin").string() };
+	{
+		std::ofstream File{ KFileName, std::ofstream::binary | std::ofstream::trunc };
+		File.write((const char*)vFloats.data(), (std::streamsize)(vFloats.size() * sizeof(float)));
+	}
+	BenchLZFile(KFileName);
+
+	std::error_code ErrorCode{};
+	std::filesystem::remove(KFileName, ErrorCode);
+}
+
+static void BenchDrawPacketSort()
+{
+	// The same measurement as the editor's sort benchmark button
+	static constexpr uint32_t KPacketCount{ 200'000 };
+	static constexpr uint32_t KIterationCount{ 10 };
+
+	const double KMicroseconds{ CDrawPacketQueue::MeasureSortTime(KPacketCount, KIterationCount) };
+	printf("DrawPacket: sorted %u packets in %.3f ms (%.1f M packets/s)\n", KPacketCount, KMicroseconds / 1'000.0,
+		KPacketCount / KMicroseconds);
+}
+
+static void BenchTaskScheduler()
+{
+	static constexpr uint32_t KBatchCount{ 2000 };
+	static constexpr uint32_t KTaskCount{ 16 };
+
+	// Empty tasks, so that only the cost of scheduling a batch is measured (the workers are kept between batches)
+	CTaskScheduler TaskScheduler{};
+	auto StartTimePoint{ std::chrono::steady_clock::now() };
+	for (uint32_t iBatch = 0; iBatch < KBatchCount; ++iBatch)
+	{
+		TaskScheduler.Reset();
+		for (uint32_t iTask = 0; iTask < KTaskCount; ++iTask) TaskScheduler.AddTask([] {});
+		TaskScheduler.Start();
+		TaskScheduler.Wait(true);
+	}
+	printf("TaskScheduler: %.2f us per batch of %u tasks\n", GetSecondsSince(StartTimePoint) * 1'000'000.0 / KBatchCount, KTaskCount);
+}
+
+static void BenchDirtyRangeTracker()
+{
+	static constexpr uint32_t KIterationCount{ 1000 };
+	static constexpr uint32_t KMarkCount{ 1000 };
+
+	CDirtyRangeTracker DirtyRangeTracker{};
+	size_t RangeCount{};
+	uint32_t Seed{ 1 };
+	auto StartTimePoint{ std::chrono::steady_clock::now() };
+	for (uint32_t iIteration = 0; iIteration < KIterationCount; ++iIteration)
+	{
+		DirtyRangeTracker.Clear();
+		for (uint32_t iMark = 0; iMark < KMarkCount; ++iMark)
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			DirtyRangeTracker.MarkDirty((Seed >> 8) % 100000);
+		}
+		RangeCount += DirtyRangeTracker.Coalesce(16).size();
+	}
+	printf("DirtyRangeTracker: %.2f us per %u random marks coalesced (%zu ranges)\n",
+		GetSecondsSince(StartTimePoint) * 1'000'000.0 / KIterationCount, KMarkCount, RangeCount / KIterationCount);
+}
+
+static void BenchStateCacheHash()
+{
+	static constexpr uint32_t KIterationCount{ 100000 };
+
+	// A constant buffer of 256 bytes
+	uint8_t Bytes[256]{};
+	uint64_t Hash{};
+	auto StartTimePoint{ std::chrono::steady_clock::now() };
+	for (uint32_t iIteration = 0; iIteration < KIterationCount; ++iIteration)
+	{
+		Bytes[0] = (uint8_t)iIteration;
+		Hash ^= CStateCache::Hash(Bytes, sizeof(Bytes));
+	}
+	const double KSeconds{ GetSecondsSince(StartTimePoint) };
+	printf("StateCache::Hash: %.1f ns per 256B (%.2f GB/s) [%llx]\n", KSeconds * 1'000'000'000.0 / KIterationCount,
+		(double)sizeof(Bytes) * KIterationCount / KSeconds / (1024.0 * 1024.0 * 1024.0), (unsigned long long)(Hash & 0xF));
+}
+
+#ifdef EDITOR_HAS_DIRECTXMATH
+static void BenchFrustumCuller()
+{
+	static constexpr uint32_t KSphereCount{ 100'000 };
+	static constexpr uint32_t KIterationCount{ 100 };
+
+	// A 90 degree view down +z (near 1, far 500) over instances scattered in [-500, 500]^3
+	const DirectX::XMVECTOR KPlanes[6]
+	{
+		DirectX::XMVectorSet(0, 0, -1, 1), DirectX::XMVectorSet(0, 0, 1, -500),
+		DirectX::XMVectorSet(1, 0, -1, 0), DirectX::XMVectorSet(-1, 0, -1, 0),
+		DirectX::XMVectorSet(0, 1, -1, 0), DirectX::XMVectorSet(0, -1, -1, 0),
+	};
+	CFrustumCuller FrustumCuller{};
+	FrustumCuller.SetPlanes(KPlanes, 6);
+
+	std::vector<DirectX::XMFLOAT4> vSpheres(KSphereCount);
+	uint32_t Seed{ 1 };
+	auto Random{ [&Seed]() { Seed = Seed * 1664525u + 1013904223u; return (float)(Seed >> 8) / (float)(1 << 24); } };
+	for (auto& Sphere : vSpheres)
+	{
+		Sphere = DirectX::XMFLOAT4(Random() * 1000.0f - 500.0f, Random() * 1000.0f - 500.0f, Random() * 1000.0f - 500.0f, 1.0f + Random() * 4.0f);
+	}
+
+	std::vector<uint32_t> vVisibleIndices{};
+	vVisibleIndices.reserve(KSphereCount);
+	uint32_t VisibleCount{};
+	auto StartTimePoint{ std::chrono::steady_clock::now() };
+	for (uint32_t iIteration = 0; iIteration < KIterationCount; ++iIteration)
+	{
+		vVisibleIndices.clear();
+		VisibleCount = FrustumCuller.Cull(vSpheres.data(), KSphereCount, vVisibleIndices);
+	}
+	const double KBatchedSeconds{ GetSecondsSince(StartTimePoint) / KIterationCount };
+
+	// One sphere at a time, like the loop Cull() replaces
+	uint32_t ScalarVisibleCount{};
+	StartTimePoint = std::chrono::steady_clock::now();
+	for (uint32_t iIteration = 0; iIteration < KIterationCount; ++iIteration)
+	{
+		ScalarVisibleCount = 0;
+		for (const auto& Sphere : vSpheres) ScalarVisibleCount += (FrustumCuller.IsVisible(Sphere)) ? 1 : 0;
+	}
+	const double KScalarSeconds{ GetSecondsSince(StartTimePoint) / KIterationCount };
+
+	printf("FrustumCuller: %u of %u spheres visible (%s), 4-wide %.3f ms (%.1f M spheres/s), one at a time %.3f ms (x%.2f)\n",
+		VisibleCount, KSphereCount, (VisibleCount == ScalarVisibleCount) ? "match" : "MISMATCH", KBatchedSeconds * 1'000.0,
+		KSphereCount / KBatchedSeconds / 1'000'000.0, KScalarSeconds * 1'000.0, KScalarSeconds / KBatchedSeconds);
+}
+
+static void BenchLightClusterBuilder()
+{
+	// The same measurement as the editor's light cluster button: 4096 lights on a 1080p grid
+	static constexpr uint32_t KLightCount{ 4096 };
+	static constexpr uint32_t KIterationCount{ 10 };
+
+	const double KMicroseconds{ CLightClusterBuilder::MeasureBuildTime(KLightCount, KIterationCount) };
+	printf("LightClusterBuilder: %u lights on a 1920x1080 grid in %.3f ms (%.1f M lights/s)\n", KLightCount, KMicroseconds / 1'000.0,
+		KLightCount / KMicroseconds);
+}
+
+static void BenchOcclusionCuller()
+{
+	// The same measurements as the editor's occlusion button: 256 box occluders, then 10k boxes tested against them
+	static constexpr uint32_t KOccluderCount{ 256 };
+	static constexpr uint32_t KBoxCount{ 10'000 };
+	static constexpr uint32_t KIterationCount{ 10 };
+
+	const double KSingleThreadMicroseconds{ COcclusionCuller::MeasureRasterizationTime(KOccluderCount, KIterationCount, 1) };
+	const double KMicroseconds{ COcclusionCuller::MeasureRasterizationTime(KOccluderCount, KIterationCount) };
+	printf("OcclusionCuller: rasterized %u occluders (%u triangles) in %.3f ms on 1 thread, %.3f ms on %u threads\n", KOccluderCount,
+		KOccluderCount * 12, KSingleThreadMicroseconds / 1'000.0, KMicroseconds / 1'000.0, std::max(std::thread::hardware_concurrency(), 1u));
+
+	const double KTestMicroseconds{ COcclusionCuller::MeasureTestTime(KBoxCount, KIterationCount) };
+	printf("OcclusionCuller: tested %u boxes in %.3f ms (%.1f M boxes/s)\n", KBoxCount, KTestMicroseconds / 1'000.0, KBoxCount / KTestMicroseconds);
+}
+
+static void BenchMeshSimplifier()
+{
+	// The same measurement as the editor's grid simplification button (the assets are measured by the editor, see -measure-mesh-lods)
+	static constexpr uint32_t KGridSize{ 128 };
+	static constexpr uint32_t KIterationCount{ 3 };
+
+	const uint32_t KTriangleCount{ (KGridSize - 1) * (KGridSize - 1) * 2 };
+	const double KMicroseconds{ CMeshSimplifier::MeasureSimplifyTime(KGridSize, KIterationCount) };
+	printf("MeshSimplifier: %u -> %u triangles in %.3f ms (%.0f K triangles/s)\n", KTriangleCount, KTriangleCount / 4,
+		KMicroseconds / 1'000.0, KTriangleCount / KMicroseconds * 1'000.0);
+}
+#endif
+
+#ifdef _WIN32
+static void BenchAnimationDecode()
+{
+	static constexpr uint32_t KNodeCount{ 64 };
+	static constexpr uint32_t KKeyCount{ 300 };
+
+	// 10 seconds of 64 bones keyed on every tick (30 ticks per second)
+	SMeshAnimation Animation{};
+	Animation.Name = "bench";
+	Animation.Duration = (float)(KKeyCount - 1);
+	Animation.TicksPerSecond = 30.0f;
+	Animation.vNodeAnimations.resize(KNodeCount);
+	for (uint32_t iNode = 0; iNode < KNodeCount; ++iNode)
+	{
+		auto& NodeAnimation{ Animation.vNodeAnimations[iNode] };
+		NodeAnimation.Index = iNode;
+		NodeAnimation.Name = "node" + std::to_string(iNode);
+		for (uint32_t iKey = 0; iKey < KKeyCount; ++iKey)
+		{
+			const float KTime{ (float)iKey };
+			const float KAngle{ sinf(KTime * 0.03f + iNode) };
+			NodeAnimation.vPositionKeys.push_back({ KTime, XMVectorSet(sinf(KTime * 0.1f + iNode), cosf(KTime * 0.07f), 0.01f * KTime, 0) });
+			NodeAnimation.vRotationKeys.push_back({ KTime, XMVectorSet(0, sinf(KAngle * 0.5f), 0, cosf(KAngle * 0.5f)) });
+			NodeAnimation.vScalingKeys.push_back({ KTime, XMVectorSet(1, 1, 1, 0) });
+		}
+	}
+
+	// @important: CreateReport() decodes the compressed clip KDecodeBenchmarkIterationCount times
+	auto StartTimePoint{ std::chrono::steady_clock::now() };
+	const CAnimationCompressor::SReport KReport{ CAnimationCompressor().CreateReport(Animation) };
+	printf("AnimationCompressor: %zu -> %zu bytes (x%.2f), %u of %u keys kept, decode %.1f M keys/s (report %.1f ms)\n",
+		KReport.RawByteCount, KReport.CompressedByteCount, KReport.CompressionRatio, KReport.CompressedKeyCount, KReport.RawKeyCount,
+		KReport.DecodedKeysPerSecond / 1'000'000.0, GetSecondsSince(StartTimePoint) * 1'000.0);
+}
+
+static void BenchPoseEvaluation()
+{
+	static constexpr uint32_t KBoneCount{ 64 };
+	static constexpr uint32_t KKeyCount{ 60 };
+	static constexpr uint32_t KIterationCount{ 10'000 };
+
+	// A non-bone root and a binary tree of bones, every bone keyed by 2 animations
+	SMESHData Model{};
+	Model.vTreeNodes.resize(KBoneCount + 1);
+	Model.vTreeNodes[0].Name = "root";
+	Model.vTreeNodes[0].ParentNodeIndex = -1;
+	Model.vTreeNodes[0].MatrixTransformation = XMMatrixIdentity();
+	for (uint32_t iBone = 0; iBone < KBoneCount; ++iBone)
+	{
+		SMeshTreeNode& Node{ Model.vTreeNodes[iBone + 1] };
+		Node.Index = (int32_t)iBone + 1;
+		Node.Name = "bone" + std::to_string(iBone);
+		Node.ParentNodeIndex = (iBone == 0) ? 0 : (int32_t)((iBone - 1) / 2 + 1);
+		Node.MatrixTransformation = XMMatrixTranslation(0, 1, 0);
+		Node.bIsBone = true;
+		Node.BoneIndex = iBone;
+		Node.MatrixBoneOffset = XMMatrixTranslation(0, -(float)iBone, 0);
+		Model.vTreeNodes[Node.ParentNodeIndex].vChildNodeIndices.emplace_back(Node.Index);
+	}
+	Model.vAnimations.resize(2);
+	for (uint32_t iAnimation = 0; iAnimation < 2; ++iAnimation)
+	{
+		SMeshAnimation& Animation{ Model.vAnimations[iAnimation] };
+		Animation.Name = "bench" + std::to_string(iAnimation);
+		Animation.Duration = (float)(KKeyCount - 1);
+		Animation.TicksPerSecond = 30.0f;
+		Animation.vNodeAnimations.resize(KBoneCount);
+		for (uint32_t iBone = 0; iBone < KBoneCount; ++iBone)
+		{
+			auto& NodeAnimation{ Animation.vNodeAnimations[iBone] };
+			NodeAnimation.Index = iBone;
+			NodeAnimation.Name = Model.vTreeNodes[iBone + 1].Name;
+			Animation.umapNodeAnimationNameToIndex[NodeAnimation.Name] = iBone;
+			for (uint32_t iKey = 0; iKey < KKeyCount; ++iKey)
+			{
+				const float KTime{ (float)iKey };
+				const float KAngle{ sinf(KTime * 0.1f + iBone + iAnimation) };
+				NodeAnimation.vPositionKeys.push_back({ KTime, XMVectorSet(0, 1, 0.01f * KTime, 0) });
+				NodeAnimation.vRotationKeys.push_back({ KTime, XMVectorSet(sinf(KAngle * 0.5f), 0, 0, cosf(KAngle * 0.5f)) });
+				NodeAnimation.vScalingKeys.push_back({ KTime, XMVectorSet(1, 1, 1, 0) });
+			}
+		}
+	}
+
+	CPoseEvaluator PoseEvaluator{};
+	PoseEvaluator.Initialize(Model);
+
+	// The layer mask covers half of the tree, like an upper body layer
+	std::vector<float> vLayerMaskWeights(Model.vTreeNodes.size());
+	for (size_t iNode = 0; iNode < vLayerMaskWeights.size(); ++iNode)
+	{
+		vLayerMaskWeights[iNode] = (iNode % 2) ? 1.0f : 0.0f;
+	}
+
+	// @important: a tick between keys, so that every key is interpolated
+	double UnblendedMicroseconds{};
+	double BlendedMicroseconds{};
+	PoseEvaluator.MeasurePoseEvaluationTime(0, 1, 12.5f, &vLayerMaskWeights, KIterationCount, UnblendedMicroseconds, BlendedMicroseconds);
+	printf("PoseEvaluator: %u bones, unblended %.2f us, crossfade + layer %.2f us (x%.2f)\n", KBoneCount, UnblendedMicroseconds, BlendedMicroseconds,
+		BlendedMicroseconds / UnblendedMicroseconds);
+}
+
+static void BenchIncrementalSave()
+{
+	static constexpr uint32_t KObjectCount{ 64 };
+	static constexpr size_t KObjectByteCount{ 64 * 1024 };
+
+	// The save latency of the editor (see -measure-scene-save) on a smaller scene: a few moved objects against a full save
+	const std::string KFileName{ (std::filesystem::temp_directory_path() / "EditorBench_IncrementalSave.scene").string() };
+	for (bool bShouldCompress : { false, true })
+	{
+		std::vector<CSceneContainer::SIncrementalSaveBenchmark> vBenchmarks{};
+		if (!CSceneContainer::MeasureIncrementalSaveTime(KFileName, KObjectCount, KObjectByteCount, { 0, 1, 4, 16, KObjectCount },
+			bShouldCompress, vBenchmarks))
+		{
+			printf("SceneContainer: can't save %s\n", KFileName.c_str());
+			return;
+		}
+		for (const auto& Benchmark : vBenchmarks)
+		{
+			printf("SceneContainer (%s): %u of %u objects changed, save %.2f ms (full: %.2f ms)%s\n",
+				(bShouldCompress) ? "compressed" : "uncompressed", Benchmark.DirtyChunkCount, KObjectCount, Benchmark.Milliseconds,
+				Benchmark.FullMilliseconds, (Benchmark.bIsIdentical) ? "" : " DIFFERENT");
+		}
+	}
+}
+#endif
+
+int main(int argc, char** argv)
+{
+	if (argc > 1)
+	{
+		for (int iArgument = 1; iArgument < argc; ++iArgument) BenchLZFile(argv[iArgument]);
+		return 0;
+	}
+
+	BenchLZ();
+	BenchDrawPacketSort();
+	BenchTaskScheduler();
+	BenchDirtyRangeTracker();
+	BenchStateCacheHash();
+#ifdef EDITOR_HAS_DIRECTXMATH
+	BenchFrustumCuller();
+	BenchLightClusterBuilder();
+	BenchOcclusionCuller();
+	BenchMeshSimplifier();
+#endif
+#ifdef _WIN32
+	BenchAnimationDecode();
+	BenchPoseEvaluation();
+	BenchIncrementalSave();
+#endif
+	return 0;
+}
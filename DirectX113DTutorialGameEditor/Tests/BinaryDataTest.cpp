@@ -0,0 +1,152 @@
+#include "Test.h"
+#include "../Core/BinaryData.h"
+#include "../Model/ObjectTypes.h"
+#include <filesystem>
+#include <cstring>
+
+// Vertices with distinct values in every component, so that a shifted or swapped element can't compare equal
+static std::vector<SVertex3D> MakeVertices(uint32_t Count)
+{
+	std::vector<SVertex3D> vVertices{};
+	for (uint32_t iVertex = 0; iVertex < Count; ++iVertex)
+	{
+		const float KValue{ (float)iVertex };
+		SVertex3D Vertex{ XMVectorSet(KValue, KValue + 0.25f, -KValue, 1), XMVectorSet(0.5f, KValue / Count, 1, 1),
+			XMVectorSet(KValue / Count, 1 - KValue / Count, 0, 0) };
+		Vertex.Normal = XMVectorSet(0, 1, 0, 0);
+		Vertex.Tangent = XMVectorSet(1, 0, KValue, 0);
+		vVertices.emplace_back(Vertex);
+	}
+	return vVertices;
+}
+
+TEST_CASE(BinaryData_ArraysRoundTrip)
+{
+	const std::vector<SVertex3D> KVertices{ MakeVertices(81) };
+	std::vector<STriangle> vTriangles{};
+	std::vector<SAnimationVertex> vAnimationVertices(KVertices.size());
+	std::vector<uint16_t> vHalfs{};
+	std::vector<uint32_t> vColors{};
+	for (uint32_t iVertex = 0; iVertex < (uint32_t)KVertices.size(); ++iVertex)
+	{
+		if (iVertex + 2 < (uint32_t)KVertices.size()) vTriangles.emplace_back(iVertex, iVertex + 1, iVertex + 2);
+		vAnimationVertices[iVertex].BoneIDs[0] = iVertex % 60;
+		vAnimationVertices[iVertex].BoneIDs[1] = (iVertex + 1) % 60;
+		vAnimationVertices[iVertex].Weights[0] = 0.75f;
+		vAnimationVertices[iVertex].Weights[1] = 0.25f;
+		vHalfs.emplace_back((uint16_t)(0x3C00 + iVertex));
+		vColors.emplace_back(0xFF000000 | iVertex);
+	}
+
+	// As the MESH arrays are written (see CMeshPorter::WriteMESHData()): a count, then the elements with one copy
+	CBinaryData Writer{};
+	Writer.WriteUint32((uint32_t)KVertices.size());
+	Writer.WriteArray(KVertices);
+	Writer.WriteArray(vAnimationVertices);
+	Writer.WriteUint32((uint32_t)vTriangles.size());
+	Writer.WriteArray(vTriangles);
+	Writer.WriteArray(vHalfs, 2);
+	Writer.WriteArray(vColors, 1);
+	Writer.WriteArray(std::vector<STriangle>{}); // writes nothing
+	CHECK(Writer.GetBytes().size() == sizeof(uint32_t) * 2 +
+		(sizeof(SVertex3D) + sizeof(SAnimationVertex) + sizeof(uint16_t) + sizeof(uint32_t)) * KVertices.size() +
+		sizeof(STriangle) * vTriangles.size());
+
+	CBinaryData Reader{};
+	Reader.SetReadView(Writer.GetBytes().data(), Writer.GetBytes().size());
+	uint32_t VertexCount{};
+	uint32_t TriangleCount{};
+	std::vector<SVertex3D> vReadVertices{};
+	std::vector<SAnimationVertex> vReadAnimationVertices{};
+	std::vector<STriangle> vReadTriangles{};
+	std::vector<uint16_t> vReadHalfs{};
+	std::vector<uint32_t> vReadColors{};
+	CHECK(Reader.ReadUint32(VertexCount) && VertexCount == KVertices.size());
+	CHECK(Reader.ReadArray(vReadVertices, VertexCount));
+	CHECK(Reader.ReadArray(vReadAnimationVertices, VertexCount));
+	CHECK(Reader.ReadUint32(TriangleCount) && TriangleCount == vTriangles.size());
+	CHECK(Reader.ReadArray(vReadTriangles, TriangleCount));
+	CHECK(Reader.ReadArray(vReadHalfs, VertexCount, 2));
+	CHECK(Reader.ReadArray(vReadColors, VertexCount, 1));
+	CHECK(Reader.GetRemainingByteCount() == 0);
+
+	CHECK(vReadVertices.size() == KVertices.size() &&
+		memcmp(vReadVertices.data(), KVertices.data(), sizeof(SVertex3D) * KVertices.size()) == 0);
+	CHECK(vReadAnimationVertices.size() == vAnimationVertices.size() &&
+		memcmp(vReadAnimationVertices.data(), vAnimationVertices.data(), sizeof(SAnimationVertex) * vAnimationVertices.size()) == 0);
+	CHECK(vReadTriangles.size() == vTriangles.size() &&
+		memcmp(vReadTriangles.data(), vTriangles.data(), sizeof(STriangle) * vTriangles.size()) == 0);
+	CHECK(vReadHalfs == vHalfs);
+	CHECK(vReadColors == vColors);
+
+	// An empty array needs no bytes
+	std::vector<STriangle> vEmptyTriangles{ STriangle(1, 2, 3) };
+	CHECK(Reader.ReadArray(vEmptyTriangles, 0));
+	CHECK(vEmptyTriangles.empty());
+
+	// @important: not enough bytes left, and the reader doesn't move
+	Reader.SetReadView(Writer.GetBytes().data(), sizeof(STriangle) * 2 - 1);
+	std::vector<STriangle> vMissingTriangles{ STriangle(1, 2, 3) };
+	CHECK(!Reader.ReadArray(vMissingTriangles, 2));
+	CHECK(vMissingTriangles.empty());
+	CHECK(Reader.GetRemainingByteCount() == sizeof(STriangle) * 2 - 1);
+	CHECK(Reader.ReadArray(vMissingTriangles, 1));
+}
+
+TEST_CASE(BinaryData_ArraysAreLittleEndian)
+{
+	// @important: files are little-endian whatever the host, element by element
+	CBinaryData Writer{};
+	Writer.WriteArray(std::vector<uint32_t>{ 0x04030201, 0x08070605 });
+	Writer.WriteArray(std::vector<uint16_t>{ 0x0A09 }, 2);
+	Writer.WriteArray(std::vector<STriangle>{ STriangle(0x0E0D0C0B, 0x1211100F, 0x16151413) });
+	const std::vector<byte> KExpectedBytes{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22 };
+	CHECK(Writer.GetBytes() == KExpectedBytes);
+
+	CBinaryData Reader{};
+	Reader.SetReadView(KExpectedBytes.data(), KExpectedBytes.size());
+	uint32_t Value{};
+	CHECK(Reader.ReadUint32(Value) && Value == 0x04030201);
+	std::vector<uint32_t> vValues{};
+	CHECK(Reader.ReadArray(vValues, 1) && vValues[0] == 0x08070605);
+	std::vector<uint16_t> vShorts{};
+	CHECK(Reader.ReadArray(vShorts, 1, 2) && vShorts[0] == 0x0A09);
+	STriangle Triangle{};
+	CHECK(Reader.ReadArray(&Triangle, 1));
+	CHECK(Triangle.I0 == 0x0E0D0C0B && Triangle.I1 == 0x1211100F && Triangle.I2 == 0x16151413);
+}
+
+TEST_CASE(BinaryData_CompressedFilesRoundTrip)
+{
+	const std::vector<SVertex3D> KVertices{ MakeVertices(1024) };
+	const std::string KFileName{ (std::filesystem::temp_directory_path() / "EditorTests_BinaryData.bin").string() };
+
+	for (bool bShouldCompress : { false, true })
+	{
+		CBinaryData Writer{};
+		Writer.WriteString("KJW_TEST", 8);
+		Writer.WriteUint32((uint32_t)KVertices.size());
+		Writer.WriteArray(KVertices);
+		const std::vector<byte> KBytes{ Writer.GetBytes() };
+		CHECK(Writer.SaveToFile(KFileName, bShouldCompress));
+
+		CMappedFile MappedFile{};
+		CHECK(MappedFile.Open(KFileName));
+		CHECK(CLZCodec::IsCompressed(MappedFile.GetData(), MappedFile.GetSize()) == bShouldCompress);
+		if (bShouldCompress) CHECK(MappedFile.GetSize() < KBytes.size());
+		MappedFile.Close();
+
+		// @important: compressed or not, a file reads the same through both loads
+		for (bool bShouldMap : { false, true })
+		{
+			CBinaryData Reader{};
+			CHECK((bShouldMap) ? Reader.LoadFromMappedFile(KFileName) : Reader.LoadFromFile(KFileName));
+			CHECK(Reader.GetRemainingByteCount() == KBytes.size());
+			std::vector<byte> vReadBytes{};
+			CHECK(Reader.ReadBytes(KBytes.size(), vReadBytes) && vReadBytes == KBytes);
+		}
+	}
+
+	std::error_code ErrorCode{};
+	std::filesystem::remove(KFileName, ErrorCode);
+}
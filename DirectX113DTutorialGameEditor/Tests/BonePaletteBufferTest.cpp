@@ -0,0 +1,86 @@
+#include "Test.h"
+#include "../Core/BonePaletteBuffer.h"
+
+// Distinct values per (object, bone, element), so that any misplaced element shows up
+static XMMATRIX MakeBoneMatrix(uint32_t iObject, uint32_t iBone)
+{
+	const float KBase{ (float)(iObject * 1000 + iBone * 20) };
+	XMFLOAT4X4 Matrix{};
+	for (int iRow = 0; iRow < 4; ++iRow)
+	{
+		for (int iColumn = 0; iColumn < 4; ++iColumn)
+		{
+			Matrix.m[iRow][iColumn] = KBase + (float)(iRow * 4 + iColumn);
+		}
+	}
+	return XMLoadFloat4x4(&Matrix);
+}
+
+TEST_CASE(BonePaletteBuffer_PacksPalettesBackToBack)
+{
+	static constexpr uint32_t KBoneMatrixCounts[]{ 3, 1, 7, 4 };
+
+	CBonePalettePacker Packer{};
+	std::vector<uint32_t> vOffsets{};
+	std::vector<std::vector<XMMATRIX>> vPalettes{};
+	for (uint32_t iObject = 0; iObject < (uint32_t)std::size(KBoneMatrixCounts); ++iObject)
+	{
+		// @important: CObject3D keeps its bone matrices transposed (see CPoseEvaluator::CalculateAnimatedBoneMatrices())
+		std::vector<XMMATRIX> vPalette{};
+		for (uint32_t iBone = 0; iBone < KBoneMatrixCounts[iObject]; ++iBone)
+		{
+			vPalette.emplace_back(XMMatrixTranspose(MakeBoneMatrix(iObject, iBone)));
+		}
+		vOffsets.emplace_back(Packer.Pack(vPalette.data(), (uint32_t)vPalette.size()));
+		vPalettes.emplace_back(vPalette);
+	}
+
+	CHECK(vOffsets[0] == 0);
+	CHECK(vOffsets[1] == 3);
+	CHECK(vOffsets[2] == 4);
+	CHECK(vOffsets[3] == 11);
+	CHECK(Packer.GetPackedMatrixCount() == 15);
+	CHECK(Packer.GetPackedPaletteCount() == 4);
+	CHECK(Packer.GetPackedByteCount() == 15 * sizeof(XMFLOAT4X4));
+
+	// The shader reads a packed matrix's rows as the bone matrix's columns, so the translation is in the last column
+	const XMFLOAT4X4* const PtrPacked{ Packer.GetPackedMatrices() };
+	for (uint32_t iObject = 0; iObject < (uint32_t)vPalettes.size(); ++iObject)
+	{
+		for (uint32_t iBone = 0; iBone < (uint32_t)vPalettes[iObject].size(); ++iBone)
+		{
+			XMFLOAT4X4 BoneMatrix{};
+			XMStoreFloat4x4(&BoneMatrix, MakeBoneMatrix(iObject, iBone));
+			const XMFLOAT4X4& Packed{ PtrPacked[vOffsets[iObject] + iBone] };
+			bool bIsTransposed{ true };
+			for (int iRow = 0; iRow < 4; ++iRow)
+			{
+				for (int iColumn = 0; iColumn < 4; ++iColumn)
+				{
+					if (Packed.m[iRow][iColumn] != BoneMatrix.m[iColumn][iRow]) bIsTransposed = false;
+				}
+			}
+			CHECK(bIsTransposed);
+			CHECK(Packed._14 == BoneMatrix._41);
+		}
+	}
+}
+
+TEST_CASE(BonePaletteBuffer_ReusesStorageAfterClear)
+{
+	std::vector<XMMATRIX> vPalette(16, XMMatrixIdentity());
+
+	CBonePalettePacker Packer{};
+	Packer.Pack(vPalette.data(), 16);
+	Packer.Pack(vPalette.data(), 16);
+	const XMFLOAT4X4* const PtrPeak{ Packer.GetPackedMatrices() };
+
+	// @important: a frame that doesn't exceed the previous peak must not reallocate
+	Packer.Clear();
+	CHECK(Packer.GetPackedMatrixCount() == 0);
+	CHECK(Packer.GetPackedPaletteCount() == 0);
+	CHECK(Packer.Pack(vPalette.data(), 10) == 0);
+	CHECK(Packer.Pack(vPalette.data(), 16) == 10);
+	CHECK(Packer.GetPackedMatrices() == PtrPeak);
+	CHECK(Packer.GetPackedByteCount() == 26 * sizeof(XMFLOAT4X4));
+}
@@ -0,0 +1,120 @@
+#include "Test.h"
+#include "../Core/DirtyRangeTracker.h"
+
+static bool IsRange(const CDirtyRangeTracker::SRange& Range, uint32_t First, uint32_t Count)
+{
+	return (Range.First == First && Range.Count == Count);
+}
+
+TEST_CASE(DirtyRangeTracker_ExtendsConsecutiveMarks)
+{
+	CDirtyRangeTracker DirtyRangeTracker{};
+	CHECK(!DirtyRangeTracker.IsDirty());
+
+	DirtyRangeTracker.MarkDirty(0);
+	DirtyRangeTracker.MarkDirty(1);
+	DirtyRangeTracker.MarkDirty(2, 3);
+	DirtyRangeTracker.MarkDirty(1);
+	CHECK(DirtyRangeTracker.IsDirty());
+
+	const auto& vRanges{ DirtyRangeTracker.Coalesce() };
+	CHECK(vRanges.size() == 1 && IsRange(vRanges[0], 0, 5));
+
+	DirtyRangeTracker.Clear();
+	CHECK(!DirtyRangeTracker.IsDirty());
+
+	DirtyRangeTracker.MarkDirty(7, 0);
+	CHECK(!DirtyRangeTracker.IsDirty());
+}
+
+TEST_CASE(DirtyRangeTracker_SortsAndMerges)
+{
+	CDirtyRangeTracker DirtyRangeTracker{};
+	DirtyRangeTracker.MarkDirty(10, 2);
+	DirtyRangeTracker.MarkDirty(0, 2);
+	DirtyRangeTracker.MarkDirty(5);
+	DirtyRangeTracker.MarkDirty(2); // adjacent to [0, 2) once sorted
+
+	const auto& vRanges{ DirtyRangeTracker.Coalesce() };
+	CHECK(vRanges.size() == 3);
+	CHECK(IsRange(vRanges[0], 0, 3));
+	CHECK(IsRange(vRanges[1], 5, 1));
+	CHECK(IsRange(vRanges[2], 10, 2));
+
+	// Gaps of 2 elements or less are uploaded as well
+	const auto& vMergedRanges{ DirtyRangeTracker.Coalesce(2) };
+	CHECK(vMergedRanges.size() == 2);
+	CHECK(IsRange(vMergedRanges[0], 0, 6));
+	CHECK(IsRange(vMergedRanges[1], 10, 2));
+}
+
+TEST_CASE(DirtyRangeTracker_MergesOverlaps)
+{
+	CDirtyRangeTracker DirtyRangeTracker{};
+	DirtyRangeTracker.MarkDirty(20, 5);
+	DirtyRangeTracker.MarkDirty(0, 10);
+	DirtyRangeTracker.MarkDirty(5, 20);
+	DirtyRangeTracker.MarkDirty(3, 2);
+
+	const auto& vRanges{ DirtyRangeTracker.Coalesce() };
+	CHECK(vRanges.size() == 1 && IsRange(vRanges[0], 0, 25));
+}
+
+TEST_CASE(DirtyRangeTracker_DoesntOverflow)
+{
+	CDirtyRangeTracker DirtyRangeTracker{};
+	DirtyRangeTracker.MarkDirty(UINT32_MAX - 1);
+	DirtyRangeTracker.MarkDirty(0);
+
+	const auto& vRanges{ DirtyRangeTracker.Coalesce() };
+	CHECK(vRanges.size() == 2 && IsRange(vRanges[0], 0, 1) && IsRange(vRanges[1], UINT32_MAX - 1, 1));
+
+	const auto& vMergedRanges{ DirtyRangeTracker.Coalesce(UINT32_MAX) };
+	CHECK(vMergedRanges.size() == 1 && IsRange(vMergedRanges[0], 0, UINT32_MAX));
+}
+
+TEST_CASE(DirtyRangeTracker_ExtendsUpToTheLastElement)
+{
+	// Ranges that end at the largest index MarkDirty() accepts
+	CDirtyRangeTracker DirtyRangeTracker{};
+	DirtyRangeTracker.MarkDirty(UINT32_MAX - 6, 2);
+	DirtyRangeTracker.MarkDirty(UINT32_MAX - 4, 4);
+	DirtyRangeTracker.MarkDirty(UINT32_MAX - 5, 1);
+	DirtyRangeTracker.MarkDirty(UINT32_MAX - 1, 1);
+
+	const auto& vRanges{ DirtyRangeTracker.Coalesce() };
+	CHECK(vRanges.size() == 1 && IsRange(vRanges[0], UINT32_MAX - 6, 6));
+}
+
+TEST_CASE(DirtyRangeTracker_CoversEveryMark)
+{
+	static constexpr uint32_t KElementCount{ 512 };
+
+	CDirtyRangeTracker DirtyRangeTracker{};
+	std::vector<bool> vIsDirty(KElementCount);
+	uint32_t Seed{ 7 };
+	for (uint32_t iMark = 0; iMark < 100; ++iMark)
+	{
+		Seed = Seed * 1664525 + 1013904223;
+		const uint32_t KFirst{ (Seed >> 8) % KElementCount };
+		const uint32_t KCount{ 1 + (Seed >> 20) % 8 };
+		DirtyRangeTracker.MarkDirty(KFirst, KCount);
+		for (uint32_t iElement = KFirst; iElement < KFirst + KCount && iElement < KElementCount; ++iElement) vIsDirty[iElement] = true;
+	}
+
+	// Without a gap, exactly the dirty elements are covered, by sorted and separated ranges
+	std::vector<bool> vIsCovered(KElementCount + 8);
+	const auto& vRanges{ DirtyRangeTracker.Coalesce() };
+	for (size_t iRange = 0; iRange < vRanges.size(); ++iRange)
+	{
+		if (iRange) CHECK(vRanges[iRange - 1].First + vRanges[iRange - 1].Count < vRanges[iRange].First);
+		for (uint32_t iElement = vRanges[iRange].First; iElement < vRanges[iRange].First + vRanges[iRange].Count; ++iElement)
+		{
+			vIsCovered[iElement] = true;
+		}
+	}
+	for (uint32_t iElement = 0; iElement < KElementCount; ++iElement)
+	{
+		CHECK(vIsCovered[iElement] == vIsDirty[iElement]);
+	}
+}
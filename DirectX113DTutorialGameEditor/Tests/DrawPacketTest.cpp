@@ -0,0 +1,93 @@
+#include "Test.h"
+#include "../Core/DrawPacket.h"
+#include <algorithm>
+
+TEST_CASE(DrawPacket_PacksAndUnpacksSortKeys)
+{
+	const uint64_t KSortKey{ CDrawPacketQueue::MakeSortKey(0xAB, 0x1234, 0x56789A, 0xBCDE) };
+	CHECK(KSortKey == 0xAB123456789ABCDEull);
+	CHECK(CDrawPacketQueue::GetShaderSet(KSortKey) == 0x1234);
+	CHECK(CDrawPacketQueue::GetMaterialSet(KSortKey) == 0x56789A);
+
+	CHECK(CDrawPacketQueue::QuantizeDepth(-1.0f, 100.0f) == 0);
+	CHECK(CDrawPacketQueue::QuantizeDepth(0.0f, 100.0f) == 0);
+	CHECK(CDrawPacketQueue::QuantizeDepth(25.0f, 100.0f) < CDrawPacketQueue::QuantizeDepth(50.0f, 100.0f));
+	CHECK(CDrawPacketQueue::QuantizeDepth(100.0f, 100.0f) == 0xFFFF);
+	CHECK(CDrawPacketQueue::QuantizeDepth(1000.0f, 100.0f) == 0xFFFF);
+}
+
+TEST_CASE(DrawPacket_SortsByKeyAndKeepsTheOrderOfEqualKeys)
+{
+	// @important: few distinct keys, so that every key is shared by many packets
+	CDrawPacketQueue Queue{};
+	uint32_t Seed{ 3 };
+	for (uint32_t iPacket = 0; iPacket < 1000; ++iPacket)
+	{
+		Seed = Seed * 1664525u + 1013904223u;
+		const uint32_t KBits{ Seed >> 8 };
+		Queue.Push(CDrawPacketQueue::MakeSortKey(KBits & 1, (KBits >> 1) & 3, (KBits >> 3) & 7, (KBits >> 6) & 0xFF00), iPacket, KBits & 7);
+	}
+	Queue.Sort();
+
+	const std::vector<SDrawPacket>& KPackets{ Queue.GetPackets() };
+	CHECK(KPackets.size() == 1000);
+	std::vector<bool> vIsPushed(1000);
+	bool bIsSorted{ true };
+	bool bIsStable{ true };
+	for (size_t iPacket = 0; iPacket < KPackets.size(); ++iPacket)
+	{
+		vIsPushed[KPackets[iPacket].ObjectIndex] = true;
+		if (iPacket == 0) continue;
+
+		const SDrawPacket& KPrevious{ KPackets[iPacket - 1] };
+		if (KPrevious.SortKey > KPackets[iPacket].SortKey) bIsSorted = false;
+		// Packets were pushed in the order of their object indices
+		if (KPrevious.SortKey == KPackets[iPacket].SortKey && KPrevious.ObjectIndex > KPackets[iPacket].ObjectIndex) bIsStable = false;
+	}
+	CHECK(bIsSorted);
+	CHECK(bIsStable);
+	CHECK(std::find(vIsPushed.begin(), vIsPushed.end(), false) == vIsPushed.end());
+}
+
+TEST_CASE(DrawPacket_SkipsBytesSharedByEveryPacket)
+{
+	// Every byte but the material set's lowest is the same, so the sort takes a single radix pass
+	CDrawPacketQueue Queue{};
+	for (uint32_t iPacket = 0; iPacket < 8; ++iPacket)
+	{
+		Queue.Push(CDrawPacketQueue::MakeSortKey(2, 7, 0x100 | ((iPacket * 5) % 8), 0x4000), iPacket, 0);
+	}
+	Queue.Sort();
+
+	const std::vector<SDrawPacket>& KPackets{ Queue.GetPackets() };
+	for (uint32_t iPacket = 0; iPacket < 8; ++iPacket)
+	{
+		CHECK(CDrawPacketQueue::GetMaterialSet(KPackets[iPacket].SortKey) == (0x100 | iPacket));
+		CHECK(CDrawPacketQueue::GetShaderSet(KPackets[iPacket].SortKey) == 7);
+	}
+
+	// Nothing differs at all
+	Queue.Clear();
+	for (uint32_t iPacket = 0; iPacket < 4; ++iPacket) Queue.Push(42, iPacket, 0);
+	Queue.Sort();
+	for (uint32_t iPacket = 0; iPacket < 4; ++iPacket) CHECK(Queue.GetPackets()[iPacket].ObjectIndex == iPacket);
+}
+
+TEST_CASE(DrawPacket_CountsAvoidedStateChanges)
+{
+	CDrawStateTracker StateTracker{};
+	CHECK(StateTracker.ShouldSetShaderSet(1));
+	CHECK(!StateTracker.ShouldSetShaderSet(1));
+	CHECK(StateTracker.ShouldSetMaterialSet(1));
+	CHECK(StateTracker.ShouldSetMaterialSet(2));
+	CHECK(StateTracker.ShouldSetObject(0));
+	CHECK(StateTracker.GetStateChangeCount() == 4);
+	CHECK(StateTracker.GetAvoidedStateChangeCount() == 1);
+
+	// @important: after someone else has set the states, none of them can be skipped
+	StateTracker.Invalidate();
+	CHECK(StateTracker.ShouldSetShaderSet(1));
+	StateTracker.ResetCounters();
+	CHECK(StateTracker.GetStateChangeCount() == 0);
+	CHECK(StateTracker.GetAvoidedStateChangeCount() == 0);
+}
@@ -0,0 +1,82 @@
+#include "Test.h"
+#include "../Core/FrustumCuller.h"
+
+using namespace DirectX;
+
+// The box [-10, 10]^3 as 6 outward planes (unnormalized, SetPlanes() normalizes them)
+static void SetBoxPlanes(CFrustumCuller& FrustumCuller)
+{
+	const XMVECTOR KPlanes[6]
+	{
+		XMVectorSet(+2, 0, 0, -20), XMVectorSet(-1, 0, 0, -10),
+		XMVectorSet(0, +1, 0, -10), XMVectorSet(0, -1, 0, -10),
+		XMVectorSet(0, 0, +1, -10), XMVectorSet(0, 0, -4, -40),
+	};
+	FrustumCuller.SetPlanes(KPlanes, 6);
+}
+
+TEST_CASE(FrustumCuller_ClassifiesSpheresAgainstKnownPlanes)
+{
+	CFrustumCuller FrustumCuller{};
+	SetBoxPlanes(FrustumCuller);
+
+	// Inside
+	CHECK(FrustumCuller.IsVisible(XMFLOAT4(0, 0, 0, 1)));
+	CHECK(FrustumCuller.IsVisible(XMFLOAT4(9, -9, 9, 1)));
+
+	// Straddling a plane (the center is outside, but the sphere reaches in)
+	CHECK(FrustumCuller.IsVisible(XMFLOAT4(10.5f, 0, 0, 1)));
+	CHECK(FrustumCuller.IsVisible(XMFLOAT4(0, 0, -10.75f, 1)));
+
+	// Enclosing the whole box
+	CHECK(FrustumCuller.IsVisible(XMFLOAT4(100, 0, 0, 200)));
+
+	// Outside
+	CHECK(!FrustumCuller.IsVisible(XMFLOAT4(11.5f, 0, 0, 1)));
+	CHECK(!FrustumCuller.IsVisible(XMFLOAT4(0, -30, 0, 5)));
+	CHECK(!FrustumCuller.IsVisible(XMFLOAT4(0, 0, -12, 1)));
+}
+
+TEST_CASE(FrustumCuller_BatchedCullMatchesIsVisible)
+{
+	CFrustumCuller FrustumCuller{};
+	SetBoxPlanes(FrustumCuller);
+
+	// @important: 4-wide batches and a tail of 3, with every classification in both
+	std::vector<XMFLOAT4> vSpheres{};
+	uint32_t Seed{ 7 };
+	for (uint32_t iSphere = 0; iSphere < 4 * 9 + 3; ++iSphere)
+	{
+		Seed = Seed * 1664525u + 1013904223u;
+		const float KCoordinate{ (float)(Seed >> 8) / (float)(1 << 24) * 30.0f - 15.0f };
+		const float KRadius{ (float)(iSphere % 4) };
+		switch (iSphere % 3)
+		{
+		case 0: vSpheres.emplace_back(KCoordinate, 0.0f, 0.0f, KRadius); break;
+		case 1: vSpheres.emplace_back(0.0f, KCoordinate, 0.0f, KRadius); break;
+		default: vSpheres.emplace_back(0.0f, 0.0f, KCoordinate, KRadius); break;
+		}
+	}
+	// The tail holds an inside, an outside and a straddling sphere
+	vSpheres[36] = XMFLOAT4(1, 2, 3, 1);
+	vSpheres[37] = XMFLOAT4(-20, 0, 0, 1);
+	vSpheres[38] = XMFLOAT4(0, 10.5f, 0, 1);
+
+	// @important: Cull() appends, the existing indices must stay
+	std::vector<uint32_t> vVisibleIndices{ 1234 };
+	const uint32_t KVisibleCount{ FrustumCuller.Cull(vSpheres.data(), (uint32_t)vSpheres.size(), vVisibleIndices) };
+
+	std::vector<uint32_t> vExpectedIndices{ 1234 };
+	for (uint32_t iSphere = 0; iSphere < (uint32_t)vSpheres.size(); ++iSphere)
+	{
+		if (FrustumCuller.IsVisible(vSpheres[iSphere])) vExpectedIndices.emplace_back(iSphere);
+	}
+	CHECK(KVisibleCount == (uint32_t)vExpectedIndices.size() - 1);
+	CHECK(vVisibleIndices == vExpectedIndices);
+	CHECK(KVisibleCount > 0 && KVisibleCount < (uint32_t)vSpheres.size());
+
+	// The tail alone
+	std::vector<uint32_t> vTailIndices{};
+	CHECK(FrustumCuller.Cull(&vSpheres[36], 3, vTailIndices) == 2);
+	CHECK(vTailIndices == std::vector<uint32_t>({ 0, 2 }));
+}
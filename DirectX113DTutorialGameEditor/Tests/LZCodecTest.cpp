@@ -0,0 +1,158 @@
+#include "Test.h"
+#include "../Core/LZCodec.h"
+#include <cmath>
+#include <cstring>
+
+static bool RoundTrips(const std::vector<uint8_t>& vRaw, size_t* const PtrFrameByteCount = nullptr)
+{
+	std::vector<uint8_t> vFrame{};
+	CLZCodec::Compress(vRaw.data(), vRaw.size(), vFrame);
+	if (PtrFrameByteCount) *PtrFrameByteCount = vFrame.size();
+
+	uint64_t RawByteCount{};
+	if (!CLZCodec::IsCompressed(vFrame.data(), vFrame.size())) return false;
+	if (!CLZCodec::GetRawByteCount(vFrame.data(), vFrame.size(), RawByteCount) || RawByteCount != vRaw.size()) return false;
+
+	std::vector<uint8_t> vDecompressed(vRaw.size());
+	if (!CLZCodec::Decompress(vFrame.data(), vFrame.size(), vDecompressed.data(), vDecompressed.size())) return false;
+	return (vDecompressed == vRaw);
+}
+
+static std::vector<uint8_t> MakeNoise(size_t ByteCount, uint32_t Seed)
+{
+	std::vector<uint8_t> vBytes(ByteCount);
+	for (auto& Byte : vBytes)
+	{
+		Seed = Seed * 1664525 + 1013904223;
+		Byte = (uint8_t)(Seed >> 24);
+	}
+	return vBytes;
+}
+
+// Like vertex positions: 4 smooth floats per element
+static std::vector<uint8_t> MakeSmoothFloats(size_t FloatCount)
+{
+	std::vector<float> vFloats(FloatCount);
+	for (size_t iFloat = 0; iFloat < FloatCount; ++iFloat)
+	{
+		vFloats[iFloat] = sinf((float)(iFloat / 4) * 0.01f) * 100.0f + (float)(iFloat % 4);
+	}
+	std::vector<uint8_t> vBytes(FloatCount * 4);
+	memcpy(vBytes.data(), vFloats.data(), vBytes.size());
+	return vBytes;
+}
+
+TEST_CASE(LZCodec_RoundTripsEdgeSizes)
+{
+	CHECK(RoundTrips({}));
+	CHECK(RoundTrips({ 42 }));
+	CHECK(RoundTrips(MakeNoise(3, 1)));
+	CHECK(RoundTrips(MakeNoise(13, 2)));
+	CHECK(RoundTrips(std::vector<uint8_t>(17, 0xAB)));
+
+	// Around the block size, and sizes that don't make whole 4-byte components
+	for (size_t ByteCount : { CLZCodec::KBlockByteCount - 1, CLZCodec::KBlockByteCount, CLZCodec::KBlockByteCount + 1,
+		CLZCodec::KBlockByteCount * 2 + 3 })
+	{
+		CHECK(RoundTrips(MakeSmoothFloats(ByteCount / 4 + 1)));
+		std::vector<uint8_t> vBytes(MakeSmoothFloats(ByteCount / 4 + 1));
+		vBytes.resize(ByteCount);
+		CHECK(RoundTrips(vBytes));
+	}
+}
+
+TEST_CASE(LZCodec_StoresIncompressibleBlocks)
+{
+	const std::vector<uint8_t> KNoise{ MakeNoise(CLZCodec::KBlockByteCount * 3 + 100, 3) };
+	size_t FrameByteCount{};
+	CHECK(RoundTrips(KNoise, &FrameByteCount));
+
+	// Each block is stored as it is, so the frame only adds the headers
+	CHECK(FrameByteCount == KNoise.size() + CLZCodec::KHeaderByteCount + CLZCodec::KBlockHeaderByteCount * 4);
+}
+
+TEST_CASE(LZCodec_CompressesRepeats)
+{
+	// Overlapping matches of every short period
+	std::vector<uint8_t> vBytes{};
+	for (uint32_t Period = 1; Period <= 20; ++Period)
+	{
+		for (uint32_t iByte = 0; iByte < 3000; ++iByte) vBytes.emplace_back((uint8_t)(iByte % Period + Period * 7));
+	}
+	size_t FrameByteCount{};
+	CHECK(RoundTrips(vBytes, &FrameByteCount));
+	CHECK(FrameByteCount < vBytes.size() / 20);
+
+	std::string Text{};
+	for (uint32_t iLine = 0; iLine < 2000; ++iLine) Text += "// 4B (uint32_t) Vertex count " + std::to_string(iLine % 37) + "\n";
+	CHECK(RoundTrips(std::vector<uint8_t>(Text.begin(), Text.end()), &FrameByteCount));
+	CHECK(FrameByteCount < Text.size() / 4);
+}
+
+TEST_CASE(LZCodec_FiltersSmoothFloats)
+{
+	const std::vector<uint8_t> KFloats{ MakeSmoothFloats(100000) };
+	size_t FrameByteCount{};
+	CHECK(RoundTrips(KFloats, &FrameByteCount));
+	CHECK(FrameByteCount < KFloats.size() * 3 / 4);
+
+	std::vector<uint8_t> vFrame{};
+	CLZCodec::Compress(KFloats.data(), KFloats.size(), vFrame);
+
+	// @important: the first block has to be filtered for these to compress this well
+	CHECK(vFrame[CLZCodec::KHeaderByteCount] != (uint8_t)ELZFilter::None);
+}
+
+TEST_CASE(LZCodec_RejectsBrokenFrames)
+{
+	const std::vector<uint8_t> KRaw{ MakeSmoothFloats(40000) };
+	std::vector<uint8_t> vFrame{};
+	CLZCodec::Compress(KRaw.data(), KRaw.size(), vFrame);
+
+	std::vector<uint8_t> vDecompressed(KRaw.size());
+	CHECK(!CLZCodec::Decompress(vFrame.data(), vFrame.size(), vDecompressed.data(), vDecompressed.size() - 1));
+	CHECK(!CLZCodec::Decompress(vFrame.data(), vFrame.size() - 1, vDecompressed.data(), vDecompressed.size()));
+	CHECK(!CLZCodec::Decompress(vFrame.data(), CLZCodec::KHeaderByteCount - 1, vDecompressed.data(), vDecompressed.size()));
+	CHECK(!CLZCodec::IsCompressed(KRaw.data(), KRaw.size()));
+
+	std::vector<uint8_t> vBadFilter{ vFrame };
+	vBadFilter[CLZCodec::KHeaderByteCount] = (uint8_t)ELZFilter::COUNT;
+	CHECK(!CLZCodec::Decompress(vBadFilter.data(), vBadFilter.size(), vDecompressed.data(), vDecompressed.size()));
+
+	// A raw byte count that no frame of this size can hold
+	std::vector<uint8_t> vBadCount{ vFrame };
+	const uint64_t KHugeByteCount{ (uint64_t)vFrame.size() * 1024 };
+	memcpy(&vBadCount[8], &KHugeByteCount, 8);
+	uint64_t RawByteCount{};
+	CHECK(!CLZCodec::GetRawByteCount(vBadCount.data(), vBadCount.size(), RawByteCount));
+}
+
+TEST_CASE(LZCodec_NeverWritesPastTheDestination)
+{
+	const std::vector<uint8_t> KRaw{ MakeSmoothFloats(20000) };
+	std::vector<uint8_t> vFrame{};
+	CLZCodec::Compress(KRaw.data(), KRaw.size(), vFrame);
+
+	// Corrupts the payload byte by byte, decoding may fail or produce garbage but must stay within the destination
+	static constexpr size_t KGuardByteCount{ 64 };
+	static constexpr uint8_t KGuardByte{ 0xCD };
+	std::vector<uint8_t> vDst(KRaw.size() + KGuardByteCount);
+	uint32_t Seed{ 5 };
+	for (uint32_t iCorruption = 0; iCorruption < 300; ++iCorruption)
+	{
+		std::vector<uint8_t> vCorrupted{ vFrame };
+		Seed = Seed * 1664525 + 1013904223;
+		const size_t KOffset{ CLZCodec::KHeaderByteCount + (Seed >> 8) % (vFrame.size() - CLZCodec::KHeaderByteCount) };
+		vCorrupted[KOffset] ^= (uint8_t)(1 + (Seed >> 4) % 255);
+
+		memset(vDst.data() + KRaw.size(), KGuardByte, KGuardByteCount);
+		CLZCodec::Decompress(vCorrupted.data(), vCorrupted.size(), vDst.data(), KRaw.size());
+
+		bool bIsGuardIntact{ true };
+		for (size_t iByte = KRaw.size(); iByte < vDst.size(); ++iByte)
+		{
+			if (vDst[iByte] != KGuardByte) bIsGuardIntact = false;
+		}
+		CHECK(bIsGuardIntact);
+	}
+}
@@ -0,0 +1,197 @@
+#include "Test.h"
+#include "../Core/LightClusterBuilder.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+static constexpr uint32_t KScreenWidth{ 1920 };
+static constexpr uint32_t KScreenHeight{ 1080 };
+static constexpr float KNearZ{ 0.1f };
+static constexpr float KFarZ{ 1000.0f };
+
+static XMMATRIX MakeProjection()
+{
+	return XMMatrixPerspectiveFovLH(XM_PIDIV4, (float)KScreenWidth / (float)KScreenHeight, KNearZ, KFarZ);
+}
+
+static void SetDefaultGrid(CLightClusterBuilder& Builder)
+{
+	Builder.SetGrid(KScreenWidth, KScreenHeight, CLightClusterBuilder::KDefaultTileSize, CLightClusterBuilder::KDefaultSliceCount,
+		KNearZ, KFarZ, MakeProjection());
+}
+
+static bool HasLight(const CLightClusterBuilder& Builder, uint32_t ClusterIndex, uint32_t LightIndex)
+{
+	const CLightClusterBuilder::SCluster& KCluster{ Builder.GetClusters()[ClusterIndex] };
+	const uint32_t* const PtrBegin{ Builder.GetLightIndices().data() + KCluster.Offset };
+	return std::find(PtrBegin, PtrBegin + KCluster.Count, LightIndex) != PtrBegin + KCluster.Count;
+}
+
+// The cluster a view-space point falls into, false when it's off the screen
+static bool GetPointCluster(const CLightClusterBuilder& Builder, const XMFLOAT3& Point, uint32_t& OutClusterIndex)
+{
+	static const XMFLOAT4X4 KProjection{ [] { XMFLOAT4X4 Projection{}; XMStoreFloat4x4(&Projection, MakeProjection()); return Projection; }() };
+
+	if (Point.z <= KNearZ || Point.z >= KFarZ) return false;
+	const float KNdcX{ Point.x * KProjection._11 / Point.z };
+	const float KNdcY{ Point.y * KProjection._22 / Point.z };
+	if (fabsf(KNdcX) >= 1.0f || fabsf(KNdcY) >= 1.0f) return false;
+
+	const uint32_t KTileX{ (uint32_t)((KNdcX + 1.0f) * 0.5f * KScreenWidth) / CLightClusterBuilder::KDefaultTileSize };
+	const uint32_t KTileY{ (uint32_t)((1.0f - KNdcY) * 0.5f * KScreenHeight) / CLightClusterBuilder::KDefaultTileSize };
+	OutClusterIndex = Builder.GetClusterIndex(KTileX, KTileY, Builder.GetSliceIndex(Point.z));
+	return true;
+}
+
+static float Random(uint32_t& Seed)
+{
+	Seed = Seed * 1664525u + 1013904223u;
+	return (float)(Seed >> 8) / (float)(1 << 24);
+}
+
+TEST_CASE(LightClusterBuilder_MakesTheGrid)
+{
+	CLightClusterBuilder Builder{};
+	SetDefaultGrid(Builder);
+
+	CHECK(Builder.GetTileCountX() == 30);
+	CHECK(Builder.GetTileCountY() == 17);
+	CHECK(Builder.GetSliceCount() == CLightClusterBuilder::KDefaultSliceCount);
+	CHECK(Builder.GetClusterCount() == 30 * 17 * CLightClusterBuilder::KDefaultSliceCount);
+	CHECK(Builder.GetClusterIndex(29, 16, CLightClusterBuilder::KDefaultSliceCount - 1) == Builder.GetClusterCount() - 1);
+
+	// Exponential slices: each decade of depth gets the same number of slices
+	CHECK(Builder.GetSliceIndex(0.0f) == 0);
+	CHECK(Builder.GetSliceIndex(KNearZ) == 0);
+	CHECK(Builder.GetSliceIndex(0.15f) == 1);
+	CHECK(Builder.GetSliceIndex(1.5f) == 7);
+	CHECK(Builder.GetSliceIndex(15.0f) == 13);
+	CHECK(Builder.GetSliceIndex(KFarZ * 2.0f) == CLightClusterBuilder::KDefaultSliceCount - 1);
+}
+
+TEST_CASE(LightClusterBuilder_CoversEveryLitPoint)
+{
+	CLightClusterBuilder Builder{};
+	SetDefaultGrid(Builder);
+
+	// Point lights in front of the camera and a spot light facing it from the side
+	const XMFLOAT4 KPointLights[]{ { 0, 0, 10, 1 }, { -3, 1.5f, 6, 2.5f }, { 40, -20, 80, 12 }, { 0, 0, 0.5f, 1 } };
+	for (const auto& Light : KPointLights) Builder.AddPointLight(XMVectorSet(Light.x, Light.y, Light.z, 1), Light.w);
+	const XMFLOAT3 KSpotPosition{ 6, 2, 20 };
+	const XMVECTOR KSpotDirection{ XMVector3Normalize(XMVectorSet(-1, -0.25f, -0.5f, 0)) };
+	const float KSpotRange{ 10.0f };
+	const float KSpotHalfAngle{ 0.4f };
+	Builder.AddSpotLight(XMLoadFloat3(&KSpotPosition), KSpotDirection, KSpotRange, KSpotHalfAngle);
+	Builder.Build();
+	CHECK(Builder.GetLightCount() == 5);
+
+	// @important: points sampled inside each lit volume (with a margin) must fall into clusters that list the light
+	uint32_t Seed{ 11 };
+	uint32_t MissingCount{};
+	uint32_t SampleCount{};
+	for (uint32_t iLight = 0; iLight < 4; ++iLight)
+	{
+		const XMFLOAT4& KLight{ KPointLights[iLight] };
+		for (uint32_t iSample = 0; iSample < 2000; ++iSample)
+		{
+			XMFLOAT3 Offset{ Random(Seed) * 2 - 1, Random(Seed) * 2 - 1, Random(Seed) * 2 - 1 };
+			if (Offset.x * Offset.x + Offset.y * Offset.y + Offset.z * Offset.z > 0.95f * 0.95f) continue;
+
+			uint32_t ClusterIndex{};
+			const XMFLOAT3 KPoint{ KLight.x + Offset.x * KLight.w, KLight.y + Offset.y * KLight.w, KLight.z + Offset.z * KLight.w };
+			if (!GetPointCluster(Builder, KPoint, ClusterIndex)) continue;
+			++SampleCount;
+			if (!HasLight(Builder, ClusterIndex, iLight)) ++MissingCount;
+		}
+	}
+
+	// The spot light's sphere sector (see DSSpotLight)
+	XMFLOAT3 Direction{};
+	XMStoreFloat3(&Direction, KSpotDirection);
+	const float KConeRange{ KSpotRange / cosf(KSpotHalfAngle) };
+	for (uint32_t iSample = 0; iSample < 4000; ++iSample)
+	{
+		XMFLOAT3 Offset{ Random(Seed) * 2 - 1, Random(Seed) * 2 - 1, Random(Seed) * 2 - 1 };
+		const float KLength{ sqrtf(Offset.x * Offset.x + Offset.y * Offset.y + Offset.z * Offset.z) };
+		if (KLength > 0.95f || KLength < 0.01f) continue;
+		const float KCos{ (Offset.x * Direction.x + Offset.y * Direction.y + Offset.z * Direction.z) / KLength };
+		if (KCos < cosf(KSpotHalfAngle * 0.95f)) continue;
+
+		uint32_t ClusterIndex{};
+		const XMFLOAT3 KPoint{ KSpotPosition.x + Offset.x * KConeRange, KSpotPosition.y + Offset.y * KConeRange,
+			KSpotPosition.z + Offset.z * KConeRange };
+		if (!GetPointCluster(Builder, KPoint, ClusterIndex)) continue;
+		++SampleCount;
+		if (!HasLight(Builder, ClusterIndex, 4)) ++MissingCount;
+	}
+	CHECK(SampleCount > 1000);
+	CHECK(MissingCount == 0);
+
+	// Clusters well behind the spot light don't list it (clusters there are about 10 units deep)
+	uint32_t BehindClusterIndex{};
+	const XMFLOAT3 KBehind{ KSpotPosition.x - Direction.x * 12, KSpotPosition.y - Direction.y * 12, KSpotPosition.z - Direction.z * 12 };
+	CHECK(GetPointCluster(Builder, KBehind, BehindClusterIndex));
+	CHECK(!HasLight(Builder, BehindClusterIndex, 4));
+
+	// A small light is only in the clusters around it: its bounds cover at most 6x6 tiles (290 pixels) in 2 slices
+	uint32_t SmallLightClusterCount{};
+	for (uint32_t iCluster = 0; iCluster < Builder.GetClusterCount(); ++iCluster)
+	{
+		if (HasLight(Builder, iCluster, 0)) ++SmallLightClusterCount;
+	}
+	CHECK(SmallLightClusterCount > 0 && SmallLightClusterCount <= 6 * 6 * 2);
+}
+
+TEST_CASE(LightClusterBuilder_ListsLightsInOrder)
+{
+	CLightClusterBuilder Builder{};
+	SetDefaultGrid(Builder);
+
+	// @important: the same spot in front of the camera, added between lights that are off the screen
+	Builder.AddPointLight(XMVectorSet(0, 0, 10, 1), 2);
+	Builder.AddPointLight(XMVectorSet(0, 0, -10, 1), 2); // behind the camera
+	Builder.AddSpotLight(XMVectorSet(0, 0, 5, 1), XMVectorSet(0, 0, 1, 0), 8, 0.3f);
+	Builder.AddPointLight(XMVectorSet(500, 0, 10, 1), 2); // beside the view
+	Builder.AddPointLight(XMVectorSet(0, 0, 10, 1), 1);
+	Builder.Build();
+
+	const auto& vClusters{ Builder.GetClusters() };
+	const auto& vLightIndices{ Builder.GetLightIndices() };
+	CHECK(vClusters.size() == Builder.GetClusterCount());
+
+	// Clusters are packed back to back, and each lists its lights in the order they were added
+	uint32_t Offset{};
+	CLightClusterBuilder::SStatistics Statistics{};
+	bool bIsOrdered{ true };
+	for (const auto& Cluster : vClusters)
+	{
+		if (Cluster.Offset != Offset) bIsOrdered = false;
+		for (uint32_t iIndex = 1; iIndex < Cluster.Count; ++iIndex)
+		{
+			if (vLightIndices[Cluster.Offset + iIndex - 1] >= vLightIndices[Cluster.Offset + iIndex]) bIsOrdered = false;
+		}
+		Offset += Cluster.Count;
+		Statistics.NonEmptyClusterCount += (Cluster.Count) ? 1 : 0;
+		Statistics.MaxLightCountPerCluster = std::max(Statistics.MaxLightCountPerCluster, Cluster.Count);
+	}
+	CHECK(bIsOrdered);
+	CHECK(Offset == (uint32_t)vLightIndices.size());
+	CHECK(Builder.GetStatistics().LightIndexCount == Offset);
+	CHECK(Builder.GetStatistics().NonEmptyClusterCount == Statistics.NonEmptyClusterCount);
+	CHECK(Builder.GetStatistics().MaxLightCountPerCluster == 3);
+	CHECK(std::find(vLightIndices.begin(), vLightIndices.end(), 1u) == vLightIndices.end());
+	CHECK(std::find(vLightIndices.begin(), vLightIndices.end(), 3u) == vLightIndices.end());
+
+	uint32_t CenterClusterIndex{};
+	CHECK(GetPointCluster(Builder, XMFLOAT3(0.01f, 0.01f, 10), CenterClusterIndex));
+	const auto& KCenterCluster{ vClusters[CenterClusterIndex] };
+	CHECK(KCenterCluster.Count == 3);
+	CHECK(vLightIndices[KCenterCluster.Offset] == 0 && vLightIndices[KCenterCluster.Offset + 1] == 2 && vLightIndices[KCenterCluster.Offset + 2] == 4);
+
+	// Rebuilding without lights empties every cluster
+	Builder.ClearLights();
+	Builder.Build();
+	CHECK(Builder.GetLightIndices().empty());
+	CHECK(Builder.GetStatistics().NonEmptyClusterCount == 0);
+}
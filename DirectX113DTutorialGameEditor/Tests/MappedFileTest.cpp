@@ -0,0 +1,74 @@
+#include "Test.h"
+#include "../Core/MappedFile.h"
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+static std::string WriteTemporaryFile(const char* const Name, const std::vector<uint8_t>& vBytes)
+{
+	const std::string KFileName{ (std::filesystem::temp_directory_path() / Name).string() };
+	std::ofstream File{ KFileName, std::ofstream::binary | std::ofstream::trunc };
+	if (vBytes.size()) File.write((const char*)vBytes.data(), (std::streamsize)vBytes.size());
+	return KFileName;
+}
+
+TEST_CASE(MappedFile_MapsWholeFiles)
+{
+	std::vector<uint8_t> vBytes(100000);
+	for (size_t iByte = 0; iByte < vBytes.size(); ++iByte) vBytes[iByte] = (uint8_t)(iByte * 31 + (iByte >> 8));
+	const std::string KFileName{ WriteTemporaryFile("EditorTests_MappedFile.bin", vBytes) };
+
+	CMappedFile MappedFile{};
+	CHECK(!MappedFile.IsOpen());
+	CHECK(MappedFile.Open(KFileName));
+	CHECK(MappedFile.IsOpen());
+	CHECK(MappedFile.GetSize() == vBytes.size());
+	CHECK(MappedFile.GetData() && memcmp(MappedFile.GetData(), vBytes.data(), vBytes.size()) == 0);
+
+	MappedFile.Close();
+	CHECK(!MappedFile.IsOpen());
+	CHECK(MappedFile.GetData() == nullptr && MappedFile.GetSize() == 0);
+
+	std::error_code ErrorCode{};
+	std::filesystem::remove(KFileName, ErrorCode);
+}
+
+TEST_CASE(MappedFile_OpensEmptyFiles)
+{
+	const std::string KFileName{ WriteTemporaryFile("EditorTests_MappedFile_Empty.bin", {}) };
+
+	CMappedFile MappedFile{};
+	CHECK(MappedFile.Open(KFileName));
+	CHECK(MappedFile.IsOpen());
+	CHECK(MappedFile.GetSize() == 0);
+	MappedFile.Close();
+
+	std::error_code ErrorCode{};
+	std::filesystem::remove(KFileName, ErrorCode);
+}
+
+TEST_CASE(MappedFile_FailsOnMissingFiles)
+{
+	CMappedFile MappedFile{};
+	CHECK(!MappedFile.Open((std::filesystem::temp_directory_path() / "EditorTests_MappedFile_Missing.bin").string()));
+	CHECK(!MappedFile.IsOpen());
+}
+
+TEST_CASE(MappedFile_ReplacesTheOpenFile)
+{
+	const std::string KFileNameA{ WriteTemporaryFile("EditorTests_MappedFile_A.bin", { 1, 2, 3 }) };
+	const std::string KFileNameB{ WriteTemporaryFile("EditorTests_MappedFile_B.bin", { 4, 5 }) };
+
+	CMappedFile MappedFile{};
+	CHECK(MappedFile.Open(KFileNameA));
+	CHECK(MappedFile.Open(KFileNameB));
+	CHECK(MappedFile.GetSize() == 2 && MappedFile.GetData()[0] == 4);
+
+	// A failed open leaves nothing open
+	CHECK(!MappedFile.Open(KFileNameB + ".missing"));
+	CHECK(!MappedFile.IsOpen());
+
+	std::error_code ErrorCode{};
+	std::filesystem::remove(KFileNameA, ErrorCode);
+	std::filesystem::remove(KFileNameB, ErrorCode);
+}
@@ -0,0 +1,199 @@
+#include "Test.h"
+#include "../Core/MeshOptimizer.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using namespace DirectX;
+
+// A UV sphere (shared vertices, every triangle facing outwards) whose triangles are shuffled and whose corners are rotated,
+// as a source would give it, and UnusedVertexCount vertices no triangle refers to
+static void MakeShuffledSphere(uint32_t RingCount, uint32_t SegmentCount, uint32_t UnusedVertexCount,
+	std::vector<XMFLOAT3>& vOutPositions, std::vector<uint32_t>& vOutIndices)
+{
+	vOutPositions.clear();
+	vOutPositions.emplace_back(0.0f, 1.0f, 0.0f);
+	for (uint32_t iRing = 1; iRing < RingCount; ++iRing)
+	{
+		const float KTheta{ XM_PI * iRing / RingCount };
+		for (uint32_t iSegment = 0; iSegment < SegmentCount; ++iSegment)
+		{
+			const float KPhi{ XM_2PI * iSegment / SegmentCount };
+			vOutPositions.emplace_back(sinf(KTheta) * cosf(KPhi), cosf(KTheta), sinf(KTheta) * sinf(KPhi));
+		}
+	}
+	vOutPositions.emplace_back(0.0f, -1.0f, 0.0f);
+	const uint32_t KBottom{ (uint32_t)vOutPositions.size() - 1 };
+	for (uint32_t iUnused = 0; iUnused < UnusedVertexCount; ++iUnused) vOutPositions.emplace_back(2.0f + iUnused, 0.0f, 0.0f);
+
+	auto GetRingVertex{ [&](uint32_t iRing, uint32_t iSegment) { return 1 + (iRing - 1) * SegmentCount + iSegment % SegmentCount; } };
+	vOutIndices.clear();
+	for (uint32_t iSegment = 0; iSegment < SegmentCount; ++iSegment)
+	{
+		vOutIndices.insert(vOutIndices.end(), { 0, GetRingVertex(1, iSegment + 1), GetRingVertex(1, iSegment) });
+		for (uint32_t iRing = 1; iRing + 1 < RingCount; ++iRing)
+		{
+			const uint32_t KA{ GetRingVertex(iRing, iSegment) };
+			const uint32_t KB{ GetRingVertex(iRing, iSegment + 1) };
+			const uint32_t KC{ GetRingVertex(iRing + 1, iSegment) };
+			const uint32_t KD{ GetRingVertex(iRing + 1, iSegment + 1) };
+			vOutIndices.insert(vOutIndices.end(), { KA, KB, KC, KB, KD, KC });
+		}
+		vOutIndices.insert(vOutIndices.end(), { KBottom, GetRingVertex(RingCount - 1, iSegment), GetRingVertex(RingCount - 1, iSegment + 1) });
+	}
+
+	// @important: fixed seed (xorshift), rotating the corners keeps the winding
+	uint64_t State{ 0x9E3779B97F4A7C15 };
+	auto Random{ [&State]()
+		{
+			State ^= State << 13;
+			State ^= State >> 7;
+			State ^= State << 17;
+			return State;
+		}
+	};
+	const uint32_t KTriangleCount{ (uint32_t)(vOutIndices.size() / 3) };
+	for (uint32_t iTriangle = KTriangleCount - 1; iTriangle > 0; --iTriangle)
+	{
+		const uint32_t KOther{ (uint32_t)(Random() % (iTriangle + 1)) };
+		std::swap_ranges(vOutIndices.begin() + iTriangle * 3, vOutIndices.begin() + iTriangle * 3 + 3, vOutIndices.begin() + KOther * 3);
+		std::rotate(vOutIndices.begin() + iTriangle * 3, vOutIndices.begin() + iTriangle * 3 + Random() % 3, vOutIndices.begin() + iTriangle * 3 + 3);
+	}
+}
+
+// The triangles with their corners rotated so that the smallest comes first, sorted
+// @important: a flipped triangle doesn't rotate into the original, so two lists match only if the windings do
+static std::vector<std::array<uint32_t, 3>> GetCanonicalTriangles(const std::vector<uint32_t>& vIndices)
+{
+	std::vector<std::array<uint32_t, 3>> vTriangles{};
+	for (size_t iIndex = 0; iIndex < vIndices.size(); iIndex += 3)
+	{
+		std::array<uint32_t, 3> Triangle{ vIndices[iIndex], vIndices[iIndex + 1], vIndices[iIndex + 2] };
+		std::rotate(Triangle.begin(), std::min_element(Triangle.begin(), Triangle.end()), Triangle.end());
+		vTriangles.emplace_back(Triangle);
+	}
+	std::sort(vTriangles.begin(), vTriangles.end());
+	return vTriangles;
+}
+
+// Every triangle of a sphere around the origin faces outwards
+static bool FacesOutwards(const std::vector<XMFLOAT3>& vPositions, const std::vector<uint32_t>& vIndices)
+{
+	for (size_t iIndex = 0; iIndex < vIndices.size(); iIndex += 3)
+	{
+		const XMVECTOR KP0{ XMLoadFloat3(&vPositions[vIndices[iIndex + 0]]) };
+		const XMVECTOR KP1{ XMLoadFloat3(&vPositions[vIndices[iIndex + 1]]) };
+		const XMVECTOR KP2{ XMLoadFloat3(&vPositions[vIndices[iIndex + 2]]) };
+		const XMVECTOR KNormal{ XMVector3Cross(KP1 - KP0, KP2 - KP0) };
+		if (XMVectorGetX(XMVector3Dot(KNormal, KP0 + KP1 + KP2)) <= 0.0f) return false;
+	}
+	return true;
+}
+
+TEST_CASE(MeshOptimizer_PermutesTrianglesWithTheirWinding)
+{
+	std::vector<XMFLOAT3> vPositions{};
+	std::vector<uint32_t> vIndices{};
+	MakeShuffledSphere(16, 24, 0, vPositions, vIndices);
+	const uint32_t KVertexCount{ (uint32_t)vPositions.size() };
+	CHECK(FacesOutwards(vPositions, vIndices));
+
+	std::vector<uint32_t> vOptimizedIndices{ vIndices };
+	CMeshOptimizer::OptimizeVertexCache(vOptimizedIndices, KVertexCount);
+	CHECK(GetCanonicalTriangles(vOptimizedIndices) == GetCanonicalTriangles(vIndices));
+	const SVertexCacheStatistics KCacheStatistics{ CMeshOptimizer::AnalyzeVertexCache(vOptimizedIndices, KVertexCount) };
+
+	// @important: only the order changes, never the triangles themselves
+	CMeshOptimizer::OptimizeOverdraw(vOptimizedIndices, vPositions);
+	CHECK(vOptimizedIndices != vIndices);
+	CHECK(GetCanonicalTriangles(vOptimizedIndices) == GetCanonicalTriangles(vIndices));
+	CHECK(FacesOutwards(vPositions, vOptimizedIndices));
+
+	// The cache order is what matters the most, and the overdraw order costs a bounded part of it
+	const SVertexCacheStatistics KBefore{ CMeshOptimizer::AnalyzeVertexCache(vIndices, KVertexCount) };
+	const SVertexCacheStatistics KAfter{ CMeshOptimizer::AnalyzeVertexCache(vOptimizedIndices, KVertexCount) };
+	CHECK(KCacheStatistics.ACMR < KBefore.ACMR * 0.5f);
+	CHECK(KAfter.ACMR <= KCacheStatistics.ACMR * CMeshOptimizer::KDefaultOverdrawThreshold * 1.1f);
+	CHECK(KAfter.TriangleCount == KBefore.TriangleCount && KAfter.VertexCount == KBefore.VertexCount);
+
+	// Nothing to reorder
+	std::vector<uint32_t> vEmptyIndices{};
+	CMeshOptimizer::OptimizeVertexCache(vEmptyIndices, KVertexCount);
+	CMeshOptimizer::OptimizeOverdraw(vEmptyIndices, vPositions);
+	CHECK(vEmptyIndices.empty());
+	std::vector<uint32_t> vSingleIndices{ 2, 0, 1 };
+	CMeshOptimizer::OptimizeVertexCache(vSingleIndices, 3);
+	CMeshOptimizer::OptimizeOverdraw(vSingleIndices, vPositions);
+	CHECK(GetCanonicalTriangles(vSingleIndices) == GetCanonicalTriangles({ 0, 1, 2 }));
+}
+
+TEST_CASE(MeshOptimizer_RemapsVerticesWithTheirAttributes)
+{
+	static constexpr uint32_t KUnusedVertexCount{ 3 };
+	std::vector<XMFLOAT3> vPositions{};
+	std::vector<uint32_t> vIndices{};
+	MakeShuffledSphere(8, 12, KUnusedVertexCount, vPositions, vIndices);
+	const uint32_t KVertexCount{ (uint32_t)vPositions.size() };
+
+	// A per-vertex attribute besides the position: which vertex it was
+	std::vector<uint32_t> vSourceVertices(KVertexCount);
+	for (uint32_t iVertex = 0; iVertex < KVertexCount; ++iVertex) vSourceVertices[iVertex] = iVertex;
+
+	std::vector<uint32_t> vOptimizedIndices{ vIndices };
+	CMeshOptimizer::OptimizeVertexCache(vOptimizedIndices, KVertexCount);
+	CMeshOptimizer::OptimizeOverdraw(vOptimizedIndices, vPositions);
+	const std::vector<uint32_t> KReorderedIndices{ vOptimizedIndices };
+	std::vector<uint32_t> vRemap{};
+	CMeshOptimizer::OptimizeVertexFetch(vOptimizedIndices, KVertexCount, vRemap);
+
+	// @important: a permutation of the vertices, so the vertex count is kept
+	CHECK(vRemap.size() == KVertexCount);
+	std::vector<bool> vIsRemapped(KVertexCount);
+	bool bIsPermutation{ true };
+	for (uint32_t NewVertex : vRemap)
+	{
+		if (NewVertex >= KVertexCount || vIsRemapped[NewVertex]) bIsPermutation = false;
+		if (NewVertex < KVertexCount) vIsRemapped[NewVertex] = true;
+	}
+	CHECK(bIsPermutation);
+
+	// The vertices are numbered in the order the triangles first use them, and the unused ones go last
+	uint32_t NextVertex{};
+	bool bIsInFetchOrder{ true };
+	for (uint32_t Index : vOptimizedIndices)
+	{
+		if (Index > NextVertex) bIsInFetchOrder = false;
+		if (Index == NextVertex) ++NextVertex;
+	}
+	CHECK(bIsInFetchOrder);
+	CHECK(NextVertex == KVertexCount - KUnusedVertexCount);
+	for (uint32_t iUnused = 0; iUnused < KUnusedVertexCount; ++iUnused)
+	{
+		CHECK(vRemap[KVertexCount - KUnusedVertexCount + iUnused] >= NextVertex);
+	}
+
+	// The attributes follow the remap as CAssimpLoader moves them (see OptimizeMesh()): [remap[old vertex]] = old attribute
+	std::vector<XMFLOAT3> vRemappedPositions(KVertexCount);
+	std::vector<uint32_t> vRemappedSourceVertices(KVertexCount);
+	for (uint32_t iVertex = 0; iVertex < KVertexCount; ++iVertex)
+	{
+		vRemappedPositions[vRemap[iVertex]] = vPositions[iVertex];
+		vRemappedSourceVertices[vRemap[iVertex]] = vSourceVertices[iVertex];
+	}
+
+	// @important: every corner still has the attributes of the vertex it had before the remap, so the mesh looks the same
+	bool bKeepsAttributes{ true };
+	std::vector<uint32_t> vSourceIndices{};
+	for (size_t iIndex = 0; iIndex < vOptimizedIndices.size(); ++iIndex)
+	{
+		const uint32_t KNewVertex{ vOptimizedIndices[iIndex] };
+		const uint32_t KOldVertex{ KReorderedIndices[iIndex] };
+		const XMFLOAT3& KPosition{ vRemappedPositions[KNewVertex] };
+		if (vRemappedSourceVertices[KNewVertex] != KOldVertex || KPosition.x != vPositions[KOldVertex].x ||
+			KPosition.y != vPositions[KOldVertex].y || KPosition.z != vPositions[KOldVertex].z) bKeepsAttributes = false;
+		vSourceIndices.emplace_back(vRemappedSourceVertices[KNewVertex]);
+	}
+	CHECK(bKeepsAttributes);
+	CHECK(GetCanonicalTriangles(vSourceIndices) == GetCanonicalTriangles(vIndices));
+	CHECK(FacesOutwards(vRemappedPositions, vOptimizedIndices));
+}
@@ -0,0 +1,181 @@
+#include "Test.h"
+#include "../Core/MeshSimplifier.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+
+using namespace DirectX;
+
+// GridSize x GridSize vertices on the xz plane (1 unit apart) with the height Bump * sin(x / 2) * sin(z / 2), both triangles face +y
+static void MakeGrid(uint32_t GridSize, float Bump, std::vector<XMFLOAT3>& vOutPositions, std::vector<uint32_t>& vOutIndices)
+{
+	vOutPositions.clear();
+	for (uint32_t iZ = 0; iZ < GridSize; ++iZ)
+	{
+		for (uint32_t iX = 0; iX < GridSize; ++iX)
+		{
+			vOutPositions.emplace_back((float)iX, Bump * sinf(iX * 0.5f) * sinf(iZ * 0.5f), (float)iZ);
+		}
+	}
+	vOutIndices.clear();
+	for (uint32_t iZ = 0; iZ + 1 < GridSize; ++iZ)
+	{
+		for (uint32_t iX = 0; iX + 1 < GridSize; ++iX)
+		{
+			const uint32_t I{ iZ * GridSize + iX };
+			vOutIndices.insert(vOutIndices.end(), { I, I + GridSize, I + 1, I + 1, I + GridSize, I + GridSize + 1 });
+		}
+	}
+}
+
+// The signed area of a triangle projected on the xz plane, positive when it faces +y
+static float GetProjectedArea(const std::vector<XMFLOAT3>& vPositions, const uint32_t* const Triangle)
+{
+	const XMFLOAT3& A{ vPositions[Triangle[0]] };
+	const XMFLOAT3& B{ vPositions[Triangle[1]] };
+	const XMFLOAT3& C{ vPositions[Triangle[2]] };
+	return 0.5f * ((C.x - A.x) * (B.z - A.z) - (B.x - A.x) * (C.z - A.z));
+}
+
+// @important: as the simplified grid stays a height field, the height of its surface over a vertex gives how far the vertex is from it
+static float GetMaxHeightDistance(const std::vector<XMFLOAT3>& vPositions, const std::vector<uint32_t>& vSimplifiedIndices)
+{
+	float MaxDistance{};
+	for (const XMFLOAT3& Position : vPositions)
+	{
+		float Distance{ FLT_MAX };
+		for (size_t iIndex = 0; iIndex < vSimplifiedIndices.size(); iIndex += 3)
+		{
+			const XMFLOAT3& A{ vPositions[vSimplifiedIndices[iIndex + 0]] };
+			const XMFLOAT3& B{ vPositions[vSimplifiedIndices[iIndex + 1]] };
+			const XMFLOAT3& C{ vPositions[vSimplifiedIndices[iIndex + 2]] };
+			const float KDenominator{ (B.z - C.z) * (A.x - C.x) + (C.x - B.x) * (A.z - C.z) };
+			const float KU{ ((B.z - C.z) * (Position.x - C.x) + (C.x - B.x) * (Position.z - C.z)) / KDenominator };
+			const float KV{ ((C.z - A.z) * (Position.x - C.x) + (A.x - C.x) * (Position.z - C.z)) / KDenominator };
+			const float KW{ 1.0f - KU - KV };
+			if (KU < -1e-4f || KV < -1e-4f || KW < -1e-4f) continue;
+
+			Distance = std::min(Distance, fabsf(KU * A.y + KV * B.y + KW * C.y - Position.y));
+		}
+		MaxDistance = std::max(MaxDistance, Distance);
+	}
+	return MaxDistance;
+}
+
+// Every triangle is valid and doesn't face -y, and together they still cover the whole grid exactly once
+static bool IsHeightFieldCovered(const std::vector<XMFLOAT3>& vPositions, const std::vector<uint32_t>& vIndices, uint32_t GridSize)
+{
+	double Area{};
+	for (size_t iIndex = 0; iIndex < vIndices.size(); iIndex += 3)
+	{
+		const uint32_t* const Triangle{ &vIndices[iIndex] };
+		if (Triangle[0] >= vPositions.size() || Triangle[1] >= vPositions.size() || Triangle[2] >= vPositions.size()) return false;
+
+		const float KArea{ GetProjectedArea(vPositions, Triangle) };
+		if (KArea < 0.0f) return false;
+		Area += KArea;
+	}
+	return fabs(Area - (double)(GridSize - 1) * (GridSize - 1)) < 1e-3;
+}
+
+TEST_CASE(MeshSimplifier_SimplifiesFlatGridsToTheTarget)
+{
+	static constexpr uint32_t KGridSize{ 17 };
+	std::vector<XMFLOAT3> vPositions{};
+	std::vector<uint32_t> vIndices{};
+	MakeGrid(KGridSize, 0.0f, vPositions, vIndices);
+	const uint32_t KTriangleCount{ (uint32_t)(vIndices.size() / 3) };
+
+	CMeshSimplifier Simplifier{};
+	Simplifier.SetMesh(vPositions, vIndices);
+	CHECK(Simplifier.GetTriangleCount() == KTriangleCount);
+	CHECK(Simplifier.GetLockedVertexCount() == (KGridSize - 1) * 4);
+
+	// @important: a LOD chain, each step continuing from the last one
+	uint32_t PreviousTriangleCount{ KTriangleCount };
+	for (uint32_t Target : { KTriangleCount / 2, KTriangleCount / 4, KTriangleCount / 8 })
+	{
+		const uint32_t KResultCount{ Simplifier.Simplify(Target, FLT_MAX) };
+		CHECK(KResultCount <= Target);
+		CHECK(KResultCount > 0 && KResultCount < PreviousTriangleCount);
+		CHECK(KResultCount == Simplifier.GetTriangleCount());
+		CHECK(Simplifier.GetIndices().size() == KResultCount * 3);
+		CHECK(IsHeightFieldCovered(vPositions, Simplifier.GetIndices(), KGridSize));
+		PreviousTriangleCount = KResultCount;
+	}
+
+	// A flat grid loses no detail, and its borders (the locked vertices) all remain
+	CHECK(Simplifier.GetError() < 1e-3f);
+	std::vector<bool> vIsUsed(vPositions.size());
+	for (uint32_t Index : Simplifier.GetIndices()) vIsUsed[Index] = true;
+	bool bKeepsBorders{ true };
+	for (uint32_t iVertex = 0; iVertex < vPositions.size(); ++iVertex)
+	{
+		const bool KIsBorder{ vPositions[iVertex].x == 0 || vPositions[iVertex].z == 0 ||
+			vPositions[iVertex].x == KGridSize - 1 || vPositions[iVertex].z == KGridSize - 1 };
+		if (KIsBorder && !vIsUsed[iVertex]) bKeepsBorders = false;
+	}
+	CHECK(bKeepsBorders);
+}
+
+TEST_CASE(MeshSimplifier_StaysWithinTheErrorBound)
+{
+	static constexpr uint32_t KGridSize{ 33 };
+	std::vector<XMFLOAT3> vPositions{};
+	std::vector<uint32_t> vIndices{};
+	MakeGrid(KGridSize, 1.0f, vPositions, vIndices);
+	const uint32_t KTriangleCount{ (uint32_t)(vIndices.size() / 3) };
+
+	// Without a bound the target is reached, however far the surface moves
+	CMeshSimplifier Simplifier{};
+	Simplifier.SetMesh(vPositions, vIndices);
+	const uint32_t KTarget{ KTriangleCount / 8 };
+	CHECK(Simplifier.Simplify(KTarget, FLT_MAX) <= KTarget);
+	CHECK(IsHeightFieldCovered(vPositions, Simplifier.GetIndices(), KGridSize));
+	const float KUnboundedError{ Simplifier.GetError() };
+	CHECK(KUnboundedError > 0.0f);
+
+	// @important: bounds tighter than that stop before the target, but never collapse past the bound
+	uint32_t PreviousTriangleCount{ KTriangleCount };
+	for (float MaxError : { 0.03f, 0.1f, 0.2f })
+	{
+		CHECK(MaxError < KUnboundedError);
+
+		Simplifier.SetMesh(vPositions, vIndices);
+		const uint32_t KResultCount{ Simplifier.Simplify(KTarget, MaxError) };
+		CHECK(KResultCount > KTarget);
+		CHECK(KResultCount < PreviousTriangleCount);
+		CHECK(Simplifier.GetError() <= MaxError);
+		CHECK(IsHeightFieldCovered(vPositions, Simplifier.GetIndices(), KGridSize));
+
+		// The quadric error is an area-weighted average over the removed planes, so single vertices may stray a little farther
+		CHECK(GetMaxHeightDistance(vPositions, Simplifier.GetIndices()) <= MaxError * 2.0f);
+		PreviousTriangleCount = KResultCount;
+	}
+}
+
+TEST_CASE(MeshSimplifier_CollapsesOnlyWithinVertexGroups)
+{
+	static constexpr uint32_t KGridSize{ 9 };
+	std::vector<XMFLOAT3> vPositions{};
+	std::vector<uint32_t> vIndices{};
+	MakeGrid(KGridSize, 0.0f, vPositions, vIndices);
+	const uint32_t KTriangleCount{ (uint32_t)(vIndices.size() / 3) };
+
+	// A group per vertex leaves nothing to collapse
+	std::vector<uint32_t> vVertexGroups(vPositions.size());
+	std::iota(vVertexGroups.begin(), vVertexGroups.end(), 0);
+	CMeshSimplifier Simplifier{};
+	Simplifier.SetMesh(vPositions, vIndices, &vVertexGroups);
+	CHECK(Simplifier.Simplify(KTriangleCount / 4, FLT_MAX) == KTriangleCount);
+
+	// Two groups (the left and the right half) still simplify
+	for (uint32_t iVertex = 0; iVertex < vPositions.size(); ++iVertex)
+	{
+		vVertexGroups[iVertex] = (vPositions[iVertex].x < KGridSize / 2) ? 0 : 1;
+	}
+	Simplifier.SetMesh(vPositions, vIndices, &vVertexGroups);
+	CHECK(Simplifier.Simplify(KTriangleCount / 4, FLT_MAX) <= KTriangleCount / 4);
+	CHECK(IsHeightFieldCovered(vPositions, Simplifier.GetIndices(), KGridSize));
+}
@@ -0,0 +1,191 @@
+#include "Test.h"
+#include "../Core/OcclusionCuller.h"
+#include "../Core/TaskScheduler.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace DirectX;
+
+static constexpr uint32_t KWidth{ 16 };
+static constexpr uint32_t KHeight{ 8 };
+
+// @important: with an identity view projection, positions are already in clip space (w = 1), so the screen is known exactly
+// The quad x, y in [-0.5, 0.5] with depth 0.25 + 0.25 * x, and a nearer triangle over its lower right corner
+static void MakeKnownScene(SOccluderMesh& Quad, SOccluderMesh& Triangle)
+{
+	Quad.vPositions = { { -0.5f, -0.5f, 0.125f }, { +0.5f, -0.5f, 0.375f }, { +0.5f, +0.5f, 0.375f }, { -0.5f, +0.5f, 0.125f } };
+	Quad.vIndices = { 0, 1, 2, 0, 2, 3 };
+	Triangle.vPositions = { { 0.0f, -1.0f, 0.0625f }, { 1.0f, -1.0f, 0.0625f }, { 1.0f, 0.0f, 0.0625f } };
+	Triangle.vIndices = { 0, 2, 1 }; // @important: the other winding, occluders are double-sided
+}
+
+// Depth at each pixel center, computed directly from the scene
+static std::vector<float> MakeReferenceDepths()
+{
+	std::vector<float> vDepths((size_t)KWidth * KHeight, 1.0f);
+	for (uint32_t iY = 0; iY < KHeight; ++iY)
+	{
+		for (uint32_t iX = 0; iX < KWidth; ++iX)
+		{
+			const float KX{ ((float)iX + 0.5f) / KWidth * 2.0f - 1.0f };
+			const float KY{ 1.0f - ((float)iY + 0.5f) / KHeight * 2.0f };
+			float& Depth{ vDepths[(size_t)iY * KWidth + iX] };
+			if (fabsf(KX) <= 0.5f && fabsf(KY) <= 0.5f) Depth = 0.25f + 0.25f * KX;
+			if (KX <= 1.0f && KY >= -1.0f && KY <= KX - 1.0f) Depth = std::min(Depth, 0.0625f);
+		}
+	}
+	return vDepths;
+}
+
+// QuadCopyCount: the same quad rasterized that many times, which gives the same depths
+static void RasterizeKnownScene(COcclusionCuller& Culler, uint32_t QuadCopyCount, CTaskScheduler* const PtrTaskScheduler)
+{
+	static SOccluderMesh Quad{};
+	static SOccluderMesh Triangle{};
+	if (Quad.vIndices.empty()) MakeKnownScene(Quad, Triangle);
+
+	Culler.SetResolution(KWidth, KHeight);
+	Culler.SetBudget(QuadCopyCount + 1, COcclusionCuller::KDefaultMaxTriangleCount);
+	Culler.BeginFrame(XMMatrixIdentity(), XMVectorSet(0, 0, -1, 1));
+	for (uint32_t iCopy = 0; iCopy < QuadCopyCount; ++iCopy) Culler.AddOccluder(&Quad, XMMatrixIdentity(), XMFLOAT4(0, 0, 0.25f, 0.75f));
+	Culler.AddOccluder(&Triangle, XMMatrixIdentity(), XMFLOAT4(0.5f, -0.5f, 0.0625f, 0.75f));
+	Culler.RasterizeOccluders(PtrTaskScheduler);
+}
+
+static uint32_t CountMismatches(const COcclusionCuller& Culler, const std::vector<float>& vReferenceDepths)
+{
+	uint32_t MismatchCount{};
+	for (uint32_t iY = 0; iY < KHeight; ++iY)
+	{
+		for (uint32_t iX = 0; iX < KWidth; ++iX)
+		{
+			const float KReference{ vReferenceDepths[(size_t)iY * KWidth + iX] };
+			// @important: uncovered pixels must stay exactly cleared
+			if ((KReference == 1.0f) ? Culler.GetDepth(iX, iY) != 1.0f : fabsf(Culler.GetDepth(iX, iY) - KReference) > 1e-5f) ++MismatchCount;
+		}
+	}
+	return MismatchCount;
+}
+
+TEST_CASE(OcclusionCuller_RasterizesTheReferenceDepths)
+{
+	const std::vector<float> KReferenceDepths{ MakeReferenceDepths() };
+
+	const uint32_t KCoveredCount{ (uint32_t)std::count_if(KReferenceDepths.begin(), KReferenceDepths.end(), [](float Depth) { return Depth < 1.0f; }) };
+	CHECK(KCoveredCount == 8 * 4 + 1 + 3 + 5 + 7);
+
+	COcclusionCuller Culler{};
+	RasterizeKnownScene(Culler, 1, nullptr);
+	CHECK(Culler.GetStatistics().OccluderCount == 2);
+	CHECK(Culler.GetStatistics().TriangleCount == 3);
+	CHECK(CountMismatches(Culler, KReferenceDepths) == 0);
+
+	// Enough triangles for row bands on the workers (with more than one hardware thread)
+	CTaskScheduler TaskScheduler{};
+	TaskScheduler.Start(3);
+	TaskScheduler.Wait();
+	COcclusionCuller BandedCuller{};
+	RasterizeKnownScene(BandedCuller, 4 * COcclusionCuller::KMinTriangleCountPerThread / 2, &TaskScheduler);
+	CHECK(BandedCuller.GetStatistics().TriangleCount == 4 * COcclusionCuller::KMinTriangleCountPerThread + 1);
+	CHECK(CountMismatches(BandedCuller, KReferenceDepths) == 0);
+}
+
+TEST_CASE(OcclusionCuller_ClipsAgainstTheNearPlane)
+{
+	// Half of the triangle is behind the near plane (z < 0), what's left covers the right half of the screen
+	SOccluderMesh Mesh{};
+	Mesh.vPositions = { { -3.0f, -3.0f, -0.5f }, { 3.0f, -3.0f, 0.5f }, { 0.0f, 6.0f, 0.0f } };
+	Mesh.vIndices = { 0, 1, 2 };
+
+	COcclusionCuller Culler{};
+	Culler.SetResolution(KWidth, KHeight);
+	Culler.BeginFrame(XMMatrixIdentity(), XMVectorZero());
+	Culler.AddOccluder(&Mesh, XMMatrixIdentity(), XMFLOAT4(0, 0, 0, 6));
+	Culler.RasterizeOccluders();
+
+	CHECK(Culler.GetStatistics().TriangleCount == 1);
+	for (uint32_t iY = 0; iY < KHeight; ++iY)
+	{
+		for (uint32_t iX = 0; iX < KWidth; ++iX)
+		{
+			const float KX{ ((float)iX + 0.5f) / KWidth * 2.0f - 1.0f };
+			CHECK((KX > 0.0f) ? fabsf(Culler.GetDepth(iX, iY) - KX / 6.0f) < 1e-5f : Culler.GetDepth(iX, iY) == 1.0f);
+		}
+	}
+}
+
+TEST_CASE(OcclusionCuller_TestsAgainstTheFarthestDepth)
+{
+	COcclusionCuller Culler{};
+	RasterizeKnownScene(Culler, 1, nullptr);
+	CHECK(Culler.GetPyramidLevelCount() == 5); // 16x8, 8x4, 4x2, 2x1, 1x1
+
+	// Behind the quad, in front of it, and straddling its edge (the uncovered texels keep it visible)
+	CHECK(!Culler.IsVisible(XMFLOAT3(-0.2f, 0.2f, 0.6f), XMFLOAT3(0.1f, 0.1f, 0.05f)));
+	CHECK(Culler.IsVisible(XMFLOAT3(-0.2f, 0.2f, 0.05f), XMFLOAT3(0.1f, 0.1f, 0.01f)));
+	CHECK(Culler.IsVisible(XMFLOAT3(-0.5f, 0.2f, 0.6f), XMFLOAT3(0.1f, 0.1f, 0.05f)));
+	// Behind the left of the quad, but in front of its right (farther) side
+	CHECK(Culler.IsVisible(XMFLOAT3(0.0f, 0.0f, 0.3f), XMFLOAT3(0.45f, 0.45f, 0.01f)));
+	// Crossing the near plane
+	CHECK(Culler.IsVisible(XMFLOAT3(-0.2f, 0.2f, 0.0f), XMFLOAT3(0.1f, 0.1f, 0.05f)));
+
+	// @important: the pyramid is conservative, a box is only occluded when every pixel its bounds touch is nearer than the box
+	uint32_t Seed{ 5 };
+	auto Random{ [&Seed](float Min, float Max) { Seed = Seed * 1664525u + 1013904223u; return Min + (Max - Min) * (float)(Seed >> 8) / (float)(1 << 24); } };
+	uint32_t OccludedCount{};
+	uint32_t WrongCount{};
+	for (uint32_t iBox = 0; iBox < 2000; ++iBox)
+	{
+		const XMFLOAT3 KCenter{ Random(-0.8f, 0.8f), Random(-0.8f, 0.8f), Random(0.1f, 0.9f) };
+		const XMFLOAT3 KExtents{ Random(0.01f, 0.3f), Random(0.01f, 0.3f), Random(0.0f, 0.05f) };
+		if (Culler.IsVisible(KCenter, KExtents)) continue;
+		++OccludedCount;
+
+		// Every pixel overlapping the box's bounds
+		const int32_t KMinX{ std::max((int32_t)floorf(((KCenter.x - KExtents.x) * 0.5f + 0.5f) * KWidth), 0) };
+		const int32_t KMaxX{ std::min((int32_t)floorf(((KCenter.x + KExtents.x) * 0.5f + 0.5f) * KWidth), (int32_t)KWidth - 1) };
+		const int32_t KMinY{ std::max((int32_t)floorf((0.5f - (KCenter.y + KExtents.y) * 0.5f) * KHeight), 0) };
+		const int32_t KMaxY{ std::min((int32_t)floorf((0.5f - (KCenter.y - KExtents.y) * 0.5f) * KHeight), (int32_t)KHeight - 1) };
+		for (int32_t iY = KMinY; iY <= KMaxY; ++iY)
+		{
+			for (int32_t iX = KMinX; iX <= KMaxX; ++iX)
+			{
+				if (Culler.GetDepth((uint32_t)iX, (uint32_t)iY) >= KCenter.z - KExtents.z) ++WrongCount;
+			}
+		}
+	}
+	CHECK(OccludedCount > 50);
+	CHECK(WrongCount == 0);
+	CHECK(Culler.GetStatistics().OccludedCount == OccludedCount + 1);
+}
+
+TEST_CASE(OcclusionCuller_KeepsTheLargestOccludersWithinTheBudget)
+{
+	const SOccluderMesh KBox{ COcclusionCuller::CreateBoxOccluderMesh(XMFLOAT3(1, 1, 1)) };
+	CHECK(KBox.vPositions.size() == 8 && KBox.vIndices.size() == 36);
+
+	// Three boxes in front of a camera at the origin, the nearest one is the largest on screen
+	const XMMATRIX KViewProjection{ XMMatrixPerspectiveFovLH(XM_PIDIV2, 2.0f, 0.1f, 100.0f) };
+	// @important: the default resolution, so that even the farthest box covers a few pixels
+	COcclusionCuller Culler{};
+	Culler.SetResolution(COcclusionCuller::KDefaultWidth, COcclusionCuller::KDefaultHeight);
+	Culler.SetBudget(2, 24);
+	Culler.BeginFrame(KViewProjection, XMVectorZero());
+	Culler.AddOccluder(&KBox, XMMatrixTranslation(0, 0, 40), XMFLOAT4(0, 0, 40, 1.7f));
+	Culler.AddOccluder(&KBox, XMMatrixTranslation(-2, 0, 5), XMFLOAT4(-2, 0, 5, 1.7f));
+	Culler.AddOccluder(&KBox, XMMatrixTranslation(2, 0, 10), XMFLOAT4(2, 0, 10, 1.7f));
+	Culler.RasterizeOccluders();
+
+	CHECK(Culler.GetStatistics().QueuedOccluderCount == 3);
+	CHECK(Culler.GetStatistics().OccluderCount == 2);
+	// The farthest box was dropped, so a box right behind it stays visible while one behind the nearest is occluded
+	CHECK(Culler.IsVisible(XMFLOAT3(0, 0, 50), XMFLOAT3(0.5f, 0.5f, 0.5f)));
+	CHECK(!Culler.IsVisible(XMFLOAT3(-4, 0, 10), XMFLOAT3(0.5f, 0.5f, 0.5f)));
+
+	// Within the budget, it's rasterized
+	Culler.SetBudget(3, 36);
+	Culler.BeginFrame(KViewProjection, XMVectorZero());
+	Culler.AddOccluder(&KBox, XMMatrixTranslation(0, 0, 40), XMFLOAT4(0, 0, 40, 1.7f));
+	Culler.RasterizeOccluders();
+	CHECK(!Culler.IsVisible(XMFLOAT3(0, 0, 50), XMFLOAT3(0.5f, 0.5f, 0.5f)));
+}
@@ -0,0 +1,162 @@
+#include "Test.h"
+#include "../Model/PoseEvaluator.h"
+#include "../Core/Material.h"
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+// A small rig (a non-bone root, 4 bones, a non-bone tip) with 2 animations
+// @important: every value is a small dyadic number and every rotation is the identity, so that each step of the bake is exact and
+// the golden textures are the same on every compiler & DirectXMath code path (SSE, FMA or scalar)
+static SMESHData MakeSmallRig()
+{
+	SMESHData Model{};
+	Model.bIsModelRigged = true;
+
+	auto AddNode{ [&Model](const char* const Name, int32_t ParentNodeIndex, const XMMATRIX& MatrixTransformation)
+	{
+		SMeshTreeNode Node{};
+		Node.Index = (int32_t)Model.vTreeNodes.size();
+		Node.Name = Name;
+		Node.ParentNodeIndex = ParentNodeIndex;
+		Node.MatrixTransformation = MatrixTransformation;
+		Node.MatrixBoneOffset = XMMatrixIdentity();
+		if (ParentNodeIndex >= 0) Model.vTreeNodes[ParentNodeIndex].vChildNodeIndices.emplace_back(Node.Index);
+		Model.umapTreeNodeNameToIndex[Node.Name] = Model.vTreeNodes.size();
+		Model.vTreeNodes.emplace_back(Node);
+		return Node.Index;
+	} };
+	auto MakeBone{ [&Model](int32_t NodeIndex, uint32_t BoneIndex, float OffsetY)
+	{
+		Model.vTreeNodes[NodeIndex].bIsBone = true;
+		Model.vTreeNodes[NodeIndex].BoneIndex = BoneIndex;
+		Model.vTreeNodes[NodeIndex].MatrixBoneOffset = XMMatrixTranslation(0.5f, OffsetY, 0.0f);
+	} };
+
+	const int32_t KRoot{ AddNode("root", -1, XMMatrixScaling(2.0f, 2.0f, 2.0f) * XMMatrixTranslation(0.5f, 0.0f, 0.25f)) };
+	const int32_t KHips{ AddNode("hips", KRoot, XMMatrixTranslation(0.0f, 1.0f, 0.0f)) };
+	const int32_t KSpine{ AddNode("spine", KHips, XMMatrixTranslation(0.0f, 0.5f, 0.0f)) };
+	const int32_t KHead{ AddNode("head", KSpine, XMMatrixTranslation(0.0f, 0.75f, 0.125f)) };
+	const int32_t KHand{ AddNode("hand", KSpine, XMMatrixScaling(0.5f, 0.5f, 0.5f) * XMMatrixTranslation(0.625f, 0.25f, 0.0f)) };
+	AddNode("tip", KHead, XMMatrixTranslation(0.0f, 0.25f, 0.0f));
+	MakeBone(KHips, 0, 1.0f);
+	MakeBone(KSpine, 1, 1.5f);
+	MakeBone(KHead, 2, 2.25f);
+	MakeBone(KHand, 3, 1.75f); // @important: not keyed by "wave", so it keeps its bind pose there
+
+	auto AddNodeAnimation{ [](SMeshAnimation& Animation, const char* const NodeName, float Step)
+	{
+		SMeshAnimation::SNodeAnimation NodeAnimation{};
+		NodeAnimation.Index = (uint32_t)Animation.vNodeAnimations.size();
+		NodeAnimation.Name = NodeName;
+		// Position keys on every tick, scaling keys on every other tick (interpolated halfway in between)
+		for (int32_t iTime = 0; iTime <= (int32_t)Animation.Duration; ++iTime)
+		{
+			const float KTime{ (float)iTime };
+			NodeAnimation.vPositionKeys.push_back({ KTime, XMVectorSet(Step * KTime, 0.5f + Step, 0.25f * KTime, 0.0f) });
+			if (iTime % 2 == 0) NodeAnimation.vScalingKeys.push_back({ KTime, XMVectorSet(1.0f + Step * KTime, 1.0f, 1.0f, 0.0f) });
+		}
+		NodeAnimation.vRotationKeys.push_back({ 0.0f, XMQuaternionIdentity() });
+		Animation.umapNodeAnimationNameToIndex[NodeAnimation.Name] = Animation.vNodeAnimations.size();
+		Animation.vNodeAnimations.emplace_back(NodeAnimation);
+	} };
+
+	Model.vAnimations.resize(2);
+	SMeshAnimation& Walk{ Model.vAnimations[0] };
+	Walk.Name = "walk";
+	Walk.Duration = 4.0f;
+	Walk.TicksPerSecond = 30.0f;
+	AddNodeAnimation(Walk, "hips", 0.25f);
+	AddNodeAnimation(Walk, "spine", 0.125f);
+	AddNodeAnimation(Walk, "head", 0.5f);
+	AddNodeAnimation(Walk, "hand", 0.0625f);
+
+	SMeshAnimation& Wave{ Model.vAnimations[1] };
+	Wave.Name = "wave_long_name_!"; // @important: longer than the 15 chars a texture stores
+	Wave.Duration = 3.0f;
+	Wave.TicksPerSecond = 24.0f;
+	AddNodeAnimation(Wave, "spine", 0.5f);
+	AddNodeAnimation(Wave, "head", 0.375f);
+	return Model;
+}
+
+static std::string GetGoldenFileName(const char* const Name)
+{
+	return std::string(EDITOR_TESTS_DIR) + "/Golden/" + Name;
+}
+
+// @important: set EDITOR_TESTS_UPDATE_GOLDEN=1 to rewrite the golden file after an intended change of the texture layout
+static bool MatchesGoldenFile(const char* const Name, const void* const PtrBytes, size_t ByteCount)
+{
+	const std::string KFileName{ GetGoldenFileName(Name) };
+	if (getenv("EDITOR_TESTS_UPDATE_GOLDEN"))
+	{
+		std::ofstream File{ KFileName, std::ofstream::binary | std::ofstream::trunc };
+		File.write((const char*)PtrBytes, (std::streamsize)ByteCount);
+		printf("  %s rewritten\n", KFileName.c_str());
+	}
+
+	std::ifstream File{ KFileName, std::ifstream::binary };
+	if (!File.is_open())
+	{
+		printf("  %s is missing\n", KFileName.c_str());
+		return false;
+	}
+	const std::vector<uint8_t> KGoldenBytes{ std::istreambuf_iterator<char>(File), std::istreambuf_iterator<char>() };
+	return (KGoldenBytes.size() == ByteCount) && (memcmp(KGoldenBytes.data(), PtrBytes, ByteCount) == 0);
+}
+
+TEST_CASE(PoseEvaluator_CountsBones)
+{
+	const SMESHData KModel{ MakeSmallRig() };
+	CPoseEvaluator PoseEvaluator{};
+	PoseEvaluator.Initialize(KModel);
+
+	CHECK(PoseEvaluator.GetBoneCount() == 4);
+	CHECK(PoseEvaluator.GetBoneMatrixCount() == 4);
+	CHECK(PoseEvaluator.GetLeafBoneCount() == 2); // head (its child isn't a bone) & hand
+	CHECK(PoseEvaluator.GetAnimationTextureBoneCount() == CPoseEvaluator::KAnimationTextureMinBoneCount);
+	CHECK(PoseEvaluator.GetAnimationTextureWidth() == 4 * (int32_t)CPoseEvaluator::KAnimationTextureMinBoneCount);
+	CHECK(PoseEvaluator.GetAnimationTextureHeight(false) == CPoseEvaluator::KAnimationTextureReservedHeight + 5 + 4);
+	CHECK(PoseEvaluator.GetAnimationTextureHeight(true) == CPoseEvaluator::KAnimationTextureReservedHeight + 1 + 5 + 4);
+}
+
+TEST_CASE(PoseEvaluator_BakesTheGoldenTexture)
+{
+	const SMESHData KModel{ MakeSmallRig() };
+	CPoseEvaluator PoseEvaluator{};
+	PoseEvaluator.Initialize(KModel);
+
+	std::vector<SBakedAnimation> vBakedAnimations{};
+	CHECK(PoseEvaluator.BakeAnimations(vBakedAnimations) == 2);
+
+	std::vector<SPixel128Float> vRawData{};
+	PoseEvaluator.BuildAnimationTextureData(vBakedAnimations, vRawData);
+	CHECK(vRawData.size() == (size_t)PoseEvaluator.GetAnimationTextureWidth() * PoseEvaluator.GetAnimationTextureHeight(false));
+	CHECK(MatchesGoldenFile("SmallRigAnimation128.bin", vRawData.data(), vRawData.size() * sizeof(SPixel128Float)));
+
+	std::vector<SPixel64Float> vHalfRawData{};
+	PoseEvaluator.BuildAnimationTextureData(vBakedAnimations, vHalfRawData);
+	CHECK(vHalfRawData.size() == (size_t)PoseEvaluator.GetAnimationTextureWidth() * PoseEvaluator.GetAnimationTextureHeight(true));
+	CHECK(MatchesGoldenFile("SmallRigAnimation64.bin", vHalfRawData.data(), vHalfRawData.size() * sizeof(SPixel64Float)));
+}
+
+TEST_CASE(PoseEvaluator_RebakesOnlyChangedAnimations)
+{
+	SMESHData Model{ MakeSmallRig() };
+	CPoseEvaluator PoseEvaluator{};
+	PoseEvaluator.Initialize(Model);
+
+	std::vector<SBakedAnimation> vBakedAnimations{};
+	CHECK(PoseEvaluator.BakeAnimations(vBakedAnimations) == 2);
+	const std::vector<SBakedAnimation> KFirstBake{ vBakedAnimations };
+	CHECK(PoseEvaluator.BakeAnimations(vBakedAnimations) == 0);
+
+	Model.vAnimations[1].vNodeAnimations[0].vPositionKeys[1].Value = XMVectorSet(4.0f, 0.0f, 0.0f, 0.0f);
+	CHECK(PoseEvaluator.BakeAnimations(vBakedAnimations) == 1);
+	CHECK(vBakedAnimations[0].Hash == KFirstBake[0].Hash);
+	CHECK(memcmp(vBakedAnimations[0].vBoneMatrices.data(), KFirstBake[0].vBoneMatrices.data(),
+		KFirstBake[0].vBoneMatrices.size() * sizeof(XMFLOAT4X4)) == 0);
+	CHECK(vBakedAnimations[1].Hash != KFirstBake[1].Hash);
+}
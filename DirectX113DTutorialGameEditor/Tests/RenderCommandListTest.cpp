@@ -0,0 +1,139 @@
+#include "Test.h"
+#include "../Core/RenderCommandList.h"
+#include "../Core/TaskScheduler.h"
+
+// A synthetic frame recorded like CGame records its opaque passes (see CGame::RecordOpaqueObject3Ds())
+// 8 objects of 2 meshes each: objects 0-3 use shader set 1 and objects 4-7 shader set 2,
+// even objects use material sets 0 & 1 and odd ones 2 & 3 (shared, see CGame::UpdateObject3DMaterialSets())
+// and object 0 is the farthest from the camera
+static constexpr uint32_t KPassOpaque{ 1 };
+static constexpr uint32_t KPassDepthOnly{ 0 };
+static constexpr uint32_t KObjectCount{ 8 };
+static constexpr uint32_t KMeshCount{ 2 };
+static constexpr float KZFar{ 1000.0f };
+
+static void RecordPass(uint32_t Pass, const std::vector<uint32_t>& vObjectIndices, CDrawPacketQueue& Queue, CRenderCommandList& CommandList)
+{
+	Queue.Clear();
+	for (uint32_t ObjectIndex : vObjectIndices)
+	{
+		const uint32_t KShaderSet{ (ObjectIndex < 4) ? 1u : 2u };
+		const uint32_t KDepthBucket{ CDrawPacketQueue::QuantizeDepth(10.0f * (float)(KObjectCount - ObjectIndex), KZFar) };
+		for (uint32_t iMesh = 0; iMesh < KMeshCount; ++iMesh)
+		{
+			const uint32_t KMaterialSet{ (ObjectIndex % 2) * 2 + iMesh };
+			Queue.Push(CDrawPacketQueue::MakeSortKey(Pass, KShaderSet, KMaterialSet, KDepthBucket), ObjectIndex, iMesh);
+		}
+	}
+	Queue.Sort();
+
+	CommandList.Clear();
+	CommandList.RecordDrawPackets(Queue.GetPackets());
+}
+
+struct SPassCommandCounts
+{
+	uint32_t	ShaderSetCount{};
+	uint32_t	ObjectStatesCount{};
+	uint32_t	MaterialCount{};
+	uint32_t	DrawCount{};
+};
+
+static bool HasCommandCounts(const CNullRenderBackend& Backend, const SPassCommandCounts& Expected)
+{
+	return
+		Backend.GetCommandCount(ERenderCommandType::SetShaderSet) == Expected.ShaderSetCount &&
+		Backend.GetCommandCount(ERenderCommandType::SetObjectStates) == Expected.ObjectStatesCount &&
+		Backend.GetCommandCount(ERenderCommandType::SetMaterial) == Expected.MaterialCount &&
+		Backend.GetCommandCount(ERenderCommandType::DrawMesh) == Expected.DrawCount;
+}
+
+TEST_CASE(RenderCommandList_RecordsAHeadlessFrame)
+{
+	// The main pass draws every object, cascade 0 casts objects 0-3 and cascade 1 objects 2-7
+	const std::vector<std::vector<uint32_t>> KPassObjectIndices{ { 0, 1, 2, 3, 4, 5, 6, 7 }, { 0, 1, 2, 3 }, { 2, 3, 4, 5, 6, 7 } };
+	const uint32_t KPasses[]{ KPassOpaque, KPassDepthOnly, KPassDepthOnly };
+
+	// @important: sorted by material before depth, so the main pass goes (object, mesh) 2-0, 0-0, 2-1, 0-1, 3-0, 1-0, 3-1, 1-1, 6-0, ...
+	// and switches objects on every draw
+	const SPassCommandCounts KExpectedCounts[]
+	{
+		{ 2, 16, 8, 16 },
+		{ 1, 8, 4, 8 },
+		{ 2, 10, 8, 12 }, // 2-0, 2-1, 3-0, 3-1, then the same order as the main pass
+	};
+
+	CTaskScheduler TaskScheduler{};
+	TaskScheduler.Start(2);
+	TaskScheduler.Wait();
+
+	// @important: the lists and the queues are kept between frames, as in the game
+	std::vector<CRenderCommandList> vCommandLists(3);
+	std::vector<CDrawPacketQueue> vQueues(3);
+	for (uint32_t iFrame = 0; iFrame < 2; ++iFrame)
+	{
+		CRenderCommandList::RecordInParallel(vCommandLists,
+			[&](size_t iPass, CRenderCommandList& CommandList) { RecordPass(KPasses[iPass], KPassObjectIndices[iPass], vQueues[iPass], CommandList); },
+			TaskScheduler);
+
+		CNullRenderBackend FrameBackend{};
+		uint32_t FrameDrawCount{};
+		for (size_t iPass = 0; iPass < vCommandLists.size(); ++iPass)
+		{
+			const CRenderCommandList& KCommandList{ vCommandLists[iPass] };
+			CNullRenderBackend PassBackend{};
+			KCommandList.Replay(PassBackend);
+			KCommandList.Replay(FrameBackend);
+			CHECK(HasCommandCounts(PassBackend, KExpectedCounts[iPass]));
+
+			// The list counts what it recorded, and its state tracker what it skipped (3 states checked per draw)
+			for (uint32_t iType = 0; iType < (uint32_t)ERenderCommandType::COUNT; ++iType)
+			{
+				CHECK(KCommandList.GetCommandCount((ERenderCommandType)iType) == PassBackend.GetCommandCount((ERenderCommandType)iType));
+			}
+			const SPassCommandCounts& KExpected{ KExpectedCounts[iPass] };
+			const uint32_t KStateCount{ KExpected.ShaderSetCount + KExpected.ObjectStatesCount + KExpected.MaterialCount };
+			CHECK(KCommandList.GetStateTracker().GetStateChangeCount() == KStateCount);
+			CHECK(KCommandList.GetStateTracker().GetAvoidedStateChangeCount() == KExpected.DrawCount * 3 - KStateCount);
+			CHECK(KCommandList.GetCommands().size() == KStateCount + KExpected.DrawCount);
+			FrameDrawCount += KExpected.DrawCount;
+		}
+		CHECK(FrameBackend.GetCommandCount(ERenderCommandType::DrawMesh) == FrameDrawCount);
+	}
+
+	// A cascade that isn't updated this frame records nothing
+	vCommandLists[2].Clear();
+	CNullRenderBackend Backend{};
+	vCommandLists[2].Replay(Backend);
+	CHECK(HasCommandCounts(Backend, SPassCommandCounts()));
+}
+
+TEST_CASE(RenderCommandList_ReplaysInRecordedOrder)
+{
+	CDrawPacketQueue Queue{};
+	CRenderCommandList CommandList{};
+	RecordPass(KPassOpaque, { 4, 0 }, Queue, CommandList);
+
+	// Shader set 1 (object 0) first, and each object's meshes in the order of their material sets
+	const ERenderCommandType KSetShaderSet{ ERenderCommandType::SetShaderSet };
+	const ERenderCommandType KSetObjectStates{ ERenderCommandType::SetObjectStates };
+	const ERenderCommandType KSetMaterial{ ERenderCommandType::SetMaterial };
+	const ERenderCommandType KDrawMesh{ ERenderCommandType::DrawMesh };
+	const std::vector<SRenderCommand> KExpectedCommands
+	{
+		{ KSetShaderSet, 0, 0, 1 }, { KSetObjectStates, 0, 0, 0 }, { KSetMaterial, 0, 0, 0 }, { KDrawMesh, 0, 0, 0 },
+		{ KSetMaterial, 0, 1, 0 }, { KDrawMesh, 0, 1, 0 },
+		{ KSetShaderSet, 0, 0, 2 }, { KSetObjectStates, 4, 0, 0 }, { KSetMaterial, 4, 0, 0 }, { KDrawMesh, 4, 0, 0 },
+		{ KSetMaterial, 4, 1, 0 }, { KDrawMesh, 4, 1, 0 },
+	};
+	const std::vector<SRenderCommand>& KCommands{ CommandList.GetCommands() };
+	CHECK(KCommands.size() == KExpectedCommands.size());
+	bool bIsSame{ KCommands.size() == KExpectedCommands.size() };
+	for (size_t iCommand = 0; bIsSame && iCommand < KCommands.size(); ++iCommand)
+	{
+		const SRenderCommand& A{ KCommands[iCommand] };
+		const SRenderCommand& B{ KExpectedCommands[iCommand] };
+		bIsSame = (A.eType == B.eType && A.ObjectIndex == B.ObjectIndex && A.MeshIndex == B.MeshIndex && A.ShaderSet == B.ShaderSet);
+	}
+	CHECK(bIsSame);
+}
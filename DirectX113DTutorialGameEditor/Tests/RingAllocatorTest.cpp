@@ -0,0 +1,112 @@
+#include "Test.h"
+#include "../Core/RingAllocator.h"
+
+TEST_CASE(RingAllocator_AlignsAllocations)
+{
+	CRingAllocator RingAllocator{};
+	RingAllocator.Create(1000, 256);
+	CHECK(RingAllocator.GetByteCapacity() == 768);
+	CHECK(RingAllocator.GetAlignment() == 256);
+
+	uint32_t Offset{};
+	CHECK(RingAllocator.Allocate(1, Offset) && Offset == 0);
+	CHECK(RingAllocator.Allocate(257, Offset) && Offset == 256);
+	CHECK(RingAllocator.GetUsedByteSize() == 768);
+
+	CHECK(!RingAllocator.Allocate(0, Offset));
+	CHECK(!RingAllocator.Allocate(1, Offset));
+}
+
+TEST_CASE(RingAllocator_RetiresFencedFrames)
+{
+	CRingAllocator RingAllocator{};
+	RingAllocator.Create(1024, 256);
+
+	uint32_t Offset{};
+	for (uint32_t iAllocation = 0; iAllocation < 4; ++iAllocation)
+	{
+		CHECK(RingAllocator.Allocate(256, Offset) && Offset == iAllocation * 256);
+	}
+	CHECK(!RingAllocator.Allocate(256, Offset));
+	CHECK(!RingAllocator.HasPendingFrame());
+
+	RingAllocator.EndFrame(1);
+	CHECK(RingAllocator.HasPendingFrame() && RingAllocator.GetOldestPendingFenceValue() == 1);
+
+	RingAllocator.Retire(0);
+	CHECK(RingAllocator.GetUsedByteSize() == 1024);
+
+	RingAllocator.Retire(1);
+	CHECK(RingAllocator.GetUsedByteSize() == 0);
+	CHECK(!RingAllocator.HasPendingFrame());
+
+	// Restarts from the beginning when nothing is in flight
+	CHECK(RingAllocator.Allocate(256, Offset) && Offset == 0);
+}
+
+TEST_CASE(RingAllocator_WrapsAround)
+{
+	CRingAllocator RingAllocator{};
+	RingAllocator.Create(1024, 256);
+
+	uint32_t Offset{};
+	CHECK(RingAllocator.Allocate(512, Offset) && Offset == 0);
+	RingAllocator.EndFrame(1);
+	CHECK(RingAllocator.Allocate(256, Offset) && Offset == 512);
+	RingAllocator.EndFrame(2);
+	RingAllocator.Retire(1);
+	CHECK(RingAllocator.GetUsedByteSize() == 256);
+
+	// Doesn't fit at the end, so the last 256 bytes are skipped and belong to this frame
+	CHECK(RingAllocator.Allocate(512, Offset) && Offset == 0);
+	CHECK(RingAllocator.GetUsedByteSize() == 1024);
+	CHECK(!RingAllocator.Allocate(256, Offset));
+	RingAllocator.EndFrame(3);
+
+	RingAllocator.Retire(2);
+	CHECK(RingAllocator.GetUsedByteSize() == 768);
+
+	// In flight: [0, 512) of frame 3, free: [512, 768)
+	CHECK(RingAllocator.Allocate(256, Offset) && Offset == 512);
+	RingAllocator.EndFrame(4);
+
+	RingAllocator.Retire(4);
+	CHECK(RingAllocator.GetUsedByteSize() == 0);
+}
+
+TEST_CASE(RingAllocator_NeverHandsOutBytesInFlight)
+{
+	static constexpr uint32_t KByteCapacity{ 4096 };
+	static constexpr uint32_t KFramesInFlight{ 3 };
+
+	CRingAllocator RingAllocator{};
+	RingAllocator.Create(KByteCapacity, 16);
+
+	// Owner frame of every byte, 0 when free
+	std::vector<uint64_t> vOwners(KByteCapacity);
+	uint64_t Fence{};
+	uint32_t Seed{ 1 };
+	for (uint32_t iFrame = 0; iFrame < 1000; ++iFrame)
+	{
+		++Fence;
+		for (uint32_t iAllocation = 0; iAllocation < 4; ++iAllocation)
+		{
+			Seed = Seed * 1664525 + 1013904223;
+			const uint32_t KByteSize{ 1 + (Seed >> 8) % 400 };
+
+			uint32_t Offset{};
+			if (!RingAllocator.Allocate(KByteSize, Offset)) continue;
+
+			CHECK(Offset % 16 == 0);
+			CHECK(Offset + KByteSize <= KByteCapacity);
+			for (uint32_t iByte = Offset; iByte < Offset + KByteSize; ++iByte)
+			{
+				CHECK(vOwners[iByte] == 0 || vOwners[iByte] + KFramesInFlight < Fence);
+				vOwners[iByte] = Fence;
+			}
+		}
+		RingAllocator.EndFrame(Fence);
+
+		if (Fence > KFramesInFlight) RingAllocator.Retire(Fence - KFramesInFlight);
+	}
+}
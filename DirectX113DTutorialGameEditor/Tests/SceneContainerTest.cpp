@@ -0,0 +1,197 @@
+#include "Test.h"
+#include "../Core/SceneContainer.h"
+#include <filesystem>
+#include <fstream>
+
+static std::string GetTemporaryFileName(const char* const Name)
+{
+	return (std::filesystem::temp_directory_path() / Name).string();
+}
+
+// Compressible (a smooth ramp) and large enough to be compressed, with the object index in front
+static void WriteObjectChunk(CBinaryData& ChunkBinary, uint32_t ObjectIndex)
+{
+	static constexpr uint32_t KFloatCount{ 4096 };
+	std::vector<float> vValues(KFloatCount);
+	for (uint32_t iValue = 0; iValue < KFloatCount; ++iValue) vValues[iValue] = (float)(ObjectIndex * KFloatCount + iValue) * 0.01f;
+
+	ChunkBinary.WriteUint32(ObjectIndex);
+	ChunkBinary.WriteArray(vValues);
+}
+
+static bool ReadObjectChunk(CBinaryData& ChunkBinary, uint32_t ObjectIndex)
+{
+	std::vector<float> vValues{};
+	if (ChunkBinary.ReadUint32() != ObjectIndex || !ChunkBinary.ReadArray(vValues, 4096)) return false;
+	for (uint32_t iValue = 0; iValue < (uint32_t)vValues.size(); ++iValue)
+	{
+		if (vValues[iValue] != (float)(ObjectIndex * 4096 + iValue) * 0.01f) return false;
+	}
+	return ChunkBinary.GetRemainingByteCount() == 0;
+}
+
+static void SaveTestScene(const std::string& FileName, bool bShouldCompress)
+{
+	CSceneContainer SceneContainer{};
+	CBinaryData ChunkBinary{};
+	ChunkBinary.WriteStringWithPrefixedLength("terrain.terr");
+	SceneContainer.AddChunk(ESceneChunkType::Terrain, ChunkBinary);
+	for (uint32_t iObject3D = 0; iObject3D < 3; ++iObject3D)
+	{
+		WriteObjectChunk(ChunkBinary, iObject3D);
+		SceneContainer.AddChunk(ESceneChunkType::Object3D, ChunkBinary);
+	}
+	CHECK(ChunkBinary.GetBytes().empty());
+	CHECK(SceneContainer.SaveToFile(FileName, bShouldCompress));
+}
+
+TEST_CASE(SceneContainer_RoundTripsChunks)
+{
+	const std::string KFileName{ GetTemporaryFileName("EditorTests_SceneContainer.scene") };
+	for (bool bShouldCompress : { false, true })
+	{
+		SaveTestScene(KFileName, bShouldCompress);
+
+		CSceneContainer SceneContainer{};
+		CHECK(CSceneContainer::IsSceneContainer(KFileName));
+		CHECK(SceneContainer.Open(KFileName));
+		CHECK(SceneContainer.IsOpen());
+		CHECK(SceneContainer.Verify());
+		CHECK(SceneContainer.GetChunks().size() == 4);
+		CHECK(SceneContainer.GetChunkCount(ESceneChunkType::Object3D) == 3);
+		CHECK(SceneContainer.GetChunkCount(ESceneChunkType::Lights) == 0);
+
+		// @important: only the large chunks are compressed, and every chunk stays aligned in the mapped file
+		for (const auto& Chunk : SceneContainer.GetChunks())
+		{
+			CHECK(Chunk.Offset % CSceneContainer::KChunkAlignment == 0);
+			CHECK(Chunk.bIsCompressed == (bShouldCompress && Chunk.eType == ESceneChunkType::Object3D));
+			CHECK((Chunk.bIsCompressed) ? Chunk.ByteCount < Chunk.RawByteCount : Chunk.ByteCount == Chunk.RawByteCount);
+		}
+
+		CBinaryData ChunkBinary{};
+		std::string TerrainFileName{};
+		CHECK(SceneContainer.ReadChunk(ESceneChunkType::Terrain, ChunkBinary, 0, true));
+		CHECK(ChunkBinary.ReadStringWithPrefixedLength(TerrainFileName) && TerrainFileName == "terrain.terr");
+		for (uint32_t iObject3D = 0; iObject3D < 3; ++iObject3D)
+		{
+			CHECK(SceneContainer.ReadChunk(ESceneChunkType::Object3D, ChunkBinary, iObject3D, true));
+			CHECK(ReadObjectChunk(ChunkBinary, iObject3D));
+		}
+		CHECK(!SceneContainer.ReadChunk(ESceneChunkType::Object3D, ChunkBinary, 3));
+		CHECK(!SceneContainer.ReadChunk(ESceneChunkType::Lights, ChunkBinary));
+
+		SceneContainer.Close();
+		CHECK(!SceneContainer.IsOpen());
+	}
+
+	std::error_code ErrorCode{};
+	std::filesystem::remove(KFileName, ErrorCode);
+}
+
+TEST_CASE(SceneContainer_DetectsDamagedChunks)
+{
+	const std::string KFileName{ GetTemporaryFileName("EditorTests_SceneContainer_Damaged.scene") };
+	for (bool bShouldCompress : { false, true })
+	{
+		SaveTestScene(KFileName, bShouldCompress);
+
+		// Flips a byte in the middle of the second object
+		uint64_t DamagedOffset{};
+		{
+			CSceneContainer SceneContainer{};
+			CHECK(SceneContainer.Open(KFileName));
+			const CSceneContainer::SChunk& KChunk{ SceneContainer.GetChunks()[2] };
+			CHECK(KChunk.eType == ESceneChunkType::Object3D);
+			DamagedOffset = KChunk.Offset + KChunk.ByteCount / 2;
+		}
+		{
+			std::fstream File{ KFileName, std::fstream::in | std::fstream::out | std::fstream::binary };
+			File.seekg((std::streamoff)DamagedOffset);
+			char Byte{};
+			File.read(&Byte, 1);
+			Byte ^= 0x5A;
+			File.seekp((std::streamoff)DamagedOffset);
+			File.write(&Byte, 1);
+		}
+
+		// @important: the table of contents still opens, only the damaged chunk fails its hash
+		CSceneContainer SceneContainer{};
+		CHECK(SceneContainer.Open(KFileName));
+		CHECK(!SceneContainer.Verify());
+		CBinaryData ChunkBinary{};
+		CHECK(SceneContainer.ReadChunk(ESceneChunkType::Object3D, ChunkBinary, 0, true));
+		CHECK(!SceneContainer.ReadChunk(ESceneChunkType::Object3D, ChunkBinary, 1, true));
+		CHECK(SceneContainer.ReadChunk(ESceneChunkType::Object3D, ChunkBinary, 2, true));
+	}
+
+	std::error_code ErrorCode{};
+	std::filesystem::remove(KFileName, ErrorCode);
+}
+
+TEST_CASE(SceneContainer_RejectsOtherFiles)
+{
+	const std::string KFileName{ GetTemporaryFileName("EditorTests_SceneContainer_Other.scene") };
+	{
+		std::ofstream File{ KFileName, std::ofstream::binary | std::ofstream::trunc };
+		File << "KJW_SCN";
+	}
+
+	CSceneContainer SceneContainer{};
+	CHECK(!CSceneContainer::IsSceneContainer(KFileName));
+	CHECK(!SceneContainer.Open(KFileName));
+	CHECK(!SceneContainer.IsOpen());
+	CHECK(!CSceneContainer::IsSceneContainer(KFileName + ".missing"));
+	CHECK(!SceneContainer.Open(KFileName + ".missing"));
+
+	std::error_code ErrorCode{};
+	std::filesystem::remove(KFileName, ErrorCode);
+}
+
+TEST_CASE(SceneContainer_IncrementalSavesMatchFullSaves)
+{
+	const std::string KFileName{ GetTemporaryFileName("EditorTests_SceneContainer_Incremental.scene") };
+	for (bool bShouldCompress : { false, true })
+	{
+		// @important: whatever changed, an incremental save writes the same file as a full one
+		std::vector<CSceneContainer::SIncrementalSaveBenchmark> vBenchmarks{};
+		CHECK(CSceneContainer::MeasureIncrementalSaveTime(KFileName, 16, 16 * 1024, { 0, 1, 4, 16 }, bShouldCompress, vBenchmarks));
+		CHECK(vBenchmarks.size() == 4);
+		for (const auto& Benchmark : vBenchmarks)
+		{
+			CHECK(Benchmark.bIsIdentical);
+		}
+		CHECK(!std::filesystem::exists(KFileName) && !std::filesystem::exists(KFileName + ".full"));
+
+		// Only the changed chunks are encoded again, and an unchanged scene isn't written at all
+		CSceneContainer::SSaveCache SaveCache{};
+		auto Save{ [&](uint32_t ChangedObjectIndex)
+		{
+			CSceneContainer SceneContainer{};
+			CBinaryData ChunkBinary{};
+			for (uint32_t iObject3D = 0; iObject3D < 3; ++iObject3D)
+			{
+				WriteObjectChunk(ChunkBinary, (iObject3D == ChangedObjectIndex) ? iObject3D + 3 : iObject3D);
+				SceneContainer.AddChunk(ESceneChunkType::Object3D, ChunkBinary);
+			}
+			CHECK(SceneContainer.SaveToFile(KFileName, bShouldCompress, &SaveCache));
+		} };
+		Save(UINT32_MAX);
+		CHECK(SaveCache.LastChunkCount == 3 && SaveCache.LastDirtyChunkCount == 3 && SaveCache.bWasLastFileWritten);
+		Save(UINT32_MAX);
+		CHECK(SaveCache.LastDirtyChunkCount == 0 && !SaveCache.bWasLastFileWritten);
+		Save(1);
+		CHECK(SaveCache.LastDirtyChunkCount == 1 && SaveCache.bWasLastFileWritten);
+
+		CSceneContainer SceneContainer{};
+		CBinaryData ChunkBinary{};
+		CHECK(SceneContainer.Open(KFileName));
+		CHECK(SceneContainer.Verify());
+		CHECK(SceneContainer.ReadChunk(ESceneChunkType::Object3D, ChunkBinary, 1, true) && ReadObjectChunk(ChunkBinary, 4));
+		CHECK(SceneContainer.ReadChunk(ESceneChunkType::Object3D, ChunkBinary, 2, true) && ReadObjectChunk(ChunkBinary, 2));
+		SceneContainer.Close();
+
+		std::error_code ErrorCode{};
+		std::filesystem::remove(KFileName, ErrorCode);
+	}
+}
@@ -0,0 +1,135 @@
+#include "Test.h"
+#include "../Core/ShadowCasterCuller.h"
+#include <cmath>
+
+using namespace DirectX;
+
+// View slice z in [ZNear, ZFar], x & y in [-HalfSize, HalfSize] (in the order of SFrustumVertices: near then far, upper then lower)
+static void SetViewSlice(SShadowCascadeVolume& Volume, float ZNear, float ZFar, float HalfSize)
+{
+	for (int iVertex = 0; iVertex < 8; ++iVertex)
+	{
+		const float KX{ (iVertex & 1) ? +HalfSize : -HalfSize };
+		const float KY{ (iVertex & 2) ? -HalfSize : +HalfSize };
+		const float KZ{ (iVertex & 4) ? ZFar : ZNear };
+		Volume.ViewSliceVertices[iVertex] = XMVectorSet(KX, KY, KZ, 1.0f);
+	}
+}
+
+static bool IsNear(const XMVECTOR& A, const XMVECTOR& B)
+{
+	XMFLOAT4 Difference{};
+	XMStoreFloat4(&Difference, A - B);
+	return fabsf(Difference.x) < 1e-5f && fabsf(Difference.y) < 1e-5f && fabsf(Difference.z) < 1e-5f && fabsf(Difference.w) < 1e-5f;
+}
+
+// The light shines along +z onto the slice z in [0, 20], through the box x & y in [-10, 10], z in [-50, 50]
+static SShadowCascadeVolume MakeAlignedCascade()
+{
+	SShadowCascadeVolume Volume{};
+	Volume.LightPosition = XMVectorSet(0, 0, -50, 1);
+	Volume.LightForward = XMVectorSet(0, 0, 1, 0);
+	Volume.LightUp = XMVectorSet(0, 1, 0, 0);
+	Volume.LightRight = XMVectorSet(1, 0, 0, 0);
+	Volume.HalfSize = XMFLOAT3(10, 10, 50);
+	SetViewSlice(Volume, 0, 20, 5);
+	return Volume;
+}
+
+TEST_CASE(ShadowCasterCuller_CalculatesKnownPlanes)
+{
+	const SShadowCascadeVolume KVolume{ MakeAlignedCascade() };
+
+	XMVECTOR CasterVolumePlanes[5]{};
+	CShadowCasterCuller::CalculateCasterVolumePlanes(KVolume, CasterVolumePlanes);
+	CHECK(IsNear(CasterVolumePlanes[0], XMVectorSet(+1, 0, 0, -10)));
+	CHECK(IsNear(CasterVolumePlanes[1], XMVectorSet(-1, 0, 0, -10)));
+	CHECK(IsNear(CasterVolumePlanes[2], XMVectorSet(0, +1, 0, -10)));
+	CHECK(IsNear(CasterVolumePlanes[3], XMVectorSet(0, -1, 0, -10)));
+	CHECK(IsNear(CasterVolumePlanes[4], XMVectorSet(0, 0, +1, -50)));
+
+	// @important: every plane points outward, whatever the winding of its face
+	XMVECTOR ViewSlicePlanes[6]{};
+	CShadowCasterCuller::CalculateViewSlicePlanes(KVolume.ViewSliceVertices, ViewSlicePlanes);
+	CHECK(IsNear(ViewSlicePlanes[0], XMVectorSet(0, 0, -1, 0)));
+	CHECK(IsNear(ViewSlicePlanes[1], XMVectorSet(0, 0, +1, -20)));
+	CHECK(IsNear(ViewSlicePlanes[2], XMVectorSet(-1, 0, 0, -5)));
+	CHECK(IsNear(ViewSlicePlanes[3], XMVectorSet(+1, 0, 0, -5)));
+	CHECK(IsNear(ViewSlicePlanes[4], XMVectorSet(0, +1, 0, -5)));
+	CHECK(IsNear(ViewSlicePlanes[5], XMVectorSet(0, -1, 0, -5)));
+}
+
+TEST_CASE(ShadowCasterCuller_KeepsCastersTowardTheLight)
+{
+	CShadowCasterCuller ShadowCasterCuller{};
+	ShadowCasterCuller.SetCascade(MakeAlignedCascade());
+
+	// Inside the box and over the slice
+	CHECK(ShadowCasterCuller.IsCaster(XMFLOAT4(0, 0, 10, 1)));
+
+	// @important: behind the box toward the light, its shadow still falls into the cascade
+	CHECK(ShadowCasterCuller.IsCaster(XMFLOAT4(0, 0, -80, 1)));
+	CHECK(ShadowCasterCuller.IsCaster(XMFLOAT4(4, -4, -1000, 1)));
+
+	// Beyond the far side of the box
+	CHECK(!ShadowCasterCuller.IsCaster(XMFLOAT4(0, 0, 70, 1)));
+	CHECK(!ShadowCasterCuller.IsCaster(XMFLOAT4(0, 0, 1000, 50)));
+
+	// Beside the box
+	CHECK(!ShadowCasterCuller.IsCaster(XMFLOAT4(12, 0, 0, 1)));
+
+	// Inside the box, but its shadow passes beside the slice
+	CHECK(!ShadowCasterCuller.IsCaster(XMFLOAT4(8, 0, -20, 1)));
+	CHECK(ShadowCasterCuller.IsCaster(XMFLOAT4(5.5f, 0, -20, 1))); // its shadow grazes the slice
+}
+
+TEST_CASE(ShadowCasterCuller_SkipsCastersOfSmallerCascades)
+{
+	// The view looks along +z and the light shines down (-y), cascade 0 covers z in [0, 20] and cascade 1 z in [20, 60]
+	SShadowCascadeVolume Cascades[2]{};
+	for (int iCascade = 0; iCascade < 2; ++iCascade)
+	{
+		SShadowCascadeVolume& Volume{ Cascades[iCascade] };
+		Volume.LightForward = XMVectorSet(0, -1, 0, 0);
+		Volume.LightUp = XMVectorSet(0, 0, 1, 0);
+		Volume.LightRight = XMVectorSet(1, 0, 0, 0);
+	}
+	Cascades[0].LightPosition = XMVectorSet(0, 50, 10, 1);
+	Cascades[0].HalfSize = XMFLOAT3(12, 15, 40);
+	SetViewSlice(Cascades[0], 0, 20, 10);
+
+	// @important: like real cascades, the larger box also covers most of the smaller cascade's slice
+	Cascades[1].LightPosition = XMVectorSet(0, 50, 40, 1);
+	Cascades[1].HalfSize = XMFLOAT3(12, 32, 40);
+	SetViewSlice(Cascades[1], 20, 60, 10);
+
+	// Above the slice of cascade 0, so its shadow only falls on receivers cascade 0 already covers
+	const XMFLOAT4 KCaster{ 0, 30, 10, 1 };
+
+	XMVECTOR CasterVolumePlanes[5]{};
+	CShadowCasterCuller::CalculateCasterVolumePlanes(Cascades[1], CasterVolumePlanes);
+	CFrustumCuller CasterVolumeCuller{};
+	CasterVolumeCuller.SetPlanes(CasterVolumePlanes, 5);
+	CHECK(CasterVolumeCuller.IsVisible(KCaster));
+
+	CShadowCasterCuller ShadowCasterCuller{};
+	ShadowCasterCuller.SetCascade(Cascades[0]);
+	CHECK(ShadowCasterCuller.IsCaster(KCaster));
+	ShadowCasterCuller.SetCascade(Cascades[1]);
+	CHECK(!ShadowCasterCuller.IsCaster(KCaster));
+
+	// A caster above the boundary casts into both
+	const XMFLOAT4 KBoundaryCaster{ 0, 30, 20, 1 };
+	ShadowCasterCuller.SetCascade(Cascades[0]);
+	CHECK(ShadowCasterCuller.IsCaster(KBoundaryCaster));
+	ShadowCasterCuller.SetCascade(Cascades[1]);
+	CHECK(ShadowCasterCuller.IsCaster(KBoundaryCaster));
+
+	// Cull() agrees with IsCaster()
+	const XMFLOAT4 KSpheres[]{ KCaster, KBoundaryCaster, XMFLOAT4(0, 30, 40, 1), XMFLOAT4(0, 30, 100, 1), XMFLOAT4(0, 0, 50, 2) };
+	std::vector<uint32_t> vCasterIndices{};
+	CHECK(ShadowCasterCuller.Cull(KSpheres, 5, vCasterIndices) == 3);
+	CHECK(vCasterIndices == std::vector<uint32_t>({ 1, 2, 4 }));
+	CHECK(ShadowCasterCuller.HasAnyCaster(KSpheres, 1) == false);
+	CHECK(ShadowCasterCuller.HasAnyCaster(KSpheres, 2) == true);
+}
@@ -0,0 +1,100 @@
+#include "Test.h"
+#include "../Core/StateCache.h"
+
+TEST_CASE(StateCache_SkipsRedundantBinds)
+{
+	CStateCache StateCache{};
+	int ShaderA{};
+	int ShaderB{};
+
+	CHECK(StateCache.ShouldBindShader(0, &ShaderA));
+	CHECK(!StateCache.ShouldBindShader(0, &ShaderA));
+	CHECK(StateCache.ShouldBindShader(1, &ShaderA));
+	CHECK(StateCache.ShouldBindShader(0, &ShaderB));
+
+	// Unbinding is a bind as well
+	CHECK(StateCache.ShouldBindShader(0, nullptr));
+	CHECK(!StateCache.ShouldBindShader(0, nullptr));
+
+	CHECK(StateCache.GetCounters().IssuedBindCount == 4);
+	CHECK(StateCache.GetCounters().SkippedBindCount == 2);
+
+	StateCache.ResetCounters();
+	CHECK(StateCache.GetCounters().IssuedBindCount == 0);
+}
+
+TEST_CASE(StateCache_TellsConstantBufferOffsets)
+{
+	CStateCache StateCache{};
+	int Buffer{};
+
+	CHECK(!StateCache.IsConstantBufferBound(0, 3, &Buffer));
+	CHECK(StateCache.ShouldBindConstantBuffer(0, 3, &Buffer));
+	CHECK(StateCache.IsConstantBufferBound(0, 3, &Buffer));
+	CHECK(!StateCache.ShouldBindConstantBuffer(0, 3, &Buffer));
+	CHECK(StateCache.ShouldBindConstantBuffer(0, 3, &Buffer, 256));
+	CHECK(!StateCache.ShouldBindConstantBuffer(0, 3, &Buffer, 256));
+	CHECK(StateCache.ShouldBindConstantBuffer(0, 4, &Buffer, 256));
+	CHECK(StateCache.ShouldBindConstantBuffer(2, 3, &Buffer, 256));
+}
+
+TEST_CASE(StateCache_ForgetsEverythingOnInvalidate)
+{
+	CStateCache StateCache{};
+	int Shader{};
+	int Buffer{};
+
+	StateCache.ShouldBindShader(4, &Shader);
+	StateCache.ShouldBindConstantBuffer(4, 13, &Buffer);
+	StateCache.Invalidate();
+
+	CHECK(!StateCache.IsConstantBufferBound(4, 13, &Buffer));
+	CHECK(StateCache.ShouldBindShader(4, &Shader));
+	CHECK(StateCache.ShouldBindConstantBuffer(4, 13, &Buffer));
+}
+
+TEST_CASE(StateCache_SkipsUnchangedUploads)
+{
+	CStateCache StateCache{};
+	SUploadState UploadState{};
+	float Data[8]{ 1.0f, 2.0f, 3.0f, 4.0f };
+
+	CHECK(StateCache.ShouldUpload(UploadState, Data, sizeof(Data)));
+	CHECK(!StateCache.ShouldUpload(UploadState, Data, sizeof(Data)));
+
+	Data[7] = 1.0f;
+	CHECK(StateCache.ShouldUpload(UploadState, Data, sizeof(Data)));
+
+	// Another buffer with the same data has its own state
+	SUploadState OtherUploadState{};
+	CHECK(StateCache.ShouldUpload(OtherUploadState, Data, sizeof(Data)));
+
+	CHECK(StateCache.GetCounters().IssuedUploadCount == 3);
+	CHECK(StateCache.GetCounters().SkippedUploadCount == 1);
+}
+
+TEST_CASE(StateCache_HashesEveryByte)
+{
+	uint8_t Bytes[13]{ 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 };
+	const uint64_t KHash{ CStateCache::Hash(Bytes, sizeof(Bytes)) };
+	CHECK(KHash == CStateCache::Hash(Bytes, sizeof(Bytes)));
+	CHECK(KHash != CStateCache::Hash(Bytes, sizeof(Bytes) - 1));
+
+	for (size_t iByte = 0; iByte < sizeof(Bytes); ++iByte)
+	{
+		Bytes[iByte] ^= 0x80;
+		CHECK(CStateCache::Hash(Bytes, sizeof(Bytes)) != KHash);
+		Bytes[iByte] ^= 0x80;
+	}
+
+	// FNV-1a offset basis
+	CHECK(CStateCache::Hash(Bytes, 0) == 0xCBF29CE484222325);
+}
+
+TEST_CASE(StateCache_KeepsOneCachePerContext)
+{
+	int ContextA{};
+	int ContextB{};
+	CHECK(&CStateCache::Get(&ContextA) == &CStateCache::Get(&ContextA));
+	CHECK(&CStateCache::Get(&ContextA) != &CStateCache::Get(&ContextB));
+}
@@ -0,0 +1,107 @@
+#include "Test.h"
+#include "../Core/TaskScheduler.h"
+#include <atomic>
+
+TEST_CASE(TaskScheduler_RunsDependenciesFirst)
+{
+	CTaskScheduler TaskScheduler{};
+
+	// @important: each task depends on the one before it, so the order is fixed even with several workers
+	std::vector<uint32_t> vOrder{};
+	uint32_t Previous{ TaskScheduler.AddTask([&] { vOrder.emplace_back(0); }) };
+	for (uint32_t iTask = 1; iTask < 16; ++iTask)
+	{
+		Previous = TaskScheduler.AddTask([&, iTask] { vOrder.emplace_back(iTask); }, { Previous });
+	}
+	CHECK(TaskScheduler.GetTaskCount() == 16);
+
+	TaskScheduler.Start(3);
+	TaskScheduler.Wait();
+
+	CHECK(TaskScheduler.IsFinished());
+	CHECK(TaskScheduler.GetFinishedTaskCount() == 16);
+	CHECK(vOrder.size() == 16);
+	for (uint32_t iTask = 0; iTask < (uint32_t)vOrder.size(); ++iTask)
+	{
+		CHECK(vOrder[iTask] == iTask);
+	}
+}
+
+TEST_CASE(TaskScheduler_JoinsDiamonds)
+{
+	CTaskScheduler TaskScheduler{};
+
+	// Top -> 8 middles -> bottom, the bottom sees every middle
+	std::atomic<uint32_t> MiddleCount{};
+	uint32_t BottomSeenCount{};
+	uint32_t Top{ TaskScheduler.AddTask([] {}) };
+	std::vector<uint32_t> vMiddles{};
+	for (uint32_t iMiddle = 0; iMiddle < 8; ++iMiddle)
+	{
+		vMiddles.emplace_back(TaskScheduler.AddTask([&] { ++MiddleCount; }, { Top }));
+	}
+	uint32_t Bottom{ TaskScheduler.AddTask([&] { BottomSeenCount = MiddleCount; }, vMiddles) };
+
+	TaskScheduler.Start(2);
+	TaskScheduler.WaitForTask(Bottom);
+
+	CHECK(TaskScheduler.IsTaskFinished(Bottom));
+	CHECK(BottomSeenCount == 8);
+
+	TaskScheduler.Wait();
+}
+
+TEST_CASE(TaskScheduler_ReusesWorkersBetweenBatches)
+{
+	CTaskScheduler TaskScheduler{};
+
+	uint64_t Sum{};
+	for (uint32_t iBatch = 0; iBatch < 200; ++iBatch)
+	{
+		TaskScheduler.Reset();
+
+		std::vector<uint64_t> vPartialSums(8);
+		std::vector<uint32_t> vPartials{};
+		for (uint32_t iPartial = 0; iPartial < 8; ++iPartial)
+		{
+			vPartials.emplace_back(TaskScheduler.AddTask([&, iPartial] { vPartialSums[iPartial] = iPartial + 1; }));
+		}
+		TaskScheduler.AddTask([&] { for (uint64_t PartialSum : vPartialSums) Sum += PartialSum; }, vPartials);
+
+		// The calling thread helps on every other batch
+		TaskScheduler.Start(2);
+		TaskScheduler.Wait(iBatch % 2 == 0);
+		CHECK(TaskScheduler.IsFinished());
+	}
+	CHECK(Sum == 200 * 36);
+}
+
+TEST_CASE(TaskScheduler_FinishesEmptyBatches)
+{
+	CTaskScheduler TaskScheduler{};
+	TaskScheduler.Start(1);
+	TaskScheduler.Wait(true);
+	CHECK(TaskScheduler.IsFinished());
+	CHECK(TaskScheduler.GetTaskCount() == 0);
+
+	TaskScheduler.Reset();
+	uint32_t Value{};
+	TaskScheduler.AddTask([&] { Value = 7; });
+	TaskScheduler.Start();
+	TaskScheduler.Wait(true);
+	CHECK(Value == 7);
+}
+
+TEST_CASE(TaskScheduler_WaitsOnDestruction)
+{
+	std::atomic<uint32_t> FinishedCount{};
+	{
+		CTaskScheduler TaskScheduler{};
+		for (uint32_t iTask = 0; iTask < 32; ++iTask)
+		{
+			TaskScheduler.AddTask([&] { std::this_thread::yield(); ++FinishedCount; });
+		}
+		TaskScheduler.Start(4);
+	}
+	CHECK(FinishedCount == 32);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// Minimal test runner for the pure CPU modules, so that they can be checked without a device or a test framework
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+
+struct STestCase
+{
+	const char*	Name{};
+	void		(*Function)() {};
+};
+
+class CTestRegistry
+{
+public:
+	static CTestRegistry& Get();
+
+public:
+	void Add(const char* const Name, void (*Function)());
+	void Fail(const char* const Expression, const char* const FileName, int Line);
+
+	// Runs the tests whose names start with NamePrefix (all of them if it's empty), returns the failed test count
+	uint32_t Run(const char* const NamePrefix);
+
+private:
+	std::vector<STestCase>	m_vTestCases{};
+	uint32_t				m_FailedCheckCount{}; // of the running test
+};
+
+struct STestRegistrar
+{
+	STestRegistrar(const char* const Name, void (*Function)()) { CTestRegistry::Get().Add(Name, Function); }
+};
+
+// @important: names are prefixed with the module, since ctest runs the tests of each module by prefix (see CMakeLists.txt)
+#define TEST_CASE(Name) static void Name(); static STestRegistrar Name##Registrar{ #Name, Name }; static void Name()
+
+// @important: a failed check doesn't stop the test, so that every broken check of a round-trip shows up at once
+#define CHECK(Expression) do { if (!(Expression)) CTestRegistry::Get().Fail(#Expression, __FILE__, __LINE__); } while (false)
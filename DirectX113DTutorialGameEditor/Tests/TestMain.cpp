@@ -0,0 +1,48 @@
+#include "Test.h"
+#include <cstring>
+
+CTestRegistry& CTestRegistry::Get()
+{
+	static CTestRegistry s_TestRegistry{};
+	return s_TestRegistry;
+}
+
+void CTestRegistry::Add(const char* const Name, void (*Function)())
+{
+	m_vTestCases.emplace_back(STestCase{ Name, Function });
+}
+
+void CTestRegistry::Fail(const char* const Expression, const char* const FileName, int Line)
+{
+	++m_FailedCheckCount;
+	printf("  %s(%d): CHECK(%s) failed\n", FileName, Line, Expression);
+}
+
+uint32_t CTestRegistry::Run(const char* const NamePrefix)
+{
+	const size_t KPrefixLength{ strlen(NamePrefix) };
+	uint32_t RunTestCount{};
+	uint32_t FailedTestCount{};
+	for (const STestCase& TestCase : m_vTestCases)
+	{
+		if (strncmp(TestCase.Name, NamePrefix, KPrefixLength) != 0) continue;
+
+		m_FailedCheckCount = 0;
+		TestCase.Function();
+		++RunTestCount;
+
+		printf("[%s] %s\n", (m_FailedCheckCount) ? "FAILED" : "passed", TestCase.Name);
+		if (m_FailedCheckCount) ++FailedTestCount;
+	}
+
+	printf("%u / %u passed\n", RunTestCount - FailedTestCount, RunTestCount);
+
+	// @important: a prefix that matches nothing is a typo in CMakeLists.txt, not a pass
+	return (RunTestCount) ? FailedTestCount : 1;
+}
+
+// Usage: EditorTests [test name prefix]
+int main(int argc, char* argv[])
+{
+	return (CTestRegistry::Get().Run((argc > 1) ? argv[1] : "") == 0) ? 0 : 1;
+}
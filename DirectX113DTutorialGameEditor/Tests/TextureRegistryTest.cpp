@@ -0,0 +1,87 @@
+#include "Test.h"
+#include "../Core/TextureRegistry.h"
+
+TEST_CASE(TextureRegistry_NormalizesFileKeys)
+{
+	CHECK(CTextureRegistry::MakeFileKey("Asset/Dungeon/../Stone.PNG", true) == "file:asset\\stone.png");
+	CHECK(CTextureRegistry::MakeFileKey("asset\\stone.png", true) == "file:asset\\stone.png");
+	CHECK(CTextureRegistry::MakeFileKey("./Asset//Stone.png", true) == "file:asset\\stone.png");
+	CHECK(CTextureRegistry::MakeFileKey("Asset/Stone.png", false) == "file:asset\\stone.png|nomip");
+
+	// Leading ".." can't be resolved
+	CHECK(CTextureRegistry::MakeFileKey("../../Asset/Stone.png", true) == "file:..\\..\\asset\\stone.png");
+	CHECK(CTextureRegistry::MakeFileKey("A/../../Stone.png", true) == "file:..\\stone.png");
+}
+
+TEST_CASE(TextureRegistry_HashesMemoryKeys)
+{
+	const uint8_t KBytes[]{ 0x89, 'P', 'N', 'G', 0, 1, 2, 3, 4, 5 };
+	const std::string KKey{ CTextureRegistry::MakeMemoryKey(KBytes, sizeof(KBytes), true) };
+	CHECK(KKey.compare(0, 4, "mem:") == 0);
+	CHECK(KKey == CTextureRegistry::MakeMemoryKey(KBytes, sizeof(KBytes), true));
+	CHECK(KKey != CTextureRegistry::MakeMemoryKey(KBytes, sizeof(KBytes) - 1, true));
+	CHECK(KKey + "|nomip" == CTextureRegistry::MakeMemoryKey(KBytes, sizeof(KBytes), false));
+}
+
+TEST_CASE(TextureRegistry_SharesTexturesByKey)
+{
+	CTextureRegistry TextureRegistry{};
+
+	uint32_t Handle{ CTextureRegistry::KInvalidHandle };
+	CHECK(!TextureRegistry.Acquire("file:a.png", Handle));
+	CHECK(Handle != CTextureRegistry::KInvalidHandle);
+	TextureRegistry.SetResidentByteCount(Handle, 1000);
+
+	uint32_t SharedHandle{};
+	CHECK(TextureRegistry.Acquire("file:a.png", SharedHandle));
+	CHECK(SharedHandle == Handle);
+	CHECK(TextureRegistry.GetReferenceCount(Handle) == 2);
+	CHECK(TextureRegistry.GetKey(Handle) == "file:a.png");
+
+	uint32_t OtherHandle{};
+	CHECK(!TextureRegistry.Acquire("file:b.png", OtherHandle));
+	CHECK(OtherHandle != Handle);
+
+	const STextureRegistryCounters& KCounters{ TextureRegistry.GetCounters() };
+	CHECK(KCounters.HitCount == 1 && KCounters.MissCount == 2);
+	CHECK(KCounters.TextureCount == 2 && KCounters.ReferenceCount == 3);
+	CHECK(KCounters.ResidentByteCount == 1000 && KCounters.SharedByteCount == 1000);
+
+	// The last reference releases the texture
+	CHECK(!TextureRegistry.Release(SharedHandle));
+	CHECK(KCounters.SharedByteCount == 0);
+	CHECK(TextureRegistry.Release(Handle));
+	CHECK(KCounters.TextureCount == 1 && KCounters.ReferenceCount == 1 && KCounters.ResidentByteCount == 0);
+
+	// Released handles are reused, with a fresh entry
+	uint32_t ReusedHandle{};
+	CHECK(!TextureRegistry.Acquire("file:c.png", ReusedHandle));
+	CHECK(ReusedHandle == Handle);
+	CHECK(TextureRegistry.GetReferenceCount(ReusedHandle) == 1);
+
+	// A released key misses again
+	uint32_t ReacquiredHandle{};
+	CHECK(!TextureRegistry.Acquire("file:a.png", ReacquiredHandle));
+
+	TextureRegistry.ResetCounters();
+	CHECK(KCounters.HitCount == 0 && KCounters.MissCount == 0 && KCounters.TextureCount == 3);
+}
+
+TEST_CASE(TextureRegistry_CountsSharedBytesOnResize)
+{
+	CTextureRegistry TextureRegistry{};
+
+	uint32_t Handle{};
+	TextureRegistry.Acquire("file:a.png", Handle);
+	TextureRegistry.Acquire("file:a.png", Handle);
+	TextureRegistry.Acquire("file:a.png", Handle);
+
+	// e.g. the texture is created after it's been acquired by other materials
+	TextureRegistry.SetResidentByteCount(Handle, 100);
+	CHECK(TextureRegistry.GetCounters().ResidentByteCount == 100);
+	CHECK(TextureRegistry.GetCounters().SharedByteCount == 200);
+
+	TextureRegistry.SetResidentByteCount(Handle, 40);
+	CHECK(TextureRegistry.GetCounters().ResidentByteCount == 40);
+	CHECK(TextureRegistry.GetCounters().SharedByteCount == 80);
+}
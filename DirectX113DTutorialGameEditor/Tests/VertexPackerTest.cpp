@@ -0,0 +1,100 @@
+#include "Test.h"
+#include "../Model/VertexPacker.h"
+#include <algorithm>
+
+// UV sphere with unit normals & tangents, as the MESH packing expects them
+static std::vector<SVertex3D> MakeSphereVertices(uint32_t RingCount, uint32_t SegmentCount, const XMVECTOR& Color)
+{
+	std::vector<SVertex3D> vVertices{};
+	for (uint32_t iRing = 0; iRing <= RingCount; ++iRing)
+	{
+		const float KTheta{ XM_PI * ((float)iRing + 0.5f) / (float)(RingCount + 1) };
+		for (uint32_t iSegment = 0; iSegment <= SegmentCount; ++iSegment)
+		{
+			const float KPhi{ XM_2PI * (float)iSegment / (float)SegmentCount };
+			const XMVECTOR KNormal{ XMVectorSet(sinf(KTheta) * cosf(KPhi), cosf(KTheta), sinf(KTheta) * sinf(KPhi), 0) };
+
+			SVertex3D Vertex{ XMVectorSetW(KNormal * 3.0f, 1.0f), Color,
+				XMVectorSet((float)iSegment / SegmentCount, (float)iRing / RingCount, 0, 0) };
+			Vertex.Normal = KNormal;
+			Vertex.Tangent = XMVectorSet(-sinf(KPhi), 0, cosf(KPhi), 0);
+			vVertices.emplace_back(Vertex);
+		}
+	}
+	return vVertices;
+}
+
+static float GetMaxComponentError(const XMVECTOR& A, const XMVECTOR& B)
+{
+	XMFLOAT4 Error{};
+	XMStoreFloat4(&Error, XMVectorAbs(A - B));
+	return std::max(std::max(Error.x, Error.y), std::max(Error.z, Error.w));
+}
+
+TEST_CASE(VertexPacker_RoundTripsWithinTheBudgets)
+{
+	const CVertexPacker::SSettings KSettings{};
+	CVertexPacker VertexPacker{ KSettings };
+	const std::vector<SVertex3D> KVertices{ MakeSphereVertices(16, 24, XMVectorSet(0.25f, 0.5f, 0.75f, 1.0f)) };
+
+	SPackedVertices Packed{};
+	CVertexPacker::SReport Report{};
+	CHECK(VertexPacker.Pack(KVertices, Packed, &Report));
+	CHECK(!Packed.bHasVertexColors);
+	CHECK(CVertexPacker::GetPackedByteCount(Packed) < sizeof(SVertex3D) * KVertices.size() / 3);
+
+	std::vector<SVertex3D> vUnpacked{};
+	CVertexPacker::Unpack(Packed, vUnpacked);
+	CHECK(vUnpacked.size() == KVertices.size());
+	for (size_t iVertex = 0; iVertex < vUnpacked.size() && iVertex < KVertices.size(); ++iVertex)
+	{
+		const SVertex3D& KVertex{ KVertices[iVertex] };
+		const SVertex3D& KUnpacked{ vUnpacked[iVertex] };
+		CHECK(GetMaxComponentError(KUnpacked.Position, KVertex.Position) == 0.0f);
+		CHECK(GetMaxComponentError(KUnpacked.Color, KVertex.Color) == 0.0f);
+		CHECK(XMVectorGetX(XMVector3Length(KUnpacked.Normal - KVertex.Normal)) <= KSettings.DirectionErrorBudget);
+		CHECK(XMVectorGetX(XMVector3Length(KUnpacked.Tangent - KVertex.Tangent)) <= KSettings.DirectionErrorBudget);
+		CHECK(GetMaxComponentError(KUnpacked.TexCoord, KVertex.TexCoord) <= KSettings.TexCoordErrorBudget);
+	}
+}
+
+TEST_CASE(VertexPacker_KeepsVaryingColors)
+{
+	std::vector<SVertex3D> vVertices{ MakeSphereVertices(4, 8, XMVectorSet(1, 1, 1, 1)) };
+	for (size_t iVertex = 0; iVertex < vVertices.size(); ++iVertex)
+	{
+		vVertices[iVertex].Color = XMVectorSet((float)(iVertex % 256) / 255.0f, 0.5f, 0, 1);
+	}
+
+	SPackedVertices Packed{};
+	CHECK(CVertexPacker().Pack(vVertices, Packed));
+	CHECK(Packed.bHasVertexColors && Packed.vColors.size() == vVertices.size());
+
+	std::vector<SVertex3D> vUnpacked{};
+	CVertexPacker::Unpack(Packed, vUnpacked);
+	for (size_t iVertex = 0; iVertex < vUnpacked.size(); ++iVertex)
+	{
+		CHECK(GetMaxComponentError(vUnpacked[iVertex].Color, vVertices[iVertex].Color) <= 1.0f / 255.0f);
+	}
+}
+
+TEST_CASE(VertexPacker_RejectsVerticesOutOfTheFormat)
+{
+	const std::vector<SVertex3D> KVertices{ MakeSphereVertices(4, 8, XMVectorSet(1, 1, 1, 1)) };
+	SPackedVertices Packed{};
+
+	// Position.w isn't stored
+	std::vector<SVertex3D> vVertices{ KVertices };
+	vVertices[3].Position = XMVectorSetW(vVertices[3].Position, 0.5f);
+	CHECK(!CVertexPacker().Pack(vVertices, Packed));
+
+	// Nor is TexCoord.z
+	vVertices = KVertices;
+	vVertices[5].TexCoord = XMVectorSetZ(vVertices[5].TexCoord, 1.0f);
+	CHECK(!CVertexPacker().Pack(vVertices, Packed));
+
+	// Normals that aren't unit length don't survive the octahedral encoding
+	vVertices = KVertices;
+	vVertices[7].Normal = vVertices[7].Normal * 2.0f;
+	CHECK(!CVertexPacker().Pack(vVertices, Packed));
+}
@@ -1,4 +1,6 @@
 #include "Core/Game.h"
+#include "Editor/AssetCooker.h"
+#include <filesystem>
 
 // @TODO
 // implement anti-aliasing
@@ -8,8 +10,183 @@
 IMGUI_IMPL_API LRESULT  ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
 LRESULT CALLBACK WndProc(_In_ HWND hWnd, _In_ UINT Msg, _In_ WPARAM wParam, _In_ LPARAM lParam);
 
+// Every MESH file under Directory, sorted
+static std::vector<std::string> GetMESHFileNames(const char* const Directory)
+{
+	std::vector<std::string> vMESHFileNames{};
+	std::error_code ErrorCode{};
+	for (const auto& Entry : std::filesystem::recursive_directory_iterator(Directory, ErrorCode))
+	{
+		std::string Extension{ Entry.path().extension().string() };
+		for (auto& c : Extension) c = toupper(c);
+		if (Entry.is_regular_file() && Extension == ".MESH") vMESHFileNames.emplace_back(Entry.path().string());
+	}
+	std::sort(vMESHFileNames.begin(), vMESHFileNames.end());
+	return vMESHFileNames;
+}
+
 int WINAPI WinMain(_In_ HINSTANCE hInstance, _In_opt_ HINSTANCE hPrevInstance, _In_ LPSTR lpCmdLine, _In_ int nShowCmd)
 {
+	// Headless scene conversion (no window, no device)
+	// e.g. DirectX113DTutorial.exe -convert-scene Scene\legacy.scene Scene\converted.scene
+	if (__argc == 4 && strcmp(__argv[1], "-convert-scene") == 0)
+	{
+		return CGame::ConvertLegacyScene(__argv[2], __argv[3]) ? 0 : 1;
+	}
+
+	// Headless scene decoding benchmark (CPU stage of loading only)
+	// e.g. DirectX113DTutorial.exe -measure-scene-decode Scene\test.scene > result.txt
+	if (__argc == 3 && strcmp(__argv[1], "-measure-scene-decode") == 0)
+	{
+		static constexpr uint32_t KIterationCount{ 8 };
+		double SingleThreadMilliseconds{ CSceneDecoder::MeasureDecodeTime(__argv[2], 1, KIterationCount) };
+		double MultiThreadMilliseconds{ CSceneDecoder::MeasureDecodeTime(__argv[2], 0, KIterationCount) };
+		printf("1 thread: %.2f ms\n%u threads: %.2f ms\n", SingleThreadMilliseconds,
+			std::max(std::thread::hardware_concurrency(), 2u) - 1, MultiThreadMilliseconds);
+		return (SingleThreadMilliseconds > 0.0) ? 0 : 1;
+	}
+
+	// Headless compression benchmark (ratio, speed and round trip of each file)
+	// e.g. DirectX113DTutorial.exe -measure-compression Asset\vanguard.mesh Asset\integrated_brdf.DDS > result.txt
+	if (__argc >= 3 && strcmp(__argv[1], "-measure-compression") == 0)
+	{
+		static constexpr uint32_t KIterationCount{ 20 };
+		uint64_t TotalRawByteCount{};
+		uint64_t TotalCompressedByteCount{};
+		bool bAreAllRoundTripped{ true };
+		for (int iArgument = 2; iArgument < __argc; ++iArgument)
+		{
+			SLZBenchmark Benchmark{};
+			if (!CLZCodec::MeasureFile(__argv[iArgument], KIterationCount, Benchmark))
+			{
+				printf("%s: FAILED\n", __argv[iArgument]);
+				bAreAllRoundTripped = false;
+				continue;
+			}
+
+			printf("%s: %llu -> %llu B (ratio %.2f), encode %.0f MB/s, decode %.2f GB/s\n", __argv[iArgument],
+				(unsigned long long)Benchmark.RawByteCount, (unsigned long long)Benchmark.CompressedByteCount, Benchmark.Ratio,
+				Benchmark.EncodeMBps, Benchmark.DecodeGBps);
+			TotalRawByteCount += Benchmark.RawByteCount;
+			TotalCompressedByteCount += Benchmark.CompressedByteCount;
+		}
+		if (TotalCompressedByteCount) printf("total ratio %.2f\n", (double)TotalRawByteCount / (double)TotalCompressedByteCount);
+		return (bAreAllRoundTripped) ? 0 : 1;
+	}
+
+	// Headless mesh LOD generation benchmark (every MESH file under the directory, with the triangle count of each LOD)
+	// e.g. DirectX113DTutorial.exe -measure-mesh-lods Asset > result.txt
+	if (__argc == 3 && strcmp(__argv[1], "-measure-mesh-lods") == 0)
+	{
+		static constexpr uint32_t KIterationCount{ 3 };
+		const std::vector<std::string> vMESHFileNames{ GetMESHFileNames(__argv[2]) };
+
+		double TotalMilliseconds{};
+		std::vector<size_t> vTotalLODTriangleCounts(CObject3D::KDefaultMeshLODCount);
+		bool bAreAllRead{ !vMESHFileNames.empty() };
+		for (const auto& MESHFileName : vMESHFileNames)
+		{
+			std::vector<size_t> vLODTriangleCounts{};
+			double Milliseconds{ CObject3D::MeasureMeshLODGenerationTime(MESHFileName, CObject3D::KDefaultMeshLODCount, KIterationCount,
+				vLODTriangleCounts) };
+			if (vLODTriangleCounts.empty())
+			{
+				printf("%s: FAILED\n", MESHFileName.c_str());
+				bAreAllRead = false;
+				continue;
+			}
+
+			printf("%s: %8.2f ms, triangles", MESHFileName.c_str(), Milliseconds);
+			for (size_t iLOD = 0; iLOD < vLODTriangleCounts.size(); ++iLOD)
+			{
+				printf("%s%llu", (iLOD) ? " -> " : " ", (unsigned long long)vLODTriangleCounts[iLOD]);
+				vTotalLODTriangleCounts[iLOD] += vLODTriangleCounts[iLOD];
+			}
+			printf("\n");
+			TotalMilliseconds += Milliseconds;
+		}
+		printf("%u files: %.2f ms, triangles", (uint32_t)vMESHFileNames.size(), TotalMilliseconds);
+		for (size_t iLOD = 0; iLOD < vTotalLODTriangleCounts.size(); ++iLOD)
+		{
+			printf("%s%llu", (iLOD) ? " -> " : " ", (unsigned long long)vTotalLODTriangleCounts[iLOD]);
+		}
+		printf("\n");
+		return (bAreAllRead) ? 0 : 1;
+	}
+
+	// Headless vertex packing benchmark (size and import time of every MESH file under the directory, with raw and packed vertices)
+	// e.g. DirectX113DTutorial.exe -measure-vertex-packing Asset > result.txt
+	if (__argc == 3 && strcmp(__argv[1], "-measure-vertex-packing") == 0)
+	{
+		static constexpr uint32_t KIterationCount{ 10 };
+		const std::vector<std::string> vMESHFileNames{ GetMESHFileNames(__argv[2]) };
+
+		SVertexPackingBenchmark Total{};
+		bool bAreAllRead{ !vMESHFileNames.empty() };
+		for (const auto& MESHFileName : vMESHFileNames)
+		{
+			SVertexPackingBenchmark Benchmark{};
+			if (!CMeshPorter::MeasureVertexPacking(MESHFileName, KIterationCount, Benchmark))
+			{
+				printf("%s: FAILED\n", MESHFileName.c_str());
+				bAreAllRead = false;
+				continue;
+			}
+
+			printf("%s: %llu -> %llu B (ratio %.2f), import %.2f -> %.2f ms\n", MESHFileName.c_str(),
+				(unsigned long long)Benchmark.RawByteCount, (unsigned long long)Benchmark.PackedByteCount,
+				(double)Benchmark.RawByteCount / (double)std::max(Benchmark.PackedByteCount, (size_t)1),
+				Benchmark.RawImportMilliseconds, Benchmark.PackedImportMilliseconds);
+			Total.RawByteCount += Benchmark.RawByteCount;
+			Total.PackedByteCount += Benchmark.PackedByteCount;
+			Total.RawImportMilliseconds += Benchmark.RawImportMilliseconds;
+			Total.PackedImportMilliseconds += Benchmark.PackedImportMilliseconds;
+		}
+		printf("%u files: %llu -> %llu B (ratio %.2f), import %.2f -> %.2f ms\n", (uint32_t)vMESHFileNames.size(),
+			(unsigned long long)Total.RawByteCount, (unsigned long long)Total.PackedByteCount,
+			(double)Total.RawByteCount / (double)std::max(Total.PackedByteCount, (size_t)1),
+			Total.RawImportMilliseconds, Total.PackedImportMilliseconds);
+		return (bAreAllRead) ? 0 : 1;
+	}
+
+	// Headless incremental scene save benchmark (latency against the number of changed objects, checked against full saves)
+	// e.g. DirectX113DTutorial.exe -measure-scene-save Scene\save_test.scene 256 512 > result.txt
+	if ((__argc >= 3 && __argc <= 5) && strcmp(__argv[1], "-measure-scene-save") == 0)
+	{
+		uint32_t ObjectCount{ (__argc >= 4) ? (uint32_t)atoi(__argv[3]) : 256 };
+		size_t ObjectKilobyteCount{ (__argc >= 5) ? (size_t)atoi(__argv[4]) : 256 };
+		const std::vector<uint32_t> vDirtyObjectCounts{ 0, 1, 4, 16, 64, ObjectCount };
+
+		bool bAreAllIdentical{ true };
+		for (bool bShouldCompress : { false, true })
+		{
+			std::vector<CSceneContainer::SIncrementalSaveBenchmark> vBenchmarks{};
+			if (!CSceneContainer::MeasureIncrementalSaveTime(__argv[2], ObjectCount, ObjectKilobyteCount * 1024, vDirtyObjectCounts,
+				bShouldCompress, vBenchmarks)) return 1;
+
+			printf("%u objects of %u KB (%s)\n", ObjectCount, (uint32_t)ObjectKilobyteCount, (bShouldCompress) ? "compressed" : "uncompressed");
+			for (const auto& Benchmark : vBenchmarks)
+			{
+				printf("%4u changed: %8.2f ms (full: %8.2f ms) %s\n", Benchmark.DirtyChunkCount, Benchmark.Milliseconds, Benchmark.FullMilliseconds,
+					(Benchmark.bIsIdentical) ? "identical" : "DIFFERENT");
+				bAreAllIdentical = bAreAllIdentical && Benchmark.bIsIdentical;
+			}
+		}
+		return (bAreAllIdentical) ? 0 : 1;
+	}
+
+	// Headless asset cooking (models into MESH files and textures into DDS files)
+	// e.g. DirectX113DTutorial.exe -cook-assets Asset Asset\Cooked 8 > cook.txt
+	if ((__argc == 4 || __argc == 5) && strcmp(__argv[1], "-cook-assets") == 0)
+	{
+		uint32_t ThreadCount{ (__argc == 5) ? (uint32_t)atoi(__argv[4]) : 0 };
+
+		CAssetCooker AssetCooker{};
+		bool bResult{ AssetCooker.Cook(__argv[2], __argv[3], ThreadCount) };
+		AssetCooker.PrintReport();
+		return (bResult) ? 0 : 1;
+	}
+
 	static constexpr XMFLOAT2 KGameWindowSize{ 1280.0f, 720.0f };
 	CGame Game{ hInstance, KGameWindowSize };
 